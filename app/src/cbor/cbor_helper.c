@@ -6,16 +6,59 @@
 #include <errno.h>
 #include <string.h>
 #include <zcbor_encode.h>
+#include <zcbor_decode.h>
 
 #include "cbor_helper.h"
 #include "device_shadow_types.h"
 #include "device_shadow_decode.h"
 #include "device_shadow_encode.h"
 
+#if defined(CONFIG_APP_GEOFENCE)
+#include "geofence.h"
+#endif /* CONFIG_APP_GEOFENCE */
+
 #include <zephyr/logging/log.h>
 
 LOG_MODULE_REGISTER(cbor_helper, CONFIG_APP_LOG_LEVEL);
 
+/*
+ * Table of the configuration parameters in the "config" section of the shadow.
+ *
+ * X(name, is_set, mark_set)
+ *	name:		Key in device_shadow.cddl, field in struct config_params and in the generated
+ *			zcbor config struct (<name>_present and <name>.<name>).
+ *	is_set:		Expression on config that is true if the parameter is to be encoded.
+ *	mark_set:	Statement on config that marks the parameter as decoded.
+ *
+ * To add a configuration parameter, add it to device_shadow.cddl, struct config_params and
+ * this table.
+ */
+#define CONFIG_PARAMS_LIST(X)								\
+	X(sample_interval,	(config->sample_interval > 0),	(void)0)		\
+	X(storage_threshold,	(config->storage_threshold_valid),			\
+				(config->storage_threshold_valid = true))		\
+	X(power_interval,	(config->power_interval > 0),	(void)0)		\
+	X(environmental_interval, (config->environmental_interval > 0), (void)0)	\
+	X(environmental_profile, (config->environmental_profile_valid),			\
+				(config->environmental_profile_valid = true))		\
+	X(location_report,	(config->location_report_valid),			\
+				(config->location_report_valid = true))			\
+	X(heartbeat_interval,	(config->heartbeat_interval > 0), (void)0)
+
+#define CONFIG_PARAM_DECODE(_name, _is_set, _mark_set)					\
+	if (shadow.config._name##_present) {						\
+		config->_name = shadow.config._name._name;				\
+		_mark_set;								\
+		LOG_DBG("Configuration: Decoded " #_name " = %u", config->_name);	\
+	}
+
+#define CONFIG_PARAM_ENCODE(_name, _is_set, _mark_set)					\
+	if (_is_set) {									\
+		shadow.config_present = true;						\
+		shadow.config._name##_present = true;					\
+		shadow.config._name._name = config->_name;				\
+	}
+
 int decode_shadow_parameters_from_cbor(const uint8_t *cbor, size_t len,
 				       struct config_params *config, uint32_t *command_type,
 				       uint32_t *command_id)
@@ -37,19 +80,7 @@ int decode_shadow_parameters_from_cbor(const uint8_t *cbor, size_t len,
 	}
 
 	if (shadow.config_present) {
-		if (shadow.config.sample_interval_present) {
-			config->sample_interval = shadow.config.sample_interval.sample_interval;
-			LOG_DBG("Configuration: Decoded sample_interval = %d seconds",
-				config->sample_interval);
-		}
-
-		if (shadow.config.storage_threshold_present) {
-			config->storage_threshold =
-				shadow.config.storage_threshold.storage_threshold;
-			config->storage_threshold_valid = true;
-			LOG_DBG("Configuration: Decoded storage_threshold = %d",
-				config->storage_threshold);
-		}
+		CONFIG_PARAMS_LIST(CONFIG_PARAM_DECODE)
 	}
 
 	if (shadow.command_present) {
@@ -62,6 +93,138 @@ int decode_shadow_parameters_from_cbor(const uint8_t *cbor, size_t len,
 	return 0;
 }
 
+#if defined(CONFIG_APP_GEOFENCE)
+/* Nesting below the shadow object: config map, zone array, zone, point array and point */
+#define GEOFENCE_DECODE_BACKUPS 6
+
+static bool key_equal(const struct zcbor_string *key, const char *name)
+{
+	return (key->len == strlen(name)) && (memcmp(key->value, name, key->len) == 0);
+}
+
+/* Decode a zone, [id, radius, [[lat, lon], ...]] */
+static bool geofence_zone_decode(zcbor_state_t *state, struct geofence_zone *zone)
+{
+	if (!zcbor_list_start_decode(state) ||
+	    !zcbor_uint32_decode(state, &zone->id) ||
+	    !zcbor_uint32_decode(state, &zone->radius) ||
+	    !zcbor_list_start_decode(state)) {
+		return false;
+	}
+
+	zone->point_count = 0;
+
+	while (!zcbor_array_at_end(state)) {
+		struct geofence_point *point;
+
+		if (zone->point_count == ARRAY_SIZE(zone->points)) {
+			LOG_WRN("Too many points in zone %u", zone->id);
+
+			/* Leave the zone without points, it is ignored as invalid */
+			zone->point_count = 0;
+
+			while (!zcbor_array_at_end(state)) {
+				if (!zcbor_any_skip(state, NULL)) {
+					return false;
+				}
+			}
+
+			break;
+		}
+
+		point = &zone->points[zone->point_count];
+
+		if (!zcbor_list_start_decode(state) ||
+		    !zcbor_int32_decode(state, &point->lat) ||
+		    !zcbor_int32_decode(state, &point->lon) ||
+		    !zcbor_list_end_decode(state)) {
+			return false;
+		}
+
+		zone->point_count++;
+	}
+
+	return zcbor_list_end_decode(state) && zcbor_list_end_decode(state);
+}
+
+static bool geofence_zones_decode(zcbor_state_t *state, struct geofence_zones *zones)
+{
+	struct geofence_zone zone;
+
+	if (!zcbor_list_start_decode(state)) {
+		return false;
+	}
+
+	zones->count = 0;
+
+	while (!zcbor_array_at_end(state)) {
+		if (!geofence_zone_decode(state, &zone)) {
+			return false;
+		}
+
+		if (zones->count < ARRAY_SIZE(zones->zones)) {
+			zones->zones[zones->count++] = zone;
+		} else {
+			LOG_WRN("Too many zones, ignoring zone %u", zone.id);
+		}
+	}
+
+	return zcbor_list_end_decode(state);
+}
+
+/* Find the value of a key in the current map and leave the state at it */
+static bool map_key_find(zcbor_state_t *state, const char *name)
+{
+	struct zcbor_string key;
+
+	while (!zcbor_array_at_end(state)) {
+		if (!zcbor_tstr_decode(state, &key)) {
+			return false;
+		}
+
+		if (key_equal(&key, name)) {
+			return true;
+		}
+
+		if (!zcbor_any_skip(state, NULL)) {
+			return false;
+		}
+	}
+
+	return false;
+}
+
+int decode_shadow_geofences_from_cbor(const uint8_t *cbor, size_t len,
+				      struct geofence_zones *zones)
+{
+	ZCBOR_STATE_D(state, GEOFENCE_DECODE_BACKUPS, cbor, len, 1, 0);
+
+	if (!cbor || !zones || len == 0) {
+		LOG_ERR("Invalid input");
+		return -EINVAL;
+	}
+
+	if (!zcbor_map_start_decode(state)) {
+		return -EFAULT;
+	}
+
+	if (!map_key_find(state, "config") || !zcbor_map_start_decode(state) ||
+	    !map_key_find(state, "geofences")) {
+		/* A missing key and malformed data both end the search */
+		return (zcbor_peek_error(state) == ZCBOR_SUCCESS) ? -ENOENT : -EFAULT;
+	}
+
+	if (!geofence_zones_decode(state, zones)) {
+		LOG_ERR("Failed to decode geofences, error: %d", zcbor_peek_error(state));
+		return -EFAULT;
+	}
+
+	LOG_DBG("Configuration: Decoded %u geofences", zones->count);
+
+	return 0;
+}
+#endif /* CONFIG_APP_GEOFENCE */
+
 int encode_shadow_parameters_to_cbor(const struct config_params *config, uint32_t command_type,
 				     uint32_t command_id, uint8_t *buffer, size_t buffer_size,
 				     size_t *encoded_len)
@@ -74,17 +237,7 @@ int encode_shadow_parameters_to_cbor(const struct config_params *config, uint32_
 		return -EINVAL;
 	}
 
-	if (config->sample_interval > 0) {
-		shadow.config_present = true;
-		shadow.config.sample_interval_present = true;
-		shadow.config.sample_interval.sample_interval = config->sample_interval;
-	}
-
-	if (config->storage_threshold_valid) {
-		shadow.config_present = true;
-		shadow.config.storage_threshold_present = true;
-		shadow.config.storage_threshold.storage_threshold = config->storage_threshold;
-	}
+	CONFIG_PARAMS_LIST(CONFIG_PARAM_ENCODE)
 
 	/* Build shadow object with command section */
 	if (command_type > 0) {
@@ -8,16 +8,39 @@
 
 #define CLOUD_COMMAND_TYPE_PROVISION 1
 
-/** Device configuration parameters. */
+/** Device configuration parameters.
+ *  Each parameter is described in CONFIG_PARAMS_LIST in cbor_helper.c.
+ */
 struct config_params {
 	/** Sample interval in seconds. */
 	uint32_t sample_interval;
 
+	/** Battery sample interval in seconds, 0 if not set. */
+	uint32_t power_interval;
+
+	/** Environmental sample interval in seconds, 0 if not set. */
+	uint32_t environmental_interval;
+
 	/** Storage buffer threshold amount */
 	uint32_t storage_threshold;
 
 	/** Separate validity flag as 0 is a valid option for storage_threshold */
 	bool storage_threshold_valid;
+
+	/** Environmental sensor profile, enum environmental_profile */
+	uint32_t environmental_profile;
+
+	/** Separate validity flag as 0 is a valid option for environmental_profile */
+	bool environmental_profile_valid;
+
+	/** Location report mode, enum geofence_report_mode */
+	uint32_t location_report;
+
+	/** Separate validity flag as 0 is a valid option for location_report */
+	bool location_report_valid;
+
+	/** Location heartbeat interval in seconds, 0 if not set. */
+	uint32_t heartbeat_interval;
 };
 
 /**
@@ -39,6 +62,27 @@ int decode_shadow_parameters_from_cbor(const uint8_t *cbor,
 				       uint32_t *command_type,
 				       uint32_t *command_id);
 
+struct geofence_zones;
+
+/**
+ * @brief Decode the geofence zones in the "config" section of the shadow.
+ *
+ * The zones are an array under the "geofences" key, see device_shadow.cddl. Zones with more
+ * points than CONFIG_APP_GEOFENCE_MAX_POINTS are returned without points, and zones beyond
+ * CONFIG_APP_GEOFENCE_MAX_ZONES are ignored.
+ *
+ * @param[in]  cbor  CBOR buffer.
+ * @param[in]  len   CBOR buffer length.
+ * @param[out] zones Decoded zones.
+ *
+ * @retval 0 Success.
+ * @retval -EINVAL Invalid parameters.
+ * @retval -ENOENT No zones in the buffer.
+ * @retval -EFAULT Invalid CBOR data.
+ */
+int decode_shadow_geofences_from_cbor(const uint8_t *cbor, size_t len,
+				      struct geofence_zones *zones);
+
 /**
  * @brief Encode shadow parameters to CBOR buffer.
  *
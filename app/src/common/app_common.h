@@ -13,6 +13,12 @@
 #if defined(CONFIG_MEMFAULT)
 #include <memfault/panics/assert.h>
 #endif
+#if defined(CONFIG_APP_HANDLER_STATS)
+#include "handler_stats.h"
+#endif
+#if defined(CONFIG_APP_MODEM_TRACE_RING)
+#include "modem_trace_ring.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,6 +30,11 @@ extern "C" {
 #define FATAL_ERROR_HANDLE(is_watchdog_timeout) do {				\
 	LOG_PANIC();								\
 	if (is_watchdog_timeout) {						\
+		IF_ENABLED(CONFIG_APP_MODEM_TRACE_RING,				\
+			   (modem_trace_ring_trigger(				\
+				MODEM_TRACE_RING_TRIGGER_WATCHDOG);))		\
+		IF_ENABLED(CONFIG_APP_HANDLER_STATS,				\
+			   (handler_stats_report_running();))			\
 		IF_ENABLED(CONFIG_MEMFAULT, (MEMFAULT_SOFTWARE_WATCHDOG()));	\
 	}									\
 	k_sleep(K_SECONDS(10));							\
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _CLOUD_BACKOFF_H_
+#define _CLOUD_BACKOFF_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum cloud_backoff_type {
+	/* Same backoff time for every attempt */
+	CLOUD_BACKOFF_NONE,
+
+	/* Backoff time grows by a fixed increment per attempt */
+	CLOUD_BACKOFF_LINEAR,
+
+	/* Backoff time doubles per attempt */
+	CLOUD_BACKOFF_EXPONENTIAL,
+};
+
+/**
+ * @brief Reconnection backoff of a cloud transport.
+ *
+ * Each cloud module fills this structure from its own Kconfig options.
+ */
+struct cloud_backoff_config {
+	enum cloud_backoff_type type;
+
+	/* Backoff time of the first attempt, in seconds */
+	uint32_t initial_seconds;
+
+	/* Increment per attempt for CLOUD_BACKOFF_LINEAR, in seconds */
+	uint32_t linear_increment_seconds;
+
+	/* Upper limit of the backoff time, in seconds */
+	uint32_t max_seconds;
+
+	/* Factor applied when the server rejected the connection, 0 or 1 to disable */
+	uint32_t server_reject_factor;
+};
+
+/**
+ * @brief Calculate the backoff time before the next connection attempt.
+ *
+ * Random jitter is left to the caller, as it depends on the entropy source of the build.
+ *
+ * @param config Backoff configuration of the cloud module.
+ * @param attempts Number of failed connection attempts, starting at 1.
+ * @param server_rejected Whether the last attempt was rejected by the server.
+ *
+ * @return Backoff time in seconds.
+ */
+static inline uint32_t cloud_backoff_get(const struct cloud_backoff_config *config,
+					 uint32_t attempts, bool server_rejected)
+{
+	uint64_t backoff_time = config->initial_seconds;
+
+	attempts = MAX(attempts, 1);
+
+	if (config->type == CLOUD_BACKOFF_EXPONENTIAL) {
+		/* Limit the shift, the result is capped at max_seconds anyway */
+		backoff_time = (uint64_t)config->initial_seconds << MIN(attempts - 1, 31);
+	} else if (config->type == CLOUD_BACKOFF_LINEAR) {
+		backoff_time = config->initial_seconds +
+			((uint64_t)(attempts - 1) * config->linear_increment_seconds);
+	}
+
+	if (server_rejected && (config->server_reject_factor > 1)) {
+		backoff_time *= config->server_reject_factor;
+	}
+
+	backoff_time = MIN(backoff_time, config->max_seconds);
+
+	return (uint32_t)backoff_time;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOUD_BACKOFF_H_ */
@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "app_common.h"
+#include "cloud_transport.h"
+
+LOG_MODULE_REGISTER(cloud_transport, CONFIG_APP_CLOUD_TRANSPORT_LOG_LEVEL);
+
+/* Timeout for claiming the next item of the batch, the storage module fills the batch
+ * buffer while it is being drained.
+ */
+#define CLAIM_TIMEOUT K_MSEC(500)
+
+/* Batch of items, either being filled or waiting for delivery */
+struct transport_batch {
+	uint32_t id;
+	bool done;
+
+	/* Types of the items in the batch, in read order */
+	size_t count;
+	enum storage_data_type types[CONFIG_APP_CLOUD_TRANSPORT_BATCH_MAX_ITEMS];
+};
+
+/* Storage batch session that is being uploaded. Only accessed from the thread of the cloud
+ * module that owns the session.
+ */
+static struct {
+	const struct cloud_transport *transport;
+	bool active;
+	uint32_t session_id;
+
+	/* All items have been claimed, or claiming has been stopped by an error */
+	bool drained;
+
+	/* Batches in flight, oldest at head */
+	struct transport_batch window[CONFIG_APP_CLOUD_TRANSPORT_WINDOW_MAX];
+	size_t head;
+	size_t count;
+
+	/* Session metrics */
+	uint32_t items_available;
+	uint32_t items_sent;
+	uint32_t batches_sent;
+	int64_t start_ms;
+} session;
+
+static void storage_msg_send(enum storage_msg_type type, uint32_t session_id,
+			     enum storage_data_type data_type, uint32_t data_len)
+{
+	int err;
+	const struct storage_msg msg = {
+		.type = type,
+		.session_id = session_id,
+		.data_type = data_type,
+		.data_len = data_len,
+	};
+
+	err = zbus_chan_pub(&storage_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+static size_t window_size(void)
+{
+	return CLAMP(session.transport->window, 1, ARRAY_SIZE(session.window));
+}
+
+static size_t batch_max_items(void)
+{
+	return CLAMP(session.transport->batch_max_items, 1,
+		     CONFIG_APP_CLOUD_TRANSPORT_BATCH_MAX_ITEMS);
+}
+
+/* Consume the items of a delivered batch, consecutive items of the same type with a single
+ * message.
+ */
+static void batch_consume(const struct transport_batch *batch)
+{
+	for (size_t i = 0; i < batch->count;) {
+		size_t run = 1;
+
+		while (((i + run) < batch->count) && (batch->types[i + run] == batch->types[i])) {
+			run++;
+		}
+
+		storage_msg_send(STORAGE_BATCH_CONSUME_N, session.session_id, batch->types[i], run);
+
+		i += run;
+	}
+
+	session.items_sent += batch->count;
+}
+
+/* Items must be consumed in the order they were read, so delivered batches are only consumed
+ * once all batches before them have been delivered.
+ */
+static void window_consume(void)
+{
+	while ((session.count > 0) && session.window[session.head].done) {
+		batch_consume(&session.window[session.head]);
+
+		session.head = (session.head + 1) % ARRAY_SIZE(session.window);
+		session.count--;
+	}
+}
+
+/* Send an item that cannot be batched and consume it. Returns 0 when the item has been
+ * handled, or a negative error code to stop the session.
+ */
+static int item_send(const struct storage_data_item *item)
+{
+	int err;
+
+	err = session.transport->send_one(item);
+	if ((err == -ENOTSUP) || (err == -EINVAL)) {
+		LOG_ERR("Data error sending data (type %d): %d", item->type, err);
+
+		/* Consume the malformed item to skip it */
+		storage_msg_send(STORAGE_BATCH_CONSUME, session.session_id, item->type, 0);
+
+		return 0;
+	} else if (err) {
+		LOG_WRN("Error sending data (type %d): %d", item->type, err);
+
+		return err;
+	}
+
+	storage_msg_send(STORAGE_BATCH_CONSUME, session.session_id, item->type, 0);
+	session.items_sent++;
+
+	return 0;
+}
+
+/* Claim items into a batch until it is full or the storage batch is drained */
+static int batch_fill(struct transport_batch *batch)
+{
+	int err;
+	const struct storage_data_item *item;
+	const struct cloud_transport *transport = session.transport;
+
+	batch->count = 0;
+	batch->done = false;
+
+	while (batch->count < batch_max_items()) {
+		if ((batch->count > 0) && (transport->batch_full != NULL) &&
+		    transport->batch_full()) {
+			break;
+		}
+
+		if (transport->priority_send != NULL) {
+			transport->priority_send();
+		}
+
+		/* Items are handled in place and released as soon as they have been handled */
+		err = storage_batch_claim(&item, CLAIM_TIMEOUT);
+		if (err == -EAGAIN) {
+			LOG_DBG("No more data available in batch (timeout)");
+			session.drained = true;
+
+			break;
+		} else if (err) {
+			LOG_ERR("storage_batch_claim, error: %d", err);
+
+			return err;
+		}
+
+		err = (transport->batch_add != NULL) ? transport->batch_add(item) : -ENOTSUP;
+		if ((err == 0) || (err == -EINVAL)) {
+			if (err) {
+				/* Consumed together with the batch to skip it */
+				LOG_ERR("Data error batching data (type %d): %d", item->type, err);
+			}
+
+			batch->types[batch->count++] = item->type;
+			storage_batch_release(item);
+
+			continue;
+		} else if (err != -ENOTSUP) {
+			LOG_ERR("Failed to add data to batch (type %d): %d", item->type, err);
+			storage_batch_release(item);
+
+			return err;
+		}
+
+		/* Data type cannot be batched, send it on its own */
+		err = item_send(item);
+		storage_batch_release(item);
+		if (err) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static void batch_discard(void)
+{
+	if (session.transport->batch_discard != NULL) {
+		session.transport->batch_discard();
+	}
+}
+
+/* Fill and send batches until the window is full or the storage batch is drained */
+static void session_send(void)
+{
+	int err;
+
+	while (!session.drained && (session.count < window_size())) {
+		struct transport_batch *batch =
+			&session.window[(session.head + session.count) % ARRAY_SIZE(session.window)];
+
+		err = batch_fill(batch);
+		if (err) {
+			/* Wait for the batches in flight and close the session */
+			batch_discard();
+			session.drained = true;
+
+			break;
+		} else if (batch->count == 0) {
+			continue;
+		}
+
+		err = session.transport->send_batch(batch->types, batch->count, &batch->id);
+		if (err == -EINPROGRESS) {
+			session.count++;
+			session.batches_sent++;
+
+			continue;
+		} else if (err) {
+			/* Items of the failed batch are not consumed and are retried in the next
+			 * session.
+			 */
+			LOG_WRN("Error sending batch of %zu items: %d", batch->count, err);
+			session.drained = true;
+
+			break;
+		}
+
+		batch->done = true;
+		session.count++;
+		session.batches_sent++;
+
+		window_consume();
+	}
+
+	if (session.drained && (session.count == 0)) {
+		cloud_transport_session_close();
+	}
+}
+
+int cloud_transport_session_start(const struct cloud_transport *transport,
+				  const struct storage_msg *msg)
+{
+	__ASSERT_NO_MSG(transport != NULL);
+	__ASSERT_NO_MSG(transport->send_one != NULL);
+	__ASSERT_NO_MSG((transport->batch_add == NULL) || (transport->send_batch != NULL));
+
+	if (session.active) {
+		LOG_WRN("Storage batch session already active, ignoring session %u",
+			msg->session_id);
+
+		return -EBUSY;
+	}
+
+	LOG_INF("Processing storage batch: %u items available", msg->data_len);
+
+	session.transport = transport;
+	session.active = true;
+	session.session_id = msg->session_id;
+	session.drained = false;
+	session.head = 0;
+	session.count = 0;
+	session.items_available = msg->data_len;
+	session.items_sent = 0;
+	session.batches_sent = 0;
+	session.start_ms = k_uptime_get();
+
+	session_send();
+
+	return 0;
+}
+
+bool cloud_transport_batch_done(uint32_t id, int result)
+{
+	struct transport_batch *batch = NULL;
+
+	if (!session.active) {
+		return false;
+	}
+
+	for (size_t i = 0; i < session.count; i++) {
+		struct transport_batch *entry =
+			&session.window[(session.head + i) % ARRAY_SIZE(session.window)];
+
+		if (!entry->done && (entry->id == id)) {
+			batch = entry;
+
+			break;
+		}
+	}
+
+	if (batch == NULL) {
+		return false;
+	}
+
+	if (result) {
+		LOG_WRN("Batch of %zu items not delivered: %d", batch->count, result);
+		cloud_transport_session_close();
+
+		return true;
+	}
+
+	batch->done = true;
+
+	window_consume();
+	session_send();
+
+	return true;
+}
+
+void cloud_transport_session_close(void)
+{
+	if (!session.active) {
+		return;
+	}
+
+	/* Batches still in flight are not consumed, they are sent again in the next session */
+	session.active = false;
+
+	batch_discard();
+
+	LOG_DBG("%s: %u/%u storage items sent in %u batches, %zu in flight, %lld ms",
+		session.transport->name, session.items_sent, session.items_available,
+		session.batches_sent, session.count, k_uptime_get() - session.start_ms);
+
+	if (session.transport->session_done != NULL) {
+		session.transport->session_done(session.items_sent);
+	}
+
+	storage_msg_send(STORAGE_BATCH_CLOSE, session.session_id, STORAGE_DATA_UNKNOWN, 0);
+}
+
+bool cloud_transport_session_active(void)
+{
+	return session.active;
+}
+
+void cloud_transport_session_reject(uint32_t session_id)
+{
+	storage_msg_send(STORAGE_BATCH_CLOSE, session_id, STORAGE_DATA_UNKNOWN, 0);
+}
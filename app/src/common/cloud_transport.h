@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _CLOUD_TRANSPORT_H_
+#define _CLOUD_TRANSPORT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+
+#include "storage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Cloud transport interface.
+ *
+ * This structure provides the function pointers that the storage batch upload engine uses to
+ * send stored data over a cloud transport (nRF Cloud CoAP, MQTT). The engine claims the items
+ * of a storage batch session, packs them into batches through the transport, keeps up to
+ * @ref window batches in flight, and consumes the items of each batch from storage in read
+ * order when the batch has been delivered.
+ *
+ * All functions are called from the thread of the cloud module that owns the session.
+ */
+struct cloud_transport {
+	/* Name of the transport, used in log messages */
+	const char *name;
+
+	/* Number of batches that can wait for delivery at the same time, 1 for transports
+	 * that deliver a batch before send_batch returns. At most
+	 * CONFIG_APP_CLOUD_TRANSPORT_WINDOW_MAX.
+	 */
+	size_t window;
+
+	/* Maximum number of items per batch, at most CONFIG_APP_CLOUD_TRANSPORT_BATCH_MAX_ITEMS */
+	size_t batch_max_items;
+
+	/**
+	 * @brief Check whether the pending batch has room for any item.
+	 *
+	 * Optional, can be NULL for batches that are only limited by batch_max_items.
+	 * Called before an item is claimed, as a claimed item cannot be handed back.
+	 *
+	 * @return true if the next item must go in a new batch
+	 */
+	bool (*batch_full)(void);
+
+	/**
+	 * @brief Add an item to the pending batch.
+	 *
+	 * Optional, can be NULL if the transport sends every item on its own. Items sent on
+	 * their own are consumed right away, so -ENOTSUP must be returned for all items of a
+	 * type or for none, to keep the items of each type in read order.
+	 *
+	 * @param item Claimed storage item, released by the engine when the function returns
+	 * @return 0 on success, -ENOTSUP if the item must be sent with send_one, -EINVAL if
+	 *	   the item is malformed and is skipped, other negative errno to stop the session
+	 */
+	int (*batch_add)(const struct storage_data_item *item);
+
+	/**
+	 * @brief Send the pending batch.
+	 *
+	 * The pending batch is empty when the function returns, whatever the result.
+	 *
+	 * @param types Types of the items in the batch, in read order
+	 * @param count Number of items in the batch
+	 * @param id Set to an identifier of the batch when -EINPROGRESS is returned
+	 * @return 0 when the batch has been delivered, -EINPROGRESS when delivery is reported
+	 *	   later with cloud_transport_batch_done(), other negative errno on failure
+	 */
+	int (*send_batch)(const enum storage_data_type *types, size_t count, uint32_t *id);
+
+	/**
+	 * @brief Drop the pending batch without sending it.
+	 *
+	 * Optional, can be NULL.
+	 */
+	void (*batch_discard)(void);
+
+	/**
+	 * @brief Send an item on its own.
+	 *
+	 * @param item Claimed storage item, released by the engine when the function returns
+	 * @return 0 when the item has been delivered, -ENOTSUP or -EINVAL if the item cannot
+	 *	   be sent and is skipped, other negative errno to stop the session
+	 */
+	int (*send_one)(const struct storage_data_item *item);
+
+	/**
+	 * @brief Send data that must not wait for the session to complete.
+	 *
+	 * Optional, can be NULL. Called before each item of the session is claimed, so that
+	 * urgent data is sent between stored items instead of behind all of them.
+	 */
+	void (*priority_send)(void);
+
+	/**
+	 * @brief Called when a session has been completed, before it is closed.
+	 *
+	 * Optional, can be NULL.
+	 *
+	 * @param items_sent Number of items delivered in the session
+	 */
+	void (*session_done)(uint32_t items_sent);
+};
+
+/**
+ * @brief Start uploading a storage batch session.
+ *
+ * Call on STORAGE_BATCH_AVAILABLE. Items are sent until the window is full or the batch is
+ * drained. For transports that deliver synchronously, the session has been closed when the
+ * function returns.
+ *
+ * @param transport Transport to send the items with
+ * @param msg STORAGE_BATCH_AVAILABLE message
+ *
+ * @retval 0 on success.
+ * @retval -EBUSY if a session is already active, the new session is left to the caller.
+ */
+int cloud_transport_session_start(const struct cloud_transport *transport,
+				  const struct storage_msg *msg);
+
+/**
+ * @brief Report the delivery result of a batch that was in flight.
+ *
+ * The items of delivered batches are consumed in read order, and more batches are sent. A
+ * failed batch closes the session.
+ *
+ * @param id Identifier returned by send_batch
+ * @param result 0 if the batch was delivered, negative errno otherwise
+ *
+ * @retval true if the identifier belongs to a batch of the active session.
+ * @retval false otherwise.
+ */
+bool cloud_transport_batch_done(uint32_t id, int result);
+
+/**
+ * @brief Close the active session.
+ *
+ * Items that have not been delivered stay in storage and are sent in the next session.
+ * Does nothing if no session is active.
+ */
+void cloud_transport_session_close(void);
+
+/**
+ * @brief Check whether a session has batches in flight.
+ *
+ * @retval true if a session is active.
+ * @retval false otherwise.
+ */
+bool cloud_transport_session_active(void);
+
+/**
+ * @brief Close a storage batch session without sending anything.
+ *
+ * Use for sessions that cannot be processed, and for STORAGE_BATCH_EMPTY and
+ * STORAGE_BATCH_ERROR.
+ *
+ * @param session_id Session ID of the storage batch session
+ */
+void cloud_transport_session_reject(uint32_t session_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOUD_TRANSPORT_H_ */
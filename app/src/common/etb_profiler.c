@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include <debug/etb_trace.h>
+
+#include "etb_profiler.h"
+
+/* Register log module */
+LOG_MODULE_REGISTER(etb_profiler, CONFIG_APP_ETB_PROFILER_LOG_LEVEL);
+
+/* Size of the ETB RAM of the nRF91 Series */
+#define ETB_SNAPSHOT_WORDS	(KB(2) / sizeof(uint32_t))
+
+/* Words per line of the shell dump */
+#define DUMP_LINE_WORDS		8
+
+#define SCENARIO_NONE		ETB_PROFILER_SCENARIO_COUNT
+
+struct etb_snapshot {
+	uint8_t scenario;
+	uint32_t uptime_ms;
+	uint32_t words;
+	uint32_t data[ETB_SNAPSHOT_WORDS];
+};
+
+/* Names used in the shell dump, matched by scripts/etb_profile.py */
+static const char *const scenario_names[] = {
+	[ETB_PROFILER_SCENARIO_SAMPLING] = "sampling",
+	[ETB_PROFILER_SCENARIO_BATCH_FLUSH] = "batch_flush",
+	[ETB_PROFILER_SCENARIO_FOTA] = "fota",
+	[ETB_PROFILER_SCENARIO_SHELL] = "shell",
+};
+
+BUILD_ASSERT(ARRAY_SIZE(scenario_names) == ETB_PROFILER_SCENARIO_COUNT,
+	     "A name is needed for each scenario");
+
+static struct etb_snapshot snapshots[CONFIG_APP_ETB_PROFILER_SNAPSHOTS];
+static size_t snapshot_count;
+
+/* Scenarios start and stop on the module threads and the shell, snapshots are taken in the
+ * timer handler.
+ */
+static struct k_spinlock lock;
+static enum etb_profiler_scenario active = SCENARIO_NONE;
+static int64_t active_since_ms;
+
+static void snapshot_timer_handler(struct k_timer *timer);
+static K_TIMER_DEFINE(snapshot_timer, snapshot_timer_handler, NULL);
+
+/* Copy the trace of the last interval out of the ETB, and start tracing again */
+static void snapshot_timer_handler(struct k_timer *timer)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	struct etb_snapshot *snapshot;
+
+	if (active == SCENARIO_NONE) {
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	if ((snapshot_count >= ARRAY_SIZE(snapshots)) ||
+	    ((k_uptime_get() - active_since_ms) > CONFIG_APP_ETB_PROFILER_SCENARIO_TIMEOUT_MS)) {
+		active = SCENARIO_NONE;
+		k_timer_stop(timer);
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	snapshot = &snapshots[snapshot_count++];
+
+	etb_trace_stop();
+
+	snapshot->words = etb_data_get(snapshot->data, ARRAY_SIZE(snapshot->data));
+	snapshot->scenario = active;
+	snapshot->uptime_ms = k_uptime_get_32();
+
+	etb_trace_start();
+
+	k_spin_unlock(&lock, key);
+}
+
+void etb_profiler_start(enum etb_profiler_scenario scenario)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if ((active != SCENARIO_NONE) || (snapshot_count >= ARRAY_SIZE(snapshots))) {
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	active = scenario;
+	active_since_ms = k_uptime_get();
+
+	/* Only the trace from the start of the scenario is kept in the first snapshot */
+	etb_trace_stop();
+	etb_trace_start();
+
+	k_spin_unlock(&lock, key);
+
+	k_timer_start(&snapshot_timer, K_MSEC(CONFIG_APP_ETB_PROFILER_INTERVAL_MS),
+		      K_MSEC(CONFIG_APP_ETB_PROFILER_INTERVAL_MS));
+
+	LOG_DBG("Profiling %s", scenario_names[scenario]);
+}
+
+void etb_profiler_stop(enum etb_profiler_scenario scenario)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if (active != scenario) {
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	active = SCENARIO_NONE;
+
+	k_spin_unlock(&lock, key);
+
+	k_timer_stop(&snapshot_timer);
+
+	LOG_DBG("Profiling of %s stopped, %zu snapshots taken", scenario_names[scenario],
+		snapshot_count);
+}
+
+static int cmd_start(const struct shell *shell, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	etb_profiler_start(ETB_PROFILER_SCENARIO_SHELL);
+
+	if (active != ETB_PROFILER_SCENARIO_SHELL) {
+		shell_error(shell, "Another scenario is profiled, or the snapshot buffer is full");
+		return -EBUSY;
+	}
+
+	return 0;
+}
+
+static int cmd_stop(const struct shell *shell, size_t argc, char **argv)
+{
+	ARG_UNUSED(shell);
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	etb_profiler_stop(ETB_PROFILER_SCENARIO_SHELL);
+
+	return 0;
+}
+
+static int cmd_status(const struct shell *shell, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "Snapshots: %zu of %zu, profiling: %s", snapshot_count,
+		    ARRAY_SIZE(snapshots),
+		    (active == SCENARIO_NONE) ? "none" : scenario_names[active]);
+
+	return 0;
+}
+
+/* Print the snapshots as hex, in the format read by scripts/etb_profile.py */
+static int cmd_dump(const struct shell *shell, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	if (active != SCENARIO_NONE) {
+		shell_error(shell, "Profiling of %s in progress, stop it first",
+			    scenario_names[active]);
+		return -EBUSY;
+	}
+
+	shell_print(shell, "etb_profile begin %zu", snapshot_count);
+
+	for (size_t i = 0; i < snapshot_count; i++) {
+		const struct etb_snapshot *snapshot = &snapshots[i];
+
+		shell_print(shell, "etb_snapshot %zu %s %u %u", i,
+			    scenario_names[snapshot->scenario], snapshot->uptime_ms,
+			    snapshot->words);
+
+		for (size_t j = 0; j < snapshot->words; j += DUMP_LINE_WORDS) {
+			char line[(DUMP_LINE_WORDS * 9) + 1];
+			size_t len = 0;
+
+			for (size_t k = j; k < MIN(j + DUMP_LINE_WORDS, snapshot->words); k++) {
+				len += snprintk(&line[len], sizeof(line) - len, "%08x ",
+						snapshot->data[k]);
+			}
+
+			shell_print(shell, "%s", line);
+		}
+	}
+
+	shell_print(shell, "etb_profile end");
+
+	return 0;
+}
+
+static int cmd_clear(const struct shell *shell, size_t argc, char **argv)
+{
+	k_spinlock_key_t key;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	key = k_spin_lock(&lock);
+
+	if (active == SCENARIO_NONE) {
+		snapshot_count = 0;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	if (snapshot_count != 0) {
+		shell_error(shell, "Profiling in progress, stop it first");
+		return -EBUSY;
+	}
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_cmds,
+	SHELL_CMD(start, NULL, "Start profiling until stopped", cmd_start),
+	SHELL_CMD(stop, NULL, "Stop profiling started from the shell", cmd_stop),
+	SHELL_CMD(status, NULL, "Show the number of snapshots taken", cmd_status),
+	SHELL_CMD(dump, NULL, "Print the snapshots for scripts/etb_profile.py", cmd_dump),
+	SHELL_CMD(clear, NULL, "Remove all snapshots", cmd_clear),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(att_etb_profiler, &sub_cmds, "ETB sampling profiler", NULL);
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _ETB_PROFILER_H_
+#define _ETB_PROFILER_H_
+
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Scenarios that are profiled, reported with each snapshot. */
+enum etb_profiler_scenario {
+	/* Sampling of the data sources, from the sample trigger until all sources are done */
+	ETB_PROFILER_SCENARIO_SAMPLING,
+
+	/* Sending of stored data, from the batch request until the batch session is closed */
+	ETB_PROFILER_SCENARIO_BATCH_FLUSH,
+
+	/* FOTA download */
+	ETB_PROFILER_SCENARIO_FOTA,
+
+	/* Started and stopped from the shell */
+	ETB_PROFILER_SCENARIO_SHELL,
+
+	ETB_PROFILER_SCENARIO_COUNT,
+};
+
+#if defined(CONFIG_APP_ETB_PROFILER)
+
+/**
+ * @brief Start taking ETB snapshots for a scenario.
+ *
+ * A snapshot of the ETB is taken every CONFIG_APP_ETB_PROFILER_INTERVAL_MS, until the scenario
+ * is stopped, CONFIG_APP_ETB_PROFILER_SCENARIO_TIMEOUT_MS has passed or the snapshot buffer is
+ * full. Ignored while another scenario is profiled.
+ *
+ * @param scenario Scenario that starts.
+ */
+void etb_profiler_start(enum etb_profiler_scenario scenario);
+
+/**
+ * @brief Stop taking ETB snapshots for a scenario.
+ *
+ * Ignored if the scenario is not the one being profiled.
+ *
+ * @param scenario Scenario that ends.
+ */
+void etb_profiler_stop(enum etb_profiler_scenario scenario);
+
+#else
+
+static inline void etb_profiler_start(enum etb_profiler_scenario scenario)
+{
+	ARG_UNUSED(scenario);
+}
+
+static inline void etb_profiler_stop(enum etb_profiler_scenario scenario)
+{
+	ARG_UNUSED(scenario);
+}
+
+#endif /* CONFIG_APP_ETB_PROFILER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ETB_PROFILER_H_ */
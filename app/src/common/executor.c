@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/task_wdt/task_wdt.h>
+#include <zephyr/smf.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "app_common.h"
+#include "executor.h"
+#include "zbus_stats.h"
+
+/* Register log module */
+LOG_MODULE_REGISTER(executor, CONFIG_APP_EXECUTOR_LOG_LEVEL);
+
+BUILD_ASSERT(CONFIG_APP_EXECUTOR_WATCHDOG_TIMEOUT_SECONDS >
+	     CONFIG_APP_EXECUTOR_MSG_PROCESSING_TIMEOUT_SECONDS,
+	     "Watchdog timeout must be greater than maximum message processing time");
+
+/* Modules in priority order, with one poll event each for their subscriber queue */
+static const struct executor_module *modules[CONFIG_APP_EXECUTOR_MODULES_MAX];
+static struct k_poll_event events[CONFIG_APP_EXECUTOR_MODULES_MAX];
+static size_t module_count;
+
+static void executor_wdt_callback(int channel_id, void *user_data)
+{
+	LOG_ERR("Watchdog expired, Channel: %d, Thread: %s",
+		channel_id, k_thread_name_get((k_tid_t)user_data));
+
+	SEND_FATAL_ERROR_WATCHDOG_TIMEOUT();
+}
+
+static void module_add(const struct executor_module *module)
+{
+	size_t i = module_count;
+
+	/* Insert sorted by priority, modules of the same priority keep their link order */
+	while ((i > 0) && (modules[i - 1]->priority > module->priority)) {
+		modules[i] = modules[i - 1];
+		i--;
+	}
+
+	modules[i] = module;
+	module_count++;
+}
+
+static int modules_init(void)
+{
+	int err;
+
+	STRUCT_SECTION_FOREACH(executor_module, module) {
+		if (module_count == ARRAY_SIZE(modules)) {
+			LOG_ERR("More than %d modules, increase CONFIG_APP_EXECUTOR_MODULES_MAX",
+				CONFIG_APP_EXECUTOR_MODULES_MAX);
+			return -ENOMEM;
+		}
+
+		if (module->init) {
+			err = module->init();
+			if (err) {
+				LOG_ERR("Failed to initialize %s module, error: %d",
+					module->name, err);
+				continue;
+			}
+		}
+
+		module_add(module);
+	}
+
+	for (size_t i = 0; i < module_count; i++) {
+		k_poll_event_init(&events[i], K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, modules[i]->subscriber->message_fifo);
+	}
+
+	LOG_DBG("Running %zu modules", module_count);
+
+	return 0;
+}
+
+/* Process one message of the module with the highest priority that has a message queued */
+static int message_process(void)
+{
+	int err;
+
+	for (size_t i = 0; i < module_count; i++) {
+		const struct executor_module *module = modules[i];
+
+		if (events[i].state != K_POLL_STATE_FIFO_DATA_AVAILABLE) {
+			continue;
+		}
+
+		err = zbus_sub_wait_msg(module->subscriber, module->chan, module->msg_buf,
+					K_NO_WAIT);
+		if (err == -ENOMSG) {
+			continue;
+		} else if (err) {
+			LOG_ERR("zbus_sub_wait_msg, %s module, error: %d", module->name, err);
+			return err;
+		}
+
+		zbus_stats_received(module->subscriber, *module->chan);
+
+		handler_stats_start(module->handlers, *module->chan);
+		err = smf_run_state(module->ctx);
+		handler_stats_end(module->handlers);
+		if (err) {
+			LOG_ERR("smf_run_state(), %s module, error: %d", module->name, err);
+			return err;
+		}
+
+		state_stats_update(module->stats, module->ctx);
+
+		return 0;
+	}
+
+	return 0;
+}
+
+static void executor_thread(void)
+{
+	int err;
+	int task_wdt_id;
+	const uint32_t wdt_timeout_ms =
+		(CONFIG_APP_EXECUTOR_WATCHDOG_TIMEOUT_SECONDS * MSEC_PER_SEC);
+	const uint32_t execution_time_ms =
+		(CONFIG_APP_EXECUTOR_MSG_PROCESSING_TIMEOUT_SECONDS * MSEC_PER_SEC);
+	const k_timeout_t poll_wait_ms = K_MSEC(wdt_timeout_ms - execution_time_ms);
+
+	LOG_DBG("Executor task started");
+
+	task_wdt_id = task_wdt_add(wdt_timeout_ms, executor_wdt_callback, (void *)k_current_get());
+	if (task_wdt_id < 0) {
+		LOG_ERR("Failed to add task to watchdog: %d", task_wdt_id);
+		SEND_FATAL_ERROR();
+		return;
+	}
+
+	err = modules_init();
+	if (err) {
+		SEND_FATAL_ERROR();
+		return;
+	}
+
+	while (true) {
+		err = task_wdt_feed(task_wdt_id);
+		if (err) {
+			LOG_ERR("task_wdt_feed, error: %d", err);
+			SEND_FATAL_ERROR();
+			return;
+		}
+
+		for (size_t i = 0; i < module_count; i++) {
+			events[i].state = K_POLL_STATE_NOT_READY;
+		}
+
+		/* Queues that already hold messages are reported as ready right away */
+		err = k_poll(events, module_count, poll_wait_ms);
+		if (err == -EAGAIN) {
+			continue;
+		} else if (err) {
+			LOG_ERR("k_poll, error: %d", err);
+			SEND_FATAL_ERROR();
+			return;
+		}
+
+		err = message_process();
+		if (err) {
+			SEND_FATAL_ERROR();
+			return;
+		}
+	}
+}
+
+K_THREAD_DEFINE(executor_thread_id,
+		CONFIG_APP_EXECUTOR_THREAD_STACK_SIZE,
+		executor_thread, NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
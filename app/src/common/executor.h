@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _EXECUTOR_H_
+#define _EXECUTOR_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/smf.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "state_stats.h"
+#include "handler_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Module that runs on the shared executor thread instead of a thread of its own.
+ *
+ * Use EXECUTOR_MODULE_DEFINE() to register a module.
+ */
+struct executor_module {
+	/* Name of the module, used in logs */
+	const char *name;
+
+	/* Message subscriber of the module */
+	const struct zbus_observer *subscriber;
+
+	/* Set to the channel of the message being processed */
+	const struct zbus_channel **chan;
+
+	/* Buffer for the message being processed, large enough for all observed channels */
+	void *msg_buf;
+
+	/* State machine of the module, run with the message in msg_buf */
+	struct smf_ctx *ctx;
+
+	/* State statistics of the module, NULL when disabled */
+	struct state_stats *stats;
+
+	/* Message handling time statistics of the module, NULL when disabled */
+	struct handler_stats *handlers;
+
+	/* Called on the executor thread before the first message, may be NULL.
+	 * Must set the initial state of the state machine. A module that fails to initialize is
+	 * not run.
+	 */
+	int (*init)(void);
+
+	/* Priority of the module, modules with a lower value are run first */
+	uint8_t priority;
+};
+
+/**
+ * @brief Register a module to run on the shared executor thread.
+ *
+ * The state object must have the `ctx`, `chan` and `msg_buf` members that the modules
+ * use with zbus_sub_wait_msg() and smf_run_state() in their threads. The statistics defined
+ * with STATE_STATS_DEFINE() and HANDLER_STATS_DEFINE() under the same name are updated by the
+ * executor.
+ *
+ * @param _name Name of the module.
+ * @param _subscriber Message subscriber defined with ZBUS_MSG_SUBSCRIBER_DEFINE().
+ * @param _state State object of the module.
+ * @param _init Initialization function, see struct executor_module.
+ * @param _priority Priority of the module, see struct executor_module.
+ */
+#define EXECUTOR_MODULE_DEFINE(_name, _subscriber, _state, _init, _priority)		\
+	STRUCT_SECTION_ITERABLE(executor_module, _name##_executor_module) = {		\
+		.name = STRINGIFY(_name),						\
+		.subscriber = &(_subscriber),						\
+		.chan = &(_state).chan,							\
+		.msg_buf = (_state).msg_buf,						\
+		.ctx = SMF_CTX(&(_state)),						\
+		.stats = STATE_STATS_GET(_name),					\
+		.handlers = HANDLER_STATS_GET(_name),					\
+		.init = (_init),							\
+		.priority = (_priority),						\
+	}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _EXECUTOR_H_ */
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+#if defined(CONFIG_APP_HANDLER_STATS_SHELL)
+#include <zephyr/shell/shell.h>
+#endif /* CONFIG_APP_HANDLER_STATS_SHELL */
+
+#include "handler_stats.h"
+
+/* Register log module */
+LOG_MODULE_REGISTER(handler_stats, CONFIG_APP_HANDLER_STATS_LOG_LEVEL);
+
+BUILD_ASSERT(CONFIG_APP_HANDLER_STATS_WARN_PERCENT < CONFIG_APP_HANDLER_STATS_CRITICAL_PERCENT,
+	     "The warning level must be below the critical level");
+
+/* Upper limits of the handling time histogram buckets, in percent of the processing budget */
+static const uint32_t bucket_limits_pct[HANDLER_STATS_BUCKETS] = {
+	10, 25, 50, 80, 100, UINT32_MAX
+};
+
+/* Handling starts and ends on the module threads, reads come from the shell, the Memfault
+ * heartbeat and the watchdog callbacks.
+ */
+static struct k_spinlock lock;
+
+static uint32_t budget_pct(const struct handler_stats *stats, uint32_t time_ms)
+{
+	return (uint32_t)MIN(((uint64_t)time_ms * 100) / MAX(stats->budget_ms, 1), UINT32_MAX);
+}
+
+static struct handler_stats_entry *entry_get(struct handler_stats *stats,
+					     const struct zbus_channel *chan)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(stats->entries); i++) {
+		struct handler_stats_entry *entry = &stats->entries[i];
+
+		if (entry->chan == chan) {
+			return entry;
+		}
+
+		if (entry->chan == NULL) {
+			entry->chan = chan;
+
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+void handler_stats_start(struct handler_stats *stats, const struct zbus_channel *chan)
+{
+	k_spinlock_key_t key;
+
+	if (stats == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+
+	stats->running_chan = chan;
+	stats->running_since_ms = k_uptime_get();
+
+	k_spin_unlock(&lock, key);
+}
+
+void handler_stats_end(struct handler_stats *stats)
+{
+	const struct zbus_channel *chan;
+	struct handler_stats_entry *entry;
+	uint32_t time_ms;
+	uint32_t pct;
+	size_t bucket = 0;
+	k_spinlock_key_t key;
+
+	if ((stats == NULL) || (stats->running_chan == NULL)) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+
+	chan = stats->running_chan;
+	time_ms = (uint32_t)MIN(k_uptime_get() - stats->running_since_ms, UINT32_MAX);
+	pct = budget_pct(stats, time_ms);
+
+	while ((bucket < HANDLER_STATS_BUCKETS - 1) && (pct >= bucket_limits_pct[bucket])) {
+		bucket++;
+	}
+
+	stats->running_chan = NULL;
+	stats->interval_max_ms = MAX(stats->interval_max_ms, time_ms);
+
+	entry = entry_get(stats, chan);
+	if (entry) {
+		entry->count++;
+		entry->buckets[bucket]++;
+		entry->max_ms = MAX(entry->max_ms, time_ms);
+	}
+
+	k_spin_unlock(&lock, key);
+
+	if (entry == NULL) {
+		LOG_DBG("%s: no entry for %s, increase CONFIG_APP_HANDLER_STATS_CHANNELS_MAX",
+			stats->name, zbus_chan_name(chan));
+	}
+
+	if (pct >= CONFIG_APP_HANDLER_STATS_CRITICAL_PERCENT) {
+		LOG_ERR("%s: handling a message from %s took %u ms, %u %% of the processing budget",
+			stats->name, zbus_chan_name(chan), time_ms, pct);
+	} else if (pct >= CONFIG_APP_HANDLER_STATS_WARN_PERCENT) {
+		LOG_WRN("%s: handling a message from %s took %u ms, %u %% of the processing budget",
+			stats->name, zbus_chan_name(chan), time_ms, pct);
+	}
+}
+
+void handler_stats_report_running(void)
+{
+	const struct zbus_channel *chan;
+	int64_t since_ms;
+	k_spinlock_key_t key;
+
+	STRUCT_SECTION_FOREACH(handler_stats, stats) {
+		key = k_spin_lock(&lock);
+		chan = stats->running_chan;
+		since_ms = stats->running_since_ms;
+		k_spin_unlock(&lock, key);
+
+		if (chan == NULL) {
+			continue;
+		}
+
+		LOG_ERR("%s: handling a message from %s for %lld ms",
+			stats->name, zbus_chan_name(chan), k_uptime_get() - since_ms);
+	}
+}
+
+#if defined(CONFIG_APP_HANDLER_STATS_SHELL)
+static int cmd_handler_stats(const struct shell *shell, size_t argc, char **argv)
+{
+	struct handler_stats_entry entry;
+	k_spinlock_key_t key;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	STRUCT_SECTION_FOREACH(handler_stats, stats) {
+		shell_print(shell, "%s: processing budget %u ms", stats->name, stats->budget_ms);
+
+		for (size_t i = 0; i < ARRAY_SIZE(stats->entries); i++) {
+			key = k_spin_lock(&lock);
+			entry = stats->entries[i];
+			k_spin_unlock(&lock, key);
+
+			if (entry.chan == NULL) {
+				break;
+			}
+
+			shell_print(shell,
+				    "  %s: handled %u, max %u ms (%u %%), "
+				    "<10%%: %u, <25%%: %u, <50%%: %u, <80%%: %u, <100%%: %u, "
+				    "over: %u",
+				    zbus_chan_name(entry.chan), entry.count, entry.max_ms,
+				    budget_pct(stats, entry.max_ms), entry.buckets[0],
+				    entry.buckets[1], entry.buckets[2], entry.buckets[3],
+				    entry.buckets[4], entry.buckets[5]);
+		}
+	}
+
+	return 0;
+}
+
+SHELL_CMD_REGISTER(att_handler_stats,
+		   NULL,
+		   "Print the message handling times of all modules",
+		   cmd_handler_stats);
+#endif /* CONFIG_APP_HANDLER_STATS_SHELL */
+
+#if defined(CONFIG_APP_HANDLER_STATS_MEMFAULT)
+void handler_stats_heartbeat_collect(void)
+{
+	uint32_t max_ms;
+	k_spinlock_key_t key;
+
+	STRUCT_SECTION_FOREACH(handler_stats_metric, metric) {
+		key = k_spin_lock(&lock);
+		max_ms = metric->stats->interval_max_ms;
+		metric->stats->interval_max_ms = 0;
+		k_spin_unlock(&lock, key);
+
+		metric->set(budget_pct(metric->stats, max_ms));
+	}
+}
+#endif /* CONFIG_APP_HANDLER_STATS_MEMFAULT */
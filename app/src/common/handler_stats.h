@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _HANDLER_STATS_H_
+#define _HANDLER_STATS_H_
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <zephyr/zbus/zbus.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct handler_stats;
+
+#if defined(CONFIG_APP_HANDLER_STATS)
+
+/* Number of handling time histogram buckets, see handler_stats.c for the bucket limits */
+#define HANDLER_STATS_BUCKETS 6
+
+/** @brief Handling time statistics of the messages of one channel. */
+struct handler_stats_entry {
+	/* Channel of the messages, NULL for an unused entry */
+	const struct zbus_channel *chan;
+
+	/* Number of messages handled */
+	uint32_t count;
+
+	/* Number of messages per handling time bucket, relative to the processing budget */
+	uint32_t buckets[HANDLER_STATS_BUCKETS];
+
+	/* Longest handling time, in milliseconds */
+	uint32_t max_ms;
+};
+
+/**
+ * @brief Message handling time statistics of a module.
+ *
+ * Use HANDLER_STATS_DEFINE() to define the statistics of a module.
+ */
+struct handler_stats {
+	/* Name of the module, used in logs and in the shell */
+	const char *name;
+
+	/* Maximum message processing time of the module, in milliseconds */
+	uint32_t budget_ms;
+
+	/* One entry per channel the module has received messages on */
+	struct handler_stats_entry entries[CONFIG_APP_HANDLER_STATS_CHANNELS_MAX];
+
+	/* Channel of the message being handled, NULL when the module is waiting for messages */
+	const struct zbus_channel *running_chan;
+	int64_t running_since_ms;
+
+	/* Longest handling time since the previous Memfault heartbeat */
+	uint32_t interval_max_ms;
+};
+
+/**
+ * @brief Define the message handling time statistics of a module.
+ *
+ * @param _name Name of the module.
+ * @param _budget_seconds Maximum message processing time of the module, in seconds.
+ */
+#define HANDLER_STATS_DEFINE(_name, _budget_seconds)					\
+	STRUCT_SECTION_ITERABLE(handler_stats, _name##_handler_stats) = {		\
+		.name = STRINGIFY(_name),						\
+		.budget_ms = (_budget_seconds) * MSEC_PER_SEC,				\
+	}
+
+/** @brief Get a pointer to the handling time statistics of a module, NULL when disabled. */
+#define HANDLER_STATS_GET(_name) (&_name##_handler_stats)
+
+/**
+ * @brief Mark the start of handling a message, call right before smf_run_state().
+ *
+ * @param _name Name of the module given to HANDLER_STATS_DEFINE().
+ * @param _chan Channel the message was received on.
+ */
+#define HANDLER_STATS_START(_name, _chan) handler_stats_start(HANDLER_STATS_GET(_name), (_chan))
+
+/**
+ * @brief Mark the end of handling a message, call right after smf_run_state().
+ *
+ * @param _name Name of the module given to HANDLER_STATS_DEFINE().
+ */
+#define HANDLER_STATS_END(_name) handler_stats_end(HANDLER_STATS_GET(_name))
+
+/**
+ * @brief Record the start of handling a message.
+ *
+ * @param stats Handling time statistics, may be NULL.
+ * @param chan Channel the message was received on.
+ */
+void handler_stats_start(struct handler_stats *stats, const struct zbus_channel *chan);
+
+/**
+ * @brief Record the end of handling a message.
+ *
+ * Logs a warning if the handling time exceeds CONFIG_APP_HANDLER_STATS_WARN_PERCENT or
+ * CONFIG_APP_HANDLER_STATS_CRITICAL_PERCENT of the processing budget.
+ *
+ * @param stats Handling time statistics, may be NULL.
+ */
+void handler_stats_end(struct handler_stats *stats);
+
+/**
+ * @brief Log the messages that are being handled by any module, and for how long.
+ *
+ * Called on watchdog timeouts, so that the log that goes with the coredump shows which handler
+ * starved the watchdog.
+ */
+void handler_stats_report_running(void);
+
+#else
+
+#define HANDLER_STATS_DEFINE(_name, _budget_seconds)
+#define HANDLER_STATS_GET(_name) NULL
+#define HANDLER_STATS_START(_name, _chan) do {} while (0)
+#define HANDLER_STATS_END(_name) do {} while (0)
+
+static inline void handler_stats_start(struct handler_stats *stats,
+				       const struct zbus_channel *chan)
+{
+	ARG_UNUSED(stats);
+	ARG_UNUSED(chan);
+}
+
+static inline void handler_stats_end(struct handler_stats *stats)
+{
+	ARG_UNUSED(stats);
+}
+
+#endif /* CONFIG_APP_HANDLER_STATS */
+
+#if defined(CONFIG_APP_HANDLER_STATS_MEMFAULT)
+#include <memfault/metrics/metrics.h>
+
+/** @brief Module that is exported as Memfault heartbeat metrics. */
+struct handler_stats_metric {
+	struct handler_stats *stats;
+
+	/* Sets the metrics of the heartbeat */
+	void (*set)(uint32_t max_pct);
+};
+
+/**
+ * @brief Export the handling time statistics of a module as Memfault heartbeat metrics.
+ *
+ * The longest handling time during each heartbeat interval, in percent of the processing
+ * budget, is reported as the `<_name>_handler_max_pct` metric, which must be defined in
+ * memfault_metrics_heartbeat_config.def.
+ *
+ * @param _name Name of the module given to HANDLER_STATS_DEFINE().
+ */
+#define HANDLER_STATS_METRIC_DEFINE(_name)						\
+	static void _name##_handler_metric_set(uint32_t max_pct)			\
+	{										\
+		MEMFAULT_METRIC_SET_UNSIGNED(_name##_handler_max_pct, max_pct);		\
+	}										\
+	STRUCT_SECTION_ITERABLE(handler_stats_metric, _name##_handler_stats_metric) = {	\
+		.stats = HANDLER_STATS_GET(_name),					\
+		.set = _name##_handler_metric_set,					\
+	}
+
+/** @brief Report the handling time statistics of the heartbeat interval to Memfault. */
+void handler_stats_heartbeat_collect(void);
+
+#else
+
+#define HANDLER_STATS_METRIC_DEFINE(_name)
+
+#endif /* CONFIG_APP_HANDLER_STATS_MEMFAULT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HANDLER_STATS_H_ */
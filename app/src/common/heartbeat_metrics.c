@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <memfault/metrics/metrics.h>
+
+#include "state_stats.h"
+#include "zbus_stats.h"
+#include "handler_stats.h"
+#include "mem_stats.h"
+#if defined(CONFIG_APP_CLOUD_STATS_MEMFAULT)
+#include "cloud_stats.h"
+#endif /* CONFIG_APP_CLOUD_STATS_MEMFAULT */
+
+/* Called by Memfault at the end of each heartbeat interval */
+void memfault_metrics_heartbeat_collect_data(void)
+{
+#if defined(CONFIG_APP_STATE_STATS_MEMFAULT)
+	state_stats_heartbeat_collect();
+#endif /* CONFIG_APP_STATE_STATS_MEMFAULT */
+
+#if defined(CONFIG_APP_ZBUS_STATS_MEMFAULT)
+	zbus_stats_heartbeat_collect();
+#endif /* CONFIG_APP_ZBUS_STATS_MEMFAULT */
+
+#if defined(CONFIG_APP_HANDLER_STATS_MEMFAULT)
+	handler_stats_heartbeat_collect();
+#endif /* CONFIG_APP_HANDLER_STATS_MEMFAULT */
+
+#if defined(CONFIG_APP_MEM_STATS_MEMFAULT)
+	mem_stats_heartbeat_collect();
+#endif /* CONFIG_APP_MEM_STATS_MEMFAULT */
+
+#if defined(CONFIG_APP_CLOUD_STATS_MEMFAULT)
+	cloud_stats_heartbeat_collect();
+#endif /* CONFIG_APP_CLOUD_STATS_MEMFAULT */
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+
+#include "lz4_block.h"
+
+/* LZ4 block format limits: a match is at least 4 bytes, the last 5 bytes are literals and
+ * the last match starts at least 12 bytes before the end of the block.
+ */
+#define LZ4_MIN_MATCH		4
+#define LZ4_LAST_LITERALS	5
+#define LZ4_MATCH_LIMIT		12
+#define LZ4_HASH_BITS		10
+
+/* Shared by all calls, the encoder is not reentrant */
+static uint16_t hash_table[BIT(LZ4_HASH_BITS)];
+
+/* Write an LZ4 length that does not fit in the 4 bits of the token */
+static size_t lz4_length_put(uint8_t *dst, size_t op, size_t len)
+{
+	for (len -= 15; len >= 255; len -= 255) {
+		dst[op++] = 255;
+	}
+
+	dst[op++] = (uint8_t)len;
+
+	return op;
+}
+
+/* Write a sequence of literals followed by a match, match_len is 0 for the last sequence.
+ * Returns the new output position, or 0 if the sequence does not fit.
+ */
+static size_t lz4_sequence_put(uint8_t *dst, size_t dst_size, size_t op, const uint8_t *lit,
+			       size_t lit_len, size_t offset, size_t match_len)
+{
+	size_t needed = 1 + (lit_len / 255) + 1 + lit_len;
+	uint8_t *token = &dst[op];
+
+	if (match_len > 0) {
+		needed += sizeof(uint16_t) + ((match_len - LZ4_MIN_MATCH) / 255) + 1;
+	}
+
+	if ((op + needed) > dst_size) {
+		return 0;
+	}
+
+	op++;
+	*token = MIN(lit_len, 15) << 4;
+
+	if (lit_len >= 15) {
+		op = lz4_length_put(dst, op, lit_len);
+	}
+
+	memcpy(&dst[op], lit, lit_len);
+	op += lit_len;
+
+	if (match_len == 0) {
+		return op;
+	}
+
+	sys_put_le16((uint16_t)offset, &dst[op]);
+	op += sizeof(uint16_t);
+
+	match_len -= LZ4_MIN_MATCH;
+	*token |= MIN(match_len, 15);
+
+	if (match_len >= 15) {
+		op = lz4_length_put(dst, op, match_len);
+	}
+
+	return op;
+}
+
+size_t lz4_block_compress(const uint8_t *src, size_t len, uint8_t *dst, size_t dst_size)
+{
+	size_t ip = 0;
+	size_t anchor = 0;
+	size_t op = 0;
+
+	/* Positions are stored plus one, so that zero marks an empty entry */
+	memset(hash_table, 0, sizeof(hash_table));
+
+	while ((ip + LZ4_MATCH_LIMIT) < len) {
+		uint32_t sequence = sys_get_le32(&src[ip]);
+		uint32_t hash = (sequence * 2654435761U) >> (32 - LZ4_HASH_BITS);
+		size_t ref = hash_table[hash];
+		size_t match_len = LZ4_MIN_MATCH;
+
+		hash_table[hash] = (uint16_t)(ip + 1);
+
+		if ((ref == 0) || (sys_get_le32(&src[ref - 1]) != sequence)) {
+			ip++;
+			continue;
+		}
+
+		ref--;
+
+		while (((ip + match_len) < (len - LZ4_LAST_LITERALS)) &&
+		       (src[ref + match_len] == src[ip + match_len])) {
+			match_len++;
+		}
+
+		op = lz4_sequence_put(dst, dst_size, op, &src[anchor], ip - anchor, ip - ref,
+				      match_len);
+		if (op == 0) {
+			return 0;
+		}
+
+		ip += match_len;
+		anchor = ip;
+	}
+
+	return lz4_sequence_put(dst, dst_size, op, &src[anchor], len - anchor, 0, 0);
+}
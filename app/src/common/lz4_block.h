@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _LZ4_BLOCK_H_
+#define _LZ4_BLOCK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Compress a block in the LZ4 block format.
+ *
+ * A single pass over a small hash table, suited for blocks of up to 64 kB. The encoder keeps
+ * the limits of the format: the last 5 bytes are literals, and the last match starts at least
+ * 12 bytes before the end of the block. Not reentrant, the hash table is shared.
+ *
+ * @param[in]  src      Data to compress.
+ * @param[in]  len      Length of the data, at most 65535 bytes.
+ * @param[out] dst      Buffer for the compressed block, may not overlap src.
+ * @param[in]  dst_size Size of dst.
+ *
+ * @return Size of the compressed block, or 0 if it does not fit in dst_size bytes.
+ */
+size_t lz4_block_compress(const uint8_t *src, size_t len, uint8_t *dst, size_t dst_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LZ4_BLOCK_H_ */
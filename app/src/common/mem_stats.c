@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#if defined(CONFIG_APP_MEM_STATS_SHELL)
+#include <zephyr/shell/shell.h>
+#endif /* CONFIG_APP_MEM_STATS_SHELL */
+
+#include "mem_stats.h"
+
+/* Updates come from the module threads, reads from the shell and the Memfault heartbeat */
+static struct k_spinlock lock;
+
+static uint32_t percent(size_t part, size_t whole)
+{
+	if (whole == 0) {
+		return 0;
+	}
+
+	return (uint32_t)((part * 100) / whole);
+}
+
+void mem_stats_buffer_update(struct mem_stats_buffer *buffer, size_t used)
+{
+	k_spinlock_key_t key;
+
+	if (buffer == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+
+	buffer->used = used;
+	buffer->peak = MAX(buffer->peak, used);
+	buffer->interval_peak = MAX(buffer->interval_peak, used);
+
+	k_spin_unlock(&lock, key);
+}
+
+int mem_stats_stack_get(const struct k_thread *thread, size_t *size, size_t *used)
+{
+	int err;
+	size_t unused;
+
+	err = k_thread_stack_space_get(thread, &unused);
+	if (err) {
+		return -ENOTSUP;
+	}
+
+	*size = thread->stack_info.size;
+	*used = *size - unused;
+
+	return 0;
+}
+
+#if defined(CONFIG_APP_MEM_STATS_SHELL)
+static void shell_thread_print(const struct k_thread *thread, void *user_data)
+{
+	const struct shell *shell = user_data;
+	const char *name = k_thread_name_get((k_tid_t)thread);
+	size_t size;
+	size_t used;
+
+	if (mem_stats_stack_get(thread, &size, &used)) {
+		return;
+	}
+
+	shell_print(shell, "  %-32s stack %5zu bytes, max used %5zu bytes (%u %%)",
+		    ((name != NULL) && (name[0] != '\0')) ? name : "(unnamed)",
+		    size, used, percent(used, size));
+}
+
+static int cmd_mem_stats(const struct shell *shell, size_t argc, char **argv)
+{
+	struct mem_stats_buffer buffer;
+	k_spinlock_key_t key;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "Threads:");
+	k_thread_foreach_unlocked(shell_thread_print, (void *)shell);
+
+	shell_print(shell, "Buffers:");
+
+	STRUCT_SECTION_FOREACH(mem_stats_buffer, stats) {
+		key = k_spin_lock(&lock);
+		buffer = *stats;
+		k_spin_unlock(&lock, key);
+
+		shell_print(shell, "  %-32s size %5zu bytes, used %5zu bytes, peak %5zu bytes (%u %%)",
+			    buffer.name, buffer.size, buffer.used, buffer.peak,
+			    percent(buffer.peak, buffer.size));
+	}
+
+	return 0;
+}
+
+SHELL_CMD_REGISTER(att_mem_stats,
+		   NULL,
+		   "Print the stack high-water marks of all threads and the buffer fill levels",
+		   cmd_mem_stats);
+#endif /* CONFIG_APP_MEM_STATS_SHELL */
+
+#if defined(CONFIG_APP_MEM_STATS_MEMFAULT)
+/* The module threads, some of them do not exist when the modules run on the executor */
+MEM_STATS_THREAD_METRIC_DEFINE(main, main);
+MEM_STATS_THREAD_METRIC_DEFINE(executor_thread_id, executor);
+MEM_STATS_THREAD_METRIC_DEFINE(cloud_module_thread_id, cloud);
+MEM_STATS_THREAD_METRIC_DEFINE(storage_thread_id, storage);
+MEM_STATS_THREAD_METRIC_DEFINE(network_module_thread_id, network);
+MEM_STATS_THREAD_METRIC_DEFINE(location_module_thread_id, location);
+MEM_STATS_THREAD_METRIC_DEFINE(fota_module_thread_id, fota);
+MEM_STATS_THREAD_METRIC_DEFINE(power_module_thread_id, power);
+MEM_STATS_THREAD_METRIC_DEFINE(environmental_module_thread_id, environmental);
+
+/* All buffers of a group share one size option, so the fullest one is reported */
+MEM_STATS_BUFFER_METRIC_DEFINE(storage_pipe, storage_pipe);
+MEM_STATS_BUFFER_METRIC_DEFINE(storage_ram, storage_ram);
+
+static void heartbeat_thread_collect(const struct k_thread *thread, void *user_data)
+{
+	const char *name = k_thread_name_get((k_tid_t)thread);
+	size_t size;
+	size_t used;
+
+	ARG_UNUSED(user_data);
+
+	if ((name == NULL) || mem_stats_stack_get(thread, &size, &used)) {
+		return;
+	}
+
+	STRUCT_SECTION_FOREACH(mem_stats_thread_metric, metric) {
+		if (strcmp(metric->thread_name, name) == 0) {
+			metric->set(percent(used, size));
+		}
+	}
+}
+
+void mem_stats_heartbeat_collect(void)
+{
+	k_spinlock_key_t key;
+
+	k_thread_foreach_unlocked(heartbeat_thread_collect, NULL);
+
+	STRUCT_SECTION_FOREACH(mem_stats_buffer_metric, metric) {
+		uint32_t peak_pct = 0;
+		bool found = false;
+
+		key = k_spin_lock(&lock);
+
+		STRUCT_SECTION_FOREACH(mem_stats_buffer, buffer) {
+			if (strcmp(buffer->group, metric->group) != 0) {
+				continue;
+			}
+
+			peak_pct = MAX(peak_pct, percent(buffer->interval_peak, buffer->size));
+			found = true;
+
+			/* Start the next interval at the current fill level */
+			buffer->interval_peak = buffer->used;
+		}
+
+		k_spin_unlock(&lock, key);
+
+		if (found) {
+			metric->set(peak_pct);
+		}
+	}
+}
+#endif /* CONFIG_APP_MEM_STATS_MEMFAULT */
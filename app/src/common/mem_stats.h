@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _MEM_STATS_H_
+#define _MEM_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/iterable_sections.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Fill level of a statically allocated buffer.
+ *
+ * Use MEM_STATS_BUFFER_DEFINE() to define the statistics of a buffer. Buffers with the same
+ * group are sized by the same configuration option and are reported together to Memfault.
+ */
+struct mem_stats_buffer {
+	/* Name of the buffer, used in the shell */
+	const char *name;
+
+	/* Name of the group the buffer belongs to */
+	const char *group;
+
+	/* Capacity of the buffer, in bytes */
+	size_t size;
+
+	/* Bytes in use now, the most ever in use and the most in use since the last heartbeat */
+	size_t used;
+	size_t peak;
+	size_t interval_peak;
+};
+
+#if defined(CONFIG_APP_MEM_STATS)
+
+/**
+ * @brief Define the fill level statistics of a buffer.
+ *
+ * @param _name Name of the buffer.
+ * @param _group Name of the group of the buffer.
+ * @param _size Capacity of the buffer, in bytes.
+ */
+#define MEM_STATS_BUFFER_DEFINE(_name, _group, _size)					\
+	STRUCT_SECTION_ITERABLE(mem_stats_buffer, _name##_mem_stats) = {		\
+		.name = STRINGIFY(_name),						\
+		.group = STRINGIFY(_group),						\
+		.size = (_size),							\
+	}
+
+/** @brief Get a pointer to the statistics of a buffer, NULL when disabled. */
+#define MEM_STATS_BUFFER_GET(_name) (&_name##_mem_stats)
+
+/**
+ * @brief Update the fill level of a buffer.
+ *
+ * Call after every change that can raise the fill level, and preferably after every change.
+ *
+ * @param buffer Buffer statistics, may be NULL.
+ * @param used Bytes in use.
+ */
+void mem_stats_buffer_update(struct mem_stats_buffer *buffer, size_t used);
+
+/**
+ * @brief Get the stack usage of a thread.
+ *
+ * @param thread Thread.
+ * @param size Set to the size of the stack, in bytes.
+ * @param used Set to the most bytes of the stack ever in use.
+ *
+ * @retval 0 on success.
+ * @retval -ENOTSUP if the stack usage of the thread cannot be measured.
+ */
+int mem_stats_stack_get(const struct k_thread *thread, size_t *size, size_t *used);
+
+#else
+
+#define MEM_STATS_BUFFER_DEFINE(_name, _group, _size)
+#define MEM_STATS_BUFFER_GET(_name) NULL
+
+static inline void mem_stats_buffer_update(struct mem_stats_buffer *buffer, size_t used)
+{
+	ARG_UNUSED(buffer);
+	ARG_UNUSED(used);
+}
+
+#endif /* CONFIG_APP_MEM_STATS */
+
+#if defined(CONFIG_APP_MEM_STATS_MEMFAULT)
+#include <memfault/metrics/metrics.h>
+
+/** @brief Thread whose stack usage is exported as a Memfault heartbeat metric. */
+struct mem_stats_thread_metric {
+	/* Name of the thread, as set by K_THREAD_DEFINE() or k_thread_name_set() */
+	const char *thread_name;
+
+	/* Sets the metric of the heartbeat */
+	void (*set)(uint32_t used_pct);
+};
+
+/** @brief Buffer group whose fill level is exported as a Memfault heartbeat metric. */
+struct mem_stats_buffer_metric {
+	const char *group;
+
+	/* Sets the metric of the heartbeat */
+	void (*set)(uint32_t peak_pct);
+};
+
+/**
+ * @brief Export the stack usage of a thread as a Memfault heartbeat metric.
+ *
+ * The largest part of the stack ever in use, in percent, is reported as the
+ * `<_key>_stack_pct` metric, which must be defined in memfault_metrics_heartbeat_config.def.
+ * No value is reported while the thread does not exist.
+ *
+ * @param _thread Name of the thread.
+ * @param _key Prefix of the metric key.
+ */
+#define MEM_STATS_THREAD_METRIC_DEFINE(_thread, _key)					\
+	static void _key##_stack_metric_set(uint32_t used_pct)				\
+	{										\
+		MEMFAULT_METRIC_SET_UNSIGNED(_key##_stack_pct, used_pct);		\
+	}										\
+	STRUCT_SECTION_ITERABLE(mem_stats_thread_metric, _key##_mem_stats_metric) = {	\
+		.thread_name = STRINGIFY(_thread),					\
+		.set = _key##_stack_metric_set,						\
+	}
+
+/**
+ * @brief Export the fill level of a buffer group as a Memfault heartbeat metric.
+ *
+ * The highest fill level of any buffer in the group during each heartbeat interval, in
+ * percent, is reported as the `<_key>_peak_pct` metric, which must be defined in
+ * memfault_metrics_heartbeat_config.def.
+ *
+ * @param _group Name of the group given to MEM_STATS_BUFFER_DEFINE().
+ * @param _key Prefix of the metric key.
+ */
+#define MEM_STATS_BUFFER_METRIC_DEFINE(_group, _key)					\
+	static void _key##_peak_metric_set(uint32_t peak_pct)				\
+	{										\
+		MEMFAULT_METRIC_SET_UNSIGNED(_key##_peak_pct, peak_pct);		\
+	}										\
+	STRUCT_SECTION_ITERABLE(mem_stats_buffer_metric, _key##_mem_stats_metric) = {	\
+		.group = STRINGIFY(_group),						\
+		.set = _key##_peak_metric_set,						\
+	}
+
+/** @brief Report the stack usage and buffer fill levels to Memfault. */
+void mem_stats_heartbeat_collect(void);
+
+#else
+
+#define MEM_STATS_THREAD_METRIC_DEFINE(_thread, _key)
+#define MEM_STATS_BUFFER_METRIC_DEFINE(_group, _key)
+
+#endif /* CONFIG_APP_MEM_STATS_MEMFAULT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MEM_STATS_H_ */
@@ -0,0 +1,437 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <modem/trace_backend.h>
+#include <memfault/core/custom_data_recording.h>
+#include <string.h>
+
+#include "modem_trace_ring.h"
+#include "lz4_block.h"
+
+/* Register log module */
+LOG_MODULE_REGISTER(modem_trace_ring, CONFIG_APP_MODEM_TRACE_RING_LOG_LEVEL);
+
+#define RING_SIZE		(CONFIG_APP_MODEM_TRACE_RING_SIZE_KB * 1024)
+#define RING_MAGIC		0x4d545242 /* "MTRB" */
+
+/* The snapshot is compressed in blocks, each block in place of the traces it holds */
+#define BLOCK_SIZE		1024
+#define BLOCK_COUNT		(RING_SIZE / BLOCK_SIZE)
+#define BLOCK_RAW		BIT(15)
+
+/* Format of the uploaded snapshot, see scripts/modem_trace_decode.py */
+#define SNAPSHOT_MAGIC		0x4d545253 /* "MTRS" */
+#define SNAPSHOT_VERSION	1
+
+enum ring_state {
+	RING_RECORDING,
+	RING_FROZEN,
+	RING_PACKING,
+	RING_PACKED,
+};
+
+/* Header of the uploaded snapshot, followed by the blocks */
+struct snapshot_header {
+	uint32_t magic;
+	uint8_t version;
+	uint8_t trigger;
+	uint16_t block_size;
+	uint32_t raw_size;
+	uint32_t uptime_s;
+	uint16_t block_count;
+	uint16_t table_size;
+
+	/* Length of each block, BLOCK_RAW is set for a block that is stored uncompressed */
+	uint16_t block_len[BLOCK_COUNT];
+} __packed;
+
+/* Kept over a reset, valid when the magic and CRC match */
+struct ring_header {
+	uint32_t magic;
+	uint32_t state;
+
+	/* Write position and number of bytes in the ring buffer while recording */
+	uint32_t head;
+	uint32_t used;
+
+	/* Size and CRC of the blocks in the ring buffer once packed */
+	uint32_t packed_size;
+	uint32_t packed_crc;
+
+	struct snapshot_header snapshot;
+
+	uint32_t crc;
+};
+
+static struct ring_header ring __noinit;
+
+static uint8_t ring_buf[RING_SIZE] __noinit;
+
+/* Writes come from the trace thread, triggers from any context, including fatal errors */
+static struct k_spinlock lock;
+static bool restored;
+
+static trace_backend_processed_cb trace_processed_cb;
+
+/* Only used from the pack work item */
+static uint8_t block_buf[BLOCK_SIZE];
+
+static void pack_work_fn(struct k_work *work);
+static K_WORK_DEFINE(pack_work, pack_work_fn);
+
+static const char *trigger_name(uint8_t trigger)
+{
+	switch (trigger) {
+	case MODEM_TRACE_RING_TRIGGER_ATTACH_REJECTED:
+		return "Attach rejected";
+	case MODEM_TRACE_RING_TRIGGER_CLOUD_CONNECT:
+		return "Cloud connection failed";
+	case MODEM_TRACE_RING_TRIGGER_WATCHDOG:
+		return "Watchdog";
+	default:
+		return "Unknown";
+	}
+}
+
+/* Must be called with the lock held */
+static void ring_seal(void)
+{
+	ring.crc = crc32_ieee((const uint8_t *)&ring, offsetof(struct ring_header, crc));
+}
+
+/* Must be called with the lock held */
+static void ring_reset(void)
+{
+	memset(&ring, 0, sizeof(ring));
+
+	ring.magic = RING_MAGIC;
+	ring.state = RING_RECORDING;
+
+	ring_seal();
+}
+
+/* Keep a snapshot from before a reset, must be called with the lock held */
+static void ring_restore(void)
+{
+	uint32_t crc;
+	bool valid;
+
+	if (restored) {
+		return;
+	}
+
+	restored = true;
+
+	crc = crc32_ieee((const uint8_t *)&ring, offsetof(struct ring_header, crc));
+	valid = (ring.magic == RING_MAGIC) && (ring.crc == crc) && (ring.head < RING_SIZE) &&
+		(ring.used <= RING_SIZE) && (ring.packed_size <= RING_SIZE);
+
+	if (valid && (ring.state == RING_PACKED)) {
+		valid = (ring.packed_crc == crc32_ieee(ring_buf, ring.packed_size));
+	} else if (valid) {
+		valid = (ring.state == RING_FROZEN);
+	}
+
+	if (!valid) {
+		ring_reset();
+	}
+}
+
+static void ring_append(const uint8_t *data, size_t len)
+{
+	size_t chunk;
+
+	/* Only the end of a write that is larger than the buffer is kept */
+	if (len > RING_SIZE) {
+		data += len - RING_SIZE;
+		len = RING_SIZE;
+	}
+
+	chunk = MIN(len, RING_SIZE - ring.head);
+
+	memcpy(&ring_buf[ring.head], data, chunk);
+	memcpy(ring_buf, data + chunk, len - chunk);
+
+	ring.head = (ring.head + len) % RING_SIZE;
+	ring.used = MIN(ring.used + len, RING_SIZE);
+}
+
+static void reverse(uint8_t *buf, size_t len)
+{
+	for (size_t i = 0; i < len / 2; i++) {
+		uint8_t tmp = buf[i];
+
+		buf[i] = buf[len - 1 - i];
+		buf[len - 1 - i] = tmp;
+	}
+}
+
+/* Move the oldest trace to the start of the buffer, without a second buffer */
+static void ring_linearize(void)
+{
+	if ((ring.used < RING_SIZE) || (ring.head == 0)) {
+		return;
+	}
+
+	reverse(ring_buf, ring.head);
+	reverse(&ring_buf[ring.head], RING_SIZE - ring.head);
+	reverse(ring_buf, RING_SIZE);
+
+	ring.head = 0;
+}
+
+/* Compress the frozen traces block by block. A block never grows, so each one is written at
+ * or before the position it was read from.
+ */
+static void pack_work_fn(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	size_t packed = 0;
+	size_t count;
+
+	if (ring.state != RING_FROZEN) {
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	/* A reset while packing leaves the buffer half packed, it is discarded at boot */
+	ring.state = RING_PACKING;
+	ring_seal();
+
+	k_spin_unlock(&lock, key);
+
+	ring_linearize();
+
+	count = DIV_ROUND_UP(ring.used, BLOCK_SIZE);
+
+	for (size_t i = 0; i < count; i++) {
+		const uint8_t *src = &ring_buf[i * BLOCK_SIZE];
+		size_t len = MIN(BLOCK_SIZE, ring.used - (i * BLOCK_SIZE));
+		size_t compressed = lz4_block_compress(src, len, block_buf, len - 1);
+
+		if (compressed > 0) {
+			memcpy(&ring_buf[packed], block_buf, compressed);
+			ring.snapshot.block_len[i] = (uint16_t)compressed;
+		} else {
+			memmove(&ring_buf[packed], src, len);
+			ring.snapshot.block_len[i] = (uint16_t)len | BLOCK_RAW;
+			compressed = len;
+		}
+
+		packed += compressed;
+	}
+
+	key = k_spin_lock(&lock);
+
+	ring.snapshot.magic = SNAPSHOT_MAGIC;
+	ring.snapshot.version = SNAPSHOT_VERSION;
+	ring.snapshot.block_size = BLOCK_SIZE;
+	ring.snapshot.raw_size = ring.used;
+	ring.snapshot.block_count = (uint16_t)count;
+	ring.snapshot.table_size = BLOCK_COUNT;
+	ring.packed_size = packed;
+	ring.packed_crc = crc32_ieee(ring_buf, packed);
+	ring.state = RING_PACKED;
+	ring_seal();
+
+	k_spin_unlock(&lock, key);
+
+	LOG_INF("Modem trace snapshot packed, %u bytes to %zu bytes", ring.snapshot.raw_size,
+		packed);
+}
+
+void modem_trace_ring_trigger(enum modem_trace_ring_trigger trigger)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	ring_restore();
+
+	if ((ring.state != RING_RECORDING) || (ring.used == 0)) {
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	ring.state = RING_FROZEN;
+	ring.snapshot.trigger = (uint8_t)trigger;
+	ring.snapshot.uptime_s = (uint32_t)(k_uptime_get() / MSEC_PER_SEC);
+	ring_seal();
+
+	k_spin_unlock(&lock, key);
+
+	LOG_WRN("Modem traces frozen, trigger: %s", trigger_name(trigger));
+
+	/* Not packed on a watchdog, the reset follows, and the snapshot is packed after boot */
+	if (trigger != MODEM_TRACE_RING_TRIGGER_WATCHDOG) {
+		(void)k_work_submit(&pack_work);
+	}
+}
+
+/* Memfault custom data recording source, read while the snapshot is packed */
+static bool cdr_has_data(sMemfaultCdrMetadata *metadata)
+{
+	static const char *mimetypes[] = { MEMFAULT_CDR_BINARY };
+
+	if (ring.state != RING_PACKED) {
+		return false;
+	}
+
+	*metadata = (sMemfaultCdrMetadata) {
+		.start_time.type = kMemfaultCurrentTimeType_Unknown,
+		.mimetypes = mimetypes,
+		.num_mimetypes = ARRAY_SIZE(mimetypes),
+		.data_size_bytes = sizeof(ring.snapshot) + ring.packed_size,
+		.collection_reason = trigger_name(ring.snapshot.trigger),
+	};
+
+	return true;
+}
+
+static bool cdr_read(uint32_t offset, void *data, size_t data_len)
+{
+	const uint8_t *header = (const uint8_t *)&ring.snapshot;
+	uint8_t *out = data;
+	size_t chunk;
+
+	if ((ring.state != RING_PACKED) ||
+	    ((offset + data_len) > (sizeof(ring.snapshot) + ring.packed_size))) {
+		return false;
+	}
+
+	if (offset < sizeof(ring.snapshot)) {
+		chunk = MIN(data_len, sizeof(ring.snapshot) - offset);
+
+		memcpy(out, &header[offset], chunk);
+
+		out += chunk;
+		data_len -= chunk;
+		offset = sizeof(ring.snapshot);
+	}
+
+	memcpy(out, &ring_buf[offset - sizeof(ring.snapshot)], data_len);
+
+	return true;
+}
+
+static void cdr_mark_read(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	ring_reset();
+
+	k_spin_unlock(&lock, key);
+
+	LOG_INF("Modem trace snapshot uploaded, recording resumed");
+}
+
+static const sMemfaultCdrSourceImpl cdr_source = {
+	.has_cdr_cb = cdr_has_data,
+	.read_data_cb = cdr_read,
+	.mark_cdr_read_cb = cdr_mark_read,
+};
+
+/* Trace backend, called by the modem library */
+static int trace_backend_init(trace_backend_processed_cb trace_processed_cb_in)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	ring_restore();
+
+	k_spin_unlock(&lock, key);
+
+	trace_processed_cb = trace_processed_cb_in;
+
+	return 0;
+}
+
+static int trace_backend_deinit(void)
+{
+	return 0;
+}
+
+static int trace_backend_write(const void *data, size_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	/* Traces are dropped while a snapshot is waiting to be uploaded */
+	if (ring.state == RING_RECORDING) {
+		ring_append(data, len);
+	}
+
+	k_spin_unlock(&lock, key);
+
+	(void)trace_processed_cb(len);
+
+	return (int)len;
+}
+
+struct nrf_modem_lib_trace_backend trace_backend = {
+	.init = trace_backend_init,
+	.deinit = trace_backend_deinit,
+	.write = trace_backend_write,
+};
+
+/* Keep a snapshot from before the reset, and pack it if it was not packed yet */
+static void ring_boot(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	bool kept;
+
+	ring_restore();
+	kept = (ring.state != RING_RECORDING);
+
+	k_spin_unlock(&lock, key);
+
+	if (kept) {
+		LOG_INF("Modem trace snapshot from before the reset, trigger: %s",
+			trigger_name(ring.snapshot.trigger));
+	}
+
+	(void)k_work_submit(&pack_work);
+}
+
+#if defined(CONFIG_UNITY)
+void modem_trace_ring_test_noinit_get(uint8_t **header, size_t *header_size, uint8_t **buf,
+				      size_t *buf_size)
+{
+	*header = (uint8_t *)&ring;
+	*header_size = sizeof(ring);
+	*buf = ring_buf;
+	*buf_size = sizeof(ring_buf);
+}
+
+void modem_trace_ring_test_reboot(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	restored = false;
+
+	k_spin_unlock(&lock, key);
+
+	ring_boot();
+}
+#endif /* CONFIG_UNITY */
+
+static int modem_trace_ring_init(void)
+{
+	ring_boot();
+
+	if (!memfault_cdr_register_source(&cdr_source)) {
+		LOG_ERR("memfault_cdr_register_source failed");
+
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+SYS_INIT(modem_trace_ring_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
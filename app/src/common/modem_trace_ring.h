@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _MODEM_TRACE_RING_H_
+#define _MODEM_TRACE_RING_H_
+
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Events that freeze the modem trace ring buffer. */
+enum modem_trace_ring_trigger {
+	MODEM_TRACE_RING_TRIGGER_NONE,
+
+	/* The network rejected the attach request */
+	MODEM_TRACE_RING_TRIGGER_ATTACH_REJECTED,
+
+	/* A connection attempt to the cloud failed */
+	MODEM_TRACE_RING_TRIGGER_CLOUD_CONNECT,
+
+	/* A module watchdog expired, the snapshot is uploaded after the reset */
+	MODEM_TRACE_RING_TRIGGER_WATCHDOG,
+};
+
+#if defined(CONFIG_APP_MODEM_TRACE_RING)
+
+/**
+ * @brief Freeze the modem traces held in the ring buffer.
+ *
+ * The traces are compressed in the background and uploaded to Memfault as a custom data
+ * recording in the next upload window. Recording resumes once the snapshot is uploaded. A
+ * trigger is ignored while a snapshot is waiting to be uploaded.
+ *
+ * Can be called from any context, also from a fatal error handler right before a reset.
+ *
+ * @param trigger Reason for the snapshot, reported with the upload.
+ */
+void modem_trace_ring_trigger(enum modem_trace_ring_trigger trigger);
+
+#if defined(CONFIG_UNITY)
+/**
+ * @brief Get the noinit RAM of the ring buffer. Only for unit tests.
+ *
+ * @param[out] header      Header with the state, protected by a CRC.
+ * @param[out] header_size Size of the header.
+ * @param[out] buf         Ring buffer with the traces, or the packed snapshot.
+ * @param[out] buf_size    Size of the ring buffer.
+ */
+void modem_trace_ring_test_noinit_get(uint8_t **header, size_t *header_size, uint8_t **buf,
+				      size_t *buf_size);
+
+/**
+ * @brief Check the noinit RAM again, as at boot after a reset. Only for unit tests.
+ */
+void modem_trace_ring_test_reboot(void);
+#endif /* CONFIG_UNITY */
+
+#else
+
+static inline void modem_trace_ring_trigger(enum modem_trace_ring_trigger trigger)
+{
+	ARG_UNUSED(trigger);
+}
+
+#endif /* CONFIG_APP_MODEM_TRACE_RING */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MODEM_TRACE_RING_H_ */
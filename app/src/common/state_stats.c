@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/smf.h>
+#if defined(CONFIG_APP_STATE_STATS_SHELL)
+#include <zephyr/shell/shell.h>
+#endif /* CONFIG_APP_STATE_STATS_SHELL */
+
+#include "state_stats.h"
+
+/* Updates come from the module threads, reads from the shell and the Memfault heartbeat */
+static struct k_spinlock lock;
+
+static void dwell_add(struct state_stats_entry *entry, int64_t now_ms)
+{
+	uint32_t dwell = (uint32_t)MIN(now_ms - entry->entered_ms, UINT32_MAX);
+
+	entry->total_ms += dwell;
+	entry->max_ms = MAX(entry->max_ms, dwell);
+}
+
+/* Check if a state is the given leaf state or one of its parents */
+static bool state_is_active(const struct smf_state *state, const struct smf_state *leaf)
+{
+	for (const struct smf_state *s = leaf; s != NULL; s = s->parent) {
+		if (s == state) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static struct state_stats_entry *entry_get(struct state_stats *stats,
+					   const struct smf_state *state)
+{
+	__ASSERT_NO_MSG((state >= stats->states) && (state < &stats->states[stats->state_count]));
+
+	return &stats->entries[state - stats->states];
+}
+
+void state_stats_update(struct state_stats *stats, const struct smf_ctx *ctx)
+{
+	int64_t now_ms;
+	k_spinlock_key_t key;
+	const struct smf_state *previous;
+
+	if ((stats == NULL) || (ctx->current == stats->current)) {
+		return;
+	}
+
+	now_ms = k_uptime_get();
+	key = k_spin_lock(&lock);
+
+	previous = stats->current;
+	stats->current = ctx->current;
+
+	/* States that were left, parents shared with the new state are still active */
+	for (const struct smf_state *s = previous; s != NULL; s = s->parent) {
+		if (!state_is_active(s, stats->current)) {
+			dwell_add(entry_get(stats, s), now_ms);
+		}
+	}
+
+	/* States that were entered */
+	for (const struct smf_state *s = stats->current; s != NULL; s = s->parent) {
+		if (!state_is_active(s, previous)) {
+			struct state_stats_entry *entry = entry_get(stats, s);
+
+			entry->count++;
+			entry->entered_ms = now_ms;
+		}
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+int state_stats_get(const struct state_stats *stats, size_t state,
+		    struct state_stats_entry *entry)
+{
+	k_spinlock_key_t key;
+
+	if (state >= stats->state_count) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+
+	*entry = stats->entries[state];
+
+	if (state_is_active(&stats->states[state], stats->current)) {
+		dwell_add(entry, k_uptime_get());
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+#if defined(CONFIG_APP_STATE_STATS_SHELL)
+static int cmd_state_stats(const struct shell *shell, size_t argc, char **argv)
+{
+	struct state_stats_entry entry;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	STRUCT_SECTION_FOREACH(state_stats, stats) {
+		shell_print(shell, "%s:", stats->name);
+
+		for (size_t i = 0; i < stats->state_count; i++) {
+			(void)state_stats_get(stats, i, &entry);
+
+			if (entry.count == 0) {
+				continue;
+			}
+
+			shell_print(shell,
+				    "  state %2zu: entered %u times, total %llu ms, max %u ms%s",
+				    i, entry.count, (unsigned long long)entry.total_ms,
+				    entry.max_ms,
+				    state_is_active(&stats->states[i], stats->current) ?
+				    " (current)" : "");
+		}
+	}
+
+	return 0;
+}
+
+SHELL_CMD_REGISTER(att_state_stats,
+		   NULL,
+		   "Print the number of entries and dwell times of the states of all modules",
+		   cmd_state_stats);
+#endif /* CONFIG_APP_STATE_STATS_SHELL */
+
+#if defined(CONFIG_APP_STATE_STATS_MEMFAULT)
+void state_stats_heartbeat_collect(void)
+{
+	struct state_stats_entry entry;
+
+	STRUCT_SECTION_FOREACH(state_stats_metric, metric) {
+		if (state_stats_get(metric->stats, metric->state, &entry)) {
+			continue;
+		}
+
+		metric->set(entry.count - metric->last_count,
+			    (uint32_t)MIN(entry.total_ms - metric->last_total_ms, UINT32_MAX));
+
+		metric->last_count = entry.count;
+		metric->last_total_ms = entry.total_ms;
+	}
+}
+#endif /* CONFIG_APP_STATE_STATS_MEMFAULT */
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _STATE_STATS_H_
+#define _STATE_STATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/smf.h>
+#include <zephyr/sys/iterable_sections.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Statistics of one state of a state machine. */
+struct state_stats_entry {
+	/* Number of times the state was entered */
+	uint32_t count;
+
+	/* Cumulative time spent in the state, in milliseconds */
+	uint64_t total_ms;
+
+	/* Longest single stay in the state, in milliseconds */
+	uint32_t max_ms;
+
+	/* Uptime when the state was last entered, in milliseconds */
+	int64_t entered_ms;
+};
+
+/**
+ * @brief Dwell time statistics of the states of a state machine.
+ *
+ * Use STATE_STATS_DEFINE() to define the statistics of a module. A parent state counts as entered
+ * and its time runs while the state machine is in any of its child states.
+ */
+struct state_stats {
+	/* Name of the module, used in the shell */
+	const char *name;
+
+	/* States array of the state machine */
+	const struct smf_state *states;
+
+	/* One entry per state, in the order of the states array */
+	struct state_stats_entry *entries;
+	size_t state_count;
+
+	/* State the state machine was in at the last update */
+	const struct smf_state *current;
+};
+
+#if defined(CONFIG_APP_STATE_STATS)
+
+/**
+ * @brief Define the state statistics of a module.
+ *
+ * @param _name Name of the module.
+ * @param _states States array of the state machine of the module.
+ */
+#define STATE_STATS_DEFINE(_name, _states)						\
+	static struct state_stats_entry _name##_state_stats_entries[ARRAY_SIZE(_states)];	\
+	STRUCT_SECTION_ITERABLE(state_stats, _name##_state_stats) = {			\
+		.name = STRINGIFY(_name),						\
+		.states = (_states),							\
+		.entries = _name##_state_stats_entries,					\
+		.state_count = ARRAY_SIZE(_states),					\
+	}
+
+/** @brief Get a pointer to the state statistics of a module, NULL when disabled. */
+#define STATE_STATS_GET(_name) (&_name##_state_stats)
+
+/**
+ * @brief Update the state statistics of a module after its state machine has run.
+ *
+ * Call after smf_set_initial() and after every smf_run_state().
+ *
+ * @param _name Name of the module given to STATE_STATS_DEFINE().
+ * @param _ctx State machine context of the module.
+ */
+#define STATE_STATS_UPDATE(_name, _ctx) state_stats_update(STATE_STATS_GET(_name), (_ctx))
+
+/**
+ * @brief Update the state statistics with the current state of a state machine.
+ *
+ * @param stats State statistics, may be NULL.
+ * @param ctx State machine context.
+ */
+void state_stats_update(struct state_stats *stats, const struct smf_ctx *ctx);
+
+/**
+ * @brief Get the statistics of one state.
+ *
+ * The time spent in the current state so far is included.
+ *
+ * @param stats State statistics.
+ * @param state Index of the state in the states array.
+ * @param entry Set to the statistics of the state.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the state index is out of range.
+ */
+int state_stats_get(const struct state_stats *stats, size_t state,
+		    struct state_stats_entry *entry);
+
+#else
+
+#define STATE_STATS_DEFINE(_name, _states)
+#define STATE_STATS_GET(_name) NULL
+#define STATE_STATS_UPDATE(_name, _ctx) do {} while (0)
+
+static inline void state_stats_update(struct state_stats *stats, const struct smf_ctx *ctx)
+{
+	ARG_UNUSED(stats);
+	ARG_UNUSED(ctx);
+}
+
+#endif /* CONFIG_APP_STATE_STATS */
+
+#if defined(CONFIG_APP_STATE_STATS_MEMFAULT)
+#include <memfault/metrics/metrics.h>
+
+/** @brief State that is exported as Memfault heartbeat metrics. */
+struct state_stats_metric {
+	const struct state_stats *stats;
+	size_t state;
+
+	/* Sets the metrics of the heartbeat */
+	void (*set)(uint32_t count, uint32_t ms);
+
+	/* Values at the previous heartbeat */
+	uint32_t last_count;
+	uint64_t last_total_ms;
+};
+
+/**
+ * @brief Export the statistics of a state as Memfault heartbeat metrics.
+ *
+ * The number of entries into the state and the time spent in it during each heartbeat
+ * interval are reported as the `<_key>_count` and `<_key>_ms` metrics, which must be defined
+ * in memfault_metrics_heartbeat_config.def.
+ *
+ * @param _name Name of the module given to STATE_STATS_DEFINE().
+ * @param _state Index of the state in the states array.
+ * @param _key Prefix of the metric keys.
+ */
+#define STATE_STATS_METRIC_DEFINE(_name, _state, _key)					\
+	static void _key##_metric_set(uint32_t count, uint32_t ms)			\
+	{										\
+		MEMFAULT_METRIC_SET_UNSIGNED(_key##_count, count);			\
+		MEMFAULT_METRIC_SET_UNSIGNED(_key##_ms, ms);				\
+	}										\
+	STRUCT_SECTION_ITERABLE(state_stats_metric, _key##_state_stats_metric) = {	\
+		.stats = STATE_STATS_GET(_name),					\
+		.state = (_state),							\
+		.set = _key##_metric_set,						\
+	}
+
+/** @brief Report the state statistics of the heartbeat interval to Memfault. */
+void state_stats_heartbeat_collect(void);
+
+#else
+
+#define STATE_STATS_METRIC_DEFINE(_name, _state, _key)
+
+#endif /* CONFIG_APP_STATE_STATS_MEMFAULT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _STATE_STATS_H_ */
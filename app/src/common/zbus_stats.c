@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+#if defined(CONFIG_APP_ZBUS_STATS_SHELL)
+#include <zephyr/shell/shell.h>
+#endif /* CONFIG_APP_ZBUS_STATS_SHELL */
+
+#include "zbus_stats.h"
+
+/* Register log module */
+LOG_MODULE_REGISTER(zbus_stats, CONFIG_APP_ZBUS_STATS_LOG_LEVEL);
+
+BUILD_ASSERT(CONFIG_APP_ZBUS_STATS_SUBSCRIBERS_MAX <= 32,
+	     "Subscribers of a channel are kept in a 32-bit mask");
+
+/* Upper limits of the latency histogram buckets, in milliseconds */
+static const uint32_t latency_limits_ms[ZBUS_STATS_LATENCY_BUCKETS] = {
+	1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 5000, UINT32_MAX
+};
+
+/* Queue of a message subscriber, as seen from the publishes on the tracked channels */
+struct zbus_stats_sub {
+	const struct zbus_observer *obs;
+
+	/* Messages published and not yet received */
+	uint32_t pending;
+	uint32_t queue_hwm;
+
+	/* Publish times of the pending messages, oldest first */
+	uint32_t timestamps[CONFIG_APP_ZBUS_STATS_TIMESTAMPS];
+	size_t head;
+	size_t count;
+
+	/* Pending messages newer than the timestamps, published while the timestamps were full */
+	uint32_t untimed;
+
+	/* Messages received before the listener saw the publish. The subscriber thread can
+	 * preempt the publisher when the message is queued, before the listener runs.
+	 */
+	uint32_t early;
+};
+
+static struct zbus_stats_sub subs[CONFIG_APP_ZBUS_STATS_SUBSCRIBERS_MAX];
+static size_t sub_count;
+
+/* Publishes come from any thread, receives from the subscriber threads */
+static struct k_spinlock lock;
+
+static struct zbus_stats_chan *chan_stats_get(const struct zbus_channel *chan)
+{
+	STRUCT_SECTION_FOREACH(zbus_stats_chan, stats) {
+		if (stats->chan == chan) {
+			return stats;
+		}
+	}
+
+	return NULL;
+}
+
+static struct zbus_stats_sub *sub_get(const struct zbus_observer *obs)
+{
+	for (size_t i = 0; i < sub_count; i++) {
+		if (subs[i].obs == obs) {
+			return &subs[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void sub_published(struct zbus_stats_sub *sub, uint32_t now)
+{
+	if (sub->early) {
+		sub->early--;
+		return;
+	}
+
+	sub->pending++;
+	sub->queue_hwm = MAX(sub->queue_hwm, sub->pending);
+
+	if ((sub->untimed == 0) && (sub->count < ARRAY_SIZE(sub->timestamps))) {
+		sub->timestamps[(sub->head + sub->count) % ARRAY_SIZE(sub->timestamps)] = now;
+		sub->count++;
+	} else {
+		sub->untimed++;
+	}
+}
+
+static void latency_add(struct zbus_stats_chan *stats, uint32_t latency_ms)
+{
+	size_t i = 0;
+
+	while (latency_ms > latency_limits_ms[i]) {
+		i++;
+	}
+
+	stats->latency_buckets[i]++;
+	stats->latency_max_ms = MAX(stats->latency_max_ms, latency_ms);
+}
+
+static void zbus_stats_cb(const struct zbus_channel *chan)
+{
+	struct zbus_stats_chan *stats = chan_stats_get(chan);
+	uint32_t now = (uint32_t)k_uptime_ticks();
+	k_spinlock_key_t key;
+
+	if (stats == NULL) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+
+	stats->publish_count++;
+
+	for (size_t i = 0; i < sub_count; i++) {
+		if (!(stats->subscribers & BIT(i))) {
+			continue;
+		}
+
+		sub_published(&subs[i], now);
+
+		stats->queue_hwm = MAX(stats->queue_hwm, subs[i].pending);
+		stats->interval_queue_hwm = MAX(stats->interval_queue_hwm, subs[i].pending);
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+ZBUS_LISTENER_DEFINE(zbus_stats_lis, zbus_stats_cb);
+
+void zbus_stats_received(const struct zbus_observer *obs, const struct zbus_channel *chan)
+{
+	struct zbus_stats_chan *stats = chan_stats_get(chan);
+	struct zbus_stats_sub *sub = sub_get(obs);
+	uint32_t now = (uint32_t)k_uptime_ticks();
+	k_spinlock_key_t key;
+
+	if ((stats == NULL) || (sub == NULL)) {
+		return;
+	}
+
+	key = k_spin_lock(&lock);
+
+	stats->delivery_count++;
+
+	if (sub->count) {
+		latency_add(stats, k_ticks_to_ms_floor32(now - sub->timestamps[sub->head]));
+		sub->head = (sub->head + 1) % ARRAY_SIZE(sub->timestamps);
+		sub->count--;
+		sub->pending--;
+	} else if (sub->untimed) {
+		sub->untimed--;
+		sub->pending--;
+	} else {
+		sub->early++;
+		latency_add(stats, 0);
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+uint32_t zbus_stats_latency_p99(const uint32_t buckets[ZBUS_STATS_LATENCY_BUCKETS],
+				uint32_t max_ms)
+{
+	uint64_t total = 0;
+	uint64_t sum = 0;
+
+	for (size_t i = 0; i < ZBUS_STATS_LATENCY_BUCKETS; i++) {
+		total += buckets[i];
+	}
+
+	if (total == 0) {
+		return 0;
+	}
+
+	for (size_t i = 0; i < ZBUS_STATS_LATENCY_BUCKETS; i++) {
+		sum += buckets[i];
+
+		if ((sum * 100) >= (total * 99)) {
+			return MIN(latency_limits_ms[i], max_ms);
+		}
+	}
+
+	return max_ms;
+}
+
+/* Find the message subscribers of the tracked channels */
+static int zbus_stats_init(void)
+{
+	STRUCT_SECTION_FOREACH(zbus_channel_observation, observation) {
+		struct zbus_stats_chan *stats = chan_stats_get(observation->chan);
+		struct zbus_stats_sub *sub;
+
+		if ((stats == NULL) ||
+		    (observation->obs->type != ZBUS_OBSERVER_MSG_SUBSCRIBER_TYPE)) {
+			continue;
+		}
+
+		sub = sub_get(observation->obs);
+		if (sub == NULL) {
+			if (sub_count == ARRAY_SIZE(subs)) {
+				LOG_ERR("More than %d subscribers, increase "
+					"CONFIG_APP_ZBUS_STATS_SUBSCRIBERS_MAX",
+					CONFIG_APP_ZBUS_STATS_SUBSCRIBERS_MAX);
+				return -ENOMEM;
+			}
+
+			sub = &subs[sub_count++];
+			sub->obs = observation->obs;
+		}
+
+		stats->subscribers |= BIT(sub - subs);
+	}
+
+	return 0;
+}
+
+SYS_INIT(zbus_stats_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#if defined(CONFIG_APP_ZBUS_STATS_SHELL)
+static int cmd_zbus_stats(const struct shell *shell, size_t argc, char **argv)
+{
+	struct zbus_stats_chan stats;
+	struct zbus_stats_sub sub;
+	k_spinlock_key_t key;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	STRUCT_SECTION_FOREACH(zbus_stats_chan, entry) {
+		key = k_spin_lock(&lock);
+		stats = *entry;
+		k_spin_unlock(&lock, key);
+
+		shell_print(shell,
+			    "%s: published %u, delivered %u, latency p99 %u ms, max %u ms, "
+			    "queue high-water mark %u",
+			    zbus_chan_name(stats.chan), stats.publish_count, stats.delivery_count,
+			    zbus_stats_latency_p99(stats.latency_buckets, stats.latency_max_ms),
+			    stats.latency_max_ms, stats.queue_hwm);
+	}
+
+	for (size_t i = 0; i < sub_count; i++) {
+		key = k_spin_lock(&lock);
+		sub = subs[i];
+		k_spin_unlock(&lock, key);
+
+		shell_print(shell, "%s: pending %u, queue high-water mark %u",
+			    zbus_obs_name(sub.obs), sub.pending, sub.queue_hwm);
+	}
+
+	return 0;
+}
+
+SHELL_CMD_REGISTER(att_zbus_stats,
+		   NULL,
+		   "Print the publish, latency and queue depth statistics of zbus channels",
+		   cmd_zbus_stats);
+#endif /* CONFIG_APP_ZBUS_STATS_SHELL */
+
+#if defined(CONFIG_APP_ZBUS_STATS_MEMFAULT)
+void zbus_stats_heartbeat_collect(void)
+{
+	uint32_t buckets[ZBUS_STATS_LATENCY_BUCKETS];
+	uint32_t publish_count;
+	uint32_t queue_hwm;
+	uint32_t latency_max_ms;
+	k_spinlock_key_t key;
+
+	STRUCT_SECTION_FOREACH(zbus_stats_metric, metric) {
+		key = k_spin_lock(&lock);
+
+		publish_count = metric->stats->publish_count - metric->last_publish_count;
+		metric->last_publish_count = metric->stats->publish_count;
+
+		for (size_t i = 0; i < ZBUS_STATS_LATENCY_BUCKETS; i++) {
+			buckets[i] = metric->stats->latency_buckets[i] -
+				     metric->last_latency_buckets[i];
+			metric->last_latency_buckets[i] = metric->stats->latency_buckets[i];
+		}
+
+		latency_max_ms = metric->stats->latency_max_ms;
+		queue_hwm = metric->stats->interval_queue_hwm;
+		metric->stats->interval_queue_hwm = 0;
+
+		k_spin_unlock(&lock, key);
+
+		metric->set(publish_count, zbus_stats_latency_p99(buckets, latency_max_ms),
+			    queue_hwm);
+	}
+}
+#endif /* CONFIG_APP_ZBUS_STATS_MEMFAULT */
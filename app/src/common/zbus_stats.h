@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _ZBUS_STATS_H_
+#define _ZBUS_STATS_H_
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <zephyr/zbus/zbus.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of delivery latency histogram buckets, see zbus_stats.c for the bucket limits */
+#define ZBUS_STATS_LATENCY_BUCKETS 12
+
+/**
+ * @brief Publish and delivery statistics of a zbus channel.
+ *
+ * Use ZBUS_STATS_CHAN_DEFINE() to define the statistics of a channel.
+ */
+struct zbus_stats_chan {
+	const struct zbus_channel *chan;
+
+	/* Number of messages published on the channel */
+	uint32_t publish_count;
+
+	/* Number of messages handled by the message subscribers of the channel */
+	uint32_t delivery_count;
+
+	/* Number of deliveries per latency bucket, from publish until the subscriber has the
+	 * message
+	 */
+	uint32_t latency_buckets[ZBUS_STATS_LATENCY_BUCKETS];
+	uint32_t latency_max_ms;
+
+	/* Largest number of messages queued for any subscriber of the channel when publishing */
+	uint32_t queue_hwm;
+	uint32_t interval_queue_hwm;
+
+	/* Message subscribers of the channel, one bit per subscriber in zbus_stats.c */
+	uint32_t subscribers;
+};
+
+#if defined(CONFIG_APP_ZBUS_STATS)
+
+ZBUS_OBS_DECLARE(zbus_stats_lis);
+
+/**
+ * @brief Collect publish and delivery statistics of a channel.
+ *
+ * Must be used in the file that defines the channel. Only message subscribers added with
+ * ZBUS_CHAN_ADD_OBS() or in ZBUS_CHAN_DEFINE() are tracked.
+ *
+ * @param _chan Name of the channel.
+ */
+#define ZBUS_STATS_CHAN_DEFINE(_chan)							\
+	ZBUS_CHAN_ADD_OBS(_chan, zbus_stats_lis, 0);					\
+	STRUCT_SECTION_ITERABLE(zbus_stats_chan, _chan##_stats) = {			\
+		.chan = &(_chan),							\
+	}
+
+/**
+ * @brief Record that a message subscriber has received a message.
+ *
+ * Call after every successful zbus_sub_wait_msg().
+ *
+ * @param obs Message subscriber that received the message.
+ * @param chan Channel the message was received on.
+ */
+void zbus_stats_received(const struct zbus_observer *obs, const struct zbus_channel *chan);
+
+/**
+ * @brief Get the delivery latency that 99 % of the deliveries did not exceed.
+ *
+ * @param buckets Latency histogram, as in struct zbus_stats_chan.
+ * @param max_ms Largest latency seen.
+ *
+ * @return Upper limit of the histogram bucket holding the 99th percentile, at most max_ms.
+ */
+uint32_t zbus_stats_latency_p99(const uint32_t buckets[ZBUS_STATS_LATENCY_BUCKETS],
+				uint32_t max_ms);
+
+#else
+
+#define ZBUS_STATS_CHAN_DEFINE(_chan)
+
+static inline void zbus_stats_received(const struct zbus_observer *obs,
+				       const struct zbus_channel *chan)
+{
+	ARG_UNUSED(obs);
+	ARG_UNUSED(chan);
+}
+
+#endif /* CONFIG_APP_ZBUS_STATS */
+
+#if defined(CONFIG_APP_ZBUS_STATS_MEMFAULT)
+#include <memfault/metrics/metrics.h>
+
+/** @brief Channel that is exported as Memfault heartbeat metrics. */
+struct zbus_stats_metric {
+	struct zbus_stats_chan *stats;
+
+	/* Sets the metrics of the heartbeat */
+	void (*set)(uint32_t publish_count, uint32_t latency_p99_ms, uint32_t queue_hwm);
+
+	/* Values at the previous heartbeat */
+	uint32_t last_publish_count;
+	uint32_t last_latency_buckets[ZBUS_STATS_LATENCY_BUCKETS];
+};
+
+/**
+ * @brief Export the statistics of a channel as Memfault heartbeat metrics.
+ *
+ * The number of publishes, the 99th percentile delivery latency and the subscriber queue
+ * high-water mark during each heartbeat interval are reported as the `<_key>_pub_count`,
+ * `<_key>_latency_p99_ms` and `<_key>_queue_hwm` metrics, which must be defined in
+ * memfault_metrics_heartbeat_config.def.
+ *
+ * @param _chan Name of the channel given to ZBUS_STATS_CHAN_DEFINE().
+ * @param _key Prefix of the metric keys.
+ */
+#define ZBUS_STATS_METRIC_DEFINE(_chan, _key)						\
+	static void _key##_metric_set(uint32_t publish_count, uint32_t latency_p99_ms,	\
+				      uint32_t queue_hwm)				\
+	{										\
+		MEMFAULT_METRIC_SET_UNSIGNED(_key##_pub_count, publish_count);		\
+		MEMFAULT_METRIC_SET_UNSIGNED(_key##_latency_p99_ms, latency_p99_ms);	\
+		MEMFAULT_METRIC_SET_UNSIGNED(_key##_queue_hwm, queue_hwm);		\
+	}										\
+	STRUCT_SECTION_ITERABLE(zbus_stats_metric, _key##_zbus_stats_metric) = {	\
+		.stats = &_chan##_stats,						\
+		.set = _key##_metric_set,						\
+	}
+
+/** @brief Report the channel statistics of the heartbeat interval to Memfault. */
+void zbus_stats_heartbeat_collect(void);
+
+#else
+
+#define ZBUS_STATS_METRIC_DEFINE(_chan, _key)
+
+#endif /* CONFIG_APP_ZBUS_STATS_MEMFAULT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZBUS_STATS_H_ */
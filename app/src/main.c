@@ -13,6 +13,10 @@
 #include <zephyr/sys/reboot.h>
 
 #include "app_common.h"
+#include "state_stats.h"
+#include "zbus_stats.h"
+#include "handler_stats.h"
+#include "etb_profiler.h"
 #include "network.h"
 #include "cloud.h"
 #include "fota.h"
@@ -36,6 +40,19 @@
 #include "power.h"
 #endif /* CONFIG_APP_POWER */
 
+#if defined(CONFIG_APP_MOTION)
+#include "motion.h"
+#endif /* CONFIG_APP_MOTION */
+
+#if defined(CONFIG_APP_GEOFENCE)
+#include "geofence.h"
+#endif /* CONFIG_APP_GEOFENCE */
+
+#if defined(CONFIG_APP_CONFIG_PERSIST)
+#include <zephyr/settings/settings.h>
+#include <string.h>
+#endif /* CONFIG_APP_CONFIG_PERSIST */
+
 /* Register log module */
 LOG_MODULE_REGISTER(main, 4);
 
@@ -45,8 +62,8 @@ ZBUS_MSG_SUBSCRIBER_DEFINE(main_subscriber);
 enum timer_msg_type {
 	/* Timer for sampling data has expired.
 	 * This timer is used to trigger the sampling of data from the sensors.
-	 * The timer is set to expire every CONFIG_APP_SAMPLING_INTERVAL_SECONDS,
-	 * and can be overridden from the cloud.
+	 * The timer is set to expire at the earliest sample deadline of the data sources,
+	 * see enum sample_source.
 	 */
 	TIMER_EXPIRED_SAMPLE_DATA,
 
@@ -72,6 +89,11 @@ ZBUS_CHAN_DEFINE(timer_chan,
 enum priv_main_msg_type {
 	/* All modules have signaled that they are ready. */
 	MAIN_MODULES_READY,
+
+	/* No NETWORK_QUALITY_SAMPLE_RESPONSE was received for the evaluation of a deferred
+	 * upload.
+	 */
+	MAIN_UPLOAD_EVAL_TIMEOUT,
 };
 
 struct priv_main_msg {
@@ -99,7 +121,8 @@ ZBUS_CHAN_DEFINE(priv_main_chan,
 	X(timer_chan,		struct timer_msg)		\
 	X(priv_main_chan,	struct priv_main_msg)		\
 	IF_ENABLED(CONFIG_APP_BUTTON, (X(button_chan, struct button_msg)))	\
-	IF_ENABLED(CONFIG_APP_POWER, (X(power_chan, struct power_msg)))
+	IF_ENABLED(CONFIG_APP_POWER, (X(power_chan, struct power_msg)))	\
+	IF_ENABLED(CONFIG_APP_MOTION, (X(motion_chan, struct motion_msg)))
 
 /* Calculate the maximum message size from the list of channels */
 #define MAX_MSG_SIZE			MAX_MSG_SIZE_FROM_LIST(CHANNEL_LIST)
@@ -113,6 +136,59 @@ ZBUS_CHAN_DEFINE(priv_main_chan,
  */
 CHANNEL_LIST(ADD_OBSERVERS)
 
+#if defined(CONFIG_APP_CLOUD_PRIORITY_LANE) && defined(CONFIG_APP_BUTTON)
+/* Button presses are forwarded to the cloud priority lane from a listener, so that they reach
+ * the cloud module without waiting for the main state machine or the stored data.
+ */
+static void button_priority_forward(const struct zbus_channel *chan)
+{
+	int err;
+	const struct button_msg *button = zbus_chan_const_msg(chan);
+	const struct cloud_priority_msg msg = {
+		.type = CLOUD_PRIORITY_BUTTON,
+		.uptime_ms = k_uptime_get(),
+		.button_number = button->button_number,
+	};
+
+	/* Listeners must not block */
+	err = zbus_chan_pub(&cloud_priority_chan, &msg, K_NO_WAIT);
+	if (err) {
+		LOG_WRN("Button press not forwarded to the cloud, error: %d", err);
+	}
+}
+
+ZBUS_LISTENER_DEFINE(main_button_priority, button_priority_forward);
+ZBUS_CHAN_ADD_OBS(button_chan, main_button_priority, 0);
+#endif /* CONFIG_APP_CLOUD_PRIORITY_LANE && CONFIG_APP_BUTTON */
+
+/* Data sources with their own sample deadline. Location is sampled every sample_interval,
+ * the other sources every power_interval and environmental_interval from the shadow.
+ */
+enum sample_source {
+	SAMPLE_SOURCE_LOCATION,
+	SAMPLE_SOURCE_POWER,
+	SAMPLE_SOURCE_ENVIRONMENTAL,
+
+	SAMPLE_SOURCE_COUNT,
+};
+
+#define SAMPLE_SOURCES_ALL	(BIT(SAMPLE_SOURCE_COUNT) - 1)
+
+#if defined(CONFIG_APP_POWER_POLICY)
+/* Operating profiles selected from the battery state of charge, see CONFIG_APP_POWER_POLICY */
+enum power_profile {
+	POWER_PROFILE_NORMAL,
+	POWER_PROFILE_LOW,
+	POWER_PROFILE_CRITICAL,
+};
+
+static const char *const power_profile_names[] = {
+	[POWER_PROFILE_NORMAL] = "normal",
+	[POWER_PROFILE_LOW] = "low",
+	[POWER_PROFILE_CRITICAL] = "critical",
+};
+#endif /* CONFIG_APP_POWER_POLICY */
+
 /* Forward declarations */
 static void timer_sample_data_work_fn(struct k_work *work);
 static void timer_sample_start(uint32_t delay_sec);
@@ -121,6 +197,13 @@ static void timer_sample_stop(void);
 /* Delayable work used to schedule triggers */
 static K_WORK_DELAYABLE_DEFINE(timer_sample_data_work, timer_sample_data_work_fn);
 
+#if defined(CONFIG_APP_UPLOAD_SCHEDULING)
+static void upload_eval_timeout_work_fn(struct k_work *work);
+
+/* The network module does not respond to a connection evaluation that fails */
+static K_WORK_DELAYABLE_DEFINE(upload_eval_timeout_work, upload_eval_timeout_work_fn);
+#endif /* CONFIG_APP_UPLOAD_SCHEDULING */
+
 /* Forward declarations of state handlers */
 static enum smf_state_result waiting_for_modules_init_run(void *o);
 static enum smf_state_result running_run(void *o);
@@ -133,6 +216,7 @@ static enum smf_state_result connected_run(void *o);
 
 /* Disconnected operation handlers */
 static void disconnected_sampling_entry(void *o);
+static void sampling_exit(void *o);
 static enum smf_state_result disconnected_sampling_run(void *o);
 static void disconnected_waiting_entry(void *o);
 static enum smf_state_result disconnected_waiting_run(void *o);
@@ -146,9 +230,11 @@ static enum smf_state_result connected_waiting_run(void *o);
 static void connected_waiting_exit(void *o);
 static void connected_sending_entry(void *o);
 static enum smf_state_result connected_sending_run(void *o);
+static void connected_sending_exit(void *o);
 
 static void fota_entry(void *o);
 static enum smf_state_result fota_run(void *o);
+static void fota_exit(void *o);
 
 static void rebooting_entry(void *o);
 
@@ -194,16 +280,77 @@ struct main_state {
 	/* Trigger interval */
 	uint32_t sample_interval_sec;
 
+	/* Sample interval per data source in seconds, 0 to follow sample_interval_sec.
+	 * Not used for SAMPLE_SOURCE_LOCATION.
+	 */
+	uint32_t source_interval_sec[SAMPLE_SOURCE_COUNT];
+
+	/* Uptime in seconds of the most recent sampling of each data source. This is used to
+	 * calculate the deadline of the next sampling.
+	 */
+	uint32_t source_sample_time[SAMPLE_SOURCE_COUNT];
+
+	/* Bitmask of the data sources, BIT(enum sample_source), to sample on the next entry to a
+	 * sampling state.
+	 */
+	uint32_t sources_to_sample;
+
+#if defined(CONFIG_APP_MOTION)
+	/* Location sample interval adapted to motion, capped at sample_interval_sec.
+	 * Set to CONFIG_APP_MOTION_LOCATION_INTERVAL_SECONDS on motion and doubled for every
+	 * location sample without motion since the previous one.
+	 */
+	uint32_t location_interval_sec;
+
+	/* Motion detected since the last location sample */
+	bool moved_since_location;
+#endif /* CONFIG_APP_MOTION */
+
 	/* Storage threshold for triggering data send to cloud */
 	uint32_t storage_threshold;
 
-	/* Start time of the most recent sampling. This is used to calculate the correct
-	 * time when scheduling the next sampling trigger.
+#if defined(CONFIG_APP_ENVIRONMENTAL)
+	/* Channels read from the environmental sensor, set by the environmental_profile key */
+	enum environmental_profile environmental_profile;
+#endif /* CONFIG_APP_ENVIRONMENTAL */
+
+#if defined(CONFIG_APP_GEOFENCE)
+	/* Which location fixes are stored, set by the location_report shadow key */
+	enum geofence_report_mode location_report;
+
+	/* Interval in seconds of the fixes stored in GEOFENCE_REPORT_EVENTS mode */
+	uint32_t heartbeat_interval;
+#endif /* CONFIG_APP_GEOFENCE */
+
+#if defined(CONFIG_APP_POWER_POLICY)
+	/* Current operating profile. Stretches the sample intervals and the storage threshold
+	 * above their configured values.
+	 */
+	enum power_profile power_profile;
+#endif /* CONFIG_APP_POWER_POLICY */
+
+	/* A FOTA poll is waiting until fota_poll_allowed() allows it. With
+	 * CONFIG_APP_FOTA_SCHEDULING, it also waits for the device to be connected and idle.
+	 */
+	bool fota_poll_deferred;
+
+#if defined(CONFIG_APP_FOTA_SCHEDULING)
+	/* Uptime in milliseconds when the pending FOTA poll was requested */
+	int64_t fota_deferred_since;
+#endif /* CONFIG_APP_FOTA_SCHEDULING */
+
+#if defined(CONFIG_APP_UPLOAD_SCHEDULING)
+	/* The storage threshold was reached and the upload waits for a connection that costs
+	 * less energy.
 	 */
-	uint32_t sample_start_time;
+	bool upload_deferred;
+
+	/* Uptime in milliseconds when the pending upload was deferred */
+	int64_t upload_deferred_since;
+#endif /* CONFIG_APP_UPLOAD_SCHEDULING */
 
 	/* Used to fire the very first sample immediately on boot regardless
-	 * of sample_start_time.
+	 * of the sample times of the data sources.
 	 */
 	bool first_sample_pending;
 
@@ -220,6 +367,18 @@ struct main_state {
 	 */
 	bool cloud_synced_on_connect;
 
+#if defined(CONFIG_APP_CONFIG_PERSIST)
+	/* Flag to track if a saved configuration was applied at boot, in which case only the
+	 * shadow delta is fetched on the initial connection.
+	 */
+	bool config_restored;
+#endif /* CONFIG_APP_CONFIG_PERSIST */
+
+	/* Flag to track if a FOTA download was interrupted and is to be resumed by polling
+	 * again when the cloud is connected.
+	 */
+	bool fota_resume_pending;
+
 	/* Flag to track if the storage threshold was reached while disconnected.
 	 * Used to decide whether to send data immediately on reconnection.
 	 */
@@ -265,7 +424,7 @@ static const struct smf_state states[] = {
 	[STATE_DISCONNECTED_SAMPLING] = SMF_CREATE_STATE(
 		disconnected_sampling_entry,
 		disconnected_sampling_run,
-		NULL,
+		sampling_exit,
 		&states[STATE_DISCONNECTED],
 		NULL
 	),
@@ -287,7 +446,7 @@ static const struct smf_state states[] = {
 	[STATE_CONNECTED_SAMPLING] = SMF_CREATE_STATE(
 		connected_sampling_entry,
 		connected_sampling_run,
-		NULL,
+		sampling_exit,
 		&states[STATE_CONNECTED],
 		NULL
 	),
@@ -301,7 +460,7 @@ static const struct smf_state states[] = {
 	[STATE_CONNECTED_SENDING] = SMF_CREATE_STATE(
 		connected_sending_entry,
 		connected_sending_run,
-		NULL,
+		connected_sending_exit,
 		&states[STATE_CONNECTED],
 		NULL
 	),
@@ -309,7 +468,7 @@ static const struct smf_state states[] = {
 	[STATE_FOTA] = SMF_CREATE_STATE(
 		fota_entry,
 		fota_run,
-		NULL,
+		fota_exit,
 		NULL,
 		NULL
 	),
@@ -322,6 +481,10 @@ static const struct smf_state states[] = {
 	),
 };
 
+STATE_STATS_DEFINE(main, states);
+HANDLER_STATS_DEFINE(main, CONFIG_APP_MSG_PROCESSING_TIMEOUT_SECONDS);
+HANDLER_STATS_METRIC_DEFINE(main);
+
 /* Static helper function */
 
 static void task_wdt_callback(int channel_id, void *user_data)
@@ -358,7 +521,52 @@ static void poll_shadow_send(enum cloud_msg_type type)
 	}
 }
 
-static void poll_triggers_send(void)
+#if defined(CONFIG_APP_CLOUD_MEMFAULT_UPLOAD)
+/* Memfault data is uploaded right after the stored data, while the RRC connection is up */
+static void memfault_upload_send(void)
+{
+	int err;
+	struct cloud_msg cloud_msg = {
+		.type = CLOUD_MEMFAULT_UPLOAD,
+	};
+
+	err = zbus_chan_pub(&cloud_chan, &cloud_msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish Memfault upload request, error: %d", err);
+		SEND_FATAL_ERROR();
+
+		return;
+	}
+}
+#endif /* CONFIG_APP_CLOUD_MEMFAULT_UPLOAD */
+
+/* FOTA is deferred while the battery is low */
+static bool fota_poll_allowed(const struct main_state *state_object)
+{
+#if defined(CONFIG_APP_FAST_BOOT)
+	/* Polled from running_run() when the module reports ready */
+	if (!state_object->modules_ready.fota_ready) {
+		LOG_DBG("FOTA poll deferred until the FOTA module is ready");
+
+		return false;
+	}
+#endif /* CONFIG_APP_FAST_BOOT */
+
+#if defined(CONFIG_APP_POWER_POLICY)
+	if (state_object->power_profile != POWER_PROFILE_NORMAL) {
+		LOG_DBG("FOTA poll deferred in the %s power profile",
+			power_profile_names[state_object->power_profile]);
+
+		return false;
+	}
+#else
+	ARG_UNUSED(state_object);
+#endif /* CONFIG_APP_POWER_POLICY */
+
+	return true;
+}
+
+static void fota_poll_publish(void)
 {
 	int err;
 	struct fota_msg fota_msg = { .type = FOTA_POLL_REQUEST };
@@ -367,10 +575,214 @@ static void poll_triggers_send(void)
 	if (err) {
 		LOG_ERR("Failed to publish FOTA poll trigger, error: %d", err);
 		SEND_FATAL_ERROR();
+	}
+}
+
+#if !defined(CONFIG_APP_FOTA_SCHEDULING)
+/* Send a deferred FOTA poll if it is allowed. Only called while the device is connected. */
+static void fota_poll_deferred_send(struct main_state *state_object)
+{
+	if (!state_object->fota_poll_deferred || !fota_poll_allowed(state_object)) {
+		return;
+	}
+
+	state_object->fota_poll_deferred = false;
+
+	fota_poll_publish();
+}
+#endif /* !CONFIG_APP_FOTA_SCHEDULING */
+
+/* The poll is deferred while fota_poll_allowed() does not allow it, and is sent once it does.
+ * With CONFIG_APP_FOTA_SCHEDULING, the poll is also deferred until the device is connected and
+ * idle, see fota_poll_deferred_check().
+ */
+static void fota_poll_send(struct main_state *state_object)
+{
+	if (!state_object->fota_poll_deferred) {
+		state_object->fota_poll_deferred = true;
+#if defined(CONFIG_APP_FOTA_SCHEDULING)
+		state_object->fota_deferred_since = k_uptime_get();
+#endif /* CONFIG_APP_FOTA_SCHEDULING */
+	}
+
+#if !defined(CONFIG_APP_FOTA_SCHEDULING)
+	fota_poll_deferred_send(state_object);
+#endif /* !CONFIG_APP_FOTA_SCHEDULING */
+}
+
+#if defined(CONFIG_APP_FOTA_SCHEDULING)
+/* Called when the device is idle after sending data. The link quality is sampled first, and
+ * the poll is sent from fota_poll_rsrp_check() when the response arrives.
+ */
+static void fota_poll_deferred_check(const struct main_state *state_object)
+{
+	int err;
+	struct network_msg network_msg = { .type = NETWORK_QUALITY_SAMPLE_REQUEST };
+
+	if (!state_object->fota_poll_deferred || !fota_poll_allowed(state_object)) {
+		return;
+	}
+
+	err = zbus_chan_pub(&network_chan, &network_msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish network quality sample request, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
 
+static void fota_poll_rsrp_check(struct main_state *state_object, int16_t rsrp_idx)
+{
+	int64_t deferred_ms;
+
+	if (!state_object->fota_poll_deferred || !fota_poll_allowed(state_object)) {
 		return;
 	}
 
+	deferred_ms = k_uptime_get() - state_object->fota_deferred_since;
+
+	/* A weak signal only defers the poll for a limited time */
+	if ((rsrp_idx != RSRP_IDX_UNKNOWN) &&
+	    (RSRP_IDX_TO_DBM(rsrp_idx) < CONFIG_APP_FOTA_SCHEDULING_MIN_RSRP) &&
+	    (deferred_ms < ((int64_t)CONFIG_APP_FOTA_SCHEDULING_MAX_DEFERRAL_SECONDS *
+			    MSEC_PER_SEC))) {
+		LOG_DBG("FOTA poll deferred, RSRP: %d dBm", RSRP_IDX_TO_DBM(rsrp_idx));
+
+		return;
+	}
+
+	LOG_DBG("Sending FOTA poll deferred for %lld seconds", deferred_ms / MSEC_PER_SEC);
+
+	state_object->fota_poll_deferred = false;
+
+	fota_poll_publish();
+}
+#endif /* CONFIG_APP_FOTA_SCHEDULING */
+
+#if defined(CONFIG_APP_UPLOAD_SCHEDULING)
+/* Number of stored samples of a type at which uploads are no longer deferred */
+#define UPLOAD_FORCE_COUNT ((CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE *			\
+			     CONFIG_APP_UPLOAD_SCHEDULING_FORCE_PERCENT) / 100)
+
+static void upload_eval_timeout_work_fn(struct k_work *work)
+{
+	int err;
+	const struct priv_main_msg msg = { .type = MAIN_UPLOAD_EVAL_TIMEOUT };
+
+	ARG_UNUSED(work);
+
+	err = zbus_chan_pub(&priv_main_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish MAIN_UPLOAD_EVAL_TIMEOUT message, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+static void upload_quality_sample_request(void)
+{
+	int err;
+	struct network_msg network_msg = { .type = NETWORK_QUALITY_SAMPLE_REQUEST };
+
+	err = zbus_chan_pub(&network_chan, &network_msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish network quality sample request, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+
+	(void)k_work_reschedule(&upload_eval_timeout_work,
+				K_SECONDS(CONFIG_APP_UPLOAD_SCHEDULING_EVAL_TIMEOUT_SECONDS));
+}
+
+static bool upload_slack_expired(const struct main_state *state_object)
+{
+	return (k_uptime_get() - state_object->upload_deferred_since) >=
+	       ((int64_t)CONFIG_APP_UPLOAD_SCHEDULING_SLACK_SECONDS * MSEC_PER_SEC);
+}
+
+/* Called when the storage threshold is reached while connected. Returns true if the data is to
+ * be sent now. Otherwise, the connection is evaluated and the data is sent from
+ * STATE_CONNECTED_WAITING when upload_energy_check() allows it.
+ */
+static bool upload_threshold_check(struct main_state *state_object,
+				   const struct storage_msg *msg)
+{
+	/* Storage that is close to full is sent regardless of the connection, so that no
+	 * samples are overwritten.
+	 */
+	if (msg->data_len >= UPLOAD_FORCE_COUNT) {
+		LOG_DBG("Sending %d stored samples without evaluating the connection",
+			msg->data_len);
+
+		return true;
+	}
+
+	if (!state_object->upload_deferred) {
+		state_object->upload_deferred = true;
+		state_object->upload_deferred_since = k_uptime_get();
+	}
+
+	if (upload_slack_expired(state_object)) {
+		return true;
+	}
+
+	upload_quality_sample_request();
+
+	return false;
+}
+
+/* Called when the device is idle, a deferred upload is evaluated again */
+static void upload_deferred_check(const struct main_state *state_object)
+{
+	if (state_object->upload_deferred) {
+		upload_quality_sample_request();
+	}
+}
+
+/* Called with the connection evaluation in STATE_CONNECTED_WAITING. Returns true if the
+ * deferred upload is to be sent now. A response that arrives in another state is ignored,
+ * the connection is evaluated again when STATE_CONNECTED_WAITING is entered.
+ */
+static bool upload_energy_check(const struct main_state *state_object,
+				const struct lte_lc_conn_eval_params *params)
+{
+	if (!state_object->upload_deferred) {
+		return false;
+	}
+
+	if ((params->energy_estimate < CONFIG_APP_UPLOAD_SCHEDULING_MIN_ENERGY_ESTIMATE) &&
+	    !upload_slack_expired(state_object)) {
+		LOG_DBG("Upload deferred, energy estimate: %d", params->energy_estimate);
+
+		return false;
+	}
+
+	LOG_DBG("Sending data deferred for %lld seconds, energy estimate: %d",
+		(k_uptime_get() - state_object->upload_deferred_since) / MSEC_PER_SEC,
+		params->energy_estimate);
+
+	return true;
+}
+
+/* Called in STATE_CONNECTED_WAITING when the connection evaluation got no response. The
+ * evaluation fails, for example, in RRC connected mode, where the radio is already on and
+ * sending costs little, so the deferred upload is sent.
+ */
+static bool upload_eval_timeout_check(const struct main_state *state_object)
+{
+	if (!state_object->upload_deferred) {
+		return false;
+	}
+
+	LOG_DBG("No connection evaluation, sending data deferred for %lld seconds",
+		(k_uptime_get() - state_object->upload_deferred_since) / MSEC_PER_SEC);
+
+	return true;
+}
+#endif /* CONFIG_APP_UPLOAD_SCHEDULING */
+
+static void poll_triggers_send(struct main_state *state_object)
+{
+	fota_poll_send(state_object);
+
 	/* Get the latest device configuration by polling the desired section of the shadow */
 	poll_shadow_send(CLOUD_SHADOW_GET_DELTA);
 }
@@ -391,13 +803,208 @@ static void handle_fota_reboot_request(struct main_state *state_object)
 	smf_set_state(SMF_CTX(state_object), &states[STATE_REBOOTING]);
 }
 
-static void trigger_sampling(struct main_state *state_object)
+static bool source_enabled(enum sample_source source)
+{
+	switch (source) {
+	case SAMPLE_SOURCE_POWER:
+		return IS_ENABLED(CONFIG_APP_POWER);
+	case SAMPLE_SOURCE_ENVIRONMENTAL:
+		return IS_ENABLED(CONFIG_APP_ENVIRONMENTAL);
+	default:
+		return true;
+	}
+}
+
+static uint32_t source_interval_get(const struct main_state *state_object,
+				    enum sample_source source)
+{
+#if defined(CONFIG_APP_MOTION)
+	if (source == SAMPLE_SOURCE_LOCATION) {
+		return MIN(state_object->location_interval_sec, state_object->sample_interval_sec);
+	}
+#endif /* CONFIG_APP_MOTION */
+
+	if ((source == SAMPLE_SOURCE_LOCATION) || !state_object->source_interval_sec[source]) {
+		return state_object->sample_interval_sec;
+	}
+
+	return state_object->source_interval_sec[source];
+}
+
+/* Interval used to schedule the sampling of a data source, which the power profile can make
+ * longer than the configured interval.
+ */
+static uint32_t source_sample_interval_get(const struct main_state *state_object,
+					   enum sample_source source)
+{
+	uint32_t interval = source_interval_get(state_object, source);
+
+#if defined(CONFIG_APP_POWER_POLICY)
+	if (state_object->power_profile == POWER_PROFILE_LOW) {
+		interval = MAX(interval, CONFIG_APP_POWER_POLICY_LOW_SAMPLING_INTERVAL_SECONDS);
+	} else if (state_object->power_profile == POWER_PROFILE_CRITICAL) {
+		interval = MAX(interval, CONFIG_APP_POWER_POLICY_CRITICAL_SAMPLING_INTERVAL_SECONDS);
+	}
+#endif /* CONFIG_APP_POWER_POLICY */
+
+	return interval;
+}
+
+/* Storage threshold, which the power profile can make larger than the configured threshold */
+static uint32_t storage_threshold_get(const struct main_state *state_object)
+{
+	uint32_t threshold = state_object->storage_threshold;
+
+#if defined(CONFIG_APP_POWER_POLICY)
+	if (state_object->power_profile == POWER_PROFILE_LOW) {
+		threshold = MAX(threshold, CONFIG_APP_POWER_POLICY_LOW_STORAGE_THRESHOLD);
+	} else if (state_object->power_profile == POWER_PROFILE_CRITICAL) {
+		threshold = MAX(threshold, CONFIG_APP_POWER_POLICY_CRITICAL_STORAGE_THRESHOLD);
+	}
+#endif /* CONFIG_APP_POWER_POLICY */
+
+	return threshold;
+}
+
+static void storage_threshold_send(const struct main_state *state_object)
 {
 	int err;
-	struct location_msg location_msg = {
-		.type = LOCATION_SEARCH_TRIGGER,
+	struct storage_msg storage_msg = {
+		.type = STORAGE_SET_THRESHOLD,
+		.data_len = storage_threshold_get(state_object),
 	};
 
+	err = zbus_chan_pub(&storage_chan, &storage_msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish storage threshold update, error: %d", err);
+		SEND_FATAL_ERROR();
+
+		return;
+	}
+}
+
+/* Send the sample and upload intervals to the network module, which requests PSM and eDRX
+ * timers that match them and suspends searching until a sample deadline. Uploads happen when
+ * the storage threshold is reached.
+ */
+static void network_schedule_send(const struct main_state *state_object)
+{
+	int err;
+	uint32_t interval = source_sample_interval_get(state_object, SAMPLE_SOURCE_LOCATION);
+	struct network_msg network_msg = {
+		.type = NETWORK_SCHEDULE_SET,
+		.schedule = {
+			.sample_interval_sec = interval,
+			.upload_interval_sec = interval * storage_threshold_get(state_object),
+		},
+	};
+
+	if (!IS_ENABLED(CONFIG_APP_NETWORK_POWER_SAVING_NEGOTIATION) &&
+	    !IS_ENABLED(CONFIG_APP_NETWORK_SEARCH_POLICY)) {
+		return;
+	}
+
+	err = zbus_chan_pub(&network_chan, &network_msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish network schedule, error: %d", err);
+		SEND_FATAL_ERROR();
+
+		return;
+	}
+}
+
+/* Seconds until the next sampling of a data source is due, 0 if it is due now */
+static uint32_t source_time_remaining(const struct main_state *state_object,
+				      enum sample_source source, uint32_t now)
+{
+	uint32_t interval = source_sample_interval_get(state_object, source);
+	uint32_t time_elapsed = now - state_object->source_sample_time[source];
+
+	if (state_object->first_sample_pending) {
+		return 0;
+	}
+
+	return (time_elapsed >= interval) ? 0 : (interval - time_elapsed);
+}
+
+/* Bitmask of the data sources that are due within CONFIG_APP_SAMPLING_BATCH_WINDOW_SECONDS,
+ * so that deadlines close to each other share one wake-up.
+ */
+static uint32_t sources_due_get(const struct main_state *state_object)
+{
+	uint32_t now = k_uptime_seconds();
+	uint32_t due = 0;
+
+	for (enum sample_source source = 0; source < SAMPLE_SOURCE_COUNT; source++) {
+		if (source_enabled(source) &&
+		    (source_time_remaining(state_object, source, now) <=
+		     CONFIG_APP_SAMPLING_BATCH_WINDOW_SECONDS)) {
+			due |= BIT(source);
+		}
+	}
+
+	return due;
+}
+
+#if defined(CONFIG_APP_MOTION)
+/* Back off the location sample interval exponentially while the device is stationary */
+static void location_interval_update(struct main_state *state_object)
+{
+	if (state_object->moved_since_location) {
+		state_object->location_interval_sec = CONFIG_APP_MOTION_LOCATION_INTERVAL_SECONDS;
+	} else {
+		state_object->location_interval_sec =
+			MIN((uint64_t)state_object->location_interval_sec * 2,
+			    state_object->sample_interval_sec);
+	}
+
+	state_object->moved_since_location = false;
+
+	LOG_DBG("Next location sample in %d seconds",
+		source_sample_interval_get(state_object, SAMPLE_SOURCE_LOCATION));
+}
+
+/* Sample location at the motion interval and wake up the waiting states to apply it */
+static void handle_motion_detected(struct main_state *state_object)
+{
+	int err;
+	const struct location_msg location_msg = { .type = LOCATION_MOTION_DETECTED };
+	const struct timer_msg timer_msg = { .type = TIMER_CONFIG_CHANGED };
+
+	LOG_DBG("Motion detected, sampling location every %d seconds",
+		MIN(CONFIG_APP_MOTION_LOCATION_INTERVAL_SECONDS, state_object->sample_interval_sec));
+
+	state_object->location_interval_sec = CONFIG_APP_MOTION_LOCATION_INTERVAL_SECONDS;
+	state_object->moved_since_location = true;
+
+	/* Drop a cached fix in the location module, the device is no longer where it was */
+	err = zbus_chan_pub(&location_chan, &location_msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish location motion detected, error: %d", err);
+		SEND_FATAL_ERROR();
+
+		return;
+	}
+
+	err = zbus_chan_pub(&timer_chan, &timer_msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish timer config changed event, error: %d", err);
+		SEND_FATAL_ERROR();
+
+		return;
+	}
+}
+#endif /* CONFIG_APP_MOTION */
+
+/* Trigger sampling of the data sources in state_object->sources_to_sample */
+static void trigger_sampling(struct main_state *state_object)
+{
+	int err;
+	uint32_t now = k_uptime_seconds();
+	uint32_t sources = state_object->sources_to_sample;
+
+	LOG_DBG("Sampling data sources, mask: 0x%x", sources);
+
 #if defined(CONFIG_APP_LED)
 	/* Blue pattern to indicate sampling */
 	struct led_msg led_msg = {
@@ -419,65 +1026,105 @@ static void trigger_sampling(struct main_state *state_object)
 	}
 #endif /* CONFIG_APP_LED */
 
-	state_object->sample_start_time = k_uptime_seconds();
+	for (enum sample_source source = 0; source < SAMPLE_SOURCE_COUNT; source++) {
+		if (sources & BIT(source)) {
+			state_object->source_sample_time[source] = now;
+		}
+	}
+
 	state_object->first_sample_pending = false;
+	state_object->sources_to_sample = 0;
 
 #if defined(CONFIG_APP_POWER)
-	struct power_msg power_msg = {
-		.type = POWER_BATTERY_PERCENTAGE_SAMPLE_REQUEST,
-	};
+	if (sources & BIT(SAMPLE_SOURCE_POWER)) {
+		struct power_msg power_msg = {
+			.type = POWER_BATTERY_PERCENTAGE_SAMPLE_REQUEST,
+		};
 
-	err = zbus_chan_pub(&power_chan, &power_msg, PUB_TIMEOUT);
-	if (err) {
-		LOG_ERR("Failed to publish power battery sample request, error: %d", err);
-		SEND_FATAL_ERROR();
+		err = zbus_chan_pub(&power_chan, &power_msg, PUB_TIMEOUT);
+		if (err) {
+			LOG_ERR("Failed to publish power battery sample request, error: %d", err);
+			SEND_FATAL_ERROR();
 
-		return;
+			return;
+		}
 	}
 #endif /* CONFIG_APP_POWER */
 
 #if defined(CONFIG_APP_ENVIRONMENTAL)
-	struct environmental_msg environmental_msg = {
-		.type = ENVIRONMENTAL_SENSOR_SAMPLE_REQUEST,
-	};
+	if (sources & BIT(SAMPLE_SOURCE_ENVIRONMENTAL)) {
+		struct environmental_msg environmental_msg = {
+			.type = ENVIRONMENTAL_SENSOR_SAMPLE_REQUEST,
+		};
 
-	err = zbus_chan_pub(&environmental_chan, &environmental_msg, PUB_TIMEOUT);
-	if (err) {
-		LOG_ERR("Failed to publish environmental sensor sample request, error: %d", err);
-		SEND_FATAL_ERROR();
+		err = zbus_chan_pub(&environmental_chan, &environmental_msg, PUB_TIMEOUT);
+		if (err) {
+			LOG_ERR("Failed to publish environmental sensor sample request, error: %d",
+				err);
+			SEND_FATAL_ERROR();
 
-		return;
+			return;
+		}
 	}
 #endif /* CONFIG_APP_ENVIRONMENTAL */
 
-	err = zbus_chan_pub(&location_chan, &location_msg, PUB_TIMEOUT);
-	if (err) {
-		LOG_ERR("Failed to publish location search trigger, error: %d", err);
-		SEND_FATAL_ERROR();
+	if (sources & BIT(SAMPLE_SOURCE_LOCATION)) {
+		struct location_msg location_msg = {
+			.type = LOCATION_SEARCH_TRIGGER,
+		};
 
-		return;
+#if defined(CONFIG_APP_POWER_POLICY) && defined(CONFIG_LOCATION_METHOD_CELLULAR)
+		if (state_object->power_profile == POWER_PROFILE_CRITICAL) {
+			location_msg.type = LOCATION_CELLULAR_SEARCH_TRIGGER;
+		}
+#endif /* CONFIG_APP_POWER_POLICY && CONFIG_LOCATION_METHOD_CELLULAR */
+
+#if defined(CONFIG_APP_MOTION)
+		location_interval_update(state_object);
+#endif /* CONFIG_APP_MOTION */
+
+		err = zbus_chan_pub(&location_chan, &location_msg, PUB_TIMEOUT);
+		if (err) {
+			LOG_ERR("Failed to publish location search trigger, error: %d", err);
+			SEND_FATAL_ERROR();
+
+			return;
+		}
 	}
 }
 
-static void waiting_entry_common(const struct main_state *state_object)
+/* Handle expiry of the sample timer in a waiting state. Location sampling is done in the
+ * sampling state, which waits for the location search to complete. The other data sources
+ * are sampled directly, and the waiting state is re-entered to schedule the next deadline.
+ */
+static void sample_timer_expired(struct main_state *state_object,
+				 enum app_state sampling_state, enum app_state waiting_state)
 {
-	uint32_t time_elapsed;
-	uint32_t time_remaining;
+	state_object->sources_to_sample = sources_due_get(state_object);
 
-	/* Reschedule the next sample trigger */
+	if (state_object->sources_to_sample & BIT(SAMPLE_SOURCE_LOCATION)) {
+		smf_set_state(SMF_CTX(state_object), &states[sampling_state]);
 
-	if (state_object->first_sample_pending) {
-		time_remaining = 0;
-	} else {
-		time_elapsed = k_uptime_seconds() - state_object->sample_start_time;
+		return;
+	}
 
-		if (time_elapsed > state_object->sample_interval_sec) {
-			LOG_WRN("Sampling took longer than the interval, time_elapsed: %d, "
-				"interval: %d",
-				time_elapsed, state_object->sample_interval_sec);
-			time_remaining = 0;
-		} else {
-			time_remaining = state_object->sample_interval_sec - time_elapsed;
+	if (state_object->sources_to_sample) {
+		trigger_sampling(state_object);
+	}
+
+	smf_set_state(SMF_CTX(state_object), &states[waiting_state]);
+}
+
+static void waiting_entry_common(const struct main_state *state_object)
+{
+	uint32_t now = k_uptime_seconds();
+	uint32_t time_remaining = UINT32_MAX;
+
+	/* Reschedule the next sample trigger at the earliest deadline */
+	for (enum sample_source source = 0; source < SAMPLE_SOURCE_COUNT; source++) {
+		if (source_enabled(source)) {
+			time_remaining = MIN(time_remaining,
+					     source_time_remaining(state_object, source, now));
 		}
 	}
 
@@ -515,7 +1162,7 @@ static void storage_send_data(struct main_state *state_object)
 static void cloud_send_now(struct main_state *state_object)
 {
 	storage_send_data(state_object);
-	poll_triggers_send();
+	poll_triggers_send(state_object);
 
 #if defined(CONFIG_APP_LED)
 	int err;
@@ -616,18 +1263,101 @@ static void update_shadow_reported_section(const struct config_params *config,
 	if (config->sample_interval != 0) {
 		LOG_DBG("Reported sample_interval: %d", config->sample_interval);
 	}
+	if (config->power_interval != 0) {
+		LOG_DBG("Reported power_interval: %d", config->power_interval);
+	}
+	if (config->environmental_interval != 0) {
+		LOG_DBG("Reported environmental_interval: %d", config->environmental_interval);
+	}
 	if (config->storage_threshold_valid) {
 		LOG_DBG("Reported storage_threshold: %d", config->storage_threshold);
 	}
+	if (config->environmental_profile_valid) {
+		LOG_DBG("Reported environmental_profile: %d", config->environmental_profile);
+	}
+	if (config->location_report_valid) {
+		LOG_DBG("Reported location_report: %d", config->location_report);
+	}
+	if (config->heartbeat_interval != 0) {
+		LOG_DBG("Reported heartbeat_interval: %d", config->heartbeat_interval);
+	}
+}
+
+#if defined(CONFIG_APP_ENVIRONMENTAL)
+static void environmental_profile_send(const struct main_state *state_object)
+{
+	int err;
+	const struct environmental_msg msg = {
+		.type = ENVIRONMENTAL_PROFILE_SET,
+		.profile = state_object->environmental_profile,
+	};
+
+	err = zbus_chan_pub(&environmental_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+#endif /* CONFIG_APP_ENVIRONMENTAL */
+
+#if defined(CONFIG_APP_GEOFENCE)
+static void geofence_report_send(const struct main_state *state_object)
+{
+	int err;
+	const struct geofence_msg msg = {
+		.type = GEOFENCE_REPORT_SET,
+		.report.mode = state_object->location_report,
+		.report.heartbeat_interval = state_object->heartbeat_interval,
+	};
+
+	err = zbus_chan_pub(&geofence_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+/* Zones are not part of struct config_params, they are too large for the reported section.
+ * The geofence module keeps the state of zones that are set again unchanged.
+ */
+static void geofence_zones_apply(const struct cloud_msg *msg)
+{
+	int err;
+	static struct geofence_msg geofence_msg = {
+		.type = GEOFENCE_ZONES_SET,
+	};
+
+	err = decode_shadow_geofences_from_cbor(msg->response.buffer,
+						msg->response.buffer_data_len,
+						&geofence_msg.zones);
+	if (err == -ENOENT) {
+		return;
+	} else if (err) {
+		LOG_ERR("Failed to parse geofences, error: %d", err);
+		return;
+	}
+
+	err = zbus_chan_pub(&geofence_chan, &geofence_msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
 }
+#endif /* CONFIG_APP_GEOFENCE */
 
 static void config_apply(struct main_state *state_object, const struct config_params *config)
 {
 	int err;
 	bool interval_changed = false;
+	bool schedule_changed = false;
 
 	if (!config->sample_interval &&
-	    !config->storage_threshold_valid) {
+	    !config->power_interval &&
+	    !config->environmental_interval &&
+	    !config->storage_threshold_valid &&
+	    !config->environmental_profile_valid &&
+	    !config->location_report_valid &&
+	    !config->heartbeat_interval) {
 		LOG_DBG("No configuration parameters to update");
 		return;
 	}
@@ -636,34 +1366,81 @@ static void config_apply(struct main_state *state_object, const struct config_pa
 	    config->sample_interval != state_object->sample_interval_sec) {
 		LOG_DBG("Updating sample interval to %d seconds", config->sample_interval);
 		state_object->sample_interval_sec = config->sample_interval;
+#if defined(CONFIG_APP_MOTION)
+		state_object->location_interval_sec = config->sample_interval;
+#endif /* CONFIG_APP_MOTION */
+		interval_changed = true;
+		schedule_changed = true;
+	}
+
+	if (config->power_interval &&
+	    config->power_interval != state_object->source_interval_sec[SAMPLE_SOURCE_POWER]) {
+		LOG_DBG("Updating power interval to %d seconds", config->power_interval);
+		state_object->source_interval_sec[SAMPLE_SOURCE_POWER] = config->power_interval;
+		interval_changed = true;
+	}
+
+	if (config->environmental_interval &&
+	    config->environmental_interval !=
+	    state_object->source_interval_sec[SAMPLE_SOURCE_ENVIRONMENTAL]) {
+		LOG_DBG("Updating environmental interval to %d seconds",
+			config->environmental_interval);
+		state_object->source_interval_sec[SAMPLE_SOURCE_ENVIRONMENTAL] =
+			config->environmental_interval;
 		interval_changed = true;
 	}
 
 	if (config->storage_threshold_valid &&
 	    config->storage_threshold != state_object->storage_threshold) {
-		struct storage_msg storage_msg = {
-			.type = STORAGE_SET_THRESHOLD,
-			.data_len = config->storage_threshold,
-		};
-
 		LOG_DBG("Updating storage threshold to %d samples", config->storage_threshold);
 		state_object->storage_threshold = config->storage_threshold;
 
-		err = zbus_chan_pub(&storage_chan, &storage_msg, PUB_TIMEOUT);
-		if (err) {
-			LOG_ERR("Failed to publish storage threshold update, error: %d", err);
-			SEND_FATAL_ERROR();
+		storage_threshold_send(state_object);
+		schedule_changed = true;
+	}
 
-			return;
+#if defined(CONFIG_APP_ENVIRONMENTAL)
+	if (config->environmental_profile_valid &&
+	    config->environmental_profile != state_object->environmental_profile) {
+		LOG_DBG("Updating environmental profile to %d", config->environmental_profile);
+		state_object->environmental_profile = config->environmental_profile;
+
+		environmental_profile_send(state_object);
+	}
+#endif /* CONFIG_APP_ENVIRONMENTAL */
+
+#if defined(CONFIG_APP_GEOFENCE)
+	if ((config->location_report_valid &&
+	     config->location_report != state_object->location_report) ||
+	    (config->heartbeat_interval &&
+	     config->heartbeat_interval != state_object->heartbeat_interval)) {
+		if (config->location_report_valid) {
+			state_object->location_report = config->location_report;
+		}
+
+		if (config->heartbeat_interval) {
+			state_object->heartbeat_interval = config->heartbeat_interval;
 		}
+
+		LOG_DBG("Updating location report mode to %d, heartbeat interval %d seconds",
+			state_object->location_report, state_object->heartbeat_interval);
+
+		geofence_report_send(state_object);
+	}
+#endif /* CONFIG_APP_GEOFENCE */
+
+	if (schedule_changed) {
+		network_schedule_send(state_object);
 	}
 
 	/* Notify waiting states that configuration has changed and timers need restart */
 	if (interval_changed) {
 		const struct timer_msg timer_msg = { .type = TIMER_CONFIG_CHANGED };
 
-		/* Reset sample start time so re-entering waiting state uses full new interval */
-		state_object->sample_start_time = k_uptime_seconds();
+		/* Reset sample times so re-entering waiting state uses full new intervals */
+		for (enum sample_source source = 0; source < SAMPLE_SOURCE_COUNT; source++) {
+			state_object->source_sample_time[source] = k_uptime_seconds();
+		}
 
 		err = zbus_chan_pub(&timer_chan, &timer_msg, PUB_TIMEOUT);
 		if (err) {
@@ -675,6 +1452,72 @@ static void config_apply(struct main_state *state_object, const struct config_pa
 	}
 }
 
+#if defined(CONFIG_APP_POWER_POLICY)
+static enum power_profile power_profile_select(enum power_profile current, double percentage,
+					       bool charging)
+{
+	if (charging) {
+		return POWER_PROFILE_NORMAL;
+	}
+
+	/* A profile is only left when the state of charge is above its threshold by the
+	 * hysteresis.
+	 */
+	if ((percentage <= CONFIG_APP_POWER_POLICY_CRITICAL_SOC) ||
+	    ((current == POWER_PROFILE_CRITICAL) &&
+	     (percentage < (CONFIG_APP_POWER_POLICY_CRITICAL_SOC +
+			    CONFIG_APP_POWER_POLICY_HYSTERESIS)))) {
+		return POWER_PROFILE_CRITICAL;
+	}
+
+	if ((percentage <= CONFIG_APP_POWER_POLICY_LOW_SOC) ||
+	    ((current != POWER_PROFILE_NORMAL) &&
+	     (percentage < (CONFIG_APP_POWER_POLICY_LOW_SOC +
+			    CONFIG_APP_POWER_POLICY_HYSTERESIS)))) {
+		return POWER_PROFILE_LOW;
+	}
+
+	return POWER_PROFILE_NORMAL;
+}
+
+static void handle_battery_sample(struct main_state *state_object, const struct power_msg *msg)
+{
+	int err;
+	const struct timer_msg timer_msg = { .type = TIMER_CONFIG_CHANGED };
+	enum power_profile profile = power_profile_select(state_object->power_profile,
+							  msg->percentage, msg->charging);
+
+	if (profile == state_object->power_profile) {
+		return;
+	}
+
+	LOG_INF("Battery at %.1f%%%s, switching to the %s power profile", msg->percentage,
+		msg->charging ? " and charging" : "", power_profile_names[profile]);
+
+	state_object->power_profile = profile;
+
+	storage_threshold_send(state_object);
+
+	network_schedule_send(state_object);
+
+#if !defined(CONFIG_APP_FOTA_SCHEDULING)
+	/* A poll deferred by a low battery is sent when the normal profile is used again */
+	if (state_object->running_history == STATE_CONNECTED) {
+		fota_poll_deferred_send(state_object);
+	}
+#endif /* !CONFIG_APP_FOTA_SCHEDULING */
+
+	/* Restart the sample timer with the intervals of the new profile */
+	err = zbus_chan_pub(&timer_chan, &timer_msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish timer config changed event, error: %d", err);
+		SEND_FATAL_ERROR();
+
+		return;
+	}
+}
+#endif /* CONFIG_APP_POWER_POLICY */
+
 static void command_execute(uint32_t command_type)
 {
 	if (command_type == CLOUD_COMMAND_TYPE_PROVISION) {
@@ -695,6 +1538,190 @@ static void command_execute(uint32_t command_type)
 	}
 }
 
+/* Full current configuration, to be reported in the shadow */
+static void reported_config_full_get(const struct main_state *state_object,
+				     struct config_params *config)
+{
+	config->sample_interval = state_object->sample_interval_sec;
+	config->storage_threshold = state_object->storage_threshold;
+	config->storage_threshold_valid = true;
+
+	if (source_enabled(SAMPLE_SOURCE_POWER)) {
+		config->power_interval = source_interval_get(state_object, SAMPLE_SOURCE_POWER);
+	}
+
+	if (source_enabled(SAMPLE_SOURCE_ENVIRONMENTAL)) {
+		config->environmental_interval =
+			source_interval_get(state_object, SAMPLE_SOURCE_ENVIRONMENTAL);
+	}
+
+#if defined(CONFIG_APP_ENVIRONMENTAL)
+	config->environmental_profile = state_object->environmental_profile;
+	config->environmental_profile_valid = true;
+#endif /* CONFIG_APP_ENVIRONMENTAL */
+
+#if defined(CONFIG_APP_GEOFENCE)
+	config->location_report = state_object->location_report;
+	config->location_report_valid = true;
+	config->heartbeat_interval = state_object->heartbeat_interval;
+#endif /* CONFIG_APP_GEOFENCE */
+}
+
+#if defined(CONFIG_APP_CONFIG_PERSIST)
+#define SETTINGS_SUBTREE	"att_main"
+#define SETTINGS_KEY		"config"
+
+/* Configuration parameters set in the desired section of the shadow, others are left unset */
+static struct config_params saved_config;
+
+static int settings_load_cb(const char *key, size_t len, settings_read_cb read_cb,
+			    void *cb_arg, void *param)
+{
+	ssize_t ret;
+	bool *found = param;
+
+	if (!key || (strcmp(key, SETTINGS_KEY) != 0)) {
+		return 0;
+	}
+
+	/* The layout of struct config_params changed with a firmware update */
+	if (len != sizeof(saved_config)) {
+		LOG_WRN("Dropping saved configuration of unexpected size: %zu", len);
+
+		return 0;
+	}
+
+	ret = read_cb(cb_arg, &saved_config, len);
+	if (ret != (ssize_t)len) {
+		LOG_WRN("Failed to read saved configuration");
+
+		memset(&saved_config, 0, sizeof(saved_config));
+
+		return 0;
+	}
+
+	*found = true;
+
+	return 0;
+}
+
+/* Copy the parameters that are set in src to dst */
+static void config_merge(struct config_params *dst, const struct config_params *src)
+{
+	if (src->sample_interval) {
+		dst->sample_interval = src->sample_interval;
+	}
+
+	if (src->power_interval) {
+		dst->power_interval = src->power_interval;
+	}
+
+	if (src->environmental_interval) {
+		dst->environmental_interval = src->environmental_interval;
+	}
+
+	if (src->storage_threshold_valid) {
+		dst->storage_threshold = src->storage_threshold;
+		dst->storage_threshold_valid = true;
+	}
+
+	if (src->environmental_profile_valid) {
+		dst->environmental_profile = src->environmental_profile;
+		dst->environmental_profile_valid = true;
+	}
+
+	if (src->location_report_valid) {
+		dst->location_report = src->location_report;
+		dst->location_report_valid = true;
+	}
+
+	if (src->heartbeat_interval) {
+		dst->heartbeat_interval = src->heartbeat_interval;
+	}
+}
+
+static bool config_equal(const struct config_params *a, const struct config_params *b)
+{
+	return (a->sample_interval == b->sample_interval) &&
+	       (a->power_interval == b->power_interval) &&
+	       (a->environmental_interval == b->environmental_interval) &&
+	       (a->storage_threshold_valid == b->storage_threshold_valid) &&
+	       (a->storage_threshold == b->storage_threshold) &&
+	       (a->environmental_profile_valid == b->environmental_profile_valid) &&
+	       (a->environmental_profile == b->environmental_profile) &&
+	       (a->location_report_valid == b->location_report_valid) &&
+	       (a->location_report == b->location_report) &&
+	       (a->heartbeat_interval == b->heartbeat_interval);
+}
+
+/* Apply the configuration saved from the shadow before the last reset */
+static void config_restore(struct main_state *state_object)
+{
+	int err;
+	bool found = false;
+
+	err = settings_subsys_init();
+	if (err) {
+		LOG_WRN("settings_subsys_init, error: %d", err);
+
+		return;
+	}
+
+	err = settings_load_subtree_direct(SETTINGS_SUBTREE, settings_load_cb, &found);
+	if (err) {
+		LOG_WRN("settings_load_subtree_direct, error: %d", err);
+
+		return;
+	}
+
+	if (!found) {
+		LOG_DBG("No saved configuration, using the default configuration");
+
+		return;
+	}
+
+	LOG_INF("Applying the configuration saved from the shadow");
+
+	config_apply(state_object, &saved_config);
+
+	state_object->config_restored = true;
+}
+
+/* Save the configuration from a shadow response. A desired section replaces the saved
+ * configuration, a delta is merged into it. Flash is only written when a parameter changed.
+ */
+static void config_save(const struct config_params *config, bool replace)
+{
+	int err;
+	struct config_params updated = {0};
+	const struct config_params empty = {0};
+
+	if (!replace) {
+		updated = saved_config;
+	}
+
+	config_merge(&updated, config);
+
+	if (config_equal(&updated, &saved_config)) {
+		return;
+	}
+
+	saved_config = updated;
+
+	/* Without parameters from the shadow, the defaults are used after a reset */
+	if (config_equal(&saved_config, &empty)) {
+		err = settings_delete(SETTINGS_SUBTREE "/" SETTINGS_KEY);
+	} else {
+		err = settings_save_one(SETTINGS_SUBTREE "/" SETTINGS_KEY, &saved_config,
+					sizeof(saved_config));
+	}
+
+	if (err) {
+		LOG_WRN("Failed to save the configuration, error: %d", err);
+	}
+}
+#endif /* CONFIG_APP_CONFIG_PERSIST */
+
 static void handle_cloud_shadow_response(struct main_state *state_object,
 					 const struct cloud_msg *msg)
 {
@@ -723,12 +1750,37 @@ static void handle_cloud_shadow_response(struct main_state *state_object,
 
 		config_apply(state_object, &update_config);
 
+#if defined(CONFIG_APP_CONFIG_PERSIST)
+		config_save(&update_config, false);
+#endif /* CONFIG_APP_CONFIG_PERSIST */
+
+#if defined(CONFIG_APP_GEOFENCE)
+		geofence_zones_apply(msg);
+#endif /* CONFIG_APP_GEOFENCE */
+
 		reported_config.sample_interval =
 			(update_config.sample_interval) ? state_object->sample_interval_sec : 0;
 		reported_config.storage_threshold = (update_config.storage_threshold_valid)
 							    ? state_object->storage_threshold
 							    : 0;
 		reported_config.storage_threshold_valid = update_config.storage_threshold_valid;
+		reported_config.power_interval = (update_config.power_interval) ?
+			source_interval_get(state_object, SAMPLE_SOURCE_POWER) : 0;
+		reported_config.environmental_interval = (update_config.environmental_interval) ?
+			source_interval_get(state_object, SAMPLE_SOURCE_ENVIRONMENTAL) : 0;
+#if defined(CONFIG_APP_ENVIRONMENTAL)
+		reported_config.environmental_profile = (update_config.environmental_profile_valid) ?
+			state_object->environmental_profile : 0;
+		reported_config.environmental_profile_valid =
+			update_config.environmental_profile_valid;
+#endif /* CONFIG_APP_ENVIRONMENTAL */
+#if defined(CONFIG_APP_GEOFENCE)
+		reported_config.location_report = (update_config.location_report_valid) ?
+			state_object->location_report : 0;
+		reported_config.location_report_valid = update_config.location_report_valid;
+		reported_config.heartbeat_interval = (update_config.heartbeat_interval) ?
+			state_object->heartbeat_interval : 0;
+#endif /* CONFIG_APP_GEOFENCE */
 
 		update_shadow_reported_section(&reported_config, command_type, command_id,
 					       CLOUD_SHADOW_UPDATE_REPORTED_CONFIG);
@@ -755,9 +1807,15 @@ static void handle_cloud_shadow_response(struct main_state *state_object,
 
 		config_apply(state_object, &update_config);
 
-		reported_config.sample_interval = state_object->sample_interval_sec;
-		reported_config.storage_threshold = state_object->storage_threshold;
-		reported_config.storage_threshold_valid = true;
+#if defined(CONFIG_APP_CONFIG_PERSIST)
+		config_save(&update_config, true);
+#endif /* CONFIG_APP_CONFIG_PERSIST */
+
+#if defined(CONFIG_APP_GEOFENCE)
+		geofence_zones_apply(msg);
+#endif /* CONFIG_APP_GEOFENCE */
+
+		reported_config_full_get(state_object, &reported_config);
 
 		update_shadow_reported_section(&reported_config, 0, 0,
 					       CLOUD_SHADOW_SET_REPORTED_CONFIG);
@@ -772,9 +1830,11 @@ static void handle_cloud_shadow_response(struct main_state *state_object,
 	/* For EMPTY_DESIRED response, report the current configuration in the reported section. */
 	case CLOUD_SHADOW_RESPONSE_EMPTY_DESIRED:
 
-		reported_config.sample_interval = state_object->sample_interval_sec;
-		reported_config.storage_threshold = state_object->storage_threshold;
-		reported_config.storage_threshold_valid = true;
+#if defined(CONFIG_APP_CONFIG_PERSIST)
+		config_save(&update_config, true);
+#endif /* CONFIG_APP_CONFIG_PERSIST */
+
+		reported_config_full_get(state_object, &reported_config);
 
 		update_shadow_reported_section(&reported_config, 0, 0,
 					       CLOUD_SHADOW_SET_REPORTED_CONFIG);
@@ -787,6 +1847,47 @@ static void handle_cloud_shadow_response(struct main_state *state_object,
 	}
 }
 
+#if defined(CONFIG_APP_BOOT_TIMELINE)
+enum boot_event {
+	BOOT_EVENT_FOTA_READY,
+	BOOT_EVENT_POWER_READY,
+	BOOT_EVENT_LOCATION_READY,
+	BOOT_EVENT_RUNNING,
+	BOOT_EVENT_FIRST_LOCATION,
+	BOOT_EVENT_FIRST_UPLOAD,
+	BOOT_EVENT_COUNT,
+};
+
+static const char *const boot_event_names[] = {
+	[BOOT_EVENT_FOTA_READY] = "FOTA module ready",
+	[BOOT_EVENT_POWER_READY] = "power module ready",
+	[BOOT_EVENT_LOCATION_READY] = "location module ready",
+	[BOOT_EVENT_RUNNING] = "running",
+	[BOOT_EVENT_FIRST_LOCATION] = "first location search done",
+	[BOOT_EVENT_FIRST_UPLOAD] = "first upload done",
+};
+
+BUILD_ASSERT(ARRAY_SIZE(boot_event_names) == BOOT_EVENT_COUNT);
+
+/* Log the time since reset of the first occurrence of each boot event */
+static void boot_timeline_mark(enum boot_event event)
+{
+	static uint32_t marked;
+
+	if (marked & BIT(event)) {
+		return;
+	}
+
+	marked |= BIT(event);
+
+	LOG_INF("Boot timeline: %s at %lld ms", boot_event_names[event], k_uptime_get());
+}
+
+#define BOOT_TIMELINE_MARK(_event)	boot_timeline_mark(_event)
+#else
+#define BOOT_TIMELINE_MARK(_event)
+#endif /* CONFIG_APP_BOOT_TIMELINE */
+
 /* Check whether all modules that need time to initialize have reported ready.
  * If so, publish MAIN_MODULES_READY message to transition out of the waiting for modules state.
  */
@@ -795,11 +1896,16 @@ static void check_modules_ready(const struct main_state *state_object)
 	const struct priv_main_msg msg = { .type = MAIN_MODULES_READY };
 	int err;
 
+#if defined(CONFIG_APP_FAST_BOOT)
+	/* The FOTA and power modules finish their initialization in the background */
+	if (state_object->modules_ready.location_ready) {
+#else
 	if (state_object->modules_ready.fota_ready &&
 #if defined(CONFIG_APP_POWER)
 	    state_object->modules_ready.power_ready &&
 #endif /* CONFIG_APP_POWER */
 	    state_object->modules_ready.location_ready) {
+#endif /* CONFIG_APP_FAST_BOOT */
 		err = zbus_chan_pub(&priv_main_chan, &msg, PUB_TIMEOUT);
 		if (err) {
 			LOG_ERR("Failed to publish MAIN_MODULES_READY message, error: %d", err);
@@ -821,6 +1927,7 @@ static enum smf_state_result waiting_for_modules_init_run(void *o)
 		const struct fota_msg *msg = (const struct fota_msg *)state_object->msg_buf;
 
 		if (msg->type == FOTA_MODULE_READY) {
+			BOOT_TIMELINE_MARK(BOOT_EVENT_FOTA_READY);
 			state_object->modules_ready.fota_ready = true;
 			check_modules_ready(state_object);
 			return SMF_EVENT_HANDLED;
@@ -833,6 +1940,7 @@ static enum smf_state_result waiting_for_modules_init_run(void *o)
 		const struct power_msg *msg = (const struct power_msg *)state_object->msg_buf;
 
 		if (msg->type == POWER_MODULE_READY) {
+			BOOT_TIMELINE_MARK(BOOT_EVENT_POWER_READY);
 			state_object->modules_ready.power_ready = true;
 			check_modules_ready(state_object);
 			return SMF_EVENT_HANDLED;
@@ -842,6 +1950,7 @@ static enum smf_state_result waiting_for_modules_init_run(void *o)
 		const struct location_msg *msg = (const struct location_msg *)state_object->msg_buf;
 
 		if (msg->type == LOCATION_MODULE_READY) {
+			BOOT_TIMELINE_MARK(BOOT_EVENT_LOCATION_READY);
 			state_object->modules_ready.location_ready = true;
 			check_modules_ready(state_object);
 			return SMF_EVENT_HANDLED;
@@ -853,6 +1962,11 @@ static enum smf_state_result waiting_for_modules_init_run(void *o)
 			(const struct priv_main_msg *)state_object->msg_buf;
 
 		if (msg->type == MAIN_MODULES_READY) {
+			BOOT_TIMELINE_MARK(BOOT_EVENT_RUNNING);
+#if defined(CONFIG_APP_CONFIG_PERSIST)
+			config_restore(state_object);
+#endif /* CONFIG_APP_CONFIG_PERSIST */
+			network_schedule_send(state_object);
 			smf_set_state(SMF_CTX(state_object), &states[STATE_RUNNING]);
 			return SMF_EVENT_HANDLED;
 		}
@@ -880,7 +1994,32 @@ static enum smf_state_result running_run(void *o)
 
 			return SMF_EVENT_HANDLED;
 		}
+
+#if defined(CONFIG_APP_FAST_BOOT)
+		/* Polls requested before the module was ready were not sent */
+		if (msg->type == FOTA_MODULE_READY) {
+			BOOT_TIMELINE_MARK(BOOT_EVENT_FOTA_READY);
+			state_object->modules_ready.fota_ready = true;
+
+			if (state_object->running_history == STATE_CONNECTED) {
+				fota_poll_send(state_object);
+			}
+
+			return SMF_EVENT_HANDLED;
+		}
+#endif /* CONFIG_APP_FAST_BOOT */
+	}
+
+#if defined(CONFIG_APP_FAST_BOOT) && defined(CONFIG_APP_POWER)
+	else if ((state_object->chan == &power_chan) &&
+		 (((const struct power_msg *)state_object->msg_buf)->type ==
+		  POWER_MODULE_READY)) {
+		BOOT_TIMELINE_MARK(BOOT_EVENT_POWER_READY);
+		state_object->modules_ready.power_ready = true;
+
+		return SMF_EVENT_HANDLED;
 	}
+#endif /* CONFIG_APP_FAST_BOOT && CONFIG_APP_POWER */
 
 	/* Handle cloud provisioning completion */
 	else if (state_object->chan == &cloud_chan) {
@@ -897,6 +2036,30 @@ static enum smf_state_result running_run(void *o)
 		}
 	}
 
+#if defined(CONFIG_APP_MOTION)
+	else if (state_object->chan == &motion_chan) {
+		const struct motion_msg *msg = (const struct motion_msg *)state_object->msg_buf;
+
+		if (msg->type == MOTION_DETECTED) {
+			handle_motion_detected(state_object);
+
+			return SMF_EVENT_HANDLED;
+		}
+	}
+#endif /* CONFIG_APP_MOTION */
+
+#if defined(CONFIG_APP_POWER_POLICY)
+	else if (state_object->chan == &power_chan) {
+		const struct power_msg *msg = (const struct power_msg *)state_object->msg_buf;
+
+		if (msg->type == POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE) {
+			handle_battery_sample(state_object, msg);
+
+			return SMF_EVENT_HANDLED;
+		}
+	}
+#endif /* CONFIG_APP_POWER_POLICY */
+
 	return SMF_EVENT_PROPAGATE;
 }
 
@@ -960,7 +2123,6 @@ static void connected_entry(void *o)
 	if (!state_object->cloud_synced_on_connect) {
 
 		int err;
-		struct fota_msg fota_msg = { .type = FOTA_POLL_REQUEST };
 		struct cloud_msg cloud_msg = {
 			.type = CLOUD_SHADOW_UPDATE_REPORTED_DEVICE
 		};
@@ -973,14 +2135,35 @@ static void connected_entry(void *o)
 			return;
 		}
 
-		err = zbus_chan_pub(&fota_chan, &fota_msg, PUB_TIMEOUT);
-		if (err) {
-			LOG_ERR("Failed to trigger FOTA polling on cloud connection: %d", err);
-		}
+		fota_poll_send(state_object);
 
+#if defined(CONFIG_APP_CONFIG_PERSIST) && !defined(CONFIG_APP_GEOFENCE)
+		/* The reported section matches the saved configuration, so the delta only
+		 * holds what changed in the desired section while the device was offline.
+		 */
+		if (state_object->config_restored) {
+			poll_shadow_send(CLOUD_SHADOW_GET_DELTA);
+		} else {
+			poll_shadow_send(CLOUD_SHADOW_GET_DESIRED);
+		}
+#else
 		poll_shadow_send(CLOUD_SHADOW_GET_DESIRED);
+#endif /* CONFIG_APP_CONFIG_PERSIST && !CONFIG_APP_GEOFENCE */
 		state_object->cloud_synced_on_connect = true;
+		state_object->fota_resume_pending = false;
+	} else if (state_object->fota_resume_pending) {
+		LOG_DBG("Polling FOTA to resume the interrupted download");
+
+		fota_poll_send(state_object);
+
+		state_object->fota_resume_pending = false;
+	}
+#if !defined(CONFIG_APP_FOTA_SCHEDULING)
+	else {
+		/* A poll deferred while disconnected is sent now if it is allowed */
+		fota_poll_deferred_send(state_object);
 	}
+#endif /* !CONFIG_APP_FOTA_SCHEDULING */
 }
 
 static enum smf_state_result connected_run(void *o)
@@ -1029,22 +2212,57 @@ static enum smf_state_result connected_run(void *o)
 		const struct storage_msg *msg = (const struct storage_msg *)state_object->msg_buf;
 
 		if (msg->type == STORAGE_THRESHOLD_REACHED) {
+#if defined(CONFIG_APP_UPLOAD_SCHEDULING)
+			if (!upload_threshold_check(state_object, msg)) {
+				return SMF_EVENT_HANDLED;
+			}
+#endif /* CONFIG_APP_UPLOAD_SCHEDULING */
+
 			smf_set_state(SMF_CTX(state_object), &states[STATE_CONNECTED_SENDING]);
 
 			return SMF_EVENT_HANDLED;
 		}
 	}
 
+#if defined(CONFIG_APP_FOTA_SCHEDULING) || defined(CONFIG_APP_UPLOAD_SCHEDULING)
+	/* Link quality requested by fota_poll_deferred_check() or the upload scheduling */
+	else if (state_object->chan == &network_chan) {
+		const struct network_msg *msg = (const struct network_msg *)state_object->msg_buf;
+
+		if (msg->type == NETWORK_QUALITY_SAMPLE_RESPONSE) {
+#if defined(CONFIG_APP_UPLOAD_SCHEDULING)
+			(void)k_work_cancel_delayable(&upload_eval_timeout_work);
+#endif /* CONFIG_APP_UPLOAD_SCHEDULING */
+
+#if defined(CONFIG_APP_FOTA_SCHEDULING)
+			fota_poll_rsrp_check(state_object, msg->conn_eval_params.rsrp);
+#endif /* CONFIG_APP_FOTA_SCHEDULING */
+
+			return SMF_EVENT_HANDLED;
+		}
+	}
+#endif /* CONFIG_APP_FOTA_SCHEDULING || CONFIG_APP_UPLOAD_SCHEDULING */
+
 	return SMF_EVENT_PROPAGATE;
 }
 
 /* STATE_DISCONNECTED_SAMPLING */
 
+/* Shared by the sampling states of the disconnected and connected states */
+static void sampling_exit(void *o)
+{
+	ARG_UNUSED(o);
+
+	LOG_DBG("%s", __func__);
+	etb_profiler_stop(ETB_PROFILER_SCENARIO_SAMPLING);
+}
+
 static void disconnected_sampling_entry(void *o)
 {
 	struct main_state *state_object = (struct main_state *)o;
 
 	LOG_DBG("%s", __func__);
+	etb_profiler_start(ETB_PROFILER_SCENARIO_SAMPLING);
 	trigger_sampling(state_object);
 }
 
@@ -1056,6 +2274,7 @@ static enum smf_state_result disconnected_sampling_run(void *o)
 		const struct location_msg *msg = (const struct location_msg *)state_object->msg_buf;
 
 		if (msg->type == LOCATION_SEARCH_DONE) {
+			BOOT_TIMELINE_MARK(BOOT_EVENT_FIRST_LOCATION);
 			smf_set_state(SMF_CTX(state_object), &states[STATE_DISCONNECTED_WAITING]);
 
 			return SMF_EVENT_HANDLED;
@@ -1105,8 +2324,8 @@ static enum smf_state_result disconnected_waiting_run(void *o)
 		const struct timer_msg *msg = (const struct timer_msg *)state_object->msg_buf;
 
 		if (msg->type == TIMER_EXPIRED_SAMPLE_DATA) {
-			smf_set_state(SMF_CTX(state_object),
-				      &states[STATE_DISCONNECTED_SAMPLING]);
+			sample_timer_expired(state_object, STATE_DISCONNECTED_SAMPLING,
+					     STATE_DISCONNECTED_WAITING);
 
 			return SMF_EVENT_HANDLED;
 		}
@@ -1125,6 +2344,7 @@ static enum smf_state_result disconnected_waiting_run(void *o)
 		const struct button_msg *msg = (const struct button_msg *)state_object->msg_buf;
 
 		if (msg->type == BUTTON_PRESS_SHORT) {
+			state_object->sources_to_sample = SAMPLE_SOURCES_ALL;
 			smf_set_state(SMF_CTX(state_object),
 				      &states[STATE_DISCONNECTED_SAMPLING]);
 
@@ -1151,6 +2371,7 @@ static void connected_sampling_entry(void *o)
 	struct main_state *state_object = (struct main_state *)o;
 
 	LOG_DBG("%s", __func__);
+	etb_profiler_start(ETB_PROFILER_SCENARIO_SAMPLING);
 	trigger_sampling(state_object);
 }
 
@@ -1162,6 +2383,7 @@ static enum smf_state_result connected_sampling_run(void *o)
 		const struct location_msg *msg = (const struct location_msg *)state_object->msg_buf;
 
 		if (msg->type == LOCATION_SEARCH_DONE) {
+			BOOT_TIMELINE_MARK(BOOT_EVENT_FIRST_LOCATION);
 			smf_set_state(SMF_CTX(state_object), &states[STATE_CONNECTED_WAITING]);
 			return SMF_EVENT_HANDLED;
 		}
@@ -1186,6 +2408,14 @@ static void connected_waiting_entry(void *o)
 
 	LOG_DBG("%s", __func__);
 	waiting_entry_common(state_object);
+
+#if defined(CONFIG_APP_FOTA_SCHEDULING)
+	fota_poll_deferred_check(state_object);
+#endif /* CONFIG_APP_FOTA_SCHEDULING */
+
+#if defined(CONFIG_APP_UPLOAD_SCHEDULING)
+	upload_deferred_check(state_object);
+#endif /* CONFIG_APP_UPLOAD_SCHEDULING */
 }
 
 static enum smf_state_result connected_waiting_run(void *o)
@@ -1196,8 +2426,8 @@ static enum smf_state_result connected_waiting_run(void *o)
 		const struct timer_msg *msg = (const struct timer_msg *)state_object->msg_buf;
 
 		if (msg->type == TIMER_EXPIRED_SAMPLE_DATA) {
-			smf_set_state(SMF_CTX(state_object),
-				      &states[STATE_CONNECTED_SAMPLING]);
+			sample_timer_expired(state_object, STATE_CONNECTED_SAMPLING,
+					     STATE_CONNECTED_WAITING);
 
 			return SMF_EVENT_HANDLED;
 		}
@@ -1216,6 +2446,7 @@ static enum smf_state_result connected_waiting_run(void *o)
 		const struct button_msg *msg = (const struct button_msg *)state_object->msg_buf;
 
 		if (msg->type == BUTTON_PRESS_SHORT) {
+			state_object->sources_to_sample = SAMPLE_SOURCES_ALL;
 			smf_set_state(SMF_CTX(state_object),
 				      &states[STATE_CONNECTED_SAMPLING]);
 
@@ -1224,6 +2455,34 @@ static enum smf_state_result connected_waiting_run(void *o)
 	}
 #endif /* CONFIG_APP_BUTTON */
 
+#if defined(CONFIG_APP_UPLOAD_SCHEDULING)
+	/* Deferred uploads are only sent from here, so that sampling and sending are not
+	 * interrupted. The connection evaluation is also handled by the parent state.
+	 */
+	else if (state_object->chan == &network_chan) {
+		const struct network_msg *msg = (const struct network_msg *)state_object->msg_buf;
+
+		if (msg->type == NETWORK_QUALITY_SAMPLE_RESPONSE) {
+			if (upload_energy_check(state_object, &msg->conn_eval_params)) {
+				smf_set_state(SMF_CTX(state_object),
+					      &states[STATE_CONNECTED_SENDING]);
+
+				return SMF_EVENT_HANDLED;
+			}
+		}
+	} else if (state_object->chan == &priv_main_chan) {
+		const struct priv_main_msg *msg =
+			(const struct priv_main_msg *)state_object->msg_buf;
+
+		if ((msg->type == MAIN_UPLOAD_EVAL_TIMEOUT) &&
+		    upload_eval_timeout_check(state_object)) {
+			smf_set_state(SMF_CTX(state_object), &states[STATE_CONNECTED_SENDING]);
+
+			return SMF_EVENT_HANDLED;
+		}
+	}
+#endif /* CONFIG_APP_UPLOAD_SCHEDULING */
+
 	return SMF_EVENT_PROPAGATE;
 }
 
@@ -1241,6 +2500,14 @@ static void connected_sending_entry(void *o)
 
 	LOG_DBG("%s", __func__);
 
+#if defined(CONFIG_APP_UPLOAD_SCHEDULING)
+	/* The data of a deferred upload is sent with this one */
+	state_object->upload_deferred = false;
+	(void)k_work_cancel_delayable(&upload_eval_timeout_work);
+#endif /* CONFIG_APP_UPLOAD_SCHEDULING */
+
+	etb_profiler_start(ETB_PROFILER_SCENARIO_BATCH_FLUSH);
+
 	/* Send data immediately when entering this state */
 	cloud_send_now(state_object);
 }
@@ -1259,6 +2526,12 @@ static enum smf_state_result connected_sending_run(void *o)
 
 		/* Storage batch closed indicates sending is done, go back to waiting */
 		if (msg->type == STORAGE_BATCH_CLOSE) {
+			BOOT_TIMELINE_MARK(BOOT_EVENT_FIRST_UPLOAD);
+
+#if defined(CONFIG_APP_CLOUD_MEMFAULT_UPLOAD)
+			memfault_upload_send();
+#endif /* CONFIG_APP_CLOUD_MEMFAULT_UPLOAD */
+
 			smf_set_state(SMF_CTX(state_object),
 				      &states[STATE_CONNECTED_WAITING]);
 
@@ -1269,6 +2542,14 @@ static enum smf_state_result connected_sending_run(void *o)
 	return SMF_EVENT_PROPAGATE;
 }
 
+static void connected_sending_exit(void *o)
+{
+	ARG_UNUSED(o);
+
+	LOG_DBG("%s", __func__);
+	etb_profiler_stop(ETB_PROFILER_SCENARIO_BATCH_FLUSH);
+}
+
 /* STATE_FOTA */
 
 static void fota_entry(void *o)
@@ -1276,6 +2557,7 @@ static void fota_entry(void *o)
 	ARG_UNUSED(o);
 
 	LOG_DBG("%s", __func__);
+	etb_profiler_start(ETB_PROFILER_SCENARIO_FOTA);
 
 #if defined(CONFIG_APP_LED)
 	int err;
@@ -1335,6 +2617,12 @@ static enum smf_state_result fota_run(void *o)
 			smf_set_state(SMF_CTX(state_object),
 				      &states[state_object->running_history]);
 
+			return SMF_EVENT_HANDLED;
+		case FOTA_DOWNLOAD_INTERRUPTED:
+			state_object->fota_resume_pending = true;
+			smf_set_state(SMF_CTX(state_object),
+				      &states[state_object->running_history]);
+
 			return SMF_EVENT_HANDLED;
 		default:
 			/* FOTA_STARTING is informational; main is already in STATE_FOTA. */
@@ -1380,6 +2668,14 @@ static enum smf_state_result fota_run(void *o)
 	return SMF_EVENT_PROPAGATE;
 }
 
+static void fota_exit(void *o)
+{
+	ARG_UNUSED(o);
+
+	LOG_DBG("%s", __func__);
+	etb_profiler_stop(ETB_PROFILER_SCENARIO_FOTA);
+}
+
 /* STATE_REBOOTING */
 
 static void rebooting_entry(void *o)
@@ -1407,7 +2703,24 @@ int main(void)
 	static struct main_state main_state;
 
 	main_state.sample_interval_sec = CONFIG_APP_SAMPLING_INTERVAL_SECONDS;
+	main_state.source_interval_sec[SAMPLE_SOURCE_POWER] =
+		CONFIG_APP_SAMPLING_POWER_INTERVAL_SECONDS;
+	main_state.source_interval_sec[SAMPLE_SOURCE_ENVIRONMENTAL] =
+		CONFIG_APP_SAMPLING_ENVIRONMENTAL_INTERVAL_SECONDS;
 	main_state.storage_threshold = CONFIG_APP_STORAGE_INITIAL_THRESHOLD;
+#if defined(CONFIG_APP_ENVIRONMENTAL)
+	main_state.environmental_profile = IS_ENABLED(CONFIG_APP_ENVIRONMENTAL_PROFILE_LOW_POWER) ?
+					   ENVIRONMENTAL_PROFILE_LOW_POWER :
+					   ENVIRONMENTAL_PROFILE_FULL;
+#endif /* CONFIG_APP_ENVIRONMENTAL */
+#if defined(CONFIG_APP_GEOFENCE)
+	main_state.location_report = IS_ENABLED(CONFIG_APP_GEOFENCE_REPORT_EVENTS) ?
+				     GEOFENCE_REPORT_EVENTS : GEOFENCE_REPORT_ALL;
+	main_state.heartbeat_interval = CONFIG_APP_GEOFENCE_HEARTBEAT_INTERVAL_SECONDS;
+#endif /* CONFIG_APP_GEOFENCE */
+#if defined(CONFIG_APP_MOTION)
+	main_state.location_interval_sec = CONFIG_APP_SAMPLING_INTERVAL_SECONDS;
+#endif /* CONFIG_APP_MOTION */
 	main_state.first_sample_pending = true;
 
 	LOG_DBG("Main has started");
@@ -1421,6 +2734,7 @@ int main(void)
 	}
 
 	smf_set_initial(SMF_CTX(&main_state), &states[STATE_WAITING_FOR_MODULES_INIT]);
+	STATE_STATS_UPDATE(main, SMF_CTX(&main_state));
 
 	while (1) {
 		err = task_wdt_feed(task_wdt_id);
@@ -1442,12 +2756,18 @@ int main(void)
 			return err;
 		}
 
+		zbus_stats_received(&main_subscriber, main_state.chan);
+
+		HANDLER_STATS_START(main, main_state.chan);
 		err = smf_run_state(SMF_CTX(&main_state));
+		HANDLER_STATS_END(main);
 		if (err) {
 			LOG_ERR("smf_run_state(), error: %d", err);
 			SEND_FATAL_ERROR();
 
 			return err;
 		}
+
+		STATE_STATS_UPDATE(main, SMF_CTX(&main_state));
 	}
 }
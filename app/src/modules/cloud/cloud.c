@@ -15,6 +15,9 @@
 #include <zephyr/net/coap.h>
 #include <app_version.h>
 #include <date_time.h>
+#if defined(CONFIG_APP_CLOUD_BACKOFF_JITTER)
+#include <zephyr/random/random.h>
+#endif /* CONFIG_APP_CLOUD_BACKOFF_JITTER */
 
 #if defined(CONFIG_MEMFAULT)
 #include <memfault/ports/zephyr/http.h>
@@ -23,11 +26,27 @@
 #endif /* CONFIG_MEMFAULT */
 
 #include "app_common.h"
+#include "state_stats.h"
+#include "zbus_stats.h"
+#include "handler_stats.h"
 #include "cloud.h"
 #include "cloud_internal.h"
 #include "cloud_configuration.h"
 #include "cloud_provisioning.h"
 #include "cloud_location.h"
+#include "cloud_policy.h"
+#include "cloud_dedup.h"
+#include "cloud_network_info.h"
+#include "cloud_session.h"
+#include "cloud_stats.h"
+#include "cloud_priority.h"
+#include "cloud_memfault.h"
+#include "cloud_backoff.h"
+#include "cloud_transport.h"
+#include "modem_trace_ring.h"
+#if defined(CONFIG_APP_CLOUD_BATCH_UPLOAD)
+#include "cloud_batch.h"
+#endif /* CONFIG_APP_CLOUD_BATCH_UPLOAD */
 #ifdef CONFIG_APP_ENVIRONMENTAL
 #include "cloud_environmental.h"
 #endif /* CONFIG_APP_ENVIRONMENTAL */
@@ -39,7 +58,6 @@
 LOG_MODULE_REGISTER(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
 
 #define CUSTOM_JSON_APPID_VAL_BATTERY "BATTERY"
-#define AGNSS_MAX_DATA_SIZE 3800
 
 /* Prevent nRF Provisioning Shell from being used to trigger provisioning.
  * The cloud state machine does not support out of order provisioning via nRF Provisioning shell.
@@ -62,7 +80,7 @@ ZBUS_MSG_SUBSCRIBER_DEFINE(cloud_subscriber);
 	X(cloud_chan,		struct cloud_msg)		\
 	X(storage_chan,		struct storage_msg)		\
 	X(location_chan,	struct location_msg)		\
-	X(storage_data_chan,	struct storage_msg)
+	X(storage_data_chan,	struct storage_data_msg)
 
 /* Calculate the maximum message size from the list of channels */
 #define MAX_MSG_SIZE			MAX_MSG_SIZE_FROM_LIST(CHANNEL_LIST)
@@ -76,6 +94,13 @@ ZBUS_MSG_SUBSCRIBER_DEFINE(cloud_subscriber);
  */
 CHANNEL_LIST(ADD_OBSERVERS)
 
+#if defined(CONFIG_APP_CLOUD_PRIORITY_LANE)
+/* Priority events are queued by cloud_priority_listener, the subscriber only wakes up the
+ * thread when it is idle. Added after the listener so that the event is queued first.
+ */
+ZBUS_CHAN_ADD_OBS(cloud_priority_chan, cloud_subscriber, 1);
+#endif /* CONFIG_APP_CLOUD_PRIORITY_LANE */
+
 ZBUS_CHAN_DEFINE(cloud_chan,
 		 struct cloud_msg,
 		 NULL,
@@ -84,6 +109,9 @@ ZBUS_CHAN_DEFINE(cloud_chan,
 		 ZBUS_MSG_INIT(0)
 );
 
+ZBUS_STATS_CHAN_DEFINE(cloud_chan);
+ZBUS_STATS_METRIC_DEFINE(cloud_chan, cloud_chan);
+
 /* Create private cloud channel for internal messaging that is not intended for external use.
  * The channel is needed to communicate from asynchronous callbacks to the state machine and
  * ensure state transitions only happen from the cloud  module thread where the state machine
@@ -101,6 +129,12 @@ ZBUS_CHAN_DEFINE(priv_cloud_chan,
 static void backoff_timer_work_fn(struct k_work *work);
 static K_WORK_DELAYABLE_DEFINE(backoff_timer_work, backoff_timer_work_fn);
 
+#if defined(CONFIG_APP_CLOUD_TXN_WINDOW)
+/* Transaction window timer is run as a delayable work on the system workqueue */
+static void txn_window_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(txn_window_work, txn_window_work_fn);
+#endif /* CONFIG_APP_CLOUD_TXN_WINDOW */
+
 /* State machine */
 
 /* Cloud module states */
@@ -157,7 +191,20 @@ struct cloud_state_object {
 	/* Connection backoff time */
 	uint32_t backoff_time;
 
+	/* The last connection attempt was rejected by the server */
+	bool server_rejected;
+
+#if defined(CONFIG_APP_CLOUD_TXN_WINDOW)
+	/* Work collected in the current transaction window */
+	struct {
+		bool shadow_desired;
+		bool shadow_delta;
+		bool batch;
 
+		/* STORAGE_BATCH_AVAILABLE message of the pending batch session */
+		struct storage_msg batch_msg;
+	} txn;
+#endif /* CONFIG_APP_CLOUD_TXN_WINDOW */
 };
 
 /* Forward declarations of state handlers */
@@ -178,6 +225,7 @@ static void state_connected_entry(void *obj);
 static void state_connected_exit(void *obj);
 static void state_connected_ready_entry(void *obj);
 static enum smf_state_result state_connected_ready_run(void *obj);
+static void state_connected_ready_exit(void *obj);
 static void state_connected_paused_entry(void *obj);
 static enum smf_state_result state_connected_paused_run(void *obj);
 
@@ -228,7 +276,8 @@ static const struct smf_state states[] = {
 				 &states[STATE_CONNECTED_READY]),
 
 	[STATE_CONNECTED_READY] =
-		SMF_CREATE_STATE(state_connected_ready_entry, state_connected_ready_run, NULL,
+		SMF_CREATE_STATE(state_connected_ready_entry, state_connected_ready_run,
+				 state_connected_ready_exit,
 				 &states[STATE_CONNECTED],
 				 NULL),
 
@@ -238,6 +287,12 @@ static const struct smf_state states[] = {
 				 NULL),
 };
 
+STATE_STATS_DEFINE(cloud, states);
+STATE_STATS_METRIC_DEFINE(cloud, STATE_CONNECTING_ATTEMPT, cloud_connecting);
+STATE_STATS_METRIC_DEFINE(cloud, STATE_CONNECTING_BACKOFF, cloud_backoff);
+HANDLER_STATS_DEFINE(cloud, CONFIG_APP_CLOUD_MSG_PROCESSING_TIMEOUT_SECONDS);
+HANDLER_STATS_METRIC_DEFINE(cloud);
+
 static void cloud_wdt_callback(int channel_id, void *user_data)
 {
 	LOG_ERR("Watchdog expired, Channel: %d, Thread: %s",
@@ -264,22 +319,44 @@ static void connect_to_cloud(const struct cloud_state_object *state_object)
 		return;
 	}
 
-	err = nrf_cloud_coap_connect(APP_VERSION_STRING);
+	err = cloud_session_connect();
 	if (err == 0) {
 		LOG_INF("nRF Cloud CoAP connection successful");
 
+		cloud_provisioning_marker_save();
+
 		msg.type = CLOUD_CONNECTION_SUCCESS;
+	} else if ((err == -ENOEXEC || err == -ECONNREFUSED) && cloud_provisioning_marker_valid()) {
+		LOG_WRN("nrf_cloud_coap_connect, error: %d", err);
+		LOG_WRN("nRF Cloud CoAP connection failed with credentials that worked before");
+
+		/* Retried once before the credentials are considered invalid */
+		cloud_provisioning_marker_clear();
+
+		msg.type = CLOUD_CONNECTION_FAILED;
 	} else if (err == -EACCES || err == -ENOEXEC || err == -ECONNREFUSED) {
 		LOG_WRN("nrf_cloud_coap_connect, error: %d", err);
 		LOG_WRN("nRF Cloud CoAP connection failed, unauthorized or invalid credentials");
 
+		cloud_provisioning_marker_clear();
+
 		msg.type = CLOUD_NOT_AUTHENTICATED;
+	} else if (err == -ECONNRESET || err == -ECONNABORTED || err == -EBUSY ||
+		   err == -EPROTO || err == -EBADMSG) {
+		LOG_WRN("nrf_cloud_coap_connect, error: %d", err);
+		LOG_WRN("nRF Cloud CoAP connection rejected by the server");
+
+		msg.type = CLOUD_CONNECTION_REJECTED;
 	} else {
 		LOG_WRN("nRF Cloud CoAP connection refused");
 
 		msg.type = CLOUD_CONNECTION_FAILED;
 	}
 
+	if (msg.type != CLOUD_CONNECTION_SUCCESS) {
+		modem_trace_ring_trigger(MODEM_TRACE_RING_TRIGGER_CLOUD_CONNECT);
+	}
+
 	err = zbus_chan_pub(&priv_cloud_chan, &msg, PUB_TIMEOUT);
 	if (err) {
 		LOG_ERR("zbus_chan_pub, error: %d", err);
@@ -287,20 +364,32 @@ static void connect_to_cloud(const struct cloud_state_object *state_object)
 	}
 }
 
-static uint32_t calculate_backoff_time(uint32_t attempts)
+/* The backoff time is multiplied by CONFIG_APP_CLOUD_BACKOFF_SERVER_REJECT_FACTOR after a
+ * server-side rejection, so that an overloaded server is given more time than a lost link.
+ * With CONFIG_APP_CLOUD_BACKOFF_JITTER, the result is drawn uniformly between one second and
+ * the calculated value, so that devices that lost the network together do not reconnect
+ * in lockstep.
+ */
+static uint32_t calculate_backoff_time(uint32_t attempts, bool server_rejected)
 {
-	uint32_t backoff_time = CONFIG_APP_CLOUD_BACKOFF_INITIAL_SECONDS;
+	static const struct cloud_backoff_config backoff_config = {
+		.type = IS_ENABLED(CONFIG_APP_CLOUD_BACKOFF_TYPE_EXPONENTIAL) ?
+				CLOUD_BACKOFF_EXPONENTIAL :
+			IS_ENABLED(CONFIG_APP_CLOUD_BACKOFF_TYPE_LINEAR) ?
+				CLOUD_BACKOFF_LINEAR : CLOUD_BACKOFF_NONE,
+		.initial_seconds = CONFIG_APP_CLOUD_BACKOFF_INITIAL_SECONDS,
+		.linear_increment_seconds = CONFIG_APP_CLOUD_BACKOFF_LINEAR_INCREMENT_SECONDS,
+		.max_seconds = CONFIG_APP_CLOUD_BACKOFF_MAX_SECONDS,
+		.server_reject_factor = CONFIG_APP_CLOUD_BACKOFF_SERVER_REJECT_FACTOR,
+	};
+	uint32_t backoff_time = cloud_backoff_get(&backoff_config, attempts, server_rejected);
 
-	/* Calculate backoff time */
-	if (IS_ENABLED(CONFIG_APP_CLOUD_BACKOFF_TYPE_EXPONENTIAL)) {
-		backoff_time = CONFIG_APP_CLOUD_BACKOFF_INITIAL_SECONDS << (attempts - 1);
-	} else if (IS_ENABLED(CONFIG_APP_CLOUD_BACKOFF_TYPE_LINEAR)) {
-		backoff_time = CONFIG_APP_CLOUD_BACKOFF_INITIAL_SECONDS +
-			((attempts - 1) * CONFIG_APP_CLOUD_BACKOFF_LINEAR_INCREMENT_SECONDS);
+#if defined(CONFIG_APP_CLOUD_BACKOFF_JITTER)
+	/* A maximum of 0 seconds leaves nothing to draw from */
+	if (backoff_time > 0) {
+		backoff_time = 1 + (sys_rand32_get() % backoff_time);
 	}
-
-	__ASSERT(backoff_time <= CONFIG_APP_CLOUD_BACKOFF_MAX_SECONDS,
-		 "Backoff time exceeds maximum configured backoff time");
+#endif /* CONFIG_APP_CLOUD_BACKOFF_JITTER */
 
 	LOG_DBG("Backoff time: %u seconds", backoff_time);
 
@@ -321,6 +410,22 @@ static void backoff_timer_work_fn(struct k_work *work)
 	}
 }
 
+#if defined(CONFIG_APP_CLOUD_TXN_WINDOW)
+static void txn_window_work_fn(struct k_work *work)
+{
+	int err;
+	const struct priv_cloud_msg msg = { .type = CLOUD_TXN_WINDOW_EXPIRED };
+
+	ARG_UNUSED(work);
+
+	err = zbus_chan_pub(&priv_cloud_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+#endif /* CONFIG_APP_CLOUD_TXN_WINDOW */
+
 static void send_request_failed(void)
 {
 	int err;
@@ -349,21 +454,79 @@ static void send_provisioned_msg(void)
 	}
 }
 
+/* Offset from uptime to unix time in this boot. It is looked up from date_time once and reused
+ * for all items of a storage batch session, or for one real-time item, then invalidated so that
+ * time updates from date_time are picked up by the next session.
+ */
+static struct {
+	int64_t offset_ms;
+	bool valid;
+} uptime_offset;
+
+/**
+ * @brief Get the offset from uptime to unix time in milliseconds.
+ *
+ * @param offset_ms Offset to add to an uptime to get unix time.
+ * @return int 0 on success,
+ *             -ENODATA if date time is not valid,
+ *             other negative error code if the conversion failed.
+ */
+static int uptime_offset_get(int64_t *offset_ms)
+{
+	int err;
+	int64_t uptime_ms;
+	int64_t unix_time_ms;
+
+	if (uptime_offset.valid) {
+		*offset_ms = uptime_offset.offset_ms;
+
+		return 0;
+	}
+
+	if (!date_time_is_valid()) {
+		/* Cannot convert without valid time */
+		return -ENODATA;
+	}
+
+	uptime_ms = k_uptime_get();
+	unix_time_ms = uptime_ms;
+
+	err = date_time_uptime_to_unix_time_ms(&unix_time_ms);
+	if (err) {
+		return err;
+	}
+
+	uptime_offset.offset_ms = unix_time_ms - uptime_ms;
+	uptime_offset.valid = true;
+
+	*offset_ms = uptime_offset.offset_ms;
+
+	return 0;
+}
+
+/* Look up the offset again for the next items */
+static void uptime_offset_invalidate(void)
+{
+	uptime_offset.valid = false;
+}
+
 /**
  * @brief Attempt to set the provided uptime (in milliseconds) to unix time.
  *
  * Tries to convert the provided timestamp from uptime to unix time in milliseconds, if needed.
- * If it can't convert it will stay unchanged.
+ * If it can't convert it will stay unchanged. The conversion uses the offset from
+ * uptime_offset_get(), so date_time is only queried for the first item of a session.
  *
  * @param uptime_ms Uptime to convert to unix time.
  * @return int 0 if conversion was successful,
- *             -EINVAL if the provided pointer is NULL,
+ *             -EINVAL if the provided pointer is NULL, or the uptime is in the future,
  *             -EALREADY if the provided time was already in unix time (>= 2026-01-01),
  *             -ENODATA if date time is not valid,
  */
 static inline int attempt_timestamp_to_unix_ms(int64_t *uptime_ms)
 {
 	int err;
+	int64_t offset_ms;
 
 	if (uptime_ms == NULL) {
 		return -EINVAL;
@@ -375,20 +538,17 @@ static inline int attempt_timestamp_to_unix_ms(int64_t *uptime_ms)
 	}
 
 	if (*uptime_ms > k_uptime_get()) {
-		/* Uptime cannot be in the future */
+		/* Uptime cannot be in the future, the sample is from an earlier boot */
 		return -EINVAL;
 	}
 
-	if (!date_time_is_valid()) {
-		/* Cannot convert without valid time */
-		return -ENODATA;
-	}
-
-	err = date_time_uptime_to_unix_time_ms(uptime_ms);
+	err = uptime_offset_get(&offset_ms);
 	if (err) {
 		return err;
 	}
 
+	*uptime_ms += offset_ms;
+
 	return 0;
 }
 
@@ -430,192 +590,392 @@ static int handle_data_timestamp(int64_t *timestamp_ms)
 }
 #endif /* CONFIG_APP_POWER || CONFIG_APP_ENVIRONMENTAL */
 
-/* Storage handling functions */
+#if defined(CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE)
+/* Ask the network module for a new link quality sample for the send policy */
+static void request_network_quality_sample(void)
+{
+	int err;
+	struct network_msg msg = {
+		.type = NETWORK_QUALITY_SAMPLE_REQUEST,
+	};
 
-static int send_storage_data_to_cloud(const struct storage_data_item *item)
+	err = zbus_chan_pub(&network_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+#endif /* CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE */
+
+/* Let the network module release the RRC connection after the last uplink of a batch */
+static void transaction_done_send(void)
 {
 	int err;
-	int64_t timestamp_ms = NRF_CLOUD_NO_TIMESTAMP;
-	const bool confirmable = IS_ENABLED(CONFIG_APP_CLOUD_CONFIRMABLE_MESSAGES);
+	struct network_msg msg = {
+		.type = NETWORK_TRANSACTION_DONE,
+	};
+
+	if (!IS_ENABLED(CONFIG_APP_NETWORK_RAI)) {
+		return;
+	}
+
+	err = zbus_chan_pub(&network_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+/* Storage handling functions.
+ *
+ * Each storage data type has a function that sends an item of the type to the cloud, and one
+ * that adds an item to a cloud batch if the type can be batched. The functions are listed in
+ * DATA_SOURCE_LIST in storage_data_types.h, and dispatched through cloud_dispatch[].
+ */
 
 #if defined(CONFIG_APP_POWER)
-	if (item->type == STORAGE_TYPE_BATTERY) {
-		const struct power_msg *power = &item->data.BATTERY;
+static int battery_cloud_send(const struct storage_data_item *item)
+{
+	int err;
+	const struct power_msg *power = &item->data.BATTERY;
+	const bool confirmable = cloud_policy_confirmable(CLOUD_POLICY_DATA_ROUTINE);
+	int64_t timestamp_ms = power->timestamp;
+	int64_t start_ms;
 
-		/* Convert timestamp to unix time */
-		timestamp_ms = power->timestamp;
+	/* Convert timestamp to unix time */
+	err = handle_data_timestamp(&timestamp_ms);
+	if (err) {
+		return err;
+	}
 
-		err = handle_data_timestamp(&timestamp_ms);
-		if (err) {
-			return err;
-		}
+	start_ms = cloud_stats_start();
+	err = nrf_cloud_coap_sensor_send(CUSTOM_JSON_APPID_VAL_BATTERY,
+					 power->percentage,
+					 timestamp_ms,
+					 confirmable);
+	cloud_stats_record(CLOUD_STATS_SENSOR, 0, confirmable, start_ms, err);
+	cloud_policy_send_result(confirmable, err);
+	if (err) {
+		LOG_ERR("Failed to send battery data to cloud, error: %d", err);
+		return err;
+	}
 
-		err = nrf_cloud_coap_sensor_send(CUSTOM_JSON_APPID_VAL_BATTERY,
-						 power->percentage,
-						 timestamp_ms,
-						 confirmable);
-		if (err) {
-			LOG_ERR("Failed to send battery data to cloud, error: %d", err);
-			return err;
-		}
+	LOG_DBG("Battery data sent to cloud: %.1f%%", power->percentage);
 
-		LOG_DBG("Battery data sent to cloud: %.1f%%", power->percentage);
+	return 0;
+}
 
-		/* Unused variable if no other sources compiled in */
-		(void)confirmable;
+#if defined(CONFIG_APP_CLOUD_BATCH_UPLOAD)
+static int battery_cloud_batch_add(const struct storage_data_item *item)
+{
+	int err;
+	const struct power_msg *power = &item->data.BATTERY;
+	int64_t timestamp_ms = power->timestamp;
 
-		return 0;
+	err = handle_data_timestamp(&timestamp_ms);
+	if (err) {
+		return err;
 	}
+
+	return cloud_batch_sensor_add(CUSTOM_JSON_APPID_VAL_BATTERY, power->percentage,
+				      timestamp_ms);
+}
+#endif /* CONFIG_APP_CLOUD_BATCH_UPLOAD */
 #endif /* CONFIG_APP_POWER */
 
 #if defined(CONFIG_APP_ENVIRONMENTAL)
-	if (item->type == STORAGE_TYPE_ENVIRONMENTAL) {
-		const struct environmental_msg *env = &item->data.ENVIRONMENTAL;
+static int environmental_cloud_send(const struct storage_data_item *item)
+{
+	int err;
+	const struct environmental_msg *env = &item->data.ENVIRONMENTAL;
+	const bool confirmable = cloud_policy_confirmable(CLOUD_POLICY_DATA_ROUTINE);
+	int64_t timestamp_ms = env->timestamp;
 
-		/* Convert timestamp to unix time */
-		timestamp_ms = env->timestamp;
+	/* Convert timestamp to unix time */
+	err = handle_data_timestamp(&timestamp_ms);
+	if (err) {
+		return err;
+	}
 
-		err = handle_data_timestamp(&timestamp_ms);
-		if (err) {
-			return err;
-		}
+	err = cloud_environmental_send(env, timestamp_ms, confirmable);
+	cloud_policy_send_result(confirmable, err);
+
+	return err;
+}
 
-		return cloud_environmental_send(env, timestamp_ms, confirmable);
+#if defined(CONFIG_APP_CLOUD_BATCH_UPLOAD)
+static int environmental_cloud_batch_add(const struct storage_data_item *item)
+{
+	int err;
+	const struct environmental_msg *env = &item->data.ENVIRONMENTAL;
+	int64_t timestamp_ms = env->timestamp;
+
+	err = handle_data_timestamp(&timestamp_ms);
+	if (err) {
+		return err;
 	}
+
+	return cloud_environmental_batch_add(env, timestamp_ms);
+}
+#endif /* CONFIG_APP_CLOUD_BATCH_UPLOAD */
 #endif /* CONFIG_APP_ENVIRONMENTAL */
 
 #if defined(CONFIG_APP_LOCATION)
-	if (item->type == STORAGE_TYPE_LOCATION) {
-		const struct location_msg *loc = &item->data.LOCATION;
+/* Location data is always sent on its own */
+static int location_cloud_send(const struct storage_data_item *item)
+{
+	return cloud_location_handle_message(&item->data.LOCATION);
+}
+#endif /* CONFIG_APP_LOCATION */
+
+/* Cloud functions of a storage data type */
+struct cloud_dispatch {
+	int (*send)(const struct storage_data_item *item);
 
-		return cloud_location_handle_message(loc);
+#if defined(CONFIG_APP_CLOUD_BATCH_UPLOAD)
+	/* NULL for types that cannot be batched */
+	int (*batch_add)(const struct storage_data_item *item);
+#endif /* CONFIG_APP_CLOUD_BATCH_UPLOAD */
+};
+
+#define CLOUD_DISPATCH_ENTRY(_name, _chan, _msg_type, _data_type, _check_fn, _extract_fn,	\
+			     _record_type, _encode_fn, _decode_fn, _cloud_send_fn,		\
+			     _cloud_batch_fn)							\
+	[STORAGE_DATA_TYPE(_name)] = {								\
+		.send = _cloud_send_fn,								\
+		IF_ENABLED(CONFIG_APP_CLOUD_BATCH_UPLOAD, (.batch_add = _cloud_batch_fn,))	\
+	},
+
+/* Indexed by enum storage_data_type, entries of types that are not listed are zero */
+static const struct cloud_dispatch cloud_dispatch[STORAGE_DATA_TYPE_COUNT] = {
+	DATA_SOURCE_LIST(CLOUD_DISPATCH_ENTRY)
+};
+
+/* Get the cloud functions of a storage data type, NULL if the type cannot be sent */
+static const struct cloud_dispatch *cloud_dispatch_get(enum storage_data_type type)
+{
+	if (((unsigned int)type >= ARRAY_SIZE(cloud_dispatch)) ||
+	    (cloud_dispatch[type].send == NULL)) {
+		return NULL;
 	}
-#endif /* CONFIG_APP_LOCATION && CONFIG_LOCATION_METHOD_GNSS */
 
-	LOG_WRN("Unknown storage data type: %d", item->type);
+	return &cloud_dispatch[type];
+}
+
+static int send_storage_data_to_cloud(const struct storage_data_item *item)
+{
+	const struct cloud_dispatch *dispatch = cloud_dispatch_get(item->type);
+
+	if (dispatch == NULL) {
+		LOG_WRN("Unknown storage data type: %d", item->type);
 
-	/* Unused variables if no data sources are enabled */
-	(void)confirmable;
-	(void)timestamp_ms;
-	(void) err;
+		return -ENOTSUP;
+	}
 
-	return -ENOTSUP;
+	return dispatch->send(item);
 }
 
-static void handle_storage_batch_available(const struct storage_msg *msg)
+/* Network errors that may succeed when the request is sent again on the same connection */
+static bool send_error_is_retryable(int err)
+{
+	return (err != 0) && (err != -ENOTCONN) && (err != -ENOTSUP) && (err != -EINVAL);
+}
+
+/* Storage batch upload through the shared cloud transport engine. The engine claims the items
+ * of the session and consumes them from storage once they have been sent. nRF Cloud CoAP
+ * requests are sent one at a time, so every batch is sent before send_batch returns.
+ */
+
+/* Send a single storage item, repeats are suppressed without sending.
+ * Network errors are retried CONFIG_APP_CLOUD_SEND_RETRIES times.
+ */
+static int transport_send_one(const struct storage_data_item *item)
 {
 	int err;
-	struct storage_data_item item;
-	uint32_t items_processed = 0;
-	uint32_t items_available = msg->data_len;
-	uint32_t session_id = msg->session_id;
-	struct storage_msg out_msg = {
-		.session_id = session_id,
-	};
-	bool session_error = false;
 
-	LOG_INF("Processing storage batch: %u items available", items_available);
+	if (cloud_dedup_suppress(item)) {
+		cloud_dedup_commit(item->type);
 
-	/* Suppress delivery of storage_chan messages back to cloud_subscriber while we
-	 * are blocking in this loop.
-	 */
-	err = zbus_obs_set_chan_notification_mask(&cloud_subscriber, &storage_chan, true);
-	__ASSERT(err == 0, "cloud_subscriber not registered on storage_chan: %d", err);
+		return 0;
+	}
 
-	/* Drain the batch buffer: read until timeout, abort on hard error */
-	while (!session_error) {
-		err = storage_batch_read(&item, K_MSEC(500));
-		if (err == -EAGAIN) {
-			LOG_DBG("No more data available in batch (timeout)");
+	err = send_storage_data_to_cloud(item);
 
-			break;
-		} else if (err) {
-			LOG_ERR("storage_batch_read failed, error: %d", err);
-			session_error = true;
+	for (int retry = 0; (retry < CONFIG_APP_CLOUD_SEND_RETRIES) &&
+			    send_error_is_retryable(err); retry++) {
+		LOG_WRN("Retrying send of data (type %d) after error: %d", item->type, err);
 
-			continue;
-		}
+		err = send_storage_data_to_cloud(item);
+	}
 
-		err = send_storage_data_to_cloud(&item);
-		if (err) {
-			if (err == -ENOTSUP || err == -EINVAL) {
-				LOG_ERR("Data error sending data (type %d): %d", item.type, err);
-			} else {
-				LOG_WRN("Network error sending data (type %d): %d", item.type, err);
-				session_error = true;
+	if (err == 0) {
+		cloud_dedup_commit(item->type);
+	}
 
-				continue;
-			}
-		} else {
-			items_processed++;
-		}
+	return err;
+}
 
-		/* Consume the item: confirms a successful send or skips a malformed item */
-		out_msg.type = STORAGE_BATCH_CONSUME;
-		out_msg.data_type = item.type;
-		err = zbus_chan_pub(&storage_chan, &out_msg, PUB_TIMEOUT);
-		if (err) {
-			LOG_ERR("Failed to consume storage item, error: %d", err);
-			SEND_FATAL_ERROR();
-		}
+#if defined(CONFIG_APP_CLOUD_BATCH_UPLOAD)
+/* Add a storage item to the pending cloud batch.
+ * Returns -ENOTSUP for data types that cannot be batched and must be sent on their own.
+ */
+static int transport_batch_add(const struct storage_data_item *item)
+{
+	const struct cloud_dispatch *dispatch = cloud_dispatch_get(item->type);
+
+	if ((dispatch == NULL) || (dispatch->batch_add == NULL)) {
+		return -ENOTSUP;
 	}
 
-	LOG_DBG("Processed %u/%u storage items", items_processed, items_available);
+	/* Repeats are consumed together with the batch, which is empty if only repeats */
+	if (cloud_dedup_suppress(item)) {
+		return 0;
+	}
 
-	/* Re-enable storage_chan notifications to cloud_subscriber */
-	err = zbus_obs_set_chan_notification_mask(&cloud_subscriber, &storage_chan, false);
-	__ASSERT(err == 0, "cloud_subscriber not registered on storage_chan: %d", err);
+	return dispatch->batch_add(item);
+}
 
-	if (items_processed > 0) {
-		err = nrf_cloud_coap_shadow_network_info_update();
-		if (err) {
-			LOG_ERR("nrf_cloud_coap_shadow_network_info_update, error: %d", err);
+/* Send the pending cloud batch. A failed batch is dropped, its items are not consumed and are
+ * sent again in the next session.
+ */
+static int transport_send_batch(const enum storage_data_type *types, size_t count,
+				uint32_t *id)
+{
+	int err;
+	/* Batches only hold battery and environmental samples */
+	const bool confirmable = cloud_policy_confirmable(CLOUD_POLICY_DATA_ROUTINE);
 
-			/* Continue despite error to close the batch session */
-		}
+	ARG_UNUSED(id);
+
+	err = cloud_batch_send(confirmable);
+	cloud_policy_send_result(confirmable, err);
+
+	/* A failed batch is kept pending, so it can be sent again as is */
+	for (int retry = 0; (retry < CONFIG_APP_CLOUD_SEND_RETRIES) &&
+			    send_error_is_retryable(err); retry++) {
+		LOG_WRN("Retrying send of batch of %zu items after error: %d", count, err);
+
+		err = cloud_batch_send(confirmable);
+		cloud_policy_send_result(confirmable, err);
 	}
 
-	/* Close the batch session */
-	out_msg.type = STORAGE_BATCH_CLOSE;
-	err = zbus_chan_pub(&storage_chan, &out_msg, PUB_TIMEOUT);
 	if (err) {
-		LOG_ERR("Failed to close storage batch session, error: %d", err);
-		SEND_FATAL_ERROR();
+		LOG_WRN("Network error sending batch of %zu items: %d", count, err);
+		cloud_batch_discard();
+
+		return err;
 	}
+
+	for (size_t i = 0; i < count; i++) {
+		cloud_dedup_commit(types[i]);
+	}
+
+	return 0;
 }
+#endif /* CONFIG_APP_CLOUD_BATCH_UPLOAD */
 
-static void handle_storage_batch_empty(const struct storage_msg *msg)
+#if defined(CONFIG_APP_CLOUD_PRIORITY_LANE)
+/* Set when a priority event failed to send in the running session */
+static bool priority_send_failed;
+
+/* Send priority events that arrived during the session between the stored items. After a
+ * failure, the events are not tried again before each of the remaining items of the session.
+ * The failure is left to the next stored item, which fails the same way if the connection is
+ * lost.
+ */
+static void transport_priority_send(void)
+{
+	if (priority_send_failed) {
+		return;
+	}
+
+	if (cloud_priority_send_pending()) {
+		priority_send_failed = true;
+	}
+}
+#endif /* CONFIG_APP_CLOUD_PRIORITY_LANE */
+
+static void transport_session_done(uint32_t items_sent)
 {
 	int err;
-	struct storage_msg close_msg = {
-		.type = STORAGE_BATCH_CLOSE,
-		.session_id = msg->session_id,
-	};
 
-	LOG_DBG("Storage batch is empty, closing session");
+	/* Samples that were checked but not sent are checked again in the next session */
+	cloud_dedup_rollback();
+	uptime_offset_invalidate();
 
-	err = zbus_chan_pub(&storage_chan, &close_msg, PUB_TIMEOUT);
-	if (err) {
-		LOG_ERR("Failed to close empty storage batch session, error: %d", err);
-		SEND_FATAL_ERROR();
+	if (items_sent > 0) {
+		err = cloud_network_info_update();
+		if (err) {
+			LOG_ERR("cloud_network_info_update, error: %d", err);
+
+			/* Continue despite error to close the batch session */
+		}
+
+		transaction_done_send();
 	}
 }
 
-static void handle_storage_batch_error(const struct storage_msg *msg)
+static const struct cloud_transport coap_transport = {
+	.name = "nRF Cloud CoAP",
+	.window = 1,
+#if defined(CONFIG_APP_CLOUD_BATCH_UPLOAD)
+	.batch_max_items = CONFIG_APP_CLOUD_BATCH_MAX_ITEMS,
+	.batch_add = transport_batch_add,
+	.send_batch = transport_send_batch,
+	.batch_discard = cloud_batch_discard,
+#endif /* CONFIG_APP_CLOUD_BATCH_UPLOAD */
+	.send_one = transport_send_one,
+#if defined(CONFIG_APP_CLOUD_PRIORITY_LANE)
+	.priority_send = transport_priority_send,
+#endif /* CONFIG_APP_CLOUD_PRIORITY_LANE */
+	.session_done = transport_session_done,
+};
+
+static void handle_storage_batch_available(const struct storage_msg *msg)
 {
 	int err;
-	struct storage_msg close_msg = {
-		.type = STORAGE_BATCH_CLOSE,
-		.session_id = msg->session_id,
-	};
 
-	LOG_ERR("Storage batch error occurred, closing session");
+#if defined(CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE)
+	/* The sample arrives after the session and is used for the next one */
+	request_network_quality_sample();
+#endif /* CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE */
+
+	/* Suppress delivery of storage_chan messages back to cloud_subscriber while we
+	 * are blocking in the session.
+	 */
+	err = zbus_obs_set_chan_notification_mask(&cloud_subscriber, &storage_chan, true);
+	__ASSERT(err == 0, "cloud_subscriber not registered on storage_chan: %d", err);
 
-	err = zbus_chan_pub(&storage_chan, &close_msg, PUB_TIMEOUT);
+#if defined(CONFIG_APP_CLOUD_PRIORITY_LANE)
+	priority_send_failed = false;
+#endif /* CONFIG_APP_CLOUD_PRIORITY_LANE */
+
+	/* Every batch is sent before send_batch returns, so the session has been closed when
+	 * this returns.
+	 */
+	err = cloud_transport_session_start(&coap_transport, msg);
 	if (err) {
-		LOG_ERR("Failed to close error storage batch session, error: %d", err);
-		SEND_FATAL_ERROR();
+		LOG_ERR("cloud_transport_session_start, error: %d", err);
+		cloud_transport_session_reject(msg->session_id);
 	}
+
+	/* Re-enable storage_chan notifications to cloud_subscriber */
+	err = zbus_obs_set_chan_notification_mask(&cloud_subscriber, &storage_chan, false);
+	__ASSERT(err == 0, "cloud_subscriber not registered on storage_chan: %d", err);
+}
+
+static void handle_storage_batch_empty(const struct storage_msg *msg)
+{
+	LOG_DBG("Storage batch is empty, closing session");
+
+	cloud_transport_session_reject(msg->session_id);
+}
+
+static void handle_storage_batch_error(const struct storage_msg *msg)
+{
+	LOG_ERR("Storage batch error occurred, closing session");
+
+	cloud_transport_session_reject(msg->session_id);
 }
 
 static void handle_storage_batch_busy(const struct storage_msg *msg)
@@ -625,7 +985,7 @@ static void handle_storage_batch_busy(const struct storage_msg *msg)
 	/* Could implement retry logic here if needed */
 }
 
-static void handle_storage_data(const struct storage_msg *msg)
+static void handle_storage_data(const struct storage_data_msg *msg)
 {
 	int err;
 	/* Handle real-time storage data */
@@ -642,24 +1002,44 @@ static void handle_storage_data(const struct storage_msg *msg)
 
 	memcpy(&item.data, msg->buffer, msg->data_len);
 
+	if (cloud_dedup_suppress(&item)) {
+		cloud_dedup_commit(item.type);
+
+		return;
+	}
+
 	/* Send to cloud */
 	err = send_storage_data_to_cloud(&item);
+
+	uptime_offset_invalidate();
+
 	if (err) {
 		LOG_ERR("Failed to send real-time storage data to cloud, error: %d", err);
+		cloud_dedup_rollback();
+
 		return;
 	}
+
+	cloud_dedup_commit(item.type);
 }
 
 static void handle_cloud_channel_message(struct cloud_state_object const *state_object)
 {
 	int err;
 	const struct cloud_msg *msg = (const struct cloud_msg *)state_object->msg_buf;
-	const bool confirmable = IS_ENABLED(CONFIG_APP_CLOUD_CONFIRMABLE_MESSAGES);
+	bool confirmable;
+	int64_t start_ms;
 
 	switch (msg->type) {
 	case CLOUD_PAYLOAD_JSON:
+		confirmable = cloud_policy_confirmable(CLOUD_POLICY_DATA_CRITICAL);
+
+		start_ms = cloud_stats_start();
 		err = nrf_cloud_coap_json_message_send(msg->payload.buffer,
 						       false, confirmable);
+		cloud_stats_record(CLOUD_STATS_MESSAGE, msg->payload.buffer_data_len, confirmable,
+				   start_ms, err);
+		cloud_policy_send_result(confirmable, err);
 		if (err) {
 			LOG_ERR("nrf_cloud_coap_json_message_send, error: %d", err);
 			send_request_failed();
@@ -698,7 +1078,9 @@ static void handle_cloud_channel_message(struct cloud_state_object const *state_
 		}
 		break;
 	case CLOUD_SHADOW_UPDATE_REPORTED_DEVICE:
+		start_ms = cloud_stats_start();
 		err = nrf_cloud_coap_shadow_configured_info_update(APP_VERSION_STRING);
+		cloud_stats_record(CLOUD_STATS_SHADOW, 0, true, start_ms, err);
 		if (err) {
 			LOG_ERR("nrf_cloud_coap_shadow_configured_info_update, error: %d", err);
 			send_request_failed();
@@ -708,11 +1090,109 @@ static void handle_cloud_channel_message(struct cloud_state_object const *state_
 		LOG_DBG("Provisioning request received");
 		smf_set_state(SMF_CTX(state_object), &states[STATE_PROVISIONING]);
 		break;
+#if defined(CONFIG_APP_CLOUD_MEMFAULT_UPLOAD)
+	case CLOUD_MEMFAULT_UPLOAD:
+		/* Memfault data that fails to upload is kept for the next window */
+		(void)cloud_memfault_upload();
+		break;
+#endif /* CONFIG_APP_CLOUD_MEMFAULT_UPLOAD */
 	default:
 		break;
 	}
 }
 
+#if defined(CONFIG_APP_CLOUD_TXN_WINDOW)
+/* Collect shadow polls and batch sessions in the transaction window, so that they are run
+ * back to back once the window expires instead of as separate transactions.
+ * Returns true if the message was added to the window.
+ */
+static bool txn_window_collect(struct cloud_state_object *state_object)
+{
+	if (state_object->chan == &cloud_chan) {
+		const struct cloud_msg *msg = (const struct cloud_msg *)state_object->msg_buf;
+
+		if (msg->type == CLOUD_SHADOW_GET_DESIRED) {
+			state_object->txn.shadow_desired = true;
+		} else if (msg->type == CLOUD_SHADOW_GET_DELTA) {
+			state_object->txn.shadow_delta = true;
+		} else {
+			return false;
+		}
+	} else if (state_object->chan == &storage_chan) {
+		const struct storage_msg *msg = (const struct storage_msg *)state_object->msg_buf;
+
+		if (msg->type != STORAGE_BATCH_AVAILABLE) {
+			return false;
+		}
+
+		if (state_object->txn.batch) {
+			/* Storage only runs one session at a time, keep the latest */
+			LOG_WRN("Replacing pending batch session 0x%X with 0x%X",
+				state_object->txn.batch_msg.session_id, msg->session_id);
+		}
+
+		state_object->txn.batch_msg = *msg;
+		state_object->txn.batch = true;
+	} else {
+		return false;
+	}
+
+	/* The window starts with the first collected message and is not extended */
+	if (!k_work_delayable_is_pending(&txn_window_work)) {
+		(void)k_work_schedule(&txn_window_work,
+				      K_MSEC(CONFIG_APP_CLOUD_TXN_WINDOW_MSEC));
+	}
+
+	return true;
+}
+
+/* Run the work collected in the transaction window: shadow polls first, as they may change
+ * the configuration, then the batch upload, which ends with the network info update.
+ */
+static void txn_window_run(struct cloud_state_object *state_object)
+{
+	int err;
+
+	if (state_object->txn.shadow_desired) {
+		LOG_DBG("Poll shadow desired from transaction window");
+
+		err = cloud_configuration_poll(SHADOW_POLL_DESIRED);
+		if (err) {
+			LOG_ERR("cloud_configuration_poll, error: %d", err);
+			send_request_failed();
+		}
+	}
+
+	if (state_object->txn.shadow_delta) {
+		LOG_DBG("Poll shadow delta from transaction window");
+
+		err = cloud_configuration_poll(SHADOW_POLL_DELTA);
+		if (err) {
+			LOG_ERR("cloud_configuration_poll, error: %d", err);
+			send_request_failed();
+		}
+	}
+
+	if (state_object->txn.batch) {
+		handle_storage_batch_available(&state_object->txn.batch_msg);
+	}
+
+	memset(&state_object->txn, 0, sizeof(state_object->txn));
+}
+#endif /* CONFIG_APP_CLOUD_TXN_WINDOW */
+
+static void handle_priority_events(void)
+{
+	int err;
+
+	/* Events that nRF Cloud rejects are dropped, an error is a network error */
+	err = cloud_priority_send_pending();
+	if (err) {
+		LOG_ERR("cloud_priority_send_pending, error: %d", err);
+		send_request_failed();
+	}
+}
+
 static void handle_priv_cloud_message(struct cloud_state_object const *state_object)
 {
 	const struct priv_cloud_msg *msg = (const struct priv_cloud_msg *)state_object->msg_buf;
@@ -751,7 +1231,7 @@ static void handle_storage_channel_message(struct cloud_state_object const *stat
 
 static void handle_storage_data_message(struct cloud_state_object const *state_object)
 {
-	const struct storage_msg *msg = (const struct storage_msg *)state_object->msg_buf;
+	const struct storage_data_msg *msg = (const struct storage_data_msg *)state_object->msg_buf;
 
 	if (msg->type == STORAGE_DATA) {
 		LOG_DBG("Storage data received, type: %d, size: %d",
@@ -791,6 +1271,15 @@ static void state_running_entry(void *obj)
 		return;
 	}
 
+	/* The provisioning service runs its own checks once initialized, which take LTE
+	 * offline. With valid credentials, it is only initialized when provisioning is needed.
+	 */
+	if (cloud_provisioning_marker_valid()) {
+		LOG_DBG("Device provisioned, provisioning service not started");
+
+		return;
+	}
+
 	err = cloud_provisioning_init();
 	if (err) {
 		LOG_ERR("nrf_provisioning_init, error: %d", err);
@@ -858,6 +1347,7 @@ static void state_connecting_entry(void *obj)
 
 	state_object->connection_attempts = 0;
 	state_object->provisioning_ongoing = false;
+	state_object->server_rejected = false;
 }
 
 static enum smf_state_result state_connecting_run(void *obj)
@@ -925,7 +1415,10 @@ static enum smf_state_result state_connecting_provisioned_run(void *obj)
 			smf_set_state(SMF_CTX(state_object), &states[STATE_CONNECTED]);
 
 			return SMF_EVENT_HANDLED;
-		} else if (msg->type == CLOUD_CONNECTION_FAILED) {
+		} else if ((msg->type == CLOUD_CONNECTION_FAILED) ||
+			   (msg->type == CLOUD_CONNECTION_REJECTED)) {
+			state_object->server_rejected = (msg->type == CLOUD_CONNECTION_REJECTED);
+
 			smf_set_state(SMF_CTX(state_object), &states[STATE_CONNECTING_BACKOFF]);
 
 			return SMF_EVENT_HANDLED;
@@ -957,6 +1450,10 @@ static void state_connecting_provisioning_entry(void *obj)
 	}
 
 	state_object->provisioning_ongoing = true;
+	state_object->server_rejected = false;
+
+	/* The credentials may be replaced, they are marked again after the next connection */
+	cloud_provisioning_marker_clear();
 
 	err = cloud_provisioning_trigger();
 	if (err) {
@@ -1015,7 +1512,8 @@ static void state_connecting_backoff_entry(void *obj)
 
 	LOG_DBG("%s", __func__);
 
-	state_object->backoff_time = calculate_backoff_time(state_object->connection_attempts);
+	state_object->backoff_time = calculate_backoff_time(state_object->connection_attempts,
+							    state_object->server_rejected);
 
 	LOG_WRN("Connection attempt failed, backoff time: %u seconds",
 		state_object->backoff_time);
@@ -1108,6 +1606,12 @@ static void state_connected_ready_entry(void *obj)
 
 	LOG_DBG("%s", __func__);
 
+	/* The network may have changed while the connection was down */
+	cloud_network_info_invalidate();
+
+	/* Changes may have been made to the shadow while the connection was down */
+	cloud_configuration_poll_reset();
+
 	err = zbus_chan_pub(&cloud_chan, &cloud_msg, PUB_TIMEOUT);
 	if (err) {
 		LOG_ERR("zbus_chan_pub, error: %d", err);
@@ -1119,12 +1623,36 @@ static void state_connected_ready_entry(void *obj)
 #if defined(CONFIG_NRF_CLOUD_AGNSS) && defined(CONFIG_APP_LOCATION)
 	cloud_location_agnss_process_cached();
 #endif /* CONFIG_NRF_CLOUD_AGNSS && CONFIG_APP_LOCATION */
+
+#if defined(CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE)
+	request_network_quality_sample();
+#endif /* CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE */
+
+	/* Events that happened while the connection was down */
+	handle_priority_events();
 }
 
 static enum smf_state_result state_connected_ready_run(void *obj)
 {
 	struct cloud_state_object const *state_object = obj;
 
+#if defined(CONFIG_APP_CLOUD_TXN_WINDOW)
+	if (txn_window_collect(obj)) {
+		return SMF_EVENT_HANDLED;
+	}
+
+	if (state_object->chan == &priv_cloud_chan) {
+		const struct priv_cloud_msg *msg =
+			(const struct priv_cloud_msg *)state_object->msg_buf;
+
+		if (msg->type == CLOUD_TXN_WINDOW_EXPIRED) {
+			txn_window_run(obj);
+
+			return SMF_EVENT_HANDLED;
+		}
+	}
+#endif /* CONFIG_APP_CLOUD_TXN_WINDOW */
+
 	if (state_object->chan == &priv_cloud_chan) {
 		handle_priv_cloud_message(state_object);
 		return SMF_EVENT_HANDLED;
@@ -1140,6 +1668,12 @@ static enum smf_state_result state_connected_ready_run(void *obj)
 			return SMF_EVENT_HANDLED;
 		case NETWORK_CONNECTED:
 			return SMF_EVENT_HANDLED;
+#if defined(CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE)
+		case NETWORK_QUALITY_SAMPLE_RESPONSE:
+			cloud_policy_rsrp_update(msg->conn_eval_params.rsrp);
+
+			return SMF_EVENT_HANDLED;
+#endif /* CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE */
 		default:
 			break;
 		}
@@ -1165,6 +1699,14 @@ static enum smf_state_result state_connected_ready_run(void *obj)
 		return SMF_EVENT_HANDLED;
 	}
 
+#if defined(CONFIG_APP_CLOUD_PRIORITY_LANE)
+	if (state_object->chan == &cloud_priority_chan) {
+		handle_priority_events();
+
+		return SMF_EVENT_HANDLED;
+	}
+#endif /* CONFIG_APP_CLOUD_PRIORITY_LANE */
+
 #if defined(CONFIG_APP_LOCATION)
 	if (state_object->chan == &location_chan) {
 		const struct location_msg *msg = (const struct location_msg *)state_object->msg_buf;
@@ -1182,6 +1724,31 @@ static enum smf_state_result state_connected_ready_run(void *obj)
 	return SMF_EVENT_PROPAGATE;
 }
 
+static void state_connected_ready_exit(void *obj)
+{
+#if defined(CONFIG_APP_CLOUD_TXN_WINDOW)
+	struct cloud_state_object *state_object = obj;
+
+	LOG_DBG("%s", __func__);
+
+	(void)k_work_cancel_delayable(&txn_window_work);
+
+	/* Shadow polls are requested again by the application. A pending batch session is
+	 * closed so that storage does not wait for the session timeout.
+	 */
+	if (state_object->txn.batch) {
+		LOG_WRN("Leaving ready state, closing pending batch session 0x%X",
+			state_object->txn.batch_msg.session_id);
+
+		handle_storage_batch_empty(&state_object->txn.batch_msg);
+	}
+
+	memset(&state_object->txn, 0, sizeof(state_object->txn));
+#else
+	ARG_UNUSED(obj);
+#endif /* CONFIG_APP_CLOUD_TXN_WINDOW */
+}
+
 /* Handlers for STATE_CONNECTED_PAUSED */
 
 static void state_connected_paused_entry(void *obj)
@@ -1195,6 +1762,9 @@ static void state_connected_paused_entry(void *obj)
 
 	LOG_DBG("%s", __func__);
 
+	/* Keep the DTLS session in the modem so that no new handshake is needed on reconnect */
+	cloud_session_pause();
+
 	err = zbus_chan_pub(&cloud_chan, &cloud_msg, PUB_TIMEOUT);
 	if (err) {
 		LOG_ERR("zbus_chan_pub, error: %d", err);
@@ -1212,6 +1782,12 @@ static enum smf_state_result state_connected_paused_run(void *obj)
 		const struct network_msg *msg = (const struct network_msg *)state_object->msg_buf;
 
 		if (msg->type == NETWORK_CONNECTED) {
+			if (cloud_session_resume()) {
+				smf_set_state(SMF_CTX(state_object), &states[STATE_CONNECTING]);
+
+				return SMF_EVENT_HANDLED;
+			}
+
 			smf_set_state(SMF_CTX(state_object), &states[STATE_CONNECTED_READY]);
 
 			return SMF_EVENT_HANDLED;
@@ -1282,6 +1858,7 @@ static void cloud_module_thread(void)
 
 	/* Initialize the state machine to STATE_RUNNING, which will also run its entry function */
 	smf_set_initial(SMF_CTX(&cloud_state), &states[STATE_RUNNING]);
+	STATE_STATS_UPDATE(cloud, SMF_CTX(&cloud_state));
 
 	while (true) {
 		err = task_wdt_feed(task_wdt_id);
@@ -1303,15 +1880,21 @@ static void cloud_module_thread(void)
 			return;
 		}
 
+		zbus_stats_received(&cloud_subscriber, cloud_state.chan);
+
 		network_connection_status_retain(&cloud_state);
 
+		HANDLER_STATS_START(cloud, cloud_state.chan);
 		err = smf_run_state(SMF_CTX(&cloud_state));
+		HANDLER_STATS_END(cloud);
 		if (err) {
 			LOG_ERR("smf_run_state(), error: %d", err);
 			SEND_FATAL_ERROR();
 
 			return;
 		}
+
+		STATE_STATS_UPDATE(cloud, SMF_CTX(&cloud_state));
 	}
 }
 
@@ -17,7 +17,8 @@ extern "C" {
 
 /* Channels provided by this module */
 ZBUS_CHAN_DECLARE(
-	cloud_chan
+	cloud_chan,
+	cloud_priority_chan
 );
 
 struct cloud_payload {
@@ -127,6 +128,12 @@ enum cloud_msg_type {
 	 * reprovision devices with new credentials when the old ones expire or need rotation.
 	 */
 	CLOUD_PROVISIONING_REQUEST,
+
+	/* Request to upload pending Memfault data within the byte budget of the upload window.
+	 * Sent by the main module when the data upload is done, so that Memfault data is sent
+	 * in the same RRC connection. Available with CONFIG_APP_CLOUD_MEMFAULT_UPLOAD.
+	 */
+	CLOUD_MEMFAULT_UPLOAD,
 };
 
 struct cloud_msg {
@@ -146,6 +153,52 @@ struct cloud_msg {
 	};
 };
 
+enum cloud_priority_msg_type {
+	/* Input message types */
+
+	/* A button was pressed. The button number is in .button_number */
+	CLOUD_PRIORITY_BUTTON = 0x1,
+
+	/* The device entered or left a geofence zone. The zone and the transition are in
+	 * .geofence
+	 */
+	CLOUD_PRIORITY_GEOFENCE,
+
+	/* An environmental sample left the reporting deadband. The readings are in
+	 * .environmental
+	 */
+	CLOUD_PRIORITY_ENVIRONMENTAL,
+};
+
+/* Events on cloud_priority_chan are sent to the cloud as soon as possible, ahead of the stored
+ * data. They are sent between the items of a running storage batch session instead of waiting
+ * for the session to complete. Available with CONFIG_APP_CLOUD_PRIORITY_LANE.
+ */
+struct cloud_priority_msg {
+	enum cloud_priority_msg_type type;
+
+	/* Uptime in milliseconds when the event happened */
+	int64_t uptime_ms;
+
+	union {
+		/* Number of the pressed button, valid for CLOUD_PRIORITY_BUTTON */
+		uint8_t button_number;
+
+		/* Valid for CLOUD_PRIORITY_GEOFENCE */
+		struct {
+			uint32_t zone_id;
+			bool entered;
+		} geofence;
+
+		/* Valid for CLOUD_PRIORITY_ENVIRONMENTAL */
+		struct {
+			double temperature;
+			double humidity;
+			double pressure;
+		} environmental;
+	};
+};
+
 #define UNIX_TIME_MS_2026_01_01 1767222000000LL
 
 #ifdef __cplusplus
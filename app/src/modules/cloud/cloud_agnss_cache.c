@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <date_time.h>
+#include <string.h>
+
+#include "cloud_agnss_cache.h"
+
+LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
+
+#define SETTINGS_SUBTREE	"att_cloud/agnss"
+
+#define EPHEMERIS_VALIDITY_MS	\
+	((int64_t)CONFIG_APP_CLOUD_AGNSS_CACHE_EPHEMERIS_VALIDITY_MINUTES * MSEC_PER_SEC * 60)
+#define ALMANAC_VALIDITY_MS	\
+	((int64_t)CONFIG_APP_CLOUD_AGNSS_CACHE_ALMANAC_VALIDITY_HOURS * MSEC_PER_SEC * 60 * 60)
+
+struct cache_entry {
+	/* Date and time of the download in ms since epoch, 0 for an empty entry */
+	int64_t downloaded_ms;
+
+	/* Satellites covered by the data */
+	struct nrf_modem_gnss_agnss_data_frame covered;
+
+	uint16_t size;
+
+	/* Only the first size bytes are saved to settings */
+	char data[CONFIG_APP_CLOUD_AGNSS_CACHE_BUF_SIZE];
+};
+
+struct part_info {
+	const char *name;
+	int64_t validity_ms;
+};
+
+static const struct part_info parts[CLOUD_AGNSS_PART_COUNT] = {
+	[CLOUD_AGNSS_PART_OTHER] = { .name = "other", .validity_ms = 0 },
+	[CLOUD_AGNSS_PART_EPHEMERIDES] = { .name = "ephe", .validity_ms = EPHEMERIS_VALIDITY_MS },
+	[CLOUD_AGNSS_PART_ALMANAC] = { .name = "alm", .validity_ms = ALMANAC_VALIDITY_MS },
+};
+
+/* Only accessed from the cloud thread. CLOUD_AGNSS_PART_OTHER has no entry. */
+static struct cache_entry entries[CLOUD_AGNSS_PART_COUNT - 1];
+static bool loaded;
+
+static struct cache_entry *entry_get(enum cloud_agnss_part part)
+{
+	if ((part <= CLOUD_AGNSS_PART_OTHER) || (part >= CLOUD_AGNSS_PART_COUNT)) {
+		return NULL;
+	}
+
+	return &entries[part - 1];
+}
+
+static uint64_t sv_mask_get(enum cloud_agnss_part part,
+			    const struct nrf_modem_gnss_agnss_system_data_need *system)
+{
+	return (part == CLOUD_AGNSS_PART_EPHEMERIDES) ? system->sv_mask_ephe :
+							system->sv_mask_alm;
+}
+
+static int settings_load_cb(const char *key, size_t len, settings_read_cb read_cb,
+			    void *cb_arg, void *param)
+{
+	struct cache_entry *entry = NULL;
+	ssize_t ret;
+
+	ARG_UNUSED(param);
+
+	if (!key) {
+		return 0;
+	}
+
+	for (enum cloud_agnss_part part = CLOUD_AGNSS_PART_OTHER + 1;
+	     part < CLOUD_AGNSS_PART_COUNT; part++) {
+		if (strcmp(key, parts[part].name) == 0) {
+			entry = entry_get(part);
+			break;
+		}
+	}
+
+	if (!entry) {
+		return 0;
+	}
+
+	if ((len < offsetof(struct cache_entry, data)) || (len > sizeof(*entry))) {
+		LOG_WRN("Dropping saved A-GNSS %s data of unexpected size: %zu", key, len);
+
+		return 0;
+	}
+
+	ret = read_cb(cb_arg, entry, len);
+	if ((ret != (ssize_t)len) ||
+	    (entry->size != (len - offsetof(struct cache_entry, data)))) {
+		LOG_WRN("Failed to read saved A-GNSS %s data", key);
+
+		memset(entry, 0, sizeof(*entry));
+
+		return 0;
+	}
+
+	return 0;
+}
+
+static void load(void)
+{
+	int err;
+
+	if (loaded) {
+		return;
+	}
+
+	loaded = true;
+
+	err = settings_subsys_init();
+	if (err) {
+		LOG_WRN("settings_subsys_init, error: %d", err);
+
+		return;
+	}
+
+	err = settings_load_subtree_direct(SETTINGS_SUBTREE, settings_load_cb, NULL);
+	if (err) {
+		LOG_WRN("settings_load_subtree_direct, error: %d", err);
+	}
+}
+
+/* Returns true if all satellites of the part request are covered by the entry */
+static bool covers(enum cloud_agnss_part part, const struct cache_entry *entry,
+		   const struct nrf_modem_gnss_agnss_data_frame *part_request)
+{
+	for (uint8_t i = 0; i < part_request->system_count; i++) {
+		const struct nrf_modem_gnss_agnss_system_data_need *need = &part_request->system[i];
+		uint64_t needed = sv_mask_get(part, need);
+		uint64_t covered = 0;
+
+		for (uint8_t j = 0; j < entry->covered.system_count; j++) {
+			if (entry->covered.system[j].system_id == need->system_id) {
+				covered = sv_mask_get(part, &entry->covered.system[j]);
+				break;
+			}
+		}
+
+		if (needed & ~covered) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool cloud_agnss_cache_part_get(enum cloud_agnss_part part,
+				const struct nrf_modem_gnss_agnss_data_frame *request,
+				struct nrf_modem_gnss_agnss_data_frame *part_request)
+{
+	bool needed = false;
+
+	*part_request = *request;
+	part_request->system_count = MIN(request->system_count, ARRAY_SIZE(request->system));
+
+	if (part != CLOUD_AGNSS_PART_OTHER) {
+		part_request->data_flags = 0;
+	} else if (part_request->data_flags) {
+		needed = true;
+	}
+
+	for (uint8_t i = 0; i < part_request->system_count; i++) {
+		struct nrf_modem_gnss_agnss_system_data_need *system = &part_request->system[i];
+
+		switch (part) {
+		case CLOUD_AGNSS_PART_EPHEMERIDES:
+			system->sv_mask_alm = 0;
+			needed |= (system->sv_mask_ephe != 0);
+			break;
+		case CLOUD_AGNSS_PART_ALMANAC:
+			system->sv_mask_ephe = 0;
+			needed |= (system->sv_mask_alm != 0);
+			break;
+		default:
+			system->sv_mask_ephe = 0;
+			system->sv_mask_alm = 0;
+			break;
+		}
+	}
+
+	return needed;
+}
+
+bool cloud_agnss_cache_lookup(enum cloud_agnss_part part,
+			      const struct nrf_modem_gnss_agnss_data_frame *part_request,
+			      const char **data, size_t *size)
+{
+	int err;
+	int64_t now_ms;
+	struct cache_entry *entry = entry_get(part);
+
+	if (!entry) {
+		return false;
+	}
+
+	load();
+
+	if ((entry->downloaded_ms == 0) || !covers(part, entry, part_request)) {
+		return false;
+	}
+
+	err = date_time_now(&now_ms);
+	if (err) {
+		LOG_DBG("No valid date and time, cached A-GNSS data not used");
+
+		return false;
+	}
+
+	if ((now_ms < entry->downloaded_ms) ||
+	    ((now_ms - entry->downloaded_ms) >= parts[part].validity_ms)) {
+		LOG_DBG("Cached A-GNSS %s data expired", parts[part].name);
+
+		return false;
+	}
+
+	*data = entry->data;
+	*size = entry->size;
+
+	LOG_DBG("A-GNSS cache hit for %s data, size: %u bytes", parts[part].name, entry->size);
+
+	return true;
+}
+
+void cloud_agnss_cache_add(enum cloud_agnss_part part,
+			   const struct nrf_modem_gnss_agnss_data_frame *part_request,
+			   const char *data, size_t size)
+{
+	int err;
+	int64_t now_ms;
+	char key[sizeof(SETTINGS_SUBTREE "/") + sizeof("ephe")];
+	struct cache_entry *entry = entry_get(part);
+
+	if (!entry) {
+		return;
+	}
+
+	load();
+
+	if ((size == 0) || (size > sizeof(entry->data))) {
+		LOG_DBG("A-GNSS %s data of %zu bytes not cached", parts[part].name, size);
+
+		return;
+	}
+
+	err = date_time_now(&now_ms);
+	if (err) {
+		LOG_DBG("No valid date and time, A-GNSS data not cached");
+
+		return;
+	}
+
+	entry->downloaded_ms = now_ms;
+	entry->covered = *part_request;
+	entry->size = (uint16_t)size;
+	memcpy(entry->data, data, size);
+
+	(void)snprintk(key, sizeof(key), "%s/%s", SETTINGS_SUBTREE, parts[part].name);
+
+	err = settings_save_one(key, entry, offsetof(struct cache_entry, data) + size);
+	if (err) {
+		LOG_WRN("settings_save_one, error: %d", err);
+	}
+}
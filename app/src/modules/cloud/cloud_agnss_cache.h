@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _CLOUD_AGNSS_CACHE_H_
+#define _CLOUD_AGNSS_CACHE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <nrf_modem_gnss.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Parts of an A-GNSS request that are downloaded separately. */
+enum cloud_agnss_part {
+	/* Time, position, UTC, ionospheric and integrity data, never cached */
+	CLOUD_AGNSS_PART_OTHER,
+
+	/* Ephemerides, cached for CONFIG_APP_CLOUD_AGNSS_CACHE_EPHEMERIS_VALIDITY_MINUTES */
+	CLOUD_AGNSS_PART_EPHEMERIDES,
+
+	/* Almanacs, cached for CONFIG_APP_CLOUD_AGNSS_CACHE_ALMANAC_VALIDITY_HOURS */
+	CLOUD_AGNSS_PART_ALMANAC,
+
+	CLOUD_AGNSS_PART_COUNT,
+};
+
+/**
+ * @brief Get the part of a modem A-GNSS request that covers one assistance data type.
+ *
+ * @param[in] part Part of the request to get.
+ * @param[in] request A-GNSS request from the modem.
+ * @param[out] part_request Request for this part only.
+ *
+ * @return true if the modem requests data of this part, false otherwise.
+ */
+bool cloud_agnss_cache_part_get(enum cloud_agnss_part part,
+				const struct nrf_modem_gnss_agnss_data_frame *request,
+				struct nrf_modem_gnss_agnss_data_frame *part_request);
+
+/**
+ * @brief Look up cached A-GNSS data for a part request.
+ *
+ * There is a hit when the cached data covers all satellites of the part request and has not
+ * expired. The cache is loaded from settings at the first call.
+ *
+ * @param[in] part Part of the request.
+ * @param[in] part_request Request for this part, from cloud_agnss_cache_part_get().
+ * @param[out] data Cached A-GNSS data in nRF Cloud binary format, only set on a hit.
+ * @param[out] size Size of the cached data, only set on a hit.
+ *
+ * @return true on a cache hit, false otherwise.
+ */
+bool cloud_agnss_cache_lookup(enum cloud_agnss_part part,
+			      const struct nrf_modem_gnss_agnss_data_frame *part_request,
+			      const char **data, size_t *size);
+
+/**
+ * @brief Add A-GNSS data downloaded from nRF Cloud for a part request to the cache.
+ *
+ * Replaces the cached data of the part and saves it to settings. Data larger than
+ * CONFIG_APP_CLOUD_AGNSS_CACHE_BUF_SIZE, data of CLOUD_AGNSS_PART_OTHER and data received
+ * without a valid date and time are not cached.
+ *
+ * @param[in] part Part of the request.
+ * @param[in] part_request Request for this part, from cloud_agnss_cache_part_get().
+ * @param[in] data A-GNSS data in nRF Cloud binary format.
+ * @param[in] size Size of the data.
+ */
+void cloud_agnss_cache_add(enum cloud_agnss_part part,
+			   const struct nrf_modem_gnss_agnss_data_frame *part_request,
+			   const char *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOUD_AGNSS_CACHE_H_ */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <net/nrf_cloud.h>
+#include <net/nrf_cloud_codec.h>
+#include <net/nrf_cloud_coap.h>
+
+#include "cloud_batch.h"
+#include "cloud_stats.h"
+
+LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
+
+/* Bulk message holding all pending data messages. Only accessed from the cloud thread. */
+static NRF_CLOUD_OBJ_JSON_DEFINE(bulk_obj);
+
+/* Number of data messages in bulk_obj */
+static size_t bulk_msg_count;
+
+int cloud_batch_obj_add(struct nrf_cloud_obj *msg_obj)
+{
+	int err;
+
+	if (bulk_msg_count == 0) {
+		err = nrf_cloud_obj_bulk_init(&bulk_obj);
+		if (err) {
+			LOG_ERR("nrf_cloud_obj_bulk_init, error: %d", err);
+			return err;
+		}
+	}
+
+	/* On success, the bulk object takes ownership of the message */
+	err = nrf_cloud_obj_bulk_add(&bulk_obj, msg_obj);
+	if (err) {
+		LOG_ERR("nrf_cloud_obj_bulk_add, error: %d", err);
+
+		if (bulk_msg_count == 0) {
+			(void)nrf_cloud_obj_free(&bulk_obj);
+		}
+
+		return err;
+	}
+
+	bulk_msg_count++;
+
+	return 0;
+}
+
+int cloud_batch_sensor_add(const char *app_id, double value, int64_t timestamp_ms)
+{
+	int err;
+	NRF_CLOUD_OBJ_JSON_DEFINE(msg_obj);
+
+	err = nrf_cloud_obj_msg_init(&msg_obj, app_id, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	if (err) {
+		LOG_ERR("nrf_cloud_obj_msg_init, error: %d", err);
+		goto free_msg;
+	}
+
+	err = nrf_cloud_obj_num_add(&msg_obj, NRF_CLOUD_JSON_DATA_KEY, value, false);
+	if (err) {
+		LOG_ERR("nrf_cloud_obj_num_add, error: %d", err);
+		goto free_msg;
+	}
+
+	if (timestamp_ms != NRF_CLOUD_NO_TIMESTAMP) {
+		err = nrf_cloud_obj_ts_add(&msg_obj, timestamp_ms);
+		if (err) {
+			LOG_ERR("nrf_cloud_obj_ts_add, error: %d", err);
+			goto free_msg;
+		}
+	}
+
+	err = cloud_batch_obj_add(&msg_obj);
+	if (err) {
+		goto free_msg;
+	}
+
+	return 0;
+
+free_msg:
+	(void)nrf_cloud_obj_free(&msg_obj);
+
+	return err;
+}
+
+int cloud_batch_send(bool confirmable)
+{
+	int err;
+	int64_t start_ms;
+
+	if (bulk_msg_count == 0) {
+		return 0;
+	}
+
+	LOG_DBG("Sending %zu data messages in one request", bulk_msg_count);
+
+	start_ms = cloud_stats_start();
+	err = nrf_cloud_coap_obj_send(&bulk_obj, confirmable);
+	cloud_stats_record(CLOUD_STATS_BATCH, 0, confirmable, start_ms, err);
+	if (err) {
+		LOG_ERR("nrf_cloud_coap_obj_send, error: %d", err);
+
+		/* Kept, so that the caller can retry or discard it */
+		return err;
+	}
+
+	cloud_batch_discard();
+
+	return 0;
+}
+
+void cloud_batch_discard(void)
+{
+	if (bulk_msg_count == 0) {
+		return;
+	}
+
+	(void)nrf_cloud_obj_free(&bulk_obj);
+
+	bulk_msg_count = 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _CLOUD_BATCH_H_
+#define _CLOUD_BATCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <net/nrf_cloud_codec.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Add an encoded nRF Cloud message to the pending batch.
+ *
+ * On success, the batch takes ownership of the message. On failure, the message is left
+ * to the caller to free.
+ *
+ * @param msg_obj Message object, initialized with nrf_cloud_obj_msg_init()
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int cloud_batch_obj_add(struct nrf_cloud_obj *msg_obj);
+
+/**
+ * @brief Add a sensor value to the pending batch.
+ *
+ * The value is encoded as an nRF Cloud data message and appended to the bulk message that
+ * is sent with cloud_batch_send().
+ *
+ * @param app_id nRF Cloud application ID of the value, for example "TEMP"
+ * @param value Sensor value
+ * @param timestamp_ms Timestamp in milliseconds, or NRF_CLOUD_NO_TIMESTAMP
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int cloud_batch_sensor_add(const char *app_id, double value, int64_t timestamp_ms);
+
+/**
+ * @brief Send all pending messages to the cloud in a single request.
+ *
+ * The pending batch is released when it has been sent. On failure, it is kept so that it
+ * can be sent again, or released with cloud_batch_discard(). Calling this function with no
+ * pending messages is a no-op.
+ *
+ * @param confirmable Whether to use confirmable CoAP messages
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int cloud_batch_send(bool confirmable);
+
+/**
+ * @brief Release all pending messages without sending them.
+ */
+void cloud_batch_discard(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOUD_BATCH_H_ */
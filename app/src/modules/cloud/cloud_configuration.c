@@ -15,14 +15,64 @@
 #include "cloud.h"
 #include "cloud_configuration.h"
 #include "cloud_internal.h"
+#include "cloud_stats.h"
 
 LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
 
 ZBUS_CHAN_DECLARE(cloud_chan);
 
+#if defined(CONFIG_APP_CLOUD_SHADOW_POLL_BACKOFF)
+/* Delta poll backoff, only accessed from the cloud thread.
+ * The delta is polled at every interval-th trigger. The interval doubles with every empty
+ * delta, up to CONFIG_APP_CLOUD_SHADOW_POLL_MAX_INTERVAL, and drops to 1 when the delta
+ * holds changes.
+ */
+static struct {
+	uint8_t interval;
+	uint8_t skipped;
+} delta_poll = {
+	.interval = 1,
+};
+
+static bool delta_poll_skip(void)
+{
+	if ((delta_poll.skipped + 1) < delta_poll.interval) {
+		delta_poll.skipped++;
+
+		LOG_DBG("Shadow delta poll skipped (%d/%d)", delta_poll.skipped,
+			delta_poll.interval);
+
+		return true;
+	}
+
+	delta_poll.skipped = 0;
+
+	return false;
+}
+
+static void delta_poll_result(bool empty)
+{
+	if (empty) {
+		delta_poll.interval = MIN(delta_poll.interval * 2,
+					  CONFIG_APP_CLOUD_SHADOW_POLL_MAX_INTERVAL);
+	} else {
+		delta_poll.interval = 1;
+	}
+}
+#endif /* CONFIG_APP_CLOUD_SHADOW_POLL_BACKOFF */
+
+void cloud_configuration_poll_reset(void)
+{
+#if defined(CONFIG_APP_CLOUD_SHADOW_POLL_BACKOFF)
+	delta_poll.interval = 1;
+	delta_poll.skipped = 0;
+#endif /* CONFIG_APP_CLOUD_SHADOW_POLL_BACKOFF */
+}
+
 int cloud_configuration_poll(enum shadow_poll_type type)
 {
 	int err;
+	int64_t start_ms;
 	bool delta = (type == SHADOW_POLL_DELTA);
 	struct cloud_msg msg = {
 		.type = delta ? CLOUD_SHADOW_RESPONSE_DELTA : CLOUD_SHADOW_RESPONSE_DESIRED,
@@ -31,13 +81,22 @@ int cloud_configuration_poll(enum shadow_poll_type type)
 		},
 	};
 
+#if defined(CONFIG_APP_CLOUD_SHADOW_POLL_BACKOFF)
+	if (delta && delta_poll_skip()) {
+		return 0;
+	}
+#endif /* CONFIG_APP_CLOUD_SHADOW_POLL_BACKOFF */
+
 	LOG_DBG("Configuration: Requesting device shadow %s from cloud",
 		delta ? "delta" : "desired");
 
+	start_ms = cloud_stats_start();
 	err = nrf_cloud_coap_shadow_get(msg.response.buffer,
 					&msg.response.buffer_data_len,
 					delta,
 					COAP_CONTENT_FORMAT_APP_CBOR);
+	cloud_stats_record(CLOUD_STATS_SHADOW, err ? 0 : msg.response.buffer_data_len, true,
+			   start_ms, err);
 	if (err) {
 		LOG_ERR("nrf_cloud_coap_shadow_get, error: %d", err);
 		return err;
@@ -57,6 +116,12 @@ int cloud_configuration_poll(enum shadow_poll_type type)
 		return -ENODATA;
 	}
 
+#if defined(CONFIG_APP_CLOUD_SHADOW_POLL_BACKOFF)
+	if (delta) {
+		delta_poll_result(msg.type == CLOUD_SHADOW_RESPONSE_EMPTY_DELTA);
+	}
+#endif /* CONFIG_APP_CLOUD_SHADOW_POLL_BACKOFF */
+
 	err = zbus_chan_pub(&cloud_chan, &msg, PUB_TIMEOUT);
 	if (err) {
 		LOG_ERR("zbus_chan_pub, error: %d", err);
@@ -70,10 +135,16 @@ int cloud_configuration_poll(enum shadow_poll_type type)
  * cloud_configuration_reported_set() is used to clear the existing reported/config section in the
  * shadow and replace it with the new configuration. This is used when reporting the full device
  * configuration to the shadow.
+ *
+ * Stale configuration values can only come from an earlier firmware, and a firmware update
+ * always reboots the device. The section is therefore only cleared at the first report after
+ * boot, later reports are a single PATCH.
  */
 int cloud_configuration_reported_set(const uint8_t *buffer, size_t buffer_len)
 {
 	int err;
+	int64_t start_ms;
+	static bool reported_cleared;
 
 	if (!buffer || buffer_len == 0) {
 		return -EINVAL;
@@ -90,17 +161,26 @@ int cloud_configuration_reported_set(const uint8_t *buffer, size_t buffer_len)
 		0xF6                                /* null */
 	};
 
-	err = nrf_cloud_coap_patch("state/reported", NULL, clear_reported_payload,
-				   sizeof(clear_reported_payload), COAP_CONTENT_FORMAT_APP_CBOR,
-				   true, NULL, NULL);
-	if (err) {
-		LOG_ERR("nrf_cloud_coap_patch (clear reported), error: %d", err);
-		return err;
+	if (!reported_cleared) {
+		start_ms = cloud_stats_start();
+		err = nrf_cloud_coap_patch("state/reported", NULL, clear_reported_payload,
+					   sizeof(clear_reported_payload),
+					   COAP_CONTENT_FORMAT_APP_CBOR, true, NULL, NULL);
+		cloud_stats_record(CLOUD_STATS_SHADOW, sizeof(clear_reported_payload), true,
+				   start_ms, err);
+		if (err) {
+			LOG_ERR("nrf_cloud_coap_patch (clear reported), error: %d", err);
+			return err;
+		}
+
+		reported_cleared = true;
 	}
 
 	/* Update the reported section with the new configuration */
+	start_ms = cloud_stats_start();
 	err = nrf_cloud_coap_patch("state/reported", NULL, buffer, buffer_len,
 				   COAP_CONTENT_FORMAT_APP_CBOR, true, NULL, NULL);
+	cloud_stats_record(CLOUD_STATS_SHADOW, buffer_len, true, start_ms, err);
 	if (err) {
 		LOG_ERR("nrf_cloud_coap_patch (config report), error: %d", err);
 		return err;
@@ -117,6 +197,7 @@ int cloud_configuration_reported_set(const uint8_t *buffer, size_t buffer_len)
 int cloud_configuration_reported_update(const uint8_t *buffer, size_t buffer_len)
 {
 	int err;
+	int64_t start_ms;
 
 	if (!buffer || buffer_len == 0) {
 		return -EINVAL;
@@ -124,8 +205,10 @@ int cloud_configuration_reported_update(const uint8_t *buffer, size_t buffer_len
 
 	LOG_DBG("Configuration: Reporting delta config to cloud");
 
+	start_ms = cloud_stats_start();
 	err = nrf_cloud_coap_patch("state/reported", NULL, buffer, buffer_len,
 				   COAP_CONTENT_FORMAT_APP_CBOR, true, NULL, NULL);
+	cloud_stats_record(CLOUD_STATS_SHADOW, buffer_len, true, start_ms, err);
 	if (err) {
 		LOG_ERR("nrf_cloud_coap_patch (delta config report), error: %d", err);
 		return err;
@@ -32,12 +32,23 @@ enum shadow_poll_type {
  * - CLOUD_SHADOW_RESPONSE_DESIRED or CLOUD_SHADOW_RESPONSE_EMPTY_DESIRED (for desired section)
  * - CLOUD_SHADOW_RESPONSE_DELTA or CLOUD_SHADOW_RESPONSE_EMPTY_DELTA (for delta section)
  *
+ * With CONFIG_APP_CLOUD_SHADOW_POLL_BACKOFF, a delta poll may be skipped without a response
+ * if the previous delta polls were empty, see cloud_configuration_poll_reset().
+ *
  * @param type Type of shadow section to poll (SHADOW_POLL_DELTA or SHADOW_POLL_DESIRED)
  *
  * @return 0 on success, negative error code on failure
  */
 int cloud_configuration_poll(enum shadow_poll_type type);
 
+/**
+ * @brief Poll the shadow delta at the next poll trigger.
+ *
+ * With CONFIG_APP_CLOUD_SHADOW_POLL_BACKOFF, delta polls are skipped while the delta stays
+ * empty. This restarts polling at every trigger, for example after a new connection.
+ */
+void cloud_configuration_poll_reset(void);
+
 /**
  * @brief Set the reported section of the device shadow.
  *
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <math.h>
+
+#include "cloud_dedup.h"
+
+LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
+
+/* Reference sample of a data type that new samples are compared against */
+struct dedup_ref {
+	bool valid;
+
+	/* Samples suppressed since the reference sample was sent */
+	uint16_t suppressed;
+
+	union {
+		IF_ENABLED(CONFIG_APP_POWER, (double percentage;))
+		IF_ENABLED(CONFIG_APP_ENVIRONMENTAL, (struct {
+			double temperature;
+			double humidity;
+			double pressure;
+		} env;))
+	};
+};
+
+/* Per type references, only accessed from the cloud thread.
+ * sent_* hold the last sample that was sent, pending_* the last sample that was checked and
+ * is about to be sent.
+ */
+#if defined(CONFIG_APP_POWER)
+static struct dedup_ref sent_battery;
+static struct dedup_ref pending_battery;
+#endif /* CONFIG_APP_POWER */
+
+#if defined(CONFIG_APP_ENVIRONMENTAL)
+static struct dedup_ref sent_env;
+static struct dedup_ref pending_env;
+#endif /* CONFIG_APP_ENVIRONMENTAL */
+
+static bool within(double value, double ref, double deadband)
+{
+	double diff = value - ref;
+
+	/* A reading that is not available is only a repeat of another one that is not */
+	if (isnan(value) || isnan(ref)) {
+		return isnan(value) && isnan(ref);
+	}
+
+	return ((diff < 0) ? -diff : diff) <= deadband;
+}
+
+/* Returns true if the sample is suppressed, otherwise the sample becomes the pending reference */
+static bool check_ref(struct dedup_ref *pending, bool repeat, const struct dedup_ref *sample)
+{
+	if (pending->valid && repeat &&
+	    (pending->suppressed < CONFIG_APP_CLOUD_DEDUP_MAX_SUPPRESSED)) {
+		pending->suppressed++;
+
+		return true;
+	}
+
+	*pending = *sample;
+	pending->valid = true;
+	pending->suppressed = 0;
+
+	return false;
+}
+
+bool cloud_dedup_suppress(const struct storage_data_item *item)
+{
+	struct dedup_ref sample;
+	bool repeat;
+
+#if defined(CONFIG_APP_POWER)
+	if (item->type == STORAGE_TYPE_BATTERY) {
+		sample.percentage = item->data.BATTERY.percentage;
+
+		repeat = within(sample.percentage, pending_battery.percentage,
+				CONFIG_APP_CLOUD_DEDUP_BATTERY_DEADBAND);
+
+		if (check_ref(&pending_battery, repeat, &sample)) {
+			LOG_DBG("Battery sample suppressed: %.1f%%", sample.percentage);
+
+			return true;
+		}
+
+		return false;
+	}
+#endif /* CONFIG_APP_POWER */
+
+#if defined(CONFIG_APP_ENVIRONMENTAL)
+	if (item->type == STORAGE_TYPE_ENVIRONMENTAL) {
+		const struct environmental_msg *env = &item->data.ENVIRONMENTAL;
+
+		/* Summaries are already reduced and always sent */
+		if (env->type == ENVIRONMENTAL_SENSOR_SUMMARY) {
+			return false;
+		}
+
+		sample.env.temperature = env->temperature;
+		sample.env.humidity = env->humidity;
+		sample.env.pressure = env->pressure;
+
+		/* Temperature and humidity deadbands are configured in tenths */
+		repeat = within(env->temperature, pending_env.env.temperature,
+				CONFIG_APP_CLOUD_DEDUP_TEMPERATURE_DEADBAND / 10.0) &&
+			 within(env->humidity, pending_env.env.humidity,
+				CONFIG_APP_CLOUD_DEDUP_HUMIDITY_DEADBAND / 10.0) &&
+			 within(env->pressure, pending_env.env.pressure,
+				CONFIG_APP_CLOUD_DEDUP_PRESSURE_DEADBAND);
+
+		if (check_ref(&pending_env, repeat, &sample)) {
+			LOG_DBG("Environmental sample suppressed");
+
+			return true;
+		}
+
+		return false;
+	}
+#endif /* CONFIG_APP_ENVIRONMENTAL */
+
+	/* Unused variables if no deduplicated data sources are enabled */
+	(void)sample;
+	(void)repeat;
+
+	return false;
+}
+
+void cloud_dedup_commit(enum storage_data_type type)
+{
+#if defined(CONFIG_APP_POWER)
+	if (type == STORAGE_TYPE_BATTERY) {
+		sent_battery = pending_battery;
+	}
+#endif /* CONFIG_APP_POWER */
+
+#if defined(CONFIG_APP_ENVIRONMENTAL)
+	if (type == STORAGE_TYPE_ENVIRONMENTAL) {
+		sent_env = pending_env;
+	}
+#endif /* CONFIG_APP_ENVIRONMENTAL */
+
+	(void)type;
+}
+
+void cloud_dedup_rollback(void)
+{
+#if defined(CONFIG_APP_POWER)
+	pending_battery = sent_battery;
+#endif /* CONFIG_APP_POWER */
+
+#if defined(CONFIG_APP_ENVIRONMENTAL)
+	pending_env = sent_env;
+#endif /* CONFIG_APP_ENVIRONMENTAL */
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _CLOUD_DEDUP_H_
+#define _CLOUD_DEDUP_H_
+
+#include <stdbool.h>
+#include <zephyr/toolchain.h>
+
+#include "storage.h"
+#include "storage_data_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_APP_CLOUD_DEDUP)
+/**
+ * @brief Check whether a stored sample is a repeat of the last sample sent of its type.
+ *
+ * A battery or environmental sample is a repeat when all its values are within the
+ * configured deadbands of the last sample sent. At most CONFIG_APP_CLOUD_DEDUP_MAX_SUPPRESSED
+ * repeats in a row are suppressed. A sample that is not suppressed becomes the reference
+ * for the next samples of its type, once it is committed with cloud_dedup_commit().
+ * Other data types are never suppressed.
+ *
+ * @param item Storage item to check
+ *
+ * @return true if the sample can be dropped without sending it, false if it must be sent
+ */
+bool cloud_dedup_suppress(const struct storage_data_item *item);
+
+/**
+ * @brief Commit the samples of a type checked since the last commit as sent.
+ *
+ * @param type Storage data type of the sent samples
+ */
+void cloud_dedup_commit(enum storage_data_type type);
+
+/**
+ * @brief Forget the samples checked since the last commit, because they were not sent.
+ */
+void cloud_dedup_rollback(void);
+#else
+static inline bool cloud_dedup_suppress(const struct storage_data_item *item)
+{
+	ARG_UNUSED(item);
+
+	return false;
+}
+
+static inline void cloud_dedup_commit(enum storage_data_type type)
+{
+	ARG_UNUSED(type);
+}
+
+static inline void cloud_dedup_rollback(void)
+{
+}
+#endif /* CONFIG_APP_CLOUD_DEDUP */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOUD_DEDUP_H_ */
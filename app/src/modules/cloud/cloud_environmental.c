@@ -6,42 +6,201 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <math.h>
+#include <net/nrf_cloud.h>
+#include <net/nrf_cloud_codec.h>
 #include <net/nrf_cloud_coap.h>
 
 #include "cloud_environmental.h"
+#include "cloud_batch.h"
 
 LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
 
-int cloud_environmental_send(const struct environmental_msg *env,
-			     int64_t timestamp_ms,
-			     bool confirmable)
+#if defined(CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER)
+/* Extremes of a summary, sent next to the averages with these app IDs */
+#define SUMMARY_READINGS(env)								\
+	{ NRF_CLOUD_JSON_APPID_VAL_TEMP "_MIN", (env)->temperature_range.min },		\
+	{ NRF_CLOUD_JSON_APPID_VAL_TEMP "_MAX", (env)->temperature_range.max },		\
+	{ NRF_CLOUD_JSON_APPID_VAL_AIR_PRESS "_MIN", (env)->pressure_range.min },	\
+	{ NRF_CLOUD_JSON_APPID_VAL_AIR_PRESS "_MAX", (env)->pressure_range.max },	\
+	{ NRF_CLOUD_JSON_APPID_VAL_HUMID "_MIN", (env)->humidity_range.min },		\
+	{ NRF_CLOUD_JSON_APPID_VAL_HUMID "_MAX", (env)->humidity_range.max }
+
+struct summary_reading {
+	const char *app_id;
+	double value;
+};
+#endif /* CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER */
+
+#if defined(CONFIG_APP_CLOUD_ENVIRONMENTAL_COMBINED)
+#define CUSTOM_JSON_APPID_VAL_ENVIRONMENTAL "ENV"
+
+/* Encode all readings of a sample as one message with an object as data:
+ * {"appId":"ENV","messageType":"DATA","data":{"TEMP":..,"AIR_PRESS":..,"HUMID":..},"ts":..}
+ */
+static int combined_msg_add(const struct environmental_msg *env, int64_t timestamp_ms)
 {
 	int err;
+	NRF_CLOUD_OBJ_JSON_DEFINE(msg_obj);
+	NRF_CLOUD_OBJ_JSON_DEFINE(data_obj);
 
-	err = nrf_cloud_coap_sensor_send(NRF_CLOUD_JSON_APPID_VAL_TEMP,
-					 env->temperature,
-					 timestamp_ms,
-					 confirmable);
+	err = nrf_cloud_obj_msg_init(&msg_obj, CUSTOM_JSON_APPID_VAL_ENVIRONMENTAL,
+				     NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
 	if (err) {
-		LOG_ERR("Failed to send temperature data to cloud, error: %d", err);
+		LOG_ERR("nrf_cloud_obj_msg_init, error: %d", err);
 		return err;
 	}
 
-	err = nrf_cloud_coap_sensor_send(NRF_CLOUD_JSON_APPID_VAL_AIR_PRESS,
-					 env->pressure,
-					 timestamp_ms,
-					 confirmable);
+	err = nrf_cloud_obj_init(&data_obj);
+	if (err) {
+		LOG_ERR("nrf_cloud_obj_init, error: %d", err);
+		goto free_msg;
+	}
+
+	err = nrf_cloud_obj_num_add(&data_obj, NRF_CLOUD_JSON_APPID_VAL_TEMP,
+				    env->temperature, false);
+	if (err) {
+		LOG_ERR("nrf_cloud_obj_num_add, error: %d", err);
+		goto free_data;
+	}
+
+	/* Pressure is not available in the low-power sensor profile */
+	if (!isnan(env->pressure)) {
+		err = nrf_cloud_obj_num_add(&data_obj, NRF_CLOUD_JSON_APPID_VAL_AIR_PRESS,
+					    env->pressure, false);
+		if (err) {
+			LOG_ERR("nrf_cloud_obj_num_add, error: %d", err);
+			goto free_data;
+		}
+	}
+
+	err = nrf_cloud_obj_num_add(&data_obj, NRF_CLOUD_JSON_APPID_VAL_HUMID,
+				    env->humidity, false);
+	if (err) {
+		LOG_ERR("nrf_cloud_obj_num_add, error: %d", err);
+		goto free_data;
+	}
+
+#if defined(CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER)
+	if (env->type == ENVIRONMENTAL_SENSOR_SUMMARY) {
+		const struct summary_reading readings[] = { SUMMARY_READINGS(env) };
+
+		for (size_t i = 0; i < ARRAY_SIZE(readings); i++) {
+			if (isnan(readings[i].value)) {
+				continue;
+			}
+
+			err = nrf_cloud_obj_num_add(&data_obj, readings[i].app_id,
+						    readings[i].value, false);
+			if (err) {
+				LOG_ERR("nrf_cloud_obj_num_add, error: %d", err);
+				goto free_data;
+			}
+		}
+	}
+#endif /* CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER */
+
+	/* On success, the message takes ownership of the data object */
+	err = nrf_cloud_obj_object_add(&msg_obj, NRF_CLOUD_JSON_DATA_KEY, &data_obj, false);
+	if (err) {
+		LOG_ERR("nrf_cloud_obj_object_add, error: %d", err);
+		goto free_data;
+	}
+
+	if (timestamp_ms != NRF_CLOUD_NO_TIMESTAMP) {
+		err = nrf_cloud_obj_ts_add(&msg_obj, timestamp_ms);
+		if (err) {
+			LOG_ERR("nrf_cloud_obj_ts_add, error: %d", err);
+			goto free_msg;
+		}
+	}
+
+	err = cloud_batch_obj_add(&msg_obj);
+	if (err) {
+		goto free_msg;
+	}
+
+	return 0;
+
+free_data:
+	(void)nrf_cloud_obj_free(&data_obj);
+free_msg:
+	(void)nrf_cloud_obj_free(&msg_obj);
+
+	return err;
+}
+#endif /* CONFIG_APP_CLOUD_ENVIRONMENTAL_COMBINED */
+
+int cloud_environmental_batch_add(const struct environmental_msg *env, int64_t timestamp_ms)
+{
+#if defined(CONFIG_APP_CLOUD_ENVIRONMENTAL_COMBINED)
+	return combined_msg_add(env, timestamp_ms);
+#else
+	int err;
+
+	err = cloud_batch_sensor_add(NRF_CLOUD_JSON_APPID_VAL_TEMP, env->temperature,
+				     timestamp_ms);
 	if (err) {
-		LOG_ERR("Failed to send pressure data to cloud, error: %d", err);
 		return err;
 	}
 
-	err = nrf_cloud_coap_sensor_send(NRF_CLOUD_JSON_APPID_VAL_HUMID,
-					 env->humidity,
-					 timestamp_ms,
-					 confirmable);
+	/* Pressure is not available in the low-power sensor profile */
+	if (!isnan(env->pressure)) {
+		err = cloud_batch_sensor_add(NRF_CLOUD_JSON_APPID_VAL_AIR_PRESS, env->pressure,
+					     timestamp_ms);
+		if (err) {
+			return err;
+		}
+	}
+
+	err = cloud_batch_sensor_add(NRF_CLOUD_JSON_APPID_VAL_HUMID, env->humidity,
+				     timestamp_ms);
 	if (err) {
-		LOG_ERR("Failed to send humidity data to cloud, error: %d", err);
+		return err;
+	}
+
+#if defined(CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER)
+	if (env->type == ENVIRONMENTAL_SENSOR_SUMMARY) {
+		const struct summary_reading readings[] = { SUMMARY_READINGS(env) };
+
+		for (size_t i = 0; i < ARRAY_SIZE(readings); i++) {
+			if (isnan(readings[i].value)) {
+				continue;
+			}
+
+			err = cloud_batch_sensor_add(readings[i].app_id, readings[i].value,
+						     timestamp_ms);
+			if (err) {
+				return err;
+			}
+		}
+	}
+#endif /* CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER */
+
+	return 0;
+#endif /* CONFIG_APP_CLOUD_ENVIRONMENTAL_COMBINED */
+}
+
+int cloud_environmental_send(const struct environmental_msg *env,
+			     int64_t timestamp_ms,
+			     bool confirmable)
+{
+	int err;
+
+	/* Only called outside of batch uploads, so the pending batch holds this sample only */
+	err = cloud_environmental_batch_add(env, timestamp_ms);
+	if (err) {
+		LOG_ERR("Failed to encode environmental data, error: %d", err);
+		cloud_batch_discard();
+
+		return err;
+	}
+
+	err = cloud_batch_send(confirmable);
+	if (err) {
+		LOG_ERR("Failed to send environmental data to cloud, error: %d", err);
+		cloud_batch_discard();
+
 		return err;
 	}
 
@@ -17,7 +17,8 @@ extern "C" {
 /**
  * @brief Send environmental data to the cloud.
  *
- * Sends temperature, pressure, and humidity data to nRF Cloud.
+ * Sends temperature, pressure, and humidity data to nRF Cloud in a single request.
+ * Must not be called while a batch is pending, see cloud_batch.h.
  *
  * @param env Pointer to environmental message containing sensor data
  * @param timestamp_ms Timestamp in milliseconds, or NRF_CLOUD_NO_TIMESTAMP
@@ -29,6 +30,20 @@ int cloud_environmental_send(const struct environmental_msg *env,
 			     int64_t timestamp_ms,
 			     bool confirmable);
 
+/**
+ * @brief Add environmental data to the pending cloud batch.
+ *
+ * Adds temperature, pressure, and humidity data to the batch that is sent with
+ * cloud_batch_send(). The readings are added as three messages, or as one combined
+ * message with CONFIG_APP_CLOUD_ENVIRONMENTAL_COMBINED.
+ *
+ * @param env Pointer to environmental message containing sensor data
+ * @param timestamp_ms Timestamp in milliseconds, or NRF_CLOUD_NO_TIMESTAMP
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int cloud_environmental_batch_add(const struct environmental_msg *env, int64_t timestamp_ms);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,12 +20,14 @@ extern "C" {
  */
 enum priv_cloud_msg_type {
 	CLOUD_CONNECTION_FAILED,
+	CLOUD_CONNECTION_REJECTED,
 	CLOUD_CONNECTION_SUCCESS,
 	CLOUD_NOT_AUTHENTICATED,
 	CLOUD_PROVISIONING_FINISHED,
 	CLOUD_PROVISIONING_FAILED,
 	CLOUD_BACKOFF_EXPIRED,
 	CLOUD_SEND_REQUEST_FAILED,
+	CLOUD_TXN_WINDOW_EXPIRED,
 };
 
 struct priv_cloud_msg {
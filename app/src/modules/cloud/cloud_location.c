@@ -12,13 +12,20 @@
 
 #include "cloud_location.h"
 #include "cloud_internal.h"
+#include "cloud_policy.h"
+#include "cloud_stats.h"
+#if defined(CONFIG_APP_CLOUD_LOCATION_CACHE)
+#include <date_time.h>
+#include "cloud_location_cache.h"
+#endif /* CONFIG_APP_CLOUD_LOCATION_CACHE */
+#if defined(CONFIG_APP_CLOUD_AGNSS_CACHE)
+#include "cloud_agnss_cache.h"
+#endif /* CONFIG_APP_CLOUD_AGNSS_CACHE */
 #include "app_common.h"
 #include "location.h"
 
 LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
 
-#define AGNSS_MAX_DATA_SIZE 3800
-
 #if defined(CONFIG_LOCATION_METHOD_CELLULAR)
 static int cellular_cell_data_construct(struct lte_lc_cells_info *dest,
 					struct lte_lc_ncell *neighbor_cells,
@@ -136,12 +143,50 @@ static void send_request_failed(void)
 	}
 }
 
+#if defined(CONFIG_APP_CLOUD_LOCATION_CACHE)
+/* Report a cached position to nRF Cloud instead of resolving the request again */
+static void cached_location_send(const struct cloud_location_cache_position *position)
+{
+	int err;
+	int64_t start_ms;
+	bool confirmable = cloud_policy_confirmable(CLOUD_POLICY_DATA_CRITICAL);
+	struct nrf_cloud_gnss_data gnss_data = {
+		.type = NRF_CLOUD_GNSS_TYPE_PVT,
+		.pvt = {
+			.lat = position->lat,
+			.lon = position->lon,
+			.accuracy = (float)position->unc,
+		}
+	};
+
+	err = date_time_now(&gnss_data.ts_ms);
+	if (err) {
+		gnss_data.ts_ms = NRF_CLOUD_NO_TIMESTAMP;
+	}
+
+	start_ms = cloud_stats_start();
+	err = nrf_cloud_coap_location_send(&gnss_data, confirmable);
+	cloud_stats_record(CLOUD_STATS_LOCATION, 0, confirmable, start_ms, err);
+	cloud_policy_send_result(confirmable, err);
+	if (err) {
+		LOG_ERR("nrf_cloud_coap_location_send, error: %d", err);
+
+		send_request_failed();
+		return;
+	}
+
+	LOG_DBG("Cached location sent to nRF Cloud");
+}
+#endif /* CONFIG_APP_CLOUD_LOCATION_CACHE */
+
 /* Handle cloud location requests from the location module */
 static void handle_cloud_location_request(const struct location_cloud_request_data *request)
 {
 	int err;
+	int64_t start_ms;
 	struct nrf_cloud_location_config loc_config = {
-		.do_reply = false,
+		/* The resolved position is only needed to fill the location cache */
+		.do_reply = IS_ENABLED(CONFIG_APP_CLOUD_LOCATION_CACHE),
 	};
 	struct nrf_cloud_coap_location_request loc_req = {
 		.config = &loc_config,
@@ -150,6 +195,15 @@ static void handle_cloud_location_request(const struct location_cloud_request_da
 
 	LOG_DBG("Handling cloud location request");
 
+#if defined(CONFIG_APP_CLOUD_LOCATION_CACHE)
+	struct cloud_location_cache_position position;
+
+	if (cloud_location_cache_lookup(request, &position)) {
+		cached_location_send(&position);
+		return;
+	}
+#endif /* CONFIG_APP_CLOUD_LOCATION_CACHE */
+
 #if defined(CONFIG_LOCATION_METHOD_CELLULAR)
 	struct lte_lc_cells_info cell_info = { 0 };
 	struct lte_lc_ncell neighbor_cells[CONFIG_LTE_NEIGHBOR_CELLS_MAX];
@@ -195,7 +249,9 @@ static void handle_cloud_location_request(const struct location_cloud_request_da
 		return;
 	}
 
+	start_ms = cloud_stats_start();
 	err = nrf_cloud_coap_location_get(&loc_req, &result);
+	cloud_stats_record(CLOUD_STATS_LOCATION_GET, 0, true, start_ms, err);
 	if ((err == COAP_RESPONSE_CODE_NOT_FOUND) || (err == COAP_RESPONSE_CODE_BAD_REQUEST)) {
 		LOG_WRN("nRF Cloud CoAP location coordinates not found, error: %d", err);
 
@@ -206,14 +262,26 @@ static void handle_cloud_location_request(const struct location_cloud_request_da
 		send_request_failed();
 		return;
 	}
+
+#if defined(CONFIG_APP_CLOUD_LOCATION_CACHE)
+	position.lat = result.lat;
+	position.lon = result.lon;
+	position.unc = result.unc;
+
+	cloud_location_cache_add(request, &position);
+#endif /* CONFIG_APP_CLOUD_LOCATION_CACHE */
 }
 
 #if defined(CONFIG_NRF_CLOUD_AGNSS)
-/* Handle A-GNSS data requests from the location module */
-static void handle_agnss_request(const struct nrf_modem_gnss_agnss_data_frame *request)
+/* Download A-GNSS data from nRF Cloud into buf and inject it into the modem.
+ *
+ * Returns the size of the received data, or a negative errno on failure.
+ */
+static int agnss_data_download(const struct nrf_modem_gnss_agnss_data_frame *request,
+			       char *buf, size_t buf_sz)
 {
 	int err;
-	static char agnss_buf[AGNSS_MAX_DATA_SIZE];
+	int64_t start_ms;
 	struct nrf_cloud_coap_agnss_request agnss_req = {
 		.type = NRF_CLOUD_COAP_AGNSS_REQ_CUSTOM,
 		.agnss_req = (struct nrf_modem_gnss_agnss_data_frame *)request,
@@ -222,20 +290,20 @@ static void handle_agnss_request(const struct nrf_modem_gnss_agnss_data_frame *r
 		.mask_angle = 0
 	};
 	struct nrf_cloud_coap_agnss_result result = {
-		.buf = agnss_buf,
-		.buf_sz = sizeof(agnss_buf),
+		.buf = buf,
+		.buf_sz = buf_sz,
 		.agnss_sz = 0
 	};
 
-	LOG_DBG("Handling A-GNSS data request");
-
 	/* Send A-GNSS request to nRF Cloud */
+	start_ms = cloud_stats_start();
 	err = nrf_cloud_coap_agnss_data_get(&agnss_req, &result);
+	cloud_stats_record(CLOUD_STATS_AGNSS, err ? 0 : result.agnss_sz, true, start_ms, err);
 	if (err) {
 		LOG_ERR("nrf_cloud_coap_agnss_data_get, error: %d", err);
 
 		send_request_failed();
-		return;
+		return err;
 	}
 
 	LOG_DBG("A-GNSS data received, size: %d bytes", result.agnss_sz);
@@ -244,11 +312,85 @@ static void handle_agnss_request(const struct nrf_modem_gnss_agnss_data_frame *r
 	err = location_agnss_data_process(result.buf, result.agnss_sz);
 	if (err) {
 		LOG_ERR("Failed to process A-GNSS data, error: %d", err);
-		return;
+		return err;
 	}
 
 	LOG_DBG("A-GNSS data processed successfully");
+
+	return result.agnss_sz;
+}
+
+#if defined(CONFIG_APP_CLOUD_AGNSS_CACHE)
+/* Handle A-GNSS data requests from the location module.
+ *
+ * The request is split into time and other short-lived data, ephemerides and almanacs.
+ * Ephemerides and almanacs that are cached and still valid are injected without a download,
+ * the other parts are downloaded and cached.
+ */
+static void handle_agnss_request(const struct nrf_modem_gnss_agnss_data_frame *request)
+{
+	int ret;
+	char *buf = NULL;
+
+	LOG_DBG("Handling A-GNSS data request");
+
+	for (enum cloud_agnss_part part = CLOUD_AGNSS_PART_OTHER;
+	     part < CLOUD_AGNSS_PART_COUNT; part++) {
+		struct nrf_modem_gnss_agnss_data_frame part_request;
+		const char *data;
+		size_t size;
+
+		if (!cloud_agnss_cache_part_get(part, request, &part_request)) {
+			continue;
+		}
+
+		if (cloud_agnss_cache_lookup(part, &part_request, &data, &size)) {
+			ret = location_agnss_data_process(data, size);
+			if (ret == 0) {
+				continue;
+			}
+
+			LOG_WRN("Failed to process cached A-GNSS data, error: %d", ret);
+		}
+
+		if (!buf) {
+			buf = k_malloc(CONFIG_APP_CLOUD_AGNSS_BUF_SIZE);
+			if (!buf) {
+				LOG_ERR("Failed to allocate A-GNSS buffer");
+				return;
+			}
+		}
+
+		ret = agnss_data_download(&part_request, buf, CONFIG_APP_CLOUD_AGNSS_BUF_SIZE);
+		if (ret < 0) {
+			break;
+		}
+
+		cloud_agnss_cache_add(part, &part_request, buf, ret);
+	}
+
+	k_free(buf);
+}
+#else
+/* Handle A-GNSS data requests from the location module */
+static void handle_agnss_request(const struct nrf_modem_gnss_agnss_data_frame *request)
+{
+	char *buf;
+
+	LOG_DBG("Handling A-GNSS data request");
+
+	/* The buffer is only allocated while a request is handled */
+	buf = k_malloc(CONFIG_APP_CLOUD_AGNSS_BUF_SIZE);
+	if (!buf) {
+		LOG_ERR("Failed to allocate A-GNSS buffer");
+		return;
+	}
+
+	(void)agnss_data_download(request, buf, CONFIG_APP_CLOUD_AGNSS_BUF_SIZE);
+
+	k_free(buf);
 }
+#endif /* CONFIG_APP_CLOUD_AGNSS_CACHE */
 #endif /* CONFIG_NRF_CLOUD_AGNSS */
 
 #if defined(CONFIG_LOCATION_METHOD_GNSS)
@@ -259,8 +401,9 @@ static void handle_agnss_request(const struct nrf_modem_gnss_agnss_data_frame *r
 static int handle_gnss_location_data(const struct location_msg *location_msg)
 {
 	int err;
-	bool confirmable = IS_ENABLED(CONFIG_APP_CLOUD_CONFIRMABLE_MESSAGES);
-	const struct location_data *location_data = &location_msg->gnss_data;
+	int64_t start_ms;
+	bool confirmable = cloud_policy_confirmable(CLOUD_POLICY_DATA_CRITICAL);
+	const struct location_gnss_data *location_data = &location_msg->gnss_data;
 
 	struct nrf_cloud_gnss_data gnss_data = {
 		.type = NRF_CLOUD_GNSS_TYPE_PVT,
@@ -277,26 +420,19 @@ static int handle_gnss_location_data(const struct location_msg *location_msg)
 		(double)location_data->longitude,
 		(double)location_data->accuracy);
 
-#if defined(CONFIG_LOCATION_DATA_DETAILS)
-#define CLOUD_GNSS_HEADING_ACC_LIMIT (float)60.0
-
-	struct location_data_details_gnss gnss = location_data->details.gnss;
-
-	/* If detailed GNSS data is available, include altitude, speed, and heading */
-	if (gnss.pvt_data.flags & NRF_MODEM_GNSS_PVT_FLAG_FIX_VALID) {
-		gnss_data.pvt.alt = gnss.pvt_data.altitude;
-		gnss_data.pvt.speed = gnss.pvt_data.speed;
-		gnss_data.pvt.heading = gnss.pvt_data.heading;
-		gnss_data.pvt.has_alt = 1;
-		gnss_data.pvt.has_speed =
-			(gnss.pvt_data.flags & NRF_MODEM_GNSS_PVT_FLAG_VELOCITY_VALID) ? 1 : 0;
-		gnss_data.pvt.has_heading =
-			(gnss.pvt_data.heading_accuracy < CLOUD_GNSS_HEADING_ACC_LIMIT) ? 1 : 0;
-	}
-#endif /* CONFIG_LOCATION_DATA_DETAILS */
+	/* Altitude, speed and heading are only included when valid */
+	gnss_data.pvt.alt = location_data->altitude;
+	gnss_data.pvt.speed = location_data->speed;
+	gnss_data.pvt.heading = location_data->heading;
+	gnss_data.pvt.has_alt = (location_data->flags & LOCATION_GNSS_HAS_ALTITUDE) ? 1 : 0;
+	gnss_data.pvt.has_speed = (location_data->flags & LOCATION_GNSS_HAS_SPEED) ? 1 : 0;
+	gnss_data.pvt.has_heading = (location_data->flags & LOCATION_GNSS_HAS_HEADING) ? 1 : 0;
 
 	/* Send GNSS location data to nRF Cloud */
+	start_ms = cloud_stats_start();
 	err = nrf_cloud_coap_location_send(&gnss_data, confirmable);
+	cloud_stats_record(CLOUD_STATS_LOCATION, 0, confirmable, start_ms, err);
+	cloud_policy_send_result(confirmable, err);
 	if (err) {
 		LOG_ERR("nrf_cloud_coap_location_send, error: %d", err);
 		send_request_failed();
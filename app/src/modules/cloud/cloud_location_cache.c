@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <modem/lte_lc.h>
+#include <string.h>
+
+#include "cloud_location_cache.h"
+
+LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
+
+#define SETTINGS_KEY		"att_cloud/loc_cache"
+#define WIFI_APS_IN_KEY		3
+
+struct cache_entry {
+	/* Fingerprint of the request, 0 for an unused entry */
+	uint32_t key;
+
+	/* Value of use_counter when the entry was last used */
+	uint32_t last_used;
+
+	struct cloud_location_cache_position position;
+};
+
+/* Only accessed from the cloud thread */
+static struct cache_entry entries[CONFIG_APP_CLOUD_LOCATION_CACHE_ENTRIES];
+static uint32_t use_counter;
+static bool loaded;
+
+/* 32-bit FNV-1a hash */
+static uint32_t hash_update(uint32_t hash, const void *data, size_t len)
+{
+	const uint8_t *bytes = data;
+
+	for (size_t i = 0; i < len; i++) {
+		hash ^= bytes[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/* Fingerprint of the serving cell and the strongest Wi-Fi access points. The access points
+ * are hashed in MAC address order, so the scan order does not matter.
+ * Returns 0 if the request has no serving cell and no access points.
+ */
+static uint32_t fingerprint(const struct location_cloud_request_data *request)
+{
+	uint32_t hash = 2166136261U;
+	const struct location_wifi_ap_info *aps[WIFI_APS_IN_KEY];
+	size_t ap_count = 0;
+	bool has_cell = (request->current_cell.id != LTE_LC_CELL_EUTRAN_ID_INVALID);
+
+	if (has_cell) {
+		hash = hash_update(hash, &request->current_cell.mcc,
+				   sizeof(request->current_cell.mcc));
+		hash = hash_update(hash, &request->current_cell.mnc,
+				   sizeof(request->current_cell.mnc));
+		hash = hash_update(hash, &request->current_cell.tac,
+				   sizeof(request->current_cell.tac));
+		hash = hash_update(hash, &request->current_cell.id,
+				   sizeof(request->current_cell.id));
+	}
+
+	/* Insertion sort of the strongest access points by RSSI */
+	for (uint16_t i = 0; i < request->wifi_cnt; i++) {
+		const struct location_wifi_ap_info *ap = &request->wifi_aps[i];
+		size_t pos = ap_count;
+
+		while ((pos > 0) && (aps[pos - 1]->rssi < ap->rssi)) {
+			if (pos < WIFI_APS_IN_KEY) {
+				aps[pos] = aps[pos - 1];
+			}
+
+			pos--;
+		}
+
+		if (pos < WIFI_APS_IN_KEY) {
+			aps[pos] = ap;
+			ap_count = MIN(ap_count + 1, WIFI_APS_IN_KEY);
+		}
+	}
+
+	if (!has_cell && (ap_count == 0)) {
+		return 0;
+	}
+
+	/* Sort the selected access points by MAC address */
+	for (size_t i = 1; i < ap_count; i++) {
+		for (size_t j = i; (j > 0) && (memcmp(aps[j - 1]->mac, aps[j]->mac,
+						      MAC_ADDR_LEN) > 0); j--) {
+			const struct location_wifi_ap_info *tmp = aps[j];
+
+			aps[j] = aps[j - 1];
+			aps[j - 1] = tmp;
+		}
+	}
+
+	for (size_t i = 0; i < ap_count; i++) {
+		hash = hash_update(hash, aps[i]->mac, MAC_ADDR_LEN);
+	}
+
+	/* 0 marks an unused entry */
+	return (hash == 0) ? 1 : hash;
+}
+
+static int settings_load_cb(const char *key, size_t len, settings_read_cb read_cb,
+			    void *cb_arg, void *param)
+{
+	ssize_t ret;
+
+	ARG_UNUSED(key);
+	ARG_UNUSED(param);
+
+	/* Entries saved with another cache size are dropped */
+	if (len != sizeof(entries)) {
+		LOG_WRN("Location cache size changed, dropping saved entries");
+
+		return 0;
+	}
+
+	ret = read_cb(cb_arg, entries, sizeof(entries));
+	if (ret != sizeof(entries)) {
+		LOG_WRN("Failed to read location cache, error: %d", (int)ret);
+
+		memset(entries, 0, sizeof(entries));
+
+		return 0;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		use_counter = MAX(use_counter, entries[i].last_used);
+	}
+
+	return 0;
+}
+
+static void load(void)
+{
+	int err;
+
+	if (loaded) {
+		return;
+	}
+
+	loaded = true;
+
+	err = settings_subsys_init();
+	if (err) {
+		LOG_WRN("settings_subsys_init, error: %d", err);
+
+		return;
+	}
+
+	err = settings_load_subtree_direct(SETTINGS_KEY, settings_load_cb, NULL);
+	if (err) {
+		LOG_WRN("settings_load_subtree_direct, error: %d", err);
+	}
+}
+
+bool cloud_location_cache_lookup(const struct location_cloud_request_data *request,
+				 struct cloud_location_cache_position *position)
+{
+	uint32_t key = fingerprint(request);
+
+	load();
+
+	if (key == 0) {
+		return false;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].key == key) {
+			entries[i].last_used = ++use_counter;
+			*position = entries[i].position;
+
+			LOG_DBG("Location cache hit, key: 0x%08x", key);
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void cloud_location_cache_add(const struct location_cloud_request_data *request,
+			      const struct cloud_location_cache_position *position)
+{
+	int err;
+	uint32_t key = fingerprint(request);
+	struct cache_entry *slot = &entries[0];
+
+	load();
+
+	if (key == 0) {
+		return;
+	}
+
+	/* Reuse the entry of the same fingerprint, or replace the least recently used one */
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		if (entries[i].key == key) {
+			slot = &entries[i];
+			break;
+		}
+
+		if (entries[i].last_used < slot->last_used) {
+			slot = &entries[i];
+		}
+	}
+
+	slot->key = key;
+	slot->last_used = ++use_counter;
+	slot->position = *position;
+
+	LOG_DBG("Location cache add, key: 0x%08x", key);
+
+	err = settings_save_one(SETTINGS_KEY, entries, sizeof(entries));
+	if (err) {
+		LOG_WRN("settings_save_one, error: %d", err);
+	}
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _CLOUD_LOCATION_CACHE_H_
+#define _CLOUD_LOCATION_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "location.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Position resolved by nRF Cloud for a cellular and Wi-Fi fingerprint. */
+struct cloud_location_cache_position {
+	/** Latitude in degrees. */
+	double lat;
+
+	/** Longitude in degrees. */
+	double lon;
+
+	/** Uncertainty radius in meters. */
+	uint32_t unc;
+};
+
+/**
+ * @brief Look up the position of a cloud location request in the cache.
+ *
+ * The fingerprint of a request is the serving cell and the three strongest Wi-Fi access
+ * points. The cache is loaded from settings at the first call.
+ *
+ * @param[in] request Cloud location request from the location module.
+ * @param[out] position Cached position, only set on a hit.
+ *
+ * @return true on a cache hit, false otherwise.
+ */
+bool cloud_location_cache_lookup(const struct location_cloud_request_data *request,
+				 struct cloud_location_cache_position *position);
+
+/**
+ * @brief Add the position resolved by nRF Cloud for a request to the cache.
+ *
+ * The least recently used entry is replaced when the cache is full, and the cache is saved
+ * to settings.
+ *
+ * @param[in] request Cloud location request from the location module.
+ * @param[in] position Position resolved by nRF Cloud.
+ */
+void cloud_location_cache_add(const struct location_cloud_request_data *request,
+			      const struct cloud_location_cache_position *position);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOUD_LOCATION_CACHE_H_ */
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <memfault/core/data_packetizer.h>
+#include <memfault/ports/zephyr/http.h>
+
+#include "cloud_memfault.h"
+
+LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
+
+/* Data sources in the order they are given the budget */
+static const uint32_t sources[] = {
+	kMfltDataSourceMask_Coredump,
+	kMfltDataSourceMask_Event,
+	kMfltDataSourceMask_Cdr,
+	kMfltDataSourceMask_Log,
+};
+
+/* Size of the next message of the active sources, 0 if there is no data */
+static size_t next_message_size(void)
+{
+	const sPacketizerConfig config = {
+		.enable_multi_packet_chunk = true,
+	};
+	sPacketizerMetadata metadata;
+
+	if (!memfault_packetizer_begin(&config, &metadata)) {
+		return 0;
+	}
+
+	/* The message is only looked at, it is read from the start again when it is posted */
+	memfault_packetizer_abort();
+
+	return metadata.single_chunk_message_length;
+}
+
+int cloud_memfault_upload(void)
+{
+	int err;
+	size_t used = 0;
+	uint32_t mask = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(sources); i++) {
+		size_t size;
+
+		memfault_packetizer_set_active_sources(sources[i]);
+
+		size = next_message_size();
+		if (size == 0) {
+			continue;
+		}
+
+		if ((used > 0) && ((used + size) > CONFIG_APP_CLOUD_MEMFAULT_UPLOAD_BUDGET_BYTES)) {
+			LOG_DBG("Memfault source 0x%x (%zu bytes) deferred to the next window",
+				sources[i], size);
+			continue;
+		}
+
+		used += size;
+		mask |= sources[i];
+	}
+
+	if (mask == 0) {
+		memfault_packetizer_set_active_sources(kMfltDataSourceMask_All);
+
+		return 0;
+	}
+
+	LOG_DBG("Uploading Memfault data, sources: 0x%x, about %zu bytes", mask, used);
+
+	memfault_packetizer_set_active_sources(mask);
+
+	err = memfault_zephyr_port_post_data();
+
+	/* Coredumps posted on network connection use all sources */
+	memfault_packetizer_set_active_sources(kMfltDataSourceMask_All);
+
+	if (err) {
+		LOG_WRN("memfault_zephyr_port_post_data, error: %d", err);
+
+		return err;
+	}
+
+	return 0;
+}
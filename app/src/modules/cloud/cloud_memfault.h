@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _CLOUD_MEMFAULT_H_
+#define _CLOUD_MEMFAULT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Upload pending Memfault data within the byte budget of the upload window.
+ *
+ * Data sources are taken in the order coredumps, events (heartbeats and traces), custom data
+ * recordings and logs. A source is uploaded when its next message fits the remaining budget
+ * of CONFIG_APP_CLOUD_MEMFAULT_UPLOAD_BUDGET_BYTES, the other sources wait for the next
+ * window. The first message is uploaded even if it is larger than the budget, so that no
+ * data is held back forever. Must only be called from the cloud module thread while
+ * connected.
+ *
+ * @retval 0 if the data was uploaded or there was nothing to upload.
+ * @retval -errno if the upload failed, the data is kept for the next window.
+ */
+int cloud_memfault_upload(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOUD_MEMFAULT_H_ */
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+#include <modem/modem_info.h>
+#include <net/nrf_cloud_coap.h>
+
+#include "cloud_network_info.h"
+#include "cloud_stats.h"
+
+LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
+
+#define REFRESH_INTERVAL_MS	((int64_t)CONFIG_APP_CLOUD_NETWORK_INFO_REFRESH_HOURS * \
+				 3600 * MSEC_PER_SEC)
+
+/* Network info fields that a shadow update is needed for when they change.
+ * RSRP is left out on purpose, it changes with every sample and is refreshed periodically.
+ */
+static const enum modem_info fields[] = {
+	MODEM_INFO_CELLID,
+	MODEM_INFO_AREA_CODE,
+	MODEM_INFO_OPERATOR,
+	MODEM_INFO_CUR_BAND,
+	MODEM_INFO_IP_ADDRESS,
+};
+
+/* State of the last successful update, only accessed from the cloud thread */
+static struct {
+	bool valid;
+	uint32_t fingerprint;
+	int64_t timestamp_ms;
+} reported;
+
+/* 32-bit FNV-1a hash, only used to detect changes */
+static uint32_t hash_update(uint32_t hash, const char *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		hash ^= (uint8_t)data[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+/* Calculate a fingerprint of the current network info, returns negative error code if
+ * a field could not be read
+ */
+static int fingerprint_get(uint32_t *fingerprint)
+{
+	char buf[MODEM_INFO_MAX_RESPONSE_SIZE];
+	uint32_t hash = 2166136261U;
+	int ret;
+
+	for (size_t i = 0; i < ARRAY_SIZE(fields); i++) {
+		ret = modem_info_string_get(fields[i], buf, sizeof(buf));
+		if (ret < 0) {
+			LOG_DBG("modem_info_string_get(%d), error: %d", fields[i], ret);
+
+			return ret;
+		}
+
+		/* Include the terminator to keep field boundaries apart */
+		hash = hash_update(hash, buf, strnlen(buf, sizeof(buf) - 1) + 1);
+	}
+
+	*fingerprint = hash;
+
+	return 0;
+}
+
+int cloud_network_info_update(void)
+{
+	int err;
+	uint32_t fingerprint = 0;
+	bool fingerprint_valid;
+	int64_t now = k_uptime_get();
+	int64_t start_ms;
+
+	/* If the network info cannot be read, update anyway and let nRF Cloud sort it out */
+	fingerprint_valid = (fingerprint_get(&fingerprint) == 0);
+
+	if (reported.valid && fingerprint_valid && (reported.fingerprint == fingerprint) &&
+	    ((now - reported.timestamp_ms) < REFRESH_INTERVAL_MS)) {
+		LOG_DBG("Network info unchanged, shadow update skipped");
+
+		return 0;
+	}
+
+	start_ms = cloud_stats_start();
+	err = nrf_cloud_coap_shadow_network_info_update();
+	cloud_stats_record(CLOUD_STATS_SHADOW, 0, true, start_ms, err);
+	if (err) {
+		return err;
+	}
+
+	reported.valid = fingerprint_valid;
+	reported.fingerprint = fingerprint;
+	reported.timestamp_ms = now;
+
+	return 0;
+}
+
+void cloud_network_info_invalidate(void)
+{
+	reported.valid = false;
+}
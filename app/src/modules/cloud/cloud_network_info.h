@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _CLOUD_NETWORK_INFO_H_
+#define _CLOUD_NETWORK_INFO_H_
+
+#include <net/nrf_cloud_coap.h>
+
+#include "cloud_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_APP_CLOUD_NETWORK_INFO_CACHE)
+/**
+ * @brief Update the network info in the reported section of the device shadow if it changed.
+ *
+ * The serving cell, tracking area, operator, band and IP address are read from the modem and
+ * compared with the values at the last update. The shadow is only updated if any of them
+ * changed, if CONFIG_APP_CLOUD_NETWORK_INFO_REFRESH_HOURS passed since the last update, or
+ * after cloud_network_info_invalidate().
+ *
+ * @return 0 on success or if no update was needed, negative error code on failure
+ */
+int cloud_network_info_update(void);
+
+/**
+ * @brief Force the network info to be sent with the next cloud_network_info_update().
+ */
+void cloud_network_info_invalidate(void);
+#else
+static inline int cloud_network_info_update(void)
+{
+	int64_t start_ms = cloud_stats_start();
+	int err = nrf_cloud_coap_shadow_network_info_update();
+
+	cloud_stats_record(CLOUD_STATS_SHADOW, 0, true, start_ms, err);
+
+	return err;
+}
+
+static inline void cloud_network_info_invalidate(void)
+{
+}
+#endif /* CONFIG_APP_CLOUD_NETWORK_INFO_CACHE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOUD_NETWORK_INFO_H_ */
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+#include <modem/modem_info.h>
+
+#include "cloud_policy.h"
+
+LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
+
+/* Number of recent confirmable sends that the ACK success rate is calculated over */
+#define ACK_WINDOW_SIZE		16
+
+/* Minimum number of confirmable sends in the window before the success rate is used */
+#define ACK_WINDOW_MIN		4
+
+/* RSRP index reported by the modem when RSRP is not known */
+#define RSRP_IDX_UNKNOWN	255
+
+BUILD_ASSERT(ACK_WINDOW_SIZE <= 32, "ACK results are kept in a 32-bit mask");
+
+/* Policy state, only accessed from the cloud thread */
+static struct {
+	/* Results of recent confirmable sends, bit set for an acknowledged send */
+	uint32_t ack_mask;
+
+	/* Number of valid results in ack_mask */
+	uint8_t ack_count;
+
+	/* Routine messages sent since the last confirmable routine message */
+	uint8_t routine_since_probe;
+
+	/* Last RSRP sample in dBm */
+	int16_t rsrp_dbm;
+
+	bool rsrp_valid;
+} policy;
+
+static bool link_is_poor(void)
+{
+	if (policy.rsrp_valid &&
+	    (policy.rsrp_dbm < CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE_RSRP_THRESHOLD)) {
+		return true;
+	}
+
+	if (policy.ack_count >= ACK_WINDOW_MIN) {
+		uint32_t acked = POPCOUNT(policy.ack_mask);
+
+		if ((acked * 100) <
+		    (policy.ack_count * CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE_MIN_ACK_PERCENT)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool cloud_policy_confirmable(enum cloud_policy_data_class data_class)
+{
+	if (data_class == CLOUD_POLICY_DATA_CRITICAL) {
+		return true;
+	}
+
+	if (link_is_poor()) {
+		policy.routine_since_probe = 0;
+
+		return true;
+	}
+
+	if (++policy.routine_since_probe >= CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE_PROBE_INTERVAL) {
+		policy.routine_since_probe = 0;
+
+		return true;
+	}
+
+	return false;
+}
+
+void cloud_policy_send_result(bool confirmable, int err)
+{
+	if (!confirmable || (err == -EINVAL) || (err == -ENOTSUP)) {
+		return;
+	}
+
+	policy.ack_mask = (policy.ack_mask << 1) | ((err == 0) ? 1 : 0);
+	policy.ack_mask &= BIT_MASK(ACK_WINDOW_SIZE);
+
+	if (policy.ack_count < ACK_WINDOW_SIZE) {
+		policy.ack_count++;
+	}
+}
+
+void cloud_policy_rsrp_update(int16_t rsrp_idx)
+{
+	if (rsrp_idx == RSRP_IDX_UNKNOWN) {
+		policy.rsrp_valid = false;
+
+		return;
+	}
+
+	policy.rsrp_dbm = RSRP_IDX_TO_DBM(rsrp_idx);
+	policy.rsrp_valid = true;
+
+	LOG_DBG("Link RSRP: %d dBm", policy.rsrp_dbm);
+}
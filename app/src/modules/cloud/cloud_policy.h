@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _CLOUD_POLICY_H_
+#define _CLOUD_POLICY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <zephyr/toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Importance of data sent to the cloud. */
+enum cloud_policy_data_class {
+	/* Periodic telemetry that is resampled soon, for example battery and environmental */
+	CLOUD_POLICY_DATA_ROUTINE,
+
+	/* Data that must not be lost, for example location fixes and application messages */
+	CLOUD_POLICY_DATA_CRITICAL,
+};
+
+#if defined(CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE)
+/**
+ * @brief Choose whether the next message of a data class is sent as a confirmable message.
+ *
+ * Critical data is always confirmable. Routine data is confirmable only when the link is
+ * poor, based on the last RSRP sample and on the ACK success rate of recent confirmable
+ * messages. Every CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE_PROBE_INTERVAL routine message is
+ * confirmable to keep the ACK success rate up to date.
+ *
+ * @param data_class Importance of the data
+ *
+ * @return true to send a confirmable message, false to send a non-confirmable message
+ */
+bool cloud_policy_confirmable(enum cloud_policy_data_class data_class);
+
+/**
+ * @brief Report the result of a send.
+ *
+ * Only confirmable sends are taken into account. Data errors (-EINVAL, -ENOTSUP) are ignored.
+ *
+ * @param confirmable Whether the message was sent as a confirmable message
+ * @param err Result of the send, 0 if the message was acknowledged
+ */
+void cloud_policy_send_result(bool confirmable, int err);
+
+/**
+ * @brief Update the link quality with a new RSRP sample.
+ *
+ * @param rsrp_idx RSRP index as reported by the modem, 255 if unknown
+ */
+void cloud_policy_rsrp_update(int16_t rsrp_idx);
+#else
+static inline bool cloud_policy_confirmable(enum cloud_policy_data_class data_class)
+{
+	ARG_UNUSED(data_class);
+
+	return IS_ENABLED(CONFIG_APP_CLOUD_CONFIRMABLE_MESSAGES);
+}
+
+static inline void cloud_policy_send_result(bool confirmable, int err)
+{
+	ARG_UNUSED(confirmable);
+	ARG_UNUSED(err);
+}
+
+static inline void cloud_policy_rsrp_update(int16_t rsrp_idx)
+{
+	ARG_UNUSED(rsrp_idx);
+}
+#endif /* CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOUD_POLICY_H_ */
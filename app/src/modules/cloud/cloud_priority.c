@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+#include <net/nrf_cloud.h>
+#include <net/nrf_cloud_coap.h>
+#include <net/nrf_cloud_defs.h>
+#include <date_time.h>
+#include <math.h>
+
+#include "cloud.h"
+#include "cloud_policy.h"
+#include "cloud_stats.h"
+#include "cloud_priority.h"
+
+LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
+
+/* Large enough for a geofence event with a timestamp */
+#define GEOFENCE_EVENT_BUFFER_SIZE 128
+
+#define GEOFENCE_EVENT_FORMAT \
+	"{\"appId\":\"GEOFENCE\",\"messageType\":\"DATA\",\"data\":{\"id\":%u,\"event\":\"%s\"}"
+
+/* Events waiting to be sent. Filled by the listener in the context of the publisher, so that
+ * events are queued while the cloud module thread is blocked in a storage batch session.
+ */
+K_MSGQ_DEFINE(priority_queue, sizeof(struct cloud_priority_msg),
+	      CONFIG_APP_CLOUD_PRIORITY_QUEUE_SIZE, 4);
+
+static void priority_listener_cb(const struct zbus_channel *chan)
+{
+	const struct cloud_priority_msg *msg = zbus_chan_const_msg(chan);
+
+	/* Queued events are only removed by the cloud module thread once they have been sent */
+	if (k_msgq_put(&priority_queue, msg, K_NO_WAIT)) {
+		LOG_WRN("Priority queue full, dropping event of type %d", msg->type);
+	}
+}
+
+ZBUS_LISTENER_DEFINE(cloud_priority_listener, priority_listener_cb);
+
+/* Progress of the event at the head of the queue, reset when the event is removed. Only
+ * accessed from the cloud module thread.
+ */
+static struct {
+	/* Failed attempts to send the event */
+	uint8_t attempts;
+
+	/* Environmental readings that have already been sent */
+	uint8_t readings_sent;
+} head;
+
+/* The cloud module subscriber observes the channel as well, to be woken up when idle. It is
+ * added with a lower priority in cloud.c, so the event is queued before the thread runs.
+ */
+ZBUS_CHAN_DEFINE(cloud_priority_chan,
+		 struct cloud_priority_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS(cloud_priority_listener),
+		 ZBUS_MSG_INIT(0)
+);
+
+static int geofence_event_send(const struct cloud_priority_msg *msg, int64_t timestamp_ms,
+			       bool confirmable)
+{
+	int err;
+	int len;
+	char buffer[GEOFENCE_EVENT_BUFFER_SIZE];
+	int64_t start_ms;
+	const char *event = msg->geofence.entered ? "enter" : "exit";
+
+	if (timestamp_ms == NRF_CLOUD_NO_TIMESTAMP) {
+		len = snprintk(buffer, sizeof(buffer), GEOFENCE_EVENT_FORMAT "}",
+			       msg->geofence.zone_id, event);
+	} else {
+		len = snprintk(buffer, sizeof(buffer), GEOFENCE_EVENT_FORMAT ",\"ts\":%lld}",
+			       msg->geofence.zone_id, event, timestamp_ms);
+	}
+
+	if ((len < 0) || (len >= sizeof(buffer))) {
+		return -ENOMEM;
+	}
+
+	start_ms = cloud_stats_start();
+	err = nrf_cloud_coap_json_message_send(buffer, false, confirmable);
+	cloud_stats_record(CLOUD_STATS_MESSAGE, len, confirmable, start_ms, err);
+	cloud_policy_send_result(confirmable, err);
+
+	return err;
+}
+
+/* Readings are sent one at a time, the readings that have been sent are skipped when the
+ * event is sent again after a failure.
+ */
+static int environmental_event_send(const struct cloud_priority_msg *msg, int64_t timestamp_ms,
+				    bool confirmable)
+{
+	int err;
+	int64_t start_ms;
+	const struct {
+		const char *app_id;
+		double value;
+	} readings[] = {
+		{ NRF_CLOUD_JSON_APPID_VAL_TEMP, msg->environmental.temperature },
+		{ NRF_CLOUD_JSON_APPID_VAL_HUMID, msg->environmental.humidity },
+		{ NRF_CLOUD_JSON_APPID_VAL_AIR_PRESS, msg->environmental.pressure },
+	};
+
+	for (; head.readings_sent < ARRAY_SIZE(readings); head.readings_sent++) {
+		const size_t i = head.readings_sent;
+
+		/* Pressure is not available in the low-power sensor profile */
+		if (isnan(readings[i].value)) {
+			continue;
+		}
+
+		start_ms = cloud_stats_start();
+		err = nrf_cloud_coap_sensor_send(readings[i].app_id, readings[i].value,
+						 timestamp_ms, confirmable);
+		cloud_stats_record(CLOUD_STATS_SENSOR, 0, confirmable, start_ms, err);
+		cloud_policy_send_result(confirmable, err);
+		if (err) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static int priority_event_send(const struct cloud_priority_msg *msg)
+{
+	int err;
+	int64_t timestamp_ms = msg->uptime_ms;
+	const bool confirmable = cloud_policy_confirmable(CLOUD_POLICY_DATA_CRITICAL);
+	int64_t start_ms;
+
+	/* Without a valid time, nRF Cloud sets the time of reception, which is close enough as
+	 * the event is sent right away.
+	 */
+	if (!date_time_is_valid() || date_time_uptime_to_unix_time_ms(&timestamp_ms)) {
+		timestamp_ms = NRF_CLOUD_NO_TIMESTAMP;
+	}
+
+	switch (msg->type) {
+	case CLOUD_PRIORITY_BUTTON:
+		start_ms = cloud_stats_start();
+		err = nrf_cloud_coap_sensor_send(NRF_CLOUD_JSON_APPID_VAL_BTN,
+						 (double)msg->button_number,
+						 timestamp_ms,
+						 confirmable);
+		cloud_stats_record(CLOUD_STATS_SENSOR, 0, confirmable, start_ms, err);
+		cloud_policy_send_result(confirmable, err);
+		break;
+	case CLOUD_PRIORITY_GEOFENCE:
+		err = geofence_event_send(msg, timestamp_ms, confirmable);
+		break;
+	case CLOUD_PRIORITY_ENVIRONMENTAL:
+		err = environmental_event_send(msg, timestamp_ms, confirmable);
+		break;
+	default:
+		LOG_WRN("Unknown priority event type: %d", msg->type);
+
+		return -ENOTSUP;
+	}
+
+	if (err) {
+		return err;
+	}
+
+	LOG_DBG("Priority event of type %d sent, %lld ms after it happened",
+		msg->type, k_uptime_get() - msg->uptime_ms);
+
+	return 0;
+}
+
+/* Errors that are not solved by sending the event again: a CoAP response code from nRF Cloud
+ * rejecting the request, or an event that cannot be encoded.
+ */
+static bool send_error_is_permanent(int err)
+{
+	return (err > 0) || (err == -EINVAL) || (err == -ENOTSUP) || (err == -ENOMEM);
+}
+
+static void head_remove(void)
+{
+	struct cloud_priority_msg msg;
+
+	(void)k_msgq_get(&priority_queue, &msg, K_NO_WAIT);
+
+	head.attempts = 0;
+	head.readings_sent = 0;
+}
+
+int cloud_priority_send_pending(void)
+{
+	int err;
+	struct cloud_priority_msg msg;
+
+	/* Only remove an event from the queue once it has been sent or dropped */
+	while (k_msgq_peek(&priority_queue, &msg) == 0) {
+		err = priority_event_send(&msg);
+		if (err == 0) {
+			head_remove();
+
+			continue;
+		}
+
+		if (send_error_is_permanent(err)) {
+			LOG_ERR("Priority event of type %d rejected, error: %d, dropping it",
+				msg.type, err);
+			head_remove();
+
+			continue;
+		}
+
+		head.attempts++;
+
+		if (head.attempts >= CONFIG_APP_CLOUD_PRIORITY_SEND_ATTEMPTS) {
+			LOG_ERR("Priority event of type %d failed %d times, error: %d, dropping it",
+				msg.type, head.attempts, err);
+			head_remove();
+		} else {
+			LOG_WRN("Failed to send priority event of type %d, error: %d",
+				msg.type, err);
+		}
+
+		return err;
+	}
+
+	return 0;
+}
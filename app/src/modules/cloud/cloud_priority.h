@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _CLOUD_PRIORITY_H_
+#define _CLOUD_PRIORITY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_APP_CLOUD_PRIORITY_LANE)
+/**
+ * @brief Send the events queued on the priority lane to nRF Cloud.
+ *
+ * Events are queued from cloud_priority_chan as soon as they are published, also while the
+ * cloud module thread is busy with a storage batch session. Must only be called from the
+ * cloud module thread while connected. Events that nRF Cloud rejects, or that cannot be
+ * encoded, are dropped. An event that fails with a network error stays queued and is sent
+ * first on the next call, until it has failed CONFIG_APP_CLOUD_PRIORITY_SEND_ATTEMPTS times.
+ *
+ * @retval 0 if all queued events have been sent or dropped.
+ * @retval -errno if an event failed to send with a network error.
+ */
+int cloud_priority_send_pending(void);
+#else
+static inline int cloud_priority_send_pending(void)
+{
+	return 0;
+}
+#endif /* CONFIG_APP_CLOUD_PRIORITY_LANE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOUD_PRIORITY_H_ */
@@ -8,6 +8,11 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/zbus/zbus.h>
 #include <net/nrf_provisioning.h>
+#if defined(CONFIG_APP_CLOUD_PROVISIONED_MARKER)
+#include <zephyr/settings/settings.h>
+#include <modem/modem_key_mgmt.h>
+#include <string.h>
+#endif /* CONFIG_APP_CLOUD_PROVISIONED_MARKER */
 
 #include "cloud_provisioning.h"
 #include "cloud_internal.h"
@@ -16,6 +21,159 @@
 
 LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
 
+static bool initialized;
+
+#if defined(CONFIG_APP_CLOUD_PROVISIONED_MARKER)
+#define SETTINGS_KEY		"att_cloud/prov"
+
+/* Size of the SHA-256 digest that the modem reports for a credential */
+#define FINGERPRINT_SIZE	32
+
+/* The fingerprint is the digest of the private key of the nRF Cloud security tag, which
+ * changes when the device is provisioned with a new identity.
+ */
+static uint8_t marker[FINGERPRINT_SIZE];
+static bool marker_loaded;
+static bool marker_valid;
+
+static int settings_load_cb(const char *key, size_t len, settings_read_cb read_cb,
+			    void *cb_arg, void *param)
+{
+	ssize_t ret;
+
+	ARG_UNUSED(key);
+	ARG_UNUSED(param);
+
+	if (len != sizeof(marker)) {
+		LOG_WRN("Dropping provisioned marker of unexpected size: %zu", len);
+
+		return 0;
+	}
+
+	ret = read_cb(cb_arg, marker, sizeof(marker));
+	if (ret != sizeof(marker)) {
+		LOG_WRN("Failed to read provisioned marker, error: %d", (int)ret);
+
+		memset(marker, 0, sizeof(marker));
+	}
+
+	return 0;
+}
+
+static int fingerprint_get(uint8_t fingerprint[FINGERPRINT_SIZE])
+{
+	int err;
+
+	err = modem_key_mgmt_digest(CONFIG_NRF_CLOUD_COAP_SEC_TAG,
+				    MODEM_KEY_MGMT_CRED_TYPE_PRIVATE_CERT,
+				    fingerprint, FINGERPRINT_SIZE);
+	if (err) {
+		LOG_WRN("modem_key_mgmt_digest, error: %d", err);
+
+		return err;
+	}
+
+	return 0;
+}
+
+/* The marker is checked against the modem once per boot, or after it has been changed */
+static void marker_load(void)
+{
+	int err;
+	uint8_t fingerprint[FINGERPRINT_SIZE];
+	static const uint8_t empty[FINGERPRINT_SIZE];
+
+	if (marker_loaded) {
+		return;
+	}
+
+	marker_loaded = true;
+
+	err = settings_subsys_init();
+	if (err) {
+		LOG_WRN("settings_subsys_init, error: %d", err);
+
+		return;
+	}
+
+	err = settings_load_subtree_direct(SETTINGS_KEY, settings_load_cb, NULL);
+	if (err) {
+		LOG_WRN("settings_load_subtree_direct, error: %d", err);
+
+		return;
+	}
+
+	if (memcmp(marker, empty, sizeof(marker)) == 0) {
+		return;
+	}
+
+	err = fingerprint_get(fingerprint);
+	if (err) {
+		return;
+	}
+
+	marker_valid = (memcmp(marker, fingerprint, sizeof(marker)) == 0);
+	if (!marker_valid) {
+		LOG_INF("Credentials changed since the device was last connected");
+	}
+}
+
+bool cloud_provisioning_marker_valid(void)
+{
+	marker_load();
+
+	return marker_valid;
+}
+
+void cloud_provisioning_marker_save(void)
+{
+	int err;
+
+	marker_load();
+
+	if (marker_valid) {
+		return;
+	}
+
+	err = fingerprint_get(marker);
+	if (err) {
+		return;
+	}
+
+	err = settings_save_one(SETTINGS_KEY, marker, sizeof(marker));
+	if (err) {
+		LOG_WRN("settings_save_one, error: %d", err);
+
+		return;
+	}
+
+	marker_valid = true;
+
+	LOG_DBG("Provisioned marker saved");
+}
+
+void cloud_provisioning_marker_clear(void)
+{
+	int err;
+
+	marker_load();
+
+	if (!marker_valid) {
+		return;
+	}
+
+	marker_valid = false;
+	memset(marker, 0, sizeof(marker));
+
+	err = settings_delete(SETTINGS_KEY);
+	if (err) {
+		LOG_WRN("settings_delete, error: %d", err);
+	}
+
+	LOG_DBG("Provisioned marker cleared");
+}
+#endif /* CONFIG_APP_CLOUD_PROVISIONED_MARKER */
+
 static void nrf_provisioning_callback(const struct nrf_provisioning_callback_data *event)
 {
 	int err;
@@ -135,12 +293,18 @@ int cloud_provisioning_init(void)
 {
 	int err;
 
+	if (initialized) {
+		return 0;
+	}
+
 	err = nrf_provisioning_init(nrf_provisioning_callback);
 	if (err) {
 		LOG_ERR("nrf_provisioning_init, error: %d", err);
 		return err;
 	}
 
+	initialized = true;
+
 	return 0;
 }
 
@@ -148,6 +312,11 @@ int cloud_provisioning_trigger(void)
 {
 	int err;
 
+	err = cloud_provisioning_init();
+	if (err) {
+		return err;
+	}
+
 	err = nrf_provisioning_trigger_manually();
 	if (err) {
 		LOG_ERR("nrf_provisioning_trigger_manually, error: %d", err);
@@ -156,3 +325,16 @@ int cloud_provisioning_trigger(void)
 
 	return 0;
 }
+
+#if defined(CONFIG_UNITY)
+void cloud_provisioning_test_reset(void)
+{
+	initialized = false;
+
+#if defined(CONFIG_APP_CLOUD_PROVISIONED_MARKER)
+	marker_loaded = false;
+	marker_valid = false;
+	memset(marker, 0, sizeof(marker));
+#endif /* CONFIG_APP_CLOUD_PROVISIONED_MARKER */
+}
+#endif /* CONFIG_UNITY */
@@ -7,6 +7,8 @@
 #ifndef _CLOUD_PROVISIONING_H_
 #define _CLOUD_PROVISIONING_H_
 
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -14,6 +16,8 @@ extern "C" {
 /**
  * @brief Initialize nRF Cloud provisioning service.
  *
+ * Calling the function again after a successful initialization is a no-op.
+ *
  * @return 0 on success, negative error code otherwise.
  */
 int cloud_provisioning_init(void);
@@ -21,10 +25,58 @@ int cloud_provisioning_init(void);
 /**
  * @brief Trigger provisioning manually.
  *
+ * The provisioning service is initialized first if needed.
+ *
  * @return 0 on success, negative error code otherwise.
  */
 int cloud_provisioning_trigger(void);
 
+#if defined(CONFIG_APP_CLOUD_PROVISIONED_MARKER)
+/**
+ * @brief Check the persisted provisioned marker against the credentials in the modem.
+ *
+ * @retval true if the device connected to nRF Cloud with the credentials that are in the
+ *	   modem now.
+ * @retval false if there is no marker, or the credentials changed since it was saved.
+ */
+bool cloud_provisioning_marker_valid(void);
+
+/**
+ * @brief Save the provisioned marker with the fingerprint of the current credentials.
+ *
+ * Called when a connection to nRF Cloud succeeded. Nothing is written if the marker is
+ * already valid.
+ */
+void cloud_provisioning_marker_save(void);
+
+/**
+ * @brief Remove the provisioned marker.
+ *
+ * Called when the credentials are rejected, or are about to be replaced by provisioning.
+ */
+void cloud_provisioning_marker_clear(void);
+#else
+static inline bool cloud_provisioning_marker_valid(void)
+{
+	return false;
+}
+
+static inline void cloud_provisioning_marker_save(void)
+{
+}
+
+static inline void cloud_provisioning_marker_clear(void)
+{
+}
+#endif /* CONFIG_APP_CLOUD_PROVISIONED_MARKER */
+
+#if defined(CONFIG_UNITY)
+/**
+ * @brief Forget the state kept since boot, as a reset does. Only for unit tests.
+ */
+void cloud_provisioning_test_reset(void);
+#endif /* CONFIG_UNITY */
+
 #ifdef __cplusplus
 }
 #endif
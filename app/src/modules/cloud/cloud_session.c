@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <errno.h>
+#include <string.h>
+#include <net/nrf_cloud_coap.h>
+#include <app_version.h>
+
+#include "cloud_session.h"
+
+LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
+
+#define CLOUD_SESSION_MAGIC 0x43534D4F /* "CSMO" - Cloud Session Metrics OK */
+
+struct cloud_session_noinit {
+	uint32_t magic;     /* Magic number to identify valid metrics */
+	struct cloud_session_metrics metrics;
+};
+
+/* Place the connection metrics in the noinit RAM section.
+ * This ensures the metrics persist across warm resets.
+ */
+static __noinit struct cloud_session_noinit session_noinit;
+
+/* Set when a DTLS session is saved in the modem, only accessed from the cloud thread */
+static bool paused;
+
+static struct cloud_session_metrics *metrics_get(void)
+{
+	if (session_noinit.magic != CLOUD_SESSION_MAGIC) {
+		LOG_DBG("No valid cloud session metrics found (magic: 0x%08x)",
+			session_noinit.magic);
+
+		memset(&session_noinit.metrics, 0, sizeof(session_noinit.metrics));
+		session_noinit.magic = CLOUD_SESSION_MAGIC;
+	}
+
+	return &session_noinit.metrics;
+}
+
+static uint32_t elapsed_ms(int64_t start)
+{
+	return (uint32_t)(k_uptime_get() - start);
+}
+
+int cloud_session_connect(void)
+{
+	int err;
+	struct cloud_session_metrics *metrics = metrics_get();
+	int64_t start = k_uptime_get();
+
+	/* A session saved before a failed request or a reprovisioning is not valid anymore */
+	paused = false;
+
+	err = nrf_cloud_coap_connect(APP_VERSION_STRING);
+	if (err) {
+		return err;
+	}
+
+	metrics->full_connects++;
+	metrics->last_full_connect_ms = elapsed_ms(start);
+
+	LOG_INF("Full DTLS handshake took %u ms", metrics->last_full_connect_ms);
+
+	return 0;
+}
+
+void cloud_session_pause(void)
+{
+	int err;
+
+	err = nrf_cloud_coap_pause();
+	if (err) {
+		LOG_WRN("nrf_cloud_coap_pause, error: %d, session will not be resumed", err);
+
+		paused = false;
+
+		return;
+	}
+
+	LOG_DBG("DTLS session saved");
+
+	paused = true;
+}
+
+int cloud_session_resume(void)
+{
+	int err;
+	struct cloud_session_metrics *metrics = metrics_get();
+	int64_t start = k_uptime_get();
+
+	if (!paused) {
+		return 0;
+	}
+
+	paused = false;
+
+	err = nrf_cloud_coap_resume();
+	if (err) {
+		LOG_WRN("nrf_cloud_coap_resume, error: %d, a full handshake is needed", err);
+
+		metrics->resume_failures++;
+
+		return -ENOTCONN;
+	}
+
+	metrics->resumed_connects++;
+	metrics->last_resume_ms = elapsed_ms(start);
+
+	LOG_INF("DTLS session resumed in %u ms", metrics->last_resume_ms);
+
+	return 0;
+}
+
+void cloud_session_metrics_get(struct cloud_session_metrics *metrics)
+{
+	*metrics = *metrics_get();
+}
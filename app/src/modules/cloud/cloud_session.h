@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _CLOUD_SESSION_H_
+#define _CLOUD_SESSION_H_
+
+#include <stdint.h>
+#include <net/nrf_cloud_coap.h>
+#include <app_version.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Cloud connection metrics, kept across warm resets. */
+struct cloud_session_metrics {
+	/** Number of connections that needed a full DTLS handshake. */
+	uint32_t full_connects;
+
+	/** Number of connections resumed from a saved DTLS session. */
+	uint32_t resumed_connects;
+
+	/** Number of failed resume attempts that fell back to a full handshake. */
+	uint32_t resume_failures;
+
+	/** Duration of the last full handshake, in milliseconds. */
+	uint32_t last_full_connect_ms;
+
+	/** Duration of the last session resume, in milliseconds. */
+	uint32_t last_resume_ms;
+};
+
+#if defined(CONFIG_APP_CLOUD_SESSION_RESUME)
+/**
+ * @brief Connect to nRF Cloud with a full DTLS handshake and record its latency.
+ *
+ * @return 0 on success, otherwise the error returned by nrf_cloud_coap_connect()
+ */
+int cloud_session_connect(void);
+
+/**
+ * @brief Save the DTLS session while the network is down.
+ *
+ * The DTLS session and Connection ID are stored in the modem, so that no handshake is needed
+ * when the network comes back. Failures are not fatal, the next cloud_session_resume()
+ * then asks for a full reconnection.
+ */
+void cloud_session_pause(void);
+
+/**
+ * @brief Resume the DTLS session saved by cloud_session_pause() and record its latency.
+ *
+ * @retval 0 if the session was resumed or no session was saved.
+ * @retval -ENOTCONN if the session could not be resumed and a full reconnection is needed.
+ */
+int cloud_session_resume(void);
+
+/**
+ * @brief Get the cloud connection metrics.
+ *
+ * @param metrics Pointer to where the metrics are copied.
+ */
+void cloud_session_metrics_get(struct cloud_session_metrics *metrics);
+#else
+static inline int cloud_session_connect(void)
+{
+	return nrf_cloud_coap_connect(APP_VERSION_STRING);
+}
+
+static inline void cloud_session_pause(void)
+{
+}
+
+static inline int cloud_session_resume(void)
+{
+	return 0;
+}
+#endif /* CONFIG_APP_CLOUD_SESSION_RESUME */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOUD_SESSION_H_ */
@@ -13,6 +13,8 @@
 
 #include "app_common.h"
 #include "cloud.h"
+#include "cloud_session.h"
+#include "cloud_stats.h"
 
 LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
 
@@ -102,6 +104,51 @@ static int cmd_provisioning(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
 
+#if defined(CONFIG_APP_CLOUD_SESSION_RESUME)
+static int cmd_session_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	struct cloud_session_metrics metrics;
+
+	cloud_session_metrics_get(&metrics);
+
+	(void)shell_print(sh, "Full handshakes: %u, last: %u ms",
+			  metrics.full_connects, metrics.last_full_connect_ms);
+	(void)shell_print(sh, "Resumed sessions: %u, last: %u ms",
+			  metrics.resumed_connects, metrics.last_resume_ms);
+	(void)shell_print(sh, "Failed resumes: %u", metrics.resume_failures);
+
+	return 0;
+}
+#endif /* CONFIG_APP_CLOUD_SESSION_RESUME */
+
+#if defined(CONFIG_APP_CLOUD_STATS)
+static int cmd_request_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	struct cloud_stats_entry entry;
+
+	for (int type = 0; type < CLOUD_STATS_TYPE_COUNT; type++) {
+		(void)cloud_stats_get(type, &entry);
+
+		(void)shell_print(sh,
+				  "%s: requests: %u, failed: %u, retransmissions: %u, "
+				  "bytes: %llu, rtt avg: %llu ms, max: %u ms",
+				  cloud_stats_type_name(type), entry.requests, entry.failures,
+				  entry.retransmissions, (unsigned long long)entry.bytes,
+				  (unsigned long long)(entry.rtt_count ?
+						       entry.rtt_total_ms / entry.rtt_count : 0),
+				  entry.rtt_max_ms);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_APP_CLOUD_STATS */
+
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_cmds,
 			       SHELL_CMD(publish,
 					 NULL,
@@ -118,6 +165,19 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_cmds,
 					 "Poll the device shadow delta to receive pending "
 					 "configuration updates",
 					 cmd_poll_shadow),
+#if defined(CONFIG_APP_CLOUD_SESSION_RESUME)
+			       SHELL_CMD(session_stats,
+					 NULL,
+					 "Print cloud connection counts and handshake latencies",
+					 cmd_session_stats),
+#endif /* CONFIG_APP_CLOUD_SESSION_RESUME */
+#if defined(CONFIG_APP_CLOUD_STATS)
+			       SHELL_CMD(request_stats,
+					 NULL,
+					 "Print request counts, payload bytes and round-trip times "
+					 "per request type",
+					 cmd_request_stats),
+#endif /* CONFIG_APP_CLOUD_STATS */
 			       SHELL_SUBCMD_SET_END
 );
 
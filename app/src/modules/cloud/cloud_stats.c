@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#if defined(CONFIG_APP_CLOUD_STATS_MEMFAULT)
+#include <memfault/metrics/metrics.h>
+#endif /* CONFIG_APP_CLOUD_STATS_MEMFAULT */
+
+#include "cloud_stats.h"
+
+LOG_MODULE_DECLARE(cloud, CONFIG_APP_CLOUD_LOG_LEVEL);
+
+static const char *const type_names[CLOUD_STATS_TYPE_COUNT] = {
+	[CLOUD_STATS_SENSOR] = "sensor",
+	[CLOUD_STATS_BATCH] = "batch",
+	[CLOUD_STATS_LOCATION] = "location",
+	[CLOUD_STATS_LOCATION_GET] = "location_get",
+	[CLOUD_STATS_AGNSS] = "agnss",
+	[CLOUD_STATS_MESSAGE] = "message",
+	[CLOUD_STATS_SHADOW] = "shadow",
+};
+
+static struct cloud_stats_entry entries[CLOUD_STATS_TYPE_COUNT];
+
+#if defined(CONFIG_APP_CLOUD_STATS_MEMFAULT)
+/* Totals at the previous heartbeat, and the longest round-trip time since then */
+static struct cloud_stats_entry heartbeat_last;
+static uint32_t interval_rtt_max_ms;
+#endif /* CONFIG_APP_CLOUD_STATS_MEMFAULT */
+
+/* Requests are recorded on the cloud thread, reads come from the shell and the Memfault
+ * heartbeat.
+ */
+static struct k_spinlock lock;
+
+int64_t cloud_stats_start(void)
+{
+	return k_uptime_get();
+}
+
+void cloud_stats_record(enum cloud_stats_type type, size_t bytes, bool confirmable,
+			int64_t start_ms, int err)
+{
+	struct cloud_stats_entry *entry;
+	uint32_t time_ms;
+	k_spinlock_key_t key;
+
+	if (type >= CLOUD_STATS_TYPE_COUNT) {
+		return;
+	}
+
+	time_ms = (uint32_t)CLAMP(k_uptime_get() - start_ms, 0, UINT32_MAX);
+	entry = &entries[type];
+
+	key = k_spin_lock(&lock);
+
+	entry->requests++;
+	entry->bytes += bytes;
+
+	if (err) {
+		entry->failures++;
+	}
+
+	if (confirmable) {
+		entry->retransmissions += time_ms / CONFIG_COAP_INIT_ACK_TIMEOUT_MS;
+
+		if (!err) {
+			entry->rtt_count++;
+			entry->rtt_total_ms += time_ms;
+			entry->rtt_max_ms = MAX(entry->rtt_max_ms, time_ms);
+
+#if defined(CONFIG_APP_CLOUD_STATS_MEMFAULT)
+			interval_rtt_max_ms = MAX(interval_rtt_max_ms, time_ms);
+#endif /* CONFIG_APP_CLOUD_STATS_MEMFAULT */
+		}
+	}
+
+	k_spin_unlock(&lock, key);
+
+	LOG_DBG("%s request: %zu bytes, %u ms, error: %d", type_names[type], bytes, time_ms, err);
+}
+
+int cloud_stats_get(enum cloud_stats_type type, struct cloud_stats_entry *entry)
+{
+	k_spinlock_key_t key;
+
+	if ((type >= CLOUD_STATS_TYPE_COUNT) || (entry == NULL)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+	*entry = entries[type];
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+const char *cloud_stats_type_name(enum cloud_stats_type type)
+{
+	if (type >= CLOUD_STATS_TYPE_COUNT) {
+		return "unknown";
+	}
+
+	return type_names[type];
+}
+
+#if defined(CONFIG_APP_CLOUD_STATS_MEMFAULT)
+void cloud_stats_heartbeat_collect(void)
+{
+	struct cloud_stats_entry total = { 0 };
+	uint32_t rtt_max_ms;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&lock);
+
+	for (size_t i = 0; i < ARRAY_SIZE(entries); i++) {
+		total.requests += entries[i].requests;
+		total.failures += entries[i].failures;
+		total.retransmissions += entries[i].retransmissions;
+		total.bytes += entries[i].bytes;
+	}
+
+	rtt_max_ms = interval_rtt_max_ms;
+	interval_rtt_max_ms = 0;
+
+	k_spin_unlock(&lock, key);
+
+	MEMFAULT_METRIC_SET_UNSIGNED(cloud_requests, total.requests - heartbeat_last.requests);
+	MEMFAULT_METRIC_SET_UNSIGNED(cloud_failures, total.failures - heartbeat_last.failures);
+	MEMFAULT_METRIC_SET_UNSIGNED(cloud_retransmissions,
+				     total.retransmissions - heartbeat_last.retransmissions);
+	MEMFAULT_METRIC_SET_UNSIGNED(cloud_payload_bytes,
+				     (uint32_t)MIN(total.bytes - heartbeat_last.bytes, UINT32_MAX));
+	MEMFAULT_METRIC_SET_UNSIGNED(cloud_rtt_max_ms, rtt_max_ms);
+
+	heartbeat_last = total;
+}
+#endif /* CONFIG_APP_CLOUD_STATS_MEMFAULT */
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _CLOUD_STATS_H_
+#define _CLOUD_STATS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <zephyr/toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Type of nRF Cloud request, statistics are kept per type. */
+enum cloud_stats_type {
+	/* Single sensor values, nrf_cloud_coap_sensor_send() */
+	CLOUD_STATS_SENSOR,
+
+	/* Batched data messages, nrf_cloud_coap_obj_send() */
+	CLOUD_STATS_BATCH,
+
+	/* GNSS fixes, nrf_cloud_coap_location_send() */
+	CLOUD_STATS_LOCATION,
+
+	/* Cellular and Wi-Fi location requests, nrf_cloud_coap_location_get() */
+	CLOUD_STATS_LOCATION_GET,
+
+	/* A-GNSS data requests, nrf_cloud_coap_agnss_data_get() */
+	CLOUD_STATS_AGNSS,
+
+	/* Application JSON messages, nrf_cloud_coap_json_message_send() */
+	CLOUD_STATS_MESSAGE,
+
+	/* Shadow polls and updates */
+	CLOUD_STATS_SHADOW,
+
+	CLOUD_STATS_TYPE_COUNT,
+};
+
+/** @brief Statistics of one request type, since boot. */
+struct cloud_stats_entry {
+	/** Number of requests, including failed requests. */
+	uint32_t requests;
+
+	/** Number of requests that returned an error. */
+	uint32_t failures;
+
+	/** Estimated number of CoAP retransmissions, see cloud_stats_record(). */
+	uint32_t retransmissions;
+
+	/** Application payload bytes sent or received, where the application has the payload. */
+	uint64_t bytes;
+
+	/** Number of successful confirmable requests, the requests the round-trip time is for. */
+	uint32_t rtt_count;
+
+	/** Total and longest round-trip time of successful confirmable requests, in ms. */
+	uint64_t rtt_total_ms;
+	uint32_t rtt_max_ms;
+};
+
+#if defined(CONFIG_APP_CLOUD_STATS)
+/**
+ * @brief Get the start time of a request, to pass to cloud_stats_record().
+ *
+ * @return Uptime in milliseconds.
+ */
+int64_t cloud_stats_start(void);
+
+/**
+ * @brief Record a finished request.
+ *
+ * The nRF Cloud CoAP library is blocking, so the time from cloud_stats_start() until the
+ * request returns is the round-trip time of confirmable requests. The CoAP client does not
+ * report retransmissions, each full CONFIG_COAP_INIT_ACK_TIMEOUT_MS in the round-trip time of
+ * a confirmable request is counted as one retransmission.
+ *
+ * @param type Type of the request.
+ * @param bytes Application payload bytes sent or received, 0 if not known.
+ * @param confirmable Whether the request was confirmable, GET requests always are.
+ * @param start_ms Value returned by cloud_stats_start() before the request.
+ * @param err Result of the request.
+ */
+void cloud_stats_record(enum cloud_stats_type type, size_t bytes, bool confirmable,
+			int64_t start_ms, int err);
+
+/**
+ * @brief Get the statistics of a request type.
+ *
+ * @param type Type of the request.
+ * @param entry Filled with the statistics.
+ *
+ * @return 0 on success, -EINVAL if the type is not known.
+ */
+int cloud_stats_get(enum cloud_stats_type type, struct cloud_stats_entry *entry);
+
+/**
+ * @brief Get the name of a request type, as printed by the shell.
+ *
+ * @param type Type of the request.
+ *
+ * @return Name of the type, "unknown" if the type is not known.
+ */
+const char *cloud_stats_type_name(enum cloud_stats_type type);
+#else
+static inline int64_t cloud_stats_start(void)
+{
+	return 0;
+}
+
+static inline void cloud_stats_record(enum cloud_stats_type type, size_t bytes,
+				      bool confirmable, int64_t start_ms, int err)
+{
+	ARG_UNUSED(type);
+	ARG_UNUSED(bytes);
+	ARG_UNUSED(confirmable);
+	ARG_UNUSED(start_ms);
+	ARG_UNUSED(err);
+}
+#endif /* CONFIG_APP_CLOUD_STATS */
+
+#if defined(CONFIG_APP_CLOUD_STATS_MEMFAULT)
+/** @brief Report the requests of the heartbeat interval to Memfault, summed over all types. */
+void cloud_stats_heartbeat_collect(void);
+#endif /* CONFIG_APP_CLOUD_STATS_MEMFAULT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CLOUD_STATS_H_ */
@@ -11,9 +11,22 @@
 #include <zephyr/task_wdt/task_wdt.h>
 #include <zephyr/smf.h>
 #include <date_time.h>
+#include <math.h>
 
 #include "app_common.h"
+#include "state_stats.h"
+#include "zbus_stats.h"
+#include "handler_stats.h"
 #include "environmental.h"
+#if defined(CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER)
+#include "environmental_report.h"
+#endif /* CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER */
+#if defined(CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER) && defined(CONFIG_APP_CLOUD_PRIORITY_LANE)
+#include "cloud.h"
+#endif /* CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER && CONFIG_APP_CLOUD_PRIORITY_LANE */
+#if defined(CONFIG_APP_EXECUTOR)
+#include "executor.h"
+#endif /* CONFIG_APP_EXECUTOR */
 
 /* Register log module */
 LOG_MODULE_REGISTER(environmental, CONFIG_APP_ENVIRONMENTAL_LOG_LEVEL);
@@ -27,6 +40,8 @@ ZBUS_CHAN_DEFINE(environmental_chan,
 		 ZBUS_MSG_INIT(0)
 );
 
+ZBUS_STATS_CHAN_DEFINE(environmental_chan);
+
 /* Register subscriber */
 ZBUS_MSG_SUBSCRIBER_DEFINE(environmental);
 
@@ -64,6 +79,9 @@ struct environmental_state_object {
 	/* Pointer to the BME680 sensor device */
 	const struct device *const bme680;
 
+	/* Channels read on each sample */
+	enum environmental_profile profile;
+
 	/* Sensor values */
 	double temperature;
 	double pressure;
@@ -78,9 +96,79 @@ static const struct smf_state states[] = {
 	[STATE_RUNNING] = SMF_CREATE_STATE(NULL, state_running_run, NULL, NULL, NULL),
 };
 
-static void sample_sensors(const struct device *const bme680)
+STATE_STATS_DEFINE(environmental, states);
+HANDLER_STATS_DEFINE(environmental, CONFIG_APP_ENVIRONMENTAL_MSG_PROCESSING_TIMEOUT_SECONDS);
+HANDLER_STATS_METRIC_DEFINE(environmental);
+
+static struct environmental_state_object environmental_state = {
+	.bme680 = DEVICE_DT_GET(DT_NODELABEL(bme680)),
+	.profile = IS_ENABLED(CONFIG_APP_ENVIRONMENTAL_PROFILE_LOW_POWER) ?
+		   ENVIRONMENTAL_PROFILE_LOW_POWER : ENVIRONMENTAL_PROFILE_FULL,
+};
+
+static void msg_publish(const struct environmental_msg *msg)
+{
+	int err;
+
+	err = zbus_chan_pub(&environmental_chan, msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+#if defined(CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER)
+#if defined(CONFIG_APP_CLOUD_PRIORITY_LANE)
+static void priority_event_send(const struct environmental_msg *msg, int64_t uptime_ms)
+{
+	int err;
+	struct cloud_priority_msg priority_msg = {
+		.type = CLOUD_PRIORITY_ENVIRONMENTAL,
+		.uptime_ms = uptime_ms,
+		.environmental.temperature = msg->temperature,
+		.environmental.humidity = msg->humidity,
+		.environmental.pressure = msg->pressure,
+	};
+
+	err = zbus_chan_pub(&cloud_priority_chan, &priority_msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+#endif /* CONFIG_APP_CLOUD_PRIORITY_LANE */
+
+/* Publish the sample only when it is an excursion, and the summary when a window completes */
+static void sample_report(const struct environmental_msg *msg, int64_t uptime_ms)
+{
+	static struct environmental_report report;
+
+	environmental_report_add(msg, uptime_ms, &report);
+
+	if (report.event) {
+		msg_publish(msg);
+
+#if defined(CONFIG_APP_CLOUD_PRIORITY_LANE)
+		/* Excursions are sent right away instead of with the stored data */
+		priority_event_send(msg, uptime_ms);
+#endif /* CONFIG_APP_CLOUD_PRIORITY_LANE */
+	}
+
+	if (report.summary_ready) {
+		LOG_DBG("Summary of %u samples: temperature %.2f to %.2f C",
+			report.summary.sample_count, report.summary.temperature_range.min,
+			report.summary.temperature_range.max);
+
+		msg_publish(&report.summary);
+	}
+}
+#endif /* CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER */
+
+static void sample_sensors(const struct device *const bme680, enum environmental_profile profile)
 {
 	int err;
+	int64_t uptime_ms;
+	double pressure = NAN;
 	struct sensor_value temp = { 0 };
 	struct sensor_value press = { 0 };
 	struct sensor_value humidity = { 0 };
@@ -99,26 +187,33 @@ static void sample_sensors(const struct device *const bme680)
 		return;
 	}
 
-	err = sensor_channel_get(bme680, SENSOR_CHAN_PRESS, &press);
+	err = sensor_channel_get(bme680, SENSOR_CHAN_HUMIDITY, &humidity);
 	if (err) {
 		LOG_ERR("sensor_channel_get, error: %d", err);
 		SEND_FATAL_ERROR();
 		return;
 	}
 
-	err = sensor_channel_get(bme680, SENSOR_CHAN_HUMIDITY, &humidity);
-	if (err) {
-		LOG_ERR("sensor_channel_get, error: %d", err);
-		SEND_FATAL_ERROR();
-		return;
+	/* Only the channels of the profile are read and reported */
+	if (profile == ENVIRONMENTAL_PROFILE_FULL) {
+		err = sensor_channel_get(bme680, SENSOR_CHAN_PRESS, &press);
+		if (err) {
+			LOG_ERR("sensor_channel_get, error: %d", err);
+			SEND_FATAL_ERROR();
+			return;
+		}
+
+		pressure = sensor_value_to_double(&press);
 	}
 
+	uptime_ms = k_uptime_get();
+
 	struct environmental_msg msg = {
 		.type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE,
 		.temperature = sensor_value_to_double(&temp),
-		.pressure = sensor_value_to_double(&press),
+		.pressure = pressure,
 		.humidity = sensor_value_to_double(&humidity),
-		.timestamp = k_uptime_get(),
+		.timestamp = uptime_ms,
 	};
 
 	err = date_time_now(&msg.timestamp);
@@ -132,27 +227,18 @@ static void sample_sensors(const struct device *const bme680)
 	LOG_DBG("Temperature: %.2f C, Pressure: %.2f Pa, Humidity: %.2f %%",
 		msg.temperature, msg.pressure, msg.humidity);
 
-	err = zbus_chan_pub(&environmental_chan, &msg, PUB_TIMEOUT);
-	if (err) {
-		LOG_ERR("zbus_chan_pub, error: %d", err);
-		SEND_FATAL_ERROR();
-		return;
-	}
-}
-
-static void env_wdt_callback(int channel_id, void *user_data)
-{
-	LOG_ERR("Watchdog expired, Channel: %d, Thread: %s",
-		channel_id, k_thread_name_get((k_tid_t)user_data));
-
-	SEND_FATAL_ERROR_WATCHDOG_TIMEOUT();
+#if defined(CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER)
+	sample_report(&msg, uptime_ms);
+#else
+	msg_publish(&msg);
+#endif /* CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER */
 }
 
 /* State handlers */
 
 static enum smf_state_result state_running_run(void *obj)
 {
-	struct environmental_state_object const *state_object = obj;
+	struct environmental_state_object *state_object = obj;
 
 	if (&environmental_chan == state_object->chan) {
 		const struct environmental_msg *msg =
@@ -160,7 +246,19 @@ static enum smf_state_result state_running_run(void *obj)
 
 		if (msg->type == ENVIRONMENTAL_SENSOR_SAMPLE_REQUEST) {
 			LOG_DBG("Environmental values sample request received, getting data");
-			sample_sensors(state_object->bme680);
+			sample_sensors(state_object->bme680, state_object->profile);
+
+			return SMF_EVENT_HANDLED;
+		} else if (msg->type == ENVIRONMENTAL_PROFILE_SET) {
+			LOG_DBG("Sensor profile set to %d", msg->profile);
+
+#if defined(CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER)
+			if (msg->profile != state_object->profile) {
+				environmental_report_reset();
+			}
+#endif /* CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER */
+
+			state_object->profile = msg->profile;
 
 			return SMF_EVENT_HANDLED;
 		}
@@ -169,6 +267,26 @@ static enum smf_state_result state_running_run(void *obj)
 	return SMF_EVENT_PROPAGATE;
 }
 
+static int env_module_init(void)
+{
+	smf_set_initial(SMF_CTX(&environmental_state), &states[STATE_RUNNING]);
+	STATE_STATS_UPDATE(environmental, SMF_CTX(&environmental_state));
+
+	return 0;
+}
+
+#if defined(CONFIG_APP_EXECUTOR)
+EXECUTOR_MODULE_DEFINE(environmental, environmental, environmental_state, env_module_init,
+		       CONFIG_APP_ENVIRONMENTAL_EXECUTOR_PRIORITY);
+#else
+static void env_wdt_callback(int channel_id, void *user_data)
+{
+	LOG_ERR("Watchdog expired, Channel: %d, Thread: %s",
+		channel_id, k_thread_name_get((k_tid_t)user_data));
+
+	SEND_FATAL_ERROR_WATCHDOG_TIMEOUT();
+}
+
 static void env_module_thread(void)
 {
 	int err;
@@ -178,9 +296,6 @@ static void env_module_thread(void)
 	const uint32_t execution_time_ms =
 		(CONFIG_APP_ENVIRONMENTAL_MSG_PROCESSING_TIMEOUT_SECONDS * MSEC_PER_SEC);
 	const k_timeout_t zbus_wait_ms = K_MSEC(wdt_timeout_ms - execution_time_ms);
-	static struct environmental_state_object environmental_state = {
-		.bme680 = DEVICE_DT_GET(DT_NODELABEL(bme680)),
-	};
 
 	LOG_DBG("Environmental module task started");
 
@@ -191,7 +306,10 @@ static void env_module_thread(void)
 		return;
 	}
 
-	smf_set_initial(SMF_CTX(&environmental_state), &states[STATE_RUNNING]);
+	err = env_module_init();
+	if (err) {
+		return;
+	}
 
 	while (true) {
 		err = task_wdt_feed(task_wdt_id);
@@ -213,15 +331,22 @@ static void env_module_thread(void)
 			return;
 		}
 
+		zbus_stats_received(&environmental, environmental_state.chan);
+
+		HANDLER_STATS_START(environmental, environmental_state.chan);
 		err = smf_run_state(SMF_CTX(&environmental_state));
+		HANDLER_STATS_END(environmental);
 		if (err) {
 			LOG_ERR("smf_run_state(), error: %d", err);
 			SEND_FATAL_ERROR();
 			return;
 		}
+
+		STATE_STATS_UPDATE(environmental, SMF_CTX(&environmental_state));
 	}
 }
 
 K_THREAD_DEFINE(environmental_module_thread_id,
 		CONFIG_APP_ENVIRONMENTAL_THREAD_STACK_SIZE,
 		env_module_thread, NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+#endif /* CONFIG_APP_EXECUTOR */
@@ -28,12 +28,38 @@ enum environmental_msg_type {
 	 */
 	ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE = 0x1,
 
+	/* Summary of the samples of a reporting window, published instead of the samples with
+	 * CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER. The averages are found in the sample fields,
+	 * the extremes in the range fields.
+	 */
+	ENVIRONMENTAL_SENSOR_SUMMARY,
+
 	/* Input message types */
 
 	/* Request to sample the current environmental sensor values.
 	 * The response is sent as a ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE message.
 	 */
 	ENVIRONMENTAL_SENSOR_SAMPLE_REQUEST,
+
+	/* Select the sensor profile used for the next samples. The profile is found in the
+	 * profile field of the message structure.
+	 */
+	ENVIRONMENTAL_PROFILE_SET,
+};
+
+/** @brief Channels read from the sensor on each sample */
+enum environmental_profile {
+	/* Temperature, humidity and pressure */
+	ENVIRONMENTAL_PROFILE_FULL = 0,
+
+	/* Temperature and humidity only, pressure is NAN in the samples */
+	ENVIRONMENTAL_PROFILE_LOW_POWER = 1,
+};
+
+/** @brief Minimum and maximum of a reading over a reporting window */
+struct environmental_range {
+	double min;
+	double max;
 };
 
 struct environmental_msg {
@@ -45,16 +71,30 @@ struct environmental_msg {
 	/** Contains the current humidity in percentage. */
 	double humidity;
 
-	/** Contains the current pressure in Pa. */
+	/** Contains the current pressure in Pa, NAN if not read in the current profile. */
 	double pressure;
 
 	/** Timestamp when the sample was taken in milliseconds.
 	 *  This is either:
 	 * - Unix time in milliseconds if the system clock was synchronized at sampling time, or
 	 * - Uptime in milliseconds if the system clock was not synchronized at sampling time.
-	 * Only valid for ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE events.
+	 * Only valid for ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE and ENVIRONMENTAL_SENSOR_SUMMARY
+	 * events, for a summary the time of the last sample of the window.
 	 */
 	int64_t timestamp;
+
+	/** Extremes of the readings over the window.
+	 *  Only valid for ENVIRONMENTAL_SENSOR_SUMMARY events.
+	 */
+	struct environmental_range temperature_range;
+	struct environmental_range humidity_range;
+	struct environmental_range pressure_range;
+
+	/** Number of samples in the window. Only valid for ENVIRONMENTAL_SENSOR_SUMMARY events. */
+	uint16_t sample_count;
+
+	/** Sensor profile. Only valid for ENVIRONMENTAL_PROFILE_SET events. */
+	enum environmental_profile profile;
 };
 
 
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <math.h>
+#include <string.h>
+
+#include "environmental_report.h"
+
+LOG_MODULE_DECLARE(environmental, CONFIG_APP_ENVIRONMENTAL_LOG_LEVEL);
+
+/* Deadbands are configured in tenths for temperature and humidity, like the cloud dedup */
+#define TEMPERATURE_DEADBAND	(CONFIG_APP_ENVIRONMENTAL_REPORT_TEMPERATURE_DEADBAND / 10.0)
+#define HUMIDITY_DEADBAND	(CONFIG_APP_ENVIRONMENTAL_REPORT_HUMIDITY_DEADBAND / 10.0)
+#define PRESSURE_DEADBAND	((double)CONFIG_APP_ENVIRONMENTAL_REPORT_PRESSURE_DEADBAND)
+#define RELATIVE_DEADBAND	(CONFIG_APP_ENVIRONMENTAL_REPORT_RELATIVE_DEADBAND / 100.0)
+
+/* Temperature rate limit in degrees Celsius per millisecond */
+#define TEMPERATURE_RATE	(CONFIG_APP_ENVIRONMENTAL_REPORT_TEMPERATURE_RATE / 10.0 /	\
+				 (double)MSEC_PER_SEC / SEC_PER_MIN)
+
+/* Only accessed from the environmental module thread */
+static struct {
+	/* Last sample published as an event, the reference of the deadbands */
+	bool reported_valid;
+	struct environmental_msg reported;
+
+	/* Previous sample, for the rate of change */
+	bool previous_valid;
+	double previous_temperature;
+	int64_t previous_uptime_ms;
+
+	/* Reporting window */
+	uint16_t count;
+	double temperature_sum;
+	double humidity_sum;
+	double pressure_sum;
+	struct environmental_msg window;
+} report_state;
+
+static bool outside(double value, double ref, double deadband)
+{
+	return fabs(value - ref) > MAX(deadband, fabs(ref) * RELATIVE_DEADBAND);
+}
+
+static void range_add(struct environmental_range *range, double value, bool first)
+{
+	if (first) {
+		range->min = value;
+		range->max = value;
+
+		return;
+	}
+
+	range->min = MIN(range->min, value);
+	range->max = MAX(range->max, value);
+}
+
+static bool rate_exceeded(const struct environmental_msg *sample, int64_t uptime_ms)
+{
+	double rate;
+
+	if ((CONFIG_APP_ENVIRONMENTAL_REPORT_TEMPERATURE_RATE == 0) ||
+	    !report_state.previous_valid || (uptime_ms <= report_state.previous_uptime_ms)) {
+		return false;
+	}
+
+	rate = fabs(sample->temperature - report_state.previous_temperature) /
+	       (double)(uptime_ms - report_state.previous_uptime_ms);
+
+	return rate > TEMPERATURE_RATE;
+}
+
+static bool deadband_exceeded(const struct environmental_msg *sample)
+{
+	const struct environmental_msg *ref = &report_state.reported;
+
+	return !report_state.reported_valid ||
+	       outside(sample->temperature, ref->temperature, TEMPERATURE_DEADBAND) ||
+	       outside(sample->humidity, ref->humidity, HUMIDITY_DEADBAND) ||
+	       outside(sample->pressure, ref->pressure, PRESSURE_DEADBAND);
+}
+
+static void window_add(const struct environmental_msg *sample)
+{
+	struct environmental_msg *window = &report_state.window;
+	const bool first = (report_state.count == 0);
+
+	range_add(&window->temperature_range, sample->temperature, first);
+	range_add(&window->humidity_range, sample->humidity, first);
+	range_add(&window->pressure_range, sample->pressure, first);
+
+	if (first) {
+		report_state.temperature_sum = 0.0;
+		report_state.humidity_sum = 0.0;
+		report_state.pressure_sum = 0.0;
+	}
+
+	report_state.temperature_sum += sample->temperature;
+	report_state.humidity_sum += sample->humidity;
+	report_state.pressure_sum += sample->pressure;
+	report_state.count++;
+}
+
+void environmental_report_reset(void)
+{
+	LOG_DBG("Discarding %u samples of the reporting window", report_state.count);
+
+	report_state.count = 0;
+	report_state.reported_valid = false;
+}
+
+void environmental_report_add(const struct environmental_msg *sample, int64_t uptime_ms,
+			      struct environmental_report *report)
+{
+	const bool rate_alarm = rate_exceeded(sample, uptime_ms);
+
+	report->event = rate_alarm || deadband_exceeded(sample);
+	report->summary_ready = false;
+
+	if (report->event) {
+		LOG_DBG("Reporting sample right away%s", rate_alarm ? ", rate of change alarm" : "");
+
+		report_state.reported = *sample;
+		report_state.reported_valid = true;
+	}
+
+	report_state.previous_temperature = sample->temperature;
+	report_state.previous_uptime_ms = uptime_ms;
+	report_state.previous_valid = true;
+
+	window_add(sample);
+
+	if (report_state.count < CONFIG_APP_ENVIRONMENTAL_REPORT_WINDOW_SAMPLES) {
+		return;
+	}
+
+	/* The summary has the averages in the sample fields, and the time of the last sample */
+	report->summary = report_state.window;
+	report->summary.type = ENVIRONMENTAL_SENSOR_SUMMARY;
+	report->summary.temperature = report_state.temperature_sum / report_state.count;
+	report->summary.humidity = report_state.humidity_sum / report_state.count;
+	report->summary.pressure = report_state.pressure_sum / report_state.count;
+	report->summary.timestamp = sample->timestamp;
+	report->summary.sample_count = report_state.count;
+	report->summary_ready = true;
+
+	report_state.count = 0;
+}
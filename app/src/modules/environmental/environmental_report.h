@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _ENVIRONMENTAL_REPORT_H_
+#define _ENVIRONMENTAL_REPORT_H_
+
+#include <stdbool.h>
+
+#include "environmental.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief What to publish for a sample added to the reporting filter */
+struct environmental_report {
+	/* The sample left the deadband around the last reported sample, or the temperature
+	 * changed faster than the rate limit. The sample is to be published right away.
+	 */
+	bool event;
+
+	/* The reporting window is complete, summary is to be published */
+	bool summary_ready;
+
+	/* ENVIRONMENTAL_SENSOR_SUMMARY message of the completed window */
+	struct environmental_msg summary;
+};
+
+/**
+ * @brief Add a sample to the reporting filter.
+ *
+ * @param[in]  sample    ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE message with the sample.
+ * @param[in]  uptime_ms Uptime in milliseconds when the sample was taken, for the rate of
+ *			 change.
+ * @param[out] report    What to publish for the sample.
+ */
+void environmental_report_add(const struct environmental_msg *sample, int64_t uptime_ms,
+			      struct environmental_report *report);
+
+/**
+ * @brief Start a new reporting window.
+ *
+ * Called when the sensor profile changes, so that a window does not mix samples with and
+ * without pressure. The samples of the current window are discarded, and the next sample is
+ * reported right away as the new reference of the deadbands.
+ */
+void environmental_report_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ENVIRONMENTAL_REPORT_H_ */
@@ -17,10 +17,17 @@
 #include <nrf_cloud_fota.h>
 #include <zephyr/smf.h>
 #include <net/fota_download.h>
+#include <dfu/dfu_target.h>
 #include <modem/nrf_modem_lib.h>
 
 #include "app_common.h"
+#include "state_stats.h"
+#include "zbus_stats.h"
+#include "handler_stats.h"
 #include "fota.h"
+#if defined(CONFIG_APP_EXECUTOR)
+#include "executor.h"
+#endif /* CONFIG_APP_EXECUTOR */
 
 /* Register log module */
 LOG_MODULE_REGISTER(fota, CONFIG_APP_FOTA_LOG_LEVEL);
@@ -43,6 +50,8 @@ ZBUS_CHAN_DEFINE(fota_chan,
 		 ZBUS_MSG_INIT(0)
 );
 
+ZBUS_STATS_CHAN_DEFINE(fota_chan);
+
 /* Private channel message types for internal state management. */
 enum priv_fota_msg_type {
 	/* Modem has completed initialization. */
@@ -55,6 +64,8 @@ enum priv_fota_msg_type {
 	FOTA_PRIV_IMAGE_APPLY_NEEDED,
 	/* FOTA sequence has been aborted */
 	FOTA_PRIV_ABORTED,
+	/* The download failed, the written part of the image is kept to be resumed */
+	FOTA_PRIV_INTERRUPTED,
 };
 
 struct priv_fota_msg {
@@ -220,6 +231,10 @@ static const struct smf_state states[] = {
 				 NULL),
 };
 
+STATE_STATS_DEFINE(fota, states);
+HANDLER_STATS_DEFINE(fota, CONFIG_APP_FOTA_MSG_PROCESSING_TIMEOUT_SECONDS);
+HANDLER_STATS_METRIC_DEFINE(fota);
+
 /* Helpers */
 
 static void publish_fota_event(enum fota_msg_type type)
@@ -292,7 +307,8 @@ static void fota_status(enum nrf_cloud_fota_status status, const char *const sta
 	case NRF_CLOUD_FOTA_FAILED:
 		LOG_WRN("Firmware download failed");
 
-		publish_priv_fota(FOTA_PRIV_ABORTED);
+		publish_priv_fota(IS_ENABLED(CONFIG_APP_FOTA_DOWNLOAD_RESUME) ?
+				  FOTA_PRIV_INTERRUPTED : FOTA_PRIV_ABORTED);
 		break;
 	case NRF_CLOUD_FOTA_CANCELED:
 		LOG_WRN("Firmware download canceled");
@@ -328,6 +344,19 @@ static void fota_status(enum nrf_cloud_fota_status status, const char *const sta
 	}
 }
 
+/* Drop the saved download offset so that the next image is downloaded from byte 0 */
+static void download_progress_clear(void)
+{
+#if defined(CONFIG_APP_FOTA_DOWNLOAD_RESUME)
+	int err = dfu_target_reset();
+
+	if (err) {
+		LOG_WRN("dfu_target_reset, error: %d", err);
+	}
+#endif /* CONFIG_APP_FOTA_DOWNLOAD_RESUME */
+}
+
+#if !defined(CONFIG_APP_EXECUTOR)
 static void fota_wdt_callback(int channel_id, void *user_data)
 {
 	LOG_ERR("Watchdog expired, Channel: %d, Thread: %s",
@@ -335,6 +364,7 @@ static void fota_wdt_callback(int channel_id, void *user_data)
 
 	SEND_FATAL_ERROR_WATCHDOG_TIMEOUT();
 }
+#endif /* !CONFIG_APP_EXECUTOR */
 
 /* State handlers */
 
@@ -497,6 +527,7 @@ static enum smf_state_result state_polling_for_update_run(void *obj)
 
 			return SMF_EVENT_HANDLED;
 		case FOTA_PRIV_ABORTED:
+		case FOTA_PRIV_INTERRUPTED:
 			publish_fota_event(FOTA_ABORTED);
 			smf_set_state(SMF_CTX(state_object),
 				      &states[STATE_WAITING_FOR_POLL_REQUEST]);
@@ -575,10 +606,19 @@ static enum smf_state_result state_downloading_update_run(void *obj)
 
 			return SMF_EVENT_HANDLED;
 		case FOTA_PRIV_ABORTED:
+			download_progress_clear();
 			publish_fota_event(FOTA_ABORTED);
 			smf_set_state(SMF_CTX(state_object),
 				      &states[STATE_WAITING_FOR_POLL_REQUEST]);
 
+			return SMF_EVENT_HANDLED;
+		case FOTA_PRIV_INTERRUPTED:
+			LOG_DBG("Download interrupted, keeping the written part of the image");
+
+			publish_fota_event(FOTA_DOWNLOAD_INTERRUPTED);
+			smf_set_state(SMF_CTX(state_object),
+				      &states[STATE_WAITING_FOR_POLL_REQUEST]);
+
 			return SMF_EVENT_HANDLED;
 		default:
 			break;
@@ -707,7 +747,9 @@ static enum smf_state_result state_canceling_run(void *obj)
 		const struct priv_fota_msg *msg =
 			(const struct priv_fota_msg *)state_object->msg_buf;
 
-		if (msg->type == FOTA_PRIV_ABORTED) {
+		/* A download that fails while being canceled is not resumed either */
+		if ((msg->type == FOTA_PRIV_ABORTED) || (msg->type == FOTA_PRIV_INTERRUPTED)) {
+			download_progress_clear();
 			publish_fota_event(FOTA_ABORTED);
 			smf_set_state(SMF_CTX(state_object),
 				      &states[STATE_WAITING_FOR_POLL_REQUEST]);
@@ -719,6 +761,23 @@ static enum smf_state_result state_canceling_run(void *obj)
 	return SMF_EVENT_PROPAGATE;
 }
 
+static struct fota_state_object fota_state = {
+	.fota_ctx.reboot_fn = fota_reboot,
+	.fota_ctx.status_fn = fota_status,
+};
+
+static int fota_module_init(void)
+{
+	smf_set_initial(SMF_CTX(&fota_state), &states[STATE_RUNNING]);
+	STATE_STATS_UPDATE(fota, SMF_CTX(&fota_state));
+
+	return 0;
+}
+
+#if defined(CONFIG_APP_EXECUTOR)
+EXECUTOR_MODULE_DEFINE(fota, fota, fota_state, fota_module_init,
+		       CONFIG_APP_FOTA_EXECUTOR_PRIORITY);
+#else
 static void fota_module_thread(void)
 {
 	int err;
@@ -727,10 +786,6 @@ static void fota_module_thread(void)
 	const uint32_t execution_time_ms =
 		(CONFIG_APP_FOTA_MSG_PROCESSING_TIMEOUT_SECONDS * MSEC_PER_SEC);
 	const k_timeout_t zbus_wait_ms = K_MSEC(wdt_timeout_ms - execution_time_ms);
-	static struct fota_state_object fota_state = {
-		.fota_ctx.reboot_fn = fota_reboot,
-		.fota_ctx.status_fn = fota_status,
-	};
 
 	LOG_DBG("FOTA module task started");
 
@@ -741,7 +796,10 @@ static void fota_module_thread(void)
 		return;
 	}
 
-	smf_set_initial(SMF_CTX(&fota_state), &states[STATE_RUNNING]);
+	err = fota_module_init();
+	if (err) {
+		return;
+	}
 
 	while (true) {
 		err = task_wdt_feed(task_wdt_id);
@@ -760,15 +818,22 @@ static void fota_module_thread(void)
 			return;
 		}
 
+		zbus_stats_received(&fota, fota_state.chan);
+
+		HANDLER_STATS_START(fota, fota_state.chan);
 		err = smf_run_state(SMF_CTX(&fota_state));
+		HANDLER_STATS_END(fota);
 		if (err) {
 			LOG_ERR("smf_run_state(), error: %d", err);
 			SEND_FATAL_ERROR();
 			return;
 		}
+
+		STATE_STATS_UPDATE(fota, SMF_CTX(&fota_state));
 	}
 }
 
 K_THREAD_DEFINE(fota_module_thread_id,
 		CONFIG_APP_FOTA_THREAD_STACK_SIZE,
 		fota_module_thread, NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+#endif /* CONFIG_APP_EXECUTOR */
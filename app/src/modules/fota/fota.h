@@ -42,6 +42,13 @@ enum fota_msg_type {
 	 */
 	FOTA_ABORTED,
 
+	/* The download was interrupted, typically by a network loss. The part of the image that
+	 * was written is kept, and the application is expected to send FOTA_POLL_REQUEST when
+	 * the cloud is connected again to continue the download from where it stopped.
+	 * Only sent with CONFIG_APP_FOTA_DOWNLOAD_RESUME.
+	 */
+	FOTA_DOWNLOAD_INTERRUPTED,
+
 	/* Request to poll cloud for any available firmware updates. */
 	FOTA_POLL_REQUEST,
 
@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+#include <math.h>
+#include <string.h>
+
+#include "app_common.h"
+#include "geofence.h"
+#include "cloud.h"
+
+/* Register log module */
+LOG_MODULE_REGISTER(geofence, CONFIG_APP_GEOFENCE_LOG_LEVEL);
+
+#define EARTH_RADIUS_METERS	6371000.0
+#define DEG_TO_RAD(deg)		((deg) * 3.14159265358979323846 / 180.0)
+#define RAD_TO_DEG(rad)		((rad) * 180.0 / 3.14159265358979323846)
+#define POINT_DEG(value)	((double)(value) / 1000000.0)
+
+/* Zones whose bounding box does not contain the fix are outside by more than this */
+#define FAR_AWAY_METERS		(2.0 * EARTH_RADIUS_METERS)
+
+/* Transition fixes that can wait for the storage module to pick them up. Buffered GNSS
+ * tracking fixes are published in a burst, before the storage module thread runs.
+ */
+#define TRANSITION_FIXES_MAX	4
+
+/* Per zone state */
+struct zone_state {
+	/* Bounding box in degrees, expanded by the hysteresis. Fixes outside of it are not
+	 * evaluated further, so that only the zones near the device cost any work.
+	 */
+	double lat_min;
+	double lat_max;
+	double lon_min;
+	double lon_max;
+
+	bool inside;
+};
+
+/* Zones are set from the main module thread, fixes are evaluated from the location module
+ * thread and the store decision is made from the storage module thread.
+ */
+static K_MUTEX_DEFINE(geofence_lock);
+
+static struct {
+	struct geofence_zones zones;
+	struct zone_state state[CONFIG_APP_GEOFENCE_MAX_ZONES];
+
+	enum geofence_report_mode mode;
+	uint32_t heartbeat_interval;
+
+	/* Uptime of the last stored fix in GEOFENCE_REPORT_EVENTS mode, 0 if none */
+	int64_t last_report_ms;
+
+	/* Timestamps of the fixes that caused a transition and are not checked by the storage
+	 * module yet, 0 for free entries
+	 */
+	int64_t transition_fixes[TRANSITION_FIXES_MAX];
+} geofence = {
+	.mode = IS_ENABLED(CONFIG_APP_GEOFENCE_REPORT_EVENTS) ? GEOFENCE_REPORT_EVENTS :
+								  GEOFENCE_REPORT_ALL,
+	.heartbeat_interval = CONFIG_APP_GEOFENCE_HEARTBEAT_INTERVAL_SECONDS,
+};
+
+static void geofence_listener_cb(const struct zbus_channel *chan);
+
+ZBUS_LISTENER_DEFINE(geofence_listener, geofence_listener_cb);
+
+ZBUS_CHAN_DEFINE(geofence_chan,
+		 struct geofence_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS(geofence_listener),
+		 ZBUS_MSG_INIT(0)
+);
+
+/* Fixes are evaluated before the storage module gets them, see the storage_subscriber
+ * observer priority.
+ */
+ZBUS_CHAN_ADD_OBS(location_chan, geofence_listener, 0);
+
+/* Position of p in meters relative to the origin, with the equirectangular projection. It is
+ * accurate enough at the size of a geofence.
+ */
+static void project(double origin_lat, double origin_lon, double lat, double lon,
+		    double *x, double *y)
+{
+	*x = DEG_TO_RAD(lon - origin_lon) * cos(DEG_TO_RAD(origin_lat)) * EARTH_RADIUS_METERS;
+	*y = DEG_TO_RAD(lat - origin_lat) * EARTH_RADIUS_METERS;
+}
+
+/* Distance in meters from the origin to the segment from a to b */
+static double segment_distance_get(double ax, double ay, double bx, double by)
+{
+	double dx = bx - ax;
+	double dy = by - ay;
+	double length_sq = (dx * dx) + (dy * dy);
+	double t = 0.0;
+
+	if (length_sq > 0.0) {
+		t = CLAMP(-((ax * dx) + (ay * dy)) / length_sq, 0.0, 1.0);
+	}
+
+	dx = ax + (t * dx);
+	dy = ay + (t * dy);
+
+	return sqrt((dx * dx) + (dy * dy));
+}
+
+/* Signed distance in meters from the fix to the border of the zone, negative inside */
+static double zone_distance_get(const struct geofence_zone *zone, double lat, double lon)
+{
+	double ax, ay, bx, by;
+	double distance = FAR_AWAY_METERS;
+	bool inside = false;
+
+	if (zone->radius > 0) {
+		project(lat, lon, POINT_DEG(zone->points[0].lat), POINT_DEG(zone->points[0].lon),
+			&ax, &ay);
+
+		return sqrt((ax * ax) + (ay * ay)) - zone->radius;
+	}
+
+	/* Ray casting from the fix along the x axis, with the points relative to the fix */
+	for (size_t i = 0, j = zone->point_count - 1; i < zone->point_count; j = i++) {
+		project(lat, lon, POINT_DEG(zone->points[i].lat), POINT_DEG(zone->points[i].lon),
+			&ax, &ay);
+		project(lat, lon, POINT_DEG(zone->points[j].lat), POINT_DEG(zone->points[j].lon),
+			&bx, &by);
+
+		if (((ay > 0.0) != (by > 0.0)) && (0.0 < (ax + ((bx - ax) * -ay / (by - ay))))) {
+			inside = !inside;
+		}
+
+		distance = MIN(distance, segment_distance_get(ax, ay, bx, by));
+	}
+
+	return inside ? -distance : distance;
+}
+
+static void zone_bounds_set(const struct geofence_zone *zone, struct zone_state *state)
+{
+	double margin = (double)zone->radius + CONFIG_APP_GEOFENCE_HYSTERESIS_METERS;
+	double lat_margin;
+	double lon_margin;
+
+	state->lat_min = POINT_DEG(zone->points[0].lat);
+	state->lat_max = state->lat_min;
+	state->lon_min = POINT_DEG(zone->points[0].lon);
+	state->lon_max = state->lon_min;
+
+	for (size_t i = 1; i < zone->point_count; i++) {
+		state->lat_min = MIN(state->lat_min, POINT_DEG(zone->points[i].lat));
+		state->lat_max = MAX(state->lat_max, POINT_DEG(zone->points[i].lat));
+		state->lon_min = MIN(state->lon_min, POINT_DEG(zone->points[i].lon));
+		state->lon_max = MAX(state->lon_max, POINT_DEG(zone->points[i].lon));
+	}
+
+	lat_margin = RAD_TO_DEG(margin / EARTH_RADIUS_METERS);
+
+	/* Widest at the latitude closest to a pole */
+	lon_margin = lat_margin / MAX(cos(DEG_TO_RAD(MAX(fabs(state->lat_min),
+							    fabs(state->lat_max)))), 0.01);
+
+	state->lat_min -= lat_margin;
+	state->lat_max += lat_margin;
+	state->lon_min -= lon_margin;
+	state->lon_max += lon_margin;
+}
+
+static bool zone_valid(const struct geofence_zone *zone)
+{
+	if (zone->radius > 0) {
+		return zone->point_count >= 1;
+	}
+
+	return (zone->point_count >= 3) && (zone->point_count <= CONFIG_APP_GEOFENCE_MAX_POINTS);
+}
+
+static bool zone_equal(const struct geofence_zone *a, const struct geofence_zone *b)
+{
+	return (a->id == b->id) && (a->radius == b->radius) &&
+	       (a->point_count == b->point_count) &&
+	       (memcmp(a->points, b->points, a->point_count * sizeof(a->points[0])) == 0);
+}
+
+/* Must be called with geofence_lock held */
+static void zones_set(const struct geofence_zones *zones)
+{
+	static struct geofence_zones valid;
+	struct zone_state state[CONFIG_APP_GEOFENCE_MAX_ZONES] = { 0 };
+
+	valid.count = 0;
+
+	for (size_t i = 0; i < MIN(zones->count, ARRAY_SIZE(zones->zones)); i++) {
+		const struct geofence_zone *zone = &zones->zones[i];
+
+		if (!zone_valid(zone)) {
+			LOG_WRN("Ignoring invalid zone %u", zone->id);
+
+			continue;
+		}
+
+		/* A zone that did not change keeps its state */
+		for (size_t j = 0; j < geofence.zones.count; j++) {
+			if (zone_equal(&geofence.zones.zones[j], zone)) {
+				state[valid.count].inside = geofence.state[j].inside;
+
+				break;
+			}
+		}
+
+		zone_bounds_set(zone, &state[valid.count]);
+		valid.zones[valid.count++] = *zone;
+	}
+
+	geofence.zones = valid;
+	memcpy(geofence.state, state, sizeof(state));
+
+	LOG_DBG("%u zones set", valid.count);
+}
+
+static void priority_event_send(uint32_t zone_id, bool entered)
+{
+	int err;
+	struct cloud_priority_msg msg = {
+		.type = CLOUD_PRIORITY_GEOFENCE,
+		.uptime_ms = k_uptime_get(),
+		.geofence.zone_id = zone_id,
+		.geofence.entered = entered,
+	};
+
+	err = zbus_chan_pub(&cloud_priority_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+static void transition_send(uint32_t zone_id, bool entered, const struct location_msg *msg)
+{
+	int err;
+	struct geofence_msg event = {
+		.type = entered ? GEOFENCE_ENTERED : GEOFENCE_EXITED,
+		.transition.zone_id = zone_id,
+		.transition.fix = msg->gnss_data,
+	};
+
+	LOG_INF("%s zone %u", entered ? "Entered" : "Left", zone_id);
+
+	err = zbus_chan_pub(&geofence_chan, &event, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+
+		return;
+	}
+
+	/* Transitions are sent right away instead of with the stored data */
+	priority_event_send(zone_id, entered);
+}
+
+/* Must be called with geofence_lock held */
+static void transition_fix_add(int64_t timestamp)
+{
+	size_t oldest = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(geofence.transition_fixes); i++) {
+		if (geofence.transition_fixes[i] == 0) {
+			geofence.transition_fixes[i] = timestamp;
+
+			return;
+		}
+
+		if (geofence.transition_fixes[i] < geofence.transition_fixes[oldest]) {
+			oldest = i;
+		}
+	}
+
+	LOG_WRN("Transition fix queue full, the oldest fix is stored as a regular fix");
+
+	geofence.transition_fixes[oldest] = timestamp;
+}
+
+/* Must be called with geofence_lock held */
+static bool transition_fix_take(int64_t timestamp)
+{
+	bool found = false;
+
+	for (size_t i = 0; i < ARRAY_SIZE(geofence.transition_fixes); i++) {
+		if (geofence.transition_fixes[i] == 0) {
+			continue;
+		}
+
+		/* Fixes are checked in order, older entries were never checked */
+		if (geofence.transition_fixes[i] <= timestamp) {
+			found = found || (geofence.transition_fixes[i] == timestamp);
+			geofence.transition_fixes[i] = 0;
+		}
+	}
+
+	return found;
+}
+
+/* Zone states are updated here, and transitions published, in the context of the location
+ * module thread. The storage module only asks whether a fix is stored, so that no events are
+ * published from its storage filter.
+ */
+static void location_evaluate(const struct location_msg *msg)
+{
+	const double lat = msg->gnss_data.latitude;
+	const double lon = msg->gnss_data.longitude;
+	bool transition = false;
+
+	/* An inaccurate fix could cause transitions back and forth at the border */
+	if (msg->gnss_data.accuracy > CONFIG_APP_GEOFENCE_MAX_ACCURACY_METERS) {
+		LOG_DBG("Fix accuracy %.0f m too low for geofencing", (double)msg->gnss_data.accuracy);
+
+		return;
+	}
+
+	k_mutex_lock(&geofence_lock, K_FOREVER);
+
+	for (size_t i = 0; i < geofence.zones.count; i++) {
+		struct zone_state *state = &geofence.state[i];
+		double distance = FAR_AWAY_METERS;
+		bool inside;
+
+		if ((lat >= state->lat_min) && (lat <= state->lat_max) &&
+		    (lon >= state->lon_min) && (lon <= state->lon_max)) {
+			distance = zone_distance_get(&geofence.zones.zones[i], lat, lon);
+		}
+
+		/* Leaving a zone takes a fix outside of it by the hysteresis */
+		inside = state->inside ?
+			 (distance <= CONFIG_APP_GEOFENCE_HYSTERESIS_METERS) :
+			 (distance <= 0.0);
+
+		if (inside != state->inside) {
+			state->inside = inside;
+			transition = true;
+
+			transition_send(geofence.zones.zones[i].id, inside, msg);
+		}
+	}
+
+	if (transition) {
+		transition_fix_add(msg->timestamp);
+	}
+
+	k_mutex_unlock(&geofence_lock);
+}
+
+static void geofence_msg_handle(const struct geofence_msg *msg)
+{
+	switch (msg->type) {
+	case GEOFENCE_ZONES_SET:
+		k_mutex_lock(&geofence_lock, K_FOREVER);
+		zones_set(&msg->zones);
+		k_mutex_unlock(&geofence_lock);
+		break;
+	case GEOFENCE_REPORT_SET:
+		k_mutex_lock(&geofence_lock, K_FOREVER);
+
+		geofence.mode = msg->report.mode;
+
+		if (msg->report.heartbeat_interval > 0) {
+			geofence.heartbeat_interval = msg->report.heartbeat_interval;
+		}
+
+		k_mutex_unlock(&geofence_lock);
+
+		LOG_DBG("Report mode: %d, heartbeat interval: %u seconds",
+			msg->report.mode, msg->report.heartbeat_interval);
+		break;
+	default:
+		break;
+	}
+}
+
+static void geofence_listener_cb(const struct zbus_channel *chan)
+{
+	if (chan == &location_chan) {
+		const struct location_msg *msg = zbus_chan_const_msg(chan);
+
+		if (msg->type == LOCATION_GNSS_DATA) {
+			location_evaluate(msg);
+		}
+	} else if (chan == &geofence_chan) {
+		geofence_msg_handle(zbus_chan_const_msg(chan));
+	}
+}
+
+bool geofence_location_store(const struct location_msg *msg)
+{
+	const int64_t now = k_uptime_get();
+	bool transition;
+	bool store;
+
+	k_mutex_lock(&geofence_lock, K_FOREVER);
+
+	transition = transition_fix_take(msg->timestamp);
+
+	if (geofence.mode == GEOFENCE_REPORT_ALL) {
+		store = true;
+	} else {
+		store = transition || (geofence.last_report_ms == 0) ||
+			((now - geofence.last_report_ms) >=
+			 ((int64_t)geofence.heartbeat_interval * MSEC_PER_SEC));
+	}
+
+	if (store) {
+		geofence.last_report_ms = now;
+	}
+
+	k_mutex_unlock(&geofence_lock);
+
+	return store;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _GEOFENCE_H_
+#define _GEOFENCE_H_
+
+#include <stdbool.h>
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "location.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Channels provided by this module */
+ZBUS_CHAN_DECLARE(
+	geofence_chan
+);
+
+/** @brief Which location fixes are stored and sent to the cloud */
+enum geofence_report_mode {
+	/* All fixes, geofence transitions are reported in addition */
+	GEOFENCE_REPORT_ALL = 0,
+
+	/* Only fixes at geofence transitions, and one fix per heartbeat interval */
+	GEOFENCE_REPORT_EVENTS = 1,
+};
+
+/** @brief Point of a zone, in millionths of a degree */
+struct geofence_point {
+	int32_t lat;
+	int32_t lon;
+};
+
+/** @brief Geofence zone.
+ *
+ *  A circle when radius is set, with the center in points[0]. A polygon otherwise, with at
+ *  least three points in order around it.
+ */
+struct geofence_zone {
+	uint32_t id;
+
+	/* Radius in meters, 0 for a polygon */
+	uint32_t radius;
+
+	uint8_t point_count;
+	struct geofence_point points[CONFIG_APP_GEOFENCE_MAX_POINTS];
+};
+
+/** @brief Set of zones that fixes are evaluated against */
+struct geofence_zones {
+	uint8_t count;
+	struct geofence_zone zones[CONFIG_APP_GEOFENCE_MAX_ZONES];
+};
+
+enum geofence_msg_type {
+	/* Output message types */
+
+	/* The device entered a zone. The zone ID and the fix are in .transition */
+	GEOFENCE_ENTERED = 0x1,
+
+	/* The device left a zone. The zone ID and the fix are in .transition */
+	GEOFENCE_EXITED,
+
+	/* Input message types */
+
+	/* Replace the zones with the ones in .zones. The state of zones with an unchanged ID and
+	 * shape is kept, so that sending the same zones again does not cause transitions.
+	 */
+	GEOFENCE_ZONES_SET,
+
+	/* Set the report mode and the heartbeat interval in .report */
+	GEOFENCE_REPORT_SET,
+};
+
+struct geofence_msg {
+	enum geofence_msg_type type;
+
+	union {
+		/* Valid for GEOFENCE_ENTERED and GEOFENCE_EXITED */
+		struct {
+			uint32_t zone_id;
+			struct location_gnss_data fix;
+		} transition;
+
+		/* Valid for GEOFENCE_ZONES_SET */
+		struct geofence_zones zones;
+
+		/* Valid for GEOFENCE_REPORT_SET */
+		struct {
+			enum geofence_report_mode mode;
+
+			/* Heartbeat interval in seconds in GEOFENCE_REPORT_EVENTS mode, 0 to keep
+			 * the current interval
+			 */
+			uint32_t heartbeat_interval;
+		} report;
+	};
+};
+
+/**
+ * @brief Check whether a GNSS fix is stored.
+ *
+ * The fix is evaluated against the zones by the module's listener on location_chan, which
+ * publishes GEOFENCE_ENTERED and GEOFENCE_EXITED and sends them on the cloud priority lane.
+ * Called by the storage module for every LOCATION_GNSS_DATA message before the fix is stored.
+ *
+ * @param[in] msg LOCATION_GNSS_DATA message.
+ *
+ * @return true if the fix is to be stored, false if it is dropped in GEOFENCE_REPORT_EVENTS
+ *	   mode.
+ */
+bool geofence_location_store(const struct location_msg *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _GEOFENCE_H_ */
@@ -12,27 +12,28 @@
 
 #include "app_common.h"
 #include "led.h"
+#include "led_pattern.h"
 
 #define PWM_LED0	DT_ALIAS(pwm_led0)
 #define PWM_LED1	DT_ALIAS(pwm_led1)
 #define PWM_LED2	DT_ALIAS(pwm_led2)
 
-#if DT_NODE_HAS_STATUS(PWM_LED0, okay)
-static const struct pwm_dt_spec pwm_led0 = PWM_DT_SPEC_GET(PWM_LED0);
-#else
+#if !DT_NODE_HAS_STATUS(PWM_LED0, okay)
 #error "Unsupported board: pwm-led 0 devicetree alias is not defined"
 #endif
-#if DT_NODE_HAS_STATUS(PWM_LED1, okay)
-static const struct pwm_dt_spec pwm_led1 = PWM_DT_SPEC_GET(PWM_LED1);
-#else
+#if !DT_NODE_HAS_STATUS(PWM_LED1, okay)
 #error "Unsupported board: pwm-led 1 devicetree alias is not defined"
 #endif
-#if DT_NODE_HAS_STATUS(PWM_LED2, okay)
-static const struct pwm_dt_spec pwm_led2 = PWM_DT_SPEC_GET(PWM_LED2);
-#else
+#if !DT_NODE_HAS_STATUS(PWM_LED2, okay)
 #error "Unsupported board: pwm-led 2 devicetree alias is not defined"
 #endif
 
+#if !defined(CONFIG_APP_LED_PWM_SEQUENCE)
+static const struct pwm_dt_spec pwm_led0 = PWM_DT_SPEC_GET(PWM_LED0);
+static const struct pwm_dt_spec pwm_led1 = PWM_DT_SPEC_GET(PWM_LED1);
+static const struct pwm_dt_spec pwm_led2 = PWM_DT_SPEC_GET(PWM_LED2);
+#endif /* !CONFIG_APP_LED_PWM_SEQUENCE */
+
 /* Register log module */
 LOG_MODULE_REGISTER(led, CONFIG_APP_LED_LOG_LEVEL);
 
@@ -54,50 +55,79 @@ ZBUS_CHAN_DEFINE(led_chan,
 /* Observe channels */
 ZBUS_CHAN_ADD_OBS(led_chan, led, 0);
 
+static void pattern_build(const struct led_msg *led_msg, struct led_pattern *pattern)
+{
+	*pattern = (struct led_pattern) {
+		.steps[LED_STEP_ON] = {
+			.red = led_msg->red,
+			.green = led_msg->green,
+			.blue = led_msg->blue,
+			.duration_msec = led_msg->duration_on_msec,
+		},
+		.steps[LED_STEP_OFF] = {
+			.duration_msec = led_msg->duration_off_msec,
+		},
+		.repetitions = led_msg->repetitions,
+	};
+}
+
+#if defined(CONFIG_APP_LED_PWM_SEQUENCE)
+/* Function called when there is a message received on a channel that the module listens to */
+static void led_callback(const struct zbus_channel *chan)
+{
+	if (&led_chan == chan) {
+		struct led_pattern pattern;
+
+		pattern_build(zbus_chan_const_msg(chan), &pattern);
+
+		/* The PWM peripheral plays the whole pattern without waking up the CPU */
+		led_pwm_sequence_play(&pattern);
+	}
+}
+
+static int led_init(void)
+{
+	return led_pwm_sequence_init();
+}
+#else
 static struct k_work_delayable blink_work;
 
 /* Structure to hold all LED state variables */
 struct led_state {
-	struct led_msg current_state;
-	bool is_on;
+	struct led_pattern pattern;
+	enum led_step_index step;
 	int repetitions;
 };
 
 static struct led_state led_state;
-static void blink_timer_handler(struct k_work *work);
 
-static int pwm_out(const struct led_msg *led_msg, bool force_off)
+static int pwm_out(const struct led_step *step)
 {
 	int err;
 
 	#define PWM_PERIOD PWM_USEC(255)
 
-	/* If force_off is true, turn off all LEDs regardless of led_msg values */
-	uint8_t red = force_off ? 0 : led_msg->red;
-	uint8_t green = force_off ? 0 : led_msg->green;
-	uint8_t blue = force_off ? 0 : led_msg->blue;
-
 	if (!pwm_is_ready_dt(&pwm_led0)) {
 		LOG_ERR("Error: PWM device %s is not ready\n", pwm_led0.dev->name);
 		return -ENODEV;
 	}
 
 	/* RED */
-	err = pwm_set_dt(&pwm_led0, PWM_PERIOD, PWM_USEC(red));
+	err = pwm_set_dt(&pwm_led0, PWM_PERIOD, PWM_USEC(step->red));
 	if (err) {
 		LOG_ERR("pwm_set_dt, error:%d", err);
 		return err;
 	}
 
 	/* GREEN */
-	err = pwm_set_dt(&pwm_led1, PWM_PERIOD, PWM_USEC(green));
+	err = pwm_set_dt(&pwm_led1, PWM_PERIOD, PWM_USEC(step->green));
 	if (err) {
 		LOG_ERR("pwm_set_dt, error:%d", err);
 		return err;
 	}
 
 	/* BLUE */
-	err = pwm_set_dt(&pwm_led2, PWM_PERIOD, PWM_USEC(blue));
+	err = pwm_set_dt(&pwm_led2, PWM_PERIOD, PWM_USEC(step->blue));
 	if (err) {
 		LOG_ERR("pwm_set_dt, error:%d", err);
 		return err;
@@ -106,75 +136,69 @@ static int pwm_out(const struct led_msg *led_msg, bool force_off)
 	return 0;
 }
 
-/* Timer work handler for LED blinking */
-static void blink_timer_handler(struct k_work *work)
+/* Show a step of the pattern, and schedule the next one if the pattern continues */
+static void step_play(enum led_step_index step, bool schedule)
 {
 	int err;
 
-	ARG_UNUSED(work);
+	led_state.step = step;
 
-	led_state.is_on = !led_state.is_on;
-
-	/* Update LED state */
-	err = pwm_out(&led_state.current_state, !led_state.is_on);
+	err = pwm_out(&led_state.pattern.steps[step]);
 	if (err) {
 		LOG_ERR("pwm_out, error: %d", err);
 		SEND_FATAL_ERROR();
+		return;
 	}
 
-	/* If LED just turned off, we completed one cycle */
-	if (!led_state.is_on && led_state.repetitions > 0) {
-		led_state.repetitions--;
-		if (led_state.repetitions == 0) {
-			/* We're done, don't schedule next toggle */
-			return;
-		}
+	if (!schedule) {
+		return;
 	}
 
-	/* Schedule next toggle */
-	uint32_t next_delay = led_state.is_on ?
-		led_state.current_state.duration_on_msec :
-		led_state.current_state.duration_off_msec;
-
-	err = k_work_schedule(&blink_work, K_MSEC(next_delay));
+	err = k_work_schedule(&blink_work, K_MSEC(led_state.pattern.steps[step].duration_msec));
 	if (err < 0) {
 		LOG_ERR("k_work_schedule, error: %d", err);
 		SEND_FATAL_ERROR();
 	}
 }
 
+/* Timer work handler for LED blinking */
+static void blink_timer_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	if (led_state.step == LED_STEP_OFF) {
+		step_play(LED_STEP_ON, true);
+		return;
+	}
+
+	/* The end of the on step completes one cycle. The off step of the last cycle is not
+	 * waited for.
+	 */
+	if (led_state.repetitions > 0) {
+		led_state.repetitions--;
+	}
+
+	step_play(LED_STEP_OFF, led_state.repetitions != 0);
+}
+
 /* Function called when there is a message received on a channel that the module listens to */
 static void led_callback(const struct zbus_channel *chan)
 {
 	if (&led_chan == chan) {
-		int err;
-		const struct led_msg *led_msg = zbus_chan_const_msg(chan);
-
 		/* Cancel any existing blink timer */
 		(void)k_work_cancel_delayable(&blink_work);
 
-		/* Store the new LED state */
-		memcpy(&led_state.current_state, led_msg, sizeof(struct led_msg));
+		/* Store the new pattern */
+		pattern_build(zbus_chan_const_msg(chan), &led_state.pattern);
 
 		/* Set up repetitions */
-		led_state.repetitions = led_msg->repetitions;
+		led_state.repetitions = led_state.pattern.repetitions;
 
 		/* If repetitions is 0, turn LED off. Otherwise LED on */
-		led_state.is_on = (led_state.repetitions != 0);
-
-		err = pwm_out(led_msg, !led_state.is_on);
-		if (err) {
-			LOG_ERR("pwm_out, error: %d", err);
-			SEND_FATAL_ERROR();
-		}
-
-		/* Schedule first toggle if LED should be blinking */
-		if (led_state.is_on) {
-			err = k_work_schedule(&blink_work, K_MSEC(led_msg->duration_on_msec));
-			if (err < 0) {
-				LOG_ERR("k_work_schedule, error: %d", err);
-				SEND_FATAL_ERROR();
-			}
+		if (led_state.repetitions == 0) {
+			step_play(LED_STEP_OFF, false);
+		} else {
+			step_play(LED_STEP_ON, true);
 		}
 	}
 }
@@ -185,6 +209,7 @@ static int led_init(void)
 
 	return 0;
 }
+#endif /* CONFIG_APP_LED_PWM_SEQUENCE */
 
 /* Initialize module at SYS_INIT() */
 SYS_INIT(led_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
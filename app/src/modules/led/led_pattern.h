@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _LED_PATTERN_H_
+#define _LED_PATTERN_H_
+
+#include <zephyr/kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Index of the on and off steps of a blink pattern */
+enum led_step_index {
+	LED_STEP_ON,
+	LED_STEP_OFF,
+	LED_STEP_COUNT,
+};
+
+/** @brief Step of a pattern, the color is shown for the duration */
+struct led_step {
+	uint8_t red;
+	uint8_t green;
+	uint8_t blue;
+
+	uint32_t duration_msec;
+};
+
+/** @brief Pattern precomputed from an LED_RGB_SET message */
+struct led_pattern {
+	struct led_step steps[LED_STEP_COUNT];
+
+	/* Number of times the steps are played, -1 for forever and 0 for LEDs off */
+	int repetitions;
+};
+
+#if defined(CONFIG_APP_LED_PWM_SEQUENCE)
+/**
+ * @brief Initialize the PWM peripheral for pattern playback.
+ *
+ * @retval 0 on success.
+ * @retval -EIO if the PWM peripheral could not be initialized.
+ */
+int led_pwm_sequence_init(void);
+
+/**
+ * @brief Play a pattern with the PWM peripheral.
+ *
+ * The pattern that is playing is stopped first. The peripheral steps through the pattern on
+ * its own, so the CPU is not woken up until the next pattern is set. Once all repetitions
+ * have been played, the peripheral stops with the LEDs off.
+ *
+ * @param[in] pattern Pattern to play.
+ */
+void led_pwm_sequence_play(const struct led_pattern *pattern);
+#endif /* CONFIG_APP_LED_PWM_SEQUENCE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LED_PATTERN_H_ */
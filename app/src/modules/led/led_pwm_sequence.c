@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/pinctrl.h>
+#include <zephyr/dt-bindings/pwm/pwm.h>
+#include <zephyr/logging/log.h>
+#include <nrfx_pwm.h>
+#include <hal/nrf_gpio.h>
+#include <string.h>
+
+#include "led_pattern.h"
+
+LOG_MODULE_DECLARE(led, CONFIG_APP_LED_LOG_LEVEL);
+
+#define PWM_LED0	DT_ALIAS(pwm_led0)
+#define PWM_LED1	DT_ALIAS(pwm_led1)
+#define PWM_LED2	DT_ALIAS(pwm_led2)
+#define PWM_NODE	DT_PWMS_CTLR(PWM_LED0)
+
+BUILD_ASSERT(DT_SAME_NODE(PWM_NODE, DT_PWMS_CTLR(PWM_LED1)) &&
+	     DT_SAME_NODE(PWM_NODE, DT_PWMS_CTLR(PWM_LED2)),
+	     "The pwm-led0, pwm-led1 and pwm-led2 aliases must use the same PWM instance");
+BUILD_ASSERT(DT_SAME_NODE(PWM_NODE, DT_NODELABEL(pwm0)),
+	     "The LEDs must be on pwm0 for CONFIG_APP_LED_PWM_SEQUENCE");
+BUILD_ASSERT(!DT_NODE_HAS_STATUS(PWM_NODE, okay),
+	     "pwm0 is owned by the LED module with CONFIG_APP_LED_PWM_SEQUENCE, it must be disabled "
+	     "in devicetree, see overlay-led-pwm-sequence.overlay");
+
+/* A 1 MHz clock with a top value of 255 gives the same 255 us period and the same duty cycle
+ * per color value as the PWM driver path.
+ */
+#define PWM_TOP_VALUE		255
+#define PWM_PERIOD_USEC		255
+
+/* Bit 15 of a sequence value selects the polarity, set for an output that is high during the
+ * compare value.
+ */
+#define PWM_POLARITY_BIT	BIT(15)
+
+/* The REFRESH register holds the number of extra periods a value is played for */
+#define PWM_REFRESH_MAX		0xFFFFFF
+
+PINCTRL_DT_DEFINE(PWM_NODE);
+
+static const nrfx_pwm_t pwm = NRFX_PWM_INSTANCE(0);
+
+static const struct {
+	uint8_t channel;
+	bool inverted;
+} channels[] = {
+	{ DT_PWMS_CHANNEL(PWM_LED0), DT_PWMS_FLAGS(PWM_LED0) & PWM_POLARITY_INVERTED },
+	{ DT_PWMS_CHANNEL(PWM_LED1), DT_PWMS_FLAGS(PWM_LED1) & PWM_POLARITY_INVERTED },
+	{ DT_PWMS_CHANNEL(PWM_LED2), DT_PWMS_FLAGS(PWM_LED2) & PWM_POLARITY_INVERTED },
+};
+
+/* Values of the on and off steps, read by EasyDMA while the pattern is playing */
+static nrf_pwm_values_individual_t values[LED_STEP_COUNT];
+
+static nrf_pwm_sequence_t sequences[LED_STEP_COUNT] = {
+	[LED_STEP_ON] = {
+		.values.p_individual = &values[LED_STEP_ON],
+		.length = NRF_PWM_VALUES_LENGTH(values[LED_STEP_ON]),
+	},
+	[LED_STEP_OFF] = {
+		.values.p_individual = &values[LED_STEP_OFF],
+		.length = NRF_PWM_VALUES_LENGTH(values[LED_STEP_OFF]),
+	},
+};
+
+static uint16_t channel_value(size_t led, uint8_t color)
+{
+	return color | (channels[led].inverted ? 0 : PWM_POLARITY_BIT);
+}
+
+/* Fill in the values of a step, and the number of periods that the values are played for */
+static void step_set(enum led_step_index index, const struct led_step *step)
+{
+	uint16_t *channel_values = (uint16_t *)&values[index];
+	const uint8_t colors[] = { step->red, step->green, step->blue };
+	uint32_t periods = (uint32_t)(((uint64_t)step->duration_msec * USEC_PER_MSEC) /
+				      PWM_PERIOD_USEC);
+
+	memset(&values[index], 0, sizeof(values[index]));
+
+	for (size_t i = 0; i < ARRAY_SIZE(channels); i++) {
+		channel_values[channels[i].channel] = channel_value(i, colors[i]);
+	}
+
+	sequences[index].repeats = CLAMP(periods, 1, PWM_REFRESH_MAX + 1) - 1;
+}
+
+void led_pwm_sequence_play(const struct led_pattern *pattern)
+{
+	uint16_t count;
+
+	/* The values are read by EasyDMA, they are only updated once the peripheral stopped. A
+	 * stopped peripheral leaves the pins to the GPIO, which keeps the LEDs off.
+	 */
+	(void)nrfx_pwm_stop(&pwm, true);
+
+	if (pattern->repetitions == 0) {
+		return;
+	}
+
+	step_set(LED_STEP_ON, &pattern->steps[LED_STEP_ON]);
+	step_set(LED_STEP_OFF, &pattern->steps[LED_STEP_OFF]);
+
+	if (pattern->repetitions < 0) {
+		(void)nrfx_pwm_complex_playback(&pwm, &sequences[LED_STEP_ON],
+						&sequences[LED_STEP_OFF], 1, NRFX_PWM_FLAG_LOOP);
+
+		return;
+	}
+
+	count = MIN(pattern->repetitions, UINT16_MAX);
+
+	/* The pattern ends with the off step, after which the peripheral stops */
+	(void)nrfx_pwm_complex_playback(&pwm, &sequences[LED_STEP_ON], &sequences[LED_STEP_OFF],
+					count, NRFX_PWM_FLAG_STOP);
+}
+
+int led_pwm_sequence_init(void)
+{
+	int err;
+	nrfx_err_t nrfx_err;
+	nrfx_pwm_config_t config = {
+		.irq_priority = NRFX_PWM_DEFAULT_CONFIG_IRQ_PRIORITY,
+		.base_clock = NRF_PWM_CLK_1MHz,
+		.count_mode = NRF_PWM_MODE_UP,
+		.top_value = PWM_TOP_VALUE,
+		.load_mode = NRF_PWM_LOAD_INDIVIDUAL,
+		.step_mode = NRF_PWM_STEP_AUTO,
+		/* Pins are configured from devicetree */
+		.skip_gpio_cfg = true,
+		.skip_psel_cfg = true,
+	};
+
+	err = pinctrl_apply_state(PINCTRL_DT_DEV_CONFIG_GET(PWM_NODE), PINCTRL_STATE_DEFAULT);
+	if (err) {
+		LOG_ERR("pinctrl_apply_state, error: %d", err);
+		return err;
+	}
+
+	/* Keep the LEDs off while the peripheral is stopped */
+	for (size_t i = 0; i < ARRAY_SIZE(channels); i++) {
+		uint32_t pin = nrf_pwm_pin_get(pwm.p_reg, channels[i].channel);
+
+		if (pin != NRF_PWM_PIN_NOT_CONNECTED) {
+			nrf_gpio_pin_write(pin, channels[i].inverted ? 1 : 0);
+		}
+	}
+
+	/* No event handler, the peripheral is only controlled from led_pwm_sequence_play() */
+	nrfx_err = nrfx_pwm_init(&pwm, &config, NULL, NULL);
+	if (nrfx_err != NRFX_SUCCESS) {
+		LOG_ERR("nrfx_pwm_init, error: 0x%08x", nrfx_err);
+		return -EIO;
+	}
+
+	return 0;
+}
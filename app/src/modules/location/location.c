@@ -14,11 +14,27 @@
 #include <nrf_modem_gnss.h>
 #include <date_time.h>
 #include <modem/nrf_modem_lib.h>
+#include <string.h>
 
 #include "app_common.h"
+#include "state_stats.h"
+#include "zbus_stats.h"
+#include "handler_stats.h"
 #include "modem/lte_lc.h"
 #include "location.h"
 #include "location_helper.h"
+#if defined(CONFIG_APP_LOCATION_CACHE)
+#include "location_cache.h"
+#endif /* CONFIG_APP_LOCATION_CACHE */
+#if defined(CONFIG_APP_LOCATION_GNSS_FILTER)
+#include "location_gnss_filter.h"
+#endif /* CONFIG_APP_LOCATION_GNSS_FILTER */
+#if defined(CONFIG_APP_LOCATION_GNSS_TRACKING)
+#include "location_gnss_tracking.h"
+#endif /* CONFIG_APP_LOCATION_GNSS_TRACKING */
+#if defined(CONFIG_APP_LOCATION_WIFI_POWER_OFF)
+#include "location_wifi_power.h"
+#endif /* CONFIG_APP_LOCATION_WIFI_POWER_OFF */
 
 LOG_MODULE_REGISTER(location_module, CONFIG_APP_LOCATION_LOG_LEVEL);
 
@@ -47,14 +63,45 @@ ZBUS_CHAN_DEFINE(location_chan,
 		 ZBUS_MSG_INIT(0)
 );
 
+ZBUS_STATS_CHAN_DEFINE(location_chan);
+ZBUS_STATS_METRIC_DEFINE(location_chan, location_chan);
+
+#if defined(CONFIG_APP_LOCATION_GNSS_DETAILS)
+ZBUS_CHAN_DEFINE(location_gnss_details_chan,
+		 struct location_data,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+#endif /* CONFIG_APP_LOCATION_GNSS_DETAILS */
+
 /* Private channel message types for internal state management. */
 enum priv_location_msg_type {
 	/* Modem functional mode has been set. */
 	LOCATION_PRIV_CFUN_REQUIRED_SET,
+
+	/* The serving cell has changed. */
+	LOCATION_PRIV_CELL_UPDATE,
+
+	/* The GNSS tracking fix buffer is full. */
+	LOCATION_PRIV_TRACKING_BUFFER_FULL,
+
+	/* GNSS tracking needs assistance data. */
+	LOCATION_PRIV_TRACKING_AGNSS_REQUEST,
 };
 
 struct priv_location_msg {
 	enum priv_location_msg_type type;
+
+	/* Serving cell, valid for LOCATION_PRIV_CELL_UPDATE */
+	uint32_t cell_id;
+	uint32_t tac;
+
+#if defined(CONFIG_APP_LOCATION_GNSS_TRACKING)
+	/* Valid for LOCATION_PRIV_TRACKING_AGNSS_REQUEST */
+	struct nrf_modem_gnss_agnss_data_frame agnss_request;
+#endif /* CONFIG_APP_LOCATION_GNSS_TRACKING */
 };
 
 /* Create private location channel for internal messaging that is not intended for external use. */
@@ -88,6 +135,9 @@ CHANNEL_LIST(ADD_OBSERVERS)
 /* Forward declarations */
 static void location_event_handler(const struct location_event_data *event_data);
 static void on_cfun(int mode, void *ctx);
+#if defined(CONFIG_APP_LOCATION_CACHE)
+static void lte_lc_evt_handler(const struct lte_lc_evt *const evt);
+#endif /* CONFIG_APP_LOCATION_CACHE */
 
 NRF_MODEM_LIB_ON_CFUN(location_cfun_hook, on_cfun, NULL);
 
@@ -140,6 +190,7 @@ struct location_state_object {
 /* Forward declarations of state handlers */
 static enum smf_state_result state_waiting_for_cfun_run(void *obj);
 static void state_running_entry(void *obj);
+static enum smf_state_result state_running_run(void *obj);
 static void state_location_search_inactive_entry(void *obj);
 static enum smf_state_result state_location_search_inactive_run(void *obj);
 static void state_location_search_active_entry(void *obj);
@@ -155,7 +206,7 @@ static const struct smf_state states[] = {
 				 NULL),
 	[STATE_RUNNING] =
 		SMF_CREATE_STATE(state_running_entry,
-				 NULL,
+				 state_running_run,
 				 NULL,
 				 NULL,
 				 &states[STATE_LOCATION_SEARCH_INACTIVE]),
@@ -173,6 +224,11 @@ static const struct smf_state states[] = {
 				 NULL),
 };
 
+STATE_STATS_DEFINE(location, states);
+STATE_STATS_METRIC_DEFINE(location, STATE_LOCATION_SEARCH_ACTIVE, location_search);
+HANDLER_STATS_DEFINE(location, CONFIG_APP_LOCATION_MSG_PROCESSING_TIMEOUT_SECONDS);
+HANDLER_STATS_METRIC_DEFINE(location);
+
 static void location_wdt_callback(int channel_id, void *user_data)
 {
 	LOG_ERR("Watchdog expired, Channel: %d, Thread: %s",
@@ -223,13 +279,14 @@ static void agnss_request_send(const struct nrf_modem_gnss_agnss_data_frame *agn
 }
 #endif /* defined(CONFIG_NRF_CLOUD_AGNSS) */
 
-static void gnss_location_send(const struct location_data *location_data)
+static void gnss_location_send(const struct location_gnss_data *gnss_data, bool cached)
 {
 	int err;
 	struct location_msg location_msg = {
 		.type = LOCATION_GNSS_DATA,
-		.gnss_data = *location_data,
-		.timestamp = k_uptime_get()
+		.gnss_data = *gnss_data,
+		.timestamp = k_uptime_get(),
+		.cached = cached
 	};
 
 	err = date_time_now(&location_msg.timestamp);
@@ -247,6 +304,19 @@ static void gnss_location_send(const struct location_data *location_data)
 	}
 }
 
+#if defined(CONFIG_APP_LOCATION_GNSS_DETAILS)
+static void gnss_details_send(const struct location_data *location_data)
+{
+	int err;
+
+	err = zbus_chan_pub(&location_gnss_details_chan, location_data, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+#endif /* CONFIG_APP_LOCATION_GNSS_DETAILS */
+
 static void message_send(enum location_msg_type msg_type)
 {
 	int err;
@@ -261,6 +331,282 @@ static void message_send(enum location_msg_type msg_type)
 	}
 }
 
+#if defined(CONFIG_APP_LOCATION_CACHE)
+static void lte_lc_evt_handler(const struct lte_lc_evt *const evt)
+{
+	int err;
+	struct priv_location_msg msg = {
+		.type = LOCATION_PRIV_CELL_UPDATE,
+	};
+
+	if (evt->type != LTE_LC_EVT_CELL_UPDATE) {
+		return;
+	}
+
+	msg.cell_id = evt->cell.id;
+	msg.tac = evt->cell.tac;
+
+	err = zbus_chan_pub(&priv_location_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+/* Publish the cached fix instead of running a location search, if the device has not moved.
+ * Returns true if the cached fix was used.
+ */
+static bool cached_location_send(void)
+{
+	const struct location_gnss_data *fix = location_cache_get();
+
+	if (fix == NULL) {
+		return false;
+	}
+
+	LOG_DBG("No movement since the last GNSS fix, reusing it");
+
+	gnss_location_send(fix, true);
+	message_send(LOCATION_SEARCH_DONE);
+
+	return true;
+}
+#endif /* CONFIG_APP_LOCATION_CACHE */
+
+#if defined(CONFIG_APP_LOCATION_CACHE_WIFI)
+/* Publish the cached Wi-Fi scan instead of running a location search, if the device has not
+ * moved. Returns true if the cached scan was used.
+ */
+static bool cached_wifi_send(void)
+{
+	int err;
+	const struct location_cloud_request_data *request = location_cache_wifi_get();
+	struct location_msg location_msg = {
+		.type = LOCATION_CLOUD_REQUEST,
+		.cached = true
+	};
+
+	if (request == NULL) {
+		return false;
+	}
+
+	LOG_DBG("No movement since the last Wi-Fi scan, reusing it");
+
+	location_msg.cloud_request = *request;
+
+	err = zbus_chan_pub(&location_chan, &location_msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+
+		return true;
+	}
+
+	message_send(LOCATION_SEARCH_DONE);
+
+	return true;
+}
+#endif /* CONFIG_APP_LOCATION_CACHE_WIFI */
+
+/* Take time from PVT data and apply it to system time. */
+#if defined(CONFIG_LOCATION_METHOD_GNSS)
+static void apply_gnss_time(const struct nrf_modem_gnss_pvt_data_frame *pvt_data)
+{
+	struct tm gnss_time = {
+		.tm_year = pvt_data->datetime.year - 1900,
+		.tm_mon = pvt_data->datetime.month - 1,
+		.tm_mday = pvt_data->datetime.day,
+		.tm_hour = pvt_data->datetime.hour,
+		.tm_min = pvt_data->datetime.minute,
+		.tm_sec = pvt_data->datetime.seconds,
+	};
+
+	date_time_set(&gnss_time);
+}
+#endif /* CONFIG_LOCATION_METHOD_GNSS */
+
+#if defined(CONFIG_APP_LOCATION_COMBINED_CLOUD_SCAN) || defined(CONFIG_APP_LOCATION_GNSS_TRACKING)
+/* Default location methods in order of priority, see CONFIG_LOCATION_REQUEST_DEFAULT_METHOD_* */
+static const enum location_method default_methods[] = {
+#if defined(CONFIG_LOCATION_REQUEST_DEFAULT_METHOD_FIRST_GNSS)
+	LOCATION_METHOD_GNSS,
+#elif defined(CONFIG_LOCATION_REQUEST_DEFAULT_METHOD_FIRST_CELLULAR)
+	LOCATION_METHOD_CELLULAR,
+#elif defined(CONFIG_LOCATION_REQUEST_DEFAULT_METHOD_FIRST_WIFI)
+	LOCATION_METHOD_WIFI,
+#endif
+#if defined(CONFIG_LOCATION_REQUEST_DEFAULT_METHOD_SECOND_GNSS)
+	LOCATION_METHOD_GNSS,
+#elif defined(CONFIG_LOCATION_REQUEST_DEFAULT_METHOD_SECOND_CELLULAR)
+	LOCATION_METHOD_CELLULAR,
+#elif defined(CONFIG_LOCATION_REQUEST_DEFAULT_METHOD_SECOND_WIFI)
+	LOCATION_METHOD_WIFI,
+#endif
+#if defined(CONFIG_LOCATION_REQUEST_DEFAULT_METHOD_THIRD_GNSS)
+	LOCATION_METHOD_GNSS,
+#elif defined(CONFIG_LOCATION_REQUEST_DEFAULT_METHOD_THIRD_CELLULAR)
+	LOCATION_METHOD_CELLULAR,
+#elif defined(CONFIG_LOCATION_REQUEST_DEFAULT_METHOD_THIRD_WIFI)
+	LOCATION_METHOD_WIFI,
+#endif
+};
+#endif /* CONFIG_APP_LOCATION_COMBINED_CLOUD_SCAN || CONFIG_APP_LOCATION_GNSS_TRACKING */
+
+/* Start a location search with the default methods. With GNSS tracking, GNSS is left out, and
+ * -ENOENT is returned if no other method is enabled.
+ */
+static int location_search_start(void)
+{
+#if defined(CONFIG_APP_LOCATION_COMBINED_CLOUD_SCAN) || defined(CONFIG_APP_LOCATION_GNSS_TRACKING)
+	struct location_config config;
+	enum location_method methods[ARRAY_SIZE(default_methods)];
+	size_t count = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(default_methods); i++) {
+		/* GNSS is used by tracking, the location library must not start it */
+		if (IS_ENABLED(CONFIG_APP_LOCATION_GNSS_TRACKING) &&
+		    (default_methods[i] == LOCATION_METHOD_GNSS)) {
+			continue;
+		}
+
+		methods[count++] = default_methods[i];
+	}
+
+	if (count == 0) {
+		return -ENOENT;
+	}
+
+#if defined(CONFIG_APP_LOCATION_COMBINED_CLOUD_SCAN)
+	/* Let the location library run the Wi-Fi scan and the cell measurement together */
+	location_methods_combine(methods, count);
+#endif /* CONFIG_APP_LOCATION_COMBINED_CLOUD_SCAN */
+	location_config_defaults_set(&config, count, methods);
+#endif /* CONFIG_APP_LOCATION_COMBINED_CLOUD_SCAN || CONFIG_APP_LOCATION_GNSS_TRACKING */
+
+#if defined(CONFIG_APP_LOCATION_WIFI_POWER_OFF)
+	/* Without Wi-Fi, the location library falls back to the next method */
+	int err = location_wifi_power_on();
+
+	if (err) {
+		LOG_WRN("location_wifi_power_on, error: %d", err);
+	}
+#endif /* CONFIG_APP_LOCATION_WIFI_POWER_OFF */
+
+#if defined(CONFIG_APP_LOCATION_COMBINED_CLOUD_SCAN) || defined(CONFIG_APP_LOCATION_GNSS_TRACKING)
+	return location_request(&config);
+#else
+	return location_request(NULL);
+#endif /* CONFIG_APP_LOCATION_COMBINED_CLOUD_SCAN || CONFIG_APP_LOCATION_GNSS_TRACKING */
+}
+
+#if defined(CONFIG_APP_LOCATION_GNSS_TRACKING)
+/* Called in interrupt context, the fixes are read from the location module thread */
+static void tracking_event_handler(const struct location_gnss_tracking_evt *evt)
+{
+	int err;
+	struct priv_location_msg msg = { 0 };
+
+	if (evt->type == LOCATION_GNSS_TRACKING_EVT_BUFFER_FULL) {
+		msg.type = LOCATION_PRIV_TRACKING_BUFFER_FULL;
+	} else if (evt->type == LOCATION_GNSS_TRACKING_EVT_AGNSS_REQUEST) {
+		msg.type = LOCATION_PRIV_TRACKING_AGNSS_REQUEST;
+		msg.agnss_request = evt->agnss_request;
+	} else {
+		return;
+	}
+
+	err = zbus_chan_pub(&priv_location_chan, &msg, K_NO_WAIT);
+	if (err) {
+		LOG_WRN("zbus_chan_pub, error: %d", err);
+	}
+}
+
+static void tracking_start(void)
+{
+	int err;
+
+	err = location_gnss_tracking_start(tracking_event_handler);
+	if (err) {
+		LOG_ERR("location_gnss_tracking_start, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+/* Set the system time from a buffered fix. The fix can be several fix intervals old, so the
+ * time since it was received is added.
+ */
+static void tracking_time_apply(int64_t timestamp_ms, int64_t uptime_ms)
+{
+	struct tm now;
+	const time_t now_sec = (timestamp_ms + (k_uptime_get() - uptime_ms)) / MSEC_PER_SEC;
+
+	if (gmtime_r(&now_sec, &now) == NULL) {
+		return;
+	}
+
+	date_time_set(&now);
+}
+
+/* Publish the fixes collected by GNSS tracking, in the order they were taken.
+ * Returns the number of fixes published.
+ */
+static size_t tracking_fixes_send(void)
+{
+	struct location_data location;
+	int64_t uptime_ms;
+	int64_t timestamp_ms;
+	int64_t newest_uptime_ms = 0;
+	int64_t newest_timestamp_ms = 0;
+	bool fix_read = false;
+	size_t count = 0;
+
+	while (location_gnss_tracking_get(&location, &uptime_ms, &timestamp_ms) == 0) {
+		struct location_msg location_msg = {
+			.type = LOCATION_GNSS_DATA,
+			.timestamp = timestamp_ms,
+		};
+		int err;
+
+		/* Fixes are read oldest first, the time is set from the newest one */
+		newest_uptime_ms = uptime_ms;
+		newest_timestamp_ms = timestamp_ms;
+		fix_read = true;
+
+#if defined(CONFIG_APP_LOCATION_GNSS_FILTER)
+		/* Keep poor fixes and outliers out of storage and cloud */
+		if (!location_gnss_filter_check_at(&location, uptime_ms)) {
+			continue;
+		}
+#endif /* CONFIG_APP_LOCATION_GNSS_FILTER */
+
+#if defined(CONFIG_APP_LOCATION_GNSS_DETAILS)
+		gnss_details_send(&location);
+#endif /* CONFIG_APP_LOCATION_GNSS_DETAILS */
+
+		location_gnss_data_get(&location_msg.gnss_data, &location);
+
+		err = zbus_chan_pub(&location_chan, &location_msg, PUB_TIMEOUT);
+		if (err) {
+			LOG_ERR("zbus_chan_pub, error: %d", err);
+			SEND_FATAL_ERROR();
+
+			return count;
+		}
+
+		count++;
+	}
+
+	/* GNSS is the most accurate time source - use it. */
+	if (fix_read) {
+		tracking_time_apply(newest_timestamp_ms, newest_uptime_ms);
+	}
+
+	LOG_DBG("Published %zu GNSS tracking fixes", count);
+
+	return count;
+}
+#endif /* CONFIG_APP_LOCATION_GNSS_TRACKING */
+
 /* State handlers */
 
 static enum smf_state_result state_waiting_for_cfun_run(void *obj)
@@ -290,6 +636,10 @@ static void state_running_entry(void *obj)
 
 	LOG_DBG("%s", __func__);
 
+#if defined(CONFIG_APP_LOCATION_CACHE)
+	lte_lc_register_handler(lte_lc_evt_handler);
+#endif /* CONFIG_APP_LOCATION_CACHE */
+
 	err = location_init(location_event_handler);
 	if (err) {
 		LOG_ERR("Unable to init location library: %d", err);
@@ -297,6 +647,10 @@ static void state_running_entry(void *obj)
 		return;
 	}
 
+#if defined(CONFIG_APP_LOCATION_GNSS_TRACKING)
+	tracking_start();
+#endif /* CONFIG_APP_LOCATION_GNSS_TRACKING */
+
 	const struct location_msg ready_msg = {
 		.type = LOCATION_MODULE_READY
 	};
@@ -311,11 +665,88 @@ static void state_running_entry(void *obj)
 	LOG_DBG("Location library initialized");
 }
 
+static enum smf_state_result state_running_run(void *obj)
+{
+	struct location_state_object *state_object = obj;
+
+#if defined(CONFIG_APP_LOCATION_GNSS_TRACKING)
+	if (state_object->chan == &priv_location_chan) {
+		const struct priv_location_msg *msg =
+			(const struct priv_location_msg *)state_object->msg_buf;
+
+		if (msg->type == LOCATION_PRIV_TRACKING_BUFFER_FULL) {
+			(void)tracking_fixes_send();
+
+			return SMF_EVENT_HANDLED;
+		} else if (msg->type == LOCATION_PRIV_TRACKING_AGNSS_REQUEST) {
+#if defined(CONFIG_NRF_CLOUD_AGNSS)
+			agnss_request_send(&msg->agnss_request);
+#endif /* CONFIG_NRF_CLOUD_AGNSS */
+
+			return SMF_EVENT_HANDLED;
+		} else if (msg->type == LOCATION_PRIV_CFUN_REQUIRED_SET) {
+			/* GNSS was stopped while the modem was offline */
+			tracking_start();
+
+			return SMF_EVENT_HANDLED;
+		}
+	}
+#endif /* CONFIG_APP_LOCATION_GNSS_TRACKING */
+
+#if defined(CONFIG_APP_LOCATION_CACHE)
+	if (state_object->chan == &priv_location_chan) {
+		const struct priv_location_msg *msg =
+			(const struct priv_location_msg *)state_object->msg_buf;
+
+		if (msg->type == LOCATION_PRIV_CELL_UPDATE) {
+			location_cache_cell_update(msg->cell_id, msg->tac);
+
+			return SMF_EVENT_HANDLED;
+		}
+	}
+
+	if (state_object->chan == &location_chan) {
+		const struct location_msg *msg = (const struct location_msg *)state_object->msg_buf;
+
+		if (msg->type == LOCATION_MOTION_DETECTED) {
+			location_cache_invalidate();
+
+			return SMF_EVENT_HANDLED;
+		} else if ((msg->type == LOCATION_GNSS_DATA) && !msg->cached) {
+			location_cache_store(&msg->gnss_data);
+
+			return SMF_EVENT_HANDLED;
+#if defined(CONFIG_APP_LOCATION_CACHE_WIFI)
+		} else if ((msg->type == LOCATION_CLOUD_REQUEST) && !msg->cached) {
+			location_cache_wifi_store(&msg->cloud_request);
+
+			return SMF_EVENT_HANDLED;
+#endif /* CONFIG_APP_LOCATION_CACHE_WIFI */
+		}
+	}
+#elif !defined(CONFIG_APP_LOCATION_GNSS_TRACKING)
+	ARG_UNUSED(state_object);
+#endif /* CONFIG_APP_LOCATION_CACHE */
+
+	return SMF_EVENT_PROPAGATE;
+}
+
 static void state_location_search_inactive_entry(void *obj)
 {
 	ARG_UNUSED(obj);
 
 	LOG_DBG("%s", __func__);
+
+#if defined(CONFIG_APP_LOCATION_WIFI_POWER_OFF)
+	/* Entered at boot and when a search is done. The Wi-Fi interface is up at boot unless
+	 * CONFIG_NRF_WIFI_IF_AUTO_START is disabled.
+	 */
+	int err = location_wifi_power_off();
+
+	if (err) {
+		LOG_WRN("location_wifi_power_off, error: %d", err);
+	}
+#endif /* CONFIG_APP_LOCATION_WIFI_POWER_OFF */
 }
 
 static enum smf_state_result state_location_search_inactive_run(void *obj)
@@ -332,8 +763,34 @@ static enum smf_state_result state_location_search_inactive_run(void *obj)
 		} else if (location_msg->type == LOCATION_SEARCH_TRIGGER) {
 			LOG_DBG("Location search trigger received");
 
-			err = location_request(NULL);
-			if (err) {
+#if defined(CONFIG_APP_LOCATION_GNSS_TRACKING)
+			if (tracking_fixes_send() > 0) {
+				message_send(LOCATION_SEARCH_DONE);
+
+				return SMF_EVENT_HANDLED;
+			}
+#endif /* CONFIG_APP_LOCATION_GNSS_TRACKING */
+
+#if defined(CONFIG_APP_LOCATION_CACHE)
+			if (cached_location_send()) {
+				return SMF_EVENT_HANDLED;
+			}
+#endif /* CONFIG_APP_LOCATION_CACHE */
+
+#if defined(CONFIG_APP_LOCATION_CACHE_WIFI)
+			if (cached_wifi_send()) {
+				return SMF_EVENT_HANDLED;
+			}
+#endif /* CONFIG_APP_LOCATION_CACHE_WIFI */
+
+			err = location_search_start();
+			if (err == -ENOENT) {
+				LOG_DBG("No GNSS tracking fix since the last search");
+
+				message_send(LOCATION_SEARCH_DONE);
+
+				return SMF_EVENT_HANDLED;
+			} else if (err) {
 				LOG_WRN("location_request, error: %d", err);
 				SEND_FATAL_ERROR();
 
@@ -343,6 +800,16 @@ static enum smf_state_result state_location_search_inactive_run(void *obj)
 			smf_set_state(SMF_CTX(state_object), &states[STATE_LOCATION_SEARCH_ACTIVE]);
 
 			return SMF_EVENT_HANDLED;
+#if defined(CONFIG_APP_LOCATION_GNSS_TRACKING)
+		} else if (location_msg->type == LOCATION_GNSS_SEARCH_TRIGGER) {
+			LOG_DBG("GNSS fix trigger received");
+
+			/* GNSS is already running, publish what it found since the last search */
+			(void)tracking_fixes_send();
+			message_send(LOCATION_SEARCH_DONE);
+
+			return SMF_EVENT_HANDLED;
+#else
 		} else if (location_msg->type == LOCATION_GNSS_SEARCH_TRIGGER) {
 			struct location_config config;
 			enum location_method methods[] = {
@@ -364,6 +831,42 @@ static enum smf_state_result state_location_search_inactive_run(void *obj)
 			smf_set_state(SMF_CTX(state_object), &states[STATE_LOCATION_SEARCH_ACTIVE]);
 
 			return SMF_EVENT_HANDLED;
+#endif /* CONFIG_APP_LOCATION_GNSS_TRACKING */
+#if defined(CONFIG_LOCATION_METHOD_CELLULAR)
+		} else if (location_msg->type == LOCATION_CELLULAR_SEARCH_TRIGGER) {
+			struct location_config config;
+			enum location_method methods[] = {
+				LOCATION_METHOD_CELLULAR
+			};
+
+			LOG_DBG("Cellular location trigger received");
+
+#if defined(CONFIG_APP_LOCATION_CACHE)
+			if (cached_location_send()) {
+				return SMF_EVENT_HANDLED;
+			}
+#endif /* CONFIG_APP_LOCATION_CACHE */
+
+#if defined(CONFIG_APP_LOCATION_CACHE_WIFI)
+			if (cached_wifi_send()) {
+				return SMF_EVENT_HANDLED;
+			}
+#endif /* CONFIG_APP_LOCATION_CACHE_WIFI */
+
+			location_config_defaults_set(&config, 1, methods);
+
+			err = location_request(&config);
+			if (err) {
+				LOG_WRN("location_request, error: %d", err);
+				SEND_FATAL_ERROR();
+
+				return SMF_EVENT_HANDLED;
+			}
+
+			smf_set_state(SMF_CTX(state_object), &states[STATE_LOCATION_SEARCH_ACTIVE]);
+
+			return SMF_EVENT_HANDLED;
+#endif /* CONFIG_LOCATION_METHOD_CELLULAR */
 		}
 	}
 
@@ -387,7 +890,8 @@ static enum smf_state_result state_location_search_active_run(void *obj)
 		int err;
 
 		if (location_msg->type == LOCATION_SEARCH_TRIGGER ||
-		    location_msg->type == LOCATION_GNSS_SEARCH_TRIGGER) {
+		    location_msg->type == LOCATION_GNSS_SEARCH_TRIGGER ||
+		    location_msg->type == LOCATION_CELLULAR_SEARCH_TRIGGER) {
 			LOG_DBG("Location trigger received while active, ignoring");
 		} else if (location_msg->type == LOCATION_SEARCH_CANCEL) {
 			LOG_DBG("Location search cancel received, cancelling location request");
@@ -440,23 +944,6 @@ static void location_print_data_details(enum location_method method,
 #endif
 }
 
-/* Take time from PVT data and apply it to system time. */
-#if defined(CONFIG_LOCATION_METHOD_GNSS)
-static void apply_gnss_time(const struct nrf_modem_gnss_pvt_data_frame *pvt_data)
-{
-	struct tm gnss_time = {
-		.tm_year = pvt_data->datetime.year - 1900,
-		.tm_mon = pvt_data->datetime.month - 1,
-		.tm_mday = pvt_data->datetime.day,
-		.tm_hour = pvt_data->datetime.hour,
-		.tm_min = pvt_data->datetime.minute,
-		.tm_sec = pvt_data->datetime.seconds,
-	};
-
-	date_time_set(&gnss_time);
-}
-#endif /* CONFIG_LOCATION_METHOD_GNSS */
-
 static void location_event_handler(const struct location_event_data *event_data)
 {
 	switch (event_data->id) {
@@ -469,18 +956,31 @@ static void location_event_handler(const struct location_event_data *event_data)
 
 #if defined(CONFIG_LOCATION_METHOD_GNSS)
 		if (event_data->method == LOCATION_METHOD_GNSS) {
-			struct nrf_modem_gnss_pvt_data_frame pvt_data =
-				event_data->location.details.gnss.pvt_data;
+			struct location_gnss_data gnss_data;
+
 			if (event_data->location.datetime.valid) {
 				/* GNSS is the most accurate time source -  use it. */
-				apply_gnss_time(&pvt_data);
+				apply_gnss_time(&event_data->location.details.gnss.pvt_data);
 			} else {
 				/* this should not happen */
 				LOG_WRN("Got GNSS location without valid time data");
 			}
 
+#if defined(CONFIG_APP_LOCATION_GNSS_FILTER)
+			/* Keep poor fixes and outliers out of storage and cloud */
+			if (!location_gnss_filter_check(&event_data->location)) {
+				message_send(LOCATION_SEARCH_DONE);
+				break;
+			}
+#endif /* CONFIG_APP_LOCATION_GNSS_FILTER */
+
+#if defined(CONFIG_APP_LOCATION_GNSS_DETAILS)
+			gnss_details_send(&event_data->location);
+#endif /* CONFIG_APP_LOCATION_GNSS_DETAILS */
+
 			/* Send GNSS location data to cloud for reporting */
-			gnss_location_send(&event_data->location);
+			location_gnss_data_get(&gnss_data, &event_data->location);
+			gnss_location_send(&gnss_data, false);
 		}
 #endif /* CONFIG_LOCATION_METHOD_GNSS */
 
@@ -572,6 +1072,7 @@ static void location_module_thread(void)
 
 	/* Initialize the state machine */
 	smf_set_initial(SMF_CTX(&location_state), &states[STATE_WAITING_FOR_CFUN]);
+	STATE_STATS_UPDATE(location, SMF_CTX(&location_state));
 
 	while (true) {
 		err = task_wdt_feed(task_wdt_id);
@@ -591,12 +1092,18 @@ static void location_module_thread(void)
 			return;
 		}
 
+		zbus_stats_received(&location, location_state.chan);
+
+		HANDLER_STATS_START(location, location_state.chan);
 		err = smf_run_state(SMF_CTX(&location_state));
+		HANDLER_STATS_END(location);
 		if (err) {
 			LOG_ERR("smf_run_state(), error: %d", err);
 			SEND_FATAL_ERROR();
 			return;
 		}
+
+		STATE_STATS_UPDATE(location, SMF_CTX(&location_state));
 	}
 }
 
@@ -21,6 +21,13 @@ ZBUS_CHAN_DECLARE(
 	location_chan
 );
 
+#if defined(CONFIG_APP_LOCATION_GNSS_DETAILS)
+/* Full GNSS fix details, struct location_data, published together with LOCATION_GNSS_DATA */
+ZBUS_CHAN_DECLARE(
+	location_gnss_details_chan
+);
+#endif /* CONFIG_APP_LOCATION_GNSS_DETAILS */
+
 #define MAC_ADDR_LEN 6
 
 enum location_msg_type {
@@ -70,6 +77,12 @@ enum location_msg_type {
 	 */
 	LOCATION_GNSS_SEARCH_TRIGGER,
 
+	/* Request a location search with cellular positioning only, which uses less energy than
+	 * GNSS and Wi-Fi. Requires CONFIG_LOCATION_METHOD_CELLULAR. The result is handled as for
+	 * LOCATION_SEARCH_TRIGGER.
+	 */
+	LOCATION_CELLULAR_SEARCH_TRIGGER,
+
 	/* Request to cancel an ongoing location search operation.
 	 *
 	 * WARNING: This operation has known limitations and may cause issues with Wi-Fi
@@ -86,6 +99,12 @@ enum location_msg_type {
 	 * - Be aware that Wi-Fi scan results may be incomplete or lost
 	 */
 	LOCATION_SEARCH_CANCEL,
+
+	/* The device has moved. With CONFIG_APP_LOCATION_CACHE, this drops the cached GNSS fix
+	 * and Wi-Fi scan so that the next LOCATION_SEARCH_TRIGGER runs a new location search.
+	 * Published by the module that monitors motion, for example an accelerometer.
+	 */
+	LOCATION_MOTION_DETECTED,
 };
 
 /** Wi-Fi access point information. */
@@ -173,6 +192,41 @@ struct location_cloud_request_data {
 	struct location_wifi_ap_info wifi_aps[CONFIG_APP_LOCATION_WIFI_APS_MAX];
 };
 
+/** Altitude of a GNSS fix is valid. */
+#define LOCATION_GNSS_HAS_ALTITUDE	BIT(0)
+
+/** Speed of a GNSS fix is valid. */
+#define LOCATION_GNSS_HAS_SPEED		BIT(1)
+
+/** Heading of a GNSS fix is valid. */
+#define LOCATION_GNSS_HAS_HEADING	BIT(2)
+
+/** GNSS fix. The full fix details are only published on location_gnss_details_chan, with
+ *  CONFIG_APP_LOCATION_GNSS_DETAILS.
+ */
+struct location_gnss_data {
+	/** Latitude in degrees. */
+	double latitude;
+
+	/** Longitude in degrees. */
+	double longitude;
+
+	/** Horizontal accuracy in meters. */
+	float accuracy;
+
+	/** Altitude above WGS-84 ellipsoid in meters. */
+	float altitude;
+
+	/** Horizontal speed in m/s. */
+	float speed;
+
+	/** Heading of user movement in degrees. */
+	float heading;
+
+	/** Valid fields, LOCATION_GNSS_HAS_* flags. */
+	uint8_t flags;
+};
+
 /* Structure to pass location data through zbus */
 struct location_msg {
 	enum location_msg_type type;
@@ -187,10 +241,10 @@ struct location_msg {
 		 */
 		struct nrf_modem_gnss_agnss_data_frame agnss_request;
 
-		/** Contains GNSS location data including coordinates, accuracy and timing.
+		/** Contains the GNSS fix.
 		 *  gnss_data is valid for LOCATION_GNSS_DATA events.
 		 */
-		struct location_data gnss_data;
+		struct location_gnss_data gnss_data;
 	};
 
 	/** Timestamp when the sample was taken in milliseconds.
@@ -200,6 +254,12 @@ struct location_msg {
 	 * Only valid for LOCATION_GNSS_DATA events.
 	 */
 	int64_t timestamp;
+
+	/** The GNSS fix or the Wi-Fi scan of the cloud request is reused from the location cache
+	 *  because the device did not move.
+	 *  Only valid for LOCATION_GNSS_DATA and LOCATION_CLOUD_REQUEST events.
+	 */
+	bool cached;
 };
 
 #ifdef __cplusplus
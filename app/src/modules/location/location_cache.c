@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <modem/lte_lc.h>
+
+#include "location_cache.h"
+
+LOG_MODULE_DECLARE(location_module, CONFIG_APP_LOCATION_LOG_LEVEL);
+
+#define MAX_AGE_MS	((int64_t)CONFIG_APP_LOCATION_CACHE_MAX_AGE_SECONDS * MSEC_PER_SEC)
+#if defined(CONFIG_APP_LOCATION_CACHE_WIFI)
+#define WIFI_MAX_AGE_MS	((int64_t)CONFIG_APP_LOCATION_CACHE_WIFI_MAX_AGE_SECONDS * MSEC_PER_SEC)
+#endif /* CONFIG_APP_LOCATION_CACHE_WIFI */
+
+/* Only accessed from the location module thread */
+static struct {
+	/* Current serving cell */
+	uint32_t cell_id;
+	uint32_t tac;
+
+	/* Last GNSS fix and the serving cell and uptime when it was taken */
+	bool valid;
+	struct location_gnss_data fix;
+	uint32_t fix_cell_id;
+	uint32_t fix_tac;
+	int64_t fix_uptime_ms;
+
+#if defined(CONFIG_APP_LOCATION_CACHE_WIFI)
+	/* Last cloud location request with a Wi-Fi scan, and the serving cell and uptime when
+	 * the scan was taken
+	 */
+	bool wifi_valid;
+	struct location_cloud_request_data wifi_request;
+	uint32_t wifi_cell_id;
+	uint32_t wifi_tac;
+	int64_t wifi_uptime_ms;
+#endif /* CONFIG_APP_LOCATION_CACHE_WIFI */
+} cache = {
+	.cell_id = LTE_LC_CELL_EUTRAN_ID_INVALID,
+};
+
+void location_cache_store(const struct location_gnss_data *fix)
+{
+	if (cache.cell_id == LTE_LC_CELL_EUTRAN_ID_INVALID) {
+		LOG_DBG("Serving cell unknown, not caching the fix");
+
+		return;
+	}
+
+	cache.fix = *fix;
+	cache.fix_cell_id = cache.cell_id;
+	cache.fix_tac = cache.tac;
+	cache.fix_uptime_ms = k_uptime_get();
+	cache.valid = true;
+}
+
+const struct location_gnss_data *location_cache_get(void)
+{
+	if (!cache.valid) {
+		return NULL;
+	}
+
+	if ((cache.cell_id != cache.fix_cell_id) || (cache.tac != cache.fix_tac)) {
+		cache.valid = false;
+
+		return NULL;
+	}
+
+	if ((k_uptime_get() - cache.fix_uptime_ms) > MAX_AGE_MS) {
+		LOG_DBG("Cached fix expired");
+
+		cache.valid = false;
+
+		return NULL;
+	}
+
+	return &cache.fix;
+}
+
+#if defined(CONFIG_APP_LOCATION_CACHE_WIFI)
+void location_cache_wifi_store(const struct location_cloud_request_data *request)
+{
+	if (request->wifi_cnt == 0) {
+		return;
+	}
+
+	if (cache.cell_id == LTE_LC_CELL_EUTRAN_ID_INVALID) {
+		LOG_DBG("Serving cell unknown, not caching the Wi-Fi scan");
+
+		return;
+	}
+
+	cache.wifi_request = *request;
+	cache.wifi_cell_id = cache.cell_id;
+	cache.wifi_tac = cache.tac;
+	cache.wifi_uptime_ms = k_uptime_get();
+	cache.wifi_valid = true;
+}
+
+const struct location_cloud_request_data *location_cache_wifi_get(void)
+{
+	if (!cache.wifi_valid) {
+		return NULL;
+	}
+
+	if ((cache.cell_id != cache.wifi_cell_id) || (cache.tac != cache.wifi_tac)) {
+		cache.wifi_valid = false;
+
+		return NULL;
+	}
+
+	if ((k_uptime_get() - cache.wifi_uptime_ms) > WIFI_MAX_AGE_MS) {
+		LOG_DBG("Cached Wi-Fi scan expired");
+
+		cache.wifi_valid = false;
+
+		return NULL;
+	}
+
+	return &cache.wifi_request;
+}
+#endif /* CONFIG_APP_LOCATION_CACHE_WIFI */
+
+void location_cache_cell_update(uint32_t cell_id, uint32_t tac)
+{
+	if (cache.valid && ((cell_id != cache.fix_cell_id) || (tac != cache.fix_tac))) {
+		LOG_DBG("Serving cell changed, dropping cached fix");
+
+		cache.valid = false;
+	}
+
+#if defined(CONFIG_APP_LOCATION_CACHE_WIFI)
+	if (cache.wifi_valid && ((cell_id != cache.wifi_cell_id) || (tac != cache.wifi_tac))) {
+		LOG_DBG("Serving cell changed, dropping cached Wi-Fi scan");
+
+		cache.wifi_valid = false;
+	}
+#endif /* CONFIG_APP_LOCATION_CACHE_WIFI */
+
+	cache.cell_id = cell_id;
+	cache.tac = tac;
+}
+
+void location_cache_invalidate(void)
+{
+	if (cache.valid) {
+		LOG_DBG("Motion detected, dropping cached fix");
+	}
+
+	cache.valid = false;
+
+#if defined(CONFIG_APP_LOCATION_CACHE_WIFI)
+	if (cache.wifi_valid) {
+		LOG_DBG("Motion detected, dropping cached Wi-Fi scan");
+	}
+
+	cache.wifi_valid = false;
+#endif /* CONFIG_APP_LOCATION_CACHE_WIFI */
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _LOCATION_CACHE_H_
+#define _LOCATION_CACHE_H_
+
+#include <stdint.h>
+#include "location.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Store a GNSS fix in the location cache.
+ *
+ * The fix is stored together with the current serving cell.
+ *
+ * @param[in] fix GNSS fix
+ */
+void location_cache_store(const struct location_gnss_data *fix);
+
+/**
+ * @brief Get the cached GNSS fix if the device has not moved since it was taken.
+ *
+ * The fix is returned if the serving cell is the same as when the fix was taken, no motion
+ * was reported, and the fix is not older than CONFIG_APP_LOCATION_CACHE_MAX_AGE_SECONDS.
+ *
+ * @return Pointer to the cached fix, or NULL if it cannot be used
+ */
+const struct location_gnss_data *location_cache_get(void);
+
+#if defined(CONFIG_APP_LOCATION_CACHE_WIFI)
+/**
+ * @brief Store the Wi-Fi scan of a cloud location request in the location cache.
+ *
+ * The request is stored together with the current serving cell. Requests without Wi-Fi
+ * access points are ignored.
+ *
+ * @param[in] request Cloud location request
+ */
+void location_cache_wifi_store(const struct location_cloud_request_data *request);
+
+/**
+ * @brief Get the cached Wi-Fi scan if the device has not moved since it was taken.
+ *
+ * The request is returned if the serving cell is the same as when the scan was taken, no
+ * motion was reported, and the scan is not older than
+ * CONFIG_APP_LOCATION_CACHE_WIFI_MAX_AGE_SECONDS.
+ *
+ * @return Pointer to the cached cloud location request, or NULL if it cannot be used
+ */
+const struct location_cloud_request_data *location_cache_wifi_get(void);
+#endif /* CONFIG_APP_LOCATION_CACHE_WIFI */
+
+/**
+ * @brief Update the serving cell, the cached fix and Wi-Fi scan are dropped if the cell changed.
+ *
+ * @param[in] cell_id E-UTRAN cell ID
+ * @param[in] tac Tracking area code
+ */
+void location_cache_cell_update(uint32_t cell_id, uint32_t tac);
+
+/**
+ * @brief Drop the cached fix and Wi-Fi scan, used when motion is detected.
+ */
+void location_cache_invalidate(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LOCATION_CACHE_H_ */
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <math.h>
+
+#include "location_gnss_filter.h"
+
+LOG_MODULE_DECLARE(location_module, CONFIG_APP_LOCATION_LOG_LEVEL);
+
+#define EARTH_RADIUS_METERS	6371000.0
+#define DEG_TO_RAD(deg)		((deg) * 3.14159265358979323846 / 180.0)
+#define MAX_SPEED_MPS		(CONFIG_APP_LOCATION_GNSS_FILTER_MAX_SPEED_KMH / 3.6)
+
+/* Only accessed from the location library event handler and the location module thread */
+static struct {
+	/* Last accepted fix and the uptime when it was accepted */
+	bool valid;
+	double latitude;
+	double longitude;
+	double accuracy;
+	int64_t uptime_ms;
+
+	/* Consecutive fixes dropped as outliers */
+	uint32_t outliers;
+} filter;
+
+/* Distance in meters, the equirectangular approximation is accurate enough for the
+ * distances a device can travel between two fixes.
+ */
+static double distance_get(double lat1, double lon1, double lat2, double lon2)
+{
+	double x = DEG_TO_RAD(lon2 - lon1) * cos(DEG_TO_RAD((lat1 + lat2) / 2.0));
+	double y = DEG_TO_RAD(lat2 - lat1);
+
+	return sqrt((x * x) + (y * y)) * EARTH_RADIUS_METERS;
+}
+
+static bool quality_check(const struct location_data *fix)
+{
+	const struct location_data_details_gnss *gnss = &fix->details.gnss;
+
+	if (fix->accuracy > CONFIG_APP_LOCATION_GNSS_FILTER_MAX_ACCURACY_METERS) {
+		LOG_DBG("GNSS fix dropped, accuracy: %d m", (int)fix->accuracy);
+
+		return false;
+	}
+
+	if (gnss->satellites_used < CONFIG_APP_LOCATION_GNSS_FILTER_MIN_SATELLITES) {
+		LOG_DBG("GNSS fix dropped, satellites used: %d", gnss->satellites_used);
+
+		return false;
+	}
+
+	if ((gnss->pvt_data.hdop * 10.0f) > CONFIG_APP_LOCATION_GNSS_FILTER_MAX_HDOP_TENTHS) {
+		LOG_DBG("GNSS fix dropped, HDOP: %d.%d", (int)gnss->pvt_data.hdop,
+			(int)(gnss->pvt_data.hdop * 10.0f) % 10);
+
+		return false;
+	}
+
+	return true;
+}
+
+static bool outlier_check(const struct location_data *fix, int64_t now)
+{
+	double distance;
+	double seconds;
+
+	if (!filter.valid) {
+		return false;
+	}
+
+	/* Movement within the uncertainty of the two fixes is not counted */
+	distance = distance_get(filter.latitude, filter.longitude, fix->latitude, fix->longitude);
+	distance = MAX(distance - filter.accuracy - fix->accuracy, 0.0);
+	seconds = MAX((now - filter.uptime_ms) / (double)MSEC_PER_SEC, 1.0);
+
+	if ((distance / seconds) <= MAX_SPEED_MPS) {
+		return false;
+	}
+
+	LOG_DBG("GNSS fix dropped, %d m from the previous fix after %d s",
+		(int)distance, (int)seconds);
+
+	return true;
+}
+
+bool location_gnss_filter_check(const struct location_data *fix)
+{
+	return location_gnss_filter_check_at(fix, k_uptime_get());
+}
+
+bool location_gnss_filter_check_at(const struct location_data *fix, int64_t now)
+{
+	if (!quality_check(fix)) {
+		return false;
+	}
+
+	if (outlier_check(fix, now)) {
+		filter.outliers++;
+
+		if (filter.outliers <= CONFIG_APP_LOCATION_GNSS_FILTER_MAX_OUTLIERS) {
+			return false;
+		}
+
+		LOG_DBG("Too many consecutive outliers, accepting the fix as new reference");
+	}
+
+	filter.valid = true;
+	filter.latitude = fix->latitude;
+	filter.longitude = fix->longitude;
+	filter.accuracy = fix->accuracy;
+	filter.uptime_ms = now;
+	filter.outliers = 0;
+
+	return true;
+}
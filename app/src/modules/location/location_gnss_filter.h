@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _LOCATION_GNSS_FILTER_H_
+#define _LOCATION_GNSS_FILTER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <modem/location.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Check if a GNSS fix is good enough to be published.
+ *
+ * A fix is dropped if its accuracy, number of satellites used or HDOP does not meet the
+ * configured requirements, or if reaching it from the previous accepted fix requires a speed
+ * above CONFIG_APP_LOCATION_GNSS_FILTER_MAX_SPEED_KMH. After
+ * CONFIG_APP_LOCATION_GNSS_FILTER_MAX_OUTLIERS consecutive outliers, the next fix that meets
+ * the quality requirements is accepted, so that the filter recovers when the device has
+ * really been moved.
+ *
+ * @param[in] fix GNSS fix with details from the location library.
+ *
+ * @return true if the fix is accepted, false if it is dropped.
+ */
+bool location_gnss_filter_check(const struct location_data *fix);
+
+/**
+ * @brief Check a GNSS fix that was taken earlier.
+ *
+ * Same as location_gnss_filter_check(), for fixes that are checked some time after they were
+ * taken. Fixes must be checked in the order they were taken.
+ *
+ * @param[in] fix GNSS fix with details from the location library.
+ * @param[in] uptime_ms Uptime in milliseconds when the fix was taken.
+ *
+ * @return true if the fix is accepted, false if it is dropped.
+ */
+bool location_gnss_filter_check_at(const struct location_data *fix, int64_t uptime_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LOCATION_GNSS_FILTER_H_ */
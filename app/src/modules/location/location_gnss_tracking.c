@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/timeutil.h>
+#include <nrf_modem_gnss.h>
+#include <string.h>
+
+#include "location_gnss_tracking.h"
+
+LOG_MODULE_DECLARE(location_module, CONFIG_APP_LOCATION_LOG_LEVEL);
+
+/* Fix as received from GNSS, without the satellite information of the PVT frame */
+struct tracking_fix {
+	double latitude;
+	double longitude;
+	float accuracy;
+	float altitude;
+	float speed;
+	float heading;
+	float heading_accuracy;
+	float hdop;
+	uint8_t flags;
+	uint8_t satellites_tracked;
+	uint8_t satellites_used;
+	struct nrf_modem_gnss_datetime datetime;
+	int64_t uptime_ms;
+};
+
+/* Written from the GNSS event handler, read from the location module thread */
+K_MSGQ_DEFINE(fix_queue, sizeof(struct tracking_fix),
+	      CONFIG_APP_LOCATION_GNSS_TRACKING_BUFFER_SIZE, 8);
+
+/* Only accessed from the GNSS event handler */
+static struct nrf_modem_gnss_pvt_data_frame pvt;
+static location_gnss_tracking_handler_t tracking_handler;
+
+static void fix_store(void)
+{
+	struct tracking_fix fix = {
+		.latitude = pvt.latitude,
+		.longitude = pvt.longitude,
+		.accuracy = pvt.accuracy,
+		.altitude = pvt.altitude,
+		.speed = pvt.speed,
+		.heading = pvt.heading,
+		.heading_accuracy = pvt.heading_accuracy,
+		.hdop = pvt.hdop,
+		.flags = pvt.flags,
+		.datetime = pvt.datetime,
+		.uptime_ms = k_uptime_get(),
+	};
+	struct tracking_fix dropped;
+	const struct location_gnss_tracking_evt evt = {
+		.type = LOCATION_GNSS_TRACKING_EVT_BUFFER_FULL,
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(pvt.sv); i++) {
+		if (pvt.sv[i].sv == 0) {
+			continue;
+		}
+
+		fix.satellites_tracked++;
+
+		if (pvt.sv[i].flags & NRF_MODEM_GNSS_SV_FLAG_USED_IN_FIX) {
+			fix.satellites_used++;
+		}
+	}
+
+	/* Keep the newest fixes if the thread did not read the buffer in time */
+	if (k_msgq_put(&fix_queue, &fix, K_NO_WAIT)) {
+		(void)k_msgq_get(&fix_queue, &dropped, K_NO_WAIT);
+		(void)k_msgq_put(&fix_queue, &fix, K_NO_WAIT);
+	}
+
+	if (k_msgq_num_free_get(&fix_queue) == 0) {
+		tracking_handler(&evt);
+	}
+}
+
+/* Called in interrupt context */
+static void gnss_event_handler(int event)
+{
+	int err;
+	struct location_gnss_tracking_evt evt;
+
+	switch (event) {
+	case NRF_MODEM_GNSS_EVT_FIX:
+		err = nrf_modem_gnss_read(&pvt, sizeof(pvt), NRF_MODEM_GNSS_DATA_PVT);
+		if (err) {
+			return;
+		}
+
+		if (pvt.flags & NRF_MODEM_GNSS_PVT_FLAG_FIX_VALID) {
+			fix_store();
+		}
+
+		break;
+	case NRF_MODEM_GNSS_EVT_AGNSS_REQ:
+		evt.type = LOCATION_GNSS_TRACKING_EVT_AGNSS_REQUEST;
+
+		err = nrf_modem_gnss_read(&evt.agnss_request, sizeof(evt.agnss_request),
+					  NRF_MODEM_GNSS_DATA_AGNSS_REQ);
+		if (err) {
+			return;
+		}
+
+		tracking_handler(&evt);
+		break;
+	default:
+		break;
+	}
+}
+
+int location_gnss_tracking_start(location_gnss_tracking_handler_t handler)
+{
+	int err;
+
+	tracking_handler = handler;
+
+	/* GNSS is stopped when the modem goes offline, and cannot be configured while it runs */
+	(void)nrf_modem_gnss_stop();
+
+	err = nrf_modem_gnss_event_handler_set(gnss_event_handler);
+	if (err) {
+		LOG_ERR("nrf_modem_gnss_event_handler_set, error: %d", err);
+		return -EIO;
+	}
+
+	err = nrf_modem_gnss_use_case_set(NRF_MODEM_GNSS_USE_CASE_MULTIPLE_HOT_START);
+	if (err) {
+		LOG_ERR("nrf_modem_gnss_use_case_set, error: %d", err);
+		return -EIO;
+	}
+
+	/* An interval of 10 seconds or more selects periodic navigation */
+	err = nrf_modem_gnss_fix_interval_set(CONFIG_APP_LOCATION_GNSS_TRACKING_INTERVAL_SECONDS);
+	if (err) {
+		LOG_ERR("nrf_modem_gnss_fix_interval_set, error: %d", err);
+		return -EIO;
+	}
+
+	err = nrf_modem_gnss_start();
+	if (err) {
+		LOG_ERR("nrf_modem_gnss_start, error: %d", err);
+		return -EIO;
+	}
+
+	LOG_DBG("GNSS tracking started, fix interval %d s",
+		CONFIG_APP_LOCATION_GNSS_TRACKING_INTERVAL_SECONDS);
+
+	return 0;
+}
+
+int location_gnss_tracking_get(struct location_data *location, int64_t *uptime_ms,
+			       int64_t *timestamp_ms)
+{
+	struct tracking_fix fix;
+	struct nrf_modem_gnss_pvt_data_frame *pvt_data = &location->details.gnss.pvt_data;
+	struct tm fix_time = { 0 };
+
+	if (k_msgq_get(&fix_queue, &fix, K_NO_WAIT)) {
+		return -ENODATA;
+	}
+
+	memset(location, 0, sizeof(*location));
+
+	location->latitude = fix.latitude;
+	location->longitude = fix.longitude;
+	location->accuracy = fix.accuracy;
+	location->datetime.valid = true;
+	location->datetime.year = fix.datetime.year;
+	location->datetime.month = fix.datetime.month;
+	location->datetime.day = fix.datetime.day;
+	location->datetime.hour = fix.datetime.hour;
+	location->datetime.minute = fix.datetime.minute;
+	location->datetime.second = fix.datetime.seconds;
+	location->datetime.ms = fix.datetime.ms;
+
+	location->details.gnss.satellites_tracked = fix.satellites_tracked;
+	location->details.gnss.satellites_used = fix.satellites_used;
+
+	pvt_data->latitude = fix.latitude;
+	pvt_data->longitude = fix.longitude;
+	pvt_data->accuracy = fix.accuracy;
+	pvt_data->altitude = fix.altitude;
+	pvt_data->speed = fix.speed;
+	pvt_data->heading = fix.heading;
+	pvt_data->heading_accuracy = fix.heading_accuracy;
+	pvt_data->hdop = fix.hdop;
+	pvt_data->flags = fix.flags;
+	pvt_data->datetime = fix.datetime;
+
+	fix_time.tm_year = fix.datetime.year - 1900;
+	fix_time.tm_mon = fix.datetime.month - 1;
+	fix_time.tm_mday = fix.datetime.day;
+	fix_time.tm_hour = fix.datetime.hour;
+	fix_time.tm_min = fix.datetime.minute;
+	fix_time.tm_sec = fix.datetime.seconds;
+
+	*uptime_ms = fix.uptime_ms;
+	*timestamp_ms = (timeutil_timegm64(&fix_time) * MSEC_PER_SEC) + fix.datetime.ms;
+
+	return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _LOCATION_GNSS_TRACKING_H_
+#define _LOCATION_GNSS_TRACKING_H_
+
+#include <stdint.h>
+#include <modem/location.h>
+#include <nrf_modem_gnss.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum location_gnss_tracking_evt_type {
+	/* The fix buffer is full, the fixes must be read before the oldest one is dropped */
+	LOCATION_GNSS_TRACKING_EVT_BUFFER_FULL,
+
+	/* GNSS needs assistance data, the request is in .agnss_request */
+	LOCATION_GNSS_TRACKING_EVT_AGNSS_REQUEST,
+};
+
+struct location_gnss_tracking_evt {
+	enum location_gnss_tracking_evt_type type;
+
+	/* Valid for LOCATION_GNSS_TRACKING_EVT_AGNSS_REQUEST */
+	struct nrf_modem_gnss_agnss_data_frame agnss_request;
+};
+
+/**
+ * @brief Handler of GNSS tracking events, called in interrupt context.
+ */
+typedef void (*location_gnss_tracking_handler_t)(const struct location_gnss_tracking_evt *evt);
+
+/**
+ * @brief Start GNSS in periodic navigation mode.
+ *
+ * GNSS searches for a fix every CONFIG_APP_LOCATION_GNSS_TRACKING_INTERVAL_SECONDS and keeps
+ * the ephemerides between fixes. The modem only runs GNSS while LTE is idle, for example in
+ * PSM. Fixes are kept in a buffer of CONFIG_APP_LOCATION_GNSS_TRACKING_BUFFER_SIZE fixes
+ * without waking up any thread.
+ *
+ * Takes over the GNSS event handler of the location library, so the location library must
+ * not be used with the GNSS method while tracking. Can be called again to restart GNSS
+ * after the modem was offline.
+ *
+ * @param[in] handler Handler of tracking events.
+ *
+ * @retval 0 on success.
+ * @retval -EIO if GNSS could not be configured or started.
+ */
+int location_gnss_tracking_start(location_gnss_tracking_handler_t handler);
+
+/**
+ * @brief Get the oldest buffered fix and remove it from the buffer.
+ *
+ * The fix is returned in the format of the location library. Satellite information is not
+ * included in the PVT data.
+ *
+ * @param[out] location Fix.
+ * @param[out] uptime_ms Uptime in milliseconds when the fix was received.
+ * @param[out] timestamp_ms Time of the fix as Unix time in milliseconds.
+ *
+ * @retval 0 on success.
+ * @retval -ENODATA if the buffer is empty.
+ */
+int location_gnss_tracking_get(struct location_data *location, int64_t *uptime_ms,
+			       int64_t *timestamp_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LOCATION_GNSS_TRACKING_H_ */
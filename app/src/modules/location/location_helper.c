@@ -104,6 +104,37 @@ static int copy_wifi_data(struct location_cloud_request_data *dest,
 }
 #endif /* CONFIG_LOCATION_METHOD_WIFI */
 
+/* Heading less accurate than this, in degrees, is not published */
+#define GNSS_HEADING_ACCURACY_LIMIT	60.0f
+
+void location_gnss_data_get(struct location_gnss_data *dest, const struct location_data *src)
+{
+	const struct nrf_modem_gnss_pvt_data_frame *pvt = &src->details.gnss.pvt_data;
+
+	*dest = (struct location_gnss_data) {
+		.latitude = src->latitude,
+		.longitude = src->longitude,
+		.accuracy = src->accuracy,
+	};
+
+	if (!(pvt->flags & NRF_MODEM_GNSS_PVT_FLAG_FIX_VALID)) {
+		return;
+	}
+
+	dest->altitude = pvt->altitude;
+	dest->speed = pvt->speed;
+	dest->heading = pvt->heading;
+	dest->flags = LOCATION_GNSS_HAS_ALTITUDE;
+
+	if (pvt->flags & NRF_MODEM_GNSS_PVT_FLAG_VELOCITY_VALID) {
+		dest->flags |= LOCATION_GNSS_HAS_SPEED;
+	}
+
+	if (pvt->heading_accuracy < GNSS_HEADING_ACCURACY_LIMIT) {
+		dest->flags |= LOCATION_GNSS_HAS_HEADING;
+	}
+}
+
 int location_cloud_request_data_copy(struct location_cloud_request_data *dest,
 				     const struct location_data_cloud *src)
 {
@@ -141,3 +172,33 @@ int location_cloud_request_data_copy(struct location_cloud_request_data *dest,
 
 	return 0;
 }
+
+void location_methods_combine(enum location_method *methods, size_t count)
+{
+	size_t first = count;
+	size_t second = count;
+	enum location_method moved;
+
+	for (size_t i = 0; i < count; i++) {
+		if ((methods[i] != LOCATION_METHOD_WIFI) &&
+		    (methods[i] != LOCATION_METHOD_CELLULAR)) {
+			continue;
+		}
+
+		if (first == count) {
+			first = i;
+		} else {
+			second = i;
+			break;
+		}
+	}
+
+	if ((second == count) || (second == first + 1)) {
+		return;
+	}
+
+	moved = methods[second];
+	memmove(&methods[first + 2], &methods[first + 1],
+		(second - first - 1) * sizeof(methods[0]));
+	methods[first + 1] = moved;
+}
@@ -27,6 +27,30 @@ extern "C" {
 int location_cloud_request_data_copy(struct location_cloud_request_data *dest,
 				     const struct location_data_cloud *src);
 
+/**
+ * @brief Get the GNSS fix to publish on location_chan from location library data.
+ *
+ * Altitude and speed are set if they are valid in the PVT data. Heading is set if its
+ * accuracy is better than 60 degrees.
+ *
+ * @param[out] dest GNSS fix
+ * @param[in] src GNSS location from location library, with details
+ */
+void location_gnss_data_get(struct location_gnss_data *dest, const struct location_data *src);
+
+/**
+ * @brief Reorder location methods so that Wi-Fi and cellular are next to each other.
+ *
+ * The location library runs the Wi-Fi scan and the LTE neighbor cell measurement together
+ * and sends the results in one cloud request only when the two methods are next to each
+ * other in the method list. The method that comes later in the list is moved to right after
+ * the other one. The order of the other methods is kept.
+ *
+ * @param[in,out] methods Location methods in order of priority.
+ * @param[in] count Number of location methods.
+ */
+void location_methods_combine(enum location_method *methods, size_t count);
+
 #ifdef __cplusplus
 }
 #endif
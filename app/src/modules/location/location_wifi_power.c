@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/net/net_if.h>
+
+#include "location_wifi_power.h"
+
+LOG_MODULE_DECLARE(location_module, CONFIG_APP_LOCATION_LOG_LEVEL);
+
+int location_wifi_power_on(void)
+{
+	int err;
+	struct net_if *iface = net_if_get_first_wifi();
+
+	if (iface == NULL) {
+		return -ENODEV;
+	}
+
+	if (net_if_is_admin_up(iface)) {
+		return 0;
+	}
+
+	err = net_if_up(iface);
+	if (err && (err != -EALREADY)) {
+		return err;
+	}
+
+	LOG_DBG("Wi-Fi powered on");
+
+	return 0;
+}
+
+int location_wifi_power_off(void)
+{
+	int err;
+	struct net_if *iface = net_if_get_first_wifi();
+
+	if (iface == NULL) {
+		return -ENODEV;
+	}
+
+	if (!net_if_is_admin_up(iface)) {
+		return 0;
+	}
+
+	err = net_if_down(iface);
+	if (err && (err != -EALREADY)) {
+		return err;
+	}
+
+	LOG_DBG("Wi-Fi powered off");
+
+	return 0;
+}
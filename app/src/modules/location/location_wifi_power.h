@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _LOCATION_WIFI_POWER_H_
+#define _LOCATION_WIFI_POWER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Power on the Wi-Fi chip for a location search.
+ *
+ * Brings up the Wi-Fi network interface, which powers on and initializes the nRF70 Series
+ * chip. Does nothing if the interface is already up.
+ *
+ * @return 0 on success, -ENODEV if there is no Wi-Fi interface, or a negative error code
+ *	   from net_if_up().
+ */
+int location_wifi_power_on(void);
+
+/**
+ * @brief Power off the Wi-Fi chip between location searches.
+ *
+ * Brings down the Wi-Fi network interface, which powers off the nRF70 Series chip. Does
+ * nothing if the interface is already down.
+ *
+ * @return 0 on success, -ENODEV if there is no Wi-Fi interface, or a negative error code
+ *	   from net_if_down().
+ */
+int location_wifi_power_off(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LOCATION_WIFI_POWER_H_ */
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+
+#include "app_common.h"
+#include "motion.h"
+
+/* Register log module */
+LOG_MODULE_REGISTER(motion, CONFIG_APP_MOTION_LOG_LEVEL);
+
+#define HOLDOFF_MS ((int64_t)CONFIG_APP_MOTION_HOLDOFF_SECONDS * MSEC_PER_SEC)
+
+/* Motion state structure */
+static struct {
+	/* Uptime in milliseconds of the last published MOTION_DETECTED, 0 if none */
+	int64_t last_published_ms;
+} motion_state;
+
+static const struct device *const accel = DEVICE_DT_GET(DT_NODELABEL(adxl367));
+
+/* Activity interrupt of the accelerometer. The ADXL367 driver reports activity and
+ * inactivity as a threshold trigger, the driver is configured to only detect activity.
+ */
+static const struct sensor_trigger activity_trigger = {
+	.type = SENSOR_TRIG_THRESHOLD,
+	.chan = SENSOR_CHAN_ACCEL_XYZ,
+};
+
+/* Define channels provided by this module */
+ZBUS_CHAN_DEFINE(motion_chan,
+		 struct motion_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+/* Trigger handler called by the accelerometer driver when movement is detected */
+static void activity_handler(const struct device *dev, const struct sensor_trigger *trigger)
+{
+	int err;
+	int64_t now = k_uptime_get();
+	struct motion_msg msg = {
+		.type = MOTION_DETECTED,
+	};
+
+	ARG_UNUSED(dev);
+	ARG_UNUSED(trigger);
+
+	/* The interrupt fires continuously while the device moves, rate limit the messages */
+	if (motion_state.last_published_ms &&
+	    ((now - motion_state.last_published_ms) < HOLDOFF_MS)) {
+		return;
+	}
+
+	motion_state.last_published_ms = now;
+
+	LOG_DBG("Motion detected");
+
+	err = zbus_chan_pub(&motion_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+static int motion_init(void)
+{
+	int err;
+
+	LOG_DBG("motion_init");
+
+	if (!device_is_ready(accel)) {
+		LOG_ERR("Accelerometer device not ready");
+		SEND_FATAL_ERROR();
+		return -ENODEV;
+	}
+
+	err = sensor_trigger_set(accel, &activity_trigger, activity_handler);
+	if (err) {
+		LOG_ERR("sensor_trigger_set, error: %d", err);
+		SEND_FATAL_ERROR();
+		return err;
+	}
+
+	return 0;
+}
+
+/* Initialize module at SYS_INIT() */
+SYS_INIT(motion_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _MOTION_H_
+#define _MOTION_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Motion message types */
+enum motion_msg_type {
+	/* Output message types */
+
+	/** Movement detected by the accelerometer. Sent at most once every
+	 *  CONFIG_APP_MOTION_HOLDOFF_SECONDS.
+	 */
+	MOTION_DETECTED = 0x1,
+};
+
+/** @brief Motion message data structure */
+struct motion_msg {
+	enum motion_msg_type type;
+};
+
+/* Channels provided by this module */
+ZBUS_CHAN_DECLARE(
+	motion_chan
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MOTION_H_ */
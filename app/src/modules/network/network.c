@@ -15,8 +15,22 @@
 #include "modem/lte_lc.h"
 #include "modem/modem_info.h"
 #include "app_common.h"
+#include "state_stats.h"
+#include "zbus_stats.h"
+#include "handler_stats.h"
+#include "modem_trace_ring.h"
 #include "network.h"
 
+#if defined(CONFIG_APP_NETWORK_RAI)
+#include <nrf_socket.h>
+#endif /* CONFIG_APP_NETWORK_RAI */
+
+#if defined(CONFIG_APP_NETWORK_FAST_REATTACH)
+#include <nrf_modem_at.h>
+
+#include "network_reattach.h"
+#endif /* CONFIG_APP_NETWORK_FAST_REATTACH */
+
 /* Register log module */
 LOG_MODULE_REGISTER(network, CONFIG_APP_NETWORK_LOG_LEVEL);
 
@@ -33,13 +47,46 @@ ZBUS_CHAN_DEFINE(network_chan,
 		 ZBUS_MSG_INIT(0)
 );
 
+ZBUS_STATS_CHAN_DEFINE(network_chan);
+
 /* Register subscriber */
 ZBUS_MSG_SUBSCRIBER_DEFINE(network);
 
 /* Observe network channel */
 ZBUS_CHAN_ADD_OBS(network_chan, network, 0);
 
-#define MAX_MSG_SIZE sizeof(struct network_msg)
+enum priv_network_msg_type {
+	/* No connection within CONFIG_APP_NETWORK_FAST_REATTACH_TIMEOUT_SECONDS on the cached
+	 * bands.
+	 */
+	NETWORK_PRIV_REATTACH_TIMEOUT,
+
+	/* The search time budget of CONFIG_APP_NETWORK_SEARCH_BUDGET_SECONDS_PER_HOUR is used */
+	NETWORK_PRIV_SEARCH_BUDGET_USED,
+
+	/* Time to search again after the search was suspended */
+	NETWORK_PRIV_SEARCH_RESUME,
+};
+
+struct priv_network_msg {
+	/* Type of the message */
+	enum priv_network_msg_type type;
+};
+
+/* Create private network channel for internal messaging that is not intended for external
+ * use.
+ */
+ZBUS_CHAN_DEFINE(priv_network_chan,
+		 struct priv_network_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_ADD_OBS(priv_network_chan, network, 0);
+
+#define MAX_MSG_SIZE MAX(sizeof(struct network_msg), sizeof(struct priv_network_msg))
 
 /* State machine */
 
@@ -75,6 +122,39 @@ struct network_state_object {
 
 	/* Buffer for last ZBus message */
 	uint8_t msg_buf[MAX_MSG_SIZE];
+
+	/* Last schedule received from the application, zero until received */
+	struct network_schedule schedule;
+
+#if defined(CONFIG_APP_NETWORK_POWER_SAVING_NEGOTIATION)
+	/* Periodic TAU requested from the schedule in seconds, 0 if none has been requested */
+	uint32_t requested_tau;
+
+	/* An eDRX cycle has been requested because the network did not grant PSM */
+	bool edrx_fallback;
+#endif /* CONFIG_APP_NETWORK_POWER_SAVING_NEGOTIATION */
+
+#if defined(CONFIG_APP_NETWORK_SEARCH_POLICY)
+	/* Start of the current search budget window in ms since boot */
+	int64_t budget_window_start_ms;
+
+	/* Search time used in the current window in ms */
+	int64_t budget_used_ms;
+
+	/* Start of the ongoing search in ms since boot, 0 if not searching */
+	int64_t search_start_ms;
+
+	/* Searching is suspended until the search resume timer expires */
+	bool search_suspended;
+#endif /* CONFIG_APP_NETWORK_SEARCH_POLICY */
+
+#if defined(CONFIG_APP_NETWORK_FAST_REATTACH)
+	/* The modem is locked to the bands of the last connections */
+	bool band_locked;
+
+	/* No connection was found on the cached bands, search all bands until connected */
+	bool reattach_failed;
+#endif /* CONFIG_APP_NETWORK_FAST_REATTACH */
 };
 
 /* Forward declarations of state handlers */
@@ -85,6 +165,7 @@ static enum smf_state_result state_disconnected_run(void *obj);
 static enum smf_state_result state_disconnected_idle_run(void *obj);
 static void state_disconnected_searching_entry(void *obj);
 static enum smf_state_result state_disconnected_searching_run(void *obj);
+static void state_disconnected_searching_exit(void *obj);
 static void state_disconnecting_entry(void *obj);
 static enum smf_state_result state_disconnecting_run(void *obj);
 static enum smf_state_result state_connected_run(void *obj);
@@ -113,7 +194,8 @@ static const struct smf_state states[] = {
 				 NULL), /* No initial transition */
 	[STATE_DISCONNECTED_SEARCHING] =
 		SMF_CREATE_STATE(state_disconnected_searching_entry,
-				 state_disconnected_searching_run, NULL,
+				 state_disconnected_searching_run,
+				 state_disconnected_searching_exit,
 				 &states[STATE_DISCONNECTED],
 				 NULL), /* No initial transition */
 	[STATE_CONNECTED] =
@@ -126,6 +208,11 @@ static const struct smf_state states[] = {
 				 NULL), /* No initial transition */
 };
 
+STATE_STATS_DEFINE(network, states);
+STATE_STATS_METRIC_DEFINE(network, STATE_DISCONNECTED_SEARCHING, network_search);
+HANDLER_STATS_DEFINE(network, CONFIG_APP_NETWORK_MSG_PROCESSING_TIMEOUT_SECONDS);
+HANDLER_STATS_METRIC_DEFINE(network);
+
 static void network_status_notify(enum network_msg_type status)
 {
 	int err;
@@ -161,6 +248,7 @@ static void lte_lc_evt_handler(const struct lte_lc_evt *const evt)
 			network_status_notify(NETWORK_UICC_FAILURE);
 		} else if (evt->nw_reg_status == LTE_LC_NW_REG_NOT_REGISTERED) {
 			LOG_WRN("Not registered, check rejection cause");
+			modem_trace_ring_trigger(MODEM_TRACE_RING_TRIGGER_ATTACH_REJECTED);
 			network_status_notify(NETWORK_ATTACH_REJECTED);
 		}
 
@@ -263,6 +351,338 @@ static void request_system_mode(void)
 	network_msg_send(&msg);
 }
 
+#if defined(CONFIG_LTE_LC_CONN_EVAL_MODULE)
+static void sample_network_quality(void)
+{
+	int err;
+	struct network_msg msg = {
+		.type = NETWORK_QUALITY_SAMPLE_RESPONSE,
+	};
+
+	err = lte_lc_conn_eval_params_get(&msg.conn_eval_params);
+	if (err) {
+		/* Positive values are modem evaluation failures, for example while in RRC
+		 * connected mode. Not fatal, the requester keeps its previous sample.
+		 */
+		LOG_WRN("lte_lc_conn_eval_params_get, error: %d", err);
+
+		return;
+	}
+
+	LOG_DBG("Network quality sampled, RSRP index: %d, energy estimate: %d",
+		msg.conn_eval_params.rsrp, msg.conn_eval_params.energy_estimate);
+
+	network_msg_send(&msg);
+}
+#endif /* CONFIG_LTE_LC_CONN_EVAL_MODULE */
+
+#if defined(CONFIG_APP_NETWORK_POWER_SAVING_NEGOTIATION)
+/* Largest periodic TAU that can be requested, 31 times 320 hours */
+#define PSM_TAU_MAX_SECONDS (31 * 320 * 60 * 60)
+
+/* eDRX cycle value and length, 3GPP TS 24.008 table 10.5.5.32 */
+struct edrx_value {
+	const char *bits;
+	uint32_t cycle_ms;
+};
+
+static const struct edrx_value edrx_values_ltem[] = {
+	{ "0000", 5120 }, { "0001", 10240 }, { "0010", 20480 }, { "0011", 40960 },
+	{ "0100", 61440 }, { "0101", 81920 }, { "0110", 102400 }, { "0111", 122880 },
+	{ "1000", 143360 }, { "1001", 163840 }, { "1010", 327680 }, { "1011", 655360 },
+	{ "1100", 1310720 }, { "1101", 2621440 }, { "1110", 5242880 }, { "1111", 10485760 },
+};
+
+/* NB-IoT does not allow all values */
+static const struct edrx_value edrx_values_nbiot[] = {
+	{ "0010", 20480 }, { "0011", 40960 }, { "0101", 81920 }, { "1001", 163840 },
+	{ "1010", 327680 }, { "1011", 655360 }, { "1100", 1310720 }, { "1101", 2621440 },
+	{ "1110", 5242880 }, { "1111", 10485760 },
+};
+
+/* Returns the longest eDRX cycle not above max_ms, or the shortest cycle if all are */
+static const char *edrx_value_get(const struct edrx_value *values, size_t count,
+				  uint32_t max_ms)
+{
+	const char *bits = values[0].bits;
+
+	for (size_t i = 0; i < count; i++) {
+		if (values[i].cycle_ms <= max_ms) {
+			bits = values[i].bits;
+		}
+	}
+
+	return bits;
+}
+
+static uint32_t psm_tau_get(const struct network_schedule *schedule)
+{
+	uint64_t tau = (uint64_t)schedule->upload_interval_sec *
+		       CONFIG_APP_NETWORK_PSM_TAU_UPLOAD_MULTIPLIER;
+
+	return (uint32_t)CLAMP(tau, CONFIG_APP_NETWORK_PSM_TAU_MIN_SECONDS, PSM_TAU_MAX_SECONDS);
+}
+
+static void psm_request(struct network_state_object *state_object)
+{
+	int err;
+	uint32_t tau = psm_tau_get(&state_object->schedule);
+
+	/* Every request makes the modem renegotiate with the network */
+	if (tau == state_object->requested_tau) {
+		return;
+	}
+
+	err = lte_lc_psm_param_set_seconds(tau, CONFIG_APP_NETWORK_PSM_ACTIVE_TIME_SECONDS);
+	if (err) {
+		LOG_ERR("lte_lc_psm_param_set_seconds, error: %d", err);
+
+		return;
+	}
+
+	err = lte_lc_psm_req(true);
+	if (err) {
+		LOG_ERR("lte_lc_psm_req, error: %d", err);
+
+		return;
+	}
+
+	state_object->requested_tau = tau;
+
+	LOG_DBG("Requested PSM, TAU: %d s, active time: %d s", tau,
+		CONFIG_APP_NETWORK_PSM_ACTIVE_TIME_SECONDS);
+}
+
+/* Request the longest eDRX cycle that does not exceed the sample interval */
+static int edrx_cycle_request(const struct network_state_object *state_object)
+{
+	int err;
+	uint32_t max_ms = MIN(state_object->schedule.sample_interval_sec,
+			      CONFIG_APP_NETWORK_EDRX_MAX_SECONDS) * MSEC_PER_SEC;
+
+	err = lte_lc_edrx_param_set(LTE_LC_LTE_MODE_LTEM,
+				    edrx_value_get(edrx_values_ltem, ARRAY_SIZE(edrx_values_ltem),
+						   max_ms));
+	if (err) {
+		LOG_ERR("lte_lc_edrx_param_set, error: %d", err);
+
+		return err;
+	}
+
+	err = lte_lc_edrx_param_set(LTE_LC_LTE_MODE_NBIOT,
+				    edrx_value_get(edrx_values_nbiot, ARRAY_SIZE(edrx_values_nbiot),
+						   max_ms));
+	if (err) {
+		LOG_ERR("lte_lc_edrx_param_set, error: %d", err);
+
+		return err;
+	}
+
+	err = lte_lc_edrx_req(true);
+	if (err) {
+		LOG_ERR("lte_lc_edrx_req, error: %d", err);
+
+		return err;
+	}
+
+	return 0;
+}
+
+/* Go back to the eDRX values of CONFIG_LTE_EDRX_REQ_VALUE_LTE_M and
+ * CONFIG_LTE_EDRX_REQ_VALUE_NBIOT, used during the PSM active time.
+ */
+static int edrx_default_request(void)
+{
+	int err;
+
+	err = lte_lc_edrx_param_set(LTE_LC_LTE_MODE_LTEM, CONFIG_LTE_EDRX_REQ_VALUE_LTE_M);
+	if (err) {
+		LOG_ERR("lte_lc_edrx_param_set, error: %d", err);
+
+		return err;
+	}
+
+	err = lte_lc_edrx_param_set(LTE_LC_LTE_MODE_NBIOT, CONFIG_LTE_EDRX_REQ_VALUE_NBIOT);
+	if (err) {
+		LOG_ERR("lte_lc_edrx_param_set, error: %d", err);
+
+		return err;
+	}
+
+	err = lte_lc_edrx_req(IS_ENABLED(CONFIG_LTE_EDRX_REQ));
+	if (err) {
+		LOG_ERR("lte_lc_edrx_req, error: %d", err);
+
+		return err;
+	}
+
+	return 0;
+}
+
+static void edrx_fallback_set(struct network_state_object *state_object, bool enable)
+{
+	int err;
+
+	if (enable == state_object->edrx_fallback) {
+		return;
+	}
+
+	if (enable) {
+		err = edrx_cycle_request(state_object);
+	} else {
+		err = edrx_default_request();
+	}
+
+	if (err) {
+		return;
+	}
+
+	state_object->edrx_fallback = enable;
+
+	LOG_DBG("eDRX fallback %s", enable ? "requested" : "stopped");
+}
+
+static void schedule_apply(struct network_state_object *state_object)
+{
+	psm_request(state_object);
+
+	/* Follow the new sample interval with the eDRX cycle */
+	if (state_object->edrx_fallback) {
+		(void)edrx_cycle_request(state_object);
+	}
+}
+
+/* Check the PSM parameters granted by the network against the schedule */
+static void psm_granted_check(struct network_state_object *state_object,
+			      const struct lte_lc_psm_cfg *psm_cfg)
+{
+	if (state_object->requested_tau == 0) {
+		return;
+	}
+
+	/* An active time of -1 means that the network did not grant PSM */
+	if (psm_cfg->active_time < 0) {
+		LOG_WRN("PSM not granted by the network, requesting eDRX");
+		edrx_fallback_set(state_object, true);
+
+		return;
+	}
+
+	if ((psm_cfg->tau >= 0) &&
+	    ((uint32_t)psm_cfg->tau < state_object->schedule.upload_interval_sec)) {
+		LOG_WRN("Granted TAU of %d s is shorter than the upload interval of %d s",
+			psm_cfg->tau, state_object->schedule.upload_interval_sec);
+	}
+
+	edrx_fallback_set(state_object, false);
+}
+#endif /* CONFIG_APP_NETWORK_POWER_SAVING_NEGOTIATION */
+
+#if defined(CONFIG_APP_NETWORK_FAST_REATTACH)
+static void reattach_timeout_work_fn(struct k_work *work)
+{
+	int err;
+	const struct priv_network_msg msg = { .type = NETWORK_PRIV_REATTACH_TIMEOUT };
+
+	ARG_UNUSED(work);
+
+	err = zbus_chan_pub(&priv_network_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+K_WORK_DELAYABLE_DEFINE(reattach_timeout_work, reattach_timeout_work_fn);
+
+/* Lock the modem to the cached bands of the last connections, or remove the lock. The band
+ * lock is not stored by the modem.
+ */
+static void band_lock_set(struct network_state_object *state_object, bool use_cache)
+{
+	int err;
+	char mask[NETWORK_REATTACH_BAND_MASK_SIZE];
+	char plmn[NETWORK_REATTACH_PLMN_SIZE];
+	bool lock = use_cache && network_reattach_band_mask_get(mask, sizeof(mask), plmn);
+
+	if (!lock && !state_object->band_locked) {
+		return;
+	}
+
+	if (lock) {
+		err = nrf_modem_at_printf("AT%%XBANDLOCK=2,\"%s\"", mask);
+	} else {
+		err = nrf_modem_at_printf("AT%%XBANDLOCK=0");
+	}
+
+	if (err) {
+		/* Not fatal, the modem searches without the lock */
+		LOG_WRN("Failed to set band lock, error: %d", err);
+
+		return;
+	}
+
+	state_object->band_locked = lock;
+
+	if (lock) {
+		LOG_DBG("Searching the last bands of PLMN %s first, band mask: %s", plmn, mask);
+
+		(void)k_work_reschedule(&reattach_timeout_work,
+					K_SECONDS(CONFIG_APP_NETWORK_FAST_REATTACH_TIMEOUT_SECONDS));
+	}
+}
+
+/* Cache the PLMN and band of the serving cell for the next search */
+static void serving_cell_cache(void)
+{
+	int ret;
+	char plmn[NETWORK_REATTACH_PLMN_SIZE];
+	uint8_t band;
+
+	/* %XMONITOR: <reg_status>,<full_name>,<short_name>,<plmn>,<tac>,<AcT>,<band>,... */
+	ret = nrf_modem_at_scanf("AT%XMONITOR",
+				 "%%XMONITOR: %*d,%*[^,],%*[^,],\"%6[0-9]\",%*[^,],%*d,%hhu",
+				 plmn, &band);
+	if (ret != 2) {
+		LOG_WRN("Failed to read the serving cell, error: %d", ret);
+
+		return;
+	}
+
+	network_reattach_update(plmn, band);
+}
+#endif /* CONFIG_APP_NETWORK_FAST_REATTACH */
+
+#if defined(CONFIG_APP_NETWORK_RAI)
+/* Indicate that no more data is expected, so that the network can release the RRC
+ * connection. A temporary socket is used because the sockets of the data transaction are
+ * owned by the cloud libraries.
+ */
+static void release_assistance_request(void)
+{
+	int err;
+	int fd;
+	const int rai = NRF_RAI_NO_DATA;
+
+	fd = nrf_socket(NRF_AF_INET, NRF_SOCK_DGRAM, NRF_IPPROTO_UDP);
+	if (fd < 0) {
+		LOG_WRN("nrf_socket, error: %d", -errno);
+
+		return;
+	}
+
+	err = nrf_setsockopt(fd, NRF_SOL_SOCKET, NRF_SO_RAI, &rai, sizeof(rai));
+	if (err) {
+		/* Not fatal, the network releases the connection after its inactivity timer */
+		LOG_WRN("nrf_setsockopt, error: %d", -errno);
+	} else {
+		LOG_DBG("Release assistance indicated");
+	}
+
+	(void)nrf_close(fd);
+}
+#endif /* CONFIG_APP_NETWORK_RAI */
+
 static int network_disconnect(void)
 {
 	int err;
@@ -277,6 +697,143 @@ static int network_disconnect(void)
 	return 0;
 }
 
+#if defined(CONFIG_APP_NETWORK_SEARCH_POLICY)
+/* Length of the search budget window */
+#define SEARCH_BUDGET_WINDOW_MS (60 * 60 * MSEC_PER_SEC)
+
+/* Longest sleep between periodic searches that the modem accepts */
+#define PERIODIC_SEARCH_SLEEP_MAX_SECONDS 65535
+
+static void search_timer_work_fn(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(search_budget_work, search_timer_work_fn);
+K_WORK_DELAYABLE_DEFINE(search_resume_work, search_timer_work_fn);
+
+static void search_timer_work_fn(struct k_work *work)
+{
+	int err;
+	struct priv_network_msg msg = { .type = NETWORK_PRIV_SEARCH_BUDGET_USED };
+
+	if (work == &search_resume_work.work) {
+		msg.type = NETWORK_PRIV_SEARCH_RESUME;
+	}
+
+	err = zbus_chan_pub(&priv_network_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+/* Configure the modem to sleep between its searches with exponentially increasing times,
+ * with a full search of all bands for every CONFIG_APP_NETWORK_SEARCH_FULL_SEARCH_INTERVAL
+ * searches. The other searches are light searches on the cells in the modem's history.
+ */
+static void periodic_search_configure(void)
+{
+	int err;
+	const uint32_t sleep = CONFIG_APP_NETWORK_SEARCH_INITIAL_SLEEP_SECONDS;
+	const struct lte_lc_periodic_search_cfg cfg = {
+		.loop = false,
+		.return_to_pattern = 0,
+		.band_optimization = CONFIG_APP_NETWORK_SEARCH_FULL_SEARCH_INTERVAL,
+		.pattern_count = 1,
+		.patterns[0] = {
+			.type = LTE_LC_PERIODIC_SEARCH_PATTERN_TABLE,
+			.table = {
+				.val_1 = MIN(sleep, PERIODIC_SEARCH_SLEEP_MAX_SECONDS),
+				.val_2 = MIN(sleep * 2, PERIODIC_SEARCH_SLEEP_MAX_SECONDS),
+				.val_3 = MIN(sleep * 4, PERIODIC_SEARCH_SLEEP_MAX_SECONDS),
+				.val_4 = MIN(sleep * 8, PERIODIC_SEARCH_SLEEP_MAX_SECONDS),
+				.val_5 = MIN(sleep * 16, PERIODIC_SEARCH_SLEEP_MAX_SECONDS),
+			},
+		},
+	};
+
+	err = lte_lc_periodic_search_set(&cfg);
+	if (err) {
+		/* Not fatal, the modem uses its default search pattern */
+		LOG_WRN("lte_lc_periodic_search_set, error: %d", err);
+	}
+}
+
+/* Returns the search time left in the current budget window in ms */
+static int64_t search_budget_remaining_ms(struct network_state_object *state_object)
+{
+	const int64_t budget_ms = (int64_t)CONFIG_APP_NETWORK_SEARCH_BUDGET_SECONDS_PER_HOUR *
+				  MSEC_PER_SEC;
+	int64_t now_ms = k_uptime_get();
+
+	if ((now_ms - state_object->budget_window_start_ms) >= SEARCH_BUDGET_WINDOW_MS) {
+		state_object->budget_window_start_ms = now_ms;
+		state_object->budget_used_ms = 0;
+	}
+
+	return MAX(budget_ms - state_object->budget_used_ms, 0);
+}
+
+/* Returns true if a search can be started, otherwise the search is suspended */
+static bool search_budget_start(struct network_state_object *state_object)
+{
+	int64_t remaining_ms = search_budget_remaining_ms(state_object);
+
+	if (remaining_ms == 0) {
+		/* The state cannot be changed from an entry function */
+		(void)k_work_reschedule(&search_budget_work, K_NO_WAIT);
+
+		return false;
+	}
+
+	state_object->search_start_ms = k_uptime_get();
+
+	(void)k_work_reschedule(&search_budget_work, K_MSEC(remaining_ms));
+
+	return true;
+}
+
+static void search_budget_stop(struct network_state_object *state_object)
+{
+	(void)k_work_cancel_delayable(&search_budget_work);
+
+	if (state_object->search_start_ms) {
+		state_object->budget_used_ms += k_uptime_get() - state_object->search_start_ms;
+		state_object->search_start_ms = 0;
+	}
+}
+
+/* Stop searching until the first sample deadline after the budget window ends. Samples are
+ * buffered by the storage module until the device is connected again.
+ */
+static void search_suspend(struct network_state_object *state_object)
+{
+	int err;
+	uint32_t delay_sec = DIV_ROUND_UP(SEARCH_BUDGET_WINDOW_MS -
+					  (k_uptime_get() - state_object->budget_window_start_ms),
+					  MSEC_PER_SEC);
+
+	if (state_object->schedule.sample_interval_sec) {
+		delay_sec = ROUND_UP(delay_sec, state_object->schedule.sample_interval_sec);
+	}
+
+	LOG_WRN("Search budget of %d s per hour used, searching again in %d s",
+		CONFIG_APP_NETWORK_SEARCH_BUDGET_SECONDS_PER_HOUR, delay_sec);
+
+	err = network_disconnect();
+	if (err) {
+		LOG_ERR("network_disconnect, error: %d", err);
+		SEND_FATAL_ERROR();
+
+		return;
+	}
+
+	state_object->search_suspended = true;
+
+	(void)k_work_reschedule(&search_resume_work, K_SECONDS(delay_sec));
+
+	smf_set_state(SMF_CTX(state_object), &states[STATE_DISCONNECTED_IDLE]);
+}
+#endif /* CONFIG_APP_NETWORK_SEARCH_POLICY */
+
 /* State handlers */
 
 static void state_running_entry(void *obj)
@@ -306,12 +863,16 @@ static void state_running_entry(void *obj)
 		return;
 	}
 
+#if defined(CONFIG_APP_NETWORK_SEARCH_POLICY)
+	periodic_search_configure();
+#endif /* CONFIG_APP_NETWORK_SEARCH_POLICY */
+
 	LOG_DBG("Network module started");
 }
 
 static enum smf_state_result state_running_run(void *obj)
 {
-	struct network_state_object const *state_object = obj;
+	struct network_state_object *state_object = obj;
 
 	if (&network_chan == state_object->chan) {
 		const struct network_msg *msg = (const struct network_msg *)state_object->msg_buf;
@@ -329,6 +890,20 @@ static enum smf_state_result state_running_run(void *obj)
 			request_system_mode();
 
 			return SMF_EVENT_HANDLED;
+		case NETWORK_SCHEDULE_SET:
+			state_object->schedule = msg->schedule;
+
+#if defined(CONFIG_APP_NETWORK_POWER_SAVING_NEGOTIATION)
+			schedule_apply(state_object);
+#endif /* CONFIG_APP_NETWORK_POWER_SAVING_NEGOTIATION */
+
+			return SMF_EVENT_HANDLED;
+#if defined(CONFIG_APP_NETWORK_POWER_SAVING_NEGOTIATION)
+		case NETWORK_PSM_PARAMS:
+			psm_granted_check(state_object, &msg->psm_cfg);
+
+			return SMF_EVENT_HANDLED;
+#endif /* CONFIG_APP_NETWORK_POWER_SAVING_NEGOTIATION */
 		default:
 			break;
 		}
@@ -369,11 +944,22 @@ static enum smf_state_result state_disconnected_run(void *obj)
 static void state_disconnected_searching_entry(void *obj)
 {
 	int err;
+	struct network_state_object *state_object = obj;
 
-	ARG_UNUSED(obj);
+	ARG_UNUSED(state_object);
 
 	LOG_DBG("state_disconnected_searching_entry");
 
+#if defined(CONFIG_APP_NETWORK_SEARCH_POLICY)
+	if (!search_budget_start(state_object)) {
+		return;
+	}
+#endif /* CONFIG_APP_NETWORK_SEARCH_POLICY */
+
+#if defined(CONFIG_APP_NETWORK_FAST_REATTACH)
+	band_lock_set(state_object, !state_object->reattach_failed);
+#endif /* CONFIG_APP_NETWORK_FAST_REATTACH */
+
 	err = lte_lc_connect_async(lte_lc_evt_handler);
 	if (err) {
 		LOG_ERR("lte_lc_connect_async, error: %d", err);
@@ -382,10 +968,57 @@ static void state_disconnected_searching_entry(void *obj)
 	}
 }
 
+#if defined(CONFIG_APP_NETWORK_FAST_REATTACH)
+/* Search all bands after a search on the cached bands has failed */
+static void reattach_fallback(struct network_state_object *state_object)
+{
+	int err;
+
+	LOG_WRN("No connection on the cached bands, searching all bands");
+
+	state_object->reattach_failed = true;
+
+	/* The band lock can only be removed while the modem is offline */
+	err = network_disconnect();
+	if (err) {
+		LOG_ERR("network_disconnect, error: %d", err);
+		SEND_FATAL_ERROR();
+
+		return;
+	}
+
+	smf_set_state(SMF_CTX(state_object), &states[STATE_DISCONNECTED_SEARCHING]);
+}
+#endif /* CONFIG_APP_NETWORK_FAST_REATTACH */
+
 static enum smf_state_result state_disconnected_searching_run(void *obj)
 {
 	int err;
-	struct network_state_object const *state_object = obj;
+	struct network_state_object *state_object = obj;
+
+	if (&priv_network_chan == state_object->chan) {
+		const struct priv_network_msg *msg =
+			(const struct priv_network_msg *)state_object->msg_buf;
+
+		switch (msg->type) {
+#if defined(CONFIG_APP_NETWORK_FAST_REATTACH)
+		case NETWORK_PRIV_REATTACH_TIMEOUT:
+			if (state_object->band_locked) {
+				reattach_fallback(state_object);
+			}
+
+			return SMF_EVENT_HANDLED;
+#endif /* CONFIG_APP_NETWORK_FAST_REATTACH */
+#if defined(CONFIG_APP_NETWORK_SEARCH_POLICY)
+		case NETWORK_PRIV_SEARCH_BUDGET_USED:
+			search_suspend(state_object);
+
+			return SMF_EVENT_HANDLED;
+#endif /* CONFIG_APP_NETWORK_SEARCH_POLICY */
+		default:
+			break;
+		}
+	}
 
 	if (&network_chan == state_object->chan) {
 		const struct network_msg *msg = (const struct network_msg *)state_object->msg_buf;
@@ -393,6 +1026,17 @@ static enum smf_state_result state_disconnected_searching_run(void *obj)
 		switch (msg->type) {
 		case NETWORK_CONNECT:
 			return SMF_EVENT_HANDLED;
+#if defined(CONFIG_APP_NETWORK_FAST_REATTACH)
+		case NETWORK_SEARCH_DONE:
+			/* The modem has searched all locked bands */
+			if (state_object->band_locked) {
+				reattach_fallback(state_object);
+
+				return SMF_EVENT_HANDLED;
+			}
+
+			break;
+#endif /* CONFIG_APP_NETWORK_FAST_REATTACH */
 		case NETWORK_SEARCH_STOP: __fallthrough;
 		case NETWORK_DISCONNECT:
 			err = network_disconnect();
@@ -414,11 +1058,35 @@ static enum smf_state_result state_disconnected_searching_run(void *obj)
 static enum smf_state_result state_disconnected_idle_run(void *obj)
 {
 	int err;
-	struct network_state_object const *state_object = obj;
+	struct network_state_object *state_object = obj;
+
+#if defined(CONFIG_APP_NETWORK_SEARCH_POLICY)
+	if (&priv_network_chan == state_object->chan) {
+		const struct priv_network_msg *msg =
+			(const struct priv_network_msg *)state_object->msg_buf;
+
+		if ((msg->type == NETWORK_PRIV_SEARCH_RESUME) && state_object->search_suspended) {
+			state_object->search_suspended = false;
+
+			smf_set_state(SMF_CTX(state_object), &states[STATE_DISCONNECTED_SEARCHING]);
+		}
+
+		return SMF_EVENT_HANDLED;
+	}
+#endif /* CONFIG_APP_NETWORK_SEARCH_POLICY */
 
 	if (&network_chan == state_object->chan) {
 		const struct network_msg *msg = (const struct network_msg *)state_object->msg_buf;
 
+#if defined(CONFIG_APP_NETWORK_SEARCH_POLICY)
+		/* A request from the application replaces a pending resume */
+		if ((msg->type == NETWORK_DISCONNECT) || (msg->type == NETWORK_CONNECT)) {
+			state_object->search_suspended = false;
+
+			(void)k_work_cancel_delayable(&search_resume_work);
+		}
+#endif /* CONFIG_APP_NETWORK_SEARCH_POLICY */
+
 		switch (msg->type) {
 		case NETWORK_DISCONNECT:
 			return SMF_EVENT_HANDLED;
@@ -461,11 +1129,38 @@ static enum smf_state_result state_disconnected_idle_run(void *obj)
 	return SMF_EVENT_PROPAGATE;
 }
 
+static void state_disconnected_searching_exit(void *obj)
+{
+	LOG_DBG("state_disconnected_searching_exit");
+
+#if defined(CONFIG_APP_NETWORK_SEARCH_POLICY)
+	search_budget_stop(obj);
+#else
+	ARG_UNUSED(obj);
+#endif /* CONFIG_APP_NETWORK_SEARCH_POLICY */
+}
+
 static void state_connected_entry(void *obj)
 {
+#if defined(CONFIG_APP_NETWORK_FAST_REATTACH)
+	struct network_state_object *state_object = obj;
+
+	LOG_DBG("state_connected_entry");
+
+	(void)k_work_cancel_delayable(&reattach_timeout_work);
+
+	serving_cell_cache();
+
+	/* Allow the modem to find other bands if the connection is lost, and use the cached
+	 * bands again at the next search.
+	 */
+	band_lock_set(state_object, false);
+	state_object->reattach_failed = false;
+#else
 	ARG_UNUSED(obj);
 
 	LOG_DBG("state_connected_entry");
+#endif /* CONFIG_APP_NETWORK_FAST_REATTACH */
 }
 
 static enum smf_state_result state_connected_run(void *obj)
@@ -480,6 +1175,22 @@ static enum smf_state_result state_connected_run(void *obj)
 
 			return SMF_EVENT_HANDLED;
 		}
+
+#if defined(CONFIG_LTE_LC_CONN_EVAL_MODULE)
+		if (msg->type == NETWORK_QUALITY_SAMPLE_REQUEST) {
+			sample_network_quality();
+
+			return SMF_EVENT_HANDLED;
+		}
+#endif /* CONFIG_LTE_LC_CONN_EVAL_MODULE */
+
+#if defined(CONFIG_APP_NETWORK_RAI)
+		if (msg->type == NETWORK_TRANSACTION_DONE) {
+			release_assistance_request();
+
+			return SMF_EVENT_HANDLED;
+		}
+#endif /* CONFIG_APP_NETWORK_RAI */
 	}
 
 	return SMF_EVENT_PROPAGATE;
@@ -545,6 +1256,7 @@ static void network_module_thread(void)
 	}
 
 	smf_set_initial(SMF_CTX(&network_state), &states[STATE_RUNNING]);
+	STATE_STATS_UPDATE(network, SMF_CTX(&network_state));
 
 	while (true) {
 		err = task_wdt_feed(task_wdt_id);
@@ -564,12 +1276,18 @@ static void network_module_thread(void)
 			return;
 		}
 
+		zbus_stats_received(&network, network_state.chan);
+
+		HANDLER_STATS_START(network, network_state.chan);
 		err = smf_run_state(SMF_CTX(&network_state));
+		HANDLER_STATS_END(network);
 		if (err) {
 			LOG_ERR("smf_run_state(), error: %d", err);
 			SEND_FATAL_ERROR();
 			return;
 		}
+
+		STATE_STATS_UPDATE(network, SMF_CTX(&network_state));
 	}
 }
 
@@ -74,6 +74,11 @@ enum network_msg_type {
 	 */
 	NETWORK_SYSTEM_MODE_RESPONSE,
 
+	/* Response message to a request for a network quality sample. The sample is found in the
+	 * .conn_eval_params field of the message.
+	 */
+	NETWORK_QUALITY_SAMPLE_RESPONSE,
+
 	/* Input message types */
 
 	/* Request to connect to the network, which includes searching for a suitable network
@@ -112,6 +117,34 @@ enum network_msg_type {
 	 * NETWORK_SYSTEM_MODE_RESPONSE message.
 	 */
 	NETWORK_SYSTEM_MODE_REQUEST,
+
+	/* Request to sample the quality of the current network connection. The response is sent
+	 * as a NETWORK_QUALITY_SAMPLE_RESPONSE message. The request is ignored when the device is
+	 * not connected to a network.
+	 */
+	NETWORK_QUALITY_SAMPLE_REQUEST,
+
+	/* The sample and upload intervals of the application have changed. The intervals are
+	 * found in the .schedule field of the message. With
+	 * CONFIG_APP_NETWORK_POWER_SAVING_NEGOTIATION, the module requests PSM and eDRX timers
+	 * that match them. With CONFIG_APP_NETWORK_SEARCH_POLICY, a suspended search is resumed
+	 * at a sample deadline.
+	 */
+	NETWORK_SCHEDULE_SET,
+
+	/* The application has completed a data transaction and expects no more traffic. With
+	 * CONFIG_APP_NETWORK_RAI, the module indicates to the network that the RRC connection
+	 * can be released. Only handled while connected.
+	 */
+	NETWORK_TRANSACTION_DONE,
+};
+
+struct network_schedule {
+	/* Interval in seconds between data samplings */
+	uint32_t sample_interval_sec;
+
+	/* Expected interval in seconds between uploads to cloud */
+	uint32_t upload_interval_sec;
 };
 
 struct network_msg {
@@ -131,6 +164,17 @@ struct network_msg {
 		 *  edrx_cfg is valid for NETWORK_EDRX_PARAMS events.
 		 */
 		IF_ENABLED(CONFIG_LTE_LC_EDRX_MODULE, (struct lte_lc_edrx_cfg edrx_cfg));
+
+		/** Contains the current connection evaluation parameters, RSRP is given as an index.
+		 *  conn_eval_params is valid for NETWORK_QUALITY_SAMPLE_RESPONSE events.
+		 */
+		IF_ENABLED(CONFIG_LTE_LC_CONN_EVAL_MODULE,
+			   (struct lte_lc_conn_eval_params conn_eval_params));
+
+		/** Contains the sample and upload intervals of the application.
+		 *  schedule is valid for NETWORK_SCHEDULE_SET events.
+		 */
+		struct network_schedule schedule;
 	};
 };
 
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <string.h>
+
+#include "network_reattach.h"
+
+LOG_MODULE_DECLARE(network, CONFIG_APP_NETWORK_LOG_LEVEL);
+
+#define SETTINGS_SUBTREE	"att_network"
+#define SETTINGS_KEY		"cell"
+
+struct reattach_cache {
+	char plmn[NETWORK_REATTACH_PLMN_SIZE];
+
+	/* Bands the device connected on with the PLMN, most recently used first, 0 if unused */
+	uint8_t bands[CONFIG_APP_NETWORK_FAST_REATTACH_BAND_COUNT];
+};
+
+/* Only accessed from the network thread */
+static struct reattach_cache cache;
+static bool loaded;
+
+static int settings_load_cb(const char *key, size_t len, settings_read_cb read_cb,
+			    void *cb_arg, void *param)
+{
+	ssize_t ret;
+
+	ARG_UNUSED(param);
+
+	if (!key || (strcmp(key, SETTINGS_KEY) != 0)) {
+		return 0;
+	}
+
+	if (len != sizeof(cache)) {
+		LOG_WRN("Dropping saved serving cell of unexpected size: %zu", len);
+
+		return 0;
+	}
+
+	ret = read_cb(cb_arg, &cache, len);
+	if ((ret != (ssize_t)len) || (cache.plmn[sizeof(cache.plmn) - 1] != '\0')) {
+		LOG_WRN("Failed to read saved serving cell");
+
+		memset(&cache, 0, sizeof(cache));
+	}
+
+	return 0;
+}
+
+static void load(void)
+{
+	int err;
+
+	if (loaded) {
+		return;
+	}
+
+	loaded = true;
+
+	err = settings_subsys_init();
+	if (err) {
+		LOG_WRN("settings_subsys_init, error: %d", err);
+
+		return;
+	}
+
+	err = settings_load_subtree_direct(SETTINGS_SUBTREE, settings_load_cb, NULL);
+	if (err) {
+		LOG_WRN("settings_load_subtree_direct, error: %d", err);
+	}
+}
+
+bool network_reattach_band_mask_get(char *mask, size_t size, char *plmn)
+{
+	uint8_t highest = 0;
+
+	load();
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache.bands); i++) {
+		highest = MAX(highest, cache.bands[i]);
+	}
+
+	if ((highest == 0) || (size <= highest)) {
+		return false;
+	}
+
+	/* The last character is band 1 */
+	memset(mask, '0', highest);
+	mask[highest] = '\0';
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache.bands); i++) {
+		if (cache.bands[i]) {
+			mask[highest - cache.bands[i]] = '1';
+		}
+	}
+
+	memcpy(plmn, cache.plmn, sizeof(cache.plmn));
+
+	return true;
+}
+
+void network_reattach_update(const char *plmn, uint8_t band)
+{
+	int err;
+	struct reattach_cache updated = { 0 };
+	size_t count = 1;
+	bool known = false;
+
+	if ((band == 0) || (band > NETWORK_REATTACH_BAND_MAX) ||
+	    (strlen(plmn) >= sizeof(updated.plmn))) {
+		LOG_DBG("Serving cell not cached, PLMN: %s, band: %d", plmn, band);
+
+		return;
+	}
+
+	load();
+
+	strcpy(updated.plmn, plmn);
+	updated.bands[0] = band;
+
+	/* Keep the other bands of the same PLMN after the new band */
+	if (strcmp(cache.plmn, plmn) == 0) {
+		for (size_t i = 0; i < ARRAY_SIZE(cache.bands); i++) {
+			if (cache.bands[i] == band) {
+				known = true;
+			} else if (cache.bands[i] && (count < ARRAY_SIZE(updated.bands))) {
+				updated.bands[count++] = cache.bands[i];
+			}
+		}
+	}
+
+	if (memcmp(&updated, &cache, sizeof(cache)) == 0) {
+		return;
+	}
+
+	/* A new order of the same bands is not worth a flash write */
+	if (known) {
+		cache = updated;
+
+		return;
+	}
+
+	cache = updated;
+
+	err = settings_save_one(SETTINGS_SUBTREE "/" SETTINGS_KEY, &cache, sizeof(cache));
+	if (err) {
+		LOG_WRN("settings_save_one, error: %d", err);
+	}
+}
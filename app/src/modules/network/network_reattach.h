@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _NETWORK_REATTACH_H_
+#define _NETWORK_REATTACH_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Highest band that can be given in an AT%XBANDLOCK band mask */
+#define NETWORK_REATTACH_BAND_MAX		88
+
+/* Size of a band mask string, one character per band and a null terminator */
+#define NETWORK_REATTACH_BAND_MASK_SIZE		(NETWORK_REATTACH_BAND_MAX + 1)
+
+/* Size of a PLMN string, MCC and up to three digits of MNC and a null terminator */
+#define NETWORK_REATTACH_PLMN_SIZE		7
+
+/**
+ * @brief Get the band mask for the bands the device last connected on.
+ *
+ * The cache is loaded from settings at the first call.
+ *
+ * @param[out] mask Band mask string in AT%XBANDLOCK format, with band 1 as the last character.
+ * @param[in] size Size of the mask buffer, at least NETWORK_REATTACH_BAND_MASK_SIZE.
+ * @param[out] plmn PLMN the bands were used with, NETWORK_REATTACH_PLMN_SIZE bytes.
+ *
+ * @return true if bands are cached, false otherwise.
+ */
+bool network_reattach_band_mask_get(char *mask, size_t size, char *plmn);
+
+/**
+ * @brief Add the serving cell of a new connection to the cache.
+ *
+ * The band is added to the bands of the PLMN, replacing the least recently used band when
+ * CONFIG_APP_NETWORK_FAST_REATTACH_BAND_COUNT bands are cached. A new PLMN replaces all cached
+ * bands. The cache is saved to settings when it changes.
+ *
+ * @param[in] plmn PLMN of the serving cell.
+ * @param[in] band Band of the serving cell.
+ */
+void network_reattach_update(const char *plmn, uint8_t band);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _NETWORK_REATTACH_H_ */
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include "energy_ledger.h"
+
+/* Microampere-milliseconds in one microampere-hour */
+#define UA_MS_PER_UAH	(3600ULL * MSEC_PER_SEC)
+
+/* Only accessed from the power module thread */
+static struct {
+	/* Charge per activity in microampere-milliseconds */
+	uint64_t charge_ua_ms[ENERGY_LEDGER_COUNT];
+
+	/* Active activities, bit per enum energy_ledger_activity */
+	uint32_t active;
+
+	/* Uptime at the last update */
+	int64_t last_update_ms;
+} ledger;
+
+static const char *const activity_names[ENERGY_LEDGER_COUNT] = {
+	[ENERGY_LEDGER_FOTA] = "fota",
+	[ENERGY_LEDGER_LOCATION] = "location",
+	[ENERGY_LEDGER_SLEEP] = "sleep",
+	[ENERGY_LEDGER_CLOUD] = "cloud",
+	[ENERGY_LEDGER_OTHER] = "other",
+};
+
+void energy_ledger_update(float current, int64_t now_ms)
+{
+	int64_t span_ms = now_ms - ledger.last_update_ms;
+
+	ledger.last_update_ms = now_ms;
+
+	if ((span_ms <= 0) || (current <= 0.0f)) {
+		return;
+	}
+
+	ledger.charge_ua_ms[energy_ledger_activity_get()] +=
+		(uint64_t)(current * 1e6f + 0.5f) * (uint64_t)span_ms;
+}
+
+void energy_ledger_activity_set(enum energy_ledger_activity activity, bool active)
+{
+	if (activity >= ENERGY_LEDGER_OTHER) {
+		return;
+	}
+
+	WRITE_BIT(ledger.active, activity, active);
+}
+
+bool energy_ledger_activity_is_active(enum energy_ledger_activity activity)
+{
+	if (activity >= ENERGY_LEDGER_OTHER) {
+		return false;
+	}
+
+	return (ledger.active & BIT(activity)) != 0;
+}
+
+enum energy_ledger_activity energy_ledger_activity_get(void)
+{
+	for (enum energy_ledger_activity activity = 0; activity < ENERGY_LEDGER_OTHER;
+	     activity++) {
+		if (ledger.active & BIT(activity)) {
+			return activity;
+		}
+	}
+
+	return ENERGY_LEDGER_OTHER;
+}
+
+void energy_ledger_get(uint32_t charge_uah[ENERGY_LEDGER_COUNT])
+{
+	for (size_t i = 0; i < ENERGY_LEDGER_COUNT; i++) {
+		charge_uah[i] = (uint32_t)MIN(ledger.charge_ua_ms[i] / UA_MS_PER_UAH, UINT32_MAX);
+	}
+}
+
+void energy_ledger_reset(int64_t now_ms)
+{
+	memset(ledger.charge_ua_ms, 0, sizeof(ledger.charge_ua_ms));
+	ledger.last_update_ms = now_ms;
+}
+
+const char *energy_ledger_activity_name(enum energy_ledger_activity activity)
+{
+	if (activity >= ENERGY_LEDGER_COUNT) {
+		return "unknown";
+	}
+
+	return activity_names[activity];
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _ENERGY_LEDGER_H_
+#define _ENERGY_LEDGER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Activities that battery charge is attributed to, in order of priority. */
+enum energy_ledger_activity {
+	/* FOTA download */
+	ENERGY_LEDGER_FOTA,
+
+	/* Location search with GNSS, Wi-Fi or cellular */
+	ENERGY_LEDGER_LOCATION,
+
+	/* Modem sleep, PSM or eDRX */
+	ENERGY_LEDGER_SLEEP,
+
+	/* Modem awake while connected to cloud */
+	ENERGY_LEDGER_CLOUD,
+
+	/* Modem awake while not connected to cloud, for example network search */
+	ENERGY_LEDGER_OTHER,
+
+	ENERGY_LEDGER_COUNT,
+};
+
+/**
+ * @brief Attribute the charge since the last update to the current activity.
+ *
+ * Must be called before an activity changes, so that the span before the change is
+ * attributed to the previous activity.
+ *
+ * @param[in] current Average battery current over the span in amperes, positive when
+ *		      discharging. Charging current is not counted.
+ * @param[in] now_ms Current uptime in milliseconds.
+ */
+void energy_ledger_update(float current, int64_t now_ms);
+
+/**
+ * @brief Set whether an activity is active.
+ *
+ * Charge is attributed to the active activity of highest priority, or to
+ * ENERGY_LEDGER_OTHER if none is active.
+ *
+ * @param[in] activity Activity, ENERGY_LEDGER_OTHER cannot be set.
+ * @param[in] active true if the activity is active.
+ */
+void energy_ledger_activity_set(enum energy_ledger_activity activity, bool active);
+
+/**
+ * @brief Check whether an activity is active.
+ *
+ * @param[in] activity Activity.
+ *
+ * @return true if the activity is active, false otherwise.
+ */
+bool energy_ledger_activity_is_active(enum energy_ledger_activity activity);
+
+/**
+ * @brief Get the activity that charge is currently attributed to.
+ *
+ * @return Activity.
+ */
+enum energy_ledger_activity energy_ledger_activity_get(void);
+
+/**
+ * @brief Get the charge attributed to each activity since the last reset.
+ *
+ * @param[out] charge_uah Charge in microampere-hours, indexed by enum energy_ledger_activity.
+ */
+void energy_ledger_get(uint32_t charge_uah[ENERGY_LEDGER_COUNT]);
+
+/**
+ * @brief Clear the attributed charge. The active activities are kept.
+ *
+ * @param[in] now_ms Current uptime in milliseconds, start of the next span.
+ */
+void energy_ledger_reset(int64_t now_ms);
+
+/**
+ * @brief Get the name of an activity.
+ *
+ * @param[in] activity Activity.
+ *
+ * @return Name of the activity.
+ */
+const char *energy_ledger_activity_name(enum energy_ledger_activity activity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ENERGY_LEDGER_H_ */
@@ -48,6 +48,7 @@ int fuel_gauge_state_save(void)
 {
 	int err;
 	size_t state_size = nrf_fuel_gauge_state_size;
+	uint32_t start = k_cycle_get_32();
 
 	if (state_size > sizeof(fuel_gauge_noinit.state)) {
 		LOG_ERR("Fuel gauge state size too large: %zu", state_size);
@@ -63,6 +64,9 @@ int fuel_gauge_state_save(void)
 	fuel_gauge_noinit.size = state_size;
 	fuel_gauge_noinit.magic = FUEL_GAUGE_MAGIC;
 
+	LOG_DBG("Fuel gauge state saved, %zu bytes in %u us", state_size,
+		k_cyc_to_us_floor32(k_cycle_get_32() - start));
+
 	return 0;
 }
 
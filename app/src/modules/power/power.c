@@ -11,6 +11,9 @@
 #include <zephyr/smf.h>
 #include <date_time.h>
 #include <zephyr/drivers/sensor/npm13xx_charger.h>
+#if defined(CONFIG_APP_POWER_CHARGER_EVENTS)
+#include <zephyr/drivers/mfd/npm13xx.h>
+#endif /* CONFIG_APP_POWER_CHARGER_EVENTS */
 #include <nrf_fuel_gauge.h>
 #include <math.h>
 #include <modem/nrf_modem_lib.h>
@@ -18,8 +21,23 @@
 
 #include "lp803448_model.h"
 #include "app_common.h"
+#include "state_stats.h"
+#include "zbus_stats.h"
+#include "handler_stats.h"
 #include "power.h"
 #include "fuel_gauge_state.h"
+#if defined(CONFIG_APP_FOTA)
+#include "fota.h"
+#endif /* CONFIG_APP_FOTA */
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+#include <net/nrf_cloud_defs.h>
+#include "energy_ledger.h"
+#include "location.h"
+#include "cloud.h"
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
+#if defined(CONFIG_APP_EXECUTOR)
+#include "executor.h"
+#endif /* CONFIG_APP_EXECUTOR */
 
 LOG_MODULE_REGISTER(power, CONFIG_APP_POWER_LOG_LEVEL);
 
@@ -36,6 +54,12 @@ LOG_MODULE_REGISTER(power, CONFIG_APP_POWER_LOG_LEVEL);
 				 NPM13XX_CHG_STATUS_CC_MASK | \
 				 NPM13XX_CHG_STATUS_CV_MASK)
 
+/* Idle current in amperes */
+#define IDLE_CURRENT ((float)CONFIG_APP_POWER_IDLE_CURRENT_NA / 1e9f)
+
+/* State of charge change in percentage points for the fuel gauge state to be saved again */
+#define STATE_SAVE_SOC_CHANGE ((float)CONFIG_APP_POWER_STATE_SAVE_SOC_CHANGE_TENTHS / 10.0f)
+
 /* Register subscriber */
 ZBUS_MSG_SUBSCRIBER_DEFINE(power);
 
@@ -48,6 +72,8 @@ ZBUS_CHAN_DEFINE(power_chan,
 		 ZBUS_MSG_INIT(0)
 );
 
+ZBUS_STATS_CHAN_DEFINE(power_chan);
+
 /* Private channel message types for internal state management. */
 enum priv_power_msg_type {
 	/** Modem has been initialized */
@@ -58,6 +84,10 @@ enum priv_power_msg_type {
 	POWER_PRIV_MODEM_SLEEP_EXIT,
 	/** Timer for sampling data has expired. */
 	POWER_PRIV_TIMER_EXPIRED,
+	/** The charger reported a VBUS or charge state change */
+	POWER_PRIV_CHARGER_EVENT,
+	/** Timer for reporting the energy ledger to cloud has expired */
+	POWER_PRIV_ENERGY_REPORT_TIMER_EXPIRED,
 };
 
 struct priv_power_msg {
@@ -79,7 +109,10 @@ ZBUS_CHAN_DEFINE(priv_power_chan,
  */
 #define CHANNEL_LIST(X)                                                                            \
 	X(power_chan, struct power_msg)                                                            \
-	X(priv_power_chan, struct priv_power_msg)
+	X(priv_power_chan, struct priv_power_msg)                                                  \
+	IF_ENABLED(CONFIG_APP_FOTA, (X(fota_chan, struct fota_msg)))                               \
+	IF_ENABLED(CONFIG_APP_POWER_ENERGY_LEDGER, (X(location_chan, struct location_msg)))        \
+	IF_ENABLED(CONFIG_APP_POWER_ENERGY_LEDGER, (X(cloud_chan, struct cloud_msg)))
 
 /* Calculate the maximum message size from the list of channels */
 #define MAX_MSG_SIZE MAX_MSG_SIZE_FROM_LIST(CHANNEL_LIST)
@@ -158,6 +191,20 @@ struct power_state_object {
 
 	/* Charging status */
 	bool charging;
+
+	/* VBUS status */
+	bool vbus_connected;
+
+	/* Battery percentage when the fuel gauge state was last saved */
+	float saved_percentage;
+
+	/* The fuel gauge state has been saved since boot */
+	bool state_saved;
+
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+	/* The energy report is sent when cloud is connected */
+	bool energy_report_pending;
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
 };
 
 /* Forward declarations of work function */
@@ -166,12 +213,19 @@ static void timer_sample_work_fn(struct k_work *work);
 /* Delayable work used to schedule triggers */
 K_WORK_DELAYABLE_DEFINE(timer_sample_work, timer_sample_work_fn);
 
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+static void timer_energy_report_work_fn(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(timer_energy_report_work, timer_energy_report_work_fn);
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
+
 /* Forward declarations of state handlers */
 static enum smf_state_result state_waiting_for_modem_init_run(void *obj);
 static void state_running_entry(void *obj);
 static enum smf_state_result state_running_run(void *obj);
 static void state_idle_entry(void *obj);
 static enum smf_state_result state_idle_run(void *obj);
+static void state_idle_exit(void *obj);
 static void state_active_entry(void *obj);
 static enum smf_state_result state_active_run(void *obj);
 static void state_active_exit(void *obj);
@@ -193,7 +247,7 @@ static const struct smf_state states[] = {
 	[STATE_IDLE] =
 		SMF_CREATE_STATE(state_idle_entry,
 				 state_idle_run,
-				 NULL,
+				 state_idle_exit,
 				 &states[STATE_RUNNING],
 				 NULL),
 	[STATE_ACTIVE] =
@@ -204,18 +258,31 @@ static const struct smf_state states[] = {
 				 NULL),
 };
 
-static void power_wdt_callback(int channel_id, void *user_data)
+STATE_STATS_DEFINE(power, states);
+HANDLER_STATS_DEFINE(power, CONFIG_APP_POWER_MSG_PROCESSING_TIMEOUT_SECONDS);
+HANDLER_STATS_METRIC_DEFINE(power);
+
+static void timer_sample_work_fn(struct k_work *work)
 {
-	LOG_ERR("Watchdog expired, Channel: %d, Thread: %s", channel_id,
-		k_thread_name_get((k_tid_t)user_data));
+	int err;
+	const struct priv_power_msg msg = {.type = POWER_PRIV_TIMER_EXPIRED};
 
-	SEND_FATAL_ERROR_WATCHDOG_TIMEOUT();
+	ARG_UNUSED(work);
+
+	err = zbus_chan_pub(&priv_power_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish, error: %d", err);
+		SEND_FATAL_ERROR();
+
+		return;
+	}
 }
 
-static void timer_sample_work_fn(struct k_work *work)
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+static void timer_energy_report_work_fn(struct k_work *work)
 {
 	int err;
-	const struct priv_power_msg msg = {.type = POWER_PRIV_TIMER_EXPIRED};
+	const struct priv_power_msg msg = {.type = POWER_PRIV_ENERGY_REPORT_TIMER_EXPIRED};
 
 	ARG_UNUSED(work);
 
@@ -227,6 +294,7 @@ static void timer_sample_work_fn(struct k_work *work)
 		return;
 	}
 }
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
 
 static void timer_sample_start(uint32_t delay_ms)
 {
@@ -251,6 +319,37 @@ static void timer_sample_stop(void)
 	}
 }
 
+#if defined(CONFIG_APP_POWER_CHARGER_EVENTS)
+static void charger_event_handler(const struct device *dev, struct gpio_callback *cb,
+				  uint32_t events)
+{
+	int err;
+	const struct priv_power_msg msg = {.type = POWER_PRIV_CHARGER_EVENT};
+
+	ARG_UNUSED(dev);
+	ARG_UNUSED(cb);
+
+	LOG_DBG("Charger event: 0x%x", events);
+
+	err = zbus_chan_pub(&priv_power_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+static int charger_events_init(const struct device *pmic)
+{
+	static struct gpio_callback event_cb;
+
+	gpio_init_callback(&event_cb, charger_event_handler,
+			   BIT(NPM13XX_EVENT_VBUS_DETECTED) | BIT(NPM13XX_EVENT_VBUS_REMOVED) |
+			   BIT(NPM13XX_EVENT_CHG_COMPLETED) | BIT(NPM13XX_EVENT_CHG_ERROR));
+
+	return mfd_npm13xx_add_callback(pmic, &event_cb);
+}
+#endif /* CONFIG_APP_POWER_CHARGER_EVENTS */
+
 static void send_battery_percentage_sample_response(const struct power_state_object *state_object)
 {
 	int err;
@@ -376,6 +475,28 @@ static void power_update_charge_state_if_changed(int32_t chg_status, int32_t *pr
 					      &ext_data);
 }
 
+/* Save the fuel gauge state to no-init RAM when the state of charge has changed. The state
+ * is also saved before a FOTA reboot, see state_running_run().
+ */
+static void fuel_gauge_state_update(struct power_state_object *state_object)
+{
+	int err;
+	float change = fabsf(state_object->percentage - state_object->saved_percentage);
+
+	if (state_object->state_saved && (change < STATE_SAVE_SOC_CHANGE)) {
+		return;
+	}
+
+	err = fuel_gauge_state_save();
+	if (err) {
+		LOG_WRN("Failed to save fuel gauge state: %d", err);
+		return;
+	}
+
+	state_object->saved_percentage = state_object->percentage;
+	state_object->state_saved = true;
+}
+
 static int sample_and_process(struct power_state_object *state_object)
 {
 	int err;
@@ -393,6 +514,7 @@ static int sample_and_process(struct power_state_object *state_object)
 	}
 
 	state_object->charging = power_is_charging(chg_status);
+	state_object->vbus_connected = vbus_connected;
 
 	/* Inform fuel gauge of VBUS state */
 	(void)nrf_fuel_gauge_ext_state_update(
@@ -414,15 +536,221 @@ static int sample_and_process(struct power_state_object *state_object)
 		return err;
 	}
 
-	err = fuel_gauge_state_save();
+	fuel_gauge_state_update(state_object);
+
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+	energy_ledger_span_end(state_object);
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
+
+	return 0;
+}
+
+/* While the modem sleeps, the current is flat and the fuel gauge extrapolates the state of
+ * charge from the idle current, so samples are only needed at a long interval. While VBUS is
+ * connected the current depends on the charger, and the battery is sampled as often as when
+ * the modem is active.
+ */
+static bool idle_current_varies(const struct power_state_object *state_object)
+{
+	/* The current depends on the charger while VBUS is connected */
+	if (state_object->vbus_connected) {
+		return true;
+	}
+
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+	/* GNSS can run while the modem sleeps */
+	return energy_ledger_activity_is_active(ENERGY_LEDGER_LOCATION);
+#else
+	return false;
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
+}
+
+static void idle_timer_start(const struct power_state_object *state_object)
+{
+	if (idle_current_varies(state_object)) {
+		timer_sample_start(CONFIG_APP_POWER_SAMPLE_INTERVAL_MS);
+	} else if (CONFIG_APP_POWER_IDLE_SAMPLE_INTERVAL_SECONDS > 0) {
+		timer_sample_start(CONFIG_APP_POWER_IDLE_SAMPLE_INTERVAL_SECONDS * MSEC_PER_SEC);
+	} else {
+		timer_sample_stop();
+	}
+}
+
+static void idle_set(const struct power_state_object *state_object)
+{
+	if (idle_current_varies(state_object)) {
+		return;
+	}
+
+	nrf_fuel_gauge_idle_set(state_object->voltage, state_object->temperature, IDLE_CURRENT);
+}
+
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+#define ENERGY_REPORT_INTERVAL K_SECONDS(CONFIG_APP_POWER_ENERGY_LEDGER_REPORT_INTERVAL_SECONDS)
+
+#define ENERGY_REPORT_TEMPLATE									\
+	"{\"" NRF_CLOUD_JSON_MSG_TYPE_KEY "\":\"" NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA "\","	\
+	"\"" NRF_CLOUD_JSON_APPID_KEY "\":\"ENERGY\","						\
+	"\"" NRF_CLOUD_JSON_DATA_KEY "\":\"fota=%u,loc=%u,slp=%u,cld=%u,oth=%u\"}"
+
+/* Attribute the charge since the last update to the current activity. While the modem sleeps
+ * and the current is flat, the fuel gauge is not sampled and the idle current is used.
+ */
+static void energy_ledger_span_end(const struct power_state_object *state_object)
+{
+	float current = state_object->current;
+
+	if (energy_ledger_activity_is_active(ENERGY_LEDGER_SLEEP) &&
+	    !idle_current_varies(state_object)) {
+		current = IDLE_CURRENT;
+	}
+
+	energy_ledger_update(current, k_uptime_get());
+}
+
+static void energy_activity_set(const struct power_state_object *state_object,
+				enum energy_ledger_activity activity, bool active)
+{
+	if (energy_ledger_activity_is_active(activity) == active) {
+		return;
+	}
+
+	energy_ledger_span_end(state_object);
+	energy_ledger_activity_set(activity, active);
+}
+
+static void energy_report_send(struct power_state_object *state_object)
+{
+	int err;
+	int ret;
+	uint32_t charge[ENERGY_LEDGER_COUNT];
+	struct cloud_msg msg = {
+		.type = CLOUD_PAYLOAD_JSON,
+	};
+
+	state_object->energy_report_pending = false;
+
+	energy_ledger_span_end(state_object);
+	energy_ledger_get(charge);
+
+	ret = snprintk(msg.payload.buffer, sizeof(msg.payload.buffer), ENERGY_REPORT_TEMPLATE,
+		       charge[ENERGY_LEDGER_FOTA], charge[ENERGY_LEDGER_LOCATION],
+		       charge[ENERGY_LEDGER_SLEEP], charge[ENERGY_LEDGER_CLOUD],
+		       charge[ENERGY_LEDGER_OTHER]);
+	if ((ret < 0) || (ret >= sizeof(msg.payload.buffer))) {
+		LOG_WRN("Energy report does not fit in the payload buffer");
+		return;
+	}
+
+	msg.payload.buffer_data_len = ret;
+
+	err = zbus_chan_pub(&cloud_chan, &msg, PUB_TIMEOUT);
 	if (err) {
-		LOG_WRN("Failed to save fuel gauge state: %d", err);
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+		return;
 	}
 
-	timer_sample_start(CONFIG_APP_POWER_SAMPLE_INTERVAL_MS);
+	/* Each report covers the charge since the previous one */
+	energy_ledger_reset(k_uptime_get());
+}
 
-	return 0;
+/* Track the activities of other modules from their messages.
+ * Returns true if the message was handled.
+ */
+static bool energy_activity_handle(struct power_state_object *state_object)
+{
+	if (state_object->chan == &location_chan) {
+		const struct location_msg *msg = (const struct location_msg *)state_object->msg_buf;
+
+		if ((msg->type != LOCATION_SEARCH_STARTED) && (msg->type != LOCATION_SEARCH_DONE)) {
+			return false;
+		}
+
+		energy_activity_set(state_object, ENERGY_LEDGER_LOCATION,
+				    msg->type == LOCATION_SEARCH_STARTED);
+
+		/* Sample while a search runs during modem sleep, and go back to idle after it */
+		if (energy_ledger_activity_is_active(ENERGY_LEDGER_SLEEP)) {
+			idle_set(state_object);
+			idle_timer_start(state_object);
+		}
+
+		return true;
+	}
+
+	if (state_object->chan == &cloud_chan) {
+		const struct cloud_msg *msg = (const struct cloud_msg *)state_object->msg_buf;
+
+		if ((msg->type != CLOUD_CONNECTED) && (msg->type != CLOUD_DISCONNECTED)) {
+			return false;
+		}
+
+		energy_activity_set(state_object, ENERGY_LEDGER_CLOUD,
+				    msg->type == CLOUD_CONNECTED);
+
+		if ((msg->type == CLOUD_CONNECTED) && state_object->energy_report_pending) {
+			energy_report_send(state_object);
+		}
+
+		return true;
+	}
+
+#if defined(CONFIG_APP_FOTA)
+	if (state_object->chan == &fota_chan) {
+		const struct fota_msg *msg = (const struct fota_msg *)state_object->msg_buf;
+
+		if (msg->type == FOTA_STARTING) {
+			energy_activity_set(state_object, ENERGY_LEDGER_FOTA, true);
+		} else if ((msg->type == FOTA_ABORTED) ||
+			   (msg->type == FOTA_DOWNLOAD_INTERRUPTED) ||
+			   (msg->type == FOTA_REQUEST_REBOOT)) {
+			energy_activity_set(state_object, ENERGY_LEDGER_FOTA, false);
+		}
+
+		/* Also handled in state_running_run() */
+		return false;
+	}
+#endif /* CONFIG_APP_FOTA */
+
+	if (state_object->chan == &priv_power_chan) {
+		const struct priv_power_msg *msg =
+			(const struct priv_power_msg *)state_object->msg_buf;
+
+		if (msg->type != POWER_PRIV_ENERGY_REPORT_TIMER_EXPIRED) {
+			return false;
+		}
+
+		if (energy_ledger_activity_is_active(ENERGY_LEDGER_CLOUD)) {
+			energy_report_send(state_object);
+		} else {
+			state_object->energy_report_pending = true;
+		}
+
+		(void)k_work_reschedule(&timer_energy_report_work, ENERGY_REPORT_INTERVAL);
+
+		return true;
+	}
+
+	return false;
+}
+
+#if defined(CONFIG_APP_POWER_SHELL)
+static void log_energy_ledger(const struct power_state_object *state_object)
+{
+	uint32_t charge[ENERGY_LEDGER_COUNT];
+
+	energy_ledger_span_end(state_object);
+	energy_ledger_get(charge);
+
+	LOG_INF("Charge since the last energy report:");
+
+	for (size_t i = 0; i < ENERGY_LEDGER_COUNT; i++) {
+		LOG_INF("%s: %u uAh", energy_ledger_activity_name(i), charge[i]);
+	}
 }
+#endif /* CONFIG_APP_POWER_SHELL */
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
 
 static void lte_lc_evt_handler(const struct lte_lc_evt *const evt)
 {
@@ -485,6 +813,14 @@ static void state_running_entry(void *obj)
 
 	lte_lc_register_handler(lte_lc_evt_handler);
 
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+	energy_ledger_reset(k_uptime_get());
+
+	if (CONFIG_APP_POWER_ENERGY_LEDGER_REPORT_INTERVAL_SECONDS > 0) {
+		(void)k_work_reschedule(&timer_energy_report_work, ENERGY_REPORT_INTERVAL);
+	}
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
+
 	err = zbus_chan_pub(&power_chan, &msg, PUB_TIMEOUT);
 	if (err) {
 		LOG_ERR("zbus_chan_pub, error: %d", err);
@@ -495,7 +831,13 @@ static void state_running_entry(void *obj)
 
 static enum smf_state_result state_running_run(void *obj)
 {
-	const struct power_state_object *state_object = obj;
+	struct power_state_object *state_object = obj;
+
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+	if (energy_activity_handle(state_object)) {
+		return SMF_EVENT_HANDLED;
+	}
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
 
 	/* Handle sample requests at top level */
 	if (state_object->chan == &power_chan) {
@@ -511,9 +853,32 @@ static enum smf_state_result state_running_run(void *obj)
 			log_battery_sample(state_object);
 			return SMF_EVENT_HANDLED;
 		}
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+		if (power_msg->type == POWER_ENERGY_LOG) {
+			log_energy_ledger(state_object);
+			return SMF_EVENT_HANDLED;
+		}
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
 #endif /* CONFIG_APP_POWER_SHELL */
 	}
 
+#if defined(CONFIG_APP_FOTA)
+	if (state_object->chan == &fota_chan) {
+		const struct fota_msg *fota_msg = (const struct fota_msg *)state_object->msg_buf;
+
+		/* Keep the latest fuel gauge state across the reboot into the new image */
+		if (fota_msg->type == FOTA_REQUEST_REBOOT) {
+			int err = fuel_gauge_state_save();
+
+			if (err) {
+				LOG_WRN("Failed to save fuel gauge state: %d", err);
+			}
+		}
+
+		return SMF_EVENT_HANDLED;
+	}
+#endif /* CONFIG_APP_FOTA */
+
 	return SMF_EVENT_PROPAGATE;
 }
 
@@ -521,20 +886,33 @@ static void state_idle_entry(void *obj)
 {
 	const struct power_state_object *state_object = obj;
 
-	float idle_current = ((float)CONFIG_APP_POWER_IDLE_CURRENT_NA / 1e9f);
-
 	LOG_DBG("%s", __func__);
 
-	nrf_fuel_gauge_idle_set(state_object->voltage, state_object->temperature, idle_current);
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+	energy_activity_set(state_object, ENERGY_LEDGER_SLEEP, true);
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
+
+	idle_set(state_object);
+	idle_timer_start(state_object);
 }
 
 static enum smf_state_result state_idle_run(void *obj)
 {
-	const struct power_state_object *state_object = obj;
+	struct power_state_object *state_object = obj;
 
 	if (state_object->chan == &priv_power_chan) {
 		const struct priv_power_msg *msg =
 			(const struct priv_power_msg *)state_object->msg_buf;
+
+		if ((msg->type == POWER_PRIV_TIMER_EXPIRED) ||
+		    (msg->type == POWER_PRIV_CHARGER_EVENT)) {
+			sample_and_process(state_object);
+			idle_set(state_object);
+			idle_timer_start(state_object);
+
+			return SMF_EVENT_HANDLED;
+		}
+
 		if (msg->type == POWER_PRIV_MODEM_SLEEP_EXIT) {
 			smf_set_state(SMF_CTX(state_object), &states[STATE_ACTIVE]);
 
@@ -549,6 +927,21 @@ static enum smf_state_result state_idle_run(void *obj)
 	return SMF_EVENT_PROPAGATE;
 }
 
+static void state_idle_exit(void *obj)
+{
+	const struct power_state_object *state_object = obj;
+
+	LOG_DBG("%s", __func__);
+
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+	energy_activity_set(state_object, ENERGY_LEDGER_SLEEP, false);
+#else
+	ARG_UNUSED(state_object);
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
+
+	timer_sample_stop();
+}
+
 static void state_active_entry(void *obj)
 {
 	ARG_UNUSED(obj);
@@ -567,8 +960,10 @@ static enum smf_state_result state_active_run(void *obj)
 		const struct priv_power_msg *msg =
 			(const struct priv_power_msg *)state_object->msg_buf;
 
-		if (msg->type == POWER_PRIV_TIMER_EXPIRED) {
+		if ((msg->type == POWER_PRIV_TIMER_EXPIRED) ||
+		    (msg->type == POWER_PRIV_CHARGER_EVENT)) {
 			sample_and_process(state_object);
+			timer_sample_start(CONFIG_APP_POWER_SAMPLE_INTERVAL_MS);
 			return SMF_EVENT_HANDLED;
 		}
 
@@ -595,41 +990,36 @@ static void state_active_exit(void *obj)
 	timer_sample_stop();
 }
 
-static void power_module_thread(void)
+static struct power_state_object power_state = {
+	.charger = DEVICE_DT_GET(DT_NODELABEL(npm1300_charger)),
+};
+
+static int power_module_init(void)
 {
 	int err;
-	int task_wdt_id;
-	const uint32_t wdt_timeout_ms = (CONFIG_APP_POWER_WATCHDOG_TIMEOUT_SECONDS * MSEC_PER_SEC);
-	const uint32_t execution_time_ms =
-		(CONFIG_APP_POWER_MSG_PROCESSING_TIMEOUT_SECONDS * MSEC_PER_SEC);
-	const k_timeout_t zbus_wait_ms = K_MSEC(wdt_timeout_ms - execution_time_ms);
-	static struct power_state_object power_state = {
-		.charger = DEVICE_DT_GET(DT_NODELABEL(npm1300_charger)),
-	};
 	int32_t chg_status;
 	struct nrf_fuel_gauge_init_parameters parameters = {.model = &battery_model};
 
-	LOG_DBG("Power module task started");
-
-	task_wdt_id = task_wdt_add(wdt_timeout_ms, power_wdt_callback, (void *)k_current_get());
-	if (task_wdt_id < 0) {
-		LOG_ERR("Failed to add task to watchdog: %d", task_wdt_id);
-		SEND_FATAL_ERROR();
-		return;
-	}
-
 	if (!device_is_ready(power_state.charger)) {
 		LOG_ERR("Charger device not ready");
 		SEND_FATAL_ERROR();
-		return;
+		return -ENODEV;
 	}
 
+#if defined(CONFIG_APP_POWER_CHARGER_EVENTS)
+	/* Without charger events, VBUS and charge state changes are seen at the next sample */
+	err = charger_events_init(DEVICE_DT_GET(DT_PARENT(DT_NODELABEL(npm1300_charger))));
+	if (err) {
+		LOG_WRN("charger_events_init, error: %d", err);
+	}
+#endif /* CONFIG_APP_POWER_CHARGER_EVENTS */
+
 	err = charger_read_sensors(power_state.charger, &parameters.v0, &parameters.i0,
 				   &parameters.t0, &chg_status, NULL);
 	if (err) {
 		LOG_ERR("charger_read_sensors, error: %d", err);
 		SEND_FATAL_ERROR();
-		return;
+		return err;
 	}
 
 	parameters.state = fuel_gauge_state_get();
@@ -644,7 +1034,7 @@ static void power_module_thread(void)
 	if (err) {
 		LOG_ERR("nrf_fuel_gauge_init, error: %d", err);
 		SEND_FATAL_ERROR();
-		return;
+		return err;
 	}
 
 	/* Seed the initial SoC */
@@ -661,7 +1051,7 @@ static void power_module_thread(void)
 	if (err) {
 		LOG_ERR("nrf_fuel_gauge_process, error: %d", err);
 		SEND_FATAL_ERROR();
-		return;
+		return err;
 	}
 
 	/* Set charge current limit and termination current for accurate TTF prediction */
@@ -689,6 +1079,45 @@ static void power_module_thread(void)
 
 	/* Initialize the state machine */
 	smf_set_initial(SMF_CTX(&power_state), &states[STATE_WAITING_FOR_MODEM_INIT]);
+	STATE_STATS_UPDATE(power, SMF_CTX(&power_state));
+
+	return 0;
+}
+
+#if defined(CONFIG_APP_EXECUTOR)
+EXECUTOR_MODULE_DEFINE(power, power, power_state, power_module_init,
+		       CONFIG_APP_POWER_EXECUTOR_PRIORITY);
+#else
+static void power_wdt_callback(int channel_id, void *user_data)
+{
+	LOG_ERR("Watchdog expired, Channel: %d, Thread: %s", channel_id,
+		k_thread_name_get((k_tid_t)user_data));
+
+	SEND_FATAL_ERROR_WATCHDOG_TIMEOUT();
+}
+
+static void power_module_thread(void)
+{
+	int err;
+	int task_wdt_id;
+	const uint32_t wdt_timeout_ms = (CONFIG_APP_POWER_WATCHDOG_TIMEOUT_SECONDS * MSEC_PER_SEC);
+	const uint32_t execution_time_ms =
+		(CONFIG_APP_POWER_MSG_PROCESSING_TIMEOUT_SECONDS * MSEC_PER_SEC);
+	const k_timeout_t zbus_wait_ms = K_MSEC(wdt_timeout_ms - execution_time_ms);
+
+	LOG_DBG("Power module task started");
+
+	task_wdt_id = task_wdt_add(wdt_timeout_ms, power_wdt_callback, (void *)k_current_get());
+	if (task_wdt_id < 0) {
+		LOG_ERR("Failed to add task to watchdog: %d", task_wdt_id);
+		SEND_FATAL_ERROR();
+		return;
+	}
+
+	err = power_module_init();
+	if (err) {
+		return;
+	}
 
 	while (true) {
 		err = task_wdt_feed(task_wdt_id);
@@ -708,14 +1137,21 @@ static void power_module_thread(void)
 			return;
 		}
 
+		zbus_stats_received(&power, power_state.chan);
+
+		HANDLER_STATS_START(power, power_state.chan);
 		err = smf_run_state(SMF_CTX(&power_state));
+		HANDLER_STATS_END(power);
 		if (err) {
 			LOG_ERR("smf_run_state(), error: %d", err);
 			SEND_FATAL_ERROR();
 			return;
 		}
+
+		STATE_STATS_UPDATE(power, SMF_CTX(&power_state));
 	}
 }
 
 K_THREAD_DEFINE(power_module_thread_id, CONFIG_APP_POWER_THREAD_STACK_SIZE, power_module_thread,
 		NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+#endif /* CONFIG_APP_EXECUTOR */
@@ -38,6 +38,11 @@ enum power_msg_type {
 #if defined(CONFIG_APP_POWER_SHELL)
 	/* Request to log the latest sampled battery data to the console. */
 	POWER_BATTERY_SAMPLE_LOG,
+
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+	/* Request to log the charge attributed to each activity to the console. */
+	POWER_ENERGY_LOG,
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
 #endif /* CONFIG_APP_POWER_SHELL */
 };
 
@@ -28,12 +28,38 @@ static int cmd_power_sample(const struct shell *shell, size_t argc, char **argv)
 	return 0;
 }
 
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+static int cmd_power_energy(const struct shell *shell, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	int err;
+	struct power_msg msg = {
+		.type = POWER_ENERGY_LOG,
+	};
+	err = zbus_chan_pub(&power_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		shell_error(shell, "Failed to publish energy log message, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+
+	return 0;
+}
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
+
 SHELL_STATIC_SUBCMD_SET_CREATE(
 	sub_cmds,
 	SHELL_CMD(sample,
 		  NULL,
 		  "Get latest sampled battery data (state of charge, voltage, charging state)",
 		  cmd_power_sample),
+#if defined(CONFIG_APP_POWER_ENERGY_LEDGER)
+	SHELL_CMD(energy,
+		  NULL,
+		  "Get the charge attributed to each activity since the last energy report",
+		  cmd_power_energy),
+#endif /* CONFIG_APP_POWER_ENERGY_LEDGER */
 	SHELL_SUBCMD_SET_END);
 
 SHELL_CMD_REGISTER(att_power,
@@ -9,9 +9,14 @@
 #include <zephyr/logging/log.h>
 #include <errno.h>
 #include <math.h>
+#include <string.h>
 #include <zephyr/fs/fs.h>
 #include <zephyr/fs/littlefs.h>
 #include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK)
+#include <zephyr/sys/crc.h>
+#endif /* CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK */
 
 #include "storage.h"
 #include "storage_backend.h"
@@ -19,9 +24,69 @@
 
 #define MAX_PATH_LEN     CONFIG_APP_STORAGE_LITTLEFS_MAX_PATH_LEN
 #define RECORDS_PER_TYPE CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE
+#define TIME_INDEX_SIZE  CONFIG_APP_STORAGE_LITTLEFS_TIME_INDEX_BLOCKS
+#define FRAME_SIZE       CONFIG_APP_STORAGE_LITTLEFS_FRAME_SIZE
 
 LOG_MODULE_REGISTER(lfs_backend, CONFIG_APP_STORAGE_LOG_LEVEL);
 
+struct storage_file_header {
+	uint32_t read_offset;
+	uint32_t write_offset;
+
+	/* Size of one slot in the data files, see get_slot_layout(). Records written with a
+	 * different layout, for example before CONFIG_APP_STORAGE_LITTLEFS_COMPACT_RECORDS was
+	 * toggled, are discarded.
+	 */
+	uint32_t slot_size;
+};
+
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK)
+#define SUPERBLOCK_MAGIC	0x41545342
+#define SUPERBLOCK_COPIES	2
+
+/* Offsets of one data type in the superblock */
+struct superblock_entry {
+	/* CRC32 of the type name, so that an entry is not used for another type when the set
+	 * of enabled data types changes
+	 */
+	uint32_t name_crc;
+	struct storage_file_header header;
+};
+
+/*
+ * The superblock file holds SUPERBLOCK_COPIES copies of this structure, which are written in
+ * turn. A write that is interrupted by a reset only damages the copy being written, and the
+ * valid copy with the highest sequence number is used at boot.
+ */
+struct superblock {
+	uint32_t magic;
+	uint32_t sequence;
+	struct superblock_entry entries[CONFIG_APP_STORAGE_MAX_TYPES];
+
+	/* CRC32 of all fields above */
+	uint32_t crc;
+};
+
+/* How the offsets of a type loaded from the superblock are validated on first use */
+enum header_validation {
+	/* Validated, or nothing to validate */
+	HEADER_CHECKED,
+
+	/* The superblock entry is valid, records stored after it was written are recovered */
+	HEADER_RECOVER,
+
+	/* No valid superblock entry, the offsets are rebuilt from the data files */
+	HEADER_REBUILD,
+};
+#endif /* CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK */
+
+/* Entry of the sparse time index, describing the first slot of one data file */
+struct time_index_entry {
+	int64_t timestamp;
+	uint32_t seq;
+	bool valid;
+};
+
 /*
  * Per-type state keeping the header file permanently open.
  *
@@ -32,24 +97,90 @@ LOG_MODULE_REGISTER(lfs_backend, CONFIG_APP_STORAGE_LOG_LEVEL);
  * By opening each header file once at init and leaving it open, the replay
  * is paid only once at boot. Subsequent reads/writes use fs_seek + fs_read/
  * fs_write + fs_sync on the already-open handle, which are O(1).
+ *
+ * The header itself is cached in RAM. Stores and retrieves only update the cached copy and
+ * mark it dirty; the header file is written when the storage module calls the sync operation.
+ * Records stored after the last sync are found again at boot through their sequence numbers,
+ * see recover_records().
+ *
+ * The data file handles are described in data_file_get().
  */
 struct lfs_type_state {
 	struct fs_file_t header_file;
 	bool header_open;
+	struct storage_file_header header;
+	bool header_dirty;
+
+	/* Index of the data file open in each handle, -1 when closed */
+	struct fs_file_t write_file;
+	int write_file_index;
+	struct fs_file_t read_file;
+	int read_file_index;
+
+	/* Records written through the write handle since it was last synced */
+	uint32_t unsynced_writes;
+
+	/* Sparse time index with the first record of each data file, see lfs_storage_find() */
+	struct time_index_entry time_index[TIME_INDEX_SIZE];
+
+#if FRAME_SIZE > 0
+	/* Frame that is being filled, holding the records from frame_start on */
+	uint8_t frame[FRAME_SIZE];
+	uint32_t frame_start;
+
+	/* Slots of the frame that hold records, 0 when no frame is being filled */
+	uint32_t frame_records;
+
+	/* The frame holds records that are not written to the data file */
+	bool frame_dirty;
+#endif /* FRAME_SIZE > 0 */
+
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK)
+	/* Validation left to do before the type is first used, see header_check() */
+	enum header_validation check;
+#endif /* CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK */
 };
 
 static struct lfs_type_state type_state[CONFIG_APP_STORAGE_MAX_TYPES];
 
-/* Block size cached from fs_statvfs() during init. The value is a hardware property of the flash
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK)
+/* With CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK, the offsets of all types are kept in one file
+ * instead of a header file per type. It is opened once at init and left open, like the header
+ * files.
+ */
+static struct fs_file_t superblock_file;
+static bool superblock_open;
+
+/* Sequence number of the superblock copy that was written last */
+static uint32_t superblock_sequence;
+
+static int header_check(const struct storage_data *type, int idx);
+#endif /* CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK */
+
+/* Block size cached during init, see verify_partition_size(). The value is a hardware property of the flash
  * and is therefore constant, so caching it avoids repeated fs_statvfs() calls and calculations
  * in the hot path.
  */
 static size_t cached_block_size;
 
-struct storage_file_header {
-	uint32_t read_offset;
-	uint32_t write_offset;
-};
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_COMPACT_RECORDS)
+#define MAX_RECORD_SIZE STORAGE_MAX_RECORD_SIZE
+#else
+#define MAX_RECORD_SIZE STORAGE_MAX_DATA_SIZE
+#endif /* CONFIG_APP_STORAGE_LITTLEFS_COMPACT_RECORDS */
+
+/* Each slot in the data files starts with the sequence number of its record, which is the
+ * write_offset the record was stored at, followed by the record itself.
+ */
+#define RECORD_SEQ_SIZE	sizeof(uint32_t)
+#define MAX_SLOT_SIZE	(RECORD_SEQ_SIZE + MAX_RECORD_SIZE)
+
+/* With CONFIG_APP_STORAGE_LITTLEFS_FRAME_SIZE, slots are grouped into frames of FRAME_SIZE
+ * bytes, and a frame only holds whole slots followed by padding. Each frame is collected in RAM
+ * and written at once, see frame_append().
+ */
+BUILD_ASSERT((FRAME_SIZE == 0) || (FRAME_SIZE >= MAX_SLOT_SIZE),
+	     "CONFIG_APP_STORAGE_LITTLEFS_FRAME_SIZE must hold the largest record slot");
 
 #define LFS_NODE DT_NODELABEL(lfs1)
 
@@ -77,6 +208,59 @@ static struct fs_mount_t *mountpoint =
 #endif
 	;
 
+/*
+ * @brief Get the size of one on-flash record of a storage data type
+ *
+ * @param type Storage data type
+ * @return size_t Record size in bytes
+ */
+static size_t get_record_size(const struct storage_data *type)
+{
+	if (IS_ENABLED(CONFIG_APP_STORAGE_LITTLEFS_COMPACT_RECORDS)) {
+		return type->record_size;
+	}
+
+	return type->data_size;
+}
+
+/*
+ * @brief Get the size of one slot in the data files of a storage data type
+ *
+ * @param type Storage data type
+ * @return size_t Slot size in bytes, sequence number included
+ */
+static size_t get_slot_size(const struct storage_data *type)
+{
+	return RECORD_SEQ_SIZE + get_record_size(type);
+}
+
+/*
+ * @brief Get the slot layout of a storage data type, as stored in its header
+ *
+ * The slot size, with the frame size in the upper 16 bits. Without frames, this equals the
+ * slot size, so that records stored before frames were available are kept.
+ *
+ * @param type Storage data type
+ * @return uint32_t Slot layout
+ */
+static uint32_t get_slot_layout(const struct storage_data *type)
+{
+	return (uint32_t)get_slot_size(type) | ((uint32_t)FRAME_SIZE << 16);
+}
+
+#if FRAME_SIZE > 0
+/*
+ * @brief Get the number of slots in one frame
+ *
+ * @param type Storage data type
+ * @return size_t Number of slots
+ */
+static size_t get_records_per_frame(const struct storage_data *type)
+{
+	return FRAME_SIZE / get_slot_size(type);
+}
+#endif /* FRAME_SIZE > 0 */
+
 /*
  * @brief Mount LittleFS filesystem
  *
@@ -125,6 +309,17 @@ static void verify_partition_size(void)
 {
 	struct fs_statvfs stat;
 	int necessary_blocks = 0;
+
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK)
+	/* fs_statvfs() traverses the whole filesystem to count the free blocks, which takes
+	 * longer the more is stored. Only the geometry is needed here, which LittleFS keeps in
+	 * its configuration once mounted.
+	 */
+	const struct fs_littlefs *fs = mountpoint->fs_data;
+
+	stat.f_frsize = fs->cfg.block_size;
+	stat.f_blocks = fs->cfg.block_count;
+#else
 	int ret;
 
 	ret = fs_statvfs(mountpoint->mnt_point, &stat);
@@ -133,6 +328,7 @@ static void verify_partition_size(void)
 		__ASSERT_NO_MSG(false);
 		return;
 	}
+#endif /* CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK */
 
 	LOG_DBG("Filesystem stats for %s: block size = %lu ; total blocks = %lu",
 		mountpoint->mnt_point, stat.f_frsize, stat.f_blocks);
@@ -141,7 +337,12 @@ static void verify_partition_size(void)
 
 	STRUCT_SECTION_FOREACH(storage_data, type) {
 
-		size_t max_file_size = type->data_size * RECORDS_PER_TYPE;
+#if FRAME_SIZE > 0
+		size_t max_file_size = DIV_ROUND_UP(RECORDS_PER_TYPE, get_records_per_frame(type)) *
+				       FRAME_SIZE;
+#else
+		size_t max_file_size = get_slot_size(type) * RECORDS_PER_TYPE;
+#endif /* FRAME_SIZE > 0 */
 		size_t block_size = stat.f_frsize;
 
 		necessary_blocks += (int)ceil((double)max_file_size / block_size);
@@ -228,7 +429,7 @@ static int get_type_index(const struct storage_data *type, int *idx_out)
 /*
  * @brief Read storage file header
  *
- * Reads the storage file header for the given storage data type.
+ * Returns the cached storage file header for the given storage data type.
  *
  * @param type Storage data type
  * @param header Output header structure
@@ -246,37 +447,30 @@ static int read_storage_file_header(const struct storage_data *type,
 		return ret;
 	}
 
-	__ASSERT(type_state[idx].header_open,
-		 "Header file not open for type %s", type->name);
-
-	ret = fs_seek(&type_state[idx].header_file, 0, FS_SEEK_SET);
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK)
+	ret = header_check(type, idx);
 	if (ret < 0) {
-		LOG_ERR("Failed to seek header file for %s: %d", type->name, ret);
-
 		return ret;
 	}
+#endif /* CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK */
 
-	ret = (int)fs_read(&type_state[idx].header_file, header, sizeof(*header));
-	if (ret < 0) {
-		LOG_ERR("Failed to read header file for %s: %d", type->name, ret);
-
-		return ret;
-	}
+	*header = type_state[idx].header;
 
 	return 0;
 }
 
 /*
- * @brief Write storage file header
+ * @brief Update storage file header
  *
- * Writes the storage file header for the given storage data type.
+ * Updates the cached storage file header for the given storage data type and marks it dirty.
+ * The header file is written by sync_storage_file_header().
  *
  * @param type Storage data type
  * @param header Header structure to write
  * @return int 0 on success, negative errno on failure
  */
-static int write_storage_file_header(const struct storage_data *type,
-				     const struct storage_file_header *header)
+static int update_storage_file_header(const struct storage_data *type,
+				      const struct storage_file_header *header)
 {
 	int idx;
 	int ret;
@@ -287,6 +481,24 @@ static int write_storage_file_header(const struct storage_data *type,
 		return ret;
 	}
 
+	type_state[idx].header = *header;
+	type_state[idx].header_dirty = true;
+
+	return 0;
+}
+
+#if !defined(CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK)
+/*
+ * @brief Write the cached storage file header to flash
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ * @return int 0 on success, negative errno on failure
+ */
+static int sync_storage_file_header(const struct storage_data *type, int idx)
+{
+	int ret;
+
 	__ASSERT(type_state[idx].header_open,
 		 "Header file not open for type %s", type->name);
 
@@ -297,7 +509,8 @@ static int write_storage_file_header(const struct storage_data *type,
 		return ret;
 	}
 
-	ret = (int)fs_write(&type_state[idx].header_file, header, sizeof(*header));
+	ret = (int)fs_write(&type_state[idx].header_file, &type_state[idx].header,
+			    sizeof(type_state[idx].header));
 	if (ret < 0) {
 		LOG_ERR("Failed to write header file for %s: %d", type->name, ret);
 
@@ -311,8 +524,14 @@ static int write_storage_file_header(const struct storage_data *type,
 		return ret;
 	}
 
+	type_state[idx].header_dirty = false;
+
+	LOG_DBG("Synced header of %s (read_offset=%u, write_offset=%u)", type->name,
+		type_state[idx].header.read_offset, type_state[idx].header.write_offset);
+
 	return 0;
 }
+#endif /* !CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK */
 
 /*
  * @brief Get the entries per block object
@@ -329,46 +548,1205 @@ static int get_entries_per_block(const struct storage_data *type, size_t *entrie
 	__ASSERT(cached_block_size > 0,
 		 "Block size not yet cached; verify_partition_size() must run first");
 
-	*entries_per_block = cached_block_size / type->data_size;
-	if (*entries_per_block == 0) {
-		LOG_ERR("Data size %zu exceeds block size %zu",
-			type->data_size, cached_block_size);
+#if FRAME_SIZE > 0
+	*entries_per_block = (cached_block_size / FRAME_SIZE) * get_records_per_frame(type);
+#else
+	*entries_per_block = cached_block_size / get_slot_size(type);
+#endif /* FRAME_SIZE > 0 */
+	if (*entries_per_block == 0) {
+		LOG_ERR("Slot size %zu or frame size %d exceeds block size %zu",
+			get_slot_size(type), FRAME_SIZE, cached_block_size);
+
+		return -EFBIG;
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Get the file index for a given entry index
+ *
+ * @param entries_per_block Number of entries per block
+ * @param index Entry index
+ * @return int File index
+ */
+static int get_file_index(size_t entries_per_block, uint32_t index)
+{
+	return index / entries_per_block;
+}
+
+/*
+ * @brief Get the offset index within a block for a given entry index
+ *
+ * @param entries_per_block Number of entries per block
+ * @param index Entry index
+ * @return int Offset index within the block
+ */
+static int get_entry_offset_index(size_t entries_per_block, uint32_t index)
+{
+	return index % entries_per_block;
+}
+
+/*
+ * @brief Get the data file and position of the slot holding a record
+ *
+ * @param type Storage data type
+ * @param offset Absolute record offset, as used in the storage file header
+ * @param file_index Output index of the data file
+ * @param pos Output position of the slot within the data file
+ * @return int 0 on success, negative errno on failure
+ */
+static int get_slot_location(const struct storage_data *type, uint32_t offset,
+			     int *file_index, size_t *pos)
+{
+	size_t entries_per_block;
+	int wrapped_index;
+	int slot_index;
+	int ret;
+
+	ret = get_entries_per_block(type, &entries_per_block);
+	if (ret < 0) {
+		return ret;
+	}
+
+	wrapped_index = offset % RECORDS_PER_TYPE;
+	*file_index = get_file_index(entries_per_block, wrapped_index);
+	slot_index = get_entry_offset_index(entries_per_block, wrapped_index);
+
+#if FRAME_SIZE > 0
+	/* Frames are padded after their last slot */
+	*pos = ((slot_index / get_records_per_frame(type)) * FRAME_SIZE) +
+	       ((slot_index % get_records_per_frame(type)) * get_slot_size(type));
+#else
+	*pos = slot_index * get_slot_size(type);
+#endif /* FRAME_SIZE > 0 */
+
+	return 0;
+}
+
+/*
+ * @brief Close a data file handle if it is open
+ *
+ * @param file File handle
+ * @param file_index Index of the open data file, set to -1
+ * @return int 0 on success, negative errno on failure
+ */
+static int data_file_close(struct fs_file_t *file, int *file_index)
+{
+	int ret;
+
+	if (*file_index < 0) {
+		return 0;
+	}
+
+	*file_index = -1;
+
+	ret = fs_close(file);
+	if (ret < 0) {
+		LOG_ERR("Failed to close data file: %d", ret);
+
+		return ret;
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Get an open handle to a data file
+ *
+ * Each type has one handle for writing and one for reading. With
+ * CONFIG_APP_STORAGE_LITTLEFS_KEEP_FILES_OPEN the handles stay open between calls, so that
+ * consecutive records in the same file do not pay for a directory lookup and a metadata
+ * commit each. Otherwise data_file_put() closes them after every operation.
+ *
+ * The write handle is also used for reads from the file it has open, as LittleFS does not
+ * make unsynced writes visible to other handles of the same file.
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ * @param file_index Index of the data file
+ * @param write True to open the file for writing, creating it if needed
+ * @param file Output file handle
+ * @return int 0 on success, -ENOENT if a file opened for reading does not exist, other
+ *	       negative errno on failure
+ */
+static int data_file_get(const struct storage_data *type, int idx, int file_index, bool write,
+			 struct fs_file_t **file)
+{
+	struct lfs_type_state *state = &type_state[idx];
+	char file_path[MAX_PATH_LEN];
+	int ret;
+
+	if (state->write_file_index == file_index) {
+		*file = &state->write_file;
+
+		return 0;
+	}
+
+	if (!write && (state->read_file_index == file_index)) {
+		*file = &state->read_file;
+
+		return 0;
+	}
+
+	ret = create_storage_file_path(type, file_index, file_path);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!write) {
+		ret = data_file_close(&state->read_file, &state->read_file_index);
+		if (ret < 0) {
+			return ret;
+		}
+
+		fs_file_t_init(&state->read_file);
+
+		ret = fs_open(&state->read_file, file_path, FS_O_READ);
+		if (ret < 0) {
+			return ret;
+		}
+
+		state->read_file_index = file_index;
+		*file = &state->read_file;
+
+		return 0;
+	}
+
+	/* Closing the previous write file commits its data */
+	ret = data_file_close(&state->write_file, &state->write_file_index);
+	if (ret < 0) {
+		return ret;
+	}
+
+	state->unsynced_writes = 0;
+
+	/* A read handle of the same file would not see the new writes */
+	if (state->read_file_index == file_index) {
+		ret = data_file_close(&state->read_file, &state->read_file_index);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	fs_file_t_init(&state->write_file);
+
+	ret = fs_open(&state->write_file, file_path, FS_O_RDWR | FS_O_CREATE);
+	if (ret < 0) {
+		LOG_ERR("Failed to open %s: %d", file_path, ret);
+
+		return ret;
+	}
+
+	state->write_file_index = file_index;
+	*file = &state->write_file;
+
+	return 0;
+}
+
+/*
+ * @brief Release the data file handles of a type after an operation
+ *
+ * Closes the handles unless CONFIG_APP_STORAGE_LITTLEFS_KEEP_FILES_OPEN is enabled.
+ *
+ * @param idx Index of the type in type_state[]
+ * @return int 0 on success, negative errno on failure
+ */
+static int data_file_put(int idx)
+{
+	int ret;
+
+	if (IS_ENABLED(CONFIG_APP_STORAGE_LITTLEFS_KEEP_FILES_OPEN)) {
+		return 0;
+	}
+
+	ret = data_file_close(&type_state[idx].read_file, &type_state[idx].read_file_index);
+	if (ret < 0) {
+		data_file_close(&type_state[idx].write_file, &type_state[idx].write_file_index);
+
+		return ret;
+	}
+
+	return data_file_close(&type_state[idx].write_file, &type_state[idx].write_file_index);
+}
+
+#if FRAME_SIZE > 0
+static int frame_flush(const struct storage_data *type, int idx);
+#endif /* FRAME_SIZE > 0 */
+
+/*
+ * @brief Commit records written through a kept-open write handle
+ *
+ * With frames, the frame that is being filled is written first.
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ * @return int 0 on success, negative errno on failure
+ */
+static int data_file_sync(const struct storage_data *type, int idx)
+{
+	int ret;
+
+#if FRAME_SIZE > 0
+	ret = frame_flush(type, idx);
+	if (ret < 0) {
+		return ret;
+	}
+#endif /* FRAME_SIZE > 0 */
+
+	if ((type_state[idx].write_file_index < 0) || (type_state[idx].unsynced_writes == 0)) {
+		return 0;
+	}
+
+	ret = fs_sync(&type_state[idx].write_file);
+	if (ret < 0) {
+		LOG_ERR("Failed to sync data file of %s: %d", type->name, ret);
+
+		return ret;
+	}
+
+	type_state[idx].unsynced_writes = 0;
+
+	return 0;
+}
+
+/*
+ * @brief Write slots to the data file holding a record
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ * @param offset Absolute offset of the first record that is written
+ * @param buf Slot, or frame, to write
+ * @param len Number of bytes to write
+ * @return int 0 on success, negative errno on failure
+ */
+static int data_write(const struct storage_data *type, int idx, uint32_t offset,
+		      const uint8_t *buf, size_t len)
+{
+	struct fs_file_t *file;
+	size_t write_pos;
+	int file_index;
+	int ret;
+
+	ret = get_slot_location(type, offset, &file_index, &write_pos);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* Open storage file */
+	ret = data_file_get(type, idx, file_index, true, &file);
+	if (ret < 0) {
+		return ret;
+	}
+
+	LOG_DBG("Writing %zu bytes of %s data in file %d at offset %zu", len, type->name,
+		file_index, write_pos);
+
+	/* Move to write position with wrap-around. Within a file, records are appended, so this
+	 * is a no-op while the file is kept open.
+	 */
+	ret = fs_seek(file, write_pos, FS_SEEK_SET);
+	if (ret < 0) {
+		LOG_ERR("Failed to move to write position: %d", ret);
+		data_file_put(idx);
+
+		return ret;
+	}
+
+	ret = (int)fs_write(file, buf, len);
+	if (ret < 0) {
+		LOG_ERR("Failed to write data: %d", ret);
+		data_file_put(idx);
+
+		return ret;
+	}
+
+	type_state[idx].unsynced_writes++;
+
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_KEEP_FILES_OPEN)
+	if ((CONFIG_APP_STORAGE_LITTLEFS_SYNC_RECORDS > 0) &&
+	    (type_state[idx].unsynced_writes >= CONFIG_APP_STORAGE_LITTLEFS_SYNC_RECORDS)) {
+		ret = data_file_sync(type, idx);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+#endif /* CONFIG_APP_STORAGE_LITTLEFS_KEEP_FILES_OPEN */
+
+	ret = data_file_put(idx);
+	if (ret < 0) {
+		LOG_ERR("Failed to close file after writing: %d", ret);
+
+		return ret;
+	}
+
+	return 0;
+}
+
+#if FRAME_SIZE > 0
+/*
+ * @brief Write the frame that is being filled to its data file
+ *
+ * The whole frame is written, padding included, so that writes start and end on frame
+ * boundaries. A frame that is not full stays in RAM, and is written again once it is.
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ * @return int 0 on success, negative errno on failure
+ */
+static int frame_flush(const struct storage_data *type, int idx)
+{
+	struct lfs_type_state *state = &type_state[idx];
+	int ret;
+
+	if (!state->frame_dirty) {
+		return 0;
+	}
+
+	/* Cleared first, as data_write() may sync the data file, which flushes the frame */
+	state->frame_dirty = false;
+
+	ret = data_write(type, idx, state->frame_start, state->frame, FRAME_SIZE);
+	if (ret < 0) {
+		state->frame_dirty = true;
+
+		return ret;
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Load a frame that was partly written before, for example before a reset
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ * @param frame_start Absolute offset of the first record of the frame
+ */
+static void frame_load(const struct storage_data *type, int idx, uint32_t frame_start)
+{
+	struct lfs_type_state *state = &type_state[idx];
+	struct fs_file_t *file;
+	size_t read_pos;
+	int file_index;
+
+	memset(state->frame, 0, sizeof(state->frame));
+
+	if ((get_slot_location(type, frame_start, &file_index, &read_pos) < 0) ||
+	    (data_file_get(type, idx, file_index, false, &file) < 0)) {
+		return;
+	}
+
+	if (fs_seek(file, read_pos, FS_SEEK_SET) == 0) {
+		(void)fs_read(file, state->frame, sizeof(state->frame));
+	}
+
+	(void)data_file_put(idx);
+}
+
+/*
+ * @brief Add a slot to the frame that is being filled
+ *
+ * The frame is written once it is full, or once it holds the last slot of the ring, as the
+ * next record starts over at the first frame. Until then, the records in the frame are read
+ * from RAM, see read_slot().
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ * @param offset Absolute offset of the record
+ * @param slot Slot to add
+ * @return int 0 on success, negative errno on failure
+ */
+static int frame_append(const struct storage_data *type, int idx, uint32_t offset,
+			const uint8_t *slot)
+{
+	struct lfs_type_state *state = &type_state[idx];
+	size_t slot_size = get_slot_size(type);
+	uint32_t slot_index = (offset % RECORDS_PER_TYPE) % get_records_per_frame(type);
+	int ret;
+
+	if (state->frame_records == 0) {
+		if (slot_index > 0) {
+			frame_load(type, idx, offset - slot_index);
+		} else {
+			memset(state->frame, 0, sizeof(state->frame));
+		}
+
+		state->frame_start = offset - slot_index;
+	}
+
+	__ASSERT(state->frame_start == (offset - slot_index),
+		 "Record %u of %s is not in the frame being filled", offset, type->name);
+
+	memcpy(&state->frame[slot_index * slot_size], slot, slot_size);
+	state->frame_records = slot_index + 1;
+	state->frame_dirty = true;
+
+	if ((state->frame_records < get_records_per_frame(type)) &&
+	    (((offset + 1) % RECORDS_PER_TYPE) != 0)) {
+		return 0;
+	}
+
+	ret = frame_flush(type, idx);
+	if (ret < 0) {
+		return ret;
+	}
+
+	state->frame_records = 0;
+
+	return 0;
+}
+#endif /* FRAME_SIZE > 0 */
+
+/*
+ * @brief Read the slot holding a record
+ *
+ * @param type Storage data type
+ * @param offset Absolute record offset, as used in the storage file header
+ * @param slot Output buffer of at least get_slot_size(type) bytes
+ * @return int 0 on success, -ENOENT if the data file does not exist, -ENODATA if the slot
+ *	       has not been written, other negative errno on failure
+ */
+static int read_slot(const struct storage_data *type, uint32_t offset, uint8_t *slot)
+{
+	struct fs_file_t *file;
+	size_t slot_size = get_slot_size(type);
+	size_t read_pos;
+	int file_index;
+	int read_bytes;
+	int idx;
+	int ret;
+
+	ret = get_type_index(type, &idx);
+	if (ret < 0) {
+		return ret;
+	}
+
+#if FRAME_SIZE > 0
+	/* Records in the frame that is being filled are only in RAM */
+	if ((offset - type_state[idx].frame_start) < type_state[idx].frame_records) {
+		memcpy(slot, &type_state[idx].frame[(offset - type_state[idx].frame_start) *
+						    slot_size], slot_size);
+
+		return 0;
+	}
+#endif /* FRAME_SIZE > 0 */
+
+	ret = get_slot_location(type, offset, &file_index, &read_pos);
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = data_file_get(type, idx, file_index, false, &file);
+	if (ret < 0) {
+		return ret;
+	}
+
+	LOG_DBG("Reading %s slot in file %d at offset %zu", type->name, file_index, read_pos);
+
+	ret = fs_seek(file, read_pos, FS_SEEK_SET);
+	if (ret < 0) {
+		LOG_ERR("Failed to move to read position: %d", ret);
+		data_file_put(idx);
+
+		return ret;
+	}
+
+	read_bytes = fs_read(file, slot, slot_size);
+	if (read_bytes < 0) {
+		LOG_ERR("Failed to read data: %d", read_bytes);
+		data_file_put(idx);
+
+		return read_bytes;
+	}
+
+	ret = data_file_put(idx);
+	if (ret < 0) {
+		LOG_ERR("Failed to close file after reading: %d", ret);
+
+		return ret;
+	}
+
+	if (read_bytes != (int)slot_size) {
+		return -ENODATA;
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Delete all data files of a storage data type
+ *
+ * @param type Storage data type
+ * @return int 0 on success, negative errno on failure
+ */
+static int delete_data_files(const struct storage_data *type)
+{
+	char file_path[MAX_PATH_LEN];
+	size_t entries_per_block;
+	int file_count;
+	int idx;
+	int ret;
+
+	ret = get_entries_per_block(type, &entries_per_block);
+	if (ret < 0) {
+		return ret;
+	}
+
+	file_count = DIV_ROUND_UP(RECORDS_PER_TYPE, entries_per_block);
+
+	ret = get_type_index(type, &idx);
+	if (ret < 0) {
+		return ret;
+	}
+
+	type_state[idx].unsynced_writes = 0;
+
+#if FRAME_SIZE > 0
+	type_state[idx].frame_records = 0;
+	type_state[idx].frame_dirty = false;
+#endif /* FRAME_SIZE > 0 */
+
+	(void)data_file_close(&type_state[idx].write_file, &type_state[idx].write_file_index);
+	(void)data_file_close(&type_state[idx].read_file, &type_state[idx].read_file_index);
+
+	for (int i = 0; i < file_count; i++) {
+		ret = create_storage_file_path(type, i, file_path);
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = fs_unlink(file_path);
+		if (ret < 0 && ret != -ENOENT) {
+			LOG_ERR("Failed to delete file %s: %d", file_path, ret);
+
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Recover records stored after the last header sync
+ *
+ * The header on flash may lag behind the data files after an unexpected reset. Starting at
+ * the stored write_offset, every slot whose sequence number matches the expected offset holds
+ * a record that was written after the last sync, so write_offset is advanced past it.
+ * Records that were consumed after the last sync cannot be told apart from unconsumed ones and
+ * are delivered again.
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ */
+static void recover_records(const struct storage_data *type, int idx)
+{
+	struct storage_file_header *header = &type_state[idx].header;
+	uint8_t slot[MAX_SLOT_SIZE];
+	uint32_t recovered = 0;
+
+	while (recovered < RECORDS_PER_TYPE) {
+		if (read_slot(type, header->write_offset, slot) != 0) {
+			break;
+		}
+
+		if (sys_get_le32(slot) != header->write_offset) {
+			break;
+		}
+
+		header->write_offset++;
+		recovered++;
+	}
+
+	if (recovered == 0) {
+		return;
+	}
+
+	if ((header->write_offset - header->read_offset) > RECORDS_PER_TYPE) {
+		header->read_offset = header->write_offset - RECORDS_PER_TYPE;
+	}
+
+	type_state[idx].header_dirty = true;
+
+	LOG_WRN("Recovered %u %s records stored after the last header sync",
+		recovered, type->name);
+}
+
+/*
+ * @brief Read the timestamp of a stored record
+ *
+ * @param type Storage data type
+ * @param offset Absolute record offset, as used in the storage file header
+ * @param timestamp Output timestamp of the record
+ * @return int 0 on success, -ENODATA if the slot does not hold the record at @p offset,
+ *	       other negative errno on failure
+ */
+static int read_record_timestamp(const struct storage_data *type, uint32_t offset,
+				 int64_t *timestamp)
+{
+	static uint8_t data[STORAGE_MAX_DATA_SIZE];
+	uint8_t slot[MAX_SLOT_SIZE];
+	int ret;
+
+	ret = read_slot(type, offset, slot);
+	if (ret == -ENOENT) {
+		return -ENODATA;
+	} else if (ret < 0) {
+		return ret;
+	}
+
+	if (sys_get_le32(slot) != offset) {
+		return -ENODATA;
+	}
+
+	if (IS_ENABLED(CONFIG_APP_STORAGE_LITTLEFS_COMPACT_RECORDS)) {
+		type->decode_record(&slot[RECORD_SEQ_SIZE], data);
+	} else {
+		memcpy(data, &slot[RECORD_SEQ_SIZE], type->data_size);
+	}
+
+	*timestamp = type->get_timestamp(data);
+
+	return 0;
+}
+
+/*
+ * @brief Update the time index after a record was stored
+ *
+ * Only records stored in the first slot of a data file are indexed.
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ * @param offset Absolute offset the record was stored at
+ * @param data Stored data
+ */
+static void time_index_update(const struct storage_data *type, int idx, uint32_t offset,
+			      const void *data)
+{
+	size_t entries_per_block;
+	uint32_t wrapped_index = offset % RECORDS_PER_TYPE;
+	int file_index;
+
+	if (get_entries_per_block(type, &entries_per_block) < 0) {
+		return;
+	}
+
+	if (get_entry_offset_index(entries_per_block, wrapped_index) != 0) {
+		return;
+	}
+
+	file_index = get_file_index(entries_per_block, wrapped_index);
+	if (file_index >= TIME_INDEX_SIZE) {
+		return;
+	}
+
+	type_state[idx].time_index[file_index] = (struct time_index_entry) {
+		.timestamp = type->get_timestamp(data),
+		.seq = offset,
+		.valid = true,
+	};
+}
+
+/*
+ * @brief Build the time index from the data files
+ *
+ * Reads the first slot of every data file, which is one read per file.
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ */
+static void time_index_build(const struct storage_data *type, int idx)
+{
+	const struct storage_file_header *header = &type_state[idx].header;
+	size_t entries_per_block;
+	int file_count;
+
+	memset(type_state[idx].time_index, 0, sizeof(type_state[idx].time_index));
+
+	if ((header->write_offset == 0) || (get_entries_per_block(type, &entries_per_block) < 0)) {
+		return;
+	}
+
+	file_count = DIV_ROUND_UP(RECORDS_PER_TYPE, entries_per_block);
+	if (file_count > TIME_INDEX_SIZE) {
+		LOG_WRN("%s uses %d data files, only the first %d are indexed by time",
+			type->name, file_count, TIME_INDEX_SIZE);
+
+		file_count = TIME_INDEX_SIZE;
+	}
+
+	for (int i = 0; i < file_count; i++) {
+		uint32_t first_slot = i * entries_per_block;
+		uint32_t last = header->write_offset - 1;
+		uint32_t offset;
+		int64_t timestamp;
+
+		if (last < first_slot) {
+			break;
+		}
+
+		/* Most recent record stored in the first slot of the file */
+		offset = last - ((last - first_slot) % RECORDS_PER_TYPE);
+
+		if (read_record_timestamp(type, offset, &timestamp) == 0) {
+			type_state[idx].time_index[i] = (struct time_index_entry) {
+				.timestamp = timestamp,
+				.seq = offset,
+				.valid = true,
+			};
+		}
+	}
+}
+
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK)
+/*
+ * @brief Get the CRC32 of the name of a storage data type
+ *
+ * @param type Storage data type
+ * @return uint32_t CRC32 of the type name
+ */
+static uint32_t type_name_crc(const struct storage_data *type)
+{
+	return crc32_ieee((const uint8_t *)type->name, strlen(type->name));
+}
+
+/*
+ * @brief Write the cached offsets of all types to the superblock
+ *
+ * Writes the copy that was not written last, so that the previous copy stays valid until the
+ * new one is complete.
+ *
+ * @return int 0 on success, negative errno on failure
+ */
+static int superblock_write(void)
+{
+	struct superblock sb = {
+		.magic = SUPERBLOCK_MAGIC,
+		.sequence = superblock_sequence + 1,
+	};
+	int idx = 0;
+	int ret;
+
+	__ASSERT(superblock_open, "Superblock file not open");
+
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		/* A type that is not rebuilt yet has no valid offsets to write */
+		if (type_state[idx].check != HEADER_REBUILD) {
+			sb.entries[idx].name_crc = type_name_crc(type);
+			sb.entries[idx].header = type_state[idx].header;
+		}
+
+		idx++;
+	}
+
+	sb.crc = crc32_ieee((const uint8_t *)&sb, offsetof(struct superblock, crc));
+
+	ret = fs_seek(&superblock_file, (sb.sequence % SUPERBLOCK_COPIES) * sizeof(sb),
+		      FS_SEEK_SET);
+	if (ret < 0) {
+		LOG_ERR("Failed to seek superblock: %d", ret);
+
+		return ret;
+	}
+
+	ret = (int)fs_write(&superblock_file, &sb, sizeof(sb));
+	if (ret < 0) {
+		LOG_ERR("Failed to write superblock: %d", ret);
+
+		return ret;
+	}
+
+	ret = fs_sync(&superblock_file);
+	if (ret < 0) {
+		LOG_ERR("Failed to sync superblock: %d", ret);
+
+		return ret;
+	}
+
+	superblock_sequence = sb.sequence;
+
+	for (int i = 0; i < idx; i++) {
+		type_state[i].header_dirty = false;
+	}
+
+	LOG_DBG("Wrote superblock %u", sb.sequence);
+
+	return 0;
+}
+
+/*
+ * @brief Commit unsynced records of all types, then write the superblock if needed
+ *
+ * Records are committed before the superblock that refers to them, so that the superblock
+ * never points past the records on flash.
+ *
+ * @return int 0 on success, negative errno on failure
+ */
+static int superblock_sync(void)
+{
+	bool dirty = false;
+	int idx = 0;
+	int err = 0;
+
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		int ret = data_file_sync(type, idx);
+
+		if (ret < 0 && err == 0) {
+			err = ret;
+		}
+
+		dirty |= type_state[idx].header_dirty;
+		idx++;
+	}
+
+	if (err == 0 && dirty) {
+		err = superblock_write();
+	}
+
+	return err;
+}
+
+/*
+ * @brief Load the newest valid superblock copy
+ *
+ * @param sb Output superblock
+ * @return int 0 on success, -ENODATA if no copy is valid, other negative errno on failure
+ */
+static int superblock_load(struct superblock *sb)
+{
+	struct superblock copy;
+	bool found = false;
+
+	for (int i = 0; i < SUPERBLOCK_COPIES; i++) {
+		int read_bytes;
+		int ret;
+
+		ret = fs_seek(&superblock_file, i * sizeof(copy), FS_SEEK_SET);
+		if (ret < 0) {
+			LOG_ERR("Failed to seek superblock: %d", ret);
+
+			return ret;
+		}
+
+		read_bytes = (int)fs_read(&superblock_file, &copy, sizeof(copy));
+		if (read_bytes < 0) {
+			LOG_ERR("Failed to read superblock: %d", read_bytes);
+
+			return read_bytes;
+		}
+
+		if ((read_bytes != (int)sizeof(copy)) || (copy.magic != SUPERBLOCK_MAGIC) ||
+		    (copy.crc != crc32_ieee((const uint8_t *)&copy,
+					    offsetof(struct superblock, crc)))) {
+			LOG_DBG("Superblock copy %d is not valid", i);
+
+			continue;
+		}
+
+		if (!found || ((int32_t)(copy.sequence - sb->sequence) > 0)) {
+			*sb = copy;
+			found = true;
+		}
+	}
+
+	return found ? 0 : -ENODATA;
+}
+
+/*
+ * @brief Migrate the header file of a type from before the superblock was enabled
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ * @return int 0 on success, -ENOENT if there is no usable header file, other negative errno
+ *	       on failure
+ */
+static int legacy_header_migrate(const struct storage_data *type, int idx)
+{
+	char header_file_path[MAX_PATH_LEN];
+	struct storage_file_header header;
+	struct fs_file_t file;
+	int read_bytes;
+	int ret;
+
+	ret = create_storage_header_file_path(type, header_file_path);
+	if (ret < 0) {
+		return ret;
+	}
+
+	fs_file_t_init(&file);
+
+	ret = fs_open(&file, header_file_path, FS_O_READ);
+	if (ret < 0) {
+		return ret;
+	}
+
+	read_bytes = (int)fs_read(&file, &header, sizeof(header));
+	(void)fs_close(&file);
+
+	if ((read_bytes != (int)sizeof(header)) || (header.slot_size != get_slot_layout(type))) {
+		return -ENOENT;
+	}
+
+	type_state[idx].header = header;
+	recover_records(type, idx);
+
+	LOG_INF("Migrated header file of %s to the superblock", type->name);
+
+	return 0;
+}
+
+/*
+ * @brief Rebuild the offsets of a type that has no valid superblock entry
+ *
+ * A header file left from before the superblock was enabled is migrated. Otherwise, the write
+ * offset is found from the sequence numbers of the stored records, which reads every slot
+ * once. Records that were consumed cannot be told apart from unconsumed ones and are
+ * delivered again.
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ * @return int 0 on success, negative errno on failure
+ */
+static int header_rebuild(const struct storage_data *type, int idx)
+{
+	struct storage_file_header *header = &type_state[idx].header;
+	uint8_t slot[MAX_SLOT_SIZE];
+	size_t entries_per_block;
+	uint32_t newest = 0;
+	uint32_t found = 0;
+	int ret;
+
+	ret = legacy_header_migrate(type, idx);
+	if (ret != -ENOENT) {
+		return ret;
+	}
+
+	ret = get_entries_per_block(type, &entries_per_block);
+	if (ret < 0) {
+		return ret;
+	}
+
+	for (uint32_t i = 0; i < RECORDS_PER_TYPE; i++) {
+		uint32_t seq;
+
+		ret = read_slot(type, i, slot);
+		if (ret == -ENOENT || ret == -ENODATA) {
+			/* The rest of the data file has not been written */
+			i = ROUND_UP(i + 1, entries_per_block) - 1;
+
+			continue;
+		} else if (ret < 0) {
+			return ret;
+		}
+
+		seq = sys_get_le32(slot);
+		if ((seq % RECORDS_PER_TYPE) != i) {
+			continue;
+		}
+
+		if ((found == 0) || ((int32_t)(seq - newest) > 0)) {
+			newest = seq;
+		}
+
+		found++;
+	}
+
+	if (found == 0) {
+		/* Remove data files without records, so that their contents are not mistaken
+		 * for records later
+		 */
+		return delete_data_files(type);
+	}
+
+	header->write_offset = newest + 1;
+	header->read_offset = header->write_offset - MIN(header->write_offset, RECORDS_PER_TYPE);
+
+	/* Skip slots at the start of the ring that hold older records, or none */
+	while (header->read_offset != header->write_offset) {
+		if ((read_slot(type, header->read_offset, slot) == 0) &&
+		    (sys_get_le32(slot) == header->read_offset)) {
+			break;
+		}
+
+		header->read_offset++;
+	}
+
+	LOG_WRN("Rebuilt offsets of %s from the data files (read_offset=%u, write_offset=%u)",
+		type->name, header->read_offset, header->write_offset);
+
+	return 0;
+}
+
+/*
+ * @brief Validate the offsets of a type loaded from the superblock
+ *
+ * Called before a type is first used after init, so that the time from reset to the backend
+ * being ready does not depend on the number of stored records. Offsets that changed are
+ * written to the superblock right away, so the work is not repeated after a reset.
+ *
+ * @param type Storage data type
+ * @param idx Index of the type in type_state[]
+ * @return int 0 on success, negative errno on failure
+ */
+static int header_check(const struct storage_data *type, int idx)
+{
+	enum header_validation check = type_state[idx].check;
+	char header_file_path[MAX_PATH_LEN];
+	int ret = 0;
+
+	switch (check) {
+	case HEADER_CHECKED:
+		return 0;
+	case HEADER_RECOVER:
+		recover_records(type, idx);
+		break;
+	case HEADER_REBUILD:
+		ret = header_rebuild(type, idx);
+		break;
+	}
+
+	if (ret < 0) {
+		LOG_ERR("Failed to validate offsets of %s: %d", type->name, ret);
+
+		return ret;
+	}
+
+	type_state[idx].check = HEADER_CHECKED;
+
+	time_index_build(type, idx);
+
+	if ((check == HEADER_RECOVER) && !type_state[idx].header_dirty) {
+		return 0;
+	}
+
+	type_state[idx].header_dirty = true;
+
+	ret = superblock_sync();
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* A migrated header file is only removed once the superblock holds its offsets */
+	if ((check == HEADER_REBUILD) &&
+	    (create_storage_header_file_path(type, header_file_path) >= 0)) {
+		(void)fs_unlink(header_file_path);
+	}
+
+	return 0;
+}
+
+/*
+ * @brief Initialize the cached headers of all storage data types from the superblock
+ *
+ * Only the superblock is read, the offsets of each type are validated by header_check() when
+ * the type is first used. Types without a valid entry in the superblock are rebuilt from their
+ * data files at that point.
+ *
+ * @return int 0 on success, negative errno on failure
+ */
+static int init_header_files(void)
+{
+	char superblock_path[MAX_PATH_LEN];
+	struct superblock sb;
+	bool loaded;
+	int idx = 0;
+	int ret;
+
+	ret = snprintk(superblock_path, sizeof(superblock_path), "%s/storage.sb",
+		       mountpoint->mnt_point);
+	if (ret < 0 || ret >= sizeof(superblock_path)) {
+		LOG_ERR("Failed to create superblock file path");
+
+		return -ENAMETOOLONG;
+	}
+
+	/* Close the file of an earlier init, so that the backend can be initialized again */
+	if (superblock_open) {
+		fs_close(&superblock_file);
+		superblock_open = false;
+	}
+
+	/* Open the superblock file and leave it open for the lifetime of the backend. */
+	fs_file_t_init(&superblock_file);
+
+	ret = fs_open(&superblock_file, superblock_path, FS_O_RDWR | FS_O_CREATE);
+	if (ret < 0) {
+		LOG_ERR("Failed to open superblock file %s: %d", superblock_path, ret);
+
+		return ret;
+	}
+
+	superblock_open = true;
+
+	ret = superblock_load(&sb);
+	if (ret < 0 && ret != -ENODATA) {
+		return ret;
+	}
+
+	loaded = (ret == 0);
+	superblock_sequence = loaded ? sb.sequence : 0;
+
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		const struct superblock_entry *entry = &sb.entries[idx];
+
+		/* Data files are opened on demand */
+		type_state[idx].write_file_index = -1;
+		type_state[idx].read_file_index = -1;
+		type_state[idx].unsynced_writes = 0;
+		type_state[idx].header_dirty = false;
+
+		memset(type_state[idx].time_index, 0, sizeof(type_state[idx].time_index));
+
+		type_state[idx].header = (struct storage_file_header) {
+			.read_offset = 0,
+			.write_offset = 0,
+			.slot_size = get_slot_layout(type),
+		};
+
+		if (!loaded || (entry->name_crc != type_name_crc(type))) {
+			type_state[idx].check = HEADER_REBUILD;
+		} else if (entry->header.slot_size != get_slot_layout(type)) {
+			/* Only happens once after the on-flash format changed, and deleting the
+			 * files does not read them
+			 */
+			LOG_WRN("Slot layout of %s changed from 0x%x to 0x%x, discarding stored "
+				"records", type->name, entry->header.slot_size, get_slot_layout(type));
+
+			ret = delete_data_files(type);
+			if (ret < 0) {
+				return ret;
+			}
 
-		return -EFBIG;
+			type_state[idx].check = HEADER_CHECKED;
+			type_state[idx].header_dirty = true;
+		} else {
+			type_state[idx].header = entry->header;
+			type_state[idx].check = HEADER_RECOVER;
+		}
+
+		idx++;
 	}
 
-	return 0;
-}
+	ret = superblock_sync();
+	if (ret < 0) {
+		return ret;
+	}
 
-/*
- * @brief Get the file index for a given entry index
- *
- * @param entries_per_block Number of entries per block
- * @param index Entry index
- * @return int File index
- */
-static int get_file_index(size_t entries_per_block, uint32_t index)
-{
-	return index / entries_per_block;
-}
+	if (loaded) {
+		LOG_INF("Loaded superblock %u", sb.sequence);
+	} else {
+		LOG_WRN("No valid superblock, offsets are rebuilt on first use");
+	}
 
-/*
- * @brief Get the offset index within a block for a given entry index
- *
- * @param entries_per_block Number of entries per block
- * @param index Entry index
- * @return int Offset index within the block
- */
-static int get_entry_offset_index(size_t entries_per_block, uint32_t index)
-{
-	return index % entries_per_block;
+	return 0;
 }
-
+#else
 /*
  * @brief Initialize header files for all storage data types
  *
  * Checks if header files exist for each registered storage data type,
- * and creates them with initial values if they do not.
+ * and creates them with initial values if they do not. Existing headers are
+ * loaded into the RAM cache and records stored after their last sync are recovered.
  *
  * @return int
  */
@@ -387,6 +1765,11 @@ static int init_header_files(void)
 			return ret;
 		}
 
+		/* Data files are opened on demand */
+		type_state[idx].write_file_index = -1;
+		type_state[idx].read_file_index = -1;
+		type_state[idx].unsynced_writes = 0;
+
 		/* Open the header file and leave it open for the lifetime of the backend. */
 		fs_file_t_init(&type_state[idx].header_file);
 
@@ -415,50 +1798,61 @@ static int init_header_files(void)
 			return read_bytes;
 		}
 
-		if (read_bytes < (int)sizeof(header)) {
-			/* New or empty file: write and sync a zero-initialised header. */
-			const struct storage_file_header zero_header = {
-				.read_offset = 0,
-				.write_offset = 0,
-			};
+		if ((read_bytes == (int)sizeof(header)) &&
+		    (header.slot_size != get_slot_layout(type))) {
+			LOG_WRN("Slot layout of %s changed from 0x%x to 0x%x, discarding stored "
+				"records", type->name, header.slot_size, get_slot_layout(type));
+		}
 
-			ret = fs_seek(&type_state[idx].header_file, 0, FS_SEEK_SET);
+		if ((read_bytes < (int)sizeof(header)) ||
+		    (header.slot_size != get_slot_layout(type))) {
+			/* New, empty or incompatible file: remove stale data files, so that their
+			 * sequence numbers are not mistaken for new records, and write and sync
+			 * a zero-initialised header.
+			 */
+			ret = delete_data_files(type);
 			if (ret < 0) {
-				LOG_ERR("Failed to seek header file %s: %d",
-					header_file_path, ret);
-
 				return ret;
 			}
 
-			ret = (int)fs_write(&type_state[idx].header_file,
-					    &zero_header, sizeof(zero_header));
-			if (ret < 0) {
-				LOG_ERR("Failed to write initial header to %s: %d",
-					header_file_path, ret);
-
-				return ret;
-			}
+			type_state[idx].header = (struct storage_file_header) {
+				.read_offset = 0,
+				.write_offset = 0,
+				.slot_size = get_slot_layout(type),
+			};
 
-			ret = fs_sync(&type_state[idx].header_file);
+			ret = sync_storage_file_header(type, idx);
 			if (ret < 0) {
-				LOG_ERR("Failed to sync header file %s: %d",
-					header_file_path, ret);
-
 				return ret;
 			}
 
 			LOG_DBG("Initialized header file %s", header_file_path);
 		} else {
+			type_state[idx].header = header;
+			type_state[idx].header_dirty = false;
+
+			recover_records(type, idx);
+
+			if (type_state[idx].header_dirty) {
+				ret = sync_storage_file_header(type, idx);
+				if (ret < 0) {
+					return ret;
+				}
+			}
+
 			LOG_DBG("Opened header file %s (read_offset=%u, write_offset=%u)",
-				header_file_path,
-				header.read_offset, header.write_offset);
+				header_file_path, type_state[idx].header.read_offset,
+				type_state[idx].header.write_offset);
 		}
 
+		time_index_build(type, idx);
+
 		idx++;
 	}
 
 	return 0;
 }
+#endif /* CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK */
 
 /*
  * @brief Initialize LittleFS storage backend
@@ -507,7 +1901,7 @@ static int lfs_storage_init(void)
 /*
  * @brief Store data in LittleFS storage backend
  *
- * Stores the given data for the specified storage data type, updating the storage
+ * Stores the given data for the specified storage data type, updating the cached storage
  * file header accordingly.
  *
  * @param type Storage data type
@@ -517,21 +1911,18 @@ static int lfs_storage_init(void)
  */
 static int lfs_storage_store(const struct storage_data *type, const void *data, size_t size)
 {
-	char file_path[MAX_PATH_LEN];
-	struct fs_file_t file;
 	struct storage_file_header header;
-	size_t write_pos;
-	size_t entries_per_block;
+	uint8_t slot[MAX_SLOT_SIZE];
+	size_t slot_size = get_slot_size(type);
 	int was_full;
-	int wrapped_index;
-	int file_index;
-	int entry_offset_index;
+	int idx;
 	int ret;
 
 	__ASSERT(type != NULL, "Storage type is NULL");
 	__ASSERT(data != NULL, "Data pointer is NULL");
 	__ASSERT(size == type->data_size, "Data size mismatch: expected %zu, got %zu",
 		 type->data_size, size);
+	__ASSERT_NO_MSG(slot_size <= sizeof(slot));
 
 	/* Read current header */
 	ret = read_storage_file_header(type, &header);
@@ -542,57 +1933,34 @@ static int lfs_storage_store(const struct storage_data *type, const void *data,
 		return ret;
 	}
 
-	ret = get_entries_per_block(type, &entries_per_block);
+	ret = get_type_index(type, &idx);
 	if (ret < 0) {
 		return ret;
 	}
 
-	wrapped_index = header.write_offset % RECORDS_PER_TYPE;
-	file_index = get_file_index(entries_per_block, wrapped_index);
-	entry_offset_index = get_entry_offset_index(entries_per_block, wrapped_index);
 	was_full = ((header.write_offset - header.read_offset) >= RECORDS_PER_TYPE);
-	write_pos = (entry_offset_index % RECORDS_PER_TYPE) * type->data_size;
-
-	/* Open storage file */
-	ret = create_storage_file_path(type, file_index, file_path);
-	if (ret < 0) {
-		return ret;
-	}
-
-	fs_file_t_init(&file);
 
-	ret = fs_open(&file, file_path, FS_O_WRITE | FS_O_CREATE);
-	if (ret < 0) {
-		LOG_ERR("Failed to open %s: %d", file_path, ret);
+	sys_put_le32(header.write_offset, slot);
 
-		return ret;
+	if (IS_ENABLED(CONFIG_APP_STORAGE_LITTLEFS_COMPACT_RECORDS)) {
+		type->encode_record(data, &slot[RECORD_SEQ_SIZE]);
+	} else {
+		memcpy(&slot[RECORD_SEQ_SIZE], data, type->data_size);
 	}
-	LOG_DBG("Storing data in file %s at offset %zu (write_offset=%u, read_offset=%u)",
-		file_path, write_pos, header.write_offset, header.read_offset);
 
-	/* Move to write position with wrap-around */
-	ret = fs_seek(&file, write_pos, FS_SEEK_SET);
-	if (ret < 0) {
-		LOG_ERR("Failed to move to write position: %d", ret);
-		fs_close(&file);
-
-		return ret;
-	}
+	LOG_DBG("Storing %s data (write_offset=%u, read_offset=%u)", type->name,
+		header.write_offset, header.read_offset);
 
-	ret = (int)fs_write(&file, data, size);
+#if FRAME_SIZE > 0
+	ret = frame_append(type, idx, header.write_offset, slot);
+#else
+	ret = data_write(type, idx, header.write_offset, slot, slot_size);
+#endif /* FRAME_SIZE > 0 */
 	if (ret < 0) {
-		LOG_ERR("Failed to write data: %d", ret);
-		fs_close(&file);
-
 		return ret;
 	}
 
-	ret = fs_close(&file);
-	if (ret < 0) {
-		LOG_ERR("Failed to close file after writing: %d", ret);
-
-		return ret;
-	}
+	time_index_update(type, idx, header.write_offset, data);
 
 	/* Update header */
 	header.write_offset += 1;
@@ -601,7 +1969,7 @@ static int lfs_storage_store(const struct storage_data *type, const void *data,
 		LOG_WRN("Storage full for type %s, overwriting oldest data", type->name);
 	}
 
-	ret = write_storage_file_header(type, &header);
+	ret = update_storage_file_header(type, &header);
 	if (ret < 0) {
 		LOG_ERR("Failed to update storage file header: %d", ret);
 
@@ -614,38 +1982,35 @@ static int lfs_storage_store(const struct storage_data *type, const void *data,
 /*
  * @brief Read data entry from LittleFS storage backend
  *
- * Internal helper that reads the next data entry for the specified storage data type.
+ * Internal helper that reads a data entry for the specified storage data type.
  * Optionally updates the read offset if update_offset is true.
  *
  * @param type Storage data type
+ * @param index Position of the entry, counted from the oldest entry (0). Must be 0 when
+ *		update_offset is true, as only the oldest entry can be removed.
  * @param data Pointer to buffer to store read data
  * @param size Size of buffer
  * @param update_offset If true, increment read_offset after successful read
  * @return int Number of bytes read on success, negative errno on failure
  */
-static int read_data_entry(const struct storage_data *type, void *data, size_t size,
-			   bool update_offset)
+static int read_data_entry(const struct storage_data *type, size_t index, void *data,
+			   size_t size, bool update_offset)
 {
-	char file_path[MAX_PATH_LEN];
-	struct fs_file_t file;
 	struct storage_file_header header;
-	uint8_t temp_buffer[STORAGE_MAX_DATA_SIZE];
-	size_t read_pos;
-	size_t entries_per_block;
-	int read_bytes;
-	int wrapped_index;
-	int file_index;
-	int entry_offset_index;
+	uint8_t slot[MAX_SLOT_SIZE];
+	uint32_t offset;
+	uint32_t seq;
 	int ret;
 
 	__ASSERT(type != NULL, "Storage type is NULL");
+	__ASSERT(!update_offset || index == 0, "Only the oldest entry can be retrieved");
 
 	/* If data is not null, size must be at least type->data_size */
 	__ASSERT(data != NULL ? size >= type->data_size : true,
 		 "Data size mismatch: expected at least %zu, got %zu", type->data_size, size);
-	__ASSERT(type->data_size <= STORAGE_MAX_DATA_SIZE,
-		 "Type data size %zu exceeds max supported %d", type->data_size,
-		 STORAGE_MAX_DATA_SIZE);
+	__ASSERT(get_slot_size(type) <= MAX_SLOT_SIZE,
+		 "Type slot size %zu exceeds max supported %d", get_slot_size(type),
+		 MAX_SLOT_SIZE);
 
 	/* Read current header */
 	ret = read_storage_file_header(type, &header);
@@ -656,70 +2021,50 @@ static int read_data_entry(const struct storage_data *type, void *data, size_t s
 		return ret;
 	}
 
-	if (header.read_offset == header.write_offset) {
-		LOG_DBG("No new entries to read for %s", type->name);
+	if ((header.write_offset - header.read_offset) <= index) {
+		LOG_DBG("No entry at index %zu to read for %s", index, type->name);
 
 		return -EAGAIN;
 	}
 
-	ret = get_entries_per_block(type, &entries_per_block);
-	if (ret < 0) {
-		return ret;
-	}
-
-	wrapped_index = header.read_offset % RECORDS_PER_TYPE;
-	file_index = get_file_index(entries_per_block, wrapped_index);
-	entry_offset_index = get_entry_offset_index(entries_per_block, wrapped_index);
-	read_pos = (entry_offset_index % RECORDS_PER_TYPE) * type->data_size;
-
-	/* Open storage file */
-	ret = create_storage_file_path(type, file_index, file_path);
-	if (ret < 0) {
-		return ret;
-	}
-
-	fs_file_t_init(&file);
-
-	ret = fs_open(&file, file_path, FS_O_READ);
-	if (ret < 0) {
-		LOG_ERR("Failed to open %s: %d", file_path, ret);
-
-		return ret;
-	}
+	offset = header.read_offset + index;
 
-	LOG_DBG("%s data in file %s at offset %zu (write_offset=%u, read_offset=%u)",
-		update_offset ? "Reading" : "Peeking", file_path, read_pos, header.write_offset,
+	LOG_DBG("%s %s record %u (write_offset=%u, read_offset=%u)",
+		update_offset ? "Reading" : "Peeking", type->name, offset, header.write_offset,
 		header.read_offset);
 
-	/* Move to read position with wrap-around */
-	ret = fs_seek(&file, read_pos, FS_SEEK_SET);
-	if (ret < 0) {
-		LOG_ERR("Failed to move to read position: %d", ret);
-		fs_close(&file);
+	ret = read_slot(type, offset, slot);
+	if (ret == -ENOENT || ret == -ENODATA) {
+		LOG_ERR("Record %u of %s is missing", offset, type->name);
+
+		return -EIO;
+	} else if (ret < 0) {
+		LOG_ERR("Failed to read record %u of %s: %d", offset, type->name, ret);
 
 		return ret;
 	}
 
-	read_bytes = fs_read(&file, data != NULL ? data : temp_buffer, type->data_size);
-	if (read_bytes < 0) {
-		LOG_ERR("Failed to read data: %d", read_bytes);
-		fs_close(&file);
+	seq = sys_get_le32(slot);
+	if (seq != offset) {
+		LOG_ERR("Sequence number mismatch for %s: expected %u, got %u",
+			type->name, offset, seq);
 
-		return read_bytes;
+		return -EIO;
 	}
 
-	ret = fs_close(&file);
-	if (ret < 0) {
-		LOG_ERR("Failed to close file after reading: %d", ret);
-
-		return ret;
+	if (data != NULL) {
+		if (IS_ENABLED(CONFIG_APP_STORAGE_LITTLEFS_COMPACT_RECORDS)) {
+			type->decode_record(&slot[RECORD_SEQ_SIZE], data);
+		} else {
+			memcpy(data, &slot[RECORD_SEQ_SIZE], type->data_size);
+		}
 	}
 
 	/* Update header if requested */
 	if (update_offset) {
 		header.read_offset += 1;
 
-		ret = write_storage_file_header(type, &header);
+		ret = update_storage_file_header(type, &header);
 		if (ret < 0) {
 			LOG_ERR("Failed to update storage file header: %d", ret);
 
@@ -727,23 +2072,25 @@ static int read_data_entry(const struct storage_data *type, void *data, size_t s
 		}
 	}
 
-	return read_bytes;
+	return (int)type->data_size;
 }
 
 /*
  * @brief Peek data from LittleFS storage backend
  *
- * Peeks at the next data entry for the specified storage data type without
- * updating the read offset.
+ * Peeks at the data entry at the given index for the specified storage data type
+ * without updating the read offset.
  *
  * @param type Storage data type
+ * @param index Position of the entry, counted from the oldest entry (0)
  * @param data Pointer to buffer to store peeked data
  * @param size Size of buffer
  * @return int Number of bytes read on success, negative errno on failure
  */
-static int lfs_storage_peek(const struct storage_data *type, void *data, size_t size)
+static int lfs_storage_peek(const struct storage_data *type, size_t index, void *data,
+			    size_t size)
 {
-	return read_data_entry(type, data, size, false);
+	return read_data_entry(type, index, data, size, false);
 }
 
 /*
@@ -759,7 +2106,86 @@ static int lfs_storage_peek(const struct storage_data *type, void *data, size_t
  */
 static int lfs_storage_retrieve(const struct storage_data *type, void *data, size_t size)
 {
-	return read_data_entry(type, data, size, true);
+	return read_data_entry(type, 0, data, size, true);
+}
+
+/*
+ * @brief Overwrite a record in LittleFS storage backend
+ *
+ * The slot of the record is written again with the same sequence number, so recovery after
+ * a reset is not affected. A record in the frame that is being filled is only updated in
+ * RAM. Other records are written to their slot directly, which is a partial frame write.
+ *
+ * @param type Storage data type
+ * @param index Position of the record, counted from the oldest record (0)
+ * @param data Pointer to the new data
+ * @param size Size of the data
+ * @return int 0 on success, -EAGAIN if there is no record at @p index, other negative errno
+ *	       on failure
+ */
+static int lfs_storage_replace(const struct storage_data *type, size_t index, const void *data,
+			       size_t size)
+{
+	struct storage_file_header header;
+	uint8_t slot[MAX_SLOT_SIZE];
+	size_t slot_size = get_slot_size(type);
+	uint32_t offset;
+	int idx;
+	int ret;
+
+	__ASSERT(type != NULL, "Storage type is NULL");
+	__ASSERT(data != NULL, "Data pointer is NULL");
+	__ASSERT(size == type->data_size, "Data size mismatch: expected %zu, got %zu",
+		 type->data_size, size);
+	__ASSERT_NO_MSG(slot_size <= sizeof(slot));
+
+	ret = read_storage_file_header(type, &header);
+	if (ret < 0) {
+		LOG_ERR("Failed to read storage file header: %d", ret);
+		SEND_FATAL_ERROR();
+
+		return ret;
+	}
+
+	if ((header.write_offset - header.read_offset) <= index) {
+		return -EAGAIN;
+	}
+
+	ret = get_type_index(type, &idx);
+	if (ret < 0) {
+		return ret;
+	}
+
+	offset = header.read_offset + index;
+
+	sys_put_le32(offset, slot);
+
+	if (IS_ENABLED(CONFIG_APP_STORAGE_LITTLEFS_COMPACT_RECORDS)) {
+		type->encode_record(data, &slot[RECORD_SEQ_SIZE]);
+	} else {
+		memcpy(&slot[RECORD_SEQ_SIZE], data, type->data_size);
+	}
+
+	LOG_DBG("Replacing %s record %u", type->name, offset);
+
+#if FRAME_SIZE > 0
+	if ((offset - type_state[idx].frame_start) < type_state[idx].frame_records) {
+		memcpy(&type_state[idx].frame[(offset - type_state[idx].frame_start) * slot_size],
+		       slot, slot_size);
+		type_state[idx].frame_dirty = true;
+	} else {
+		ret = data_write(type, idx, offset, slot, slot_size);
+	}
+#else
+	ret = data_write(type, idx, offset, slot, slot_size);
+#endif /* FRAME_SIZE > 0 */
+	if (ret < 0) {
+		return ret;
+	}
+
+	time_index_update(type, idx, offset, data);
+
+	return 0;
 }
 
 /*
@@ -792,6 +2218,88 @@ static int lfs_storage_records_count(const struct storage_data *type)
 	return count;
 }
 
+/*
+ * @brief Find the oldest record at or after a point in time
+ *
+ * The time index holds the timestamp of the first record of each data file, which narrows the
+ * search down to the records of one file without reading flash. The records in that file are
+ * then binary searched, so only O(log(entries per block)) records are read.
+ *
+ * @param type Storage data type
+ * @param timestamp Timestamp in milliseconds
+ * @return int Index of the first record at or after @p timestamp, the number of records if
+ *	       there is none, negative errno on failure
+ */
+static int lfs_storage_find(const struct storage_data *type, int64_t timestamp)
+{
+	struct storage_file_header header;
+	uint32_t low;
+	uint32_t high;
+	int idx;
+	int ret;
+
+	__ASSERT(type != NULL, "Storage type is NULL");
+
+	ret = get_type_index(type, &idx);
+	if (ret < 0) {
+		return ret;
+	}
+
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK)
+	ret = header_check(type, idx);
+	if (ret < 0) {
+		return ret;
+	}
+#endif /* CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK */
+
+	header = type_state[idx].header;
+	low = header.read_offset;
+	high = header.write_offset;
+
+	for (int i = 0; i < TIME_INDEX_SIZE; i++) {
+		const struct time_index_entry *entry = &type_state[idx].time_index[i];
+
+		/* Skip files whose first record is not stored any more */
+		if (!entry->valid || ((entry->seq - header.read_offset) >=
+				      (header.write_offset - header.read_offset))) {
+			continue;
+		}
+
+		if (entry->timestamp < timestamp) {
+			if ((entry->seq - header.read_offset) >= (low - header.read_offset)) {
+				low = entry->seq + 1;
+			}
+		} else if ((entry->seq - header.read_offset) < (high - header.read_offset)) {
+			high = entry->seq;
+		}
+	}
+
+	/* Timestamps that are out of order can make the index contradict itself */
+	if ((low - header.read_offset) > (high - header.read_offset)) {
+		low = high;
+	}
+
+	while ((high - low) > 0) {
+		uint32_t mid = low + ((high - low) / 2);
+		int64_t mid_timestamp;
+
+		ret = read_record_timestamp(type, mid, &mid_timestamp);
+		if (ret < 0) {
+			LOG_ERR("Failed to read timestamp of %s record %u: %d", type->name, mid, ret);
+
+			return (ret == -ENODATA) ? -EIO : ret;
+		}
+
+		if (mid_timestamp < timestamp) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return (int)(low - header.read_offset);
+}
+
 /*
  * @brief Clear all stored data in LittleFS storage backend
  *
@@ -807,7 +2315,7 @@ static int lfs_storage_clear(void)
 	char file_path[MAX_PATH_LEN];
 	int ret;
 
-	/* Close all open header file handles before deleting the files.
+	/* Close all open header and data file handles before deleting the files.
 	 * init_header_files(), called at the end of this function, will re-open them.
 	 */
 	{
@@ -819,10 +2327,29 @@ static int lfs_storage_clear(void)
 				fs_close(&type_state[close_idx].header_file);
 				type_state[close_idx].header_open = false;
 			}
+
+			(void)data_file_close(&type_state[close_idx].write_file,
+					      &type_state[close_idx].write_file_index);
+			(void)data_file_close(&type_state[close_idx].read_file,
+					      &type_state[close_idx].read_file_index);
+
+#if FRAME_SIZE > 0
+			/* Records in RAM are cleared as well */
+			type_state[close_idx].frame_records = 0;
+			type_state[close_idx].frame_dirty = false;
+#endif /* FRAME_SIZE > 0 */
+
 			close_idx++;
 		}
 	}
 
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK)
+	if (superblock_open) {
+		fs_close(&superblock_file);
+		superblock_open = false;
+	}
+#endif /* CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK */
+
 	fs_dir_t_init(&dir);
 
 	ret = fs_opendir(&dir, mountpoint->mnt_point);
@@ -885,22 +2412,73 @@ static int lfs_storage_clear(void)
 
 	return 0;
 }
+
+/*
+ * @brief Write unsynced records and dirty cached headers to flash
+ *
+ * Records are committed before the header that refers to them, so that a synced header
+ * never points past the records on flash.
+ *
+ * @return int 0 on success, negative errno on failure
+ */
+static int lfs_storage_sync(void)
+{
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK)
+	return superblock_sync();
+#else
+	int idx = 0;
+	int err = 0;
+
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		int ret = data_file_sync(type, idx);
+
+		if (ret == 0 && type_state[idx].header_dirty) {
+			ret = sync_storage_file_header(type, idx);
+		}
+
+		if (ret < 0 && err == 0) {
+			err = ret;
+		}
+
+		idx++;
+	}
+
+	return err;
+#endif /* CONFIG_APP_STORAGE_LITTLEFS_SUPERBLOCK */
+}
+
 /*
  * @brief LittleFS storage backend interface
  *
  * Implementation of the storage_backend interface for LittleFS-based storage.
  * Provides functions for initializing the backend, storing and retrieving
- * data, counting stored records, and clearing all data.
+ * data, counting stored records, clearing all data and syncing cached headers.
  */
 static const struct storage_backend lfs_backend = {
 	.init = lfs_storage_init,
 	.store = lfs_storage_store,
 	.peek = lfs_storage_peek,
 	.retrieve = lfs_storage_retrieve,
+	.replace = lfs_storage_replace,
 	.count = lfs_storage_records_count,
+	.find = lfs_storage_find,
 	.clear = lfs_storage_clear,
+	.sync = lfs_storage_sync,
 };
 
+/*
+ * @brief Get the LittleFS storage backend interface
+ *
+ * Makes the LittleFS storage backend available to the tiered backend.
+ *
+ * @return Pointer to the LittleFS storage backend interface
+ */
+const struct storage_backend *storage_backend_littlefs_get(void)
+{
+	return &lfs_backend;
+}
+
+#if defined(CONFIG_APP_STORAGE_BACKEND_LITTLEFS)
 /*
  * @brief Get the LittleFS storage backend interface
  *
@@ -912,3 +2490,4 @@ const struct storage_backend *storage_backend_get(void)
 {
 	return &lfs_backend;
 }
+#endif /* CONFIG_APP_STORAGE_BACKEND_LITTLEFS */
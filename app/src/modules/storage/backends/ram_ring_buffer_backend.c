@@ -7,14 +7,21 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/ring_buffer.h>
+#include <string.h>
 
 #include "storage.h"
 #include "storage_backend.h"
 #include "storage_data_types.h"
+#include "mem_stats.h"
 
 LOG_MODULE_DECLARE(storage, CONFIG_APP_STORAGE_LOG_LEVEL);
 
+#if defined(CONFIG_APP_STORAGE_BACKEND_TIERED)
+/* In the tiered backend, the RAM ring buffers only hold the records that have not spilled */
+#define RECORDS_PER_TYPE	CONFIG_APP_STORAGE_TIERED_RAM_RECORDS_PER_TYPE
+#else
 #define RECORDS_PER_TYPE	CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE
+#endif
 
 /**
  * @brief Macro to declare a ring buffer for a specific data type
@@ -23,6 +30,7 @@ LOG_MODULE_DECLARE(storage, CONFIG_APP_STORAGE_LOG_LEVEL);
  * For each data type in DATA_SOURCE_LIST, it declares a ring buffer with:
  * - Name: <type_name>_ring_buf (e.g., battery_ring_buf)
  * - Size: Calculated to hold RECORDS_PER_TYPE items of the data type's size
+ * - Fill level statistics with the same name, in the storage_ram group
  *
  * @param _name Name of the data type (e.g., battery)
  * @param _c Channel parameter (unused in this macro)
@@ -30,9 +38,17 @@ LOG_MODULE_DECLARE(storage, CONFIG_APP_STORAGE_LOG_LEVEL);
  * @param _data_type Data type to store
  * @param _cfn Check function parameter (unused in this macro)
  * @param _efn Extract function parameter (unused in this macro)
+ * @param _rt Record type parameter (unused in this macro)
+ * @param _enc Encode function parameter (unused in this macro)
+ * @param _dec Decode function parameter (unused in this macro)
+ * @param _snd Cloud send function parameter (unused in this macro)
+ * @param _bat Cloud batch function parameter (unused in this macro)
  */
-#define RAM_RING_BUF_ADD(_name, _c, _m, _data_type, _cfn, _efn)				\
-	RING_BUF_DECLARE(_name ## _ring_buf, (sizeof(_data_type) * RECORDS_PER_TYPE));
+#define RAM_RING_BUF_ADD(_name, _c, _m, _data_type, _cfn, _efn, _rt, _enc, _dec,		\
+			 _snd, _bat)							\
+	RING_BUF_DECLARE(_name ## _ring_buf, (sizeof(_data_type) * RECORDS_PER_TYPE));	\
+	MEM_STATS_BUFFER_DEFINE(_name ## _ring_buf, storage_ram,				\
+				(sizeof(_data_type) * RECORDS_PER_TYPE));
 
 /**
  * @brief Macro to create a pointer to a ring buffer
@@ -51,10 +67,20 @@ LOG_MODULE_DECLARE(storage, CONFIG_APP_STORAGE_LOG_LEVEL);
  * @param _dt Data type parameter (unused in this macro)
  * @param _cfn Check function parameter (unused in this macro)
  * @param _efn Extract function parameter (unused in this macro)
+ * @param _rt Record type parameter (unused in this macro)
+ * @param _enc Encode function parameter (unused in this macro)
+ * @param _dec Decode function parameter (unused in this macro)
+ * @param _snd Cloud send function parameter (unused in this macro)
+ * @param _bat Cloud batch function parameter (unused in this macro)
  */
-#define RAM_RING_BUF_PTR(_name, _c, _m, _dt, _cfn, _efn)					\
+#define RAM_RING_BUF_PTR(_name, _c, _m, _dt, _cfn, _efn, _rt, _enc, _dec, _snd, _bat)	\
 	&(_name ## _ring_buf),
 
+/* Pointer to the fill level statistics of a ring buffer, same use as RAM_RING_BUF_PTR */
+#define RAM_RING_BUF_MEM_STATS_PTR(_name, _c, _m, _dt, _cfn, _efn, _rt, _enc, _dec,		\
+				   _snd, _bat)						\
+	MEM_STATS_BUFFER_GET(_name ## _ring_buf),
+
 /* Declare ring buffers for each data type */
 DATA_SOURCE_LIST(RAM_RING_BUF_ADD)
 
@@ -66,6 +92,9 @@ struct ram_backend_ctx {
 	 */
 	struct ring_buf *ring_buf_ptrs[CONFIG_APP_STORAGE_MAX_TYPES];
 
+	/* Fill level statistics of the ring buffers, NULL when disabled */
+	struct mem_stats_buffer *mem_stats_ptrs[CONFIG_APP_STORAGE_MAX_TYPES];
+
 	/* Number of data types registered */
 	int num_registered_types;
 };
@@ -75,8 +104,13 @@ static struct ram_backend_ctx ctx = {
 		/* Expands to a list of ring buffer pointers for each data type */
 		DATA_SOURCE_LIST(RAM_RING_BUF_PTR)
 	},
+	.mem_stats_ptrs = {
+		DATA_SOURCE_LIST(RAM_RING_BUF_MEM_STATS_PTR)
+	},
 };
 
+static int ram_records_count(const struct storage_data *type);
+
 /**
  * @brief Get the index for a storage data type
  *
@@ -118,6 +152,19 @@ static struct ring_buf *get_ring_buf_ptr(size_t idx)
 	return ctx.ring_buf_ptrs[idx];
 }
 
+/**
+ * @brief Update the fill level statistics of the ring buffer for a data type
+ *
+ * @param idx Index of the data type
+ */
+static void mem_stats_update(size_t idx)
+{
+	const struct ring_buf *ring_buf = get_ring_buf_ptr(idx);
+
+	mem_stats_buffer_update(ctx.mem_stats_ptrs[idx],
+				ring_buf_capacity_get(ring_buf) - ring_buf_space_get(ring_buf));
+}
+
 /**
  * @brief Initialize the RAM storage backend
  *
@@ -210,29 +257,88 @@ static int ram_store(const struct storage_data *type, const void *data, size_t s
 		return -EIO;
 	}
 
+	mem_stats_update(idx);
+
 	LOG_DBG("Stored %s item, count: %u, left: %u bytes",
-		type->name, storage_backend_get()->count(type),
+		type->name, ram_records_count(type),
 		ring_buf_space_get(ring_buf));
 
 	return 0;
 }
 
+/**
+ * @brief Copy bytes of a ring buffer at an offset without removing them
+ *
+ * Uses the ring buffer claim API to skip the first @p offset bytes and copy the
+ * following @p len bytes, out of the ring buffer or, to overwrite them in place, into it.
+ * The claim is released without consuming any data.
+ *
+ * @param ring_buf Ring buffer to access
+ * @param offset Number of bytes to skip from the head of the ring buffer
+ * @param data Destination buffer, or source buffer if @p write is true
+ * @param len Number of bytes to copy
+ * @param write True to copy @p data into the ring buffer
+ * @return 0 on success, -EIO if the ring buffer holds fewer than offset + len bytes
+ */
+static int ring_buf_copy_at(struct ring_buf *ring_buf, uint32_t offset, uint8_t *data,
+			    uint32_t len, bool write)
+{
+	uint8_t *claim;
+	uint32_t claimed;
+	int err = 0;
+
+	while (offset > 0) {
+		claimed = ring_buf_get_claim(ring_buf, &claim, offset);
+		if (claimed == 0) {
+			err = -EIO;
+			goto release;
+		}
+
+		offset -= claimed;
+	}
+
+	while (len > 0) {
+		claimed = ring_buf_get_claim(ring_buf, &claim, len);
+		if (claimed == 0) {
+			err = -EIO;
+			goto release;
+		}
+
+		if (write) {
+			memcpy(claim, data, claimed);
+		} else {
+			memcpy(data, claim, claimed);
+		}
+
+		data += claimed;
+		len -= claimed;
+	}
+
+release:
+	/* Finishing with zero bytes releases the claim and leaves the data in place */
+	(void)ring_buf_get_finish(ring_buf, 0);
+
+	return err;
+}
+
 /**
  * @brief Peek at data from the RAM backend without removing it
  *
- * Returns the size of the next item without copying data (if data is NULL)
+ * Returns the size of the item at the given index without copying data (if data is NULL)
  * or copies the data if data buffer is provided.
  *
  * @param type Storage data type to peek at
+ * @param index Position of the record, counted from the oldest record (0)
  * @param data Pointer where the peeked data will be stored (can be NULL for size-only)
  * @param size Size of the data buffer in bytes (ignored if data is NULL)
  * @return Number of bytes that would be read on success, negative errno on failure
  */
-static int ram_peek(const struct storage_data *type, void *data, size_t size)
+static int ram_peek(const struct storage_data *type, size_t index, void *data, size_t size)
 {
 	struct ring_buf *ring_buf;
 	int idx;
-	uint32_t bytes_peeked;
+	int count;
+	int err;
 
 	if (!type) {
 		return -EINVAL;
@@ -245,7 +351,12 @@ static int ram_peek(const struct storage_data *type, void *data, size_t size)
 
 	ring_buf = get_ring_buf_ptr(idx);
 
-	if (ring_buf_is_empty(ring_buf)) {
+	count = ram_records_count(type);
+	if (count < 0) {
+		return count;
+	}
+
+	if (index >= (size_t)count) {
 		return -EAGAIN;
 	}
 
@@ -262,15 +373,61 @@ static int ram_peek(const struct storage_data *type, void *data, size_t size)
 	}
 
 	/* Peek at the data without removing it */
-	bytes_peeked = ring_buf_peek(ring_buf, data, (uint32_t)type->data_size);
-	if (bytes_peeked != (uint32_t)type->data_size) {
-		LOG_ERR("Failed to peek data: expected %zu bytes, got %u",
-			type->data_size, bytes_peeked);
+	err = ring_buf_copy_at(ring_buf, (uint32_t)(index * type->data_size), data,
+			       (uint32_t)type->data_size, false);
+	if (err) {
+		LOG_ERR("Failed to peek data at index %zu: %d", index, err);
 
-		return -EIO;
+		return err;
 	}
 
-	return (int)bytes_peeked;
+	return (int)type->data_size;
+}
+
+/**
+ * @brief Overwrite a record in the RAM backend
+ *
+ * @param type Storage data type of the record
+ * @param index Position of the record, counted from the oldest record (0)
+ * @param data Pointer to the new data
+ * @param size Size of the data in bytes
+ * @return 0 on success, negative errno on failure
+ */
+static int ram_replace(const struct storage_data *type, size_t index, const void *data,
+		       size_t size)
+{
+	int idx;
+	int count;
+	int err;
+
+	if (!type || !data || (size != type->data_size)) {
+		return -EINVAL;
+	}
+
+	idx = get_type_index(type);
+	if (idx < 0) {
+		return -EINVAL;
+	}
+
+	count = ram_records_count(type);
+	if (count < 0) {
+		return count;
+	}
+
+	if (index >= (size_t)count) {
+		return -EAGAIN;
+	}
+
+	/* The data is only read from when writing */
+	err = ring_buf_copy_at(get_ring_buf_ptr(idx), (uint32_t)(index * type->data_size),
+			       (uint8_t *)data, (uint32_t)size, true);
+	if (err) {
+		LOG_ERR("Failed to replace data at index %zu: %d", index, err);
+
+		return err;
+	}
+
+	return 0;
 }
 
 /**
@@ -318,8 +475,10 @@ static int ram_retrieve(const struct storage_data *type, void *data, size_t size
 		return -EIO;
 	}
 
+	mem_stats_update(idx);
+
 	LOG_DBG("Retrieved item in %s ring buffer, size: %u bytes, %u items left",
-		type->name, bytes_read, storage_backend_get()->count(type));
+		type->name, bytes_read, ram_records_count(type));
 
 	return (int)bytes_read;
 }
@@ -388,6 +547,7 @@ static int ram_clear(void)
 		ring_buf = get_ring_buf_ptr(idx);
 
 		ring_buf_reset(ring_buf);
+		mem_stats_update(idx);
 	}
 
 	return 0;
@@ -405,10 +565,24 @@ static const struct storage_backend ram_backend = {
 	.store = ram_store,
 	.peek = ram_peek,
 	.retrieve = ram_retrieve,
+	.replace = ram_replace,
 	.count = ram_records_count,
 	.clear = ram_clear,
 };
 
+/**
+ * @brief Get the RAM storage backend interface
+ *
+ * Makes the RAM storage backend available to the tiered backend.
+ *
+ * @return Pointer to the RAM storage backend interface
+ */
+const struct storage_backend *storage_backend_ram_get(void)
+{
+	return &ram_backend;
+}
+
+#if defined(CONFIG_APP_STORAGE_BACKEND_RAM)
 /**
  * @brief Get the RAM storage backend interface
  *
@@ -420,3 +594,4 @@ const struct storage_backend *storage_backend_get(void)
 {
 	return &ram_backend;
 }
+#endif /* CONFIG_APP_STORAGE_BACKEND_RAM */
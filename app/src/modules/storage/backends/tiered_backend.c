@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <errno.h>
+
+#include "storage.h"
+#include "storage_backend.h"
+#include "storage_data_types.h"
+
+LOG_MODULE_DECLARE(storage, CONFIG_APP_STORAGE_LOG_LEVEL);
+
+#define RECORDS_PER_TYPE	CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE
+#define SPILL_WATERMARK		CONFIG_APP_STORAGE_TIERED_SPILL_WATERMARK
+
+BUILD_ASSERT(SPILL_WATERMARK <= CONFIG_APP_STORAGE_TIERED_RAM_RECORDS_PER_TYPE,
+	     "The spill watermark must not exceed the RAM tier capacity");
+
+/*
+ * Tiered storage backend.
+ *
+ * New records are stored in the RAM backend. When the RAM tier of a type holds
+ * CONFIG_APP_STORAGE_TIERED_SPILL_WATERMARK records, or when the storage module asks the backend
+ * to persist its records, all RAM records of the type are moved to the LittleFS backend.
+ *
+ * Records in LittleFS are always older than the records in RAM, so reads drain LittleFS first
+ * and then RAM to keep FIFO order. The two tiers together hold at most
+ * CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE records per type; when full, the oldest record is
+ * dropped, like in the other backends.
+ */
+
+/* Buffer for moving a record between the tiers, only used from the storage thread */
+static uint8_t record_buf[STORAGE_MAX_DATA_SIZE];
+
+static const struct storage_backend *ram;
+static const struct storage_backend *lfs;
+
+/**
+ * @brief Move all RAM records of a type to LittleFS
+ *
+ * Records are only removed from RAM after they are stored in LittleFS, so a failure leaves
+ * the remaining records in RAM.
+ *
+ * @param type Storage data type to spill
+ * @return 0 on success, negative errno on failure
+ */
+static int spill_type(const struct storage_data *type)
+{
+	int count = ram->count(type);
+	int ret;
+
+	if (count <= 0) {
+		return count;
+	}
+
+	LOG_DBG("Spilling %d %s records to flash", count, type->name);
+
+	for (int i = 0; i < count; i++) {
+		ret = ram->peek(type, 0, record_buf, sizeof(record_buf));
+		if (ret < 0) {
+			LOG_ERR("Failed to peek %s record in RAM, error: %d", type->name, ret);
+
+			return ret;
+		}
+
+		ret = lfs->store(type, record_buf, type->data_size);
+		if (ret) {
+			LOG_ERR("Failed to spill %s record to flash, error: %d", type->name, ret);
+
+			return ret;
+		}
+
+		ret = ram->retrieve(type, record_buf, sizeof(record_buf));
+		if (ret < 0) {
+			LOG_ERR("Failed to remove spilled %s record from RAM, error: %d",
+				type->name, ret);
+
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Drop the oldest record of a type, from LittleFS if it holds any
+ *
+ * @param type Storage data type to drop a record of
+ * @return 0 on success, negative errno on failure
+ */
+static int drop_oldest(const struct storage_data *type)
+{
+	int ret;
+
+	if (lfs->count(type) > 0) {
+		ret = lfs->retrieve(type, record_buf, sizeof(record_buf));
+	} else {
+		ret = ram->retrieve(type, record_buf, sizeof(record_buf));
+	}
+
+	return (ret < 0) ? ret : 0;
+}
+
+static int tiered_init(void)
+{
+	int err;
+
+	ram = storage_backend_ram_get();
+	lfs = storage_backend_littlefs_get();
+
+	err = ram->init();
+	if (err) {
+		LOG_ERR("Failed to initialize RAM tier, error: %d", err);
+
+		return err;
+	}
+
+	err = lfs->init();
+	if (err) {
+		LOG_ERR("Failed to initialize flash tier, error: %d", err);
+
+		return err;
+	}
+
+	return 0;
+}
+
+static int tiered_count(const struct storage_data *type)
+{
+	int ram_count;
+	int lfs_count;
+
+	if (!type) {
+		return -EINVAL;
+	}
+
+	ram_count = ram->count(type);
+	if (ram_count < 0) {
+		return ram_count;
+	}
+
+	lfs_count = lfs->count(type);
+	if (lfs_count < 0) {
+		return lfs_count;
+	}
+
+	return ram_count + lfs_count;
+}
+
+static int tiered_store(const struct storage_data *type, const void *data, size_t size)
+{
+	int count;
+	int err;
+
+	if (!type || !data) {
+		return -EINVAL;
+	}
+
+	count = tiered_count(type);
+	if (count < 0) {
+		return count;
+	}
+
+	if (count >= RECORDS_PER_TYPE) {
+		LOG_DBG("Full storage, old data will be overwritten");
+
+		err = drop_oldest(type);
+		if (err) {
+			LOG_ERR("Failed to discard oldest %s record, error: %d", type->name, err);
+
+			return err;
+		}
+	}
+
+	if (ram->count(type) >= SPILL_WATERMARK) {
+		err = spill_type(type);
+		if (err) {
+			return err;
+		}
+	}
+
+	return ram->store(type, data, size);
+}
+
+static int tiered_peek(const struct storage_data *type, size_t index, void *data, size_t size)
+{
+	int lfs_count;
+
+	if (!type) {
+		return -EINVAL;
+	}
+
+	lfs_count = lfs->count(type);
+	if (lfs_count < 0) {
+		return lfs_count;
+	}
+
+	if (index < (size_t)lfs_count) {
+		return lfs->peek(type, index, data, size);
+	}
+
+	return ram->peek(type, index - (size_t)lfs_count, data, size);
+}
+
+static int tiered_retrieve(const struct storage_data *type, void *data, size_t size)
+{
+	int lfs_count;
+
+	if (!type || !data) {
+		return -EINVAL;
+	}
+
+	lfs_count = lfs->count(type);
+	if (lfs_count < 0) {
+		return lfs_count;
+	}
+
+	if (lfs_count > 0) {
+		return lfs->retrieve(type, data, size);
+	}
+
+	return ram->retrieve(type, data, size);
+}
+
+static int tiered_replace(const struct storage_data *type, size_t index, const void *data,
+			  size_t size)
+{
+	int lfs_count;
+
+	if (!type || !data) {
+		return -EINVAL;
+	}
+
+	lfs_count = lfs->count(type);
+	if (lfs_count < 0) {
+		return lfs_count;
+	}
+
+	if (index < (size_t)lfs_count) {
+		return lfs->replace(type, index, data, size);
+	}
+
+	return ram->replace(type, index - (size_t)lfs_count, data, size);
+}
+
+static int tiered_clear(void)
+{
+	int err;
+
+	err = ram->clear();
+	if (err) {
+		LOG_ERR("Failed to clear RAM tier, error: %d", err);
+
+		return err;
+	}
+
+	return lfs->clear();
+}
+
+static int tiered_sync(void)
+{
+	return lfs->sync();
+}
+
+static int tiered_persist(void)
+{
+	int err;
+
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		err = spill_type(type);
+		if (err) {
+			return err;
+		}
+	}
+
+	return lfs->sync();
+}
+
+/**
+ * @brief Tiered storage backend interface
+ *
+ * Implementation of the storage_backend interface on top of the RAM and LittleFS backends.
+ */
+static const struct storage_backend tiered_backend = {
+	.init = tiered_init,
+	.store = tiered_store,
+	.peek = tiered_peek,
+	.retrieve = tiered_retrieve,
+	.replace = tiered_replace,
+	.count = tiered_count,
+	.clear = tiered_clear,
+	.sync = tiered_sync,
+	.persist = tiered_persist,
+};
+
+/**
+ * @brief Get the tiered storage backend interface
+ *
+ * Makes the tiered storage backend available to the storage module.
+ *
+ * @return Pointer to the tiered storage backend interface
+ */
+const struct storage_backend *storage_backend_get(void)
+{
+	return &tiered_backend;
+}
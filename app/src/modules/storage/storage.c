@@ -17,6 +17,10 @@
 #include "storage_backend.h"
 #include "storage_data_types.h"
 #include "app_common.h"
+#include "state_stats.h"
+#include "zbus_stats.h"
+#include "handler_stats.h"
+#include "mem_stats.h"
 
 #ifdef CONFIG_APP_POWER
 #include "power.h"
@@ -73,10 +77,12 @@ BUILD_ASSERT(CONFIG_APP_STORAGE_WATCHDOG_TIMEOUT_SECONDS >
  * For example, with CONFIG_APP_POWER enabled, the expansion looks like:
  *
  * Step 1: DATA_SOURCE_LIST expands to:
- *   ADD_OBSERVERS(battery, power_chan, struct power_msg, double, battery_check, battery_extract)
+ *   ADD_OBSERVERS(battery, power_chan, struct power_msg, double, battery_check, battery_extract,
+ *                 struct storage_battery_record, battery_encode, battery_decode,
+ *                 battery_cloud_send, battery_cloud_batch_add)
  *
  * Step 2: ADD_OBSERVERS expands to:
- *   ZBUS_CHAN_ADD_OBS(power_chan, storage_subscriber, 0)
+ *   ZBUS_CHAN_ADD_OBS(power_chan, storage_subscriber, 1)
  *
  * This process repeats for each enabled module in DATA_SOURCE_LIST.
  *
@@ -86,12 +92,27 @@ BUILD_ASSERT(CONFIG_APP_STORAGE_WATCHDOG_TIMEOUT_SECONDS >
  * @param _dt Data type to store (unused in this macro)
  * @param _c Check function (unused in this macro)
  * @param _e Extract function (unused in this macro)
+ * @param _rt Record type (unused in this macro)
+ * @param _enc Encode function (unused in this macro)
+ * @param _dec Decode function (unused in this macro)
+ * @param _snd Cloud send function (unused in this macro)
+ * @param _bat Cloud batch function (unused in this macro)
  */
-#define ADD_OBSERVERS(_n, _chan, _t, _dt, _c, _e) ZBUS_CHAN_ADD_OBS(_chan, storage_subscriber, 0);
+/* Added after the observers with priority 0, so that listeners that the check functions
+ * depend on, like the geofence listener on location_chan, have seen the message first.
+ */
+#define ADD_OBSERVERS(_n, _chan, _t, _dt, _c, _e, _rt, _enc, _dec, _snd, _bat)		\
+	ZBUS_CHAN_ADD_OBS(_chan, storage_subscriber, 1);
 
 /* Private storage channel message types */
 enum priv_storage_msg_type {
 	STORAGE_BATCH_SESSION_TIMEOUT,
+
+	/* The consumer has released enough batch items, more items can be handed out */
+	STORAGE_BATCH_PIPE_REFILL,
+
+	/* Cached backend state should be written to persistent storage */
+	STORAGE_BACKEND_SYNC,
 };
 
 struct priv_storage_msg {
@@ -112,15 +133,20 @@ ZBUS_CHAN_DEFINE(storage_chan,
 		 ZBUS_MSG_INIT(0)
 );
 
+ZBUS_STATS_CHAN_DEFINE(storage_chan);
+ZBUS_STATS_METRIC_DEFINE(storage_chan, storage_chan);
+
 /* Create the storage data channel */
 ZBUS_CHAN_DEFINE(storage_data_chan,
-		 struct storage_msg,
+		 struct storage_data_msg,
 		 NULL,
 		 NULL,
 		 ZBUS_OBSERVERS_EMPTY,
 		 ZBUS_MSG_INIT(0)
 );
 
+ZBUS_STATS_CHAN_DEFINE(storage_data_chan);
+
 /* Create private storage channel for internal messaging */
 ZBUS_CHAN_DEFINE(priv_storage_chan,
 		 struct priv_storage_msg,
@@ -140,25 +166,59 @@ static void state_buffer_pipe_active_entry(void *o);
 static enum smf_state_result state_buffer_pipe_active_run(void *o);
 static void state_buffer_pipe_active_exit(void *o);
 
-/* Storage pipe for streaming data to consumers */
-K_PIPE_DEFINE(storage_pipe, CONFIG_APP_STORAGE_BATCH_BUFFER_SIZE, 4);
+/* Number of items that fit in the batch buffer. At least one item is always available. */
+#define BATCH_ITEM_COUNT	MAX(1, (CONFIG_APP_STORAGE_BATCH_BUFFER_SIZE /	\
+					sizeof(struct storage_data_item)))
 
-/* Storage pipe item header (compact, fixed-width) */
-struct storage_pipe_header {
-	uint8_t type;
-	uint16_t data_size;
-};
+/* Batch items are peeked from the backend directly into blocks of this slab and handed to the
+ * consumer by pointer through storage_batch_queue, so that no further copies are needed.
+ */
+K_MEM_SLAB_DEFINE_STATIC(storage_batch_slab, sizeof(struct storage_data_item),
+			 BATCH_ITEM_COUNT, 4);
+K_MSGQ_DEFINE(storage_batch_queue, sizeof(struct storage_data_item *), BATCH_ITEM_COUNT, 4);
+
+MEM_STATS_BUFFER_DEFINE(storage_pipe, storage_pipe,
+			BATCH_ITEM_COUNT * sizeof(struct storage_data_item));
 
-/* Ensure the batch pipe is large enough to hold one full item plus its header. */
-BUILD_ASSERT(CONFIG_APP_STORAGE_BATCH_BUFFER_SIZE >=
-	     sizeof(struct storage_pipe_header) + STORAGE_MAX_DATA_SIZE,
-	     "CONFIG_APP_STORAGE_BATCH_BUFFER_SIZE is too small to hold the largest "
-	     "storage_data_item plus its pipe header");
+/* Set while a STORAGE_BATCH_PIPE_REFILL message is pending, to avoid one message per read */
+static atomic_t pipe_refill_pending;
+
+/* The consumer requests a refill once this many batch items are free */
+#define PIPE_REFILL_LEVEL	DIV_ROUND_UP(BATCH_ITEM_COUNT, 2)
 
 /* Pipe session tracking */
 struct pipe_session {
 	uint32_t session_id;
 	size_t total_items;
+
+	/* Number of items per data type that have been written to the pipe but not yet
+	 * consumed. Used as the peek index of the next item to hand out, so that a consumer
+	 * can read ahead and confirm several items at once. In query sessions, nothing is
+	 * consumed and this is the cursor into the selected records.
+	 */
+	size_t in_flight[STORAGE_DATA_TYPE_COUNT];
+
+	/* Number of items per data type that have been written to the pipe, but have since been
+	 * overwritten in the backend by new records. Their STORAGE_BATCH_CONSUME has nothing left
+	 * to remove.
+	 */
+	size_t dropped[STORAGE_DATA_TYPE_COUNT];
+
+	/* Set for sessions started with STORAGE_BATCH_QUERY */
+	bool query;
+	bool newest_first;
+
+	/* Index of the first selected record and number of selected records per data type,
+	 * only used in query sessions.
+	 */
+	size_t first[STORAGE_DATA_TYPE_COUNT];
+	size_t selected[STORAGE_DATA_TYPE_COUNT];
+
+	/* Timestamp of the next item of each data type to hand out, used to merge the types in
+	 * timestamp order. Only valid while the item has not been handed out.
+	 */
+	int64_t next_timestamp[STORAGE_DATA_TYPE_COUNT];
+	bool next_timestamp_valid[STORAGE_DATA_TYPE_COUNT];
 };
 
 /* Storage module state object */
@@ -185,6 +245,10 @@ struct storage_state {
 /* Delayable work for session timeout */
 static void session_timeout_work_fn(struct k_work *work);
 
+/* Delayable work that bounds how long backend state stays unsynced after a change */
+static void backend_sync_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(backend_sync_work, backend_sync_work_fn);
+
 /* Defining the storage module states */
 enum storage_module_state {
 	STATE_RUNNING,
@@ -209,6 +273,10 @@ static const struct smf_state states[] = {
 				 NULL),
 };
 
+STATE_STATS_DEFINE(storage, states);
+HANDLER_STATS_DEFINE(storage, CONFIG_APP_STORAGE_MSG_PROCESSING_TIMEOUT_SECONDS);
+HANDLER_STATS_METRIC_DEFINE(storage);
+
 /* Static helper functions */
 static void task_wdt_callback(int channel_id, void *user_data)
 {
@@ -243,63 +311,66 @@ static void session_timeout_work_fn(struct k_work *work)
 	}
 }
 
-/*
- * Write all bytes to pipe. The provided timeout is reused for each attempt to
- * keep logic simple and predictable. The helper is needed because
- * k_pipe_write() does not guarantee that all bytes will be written. Returns
- * number of bytes written if successful, negative error code if failed.
- */
-static int pipe_write_all(struct k_pipe *pipe,
-	const uint8_t *buf,
-	size_t len,
-	k_timeout_t timeout)
+static void backend_sync_work_fn(struct k_work *work)
 {
-	int ret;
-	size_t written_total = 0;
+	int err;
+	struct priv_storage_msg msg = { .type = STORAGE_BACKEND_SYNC };
 
-	while (written_total < len) {
-		ret = k_pipe_write(pipe, buf + written_total, len - written_total, timeout);
-		if (ret < 0) {
-			return ret;
-		}
+	ARG_UNUSED(work);
 
-		if (ret == 0) {
-			return -EAGAIN;
-		}
+	err = zbus_chan_pub(&priv_storage_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish backend sync message: %d", err);
+	}
+}
 
-		written_total += (size_t)ret;
+/* Schedule a backend sync, unless one is already pending. Called after every change to the
+ * stored data, so the delay is an upper bound on how long a change stays unsynced.
+ */
+static void schedule_backend_sync(void)
+{
+	if (storage_backend_get()->sync == NULL) {
+		return;
 	}
 
-	return (int)written_total;
+	(void)k_work_schedule(&backend_sync_work, K_SECONDS(CONFIG_APP_STORAGE_SYNC_DELAY_SECONDS));
 }
 
-/*
- * Read exact number of bytes from pipe. The provided timeout is reused for each
- * attempt to keep logic simple and predictable.
- * Returns number of bytes read if successful, negative error code if failed.
- */
-static int pipe_read_exact(struct k_pipe *pipe,
-	uint8_t *buf,
-	size_t len,
-	k_timeout_t timeout)
+static void backend_sync(void)
 {
-	int ret;
-	size_t read_total = 0;
+	int err;
+	const struct storage_backend *backend = storage_backend_get();
 
-	while (read_total < len) {
-		ret = k_pipe_read(pipe, buf + read_total, len - read_total, timeout);
-		if (ret < 0) {
-			return ret;
-		}
+	if (backend->sync == NULL) {
+		return;
+	}
 
-		if (ret == 0) {
-			return -EAGAIN;
-		}
+	(void)k_work_cancel_delayable(&backend_sync_work);
 
-		read_total += (size_t)ret;
+	err = backend->sync();
+	if (err) {
+		LOG_ERR("Failed to sync storage backend, error: %d", err);
 	}
+}
+
 
-	return (int)read_total;
+static void backend_persist(void)
+{
+	int err;
+	const struct storage_backend *backend = storage_backend_get();
+
+	if (backend->persist == NULL) {
+		backend_sync();
+
+		return;
+	}
+
+	(void)k_work_cancel_delayable(&backend_sync_work);
+
+	err = backend->persist();
+	if (err) {
+		LOG_ERR("Failed to persist stored data, error: %d", err);
+	}
 }
 
 static void check_and_notify_buffer_threshold(const struct storage_state *state_object,
@@ -334,13 +405,113 @@ static void check_and_notify_buffer_threshold(const struct storage_state *state_
 	}
 }
 
-static void handle_data_message(const struct storage_state *state_object,
+#if defined(CONFIG_APP_STORAGE_THINNING)
+/* Number of records of a type that triggers thinning */
+#define THINNING_THRESHOLD	MAX(2, (CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE *	\
+				CONFIG_APP_STORAGE_THINNING_THRESHOLD_PERCENT) / 100)
+
+/* Drop every second record of the older half of the records of a type.
+ *
+ * The records of the older half that are kept are moved in place towards the newer half,
+ * and the records in front of them are then removed from the oldest end. The newer half is
+ * not written, and no record is stored again. Moves start with the newest kept record, so a
+ * slot is only overwritten once its record has been moved or if its record is dropped. A
+ * failure or a reset in the middle of a pass can leave duplicates of old records, but never
+ * loses a record that is kept. Repeated passes thin the oldest records again, so that their
+ * density halves with every pass.
+ */
+static void thin_records(const struct storage_data *type)
+{
+	static uint8_t data[STORAGE_MAX_DATA_SIZE];
+	const struct storage_backend *backend = storage_backend_get();
+	int count = backend->count(type);
+	int older;
+	int dropped;
+	int ret;
+
+	if (count < 0) {
+		LOG_ERR("Failed to get count for %s, error: %d", type->name, count);
+		return;
+	}
+
+	/* Record 2 * i of the older half moves to position dropped + i */
+	older = count / 2;
+	dropped = older / 2;
+
+	for (int i = older - dropped - 1; i >= 0; i--) {
+		if ((2 * i) == (dropped + i)) {
+			continue;
+		}
+
+		ret = backend->peek(type, 2 * i, data, sizeof(data));
+		if (ret < 0) {
+			LOG_ERR("Failed to peek %s data for thinning, error: %d", type->name, ret);
+			return;
+		}
+
+		ret = backend->replace(type, dropped + i, data, type->data_size);
+		if (ret) {
+			LOG_ERR("Failed to move thinned %s data, error: %d", type->name, ret);
+			return;
+		}
+	}
+
+	for (int i = 0; i < dropped; i++) {
+		ret = backend->retrieve(type, data, sizeof(data));
+		if (ret < 0) {
+			LOG_ERR("Failed to drop thinned %s data, error: %d", type->name, ret);
+			return;
+		}
+	}
+
+	LOG_INF("Thinned %s records from %d to %d", type->name, count, count - dropped);
+}
+#endif /* CONFIG_APP_STORAGE_THINNING */
+
+/* The oldest record of a type was overwritten by a new record while a batch session is active.
+ * The records the session refers to by index have moved one position towards the oldest end.
+ */
+static void session_oldest_dropped(struct pipe_session *session, const struct storage_data *type)
+{
+	size_t *in_flight = &session->in_flight[type->data_type];
+
+	/* The next item to hand out has moved, or is gone */
+	session->next_timestamp_valid[type->data_type] = false;
+
+	if (!session->query) {
+		/* The dropped record was the oldest item handed out, if any was */
+		if (*in_flight > 0) {
+			(*in_flight)--;
+			session->dropped[type->data_type]++;
+		}
+
+		return;
+	}
+
+	if (session->first[type->data_type] > 0) {
+		session->first[type->data_type]--;
+	} else if (session->selected[type->data_type] > 0) {
+		/* The dropped record was selected, it is handed out last when newest_first */
+		size_t position = session->newest_first ?
+				  (session->selected[type->data_type] - 1) : 0;
+
+		if (position < *in_flight) {
+			(*in_flight)--;
+		}
+
+		session->selected[type->data_type]--;
+	}
+}
+
+static void handle_data_message(struct storage_state *state_object,
 				const struct storage_data *type,
 				const uint8_t *buf)
 {
 	int err;
+	int count = 0;
 	uint8_t data[STORAGE_MAX_DATA_SIZE];
 	const struct storage_backend *backend = storage_backend_get();
+	struct pipe_session *session = &state_object->current_session;
 
 	LOG_DBG("Handle data message for %s", type->name);
 
@@ -350,20 +521,45 @@ static void handle_data_message(const struct storage_state *state_object,
 
 	type->extract_data(buf, (void *)data);
 
+	/* A full backend overwrites the oldest record, which the session may refer to */
+	if (session->session_id != 0) {
+		count = backend->count(type);
+	}
+
 	err = backend->store(type, (const void *)data, type->data_size);
 	if (err) {
 		LOG_ERR("Failed to store %s data, error: %d", type->name, err);
 	}
 
+	/* The oldest record can be dropped even if storing the new one failed afterwards */
+	if (count > 0) {
+		int expected = err ? count : (count + 1);
+		int now = backend->count(type);
+
+		if ((now >= 0) && (now < expected)) {
+			session_oldest_dropped(session, type);
+		}
+	}
+
+#if defined(CONFIG_APP_STORAGE_THINNING)
+	/* Thinning moves records around, so it waits while a batch session refers to them */
+	if (type->thin && (backend->replace != NULL) &&
+	    (state_object->current_session.session_id == 0) &&
+	    (backend->count(type) >= THINNING_THRESHOLD)) {
+		thin_records(type);
+	}
+#endif /* CONFIG_APP_STORAGE_THINNING */
+
+	schedule_backend_sync();
+
 	check_and_notify_buffer_threshold(state_object, type);
 }
 
 static void flush_stored_data(void)
 {
 	int count;
-	struct storage_msg msg = {0};
+	struct storage_data_msg msg = {0};
 	const struct storage_backend *backend = storage_backend_get();
-	uint8_t data[STORAGE_MAX_DATA_SIZE];
 
 	STRUCT_SECTION_FOREACH(storage_data, type) {
 		count = backend->count(type);
@@ -380,17 +576,15 @@ static void flush_stored_data(void)
 			msg.type = STORAGE_DATA;
 			msg.data_type = type->data_type;
 
-			ret = backend->retrieve(type, data, sizeof(data));
+			ret = backend->retrieve(type, msg.buffer, sizeof(msg.buffer));
 			if (ret < 0) {
 				LOG_ERR("Failed to retrieve %s data, error: %d", type->name, ret);
 				break;
 			}
 
-			__ASSERT_NO_MSG(ret <= sizeof(data));
+			__ASSERT_NO_MSG(ret <= sizeof(msg.buffer));
 			__ASSERT_NO_MSG(ret == type->data_size);
 
-			memcpy((void *)msg.buffer, data, ret);
-
 			msg.data_len = (uint16_t)ret;
 
 			ret = zbus_chan_pub(&storage_data_chan, &msg, PUB_TIMEOUT);
@@ -402,6 +596,8 @@ static void flush_stored_data(void)
 			count--;
 		}
 	}
+
+	backend_sync();
 }
 
 static void storage_clear(void)
@@ -431,14 +627,26 @@ static void update_threshold(struct storage_state *state_object, uint32_t new_th
 	state_object->buffer_threshold_limit = new_threshold;
 }
 
-/* Drain any remaining data from the pipe */
+/* Report the batch items in use, queued or claimed by the consumer */
+static void pipe_mem_stats_update(void)
+{
+	mem_stats_buffer_update(MEM_STATS_BUFFER_GET(storage_pipe),
+				k_mem_slab_num_used_get(&storage_batch_slab) *
+				sizeof(struct storage_data_item));
+}
+
+/* Release all items that have not been claimed by the consumer */
 static void drain_pipe(void)
 {
-	uint8_t dummy_buffer[64];
+	struct storage_data_item *item;
 
-	while (k_pipe_read(&storage_pipe, dummy_buffer, sizeof(dummy_buffer), K_NO_WAIT) > 0) {
-		/* Drain pipe */
+	while (k_msgq_get(&storage_batch_queue, &item, K_NO_WAIT) == 0) {
+		k_mem_slab_free(&storage_batch_slab, (void *)item);
 	}
+
+	pipe_mem_stats_update();
+
+	atomic_clear(&pipe_refill_pending);
 }
 
 /* Send batch response message with session_id and optional data_len */
@@ -481,64 +689,207 @@ static void send_batch_available_response(uint32_t session_id, size_t item_count
 	send_batch_response(STORAGE_BATCH_AVAILABLE, session_id, item_count);
 }
 
-/* Populate the pipe with the next pending item.
+/* Get the index of the next item of a type to hand out in the current session.
  *
- * Peeks the head item of the first non-empty type and writes it to the pipe.
- * The item is NOT removed from the backend; that only happens on STORAGE_BATCH_CONSUME.
+ * @return 0 on success
+ * @return -ENODATA if all items of the type are handed out
+ * @return -EIO if the items could not be counted
+ */
+static int pipe_next_index(const struct pipe_session *session, const struct storage_data *type,
+			   size_t *index)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	size_t in_flight = session->in_flight[type->data_type];
+	size_t available;
+
+	if (session->query) {
+		available = session->selected[type->data_type];
+	} else {
+		int count = backend->count(type);
+
+		if (count < 0) {
+			LOG_ERR("Failed to get count for %s, error: %d", type->name, count);
+			return -EIO;
+		}
+
+		available = (size_t)count;
+	}
+
+	if (in_flight >= available) {
+		return -ENODATA;
+	}
+
+	if (!session->query) {
+		*index = in_flight;
+	} else if (session->newest_first) {
+		*index = session->first[type->data_type] + available - 1 - in_flight;
+	} else {
+		*index = session->first[type->data_type] + in_flight;
+	}
+
+	return 0;
+}
+
+/* Get the timestamp of the next item of a type. It is peeked once and kept until the item is
+ * handed out, so that each merge step only peeks the type that was handed out last.
  *
- * @return 0 on success (one item written to pipe)
+ * @return 0 on success
+ * @return -EIO on peek error
+ */
+static int pipe_next_timestamp(struct pipe_session *session, const struct storage_data *type,
+			       size_t index, int64_t *timestamp)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	uint8_t data[STORAGE_MAX_DATA_SIZE];
+	int ret;
+
+	if (!session->next_timestamp_valid[type->data_type]) {
+		ret = backend->peek(type, index, data, sizeof(data));
+		if (ret < 0) {
+			LOG_ERR("Failed to peek %s data: %d", type->name, ret);
+			return -EIO;
+		}
+
+		session->next_timestamp[type->data_type] = type->get_timestamp(data);
+		session->next_timestamp_valid[type->data_type] = true;
+	}
+
+	*timestamp = session->next_timestamp[type->data_type];
+
+	return 0;
+}
+
+/* Hand the next pending item to the consumer.
+ *
+ * The types are merged by timestamp: of the next items of all types that have items left,
+ * the oldest is handed out, or the newest in query sessions with newest_first. Items with the
+ * same timestamp are handed out in type registration order. The item is peeked into a free
+ * batch item and queued for the consumer. It is NOT removed from the backend; that only
+ * happens on STORAGE_BATCH_CONSUME or STORAGE_BATCH_CONSUME_N.
+ *
+ * @return 0 on success (one item queued)
  * @return -ENODATA if no items are available across all types
- * @return -EIO on peek or pipe write error
+ * @return -ENOSPC if all batch items are in use at the moment
+ * @return -EIO on peek error
  */
-static int populate_pipe(struct storage_state *state_object)
+static int pipe_write_next_item(struct storage_state *state_object)
 {
 	const struct storage_backend *backend = storage_backend_get();
+	struct pipe_session *session = &state_object->current_session;
+	const struct storage_data *next = NULL;
+	size_t next_index = 0;
+	int64_t next_timestamp = 0;
+	struct storage_data_item *item;
+	int ret;
 
 	STRUCT_SECTION_FOREACH(storage_data, type) {
-		int ret;
-		uint8_t item_buffer[sizeof(struct storage_pipe_header) + STORAGE_MAX_DATA_SIZE];
-		struct storage_pipe_header *header = (struct storage_pipe_header *)item_buffer;
-		uint8_t *data = item_buffer + sizeof(struct storage_pipe_header);
-		size_t total_size;
-
-		/* Peek the head item */
-		ret = backend->peek(type, data, STORAGE_MAX_DATA_SIZE);
-		if (ret == -EAGAIN) {
-			/* No items of this type, try next */
+		size_t index;
+		int64_t timestamp;
+
+		ret = pipe_next_index(session, type, &index);
+		if (ret == -ENODATA) {
+			/* All items of this type are handed out, try next */
 			continue;
 		} else if (ret < 0) {
-			LOG_ERR("Failed to peek %s data: %d", type->name, ret);
-			return -EIO;
+			return ret;
 		}
 
-		if (ret > UINT16_MAX) {
-			LOG_ERR("Peek returned oversized item for %s: %d", type->name, ret);
-			return -EIO;
+		if (next == NULL) {
+			next = type;
+			next_index = index;
+
+			continue;
 		}
 
-		header->type = (uint8_t)type->data_type;
-		header->data_size = (uint16_t)ret;
-		total_size = sizeof(struct storage_pipe_header) + (size_t)ret;
+		/* Timestamps are only needed once there is more than one type to merge */
+		ret = pipe_next_timestamp(session, next, next_index, &next_timestamp);
+		if (ret < 0) {
+			return ret;
+		}
 
-		ret = pipe_write_all(&storage_pipe, item_buffer, total_size, PUB_TIMEOUT);
+		ret = pipe_next_timestamp(session, type, index, &timestamp);
 		if (ret < 0) {
-			LOG_ERR("Unexpected pipe write failure: %d", ret);
-			return -EIO;
+			return ret;
 		}
 
-		LOG_DBG("Pipe populated for session 0x%X: with %s item (%zu bytes)",
-			state_object->current_session.session_id,
-			type->name, total_size);
+		if (session->newest_first ? (timestamp > next_timestamp) :
+					    (timestamp < next_timestamp)) {
+			next = type;
+			next_index = index;
+		}
+	}
 
-		return 0;
+	if (next == NULL) {
+		return -ENODATA;
+	}
+
+	if (k_mem_slab_alloc(&storage_batch_slab, (void **)&item, K_NO_WAIT)) {
+		return -ENOSPC;
+	}
+
+	pipe_mem_stats_update();
+
+	/* Peek the next item of this type that is not already handed out */
+	ret = backend->peek(next, next_index, &item->data, sizeof(item->data));
+	if (ret < 0) {
+		LOG_ERR("Failed to peek %s data: %d", next->name, ret);
+		k_mem_slab_free(&storage_batch_slab, (void *)item);
+		pipe_mem_stats_update();
+
+		return -EIO;
+	}
+
+	item->type = next->data_type;
+
+	/* Cannot fail, the queue has room for every slab block */
+	ret = k_msgq_put(&storage_batch_queue, &item, K_NO_WAIT);
+	__ASSERT_NO_MSG(ret == 0);
+
+	session->in_flight[next->data_type]++;
+	session->next_timestamp_valid[next->data_type] = false;
+
+	LOG_DBG("Pipe populated for session 0x%X: with %s item (%zu bytes)",
+		session->session_id, next->name, next->data_size);
+
+	return 0;
+}
+
+/* Populate the pipe with as many pending items as fit in it.
+ *
+ * @return 0 if at least one item is queued or more items are waiting for space
+ * @return -ENODATA if no items are available across all types and none are queued
+ * @return -EIO on peek or pipe write error
+ */
+static int populate_pipe(struct storage_state *state_object)
+{
+	int ret;
+	size_t items_written = 0;
+
+	do {
+		ret = pipe_write_next_item(state_object);
+		if (ret == 0) {
+			items_written++;
+		}
+	} while (ret == 0);
+
+	if (ret == -EIO) {
+		return ret;
 	}
 
-	return -ENODATA;
+	LOG_DBG("Prefetched %zu items, %u queued", items_written,
+		k_msgq_num_used_get(&storage_batch_queue));
+
+	if ((ret == -ENODATA) && (k_msgq_num_used_get(&storage_batch_queue) == 0)) {
+		return -ENODATA;
+	}
+
+	return 0;
 }
 
-/* Consume the confirmed-sent item from the backend and peek the next one into the pipe. */
+/* Consume the oldest confirmed-sent item(s) of the given type from the backend. */
 static bool handle_batch_consume(struct storage_state *state_object,
-				 const struct storage_msg *msg)
+				 const struct storage_msg *msg,
+				 uint32_t item_count)
 {
 	const struct storage_backend *backend = storage_backend_get();
 	uint8_t discard[STORAGE_MAX_DATA_SIZE];
@@ -550,21 +901,49 @@ static bool handle_batch_consume(struct storage_state *state_object,
 		return false;
 	}
 
-	/* Remove the confirmed-sent item from the backend queue head */
+	if (state_object->current_session.query) {
+		LOG_WRN("CONSUME in read-only query session 0x%X, ignoring", msg->session_id);
+
+		/* Still counts as session activity */
+		return true;
+	}
+
+	/* Remove the confirmed-sent items from the backend queue head */
 	bool type_matched = false;
 
 	STRUCT_SECTION_FOREACH(storage_data, type) {
 		if (type->data_type == msg->data_type) {
+			size_t *in_flight =
+				&state_object->current_session.in_flight[type->data_type];
+			size_t *dropped =
+				&state_object->current_session.dropped[type->data_type];
+
 			type_matched = true;
-			ret = backend->retrieve(type, discard, sizeof(discard));
-			if (ret < 0) {
-				LOG_ERR("Failed to consume item (type %d): %d, aborting session",
-					msg->data_type, ret);
-				send_batch_error_response(msg->session_id);
-				smf_set_state(SMF_CTX(state_object), &states[STATE_BUFFER_IDLE]);
-				return false;
+
+			for (uint32_t i = 0; i < item_count; i++) {
+				/* Already overwritten by a newer record, nothing to remove */
+				if (*dropped > 0) {
+					(*dropped)--;
+					continue;
+				}
+
+				ret = backend->retrieve(type, discard, sizeof(discard));
+				if (ret < 0) {
+					LOG_ERR("Failed to consume item (type %d): %d, "
+						"aborting session", msg->data_type, ret);
+					send_batch_error_response(msg->session_id);
+					smf_set_state(SMF_CTX(state_object),
+						      &states[STATE_BUFFER_IDLE]);
+					return false;
+				}
+
+				if (*in_flight > 0) {
+					(*in_flight)--;
+				}
 			}
-			LOG_DBG("Consumed %s item from backend", type->name);
+
+			LOG_DBG("Consumed %u %s item(s) from backend", item_count, type->name);
+			schedule_backend_sync();
 			break;
 		}
 	}
@@ -576,15 +955,107 @@ static bool handle_batch_consume(struct storage_state *state_object,
 		return false;
 	}
 
-	/* Peek the next item into the pipe for the consumer */
+	return true;
+}
+
+/* The consumer has released enough batch items, top up the queue again. */
+static void handle_batch_pipe_refill(struct storage_state *state_object)
+{
+	int ret;
+
+	atomic_clear(&pipe_refill_pending);
+
 	ret = populate_pipe(state_object);
 	if (ret == -ENODATA) {
-		LOG_DBG("All items consumed, pipe empty");
+		LOG_DBG("All items handed out, pipe empty");
 	} else if (ret < 0) {
-		LOG_ERR("Failed to populate pipe after consume: %d", ret);
+		LOG_ERR("Failed to populate pipe on refill: %d", ret);
 	}
+}
 
-	return true;
+/* Get the index of the first record of a type with a timestamp at or after the given time.
+ * Uses the lookup of the backend when it has one, otherwise a binary search with peek.
+ *
+ * @return Index of the record, the number of records if none is that recent,
+ *	   or negative errno on failure
+ */
+static int find_first_since(const struct storage_data *type, int64_t since, int count)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	uint8_t data[STORAGE_MAX_DATA_SIZE];
+	size_t low = 0;
+	size_t high = (size_t)count;
+
+	if (since <= 0) {
+		return 0;
+	}
+
+	if (backend->find) {
+		return backend->find(type, since);
+	}
+
+	while (low < high) {
+		size_t mid = low + ((high - low) / 2);
+		int ret = backend->peek(type, mid, data, sizeof(data));
+
+		if (ret < 0) {
+			LOG_ERR("Failed to peek %s data: %d", type->name, ret);
+			return ret;
+		}
+
+		if (type->get_timestamp(data) < since) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	return (int)low;
+}
+
+/* Select the records of each type that match the query of a STORAGE_BATCH_QUERY message.
+ *
+ * @return Total number of selected records, or negative errno on failure
+ */
+static int select_query_records(struct pipe_session *session,
+				const struct storage_msg *request_msg)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	const struct storage_query *query = &request_msg->query;
+	size_t total_items = 0;
+
+	session->query = true;
+	session->newest_first = query->newest_first;
+
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		int count;
+		int first;
+
+		if ((request_msg->data_type != STORAGE_DATA_ALL) &&
+		    (request_msg->data_type != type->data_type)) {
+			continue;
+		}
+
+		count = backend->count(type);
+		if (count <= 0) {
+			continue;
+		}
+
+		first = find_first_since(type, query->since, count);
+		if (first < 0) {
+			return first;
+		}
+
+		if ((query->max_items > 0) && ((count - first) > (int)query->max_items)) {
+			first = count - (int)query->max_items;
+		}
+
+		session->first[type->data_type] = (size_t)first;
+		session->selected[type->data_type] = (size_t)(count - first);
+		total_items += session->selected[type->data_type];
+	}
+
+	return (int)total_items;
 }
 
 /* Start a new batch session.
@@ -604,12 +1075,30 @@ static int start_batch_session(struct storage_state *state_object,
 		return -EINVAL;
 	}
 
-	/* Count total items available */
-	STRUCT_SECTION_FOREACH(storage_data, type) {
-		int count = backend->count(type);
+	/* Clear any stale data from pipe before starting new session */
+	drain_pipe();
+
+	/* Start new session using requester's session ID */
+	memset(&state_object->current_session, 0, sizeof(state_object->current_session));
+	state_object->current_session.session_id = request_msg->session_id;
+
+	if (request_msg->type == STORAGE_BATCH_QUERY) {
+		err = select_query_records(&state_object->current_session, request_msg);
+		if (err < 0) {
+			LOG_ERR("Failed to select records for query: %d", err);
 
-		if (count > 0) {
-			total_items += count;
+			return err;
+		}
+
+		total_items = (size_t)err;
+	} else {
+		/* Count total items available */
+		STRUCT_SECTION_FOREACH(storage_data, type) {
+			int count = backend->count(type);
+
+			if (count > 0) {
+				total_items += count;
+			}
 		}
 	}
 
@@ -617,11 +1106,6 @@ static int start_batch_session(struct storage_state *state_object,
 		return -ENODATA;
 	}
 
-	/* Clear any stale data from pipe before starting new session */
-	drain_pipe();
-
-	/* Start new session using requester's session ID */
-	state_object->current_session.session_id = request_msg->session_id;
 	state_object->current_session.total_items = total_items;
 
 	/* Try to populate the pipe */
@@ -633,7 +1117,7 @@ static int start_batch_session(struct storage_state *state_object,
 		return err;
 	}
 
-	/* Success, one item in pipe, report total available to consumer */
+	/* Success, pipe primed, report total available to consumer */
 	send_batch_available_response(request_msg->session_id, total_items);
 
 	LOG_DBG("Started batch session (session_id 0x%X), %zu items in batch",
@@ -643,58 +1127,72 @@ static int start_batch_session(struct storage_state *state_object,
 	return 0;
 }
 
-/* New API: Read one item from storage batch */
-int storage_batch_read(struct storage_data_item *out_item, k_timeout_t timeout)
+int storage_batch_claim(const struct storage_data_item **item, k_timeout_t timeout)
 {
-	struct storage_pipe_header header;
+	struct storage_data_item *claimed;
 	int ret;
 
-	if (!out_item) {
+	if (!item) {
 		return -EINVAL;
 	}
 
 	/* Session validation is implicit - if there's no active session,
-	 * the pipe will be empty and this function will return -EAGAIN.
+	 * the queue will be empty and this function will return -EAGAIN.
 	 */
-
-	/* First, try to read just the header to get the data size */
-	ret = pipe_read_exact(&storage_pipe, (uint8_t *)&header,
-			       sizeof(header), timeout);
-	if (ret < 0) {
-		return ret;  /* -EAGAIN (no data in timeout) or other error */
+	ret = k_msgq_get(&storage_batch_queue, &claimed, timeout);
+	if (ret == -ENOMSG) {
+		return -EAGAIN;
+	} else if (ret) {
+		return ret; /* -EAGAIN (no data in timeout) or other error */
 	}
 
-	if (ret != sizeof(header)) {
-		LOG_ERR("Incomplete header read: %d/%zu bytes",
-			ret, sizeof(header));
-		return -EIO;
-	}
+	LOG_DBG("Claimed storage item: type=%u", claimed->type);
 
-	/* Validate header */
-	if ((size_t)header.data_size > sizeof(out_item->data)) {
-		LOG_ERR("Data size too large: %u > %zu",
-			header.data_size, sizeof(out_item->data));
-		return -EMSGSIZE;
+	*item = claimed;
+
+	return 0;
+}
+
+void storage_batch_release(const struct storage_data_item *item)
+{
+	int err;
+	struct priv_storage_msg refill_msg = { .type = STORAGE_BATCH_PIPE_REFILL };
+
+	__ASSERT_NO_MSG(item != NULL);
+
+	k_mem_slab_free(&storage_batch_slab, (void *)item);
+	pipe_mem_stats_update();
+
+	/* Let the storage thread top up the batch while the consumer processes the items
+	 * that are left, but only request it once until the refill has been handled.
+	 */
+	if ((k_mem_slab_num_free_get(&storage_batch_slab) >= PIPE_REFILL_LEVEL) &&
+	    atomic_cas(&pipe_refill_pending, 0, 1)) {
+		err = zbus_chan_pub(&priv_storage_chan, &refill_msg, PUB_TIMEOUT);
+		if (err) {
+			LOG_ERR("Failed to publish pipe refill message: %d", err);
+			SEND_FATAL_ERROR();
+		}
 	}
+}
 
-	/* Read the data portion */
-	ret = pipe_read_exact(&storage_pipe, (uint8_t *)&out_item->data,
-			  (size_t)header.data_size, timeout);
-	if (ret < 0) {
-		LOG_ERR("Failed to read data from pipe: %d", ret);
-		return ret;
+int storage_batch_read(struct storage_data_item *out_item, k_timeout_t timeout)
+{
+	const struct storage_data_item *item;
+	int ret;
+
+	if (!out_item) {
+		return -EINVAL;
 	}
 
-	if (ret != header.data_size) {
-		LOG_ERR("Incomplete data read: %d/%u bytes",
-			ret, header.data_size);
-		return -EIO;
+	ret = storage_batch_claim(&item, timeout);
+	if (ret) {
+		return ret;
 	}
 
-	/* Fill output structure */
-	out_item->type = header.type;
+	*out_item = *item;
 
-	LOG_DBG("Read storage item: type=%u, size=%u", header.type, header.data_size);
+	storage_batch_release(item);
 
 	/* Session will be closed via explicit STORAGE_BATCH_CLOSE messages */
 
@@ -712,6 +1210,7 @@ static void handle_storage_stats(void)
 	LOG_INF("Backend: %s: %s", backend ? "Available" : "Not available",
 		IS_ENABLED(CONFIG_APP_STORAGE_BACKEND_RAM)        ? "RAM"
 		: IS_ENABLED(CONFIG_APP_STORAGE_BACKEND_LITTLEFS) ? "LittleFS"
+		: IS_ENABLED(CONFIG_APP_STORAGE_BACKEND_TIERED)   ? "Tiered (RAM + LittleFS)"
 								  : "Unknown");
 	if (!backend) {
 		LOG_ERR("No storage backend available");
@@ -771,12 +1270,19 @@ static enum smf_state_result state_running_run(void *o)
 		case STORAGE_CLEAR:
 			/* Clear all stored data */
 			storage_clear();
+
+			/* Clearing rewrites all backend state, nothing is left to sync */
+			(void)k_work_cancel_delayable(&backend_sync_work);
 			break;
 
 		case STORAGE_FLUSH:
 			flush_stored_data();
 			break;
 
+		case STORAGE_PERSIST:
+			backend_persist();
+			break;
+
 		case STORAGE_SET_THRESHOLD:
 			/* Update buffer threshold limit */
 			update_threshold(state_object, msg->data_len);
@@ -793,6 +1299,17 @@ static enum smf_state_result state_running_run(void *o)
 		}
 	}
 
+	if (state_object->chan == &priv_storage_chan) {
+		const struct priv_storage_msg *priv_msg =
+			(const struct priv_storage_msg *)state_object->msg_buf;
+
+		if (priv_msg->type == STORAGE_BACKEND_SYNC) {
+			backend_sync();
+
+			return SMF_EVENT_HANDLED;
+		}
+	}
+
 	/* Check if message is from a registered data type */
 	STRUCT_SECTION_FOREACH(storage_data, type) {
 		if (state_object->chan == type->chan) {
@@ -812,7 +1329,8 @@ static enum smf_state_result state_buffer_idle_run(void *o)
 
 	LOG_DBG("%s", __func__);
 
-	if (state_object->chan == &storage_chan && msg->type == STORAGE_BATCH_REQUEST) {
+	if ((state_object->chan == &storage_chan) &&
+	    ((msg->type == STORAGE_BATCH_REQUEST) || (msg->type == STORAGE_BATCH_QUERY))) {
 		LOG_DBG("Batch request received, switching to batch active state");
 		/* Set up session ID for the upcoming batch session */
 		state_object->current_session.session_id = msg->session_id;
@@ -879,13 +1397,28 @@ static enum smf_state_result state_buffer_pipe_active_run(void *o)
 			return SMF_EVENT_HANDLED;
 
 		case STORAGE_BATCH_CONSUME:
-			if (handle_batch_consume(state_object, msg)) {
+			if (handle_batch_consume(state_object, msg, 1)) {
+				k_work_reschedule(&state_object->session_timeout_work,
+						  K_SECONDS(STORAGE_SESSION_TIMEOUT_SECONDS));
+			}
+			return SMF_EVENT_HANDLED;
+
+		case STORAGE_BATCH_CONSUME_N:
+			if (msg->data_len == 0) {
+				LOG_WRN("CONSUME_N with zero items, ignoring");
+
+				return SMF_EVENT_HANDLED;
+			}
+
+			if (handle_batch_consume(state_object, msg, msg->data_len)) {
 				k_work_reschedule(&state_object->session_timeout_work,
 						  K_SECONDS(STORAGE_SESSION_TIMEOUT_SECONDS));
 			}
 			return SMF_EVENT_HANDLED;
 
-		case STORAGE_BATCH_REQUEST: {
+		case STORAGE_BATCH_REQUEST:
+			__fallthrough;
+		case STORAGE_BATCH_QUERY: {
 			int err;
 
 			LOG_DBG("Batch request received, session_id: 0x%X", msg->session_id);
@@ -952,6 +1485,16 @@ static enum smf_state_result state_buffer_pipe_active_run(void *o)
 
 			return SMF_EVENT_HANDLED;
 		}
+
+		if (priv_msg->type == STORAGE_BATCH_PIPE_REFILL) {
+			handle_batch_pipe_refill(state_object);
+
+			/* Reset session timeout on activity */
+			k_work_reschedule(&state_object->session_timeout_work,
+					  K_SECONDS(STORAGE_SESSION_TIMEOUT_SECONDS));
+
+			return SMF_EVENT_HANDLED;
+		}
 	}
 
 	return SMF_EVENT_PROPAGATE;
@@ -969,6 +1512,9 @@ static void state_buffer_pipe_active_exit(void *o)
 	/* Drain any remaining data from pipe */
 	drain_pipe();
 
+	/* Persist the items consumed during the session */
+	backend_sync();
+
 	/* Clear session state */
 	memset(&state_object->current_session, 0, sizeof(state_object->current_session));
 }
@@ -1006,6 +1552,7 @@ static void storage_thread(void)
 
 	/* Initialize the state machine */
 	smf_set_initial(SMF_CTX(&storage_state), &states[STATE_RUNNING]);
+	STATE_STATS_UPDATE(storage, SMF_CTX(&storage_state));
 
 	while (true) {
 		err = task_wdt_feed(task_wdt_id);
@@ -1027,13 +1574,19 @@ static void storage_thread(void)
 			return;
 		}
 
+		zbus_stats_received(&storage_subscriber, storage_state.chan);
+
+		HANDLER_STATS_START(storage, storage_state.chan);
 		err = smf_run_state(SMF_CTX(&storage_state));
+		HANDLER_STATS_END(storage);
 		if (err) {
 			LOG_ERR("smf_run_state(), error: %d", err);
 			SEND_FATAL_ERROR();
 
 			return;
 		}
+
+		STATE_STATS_UPDATE(storage, SMF_CTX(&storage_state));
 	}
 }
 
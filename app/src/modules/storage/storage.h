@@ -44,6 +44,15 @@ enum storage_msg_type {
 	 */
 	STORAGE_BATCH_REQUEST,
 
+	/* Command to request a read-only view of stored data using batch access.
+	 * Same as STORAGE_BATCH_REQUEST, but only the records selected by the `query` field
+	 * are handed out, and `data_type` selects a single type or STORAGE_DATA_ALL.
+	 * Records are not removed from storage, STORAGE_BATCH_CONSUME and
+	 * STORAGE_BATCH_CONSUME_N are ignored in query sessions.
+	 * The session must be closed with STORAGE_BATCH_CLOSE.
+	 */
+	STORAGE_BATCH_QUERY,
+
 	/* Consumer finished with batch session. */
 	STORAGE_BATCH_CLOSE,
 
@@ -52,6 +61,12 @@ enum storage_msg_type {
 	 */
 	STORAGE_STATS,
 
+	/* Command to move stored data held in RAM to persistent storage, for example before a
+	 * planned reboot or power-off. Only has an effect with backends that keep records in RAM
+	 * in front of flash, like the tiered backend.
+	 */
+	STORAGE_PERSIST,
+
 	/* Output messages */
 
 	/* Number of items in storage >= trigger limit.
@@ -67,10 +82,13 @@ enum storage_msg_type {
 	 * The `data_len` field contains the total number of items available.
 	 * The `session_id` field echoes back the session ID from the request.
 	 *
-	 * Call storage_batch_read() to read the next item from the batch. After the item
-	 * has been confirmed sent, publish STORAGE_BATCH_CONSUME (with the matching
-	 * `session_id` and `data_type`) to remove it from the backend and advance to the
-	 * next item. Reading without consuming will repeatedly return the same head item.
+	 * Call storage_batch_read() to read the next item from the batch. The storage module
+	 * prefetches as many items as fit in the batch buffer and tops it up as the consumer
+	 * reads. Reading an item does not remove anything from the backend.
+	 * After an item has been confirmed sent, publish STORAGE_BATCH_CONSUME (with the
+	 * matching `session_id` and `data_type`) to remove it from the backend. A consumer may
+	 * read several items ahead before confirming them. Items that are read but not
+	 * consumed when the session is closed are handed out again in the next session.
 	 */
 	STORAGE_BATCH_AVAILABLE,
 
@@ -88,11 +106,37 @@ enum storage_msg_type {
 	STORAGE_BATCH_BUSY,
 
 	/* Confirm that a batch item was successfully sent to cloud.
-	 * Must contain `data_type` identifying the type of the item just sent.
-	 * Storage removes the item from the backend queue head and makes the next
-	 * item available in the pipe. Only valid during an active batch session.
+	 * Must contain `data_type` identifying the type of the item that was sent.
+	 * Storage removes the oldest item of that type from the backend queue head.
+	 * Items must be consumed in the order they were read for each data type.
+	 * Only valid during an active batch session.
 	 */
 	STORAGE_BATCH_CONSUME,
+
+	/* Confirm that several batch items of the same type were successfully sent to cloud.
+	 * Same as STORAGE_BATCH_CONSUME, but removes the `data_len` oldest items of `data_type`
+	 * in one go. Only valid during an active batch session.
+	 */
+	STORAGE_BATCH_CONSUME_N,
+};
+
+/**
+ * @brief Selection of records for a STORAGE_BATCH_QUERY message
+ *
+ * Records are expected to be stored in timestamp order, which holds as long as all samples of
+ * a type use the same time base.
+ */
+struct storage_query {
+	/* Only records with a timestamp at or after this time, in milliseconds.
+	 * 0 selects records of any age.
+	 */
+	int64_t since;
+
+	/* Only the newest max_items records of each type. 0 selects any number of records. */
+	uint32_t max_items;
+
+	/* Hand out the records newest first instead of oldest first */
+	bool newest_first;
 };
 
 /**
@@ -104,26 +148,44 @@ struct storage_msg {
 	/* Type of message */
 	enum storage_msg_type type;
 
-	/* Type of data in buffer */
+	/* Type of data the message refers to */
 	enum storage_data_type data_type;
 
-	union {
-		/* Buffer for incoming data over the channels that the storage module is
-		 * subscribed to.
-		 */
-		uint8_t buffer[STORAGE_MAX_DATA_SIZE];
+	/* Session ID for batch operations */
+	uint32_t session_id;
 
-		/* Session ID for batch operations */
-		uint32_t session_id;
-	};
+	/* Records to hand out, only valid for STORAGE_BATCH_QUERY */
+	struct storage_query query;
 
 	/* Length/count field used by various message types:
+	 * - STORAGE_SET_THRESHOLD: new threshold
 	 * - STORAGE_BATCH_AVAILABLE: number of items available in batch
-	 * - STORAGE_DATA: size of flushed data
+	 * - STORAGE_BATCH_CONSUME_N: number of items to consume
 	 */
 	uint32_t data_len;
 };
 
+/**
+ * @brief Message structure for the storage data channel
+ *
+ * Only STORAGE_DATA messages carry a data buffer, so they have a channel of their own. This
+ * keeps the control messages on storage_chan small, and with them every zbus buffer that is
+ * allocated for a storage_chan subscriber.
+ */
+struct storage_data_msg {
+	/* Type of message, always STORAGE_DATA */
+	enum storage_msg_type type;
+
+	/* Type of data in buffer */
+	enum storage_data_type data_type;
+
+	/* Size of the data in buffer */
+	uint32_t data_len;
+
+	/* Stored data, in the message format of the channel that the data was received on */
+	uint8_t buffer[STORAGE_MAX_DATA_SIZE];
+};
+
 /**
  * @brief Structure to define a storage data item
  *
@@ -141,13 +203,44 @@ struct storage_data_item {
 };
 
 /**
- * @brief Read one item from storage batch (convenience function)
+ * @brief Claim the next item from storage batch without copying it
  *
- * @details This is the ONLY direct API function provided by the storage module.
- * It reads stored data through the batch interface, handling the header parsing
- * and data extraction automatically. All other operations (requesting batch access,
+ * @details Together with storage_batch_release() and storage_batch_read(), this is the only
+ * direct API provided by the storage module. All other operations (requesting batch access,
  * closing sessions, etc.) must go through zbus messages.
  *
+ * The returned item is read-only and stays valid until it is handed back with
+ * storage_batch_release(). Claimed items occupy the batch buffer, so they must be released
+ * as soon as they have been processed to let the storage module queue up more items.
+ *
+ * This function should only be called after receiving a STORAGE_BATCH_AVAILABLE
+ * message in response to a STORAGE_BATCH_REQUEST.
+ *
+ * @param item Pointer set to the claimed item on success
+ * @param timeout Maximum time to wait for data
+ *
+ * @retval 0 on success
+ * @retval -EAGAIN if no data became available within timeout
+ * @retval -EINVAL if item is NULL
+ */
+int storage_batch_claim(const struct storage_data_item **item, k_timeout_t timeout);
+
+/**
+ * @brief Release an item claimed with storage_batch_claim()
+ *
+ * Releasing an item does not remove it from storage, that is done with
+ * STORAGE_BATCH_CONSUME or STORAGE_BATCH_CONSUME_N.
+ *
+ * @param item Item returned by storage_batch_claim()
+ */
+void storage_batch_release(const struct storage_data_item *item);
+
+/**
+ * @brief Read one item from storage batch (convenience function)
+ *
+ * @details Copies the next item into the caller's buffer. Consumers that can process the
+ * item in place should use storage_batch_claim() and storage_batch_release() instead.
+ *
  * This function should only be called after receiving a STORAGE_BATCH_AVAILABLE
  * message in response to a STORAGE_BATCH_REQUEST.
  *
@@ -157,8 +250,6 @@ struct storage_data_item {
  * @retval 0 on success, data copied to out_item
  * @retval -EAGAIN if no data became available within timeout
  * @retval -EINVAL if out_item is NULL
- * @retval -EIO if data corruption detected
- * @retval -EMSGSIZE if data too large for buffer
  */
 int storage_batch_read(struct storage_data_item *out_item,
 		       k_timeout_t timeout);
@@ -41,11 +41,13 @@ struct storage_backend {
 	 * @brief Peek at data from the backend without removing it.
 	 *
 	 * @param type Storage data type to peek at
+	 * @param index Position of the record to peek at, counted from the oldest record (0)
 	 * @param data Buffer to store the peeked data (can be NULL to just get size)
 	 * @param size Size of the buffer
-	 * @return Number of bytes that would be read on success, negative errno on failure
+	 * @return Number of bytes that would be read on success, -EAGAIN if there is no
+	 *	   record at the given index, other negative errno on failure
 	 */
-	int (*peek)(const struct storage_data *type, void *data, size_t size);
+	int (*peek)(const struct storage_data *type, size_t index, void *data, size_t size);
 
 	/**
 	 * @brief Retrieve data from the backend.
@@ -57,6 +59,22 @@ struct storage_backend {
 	 */
 	int (*retrieve)(const struct storage_data *type, void *data, size_t size);
 
+	/**
+	 * @brief Overwrite a stored record in place.
+	 *
+	 * Optional, can be NULL. Used to thin out old records without storing the kept
+	 * records again. The order and number of records do not change.
+	 *
+	 * @param type Storage data type of the record
+	 * @param index Position of the record to overwrite, counted from the oldest record (0)
+	 * @param data Pointer to the new data
+	 * @param size Size of the data in bytes
+	 * @return 0 on success, -EAGAIN if there is no record at the given index, other
+	 *	   negative errno on failure
+	 */
+	int (*replace)(const struct storage_data *type, size_t index, const void *data,
+		       size_t size);
+
 	/**
 	 * @brief Get number of records of a specific type.
 	 *
@@ -65,17 +83,54 @@ struct storage_backend {
 	 */
 	int (*count)(const struct storage_data *type);
 
+	/**
+	 * @brief Find the oldest record at or after a point in time.
+	 *
+	 * Optional, can be NULL. The storage module then does a binary search with peek.
+	 * Records are expected to be stored in timestamp order.
+	 *
+	 * @param type Storage data type to search
+	 * @param timestamp Timestamp in milliseconds, see storage_data.get_timestamp
+	 * @return Index of the first record with a timestamp at or after @p timestamp,
+	 *	   the number of records if there is none, negative errno on failure
+	 */
+	int (*find)(const struct storage_data *type, int64_t timestamp);
+
 	/**
 	 * @brief Clear all stored data.
 	 *
 	 * @return 0 on success, negative errno on failure
 	 */
 	int (*clear)(void);
+
+	/**
+	 * @brief Write cached backend state to persistent storage.
+	 *
+	 * Optional, can be NULL for backends that do not cache state. Backends that do must
+	 * be able to recover records stored after the last sync on their own.
+	 *
+	 * @return 0 on success, negative errno on failure
+	 */
+	int (*sync)(void);
+
+	/**
+	 * @brief Move records held in volatile memory to persistent storage.
+	 *
+	 * Optional, can be NULL for backends that keep all records in the same medium.
+	 * Called before a planned reboot or power-off.
+	 *
+	 * @return 0 on success, negative errno on failure
+	 */
+	int (*persist)(void);
 };
 
 /* Get the active storage backend based on Kconfig selection */
 const struct storage_backend *storage_backend_get(void);
 
+/* Get the RAM and LittleFS backends, used directly by the tiered backend */
+const struct storage_backend *storage_backend_ram_get(void);
+const struct storage_backend *storage_backend_littlefs_get(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,10 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/zbus/zbus.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+#include <math.h>
 
 #include "storage.h"
 #include "storage_data_types.h"
@@ -22,6 +26,14 @@
 #include "location.h"
 #endif
 
+#ifdef CONFIG_APP_GEOFENCE
+#include "geofence.h"
+#endif
+
+#ifdef CONFIG_APP_STORAGE_TRACK_SIMPLIFICATION
+#include "storage_track.h"
+#endif
+
 /**
  * @brief Register all enabled data types with the storage module
  *
@@ -29,18 +41,38 @@
  * data source. For example, with CONFIG_APP_POWER enabled, it expands to:
  *
  * STORAGE_DATA_TYPE_ADD(battery, power_chan, struct power_msg, double,
- *			 battery_check, battery_extract)
+ *			 battery_check, battery_extract, struct storage_battery_record,
+ *			 battery_encode, battery_decode)
  *
  * This creates:
  * 1. Helper functions to process messages:
  *    - battery_should_store(): Filters battery messages
  *    - battery_extract_data(): Extracts battery percentage
+ *    - battery_encode_record()/battery_decode_record(): Convert to and from the compact record
  * 2. A storage_data struct in the iterable section:
  *    - Links the channel to its processing functions
  *    - Makes the type available to STRUCT_SECTION_FOREACH
  */
 DATA_SOURCE_LIST(STORAGE_DATA_TYPE_ADD)
 
+/* Helpers for the compact record encoding */
+static void timestamp_encode(int64_t timestamp, uint8_t out[STORAGE_RECORD_TIMESTAMP_SIZE])
+{
+	sys_put_le48((uint64_t)timestamp, out);
+}
+
+static int64_t timestamp_decode(const uint8_t in[STORAGE_RECORD_TIMESTAMP_SIZE])
+{
+	return sign_extend_64(sys_get_le48(in), 47);
+}
+
+static int32_t fixed_point_encode(double value, double scale, int32_t min, int32_t max)
+{
+	double scaled = round(value * scale);
+
+	return (int32_t)CLAMP(scaled, (double)min, (double)max);
+}
+
 /* Power module storage */
 #ifdef CONFIG_APP_POWER
 
@@ -54,6 +86,25 @@ void battery_extract(const struct power_msg *msg, struct power_msg *data)
 {
 	*data = *msg;
 }
+
+void battery_encode(const struct power_msg *data, struct storage_battery_record *record)
+{
+	timestamp_encode(data->timestamp, record->timestamp);
+	record->percentage = (uint16_t)fixed_point_encode(data->percentage, 100.0, 0, UINT16_MAX);
+	record->voltage_mv = (uint16_t)fixed_point_encode(data->voltage, 1000.0, 0, UINT16_MAX);
+	record->charging = data->charging ? 1 : 0;
+}
+
+void battery_decode(const struct storage_battery_record *record, struct power_msg *data)
+{
+	memset(data, 0, sizeof(*data));
+
+	data->type = POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE;
+	data->timestamp = timestamp_decode(record->timestamp);
+	data->percentage = record->percentage / 100.0;
+	data->voltage = record->voltage_mv / 1000.0;
+	data->charging = record->charging != 0;
+}
 #endif /* CONFIG_APP_POWER */
 
 /* Location module storage */
@@ -64,7 +115,16 @@ bool location_check(const struct location_msg *msg)
 {
 	switch (msg->type) {
 	case LOCATION_GNSS_DATA:
+#if defined(CONFIG_APP_GEOFENCE)
+		if (!geofence_location_store(msg)) {
+			return false;
+		}
+#endif /* CONFIG_APP_GEOFENCE */
+#if defined(CONFIG_APP_STORAGE_TRACK_SIMPLIFICATION)
+		return storage_track_add(msg);
+#else
 		__fallthrough;
+#endif /* CONFIG_APP_STORAGE_TRACK_SIMPLIFICATION */
 	case LOCATION_CLOUD_REQUEST:
 		return true;
 	default:
@@ -74,17 +134,189 @@ bool location_check(const struct location_msg *msg)
 
 void location_extract(const struct location_msg *msg, struct location_msg *data)
 {
+#if defined(CONFIG_APP_STORAGE_TRACK_SIMPLIFICATION)
+	/* The stored point can be a fix held back by the track simplification */
+	if (msg->type == LOCATION_GNSS_DATA) {
+		*data = *storage_track_point_get();
+
+		return;
+	}
+#endif /* CONFIG_APP_STORAGE_TRACK_SIMPLIFICATION */
+
 	*data = *msg;
 }
+
+static void cell_encode(const struct location_cell_info *cell,
+			struct storage_location_cell_record *record)
+{
+	record->id = cell->id;
+	record->mcc = (int16_t)cell->mcc;
+	record->mnc = (int16_t)cell->mnc;
+	record->tac = cell->tac;
+	record->timing_advance = cell->timing_advance;
+	record->earfcn = cell->earfcn;
+	record->rsrp = cell->rsrp;
+	record->rsrq = cell->rsrq;
+}
+
+static void cell_decode(const struct storage_location_cell_record *record,
+			struct location_cell_info *cell)
+{
+	cell->id = record->id;
+	cell->mcc = record->mcc;
+	cell->mnc = record->mnc;
+	cell->tac = record->tac;
+	cell->timing_advance = record->timing_advance;
+	cell->earfcn = record->earfcn;
+	cell->rsrp = record->rsrp;
+	cell->rsrq = record->rsrq;
+}
+
+static void cloud_request_encode(const struct location_cloud_request_data *request,
+				 struct storage_location_cloud_request_record *record)
+{
+	record->ncells_count = MIN(request->ncells_count, CONFIG_APP_LOCATION_NEIGHBOR_CELLS_MAX);
+	record->gci_cells_count = MIN(request->gci_cells_count,
+				      CONFIG_APP_LOCATION_NEIGHBOR_CELLS_MAX);
+	record->wifi_cnt = MIN(request->wifi_cnt, CONFIG_APP_LOCATION_WIFI_APS_MAX);
+
+	cell_encode(&request->current_cell, &record->current_cell);
+
+	for (size_t i = 0; i < record->ncells_count; i++) {
+		const struct location_neighbor_cell_info *ncell = &request->neighbor_cells[i];
+
+		record->neighbor_cells[i].earfcn = ncell->earfcn;
+		record->neighbor_cells[i].time_diff = ncell->time_diff;
+		record->neighbor_cells[i].phys_cell_id = ncell->phys_cell_id;
+		record->neighbor_cells[i].rsrp = ncell->rsrp;
+		record->neighbor_cells[i].rsrq = ncell->rsrq;
+	}
+
+	for (size_t i = 0; i < record->gci_cells_count; i++) {
+		cell_encode(&request->gci_cells[i], &record->gci_cells[i]);
+	}
+
+	memcpy(record->wifi_aps, request->wifi_aps,
+	       record->wifi_cnt * sizeof(struct location_wifi_ap_info));
+}
+
+static void cloud_request_decode(const struct storage_location_cloud_request_record *record,
+				 struct location_cloud_request_data *request)
+{
+	request->ncells_count = MIN(record->ncells_count, CONFIG_APP_LOCATION_NEIGHBOR_CELLS_MAX);
+	request->gci_cells_count = MIN(record->gci_cells_count,
+				       CONFIG_APP_LOCATION_NEIGHBOR_CELLS_MAX);
+	request->wifi_cnt = MIN(record->wifi_cnt, CONFIG_APP_LOCATION_WIFI_APS_MAX);
+
+	cell_decode(&record->current_cell, &request->current_cell);
+
+	for (size_t i = 0; i < request->ncells_count; i++) {
+		struct location_neighbor_cell_info *ncell = &request->neighbor_cells[i];
+
+		ncell->earfcn = record->neighbor_cells[i].earfcn;
+		ncell->time_diff = record->neighbor_cells[i].time_diff;
+		ncell->phys_cell_id = record->neighbor_cells[i].phys_cell_id;
+		ncell->rsrp = record->neighbor_cells[i].rsrp;
+		ncell->rsrq = record->neighbor_cells[i].rsrq;
+	}
+
+	for (size_t i = 0; i < request->gci_cells_count; i++) {
+		cell_decode(&record->gci_cells[i], &request->gci_cells[i]);
+	}
+
+	memcpy(request->wifi_aps, record->wifi_aps,
+	       request->wifi_cnt * sizeof(struct location_wifi_ap_info));
+}
+
+static void gnss_encode(const struct location_gnss_data *location,
+			struct storage_location_gnss_record *record)
+{
+	record->latitude = fixed_point_encode(location->latitude, 1e7, INT32_MIN, INT32_MAX);
+	record->longitude = fixed_point_encode(location->longitude, 1e7, INT32_MIN, INT32_MAX);
+	record->accuracy = location->accuracy;
+	record->altitude = location->altitude;
+	record->speed = location->speed;
+	record->heading = location->heading;
+	record->flags = location->flags;
+}
+
+static void gnss_decode(const struct storage_location_gnss_record *record,
+			struct location_gnss_data *location)
+{
+	location->latitude = record->latitude / 1e7;
+	location->longitude = record->longitude / 1e7;
+	location->accuracy = record->accuracy;
+	location->altitude = record->altitude;
+	location->speed = record->speed;
+	location->heading = record->heading;
+	location->flags = record->flags;
+}
+
+void location_encode(const struct location_msg *data, struct storage_location_record *record)
+{
+	memset(record, 0, sizeof(*record));
+
+	record->type = (uint8_t)data->type;
+	timestamp_encode(data->timestamp, record->timestamp);
+
+	switch (data->type) {
+	case LOCATION_GNSS_DATA:
+		gnss_encode(&data->gnss_data, &record->gnss_data);
+		break;
+	case LOCATION_CLOUD_REQUEST:
+		cloud_request_encode(&data->cloud_request, &record->cloud_request);
+		break;
+	default:
+		/* Other message types are not stored, see location_check() */
+		break;
+	}
+}
+
+void location_decode(const struct storage_location_record *record, struct location_msg *data)
+{
+	memset(data, 0, sizeof(*data));
+
+	data->type = (enum location_msg_type)record->type;
+	data->timestamp = timestamp_decode(record->timestamp);
+
+	switch (data->type) {
+	case LOCATION_GNSS_DATA:
+		gnss_decode(&record->gnss_data, &data->gnss_data);
+		break;
+	case LOCATION_CLOUD_REQUEST:
+		cloud_request_decode(&record->cloud_request, &data->cloud_request);
+		break;
+	default:
+		break;
+	}
+}
 #endif /* CONFIG_APP_LOCATION */
 
 /* Environmental module storage */
 #ifdef CONFIG_APP_ENVIRONMENTAL
 
+/* Pressure that was not read in the sensor profile, above the range of encoded values */
+#define PRESSURE_UNKNOWN UINT32_MAX
+
+static uint32_t pressure_encode(double pressure)
+{
+	if (isnan(pressure)) {
+		return PRESSURE_UNKNOWN;
+	}
+
+	return (uint32_t)fixed_point_encode(pressure, 100.0, 0, INT32_MAX);
+}
+
+static double pressure_decode(uint32_t pressure)
+{
+	return (pressure == PRESSURE_UNKNOWN) ? NAN : (pressure / 100.0);
+}
+
 /* Provide functions used by storage module to check and extract data */
 bool environmental_check(const struct environmental_msg *msg)
 {
-	return msg->type == ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE;
+	return (msg->type == ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE) ||
+	       (msg->type == ENVIRONMENTAL_SENSOR_SUMMARY);
 }
 
 void environmental_extract(const struct environmental_msg *msg,
@@ -92,4 +324,54 @@ void environmental_extract(const struct environmental_msg *msg,
 {
 	*data = *msg;
 }
+
+void environmental_encode(const struct environmental_msg *data,
+			  struct storage_environmental_record *record)
+{
+	timestamp_encode(data->timestamp, record->timestamp);
+	record->temperature = (int16_t)fixed_point_encode(data->temperature, 100.0,
+							  INT16_MIN, INT16_MAX);
+	record->humidity = (uint16_t)fixed_point_encode(data->humidity, 100.0, 0, UINT16_MAX);
+	record->pressure = pressure_encode(data->pressure);
+
+#if defined(CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER)
+	record->sample_count = (data->type == ENVIRONMENTAL_SENSOR_SUMMARY) ?
+			       MAX(data->sample_count, 1) : 0;
+	record->temperature_min = (int16_t)fixed_point_encode(data->temperature_range.min,
+							      100.0, INT16_MIN, INT16_MAX);
+	record->temperature_max = (int16_t)fixed_point_encode(data->temperature_range.max,
+							      100.0, INT16_MIN, INT16_MAX);
+	record->humidity_min = (uint16_t)fixed_point_encode(data->humidity_range.min, 100.0,
+							    0, UINT16_MAX);
+	record->humidity_max = (uint16_t)fixed_point_encode(data->humidity_range.max, 100.0,
+							    0, UINT16_MAX);
+	record->pressure_min = pressure_encode(data->pressure_range.min);
+	record->pressure_max = pressure_encode(data->pressure_range.max);
+#endif /* CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER */
+}
+
+void environmental_decode(const struct storage_environmental_record *record,
+			  struct environmental_msg *data)
+{
+	memset(data, 0, sizeof(*data));
+
+	data->type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE;
+	data->timestamp = timestamp_decode(record->timestamp);
+	data->temperature = record->temperature / 100.0;
+	data->humidity = record->humidity / 100.0;
+	data->pressure = pressure_decode(record->pressure);
+
+#if defined(CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER)
+	if (record->sample_count > 0) {
+		data->type = ENVIRONMENTAL_SENSOR_SUMMARY;
+		data->sample_count = record->sample_count;
+		data->temperature_range.min = record->temperature_min / 100.0;
+		data->temperature_range.max = record->temperature_max / 100.0;
+		data->humidity_range.min = record->humidity_min / 100.0;
+		data->humidity_range.max = record->humidity_max / 100.0;
+		data->pressure_range.min = pressure_decode(record->pressure_min);
+		data->pressure_range.max = pressure_decode(record->pressure_max);
+	}
+#endif /* CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER */
+}
 #endif /* CONFIG_APP_ENVIRONMENTAL */
@@ -24,6 +24,118 @@
 #include "location.h"
 #endif
 
+/* Size of the timestamp field in compact records. 48 bits of milliseconds cover both Unix time
+ * and uptime for several thousand years.
+ */
+#define STORAGE_RECORD_TIMESTAMP_SIZE	6
+
+/*
+ * Compact records.
+ *
+ * Persistent backends store these packed records instead of the raw data type. They only keep
+ * the fields the consumers use, in fixed-point where the precision allows it, so that a record
+ * is a fraction of the size of the zbus message it was extracted from. Records have a fixed size
+ * per type, which keeps indexed access into the record files O(1).
+ */
+#if IS_ENABLED(CONFIG_APP_POWER)
+struct storage_battery_record {
+	uint8_t timestamp[STORAGE_RECORD_TIMESTAMP_SIZE];
+
+	/* Battery charge in units of 0.01 % */
+	uint16_t percentage;
+
+	/* Battery voltage in mV */
+	uint16_t voltage_mv;
+
+	uint8_t charging;
+} __packed;
+#endif /* CONFIG_APP_POWER */
+
+#if IS_ENABLED(CONFIG_APP_ENVIRONMENTAL)
+struct storage_environmental_record {
+	uint8_t timestamp[STORAGE_RECORD_TIMESTAMP_SIZE];
+
+	/* Temperature in units of 0.01 degrees Celsius */
+	int16_t temperature;
+
+	/* Humidity in units of 0.01 % */
+	uint16_t humidity;
+
+	/* Pressure in units of 0.01 of the unit used in struct environmental_msg */
+	uint32_t pressure;
+
+#if defined(CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER)
+	/* Number of samples of an ENVIRONMENTAL_SENSOR_SUMMARY, 0 for a sample. The readings
+	 * above are the averages of a summary.
+	 */
+	uint16_t sample_count;
+
+	/* Extremes of a summary, in the units of the readings above */
+	int16_t temperature_min;
+	int16_t temperature_max;
+	uint16_t humidity_min;
+	uint16_t humidity_max;
+	uint32_t pressure_min;
+	uint32_t pressure_max;
+#endif /* CONFIG_APP_ENVIRONMENTAL_REPORT_FILTER */
+} __packed;
+#endif /* CONFIG_APP_ENVIRONMENTAL */
+
+#if IS_ENABLED(CONFIG_APP_LOCATION)
+struct storage_location_gnss_record {
+	/* Latitude and longitude in units of 1e-7 degrees */
+	int32_t latitude;
+	int32_t longitude;
+	float accuracy;
+	float altitude;
+	float speed;
+	float heading;
+
+	/* LOCATION_GNSS_HAS_* flags */
+	uint8_t flags;
+} __packed;
+
+struct storage_location_cell_record {
+	uint32_t id;
+	int16_t mcc;
+	int16_t mnc;
+	uint32_t tac;
+	uint16_t timing_advance;
+	uint32_t earfcn;
+	int16_t rsrp;
+	int16_t rsrq;
+} __packed;
+
+struct storage_location_neighbor_cell_record {
+	uint32_t earfcn;
+	int32_t time_diff;
+	uint16_t phys_cell_id;
+	int16_t rsrp;
+	int16_t rsrq;
+} __packed;
+
+struct storage_location_cloud_request_record {
+	struct storage_location_cell_record current_cell;
+	uint8_t ncells_count;
+	struct storage_location_neighbor_cell_record
+		neighbor_cells[CONFIG_APP_LOCATION_NEIGHBOR_CELLS_MAX];
+	uint8_t gci_cells_count;
+	struct storage_location_cell_record gci_cells[CONFIG_APP_LOCATION_NEIGHBOR_CELLS_MAX];
+	uint16_t wifi_cnt;
+	struct location_wifi_ap_info wifi_aps[CONFIG_APP_LOCATION_WIFI_APS_MAX];
+} __packed;
+
+struct storage_location_record {
+	/* enum location_msg_type of the stored message */
+	uint8_t type;
+	uint8_t timestamp[STORAGE_RECORD_TIMESTAMP_SIZE];
+	union {
+		struct storage_location_gnss_record gnss_data;
+		struct storage_location_cloud_request_record cloud_request;
+	};
+} __packed;
+#endif /* CONFIG_APP_LOCATION */
+
 /**
  * @brief List of data sources that can be stored by the storage module
  *
@@ -35,6 +147,14 @@
  * - data_type: Type of data to store (e.g., double for battery percentage)
  * - check_fn: Function to filter messages (e.g., battery_check)
  * - extract_fn: Function to extract data (e.g., battery_extract)
+ * - record_type: Compact record type used by persistent backends
+ *                (e.g., struct storage_battery_record)
+ * - encode_fn: Function to encode data into a compact record (e.g., battery_encode)
+ * - decode_fn: Function to decode a compact record into data (e.g., battery_decode)
+ * - cloud_send_fn: Function that sends an item of this type to the cloud
+ *                  (e.g., battery_cloud_send)
+ * - cloud_batch_fn: Function that adds an item of this type to a cloud batch, NULL for types
+ *                   that are always sent on their own (e.g., battery_cloud_batch_add)
  *
  * The list uses IF_ENABLED to conditionally include data sources based on Kconfig:
  * - CONFIG_APP_POWER enables battery data storage
@@ -46,49 +166,78 @@
  * 1. With STORAGE_DATA_TYPE to register each data type:
  *    DATA_SOURCE_LIST(STORAGE_DATA_TYPE) expands to:
  *    STORAGE_DATA_TYPE(battery, power_chan, struct power_msg, double,
- *                     battery_check, battery_extract)
+ *                     battery_check, battery_extract, struct storage_battery_record,
+ *                     battery_encode, battery_decode, battery_cloud_send,
+ *                     battery_cloud_batch_add)
  *    for each enabled module
  *
  * 2. With ADD_OBSERVERS to add storage_subscriber to each channel:
  *    DATA_SOURCE_LIST(ADD_OBSERVERS) expands to:
- *    ZBUS_CHAN_ADD_OBS(power_chan, storage_subscriber, 0)
+ *    ZBUS_CHAN_ADD_OBS(power_chan, storage_subscriber, 1)
  *    for each enabled module
  *
  * 3. With MAX_MSG_SIZE_FROM_LIST to calculate buffer sizes:
  *    Used to ensure message buffers are large enough for all message types
  *
+ * 4. With CLOUD_DISPATCH_ENTRY in the cloud module to build a constant table, indexed by
+ *    enum storage_data_type, of the functions that send each type to the cloud. The cloud
+ *    functions are only referenced by the cloud module.
+ *
  * @param X Macro to apply to each entry in the list. Will be called as:
- *          X(name, channel, msg_type, data_type, check_fn, extract_fn)
+ *          X(name, channel, msg_type, data_type, check_fn, extract_fn,
+ *            record_type, encode_fn, decode_fn, cloud_send_fn, cloud_batch_fn)
  */
 #define DATA_SOURCE_LIST(X)									\
 	IF_ENABLED(CONFIG_APP_POWER,								\
 		   (X(BATTERY, power_chan, struct power_msg, struct power_msg,			\
-		      battery_check, battery_extract)))						\
+		      battery_check, battery_extract, struct storage_battery_record,		\
+		      battery_encode, battery_decode,						\
+		      battery_cloud_send, battery_cloud_batch_add)))				\
 	IF_ENABLED(CONFIG_APP_ENVIRONMENTAL,							\
 		   (X(ENVIRONMENTAL, environmental_chan,					\
 		      struct environmental_msg, struct environmental_msg,			\
-		      environmental_check, environmental_extract)))				\
+		      environmental_check, environmental_extract,				\
+		      struct storage_environmental_record,					\
+		      environmental_encode, environmental_decode,				\
+		      environmental_cloud_send, environmental_cloud_batch_add)))		\
 	IF_ENABLED(CONFIG_APP_LOCATION,								\
 		   (X(LOCATION, location_chan, struct location_msg,				\
-		      struct location_msg, location_check, location_extract)))
+		      struct location_msg, location_check, location_extract,			\
+		      struct storage_location_record, location_encode, location_decode,	\
+		      location_cloud_send, NULL)))
 
 #define STORAGE_DATA_TYPE(_name)								\
 	STORAGE_TYPE_ ## _name
 
-#define _STORAGE_DATA_TYPE_ID(_name, _chan, _msg_type, _data_type, _check_fn, _extract_fn)	\
+#define _STORAGE_DATA_TYPE_ID(_name, _chan, _msg_type, _data_type, _check_fn, _extract_fn,	\
+			      _record_type, _encode_fn, _decode_fn, _cloud_send_fn,		\
+			      _cloud_batch_fn)							\
 	STORAGE_DATA_TYPE(_name),
 
-#define _STORAGE_DATA_TYPE_MEMBER(_name, _chan, _msg_type, _data_type, _check_fn, _extract_fn)	\
+#define _STORAGE_DATA_TYPE_MEMBER(_name, _chan, _msg_type, _data_type, _check_fn, _extract_fn,	\
+				  _record_type, _encode_fn, _decode_fn, _cloud_send_fn,		\
+				  _cloud_batch_fn)						\
 	_data_type _name;
 
 
 /* Calculate the maximum data size from the list of channels */
-#define STORAGE_DATA_UNION_MEMBER(_name, _chan, _msg_type, _data_type, _check_fn, _extract_fn) \
+#define STORAGE_DATA_UNION_MEMBER(_name, _chan, _msg_type, _data_type, _check_fn, _extract_fn,	\
+				  _record_type, _encode_fn, _decode_fn, _cloud_send_fn,		\
+				  _cloud_batch_fn)						\
 	_data_type _name##_member;
 
 #define STORAGE_MAX_DATA_SIZE_FROM_LIST(_DATA_SOURCE_LIST_LIST) \
 	sizeof(union { _DATA_SOURCE_LIST_LIST(STORAGE_DATA_UNION_MEMBER) })
 
+/* Calculate the maximum compact record size from the list of channels */
+#define STORAGE_RECORD_UNION_MEMBER(_name, _chan, _msg_type, _data_type, _check_fn, _extract_fn,	\
+				    _record_type, _encode_fn, _decode_fn, _cloud_send_fn,		\
+				    _cloud_batch_fn)						\
+	_record_type _name##_record_member;
+
+#define STORAGE_MAX_RECORD_SIZE_FROM_LIST(_DATA_SOURCE_LIST_LIST) \
+	sizeof(union { _DATA_SOURCE_LIST_LIST(STORAGE_RECORD_UNION_MEMBER) })
+
 /**
  * @brief Maximum size in bytes of any data type that can be stored
  *
@@ -105,21 +254,23 @@
  * For example, if the enabled data types are:
  * - BATTERY: sizeof(double) = 8 bytes
  * - ENVIRONMENTAL: sizeof(struct environmental_msg) = ~24 bytes
- * - LOCATION: sizeof(struct location_msg) = ~300+ bytes (with CONFIG_LOCATION_DATA_DETAILS)
+ * - LOCATION: sizeof(struct location_msg) = ~580 bytes (with the default
+ *   CONFIG_APP_LOCATION_NEIGHBOR_CELLS_MAX and CONFIG_APP_LOCATION_WIFI_APS_MAX)
+ *
+ * Then STORAGE_MAX_DATA_SIZE = ~580 bytes (the size of struct location_msg)
  *
- * Then STORAGE_MAX_DATA_SIZE = ~300+ bytes (the size of struct location_msg)
+ * The location_msg size includes the largest union member, which is the cloud location request
+ * data. This structure contains:
+ * - Serving cell information: 28 bytes
+ * - Neighbor cells: CONFIG_APP_LOCATION_NEIGHBOR_CELLS_MAX * 16 bytes
+ * - GCI cells: CONFIG_APP_LOCATION_NEIGHBOR_CELLS_MAX * 28 bytes
+ * - Wi-Fi access points: CONFIG_APP_LOCATION_WIFI_APS_MAX * 8 bytes
  *
- * The location_msg size includes the largest union member, which is struct location_data when
- * CONFIG_LOCATION_DATA_DETAILS is enabled. This structure contains:
- * - Basic location data (lat, lon, accuracy, datetime): ~40 bytes
- * - location_data_details structure with GNSS details: ~250+ bytes
- *   - Contains nrf_modem_gnss_pvt_data_frame (~250+ bytes) including:
- *     - Position, velocity, time data: ~100 bytes
- *     - Array of 12 satellite info structures: 12 * 12 = 144 bytes
- *     - Additional GNSS timing and accuracy data: ~10+ bytes
+ * GNSS fixes are carried as struct location_gnss_data, ~40 bytes. The full GNSS details are
+ * not part of location_msg, see CONFIG_APP_LOCATION_GNSS_DETAILS.
  *
  * This macro is used for:
- * - Sizing message buffers in struct storage_msg to ensure they can hold any data type
+ * - Sizing the buffer in struct storage_data_msg to ensure it can hold any data type
  * - Allocating temporary buffers for data processing operations (e.g., in flush_stored_data())
  *
  * The value is automatically updated when new data types are added to DATA_SOURCE_LIST
@@ -127,6 +278,9 @@
  */
 #define STORAGE_MAX_DATA_SIZE	STORAGE_MAX_DATA_SIZE_FROM_LIST(DATA_SOURCE_LIST)
 
+/** @brief Maximum size in bytes of any compact record, see STORAGE_MAX_DATA_SIZE */
+#define STORAGE_MAX_RECORD_SIZE	STORAGE_MAX_RECORD_SIZE_FROM_LIST(DATA_SOURCE_LIST)
+
 /**
  * @brief Unique identifiers for each type of data that can be stored.
  *
@@ -205,6 +359,44 @@ struct storage_data {
 	 *             be cast to the appropriate data type internally.
 	 */
 	void (*extract_data)(const void *msg, void *data);
+
+	/* Size of the compact record of this type. */
+	size_t record_size;
+
+	/**
+	 * @brief Function to encode data into its compact record
+	 *
+	 * Used by persistent backends to shrink data before writing it. The encoding may
+	 * drop fields that are not used by the consumers and reduce the precision of others.
+	 *
+	 * @param data Pointer to data in storage format, data_size bytes.
+	 * @param record Pointer to where the record should be written, record_size bytes.
+	 */
+	void (*encode_record)(const void *data, void *record);
+
+	/**
+	 * @brief Function to decode a compact record into storage format
+	 *
+	 * @param record Pointer to the record, record_size bytes.
+	 * @param data Pointer to where the decoded data should be written, data_size bytes.
+	 */
+	void (*decode_record)(const void *record, void *data);
+
+	/**
+	 * @brief Function to get the sampling timestamp of data in storage format
+	 *
+	 * Used to look up records by time.
+	 *
+	 * @param data Pointer to data in storage format, data_size bytes.
+	 *
+	 * @return Timestamp in milliseconds, in the time base of the sample.
+	 */
+	int64_t (*get_timestamp)(const void *data);
+
+	/* Thin out old records of this type when storage fills up, see
+	 * CONFIG_APP_STORAGE_THINNING_<name>.
+	 */
+	bool thin;
 };
 
 /* Helper macro to create a name with a numerical value so that the linker can place the struct
@@ -226,7 +418,10 @@ struct storage_data {
  *                   struct power_msg,      - Type of messages on the channel
  *                   double,                - Type of data to store
  *                   battery_should_store,  - Function to check if message should be stored
- *                   battery_extract_data); - Function to extract data from message
+ *                   battery_extract_data,  - Function to extract data from message
+ *                   struct storage_battery_record, - Compact record type
+ *                   battery_encode,        - Function to encode data into a record
+ *                   battery_decode);       - Function to decode a record into data
  * @endcode
  *
  * @param _name Name to identify this storage type
@@ -235,11 +430,22 @@ struct storage_data {
  * @param _data_type Type of data to store
  * @param _check_fn Function that returns true if a message should be stored
  * @param _extract_fn Function that extracts data from a message into storage format
+ * @param _record_type Compact record type used by persistent backends
+ * @param _encode_fn Function that encodes data into a compact record
+ * @param _decode_fn Function that decodes a compact record into data
+ * @param _cloud_send_fn Function that sends data to the cloud, unused here
+ * @param _cloud_batch_fn Function that adds data to a cloud batch, unused here
+ *
+ * The data type must have an int64_t timestamp member holding the sampling time.
  */
-#define STORAGE_DATA_TYPE_ADD(_name, _chan, _msg_type, _data_type, _check_fn, _extract_fn)	\
+#define STORAGE_DATA_TYPE_ADD(_name, _chan, _msg_type, _data_type, _check_fn, _extract_fn,	\
+			      _record_type, _encode_fn, _decode_fn, _cloud_send_fn,		\
+			      _cloud_batch_fn)							\
 												\
 	extern bool _check_fn(const _msg_type * msg);						\
 	extern void _extract_fn(const _msg_type * msg, _data_type * data);			\
+	extern void _encode_fn(const _data_type * data, _record_type * record);			\
+	extern void _decode_fn(const _record_type * record, _data_type * data);			\
 												\
 	static bool _name ## _should_store(const void *msg)					\
 	{											\
@@ -255,6 +461,21 @@ struct storage_data {
 		_extract_fn(m, (_data_type *)data);						\
 	}											\
 												\
+	static void _name ## _encode_record(const void *data, void *record)			\
+	{											\
+		_encode_fn((const _data_type *)data, (_record_type *)record);			\
+	}											\
+												\
+	static void _name ## _decode_record(const void *record, void *data)			\
+	{											\
+		_decode_fn((const _record_type *)record, (_data_type *)data);			\
+	}											\
+												\
+	static int64_t _name ## _get_timestamp(const void *data)				\
+	{											\
+		return ((const _data_type *)data)->timestamp;					\
+	}											\
+												\
 	STRUCT_SECTION_ITERABLE(storage_data, _STORAGE_TYPE_NAME(_name)) = {			\
 		.name = #_name,									\
 		.chan = &_chan,									\
@@ -262,6 +483,11 @@ struct storage_data {
 		.data_size = sizeof(_data_type),						\
 		.should_store = _name ## _should_store,						\
 		.extract_data = _name ## _extract_data,						\
+		.record_size = sizeof(_record_type),						\
+		.encode_record = _name ## _encode_record,					\
+		.decode_record = _name ## _decode_record,					\
+		.get_timestamp = _name ## _get_timestamp,					\
+		.thin = IS_ENABLED(CONFIG_APP_STORAGE_THINNING_ ## _name),			\
 	};
 
 #endif /* _STORAGE_DATA_TYPES_H_ */
@@ -13,8 +13,172 @@
 #include "storage.h"
 #include "storage_data_types.h" /* For storage_chan */
 
+#if defined(CONFIG_APP_STORAGE_SHELL_EXPORT)
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+#endif /* CONFIG_APP_STORAGE_SHELL_EXPORT */
+
 LOG_MODULE_REGISTER(storage_shell, CONFIG_APP_STORAGE_LOG_LEVEL);
 
+#if defined(CONFIG_APP_STORAGE_SHELL_EXPORT)
+/* "EXPT", distinct from the session IDs of the cloud modules */
+#define EXPORT_SESSION_ID		0x45585054
+#define EXPORT_RESPONSE_TIMEOUT		K_SECONDS(5)
+#define EXPORT_ITEM_TIMEOUT		K_SECONDS(5)
+
+/* Format of the frames, see scripts/storage_export_decode.py */
+#define EXPORT_FORMAT_VERSION		1
+#define EXPORT_FRAME_HEADER		0x01
+#define EXPORT_FRAME_RECORD		0x02
+#define EXPORT_FRAME_END		0x03
+
+/* Frame kind, type and sequence number, then the record, then the CRC32 */
+#define EXPORT_FRAME_MAX_SIZE		(1 + 1 + 4 + STORAGE_MAX_DATA_SIZE + 4)
+
+/* COBS adds one byte per 254 bytes of data, and one more for the first code byte */
+#define EXPORT_COBS_MAX_SIZE		(EXPORT_FRAME_MAX_SIZE + (EXPORT_FRAME_MAX_SIZE / 254) + 1)
+
+static const struct device *const export_uart = DEVICE_DT_GET(DT_CHOSEN(zephyr_shell_uart));
+
+static uint8_t export_frame[EXPORT_FRAME_MAX_SIZE];
+static uint8_t export_cobs[EXPORT_COBS_MAX_SIZE];
+
+/* Response to the batch request of the export command */
+static struct storage_msg export_response;
+
+K_SEM_DEFINE(export_response_sem, 0, 1);
+
+static void export_listener_cb(const struct zbus_channel *chan)
+{
+	const struct storage_msg *msg = zbus_chan_const_msg(chan);
+
+	if (msg->session_id != EXPORT_SESSION_ID) {
+		return;
+	}
+
+	switch (msg->type) {
+	case STORAGE_BATCH_AVAILABLE:
+	case STORAGE_BATCH_EMPTY:
+	case STORAGE_BATCH_BUSY:
+	case STORAGE_BATCH_ERROR:
+		export_response = *msg;
+		k_sem_give(&export_response_sem);
+		break;
+	default:
+		break;
+	}
+}
+
+ZBUS_LISTENER_DEFINE(storage_export_listener, export_listener_cb);
+ZBUS_CHAN_ADD_OBS(storage_chan, storage_export_listener, 0);
+
+/* COBS encode a frame, so that it contains no zero bytes and zero can delimit frames */
+static size_t cobs_encode(const uint8_t *src, size_t len, uint8_t *dst)
+{
+	size_t code_idx = 0;
+	size_t out = 1;
+	uint8_t code = 1;
+
+	for (size_t i = 0; i < len; i++) {
+		if (src[i] != 0) {
+			dst[out++] = src[i];
+			code++;
+		}
+
+		if ((src[i] == 0) || (code == 0xFF)) {
+			dst[code_idx] = code;
+			code_idx = out++;
+			code = 1;
+		}
+	}
+
+	dst[code_idx] = code;
+
+	return out;
+}
+
+/* Add the CRC32 of the frame, and write it to the UART with a zero delimiter */
+static void export_frame_send(size_t len)
+{
+	size_t encoded_len;
+
+	sys_put_le32(crc32_ieee(export_frame, len), &export_frame[len]);
+
+	encoded_len = cobs_encode(export_frame, len + sizeof(uint32_t), export_cobs);
+
+	for (size_t i = 0; i < encoded_len; i++) {
+		uart_poll_out(export_uart, export_cobs[i]);
+	}
+
+	uart_poll_out(export_uart, 0);
+}
+
+/* Describe the data types, so that the host can name and size the records */
+static void export_header_send(uint32_t count)
+{
+	size_t len = 0;
+
+	export_frame[len++] = EXPORT_FRAME_HEADER;
+	export_frame[len++] = EXPORT_FORMAT_VERSION;
+	sys_put_le32(count, &export_frame[len]);
+	len += sizeof(uint32_t);
+
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		size_t name_len = MIN(strlen(type->name), UINT8_MAX);
+
+		/* Type, size, name length and CRC32 must fit after the name */
+		if ((len + 1 + 2 + 1 + name_len + sizeof(uint32_t)) > sizeof(export_frame)) {
+			break;
+		}
+
+		export_frame[len++] = (uint8_t)type->data_type;
+		sys_put_le16((uint16_t)type->data_size, &export_frame[len]);
+		len += sizeof(uint16_t);
+		export_frame[len++] = (uint8_t)name_len;
+		memcpy(&export_frame[len], type->name, name_len);
+		len += name_len;
+	}
+
+	export_frame_send(len);
+}
+
+static void export_record_send(const struct storage_data_item *item, uint32_t sequence)
+{
+	size_t len = 0;
+	size_t data_size = 0;
+
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		if (type->data_type == item->type) {
+			data_size = MIN(type->data_size, STORAGE_MAX_DATA_SIZE);
+			break;
+		}
+	}
+
+	export_frame[len++] = EXPORT_FRAME_RECORD;
+	export_frame[len++] = (uint8_t)item->type;
+	sys_put_le32(sequence, &export_frame[len]);
+	len += sizeof(uint32_t);
+	memcpy(&export_frame[len], &item->data, data_size);
+	len += data_size;
+
+	export_frame_send(len);
+}
+
+static void export_end_send(uint32_t count)
+{
+	size_t len = 0;
+
+	export_frame[len++] = EXPORT_FRAME_END;
+	sys_put_le32(count, &export_frame[len]);
+	len += sizeof(uint32_t);
+
+	export_frame_send(len);
+}
+#endif /* CONFIG_APP_STORAGE_SHELL_EXPORT */
+
 static int cmd_storage_flush(const struct shell *sh, size_t argc, char **argv)
 {
 	ARG_UNUSED(argc);
@@ -70,6 +234,24 @@ static int cmd_storage_clear(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
 
+static int cmd_storage_persist(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	struct storage_msg msg = { .type = STORAGE_PERSIST };
+	int err;
+
+	err = zbus_chan_pub(&storage_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		shell_error(sh, "Failed to publish STORAGE_PERSIST: %d", err);
+		return err;
+	}
+
+	shell_print(sh, "Storage persist initiated.");
+	return 0;
+}
+
 static int cmd_storage_batch_close(const struct shell *sh, size_t argc, char **argv)
 {
 	ARG_UNUSED(argc);
@@ -111,12 +293,96 @@ static int cmd_storage_stats(const struct shell *sh, size_t argc, char **argv)
 	return 0;
 }
 
+#if defined(CONFIG_APP_STORAGE_SHELL_EXPORT)
+static int cmd_storage_export(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	struct storage_msg msg = {
+		.type = STORAGE_BATCH_REQUEST,
+		.session_id = EXPORT_SESSION_ID,
+	};
+	const struct storage_data_item *item;
+	uint32_t exported = 0;
+	int err;
+
+	if (!device_is_ready(export_uart)) {
+		shell_error(sh, "Shell UART not ready");
+		return -ENODEV;
+	}
+
+	k_sem_reset(&export_response_sem);
+
+	err = zbus_chan_pub(&storage_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		shell_error(sh, "Failed to publish STORAGE_BATCH_REQUEST: %d", err);
+		return err;
+	}
+
+	err = k_sem_take(&export_response_sem, EXPORT_RESPONSE_TIMEOUT);
+	if (err) {
+		shell_error(sh, "No response to the batch request");
+		return -ETIMEDOUT;
+	}
+
+	if (export_response.type == STORAGE_BATCH_EMPTY) {
+		shell_print(sh, "No stored records to export.");
+		return 0;
+	} else if (export_response.type != STORAGE_BATCH_AVAILABLE) {
+		shell_error(sh, "Batch session not started, response: %d", export_response.type);
+		return -EBUSY;
+	}
+
+	shell_print(sh, "Exporting %u records.", export_response.data_len);
+
+	/* A delimiter ends any shell output that is still being sent, so that it is not taken
+	 * as the start of the first frame.
+	 */
+	uart_poll_out(export_uart, 0);
+
+	export_header_send(export_response.data_len);
+
+	/* Records are read from the batch session, they are not removed from storage */
+	while (exported < export_response.data_len) {
+		err = storage_batch_claim(&item, EXPORT_ITEM_TIMEOUT);
+		if (err) {
+			break;
+		}
+
+		export_record_send(item, exported);
+		storage_batch_release(item);
+
+		exported++;
+	}
+
+	export_end_send(exported);
+
+	msg.type = STORAGE_BATCH_CLOSE;
+
+	err = zbus_chan_pub(&storage_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		shell_error(sh, "Failed to publish STORAGE_BATCH_CLOSE: %d", err);
+		return err;
+	}
+
+	shell_print(sh, "Exported %u of %u records.", exported, export_response.data_len);
+
+	return 0;
+}
+#endif /* CONFIG_APP_STORAGE_SHELL_EXPORT */
+
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_cmds,
 	SHELL_CMD(flush, NULL, "Flush stored data", cmd_storage_flush),
 	SHELL_CMD(batch_request, NULL, "Request data from batch", cmd_storage_batch_request),
 	SHELL_CMD(clear, NULL, "Clear all stored data", cmd_storage_clear),
+	SHELL_CMD(persist, NULL, "Move stored data in RAM to flash", cmd_storage_persist),
 	SHELL_CMD(batch_close, NULL, "Close batch session", cmd_storage_batch_close),
 	SHELL_CMD(stats, NULL, "Show storage statistics", cmd_storage_stats),
+#if defined(CONFIG_APP_STORAGE_SHELL_EXPORT)
+	SHELL_CMD(export, NULL, "Export stored records as binary frames on the shell UART",
+		  cmd_storage_export),
+#endif /* CONFIG_APP_STORAGE_SHELL_EXPORT */
 	SHELL_SUBCMD_SET_END
 );
 
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <math.h>
+
+#include "storage_track.h"
+
+LOG_MODULE_DECLARE(storage, CONFIG_APP_STORAGE_LOG_LEVEL);
+
+#define EARTH_RADIUS_METERS	6371000.0
+#define DEG_TO_RAD(deg)		((deg) * 3.14159265358979323846 / 180.0)
+
+struct track_point {
+	double latitude;
+	double longitude;
+};
+
+/* Only accessed from the storage module thread */
+static struct {
+	/* Last stored point */
+	bool anchor_valid;
+	struct track_point anchor;
+
+	/* Fixes received since the anchor, the last one is the candidate */
+	struct track_point window[CONFIG_APP_STORAGE_TRACK_WINDOW_SIZE];
+	size_t window_count;
+	struct location_msg candidate;
+
+	/* Point returned by storage_track_point_get() */
+	struct location_msg point;
+
+	/* Trip summary, only logged */
+	int64_t trip_start;
+	double trip_distance;
+} track;
+
+/* Position in meters relative to the origin. The equirectangular projection is accurate
+ * enough for the distances between two stored points.
+ */
+static void project(const struct track_point *origin, const struct track_point *p,
+		    double *x, double *y)
+{
+	*x = DEG_TO_RAD(p->longitude - origin->longitude) *
+	     cos(DEG_TO_RAD(origin->latitude)) * EARTH_RADIUS_METERS;
+	*y = DEG_TO_RAD(p->latitude - origin->latitude) * EARTH_RADIUS_METERS;
+}
+
+static double distance_get(const struct track_point *a, const struct track_point *b)
+{
+	double x, y;
+
+	project(a, b, &x, &y);
+
+	return sqrt((x * x) + (y * y));
+}
+
+/* Distance in meters from p to the segment from a to b */
+static double segment_distance_get(const struct track_point *a, const struct track_point *b,
+				   const struct track_point *p)
+{
+	double bx, by, px, py;
+	double length_sq, t;
+
+	project(a, b, &bx, &by);
+	project(a, p, &px, &py);
+
+	length_sq = (bx * bx) + (by * by);
+	if (length_sq == 0.0) {
+		return sqrt((px * px) + (py * py));
+	}
+
+	t = CLAMP(((px * bx) + (py * by)) / length_sq, 0.0, 1.0);
+	px -= t * bx;
+	py -= t * by;
+
+	return sqrt((px * px) + (py * py));
+}
+
+/* True if all fixes since the anchor are close to the line from the anchor to p */
+static bool window_fits(const struct track_point *p)
+{
+	for (size_t i = 0; i < track.window_count; i++) {
+		if (segment_distance_get(&track.anchor, p, &track.window[i]) >
+		    CONFIG_APP_STORAGE_TRACK_TOLERANCE_METERS) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void anchor_set(const struct location_msg *msg)
+{
+	track.anchor.latitude = msg->gnss_data.latitude;
+	track.anchor.longitude = msg->gnss_data.longitude;
+	track.anchor_valid = true;
+	track.point = *msg;
+}
+
+static void window_start(const struct location_msg *msg, const struct track_point *p)
+{
+	track.window[0] = *p;
+	track.window_count = 1;
+	track.candidate = *msg;
+}
+
+bool storage_track_add(const struct location_msg *msg)
+{
+	struct track_point p = {
+		.latitude = msg->gnss_data.latitude,
+		.longitude = msg->gnss_data.longitude,
+	};
+	const struct track_point *last;
+
+	if (!track.anchor_valid) {
+		anchor_set(msg);
+
+		return true;
+	}
+
+	/* Stationary at the anchor, nothing new to store */
+	if (track.window_count == 0) {
+		if (distance_get(&track.anchor, &p) <=
+		    CONFIG_APP_STORAGE_TRACK_STOP_RADIUS_METERS) {
+			return false;
+		}
+
+		LOG_DBG("Trip started");
+
+		track.trip_start = track.point.timestamp;
+		track.trip_distance = distance_get(&track.anchor, &p);
+		window_start(msg, &p);
+
+		return false;
+	}
+
+	last = &track.window[track.window_count - 1];
+	track.trip_distance += distance_get(last, &p);
+
+	/* The device stopped, store the stop right away so the track does not end early */
+	if (distance_get(last, &p) <= CONFIG_APP_STORAGE_TRACK_STOP_RADIUS_METERS) {
+		LOG_INF("Trip ended, distance: %d m, duration: %d s", (int)track.trip_distance,
+			(int)((msg->timestamp - track.trip_start) / MSEC_PER_SEC));
+
+		track.window_count = 0;
+		anchor_set(msg);
+
+		return true;
+	}
+
+	if ((track.window_count < ARRAY_SIZE(track.window)) && window_fits(&p)) {
+		track.window[track.window_count++] = p;
+		track.candidate = *msg;
+
+		return false;
+	}
+
+	/* The candidate is needed to keep the shape of the track */
+	anchor_set(&track.candidate);
+	window_start(msg, &p);
+
+	return true;
+}
+
+const struct location_msg *storage_track_point_get(void)
+{
+	return &track.point;
+}
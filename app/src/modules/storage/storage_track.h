@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _STORAGE_TRACK_H_
+#define _STORAGE_TRACK_H_
+
+#include <stdbool.h>
+
+#include "location.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Add a GNSS fix to the simplified track.
+ *
+ * The most recent fix is held back as a candidate until a later fix shows whether it is
+ * needed to keep the shape of the track. A candidate is dropped while all fixes since the
+ * last stored point are within CONFIG_APP_STORAGE_TRACK_TOLERANCE_METERS of the line from
+ * the last stored point to the new fix. When the device stops, the fix at the stop is stored
+ * right away, and fixes within CONFIG_APP_STORAGE_TRACK_STOP_RADIUS_METERS of it are dropped
+ * until the device moves again.
+ *
+ * @param[in] msg LOCATION_GNSS_DATA message.
+ *
+ * @return true if a point is to be stored, get it with storage_track_point_get().
+ */
+bool storage_track_add(const struct location_msg *msg);
+
+/**
+ * @brief Get the point to store after storage_track_add() returned true.
+ *
+ * This is either the fix that was added or the candidate held back before it.
+ *
+ * @return Pointer to the LOCATION_GNSS_DATA message to store.
+ */
+const struct location_msg *storage_track_point_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _STORAGE_TRACK_H_ */
@@ -6,12 +6,17 @@
 
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/uart.h>
 #include <zephyr/drivers/sensor/npm13xx_charger.h>
 #include <zephyr/drivers/mfd/npm13xx.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/pm/device.h>
+#include <zephyr/shell/shell.h>
 #include <zephyr/sys/util.h>
 
+#include <hal/nrf_gpio.h>
+#include <hal/nrf_uarte.h>
 #include <modem/nrf_modem_lib.h>
 #ifdef CONFIG_NRF_MODEM_LIB_TRACE_BACKEND_UART
 #include <modem/nrf_modem_lib_trace.h>
@@ -25,9 +30,29 @@ static const struct device *const pmic_dev = DEVICE_DT_GET(DT_NODELABEL(pmic_mai
 static const struct device *const uart0_dev = DEVICE_DT_GET(DT_NODELABEL(uart0));
 static const struct device *const uart1_dev = DEVICE_DT_GET(DT_NODELABEL(uart1));
 
+/* Time given to the UARTs to send the bytes that are in flight before they are suspended */
+#define TX_DRAIN_TIMEOUT_MSEC	100
+
 /* Modem initialization synchronization */
 K_SEM_DEFINE(modem_init_sem, 0, 1);
 
+/* Wait until the UART has sent the bytes in flight, sleeping instead of spinning */
+static void uart_tx_drain(const struct device *dev)
+{
+	const int64_t start = k_uptime_get();
+
+	/* Negative values mean that the UART cannot tell, nothing is waited for then */
+	while (uart_irq_tx_complete(dev) == 0) {
+		if ((k_uptime_get() - start) >= TX_DRAIN_TIMEOUT_MSEC) {
+			LOG_WRN("%s not drained after %d ms, suspending", dev->name,
+				TX_DRAIN_TIMEOUT_MSEC);
+			break;
+		}
+
+		k_sleep(K_MSEC(1));
+	}
+}
+
 static int uart_disable(void)
 {
 	int err;
@@ -46,7 +71,8 @@ static int uart_disable(void)
 #endif
 
 	/* Allow outstanding UART transfers to complete before suspend. */
-	k_busy_wait(100 * USEC_PER_MSEC);
+	uart_tx_drain(uart1_dev);
+	uart_tx_drain(uart0_dev);
 
 	err = pm_device_action_run(uart1_dev, PM_DEVICE_ACTION_SUSPEND);
 	if (err && (err != -EALREADY)) {
@@ -99,6 +125,167 @@ static int uart_enable(void)
 	return 0;
 }
 
+#if CONFIG_APP_UART_POWER_CONTROL_IDLE_TIMEOUT_SECONDS > 0
+/* The RX pin of the shell UART is watched with a level interrupt, which uses the low-power
+ * GPIO sense mechanism. The first falling edge of a received byte kicks the idle timer while
+ * the UARTs are enabled, and resumes them while they are suspended for being idle. The byte
+ * that wakes the UARTs up is lost.
+ */
+#define IDLE_TIMEOUT	K_SECONDS(CONFIG_APP_UART_POWER_CONTROL_IDLE_TIMEOUT_SECONDS)
+
+static const struct device *const rx_port = DEVICE_DT_GET(DT_NODELABEL(gpio0));
+static struct gpio_callback rx_cb;
+static uint32_t rx_pin;
+
+/* Only accessed from the system work queue, which the VBUS events are delivered on as well */
+static bool vbus_present;
+static bool idle_suspended;
+
+static void idle_work_fn(struct k_work *work);
+static void rx_work_fn(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(idle_work, idle_work_fn);
+static K_WORK_DEFINE(rx_work, rx_work_fn);
+
+static void rx_wakeup_arm(bool enable)
+{
+	int err;
+
+	err = gpio_pin_interrupt_configure(rx_port, rx_pin,
+					   enable ? GPIO_INT_LEVEL_LOW : GPIO_INT_DISABLE);
+	if (err) {
+		LOG_ERR("gpio_pin_interrupt_configure, error: %d", err);
+	}
+}
+
+static void rx_isr(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+{
+	ARG_UNUSED(cb);
+	ARG_UNUSED(pins);
+
+	/* The level interrupt fires for as long as the line is low, it is re-armed from the
+	 * work item.
+	 */
+	(void)gpio_pin_interrupt_configure(dev, rx_pin, GPIO_INT_DISABLE);
+	(void)k_work_submit(&rx_work);
+}
+
+static void idle_work_fn(struct k_work *work)
+{
+	int err;
+
+	ARG_UNUSED(work);
+
+	if (!vbus_present || idle_suspended) {
+		return;
+	}
+
+	LOG_DBG("No shell input for %d seconds, suspending UARTs",
+		CONFIG_APP_UART_POWER_CONTROL_IDLE_TIMEOUT_SECONDS);
+
+	rx_wakeup_arm(false);
+
+	err = uart_disable();
+	if (err) {
+		LOG_ERR("uart_disable, error: %d", err);
+		return;
+	}
+
+	/* The sleep state of the UART disconnects the input buffer of the RX pin */
+	err = gpio_pin_configure(rx_port, rx_pin, GPIO_INPUT | GPIO_PULL_UP);
+	if (err) {
+		LOG_ERR("gpio_pin_configure, error: %d", err);
+		return;
+	}
+
+	idle_suspended = true;
+
+	rx_wakeup_arm(true);
+}
+
+static void rx_work_fn(struct k_work *work)
+{
+	int err;
+
+	ARG_UNUSED(work);
+
+	if (!vbus_present) {
+		return;
+	}
+
+	if (idle_suspended) {
+		LOG_DBG("Shell input, resuming UARTs");
+
+		err = uart_enable();
+		if (err) {
+			LOG_ERR("uart_enable, error: %d", err);
+			return;
+		}
+
+		idle_suspended = false;
+	}
+
+	(void)k_work_reschedule(&idle_work, IDLE_TIMEOUT);
+
+	rx_wakeup_arm(true);
+}
+
+/* Called when VBUS changes, the UARTs have already been enabled or disabled */
+static void idle_vbus_update(bool present)
+{
+	vbus_present = present;
+	idle_suspended = false;
+
+	if (present) {
+		(void)k_work_reschedule(&idle_work, IDLE_TIMEOUT);
+		rx_wakeup_arm(true);
+	} else {
+		(void)k_work_cancel_delayable(&idle_work);
+		rx_wakeup_arm(false);
+	}
+}
+
+static int idle_init(void)
+{
+	int err;
+	NRF_UARTE_Type *uarte = (NRF_UARTE_Type *)DT_REG_ADDR(DT_NODELABEL(uart0));
+
+	if (!device_is_ready(rx_port)) {
+		LOG_ERR("GPIO port is not ready");
+		return -ENODEV;
+	}
+
+	/* The pin is taken from the UART, which is configured from devicetree */
+	rx_pin = nrf_uarte_rx_pin_get(uarte);
+	if (rx_pin == NRF_UARTE_PSEL_DISCONNECTED) {
+		LOG_ERR("uart0 has no RX pin");
+		return -ENODEV;
+	}
+
+	(void)nrf_gpio_pin_port_number_extract(&rx_pin);
+
+	gpio_init_callback(&rx_cb, rx_isr, BIT(rx_pin));
+
+	err = gpio_add_callback(rx_port, &rx_cb);
+	if (err) {
+		LOG_ERR("gpio_add_callback, error: %d", err);
+		return err;
+	}
+
+	return 0;
+}
+#else
+static void idle_vbus_update(bool present)
+{
+	ARG_UNUSED(present);
+}
+
+static int idle_init(void)
+{
+	return 0;
+}
+#endif /* CONFIG_APP_UART_POWER_CONTROL_IDLE_TIMEOUT_SECONDS > 0 */
+
 static int vbus_is_present(void)
 {
 	int err;
@@ -117,6 +304,7 @@ static int vbus_is_present(void)
 
 static int sync_uart_to_vbus_status(void)
 {
+	int err;
 	int present;
 
 	present = vbus_is_present();
@@ -124,7 +312,14 @@ static int sync_uart_to_vbus_status(void)
 		return present;
 	}
 
-	return present ? uart_enable() : uart_disable();
+	err = present ? uart_enable() : uart_disable();
+	if (err) {
+		return err;
+	}
+
+	idle_vbus_update(present);
+
+	return 0;
 }
 
 static void event_callback(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
@@ -141,6 +336,8 @@ static void event_callback(const struct device *dev, struct gpio_callback *cb, u
 		if (err) {
 			LOG_ERR("uart_enable, error: %d", err);
 		}
+
+		idle_vbus_update(true);
 	}
 
 	if (pins & BIT(NPM13XX_EVENT_VBUS_REMOVED)) {
@@ -150,9 +347,75 @@ static void event_callback(const struct device *dev, struct gpio_callback *cb, u
 		if (err) {
 			LOG_ERR("uart_disable, error: %d", err);
 		}
+
+		idle_vbus_update(false);
 	}
 }
 
+#if defined(CONFIG_APP_UART_POWER_CONTROL_SHELL)
+static void uart_suspend_work_fn(struct k_work *work)
+{
+	int err;
+
+	ARG_UNUSED(work);
+
+	err = uart_disable();
+	if (err) {
+		LOG_ERR("uart_disable, error: %d", err);
+	}
+}
+
+static void uart_resume_work_fn(struct k_work *work)
+{
+	int err;
+
+	ARG_UNUSED(work);
+
+	err = uart_enable();
+	if (err) {
+		LOG_ERR("uart_enable, error: %d", err);
+	}
+}
+
+static K_WORK_DEFINE(uart_suspend_work, uart_suspend_work_fn);
+static K_WORK_DELAYABLE_DEFINE(uart_resume_work, uart_resume_work_fn);
+
+static int cmd_suspend(const struct shell *sh, size_t argc, char **argv)
+{
+	int err = 0;
+	unsigned long seconds;
+
+	ARG_UNUSED(argc);
+
+	seconds = shell_strtoul(argv[1], 10, &err);
+	if (err || (seconds == 0)) {
+		(void)shell_error(sh, "Invalid duration: %s", argv[1]);
+		return -EINVAL;
+	}
+
+	(void)shell_print(sh, "Suspending UART for %lu seconds", seconds);
+
+	/* Suspend from the work queue so that the shell can finish printing first */
+	(void)k_work_submit(&uart_suspend_work);
+	(void)k_work_reschedule(&uart_resume_work, K_SECONDS(seconds));
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_cmds,
+			       SHELL_CMD_ARG(suspend,
+					     NULL,
+					     "Suspend the UARTs for <seconds>, then resume them",
+					     cmd_suspend, 2, 0),
+			       SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(att_uart,
+		   &sub_cmds,
+		   "Asset Tracker Template UART power control commands",
+		   NULL);
+#endif /* CONFIG_APP_UART_POWER_CONTROL_SHELL */
+
 /**
  * @brief Modem library initialization callback.
  *
@@ -228,6 +491,12 @@ static void uart_power_control_thread(void *p1, void *p2, void *p3)
 
 	LOG_DBG("Modem library initialized; setting up VBUS events");
 
+	ret = idle_init();
+	if (ret) {
+		LOG_ERR("idle_init, error: %d", ret);
+		return;
+	}
+
 	ret = subscribe_to_vbus_events(pmic_dev, &event_cb);
 	if (ret) {
 		LOG_ERR("subscribe_to_vbus_events, error: %d", ret);
@@ -17,6 +17,11 @@
 #include "cloud.h"
 #include "network.h"
 #include "app_common.h"
+#include "cloud_backoff.h"
+#if defined(CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH)
+#include "storage.h"
+#include "cloud_transport.h"
+#endif /* CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH */
 
 /* Define FOTA and Location channels to avoid build warning due to the module being patched out
  * because they are not supported with the MQTT cloud.
@@ -48,7 +53,9 @@ ZBUS_MSG_SUBSCRIBER_DEFINE(cloud_subscriber);
 
 #define CHANNEL_LIST(X)						\
 		X(network_chan,	struct network_msg)		\
-		X(cloud_chan, struct cloud_msg)
+		X(cloud_chan, struct cloud_msg)			\
+		IF_ENABLED(CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH,	\
+			   (X(storage_chan, struct storage_msg)))
 
 /* Calculate the maximum message size from the list of channels */
 #define MAX_MSG_SIZE			MAX_MSG_SIZE_FROM_LIST(CHANNEL_LIST)
@@ -101,10 +108,16 @@ NRF_MODEM_LIB_ON_INIT(att_cloud_mqtt_hook, on_modem_init, NULL);
 enum priv_cloud_msg_type {
 	CLOUD_CONNECTION_ATTEMPTED,
 	CLOUD_BACKOFF_EXPIRED,
+	CLOUD_PUBACK_RECEIVED,
+	CLOUD_PUBACK_TIMEOUT,
 };
 
 struct priv_cloud_msg {
 	enum priv_cloud_msg_type type;
+
+	/* Message ID and result of the publication, valid for CLOUD_PUBACK_RECEIVED */
+	uint16_t message_id;
+	int result;
 };
 
 /* Create private cloud channel for internal messaging that is not intended for external use.
@@ -124,6 +137,29 @@ ZBUS_CHAN_DEFINE(priv_cloud_chan,
 static void backoff_timer_work_fn(struct k_work *work);
 static K_WORK_DELAYABLE_DEFINE(backoff_timer_work, backoff_timer_work_fn);
 
+/* Set when the broker has kept the session, including the subscriptions, of the previous
+ * connection. Only happens with CONFIG_MQTT_CLEAN_SESSION disabled.
+ */
+static atomic_t mqtt_session_present;
+
+#if defined(CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH)
+BUILD_ASSERT(CONFIG_APP_CLOUD_MQTT_BATCH_PAYLOAD_SIZE >= (1 + STORAGE_MAX_RECORD_SIZE),
+	     "CONFIG_APP_CLOUD_MQTT_BATCH_PAYLOAD_SIZE must fit the largest storage record");
+
+/* Times out the oldest publication of storage items that has not been acknowledged */
+static void puback_timeout_work_fn(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(puback_timeout_work, puback_timeout_work_fn);
+
+/* Payload of the publication that is being built. The MQTT library has written it to the
+ * socket when mqtt_helper_publish() returns, so one buffer is enough for the whole window.
+ */
+static uint8_t batch_payload[CONFIG_APP_CLOUD_MQTT_BATCH_PAYLOAD_SIZE];
+static size_t batch_payload_len;
+
+/* Topic that stored data is published to, set up before connecting */
+static char data_topic[CONFIG_APP_CLOUD_MQTT_TOPIC_SIZE_MAX];
+#endif /* CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH */
+
 /* Forward declarations of state handlers */
 static void state_running_entry(void *o);
 static enum smf_state_result state_running_run(void *o);
@@ -306,6 +342,17 @@ static void connect_to_cloud(const struct cloud_state *state_object)
 		return;
 	}
 
+#if defined(CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH)
+	err = snprintk(data_topic, sizeof(data_topic), "%s/%s",
+		       object->client_id, CONFIG_APP_CLOUD_MQTT_DATA_TOPIC);
+	if ((err < 0) || (err >= sizeof(data_topic))) {
+		LOG_ERR("Data topic buffer too small, len: %d, max: %d",
+			err, sizeof(data_topic));
+		SEND_FATAL_ERROR();
+		return;
+	}
+#endif /* CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH */
+
 	err = mqtt_helper_connect(&conn_params);
 	if (err) {
 		LOG_ERR("Failed connecting to MQTT, error code: %d", err);
@@ -320,20 +367,16 @@ static void connect_to_cloud(const struct cloud_state *state_object)
 
 static uint32_t calculate_backoff_time(uint32_t attempts)
 {
-	uint32_t backoff_time = CONFIG_APP_CLOUD_MQTT_BACKOFF_INITIAL_SECONDS;
-
-	/* Calculate backoff time */
-	if (IS_ENABLED(CONFIG_APP_CLOUD_MQTT_BACKOFF_TYPE_EXPONENTIAL)) {
-		backoff_time = CONFIG_APP_CLOUD_MQTT_BACKOFF_INITIAL_SECONDS << (attempts - 1);
-	} else if (IS_ENABLED(CONFIG_APP_CLOUD_MQTT_BACKOFF_TYPE_LINEAR)) {
-		backoff_time = CONFIG_APP_CLOUD_MQTT_BACKOFF_INITIAL_SECONDS +
-			((attempts - 1) * CONFIG_APP_CLOUD_MQTT_BACKOFF_LINEAR_INCREMENT_SECONDS);
-	}
-
-	/* Limit backoff time */
-	if (backoff_time > CONFIG_APP_CLOUD_MQTT_BACKOFF_MAX_SECONDS) {
-		backoff_time = CONFIG_APP_CLOUD_MQTT_BACKOFF_MAX_SECONDS;
-	}
+	static const struct cloud_backoff_config backoff_config = {
+		.type = IS_ENABLED(CONFIG_APP_CLOUD_MQTT_BACKOFF_TYPE_EXPONENTIAL) ?
+				CLOUD_BACKOFF_EXPONENTIAL :
+			IS_ENABLED(CONFIG_APP_CLOUD_MQTT_BACKOFF_TYPE_LINEAR) ?
+				CLOUD_BACKOFF_LINEAR : CLOUD_BACKOFF_NONE,
+		.initial_seconds = CONFIG_APP_CLOUD_MQTT_BACKOFF_INITIAL_SECONDS,
+		.linear_increment_seconds = CONFIG_APP_CLOUD_MQTT_BACKOFF_LINEAR_INCREMENT_SECONDS,
+		.max_seconds = CONFIG_APP_CLOUD_MQTT_BACKOFF_MAX_SECONDS,
+	};
+	uint32_t backoff_time = cloud_backoff_get(&backoff_config, attempts, false);
 
 	LOG_DBG("Backoff time: %u seconds", backoff_time);
 
@@ -395,6 +438,9 @@ static void on_mqtt_connack(enum mqtt_conn_return_code return_code, bool session
 		return;
 	}
 
+	/* Read in state_connected_entry(), which runs after CLOUD_CONNECTED is received */
+	atomic_set(&mqtt_session_present, session_present);
+
 	err = zbus_chan_pub(&cloud_chan, &cloud_msg, K_SECONDS(1));
 	if (err) {
 		LOG_ERR("zbus_chan_pub, error: %d", err);
@@ -444,7 +490,186 @@ static void on_mqtt_puback(uint16_t message_id, int result)
 	} else {
 		LOG_DBG("Publish acknowledgment received, message id: %d", message_id);
 	}
+
+#if defined(CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH)
+	int err;
+	const struct priv_cloud_msg msg = {
+		.type = CLOUD_PUBACK_RECEIVED,
+		.message_id = message_id,
+		.result = result,
+	};
+
+	/* Storage items are consumed from the cloud module thread */
+	err = zbus_chan_pub(&priv_cloud_chan, &msg, K_SECONDS(1));
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+#endif /* CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH */
+}
+
+#if defined(CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH)
+/* Storage batch upload through the shared cloud transport engine.
+ *
+ * Stored items are packed into binary publications on the data topic. Each item is one byte
+ * with its enum storage_data_type, followed by its compact record as defined in
+ * storage_data_types.h. Up to CONFIG_APP_CLOUD_MQTT_BATCH_WINDOW_SIZE QoS 1 publications are
+ * in flight at a time. The engine consumes the items of a publication from storage when its
+ * PUBACK is received, so that unacknowledged items are sent again in the next session.
+ */
+
+static void puback_timeout_work_fn(struct k_work *work)
+{
+	int err;
+	const struct priv_cloud_msg msg = { .type = CLOUD_PUBACK_TIMEOUT };
+
+	ARG_UNUSED(work);
+
+	err = zbus_chan_pub(&priv_cloud_chan, &msg, K_SECONDS(1));
+	if (err) {
+		LOG_ERR("zbus_chan_pub, error: %d", err);
+		SEND_FATAL_ERROR();
+	}
+}
+
+static const struct storage_data *storage_type_get(enum storage_data_type data_type)
+{
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		if (type->data_type == data_type) {
+			return type;
+		}
+	}
+
+	return NULL;
+}
+
+/* Only claim an item when any record fits, a claimed item cannot be handed back */
+static bool transport_batch_full(void)
+{
+	return (batch_payload_len + 1 + STORAGE_MAX_RECORD_SIZE) > sizeof(batch_payload);
+}
+
+static int transport_batch_add(const struct storage_data_item *item)
+{
+	const struct storage_data *type = storage_type_get(item->type);
+
+	if (type == NULL) {
+		LOG_ERR("Unknown storage data type: %d", item->type);
+
+		return -EINVAL;
+	}
+
+	batch_payload[batch_payload_len] = (uint8_t)item->type;
+	type->encode_record(&item->data, &batch_payload[batch_payload_len + 1]);
+	batch_payload_len += 1 + type->record_size;
+
+	return 0;
+}
+
+static int transport_send_batch(const enum storage_data_type *types, size_t count,
+				uint32_t *id)
+{
+	int err;
+	struct mqtt_publish_param param = {
+		.message.payload.data = batch_payload,
+		.message.payload.len = batch_payload_len,
+		.message.topic.qos = MQTT_QOS_1_AT_LEAST_ONCE,
+		.message.topic.topic.utf8 = data_topic,
+		.message.topic.topic.size = strlen(data_topic),
+		.message_id = mqtt_helper_msg_id_get(),
+	};
+
+	ARG_UNUSED(types);
+
+	LOG_DBG("Publishing %zu storage items, %zu bytes, message id: %d",
+		count, batch_payload_len, param.message_id);
+
+	batch_payload_len = 0;
+
+	err = mqtt_helper_publish(&param);
+	if (err) {
+		LOG_ERR("mqtt_helper_publish, error: %d", err);
+
+		return err;
+	}
+
+	/* Does not extend the timeout of the publications already in flight */
+	(void)k_work_schedule(&puback_timeout_work,
+			      K_SECONDS(CONFIG_APP_CLOUD_MQTT_BATCH_PUBACK_TIMEOUT_SECONDS));
+
+	*id = param.message_id;
+
+	return -EINPROGRESS;
+}
+
+static void transport_batch_discard(void)
+{
+	batch_payload_len = 0;
+}
+
+/* All stored data types are batched */
+static int transport_send_one(const struct storage_data_item *item)
+{
+	ARG_UNUSED(item);
+
+	return -ENOTSUP;
+}
+
+static const struct cloud_transport mqtt_transport = {
+	.name = "MQTT",
+	.window = CONFIG_APP_CLOUD_MQTT_BATCH_WINDOW_SIZE,
+	.batch_max_items = CONFIG_APP_CLOUD_MQTT_BATCH_MAX_ITEMS,
+	.batch_full = transport_batch_full,
+	.batch_add = transport_batch_add,
+	.send_batch = transport_send_batch,
+	.batch_discard = transport_batch_discard,
+	.send_one = transport_send_one,
+};
+
+static void batch_puback_handle(uint16_t message_id, int result)
+{
+	/* Not a publication of the batch, for instance a CLOUD_PAYLOAD_JSON message */
+	if (!cloud_transport_batch_done(message_id, result)) {
+		return;
+	}
+
+	if (cloud_transport_session_active()) {
+		(void)k_work_reschedule(&puback_timeout_work,
+			K_SECONDS(CONFIG_APP_CLOUD_MQTT_BATCH_PUBACK_TIMEOUT_SECONDS));
+	} else {
+		(void)k_work_cancel_delayable(&puback_timeout_work);
+	}
+}
+
+static void batch_close(void)
+{
+	(void)k_work_cancel_delayable(&puback_timeout_work);
+
+	cloud_transport_session_close();
 }
+#endif /* CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH */
+
+#if defined(CONFIG_LTE_LC_PSM_MODULE)
+/* The keep-alive is sent in the CONNECT packet and cannot be changed for a connection.
+ * A ping is only sent when nothing else has been sent for a keep-alive interval, so a keep-alive
+ * at least as long as the periodic TAU means that the ping does not add modem wake-ups.
+ */
+static void keepalive_check(int tau)
+{
+	if (tau <= 0) {
+		LOG_DBG("PSM not granted");
+
+		return;
+	}
+
+	if (CONFIG_MQTT_KEEPALIVE < tau) {
+		LOG_WRN("MQTT keep-alive (%d s) shorter than the periodic TAU (%d s), "
+			"pings will wake the modem", CONFIG_MQTT_KEEPALIVE, tau);
+	} else {
+		LOG_DBG("MQTT keep-alive %d s, periodic TAU %d s", CONFIG_MQTT_KEEPALIVE, tau);
+	}
+}
+#endif /* CONFIG_LTE_LC_PSM_MODULE */
 
 /* Zephyr State Machine Framework handlers */
 
@@ -487,7 +712,39 @@ static enum smf_state_result state_running_run(void *o)
 
 			return SMF_EVENT_HANDLED;
 		}
+
+#if defined(CONFIG_LTE_LC_PSM_MODULE)
+		if (msg->type == NETWORK_PSM_PARAMS) {
+			keepalive_check(msg->psm_cfg.tau);
+
+			return SMF_EVENT_HANDLED;
+		}
+#endif /* CONFIG_LTE_LC_PSM_MODULE */
+	}
+
+#if defined(CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH)
+	/* Batch sessions are only sent in STATE_CONNECTED, close the others right away */
+	if (state_object->chan == &storage_chan) {
+		const struct storage_msg *msg = (const struct storage_msg *)state_object->msg_buf;
+
+		switch (msg->type) {
+		case STORAGE_BATCH_AVAILABLE:
+			__fallthrough;
+		case STORAGE_BATCH_EMPTY:
+			__fallthrough;
+		case STORAGE_BATCH_ERROR:
+			cloud_transport_session_reject(msg->session_id);
+
+			return SMF_EVENT_HANDLED;
+		case STORAGE_BATCH_BUSY:
+			LOG_WRN("Storage batch is busy, will retry later");
+
+			return SMF_EVENT_HANDLED;
+		default:
+			break;
+		}
 	}
+#endif /* CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH */
 
 	return SMF_EVENT_PROPAGATE;
 }
@@ -659,6 +916,12 @@ static void state_connected_entry(void *o)
 	LOG_DBG("%s", __func__);
 	LOG_DBG("Connected to Cloud");
 
+	if (atomic_get(&mqtt_session_present)) {
+		LOG_DBG("Session present, subscriptions are kept by the broker");
+
+		return;
+	}
+
 	for (size_t i = 0; i < list.list_count; i++) {
 		LOG_INF("Subscribing to: %s", (char *)list.list[i].topic.utf8);
 	}
@@ -690,6 +953,34 @@ static enum smf_state_result state_connected_run(void *o)
 		}
 	}
 
+#if defined(CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH)
+	if (state_object->chan == &storage_chan) {
+		const struct storage_msg *msg = (const struct storage_msg *)state_object->msg_buf;
+
+		if (msg->type == STORAGE_BATCH_AVAILABLE) {
+			if (cloud_transport_session_start(&mqtt_transport, msg)) {
+				cloud_transport_session_reject(msg->session_id);
+			}
+
+			return SMF_EVENT_HANDLED;
+		}
+	} else if (state_object->chan == &priv_cloud_chan) {
+		const struct priv_cloud_msg *msg =
+			(const struct priv_cloud_msg *)state_object->msg_buf;
+
+		if (msg->type == CLOUD_PUBACK_RECEIVED) {
+			batch_puback_handle(msg->message_id, msg->result);
+
+			return SMF_EVENT_HANDLED;
+		} else if (msg->type == CLOUD_PUBACK_TIMEOUT) {
+			LOG_WRN("No PUBACK received for storage items");
+			batch_close();
+
+			return SMF_EVENT_HANDLED;
+		}
+	}
+#endif /* CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH */
+
 	return SMF_EVENT_PROPAGATE;
 }
 
@@ -701,6 +992,10 @@ static void state_connected_exit(void *o)
 
 	LOG_DBG("%s", __func__);
 
+#if defined(CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH)
+	batch_close();
+#endif /* CONFIG_APP_CLOUD_MQTT_STORAGE_BATCH */
+
 	err = mqtt_helper_disconnect();
 	if (err) {
 		LOG_ERR("Failed disconnecting from MQTT, error code: %d", err);
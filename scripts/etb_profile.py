@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+"""
+Asset Tracker Template ETB Profiler
+
+This script turns the ETB snapshots of the sampling profiler (CONFIG_APP_ETB_PROFILER) into the
+CPU time per function and flame graphs. Capture the output of the "att_etb_profiler dump"
+shell command to a file, then decode it against the ELF file of the same build:
+
+   Usage:
+     python3 etb_profile.py --dump dump.txt --elf build/app/zephyr/zephyr.elf
+     python3 etb_profile.py --dump dump.txt --elf zephyr.elf --scenario batch_flush \\
+         --folded profile.folded --svg profile.svg
+
+Each snapshot is decoded with the ETB trace decoder in tests/on_target/etb_trace_decoder. The
+CPU time of a function is estimated by the number of instructions it executed in all
+snapshots. Stacks are rebuilt from the calls and returns in the trace, so they start at the
+function that was running when the snapshot began, not at the thread entry.
+
+The folded stacks written with --folded can be opened in https://www.speedscope.app or turned
+into an SVG with flamegraph.pl, which --svg runs if it is found in PATH.
+
+Prerequisites:
+    pip install pyelftools colorama
+    arm-zephyr-eabi-objdump and arm-zephyr-eabi-objcopy in PATH, or given with --objdump and
+    --objcopy.
+"""
+
+import sys
+import argparse
+import logging
+import os
+import re
+import shutil
+import struct
+import subprocess
+import tempfile
+from collections import Counter, defaultdict
+from dataclasses import dataclass, field
+from typing import Dict, List
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.realpath(__file__)), "..", "tests",
+                                "on_target", "etb_trace_decoder"))
+
+import etb_decoder  # noqa: E402
+
+# Configure logging
+logging.basicConfig(level=logging.INFO, format='%(message)s')
+logger = logging.getLogger(__name__)
+
+SNAPSHOT_REGEX = re.compile(r"etb_snapshot (\d+) (\w+) (\d+) (\d+)")
+DATA_REGEX = re.compile(r"^(?:[0-9a-fA-F]{8}\s*)+$")
+
+# Functions that are reported as a group, matched against any frame of a stack
+CATEGORIES = {
+    "CBOR": re.compile(r"cbor|zcbor"),
+    "memcpy/memset": re.compile(r"^(memcpy|memmove|memset|__aeabi_mem\w+)$"),
+    "Logging": re.compile(r"^(z_log|log_|z_impl_z_log|cbprintf|z_cbvprintf)"),
+    "zbus": re.compile(r"^(zbus_|z_impl_zbus_)"),
+    "Storage": re.compile(r"^(storage_|ram_ring_buffer_|littlefs_|lfs_)"),
+}
+
+
+@dataclass
+class Snapshot:
+    """One ETB snapshot from the dump."""
+    index: int
+    scenario: str
+    uptime_ms: int
+    data: bytearray = field(default_factory=bytearray)
+
+
+@dataclass
+class Profile:
+    """Instructions per function and per stack of one scenario."""
+    self_instr: Counter = field(default_factory=Counter)
+    stacks: Counter = field(default_factory=Counter)
+    total: int = 0
+
+
+def dump_parse(path: str) -> List[Snapshot]:
+    """Read the snapshots from captured shell output, other lines are skipped."""
+    snapshots = []
+    current = None
+
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            match = SNAPSHOT_REGEX.search(line)
+
+            if match:
+                current = Snapshot(int(match.group(1)), match.group(2), int(match.group(3)))
+                snapshots.append(current)
+            elif "etb_profile end" in line:
+                current = None
+            elif current is not None and DATA_REGEX.match(line):
+                for word in line.split():
+                    current.data += struct.pack("<I", int(word, 16))
+
+    return snapshots
+
+
+def snapshot_profile(snapshot: Snapshot, elf: str, assembly: Dict, profile: Profile) -> None:
+    """Add the instructions of one snapshot to the profile of its scenario."""
+    with tempfile.TemporaryDirectory() as tmp:
+        trace_file = os.path.join(tmp, "etb_buf")
+
+        with open(trace_file, "wb") as f:
+            f.write(snapshot.data)
+
+        decoded = etb_decoder.decode_trace(trace_file, elf, None)
+
+    stack: List[str] = []
+    pending = None
+
+    for line in etb_decoder.parse_decoder_output(decoded):
+        if isinstance(line, etb_decoder.ExceptionLine):
+            pending = "exception"
+            continue
+
+        if isinstance(line, etb_decoder.ExceptionReturnLine):
+            pending = "exception_return"
+            continue
+
+        addr = int(line.addr_start, 16)
+        _, symbol = assembly.get(addr, (None, f"unknown@{addr:#x}"))
+
+        if pending == "call":
+            stack.append(symbol)
+        elif pending == "exception":
+            stack += ["[exception]", symbol]
+        elif pending == "exception_return" and "[exception]" in stack:
+            stack = stack[:len(stack) - stack[::-1].index("[exception]") - 1]
+        elif pending == "return" and stack:
+            stack.pop()
+
+        # Branches and tail calls stay at the same depth, unknown callers start a new stack
+        if not stack:
+            stack = [symbol]
+        elif stack[-1] != symbol:
+            stack[-1] = symbol
+
+        instructions = int(line.num_i)
+
+        profile.self_instr[symbol] += instructions
+        profile.stacks[tuple(stack)] += instructions
+        profile.total += instructions
+
+        if line.last_instr_subtype == "b+link ":
+            pending = "call"
+        elif line.last_instr_subtype == "V7:impl ret":
+            pending = "return"
+        else:
+            pending = None
+
+
+def report(name: str, profile: Profile, top: int) -> None:
+    """Log the functions with the most instructions, and the share of each category."""
+    total = max(profile.total, 1)
+    categories: Counter = Counter()
+
+    for stack, count in profile.stacks.items():
+        for category, pattern in CATEGORIES.items():
+            if any(pattern.search(frame) for frame in stack):
+                categories[category] += count
+
+    logger.info("\n== %s: %d instructions ==", name, profile.total)
+    logger.info("%10s %7s  %s", "Instr", "Share", "Function")
+
+    for symbol, count in profile.self_instr.most_common(top):
+        logger.info("%10d %6.1f%%  %s", count, 100 * count / total, symbol)
+
+    logger.info("\n%10s %7s  %s", "Instr", "Share", "Category (including callees)")
+
+    for category in CATEGORIES:
+        count = categories[category]
+        logger.info("%10d %6.1f%%  %s", count, 100 * count / total, category)
+
+
+def folded_write(path: str, profiles: Dict[str, Profile]) -> None:
+    """Write the stacks in the folded format of flamegraph.pl, with the scenario as root."""
+    with open(path, "w") as f:
+        for name, profile in profiles.items():
+            for stack, count in sorted(profile.stacks.items()):
+                f.write(f"{name};{';'.join(stack)} {count}\n")
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Profile CPU time from ETB snapshots")
+    parser.add_argument("--dump", required=True, help="Output of 'att_etb_profiler dump'")
+    parser.add_argument("--elf", required=True, help="ELF file of the profiled build")
+    parser.add_argument("--scenario", help="Only use the snapshots of this scenario")
+    parser.add_argument("--top", type=int, default=20, help="Number of functions to list")
+    parser.add_argument("--folded", help="File for the folded stacks")
+    parser.add_argument("--svg", help="File for a flame graph, needs flamegraph.pl in PATH")
+    parser.add_argument("--objdump", help="Path to objdump (default: arm-zephyr-eabi-objdump)")
+    parser.add_argument("--objcopy", help="Path to objcopy (default: arm-zephyr-eabi-objcopy)")
+    args = parser.parse_args()
+
+    if args.objdump:
+        etb_decoder.OBJDUMP_PATH = args.objdump
+
+    if args.objcopy:
+        etb_decoder.OBJCOPY_PATH = args.objcopy
+
+    snapshots = [s for s in dump_parse(args.dump)
+                 if args.scenario is None or s.scenario == args.scenario]
+
+    if not snapshots:
+        logger.error("No snapshots found in %s", args.dump)
+        return 1
+
+    assembly = etb_decoder.disassemble_elf(args.elf)
+    profiles: Dict[str, Profile] = defaultdict(Profile)
+
+    for snapshot in snapshots:
+        logger.info("Decoding snapshot %d (%s, %d ms)", snapshot.index, snapshot.scenario,
+                    snapshot.uptime_ms)
+        snapshot_profile(snapshot, args.elf, assembly, profiles[snapshot.scenario])
+
+    for name, profile in profiles.items():
+        report(name, profile, args.top)
+
+    folded = args.folded
+
+    if args.svg and not folded:
+        folded = os.path.splitext(args.svg)[0] + ".folded"
+
+    if folded:
+        folded_write(folded, profiles)
+        logger.info("\nFolded stacks written to %s", folded)
+
+    if args.svg:
+        flamegraph = shutil.which("flamegraph.pl")
+
+        if flamegraph is None:
+            logger.error("flamegraph.pl not found in PATH, use the folded stacks instead")
+            return 1
+
+        with open(args.svg, "w") as f:
+            subprocess.run([flamegraph, "--title", "ETB profile", "--countname",
+                            "instructions", folded], stdout=f, check=True)
+
+        logger.info("Flame graph written to %s", args.svg)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
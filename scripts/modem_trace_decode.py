@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+Asset Tracker Template Modem Trace Snapshot Decoder
+
+This script decodes a modem trace snapshot uploaded by the modem trace ring buffer
+(CONFIG_APP_MODEM_TRACE_RING). Download the custom data recording from the Memfault issue or
+device timeline, then convert it to a raw modem trace:
+
+   Usage:
+     python3 modem_trace_decode.py --input snapshot.bin --output modem_trace.bin
+
+The raw trace can be converted to PCAPNG with nRF Util or the Cellular Monitor application:
+
+     nrfutil trace lte --input-file modem_trace.bin --output-pcapng trace.pcapng
+
+The snapshot starts with a header that describes the blocks, followed by the blocks. Each
+block is either stored as is or compressed in the LZ4 block format. No third party packages
+are required.
+"""
+
+import sys
+import argparse
+import logging
+import struct
+from typing import List
+
+# Configure logging
+logging.basicConfig(level=logging.INFO, format='%(message)s')
+logger = logging.getLogger(__name__)
+
+SNAPSHOT_MAGIC = 0x4d545253
+SNAPSHOT_VERSION = 1
+BLOCK_RAW = 0x8000
+
+# magic, version, trigger, block_size, raw_size, uptime_s, block_count, table_size
+HEADER_FORMAT = "<IBBHIIHH"
+
+TRIGGERS = {
+    1: "Attach rejected",
+    2: "Cloud connection failed",
+    3: "Watchdog",
+}
+
+
+def lz4_block_decompress(data: bytes, max_size: int) -> bytes:
+    """Decompress one block in the LZ4 block format."""
+    out = bytearray()
+    idx = 0
+
+    def length_read(length: int) -> int:
+        nonlocal idx
+
+        if length == 15:
+            while True:
+                extra = data[idx]
+                idx += 1
+                length += extra
+                if extra != 255:
+                    break
+
+        return length
+
+    while idx < len(data):
+        token = data[idx]
+        idx += 1
+
+        literals = length_read(token >> 4)
+        out += data[idx:idx + literals]
+        idx += literals
+
+        # The last sequence has no match
+        if idx >= len(data):
+            break
+
+        offset, = struct.unpack_from("<H", data, idx)
+        idx += 2
+
+        if offset == 0 or offset > len(out):
+            raise ValueError(f"Invalid match offset {offset}")
+
+        match_len = length_read(token & 0x0F) + 4
+
+        # Matches can overlap the bytes they produce, so copy one byte at a time
+        start = len(out) - offset
+        for i in range(match_len):
+            out.append(out[start + i])
+
+        if len(out) > max_size:
+            raise ValueError("Block decompresses to more than the block size")
+
+    return bytes(out)
+
+
+def snapshot_decode(snapshot: bytes) -> bytes:
+    """Decode a snapshot to the raw modem trace."""
+    header_size = struct.calcsize(HEADER_FORMAT)
+
+    if len(snapshot) < header_size:
+        raise ValueError("Snapshot is shorter than its header")
+
+    (magic, version, trigger, block_size, raw_size, uptime_s, block_count,
+     table_size) = struct.unpack_from(HEADER_FORMAT, snapshot)
+
+    if magic != SNAPSHOT_MAGIC or version != SNAPSHOT_VERSION:
+        raise ValueError("Not a modem trace snapshot, or an unsupported version")
+
+    block_len: List[int] = list(struct.unpack_from(f"<{table_size}H", snapshot, header_size))
+    idx = header_size + 2 * table_size
+    trace = bytearray()
+
+    logger.info("Trigger: %s, %d s after boot", TRIGGERS.get(trigger, "Unknown"), uptime_s)
+
+    for i in range(block_count):
+        length = block_len[i] & ~BLOCK_RAW
+        block = snapshot[idx:idx + length]
+        idx += length
+
+        if len(block) != length:
+            raise ValueError(f"Snapshot ends in block {i}")
+
+        if block_len[i] & BLOCK_RAW:
+            trace += block
+        else:
+            trace += lz4_block_decompress(block, block_size)
+
+    if len(trace) != raw_size:
+        logger.warning("Decoded %d bytes, expected %d", len(trace), raw_size)
+
+    logger.info("Decoded %d bytes of modem traces from %d bytes", len(trace), len(snapshot))
+
+    return bytes(trace)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Decode a modem trace snapshot")
+    parser.add_argument("--input", required=True, help="Snapshot downloaded from Memfault")
+    parser.add_argument("--output", required=True, help="File for the raw modem trace")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        snapshot = f.read()
+
+    try:
+        trace = snapshot_decode(snapshot)
+    except (ValueError, IndexError, struct.error) as e:
+        logger.error("Failed to decode snapshot: %s", e)
+        return 1
+
+    with open(args.output, "wb") as f:
+        f.write(trace)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+"""
+Asset Tracker Template Storage Export Decoder
+
+This script decodes the binary export of the storage module, written to the shell UART by the
+"att_storage export" command (CONFIG_APP_STORAGE_SHELL_EXPORT). It supports two modes of
+operation:
+
+1. SERIAL (default):
+   Opens the shell UART, sends the export command and decodes the frames until the end frame
+   is received.
+
+   Usage:
+     python3 storage_export_decode.py --port /dev/ttyACM0
+     python3 storage_export_decode.py --port /dev/ttyACM0 --baudrate 115200 --output out.jsonl
+
+2. CAPTURE FILE:
+   Decodes a raw capture of the UART, for example from a logic analyzer or terminal program.
+
+   Usage:
+     python3 storage_export_decode.py --input capture.bin
+
+Frames are COBS encoded and separated by zero bytes. Each frame ends with a CRC32 (IEEE,
+little-endian) over the rest of the frame. Data between frames, such as shell and log output,
+is skipped. Each record is written as one JSON object per line, with the payload as hex.
+
+Prerequisites:
+    pip install pyserial
+
+    Note: pyserial is only required for serial mode, not for capture files.
+"""
+
+import sys
+import argparse
+import binascii
+import json
+import logging
+import struct
+import time
+from typing import Dict, Iterator, Optional
+
+# Configure logging
+logging.basicConfig(level=logging.INFO, format='%(message)s')
+logger = logging.getLogger(__name__)
+
+FORMAT_VERSION = 1
+FRAME_HEADER = 0x01
+FRAME_RECORD = 0x02
+FRAME_END = 0x03
+
+EXPORT_COMMAND = b"att_storage export\r\n"
+
+
+def cobs_decode(data: bytes) -> Optional[bytes]:
+    """Decode a COBS encoded frame, without the zero delimiter. Returns None if invalid."""
+    out = bytearray()
+    idx = 0
+
+    while idx < len(data):
+        code = data[idx]
+        if code == 0 or idx + code > len(data):
+            return None
+
+        out += data[idx + 1:idx + code]
+        idx += code
+
+        if code != 0xFF and idx < len(data):
+            out.append(0)
+
+    return bytes(out)
+
+
+def frame_check(frame: bytes) -> Optional[bytes]:
+    """Check the CRC32 at the end of a decoded frame and return the frame without it."""
+    if len(frame) < 5:
+        return None
+
+    crc, = struct.unpack_from("<I", frame, len(frame) - 4)
+    if binascii.crc32(frame[:-4]) != crc:
+        return None
+
+    return frame[:-4]
+
+
+def frames_split(chunks: Iterator[bytes]) -> Iterator[bytes]:
+    """Split a byte stream on zero bytes and yield the non-empty parts."""
+    pending = bytearray()
+
+    for chunk in chunks:
+        pending += chunk
+
+        while True:
+            end = pending.find(0)
+            if end < 0:
+                break
+
+            part = bytes(pending[:end])
+            del pending[:end + 1]
+
+            if part:
+                yield part
+
+
+class ExportDecoder:
+    """Decode the frames of one export and write the records as JSON lines."""
+
+    def __init__(self, output):
+        self.output = output
+        self.types: Dict[int, Dict] = {}
+        self.expected_count: Optional[int] = None
+        self.next_sequence = 0
+        self.records = 0
+        self.missing = 0
+        self.bad_frames = 0
+        self.done = False
+
+    def header_parse(self, frame: bytes) -> None:
+        if len(frame) < 6 or frame[1] != FORMAT_VERSION:
+            logger.error("Unsupported export format version")
+            self.bad_frames += 1
+            return
+
+        self.expected_count, = struct.unpack_from("<I", frame, 2)
+        self.types = {}
+        self.next_sequence = 0
+        idx = 6
+
+        while idx + 4 <= len(frame):
+            type_id = frame[idx]
+            size, = struct.unpack_from("<H", frame, idx + 1)
+            name_len = frame[idx + 3]
+            name = frame[idx + 4:idx + 4 + name_len].decode("utf-8", errors="replace")
+            idx += 4 + name_len
+
+            self.types[type_id] = {"name": name, "size": size}
+
+        logger.info("Export of %d records, %d data types", self.expected_count,
+                    len(self.types))
+
+    def record_parse(self, frame: bytes) -> None:
+        if len(frame) < 6:
+            self.bad_frames += 1
+            return
+
+        type_id = frame[1]
+        sequence, = struct.unpack_from("<I", frame, 2)
+        payload = frame[6:]
+        data_type = self.types.get(type_id, {"name": f"type_{type_id}", "size": None})
+
+        if sequence != self.next_sequence:
+            logger.warning("Missing records %d to %d", self.next_sequence, sequence - 1)
+            self.missing += max(sequence - self.next_sequence, 0)
+
+        self.next_sequence = sequence + 1
+        self.records += 1
+
+        if data_type["size"] is not None and len(payload) != data_type["size"]:
+            logger.warning("Record %d has %d bytes, expected %d", sequence, len(payload),
+                           data_type["size"])
+
+        self.output.write(json.dumps({
+            "sequence": sequence,
+            "type": data_type["name"],
+            "type_id": type_id,
+            "data": payload.hex(),
+        }) + "\n")
+
+    def end_parse(self, frame: bytes) -> None:
+        if len(frame) < 5:
+            self.bad_frames += 1
+            return
+
+        count, = struct.unpack_from("<I", frame, 1)
+
+        if count > self.next_sequence:
+            logger.warning("Missing records %d to %d", self.next_sequence, count - 1)
+            self.missing += count - self.next_sequence
+
+        self.done = True
+
+    def feed(self, encoded: bytes) -> None:
+        decoded = cobs_decode(encoded)
+        frame = frame_check(decoded) if decoded is not None else None
+
+        if frame is None:
+            # Shell and log output also ends up here, only count data that looks binary
+            if any(b < 0x09 or b > 0x7E for b in encoded):
+                self.bad_frames += 1
+            return
+
+        kind = frame[0]
+
+        if kind == FRAME_HEADER:
+            self.header_parse(frame)
+        elif kind == FRAME_RECORD:
+            self.record_parse(frame)
+        elif kind == FRAME_END:
+            self.end_parse(frame)
+        else:
+            self.bad_frames += 1
+
+    def summary(self) -> int:
+        logger.info("Decoded %d records, %d missing, %d bad frames", self.records,
+                    self.missing, self.bad_frames)
+
+        if not self.done:
+            logger.error("End of export not received")
+            return 1
+
+        return 1 if (self.missing or self.bad_frames) else 0
+
+
+def file_chunks(path: str) -> Iterator[bytes]:
+    with open(path, "rb") as f:
+        while True:
+            chunk = f.read(4096)
+            if not chunk:
+                return
+            yield chunk
+
+
+def serial_chunks(port: str, baudrate: int, timeout: float) -> Iterator[bytes]:
+    import serial
+
+    with serial.Serial(port, baudrate, timeout=0.1) as ser:
+        ser.reset_input_buffer()
+        ser.write(EXPORT_COMMAND)
+
+        last_data = time.monotonic()
+
+        while time.monotonic() - last_data < timeout:
+            chunk = ser.read(4096)
+            if chunk:
+                last_data = time.monotonic()
+                yield chunk
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Decode the binary export of the storage module")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="Serial port of the shell UART")
+    source.add_argument("--input", help="Raw capture of the shell UART")
+    parser.add_argument("--baudrate", type=int, default=115200, help="Baud rate of the port")
+    parser.add_argument("--timeout", type=float, default=5.0,
+                        help="Seconds without data before giving up on the serial port")
+    parser.add_argument("--output", help="File for the JSON lines, default is stdout")
+    args = parser.parse_args()
+
+    output = open(args.output, "w") if args.output else sys.stdout
+
+    try:
+        decoder = ExportDecoder(output)
+
+        if args.port:
+            chunks = serial_chunks(args.port, args.baudrate, args.timeout)
+        else:
+            chunks = file_chunks(args.input)
+
+        for encoded in frames_split(chunks):
+            decoder.feed(encoded)
+
+            if decoder.done:
+                break
+
+        return decoder.summary()
+    finally:
+        if output is not sys.stdout:
+            output.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "cloud_transport.h"
+#include "storage.h"
+
+DEFINE_FFF_GLOBALS;
+
+FAKE_VALUE_FUNC(int, storage_batch_claim, const struct storage_data_item **, k_timeout_t);
+FAKE_VOID_FUNC(storage_batch_release, const struct storage_data_item *);
+FAKE_VALUE_FUNC(int, transport_batch_add, const struct storage_data_item *);
+FAKE_VALUE_FUNC(int, transport_send_batch, const enum storage_data_type *, size_t, uint32_t *);
+FAKE_VOID_FUNC(transport_batch_discard);
+FAKE_VALUE_FUNC(int, transport_send_one, const struct storage_data_item *);
+FAKE_VOID_FUNC(transport_session_done, uint32_t);
+
+static void storage_chan_cb(const struct zbus_channel *chan);
+
+ZBUS_CHAN_DEFINE(storage_chan,
+		 struct storage_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_LISTENER_DEFINE(storage_test_listener, storage_chan_cb);
+ZBUS_CHAN_ADD_OBS(storage_chan, storage_test_listener, 0);
+
+#define SESSION_ID	0x11111111
+#define ITEMS_MAX	8
+
+static const struct cloud_transport transport = {
+	.name = "test",
+	.window = 2,
+	.batch_max_items = 2,
+	.batch_add = transport_batch_add,
+	.send_batch = transport_send_batch,
+	.batch_discard = transport_batch_discard,
+	.send_one = transport_send_one,
+	.session_done = transport_session_done,
+};
+
+/* Items handed out by storage_batch_claim, followed by claim_error or -EAGAIN */
+static struct storage_data_item items[ITEMS_MAX];
+static size_t item_count;
+static size_t items_claimed;
+static int claim_error;
+
+/* Identifier of the next batch sent */
+static uint32_t next_batch_id;
+
+/* Messages sent to the storage module */
+static struct storage_msg storage_msgs[ITEMS_MAX];
+static size_t storage_msg_count;
+
+static void storage_chan_cb(const struct zbus_channel *chan)
+{
+	TEST_ASSERT_LESS_THAN(ITEMS_MAX, storage_msg_count);
+
+	storage_msgs[storage_msg_count++] = *(const struct storage_msg *)zbus_chan_const_msg(chan);
+}
+
+static int storage_batch_claim_custom(const struct storage_data_item **item, k_timeout_t timeout)
+{
+	ARG_UNUSED(timeout);
+
+	if (items_claimed < item_count) {
+		*item = &items[items_claimed++];
+
+		return 0;
+	}
+
+	return claim_error;
+}
+
+static int transport_send_batch_custom(const enum storage_data_type *types, size_t count,
+				       uint32_t *id)
+{
+	ARG_UNUSED(types);
+	ARG_UNUSED(count);
+
+	*id = next_batch_id++;
+
+	return -EINPROGRESS;
+}
+
+static void items_set(const enum storage_data_type *types, size_t count)
+{
+	TEST_ASSERT_LESS_OR_EQUAL(ITEMS_MAX, count);
+
+	for (size_t i = 0; i < count; i++) {
+		items[i].type = types[i];
+	}
+
+	item_count = count;
+}
+
+static void session_start(void)
+{
+	struct storage_msg msg = {
+		.type = STORAGE_BATCH_AVAILABLE,
+		.session_id = SESSION_ID,
+		.data_len = item_count,
+	};
+
+	TEST_ASSERT_EQUAL(0, cloud_transport_session_start(&transport, &msg));
+}
+
+static void assert_storage_msg(size_t index, enum storage_msg_type type,
+			       enum storage_data_type data_type, uint32_t data_len)
+{
+	TEST_ASSERT_LESS_THAN(storage_msg_count, index);
+	TEST_ASSERT_EQUAL(type, storage_msgs[index].type);
+	TEST_ASSERT_EQUAL(SESSION_ID, storage_msgs[index].session_id);
+
+	if (type == STORAGE_BATCH_CONSUME_N) {
+		TEST_ASSERT_EQUAL(data_type, storage_msgs[index].data_type);
+		TEST_ASSERT_EQUAL(data_len, storage_msgs[index].data_len);
+	}
+}
+
+void setUp(void)
+{
+	RESET_FAKE(storage_batch_claim);
+	RESET_FAKE(storage_batch_release);
+	RESET_FAKE(transport_batch_add);
+	RESET_FAKE(transport_send_batch);
+	RESET_FAKE(transport_batch_discard);
+	RESET_FAKE(transport_send_one);
+	RESET_FAKE(transport_session_done);
+	FFF_RESET_HISTORY();
+
+	storage_batch_claim_fake.custom_fake = storage_batch_claim_custom;
+	transport_send_batch_fake.custom_fake = transport_send_batch_custom;
+
+	item_count = 0;
+	items_claimed = 0;
+	claim_error = -EAGAIN;
+	next_batch_id = 1;
+	storage_msg_count = 0;
+}
+
+void tearDown(void)
+{
+	/* Leave no session behind for the next test */
+	cloud_transport_session_close();
+}
+
+void test_batches_consumed_in_read_order(void)
+{
+	const enum storage_data_type types[] = {
+		STORAGE_TYPE_BATTERY, STORAGE_TYPE_BATTERY,
+		STORAGE_TYPE_ENVIRONMENTAL, STORAGE_TYPE_ENVIRONMENTAL,
+		STORAGE_TYPE_BATTERY,
+	};
+
+	items_set(types, ARRAY_SIZE(types));
+	session_start();
+
+	/* Two batches fill the window */
+	TEST_ASSERT_EQUAL(2, transport_send_batch_fake.call_count);
+	TEST_ASSERT_EQUAL(4, items_claimed);
+
+	/* The second batch waits for the first one */
+	TEST_ASSERT_TRUE(cloud_transport_batch_done(2, 0));
+	TEST_ASSERT_EQUAL(0, storage_msg_count);
+
+	/* Reported once only */
+	TEST_ASSERT_FALSE(cloud_transport_batch_done(2, 0));
+
+	TEST_ASSERT_TRUE(cloud_transport_batch_done(1, 0));
+	TEST_ASSERT_EQUAL(2, storage_msg_count);
+	assert_storage_msg(0, STORAGE_BATCH_CONSUME_N, STORAGE_TYPE_BATTERY, 2);
+	assert_storage_msg(1, STORAGE_BATCH_CONSUME_N, STORAGE_TYPE_ENVIRONMENTAL, 2);
+
+	/* The window has room again for the last item */
+	TEST_ASSERT_EQUAL(3, transport_send_batch_fake.call_count);
+	TEST_ASSERT_EQUAL(1, transport_send_batch_fake.arg1_history[2]);
+	TEST_ASSERT_TRUE(cloud_transport_session_active());
+
+	TEST_ASSERT_TRUE(cloud_transport_batch_done(3, 0));
+	TEST_ASSERT_EQUAL(4, storage_msg_count);
+	assert_storage_msg(2, STORAGE_BATCH_CONSUME_N, STORAGE_TYPE_BATTERY, 1);
+	assert_storage_msg(3, STORAGE_BATCH_CLOSE, STORAGE_DATA_UNKNOWN, 0);
+
+	TEST_ASSERT_FALSE(cloud_transport_session_active());
+	TEST_ASSERT_EQUAL(1, transport_session_done_fake.call_count);
+	TEST_ASSERT_EQUAL(ARRAY_SIZE(types), transport_session_done_fake.arg0_val);
+}
+
+void test_failed_batch_closes_session(void)
+{
+	const enum storage_data_type types[] = {
+		STORAGE_TYPE_BATTERY, STORAGE_TYPE_BATTERY,
+		STORAGE_TYPE_ENVIRONMENTAL, STORAGE_TYPE_ENVIRONMENTAL,
+		STORAGE_TYPE_BATTERY, STORAGE_TYPE_BATTERY,
+	};
+
+	items_set(types, ARRAY_SIZE(types));
+	session_start();
+
+	TEST_ASSERT_EQUAL(2, transport_send_batch_fake.call_count);
+
+	/* Delivered, but after a batch that fails */
+	TEST_ASSERT_TRUE(cloud_transport_batch_done(2, 0));
+	TEST_ASSERT_TRUE(cloud_transport_batch_done(1, -ETIMEDOUT));
+
+	/* Nothing is consumed, both batches are sent again in the next session */
+	TEST_ASSERT_EQUAL(1, storage_msg_count);
+	assert_storage_msg(0, STORAGE_BATCH_CLOSE, STORAGE_DATA_UNKNOWN, 0);
+
+	TEST_ASSERT_FALSE(cloud_transport_session_active());
+	TEST_ASSERT_EQUAL(2, transport_send_batch_fake.call_count);
+	TEST_ASSERT_EQUAL(0, transport_session_done_fake.arg0_val);
+
+	/* Late results of the closed session are not consumed */
+	TEST_ASSERT_FALSE(cloud_transport_batch_done(1, 0));
+	TEST_ASSERT_EQUAL(1, storage_msg_count);
+}
+
+void test_fill_error_waits_for_batches_in_flight(void)
+{
+	const enum storage_data_type types[] = {
+		STORAGE_TYPE_BATTERY, STORAGE_TYPE_BATTERY,
+		STORAGE_TYPE_ENVIRONMENTAL,
+	};
+
+	items_set(types, ARRAY_SIZE(types));
+	claim_error = -EIO;
+	session_start();
+
+	/* The second batch is dropped after its first item, the first one is in flight */
+	TEST_ASSERT_EQUAL(1, transport_send_batch_fake.call_count);
+	TEST_ASSERT_EQUAL(3, transport_batch_add_fake.call_count);
+	TEST_ASSERT_EQUAL(1, transport_batch_discard_fake.call_count);
+	TEST_ASSERT_EQUAL(0, storage_msg_count);
+	TEST_ASSERT_TRUE(cloud_transport_session_active());
+
+	/* The session is closed once the batch in flight is done, without claiming more */
+	TEST_ASSERT_TRUE(cloud_transport_batch_done(1, 0));
+
+	TEST_ASSERT_EQUAL(2, storage_msg_count);
+	assert_storage_msg(0, STORAGE_BATCH_CONSUME_N, STORAGE_TYPE_BATTERY, 2);
+	assert_storage_msg(1, STORAGE_BATCH_CLOSE, STORAGE_DATA_UNKNOWN, 0);
+
+	TEST_ASSERT_FALSE(cloud_transport_session_active());
+	TEST_ASSERT_EQUAL(4, storage_batch_claim_fake.call_count);
+	TEST_ASSERT_EQUAL(2, transport_session_done_fake.arg0_val);
+}
+
+/* This is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
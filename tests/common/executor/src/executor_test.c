@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+#include <zephyr/smf.h>
+#include <zephyr/task_wdt/task_wdt.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "executor.h"
+
+DEFINE_FFF_GLOBALS;
+
+FAKE_VALUE_FUNC(int, task_wdt_feed, int);
+FAKE_VALUE_FUNC(int, task_wdt_add, uint32_t, task_wdt_callback_t, void *);
+
+struct test_msg {
+	int value;
+};
+
+struct test_state_object {
+	/* This must be first */
+	struct smf_ctx ctx;
+
+	const struct zbus_channel *chan;
+
+	uint8_t msg_buf[sizeof(struct test_msg)];
+};
+
+ZBUS_MSG_SUBSCRIBER_DEFINE(high);
+ZBUS_MSG_SUBSCRIBER_DEFINE(low);
+ZBUS_MSG_SUBSCRIBER_DEFINE(failing);
+
+ZBUS_CHAN_DEFINE(high_chan, struct test_msg, NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(low_chan, struct test_msg, NULL, NULL, ZBUS_OBSERVERS_EMPTY, ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(failing_chan, struct test_msg, NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0));
+
+ZBUS_CHAN_ADD_OBS(high_chan, high, 0);
+ZBUS_CHAN_ADD_OBS(low_chan, low, 0);
+ZBUS_CHAN_ADD_OBS(failing_chan, failing, 0);
+
+/* Values of the processed messages, in processing order */
+static int processed[8];
+static size_t processed_count;
+static int init_count;
+
+static enum smf_state_result state_running_run(void *obj)
+{
+	struct test_state_object const *state_object = obj;
+	const struct test_msg *msg = (const struct test_msg *)state_object->msg_buf;
+
+	if (processed_count < ARRAY_SIZE(processed)) {
+		processed[processed_count++] = msg->value;
+	}
+
+	return SMF_EVENT_HANDLED;
+}
+
+static const struct smf_state states[] = {
+	SMF_CREATE_STATE(NULL, state_running_run, NULL, NULL, NULL),
+};
+
+static struct test_state_object high_state;
+static struct test_state_object low_state;
+static struct test_state_object failing_state;
+
+static int high_init(void)
+{
+	init_count++;
+	smf_set_initial(SMF_CTX(&high_state), &states[0]);
+
+	return 0;
+}
+
+static int low_init(void)
+{
+	init_count++;
+	smf_set_initial(SMF_CTX(&low_state), &states[0]);
+
+	return 0;
+}
+
+static int failing_init(void)
+{
+	init_count++;
+
+	return -EIO;
+}
+
+/* Registered in the opposite order of their priorities */
+EXECUTOR_MODULE_DEFINE(low, low, low_state, low_init, 2);
+EXECUTOR_MODULE_DEFINE(failing, failing, failing_state, failing_init, 0);
+EXECUTOR_MODULE_DEFINE(high, high, high_state, high_init, 1);
+
+static void publish(const struct zbus_channel *chan, int value)
+{
+	struct test_msg msg = {
+		.value = value,
+	};
+	int err = zbus_chan_pub(chan, &msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+void setUp(void)
+{
+	memset(processed, 0, sizeof(processed));
+	processed_count = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test_messages_processed_in_priority_order(void)
+{
+	/* The test thread has a higher priority, so nothing is processed while publishing */
+	publish(&low_chan, 1);
+	publish(&low_chan, 2);
+	publish(&high_chan, 3);
+
+	k_sleep(K_MSEC(100));
+
+	TEST_ASSERT_EQUAL(3, init_count);
+	TEST_ASSERT_EQUAL(3, processed_count);
+	TEST_ASSERT_EQUAL(3, processed[0]);
+	TEST_ASSERT_EQUAL(1, processed[1]);
+	TEST_ASSERT_EQUAL(2, processed[2]);
+}
+
+void test_higher_priority_message_processed_first(void)
+{
+	publish(&low_chan, 1);
+
+	k_sleep(K_MSEC(100));
+
+	publish(&low_chan, 2);
+	publish(&low_chan, 3);
+	publish(&high_chan, 4);
+
+	k_sleep(K_MSEC(100));
+
+	TEST_ASSERT_EQUAL(4, processed_count);
+	TEST_ASSERT_EQUAL(1, processed[0]);
+	TEST_ASSERT_EQUAL(4, processed[1]);
+	TEST_ASSERT_EQUAL(2, processed[2]);
+	TEST_ASSERT_EQUAL(3, processed[3]);
+}
+
+void test_module_with_failed_init_not_run(void)
+{
+	publish(&failing_chan, 1);
+
+	k_sleep(K_MSEC(100));
+
+	TEST_ASSERT_EQUAL(0, processed_count);
+	TEST_ASSERT_EQUAL(1, task_wdt_add_fake.call_count);
+	TEST_ASSERT_GREATER_THAN(0, task_wdt_feed_fake.call_count);
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
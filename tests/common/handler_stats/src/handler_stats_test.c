@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "handler_stats.h"
+
+/* Allowed difference between expected and measured handling times, due to tick rounding */
+#define TIME_TOLERANCE_MS	2
+
+struct test_msg {
+	int value;
+};
+
+ZBUS_CHAN_DEFINE(first_chan, struct test_msg, NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(second_chan, struct test_msg, NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(third_chan, struct test_msg, NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0));
+
+/* One second processing budget */
+HANDLER_STATS_DEFINE(test, 1);
+
+static void handle(const struct zbus_channel *chan, uint32_t time_ms)
+{
+	HANDLER_STATS_START(test, chan);
+	k_sleep(K_MSEC(time_ms));
+	HANDLER_STATS_END(test);
+}
+
+static uint32_t bucket_total(const struct handler_stats_entry *entry)
+{
+	uint32_t total = 0;
+
+	for (size_t i = 0; i < HANDLER_STATS_BUCKETS; i++) {
+		total += entry->buckets[i];
+	}
+
+	return total;
+}
+
+void setUp(void)
+{
+	memset(test_handler_stats.entries, 0, sizeof(test_handler_stats.entries));
+	test_handler_stats.running_chan = NULL;
+	test_handler_stats.interval_max_ms = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test_budget_set(void)
+{
+	TEST_ASSERT_EQUAL_STRING("test", test_handler_stats.name);
+	TEST_ASSERT_EQUAL(1000, test_handler_stats.budget_ms);
+}
+
+void test_handling_time_recorded(void)
+{
+	const struct handler_stats_entry *entry = &test_handler_stats.entries[0];
+
+	handle(&first_chan, 300);
+
+	TEST_ASSERT_EQUAL_PTR(&first_chan, entry->chan);
+	TEST_ASSERT_EQUAL(1, entry->count);
+	TEST_ASSERT_UINT32_WITHIN(TIME_TOLERANCE_MS, 300, entry->max_ms);
+	TEST_ASSERT_UINT32_WITHIN(TIME_TOLERANCE_MS, 300, test_handler_stats.interval_max_ms);
+
+	/* The 25 to 50 % bucket */
+	TEST_ASSERT_EQUAL(1, entry->buckets[2]);
+	TEST_ASSERT_EQUAL(1, bucket_total(entry));
+	TEST_ASSERT_NULL(test_handler_stats.running_chan);
+}
+
+void test_channels_recorded_separately(void)
+{
+	handle(&first_chan, 50);
+	handle(&second_chan, 150);
+	handle(&first_chan, 20);
+
+	TEST_ASSERT_EQUAL_PTR(&first_chan, test_handler_stats.entries[0].chan);
+	TEST_ASSERT_EQUAL(2, test_handler_stats.entries[0].count);
+	TEST_ASSERT_UINT32_WITHIN(TIME_TOLERANCE_MS, 50, test_handler_stats.entries[0].max_ms);
+	TEST_ASSERT_EQUAL_PTR(&second_chan, test_handler_stats.entries[1].chan);
+	TEST_ASSERT_EQUAL(1, test_handler_stats.entries[1].count);
+	TEST_ASSERT_UINT32_WITHIN(TIME_TOLERANCE_MS, 150, test_handler_stats.entries[1].max_ms);
+}
+
+void test_over_budget_recorded(void)
+{
+	handle(&first_chan, 900);
+	handle(&first_chan, 1200);
+
+	/* The 80 to 100 % and the over budget buckets */
+	TEST_ASSERT_EQUAL(1, test_handler_stats.entries[0].buckets[4]);
+	TEST_ASSERT_EQUAL(1, test_handler_stats.entries[0].buckets[5]);
+}
+
+void test_channels_beyond_max_not_recorded(void)
+{
+	handle(&first_chan, 10);
+	handle(&second_chan, 10);
+	handle(&third_chan, 400);
+
+	TEST_ASSERT_EQUAL(1, test_handler_stats.entries[0].count);
+	TEST_ASSERT_EQUAL(1, test_handler_stats.entries[1].count);
+
+	/* Still counted in the longest handling time of the module */
+	TEST_ASSERT_UINT32_WITHIN(TIME_TOLERANCE_MS, 400, test_handler_stats.interval_max_ms);
+}
+
+void test_end_without_start_ignored(void)
+{
+	HANDLER_STATS_END(test);
+
+	TEST_ASSERT_NULL(test_handler_stats.entries[0].chan);
+	TEST_ASSERT_EQUAL(0, test_handler_stats.interval_max_ms);
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+
+#include "mem_stats.h"
+
+#define TEST_BUFFER_SIZE 100
+
+MEM_STATS_BUFFER_DEFINE(first_buf, test_group, TEST_BUFFER_SIZE);
+MEM_STATS_BUFFER_DEFINE(second_buf, test_group, 2 * TEST_BUFFER_SIZE);
+
+void setUp(void)
+{
+	STRUCT_SECTION_FOREACH(mem_stats_buffer, buffer) {
+		buffer->used = 0;
+		buffer->peak = 0;
+		buffer->interval_peak = 0;
+	}
+}
+
+void tearDown(void)
+{
+}
+
+void test_buffer_peak_tracked(void)
+{
+	struct mem_stats_buffer *buffer = MEM_STATS_BUFFER_GET(first_buf);
+
+	mem_stats_buffer_update(buffer, 10);
+	mem_stats_buffer_update(buffer, 40);
+	mem_stats_buffer_update(buffer, 20);
+
+	TEST_ASSERT_EQUAL(20, buffer->used);
+	TEST_ASSERT_EQUAL(40, buffer->peak);
+	TEST_ASSERT_EQUAL(40, buffer->interval_peak);
+}
+
+void test_buffers_tracked_separately(void)
+{
+	mem_stats_buffer_update(MEM_STATS_BUFFER_GET(first_buf), 30);
+	mem_stats_buffer_update(MEM_STATS_BUFFER_GET(second_buf), 150);
+
+	TEST_ASSERT_EQUAL(30, MEM_STATS_BUFFER_GET(first_buf)->peak);
+	TEST_ASSERT_EQUAL(150, MEM_STATS_BUFFER_GET(second_buf)->peak);
+}
+
+void test_null_buffer_ignored(void)
+{
+	mem_stats_buffer_update(NULL, 10);
+
+	TEST_ASSERT_EQUAL(0, MEM_STATS_BUFFER_GET(first_buf)->peak);
+}
+
+void test_buffers_registered(void)
+{
+	size_t count = 0;
+
+	STRUCT_SECTION_FOREACH(mem_stats_buffer, buffer) {
+		TEST_ASSERT_EQUAL_STRING("test_group", buffer->group);
+
+		if (strcmp(buffer->name, "first_buf") == 0) {
+			TEST_ASSERT_EQUAL(TEST_BUFFER_SIZE, buffer->size);
+		} else {
+			TEST_ASSERT_EQUAL_STRING("second_buf", buffer->name);
+			TEST_ASSERT_EQUAL(2 * TEST_BUFFER_SIZE, buffer->size);
+		}
+
+		count++;
+	}
+
+	TEST_ASSERT_EQUAL(2, count);
+}
+
+void test_stack_usage_of_current_thread(void)
+{
+	const struct k_thread *thread = k_current_get();
+	size_t size;
+	size_t used;
+
+	TEST_ASSERT_EQUAL(0, mem_stats_stack_get(thread, &size, &used));
+	TEST_ASSERT_EQUAL(thread->stack_info.size, size);
+	TEST_ASSERT_LESS_OR_EQUAL(size, used);
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
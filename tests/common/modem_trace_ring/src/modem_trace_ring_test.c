@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <modem/trace_backend.h>
+#include <memfault/core/custom_data_recording.h>
+
+#include "modem_trace_ring.h"
+#include "lz4_block.h"
+
+#define RING_SIZE		(CONFIG_APP_MODEM_TRACE_RING_SIZE_KB * 1024)
+
+/* Format of the uploaded snapshot, see scripts/modem_trace_decode.py */
+#define SNAPSHOT_MAGIC		0x4d545253
+#define SNAPSHOT_VERSION	1
+#define BLOCK_SIZE		1024
+#define BLOCK_COUNT		(RING_SIZE / BLOCK_SIZE)
+#define BLOCK_RAW		BIT(15)
+
+struct snapshot_header {
+	uint32_t magic;
+	uint8_t version;
+	uint8_t trigger;
+	uint16_t block_size;
+	uint32_t raw_size;
+	uint32_t uptime_s;
+	uint16_t block_count;
+	uint16_t table_size;
+	uint16_t block_len[BLOCK_COUNT];
+} __packed;
+
+/* LZ4 block format limits checked by the decoder */
+#define LZ4_MIN_MATCH		4
+#define LZ4_LAST_LITERALS	5
+
+/* Traces written in the tests, larger than the ring buffer so that it wraps */
+#define STREAM_SIZE		(RING_SIZE + (RING_SIZE / 2))
+#define WRITE_CHUNK		100
+
+extern struct nrf_modem_lib_trace_backend trace_backend;
+
+static const sMemfaultCdrSourceImpl *cdr_source;
+static uint8_t src_buf[BLOCK_SIZE];
+static uint8_t lz4_buf[BLOCK_SIZE];
+static uint8_t out_buf[RING_SIZE];
+static uint8_t snapshot_buf[sizeof(struct snapshot_header) + RING_SIZE];
+static size_t processed_bytes;
+
+/* Registered at boot */
+bool memfault_cdr_register_source(const sMemfaultCdrSourceImpl *impl)
+{
+	cdr_source = impl;
+
+	return true;
+}
+
+static int trace_processed(size_t len)
+{
+	processed_bytes += len;
+
+	return 0;
+}
+
+/* Some of the stream repeats, like traces do, and some of it does not compress */
+static uint8_t stream_byte(size_t i)
+{
+	if ((i / BLOCK_SIZE) % 3 == 2) {
+		return (uint8_t)((i * 2654435761U) >> 24);
+	}
+
+	return (uint8_t)((i / 16) ^ (i % 8));
+}
+
+static void random_fill(uint8_t *buf, size_t len, uint32_t seed)
+{
+	for (size_t i = 0; i < len; i++) {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		buf[i] = (uint8_t)seed;
+	}
+}
+
+static void stream_write(size_t len)
+{
+	uint8_t chunk[WRITE_CHUNK];
+
+	for (size_t i = 0; i < len; i += WRITE_CHUNK) {
+		size_t chunk_len = MIN(WRITE_CHUNK, len - i);
+
+		for (size_t j = 0; j < chunk_len; j++) {
+			chunk[j] = stream_byte(i + j);
+		}
+
+		TEST_ASSERT_EQUAL(chunk_len, trace_backend.write(chunk, chunk_len));
+	}
+}
+
+/* Decoder of the LZ4 block format, checks the limits the encoder must keep */
+static int lz4_decompress(const uint8_t *src, size_t len, uint8_t *dst, size_t dst_size)
+{
+	size_t ip = 0;
+	size_t op = 0;
+	size_t lit_len = 0;
+
+	while (ip < len) {
+		uint8_t token = src[ip++];
+		size_t offset;
+		size_t match_len;
+		uint8_t byte;
+
+		lit_len = token >> 4;
+
+		if (lit_len == 15) {
+			do {
+				byte = src[ip++];
+				lit_len += byte;
+			} while ((byte == 255) && (ip < len));
+		}
+
+		if (((ip + lit_len) > len) || ((op + lit_len) > dst_size)) {
+			return -1;
+		}
+
+		memcpy(&dst[op], &src[ip], lit_len);
+		ip += lit_len;
+		op += lit_len;
+
+		/* The last sequence has no match */
+		if (ip == len) {
+			break;
+		}
+
+		offset = sys_get_le16(&src[ip]);
+		ip += sizeof(uint16_t);
+		match_len = token & 0x0f;
+
+		if (match_len == 15) {
+			do {
+				byte = src[ip++];
+				match_len += byte;
+			} while ((byte == 255) && (ip < len));
+		}
+
+		match_len += LZ4_MIN_MATCH;
+
+		if ((offset == 0) || (offset > op) || ((op + match_len) > dst_size)) {
+			return -1;
+		}
+
+		/* The match may overlap the bytes it writes */
+		for (size_t i = 0; i < match_len; i++, op++) {
+			dst[op] = dst[op - offset];
+		}
+	}
+
+	if (lit_len < MIN(op, LZ4_LAST_LITERALS)) {
+		return -1;
+	}
+
+	return (int)op;
+}
+
+static void round_trip(const uint8_t *src, size_t len)
+{
+	size_t compressed = lz4_block_compress(src, len, lz4_buf, len - 1);
+
+	TEST_ASSERT_GREATER_THAN(0, compressed);
+	TEST_ASSERT_LESS_THAN(len, compressed);
+	TEST_ASSERT_EQUAL(len, lz4_decompress(lz4_buf, compressed, out_buf, sizeof(out_buf)));
+	TEST_ASSERT_EQUAL_MEMORY(src, out_buf, len);
+}
+
+/* Read the snapshot through the Memfault source, as the upload does, in small chunks */
+static size_t snapshot_read(void)
+{
+	sMemfaultCdrMetadata metadata;
+	size_t size;
+
+	TEST_ASSERT_TRUE(cdr_source->has_cdr_cb(&metadata));
+
+	size = metadata.data_size_bytes;
+	TEST_ASSERT_LESS_OR_EQUAL(sizeof(snapshot_buf), size);
+
+	for (size_t offset = 0; offset < size; offset += WRITE_CHUNK) {
+		TEST_ASSERT_TRUE(cdr_source->read_data_cb(offset, &snapshot_buf[offset],
+							 MIN(WRITE_CHUNK, size - offset)));
+	}
+
+	TEST_ASSERT_FALSE(cdr_source->read_data_cb(size - 1, snapshot_buf, 2));
+
+	return size;
+}
+
+/* Unpack an uploaded snapshot and compare it with the end of the written stream */
+static void snapshot_verify(size_t stream_len, uint8_t trigger)
+{
+	const struct snapshot_header *header = (const struct snapshot_header *)snapshot_buf;
+	const size_t raw_size = MIN(stream_len, RING_SIZE);
+	const size_t size = snapshot_read();
+	size_t ip = sizeof(*header);
+	size_t op = 0;
+
+	TEST_ASSERT_EQUAL(SNAPSHOT_MAGIC, header->magic);
+	TEST_ASSERT_EQUAL(SNAPSHOT_VERSION, header->version);
+	TEST_ASSERT_EQUAL(trigger, header->trigger);
+	TEST_ASSERT_EQUAL(BLOCK_SIZE, header->block_size);
+	TEST_ASSERT_EQUAL(raw_size, header->raw_size);
+	TEST_ASSERT_EQUAL(DIV_ROUND_UP(raw_size, BLOCK_SIZE), header->block_count);
+	TEST_ASSERT_EQUAL(BLOCK_COUNT, header->table_size);
+
+	for (size_t i = 0; i < header->block_count; i++) {
+		const size_t block_len = header->block_len[i] & ~BLOCK_RAW;
+		const size_t expected = MIN(BLOCK_SIZE, raw_size - op);
+
+		TEST_ASSERT_LESS_OR_EQUAL(size, ip + block_len);
+
+		if (header->block_len[i] & BLOCK_RAW) {
+			TEST_ASSERT_EQUAL(expected, block_len);
+			memcpy(&out_buf[op], &snapshot_buf[ip], block_len);
+		} else {
+			TEST_ASSERT_EQUAL(expected, lz4_decompress(&snapshot_buf[ip], block_len,
+								    &out_buf[op],
+								    sizeof(out_buf) - op));
+		}
+
+		ip += block_len;
+		op += expected;
+	}
+
+	TEST_ASSERT_EQUAL(size, ip);
+
+	for (size_t i = 0; i < raw_size; i++) {
+		TEST_ASSERT_EQUAL_UINT8(stream_byte(stream_len - raw_size + i), out_buf[i]);
+	}
+}
+
+static void pack_wait(void)
+{
+	k_sleep(K_MSEC(100));
+}
+
+/* Simulate a reset, the state in noinit RAM is checked again as at boot */
+static void reboot(void)
+{
+	modem_trace_ring_test_reboot();
+	pack_wait();
+}
+
+/* Damage a byte of the noinit RAM, as a reset or power loss can */
+static void noinit_damage(bool header, size_t offset)
+{
+	uint8_t *header_ram;
+	uint8_t *buf_ram;
+	size_t header_size;
+	size_t buf_size;
+
+	modem_trace_ring_test_noinit_get(&header_ram, &header_size, &buf_ram, &buf_size);
+
+	if (header) {
+		TEST_ASSERT_LESS_THAN(header_size, offset);
+		header_ram[offset] ^= 0x01;
+	} else {
+		TEST_ASSERT_LESS_THAN(buf_size, offset);
+		buf_ram[offset] ^= 0x01;
+	}
+}
+
+static bool snapshot_ready(void)
+{
+	sMemfaultCdrMetadata metadata;
+
+	return cdr_source->has_cdr_cb(&metadata);
+}
+
+/* After a discarded snapshot, the ring records again, and holds only the new traces */
+static void expect_recording(void)
+{
+	TEST_ASSERT_FALSE(snapshot_ready());
+
+	stream_write(RING_SIZE / 4);
+
+	modem_trace_ring_trigger(MODEM_TRACE_RING_TRIGGER_CLOUD_CONNECT);
+	pack_wait();
+
+	snapshot_verify(RING_SIZE / 4, MODEM_TRACE_RING_TRIGGER_CLOUD_CONNECT);
+}
+
+void setUp(void)
+{
+	uint8_t *header_ram;
+	uint8_t *buf_ram;
+	size_t header_size;
+	size_t buf_size;
+
+	TEST_ASSERT_NOT_NULL(cdr_source);
+
+	/* Start each test from RAM that holds no valid state, as after a power cycle */
+	pack_wait();
+	modem_trace_ring_test_noinit_get(&header_ram, &header_size, &buf_ram, &buf_size);
+	memset(header_ram, 0, header_size);
+	reboot();
+
+	processed_bytes = 0;
+	TEST_ASSERT_EQUAL(0, trace_backend.init(trace_processed));
+}
+
+void tearDown(void)
+{
+}
+
+void test_lz4_repeating(void)
+{
+	for (size_t i = 0; i < BLOCK_SIZE; i++) {
+		src_buf[i] = (uint8_t)((i / 16) ^ (i % 8));
+	}
+
+	round_trip(src_buf, BLOCK_SIZE);
+}
+
+void test_lz4_overlapping_match(void)
+{
+	/* A single byte repeated is a match at offset 1, longer than 255 bytes */
+	memset(src_buf, 0xaa, BLOCK_SIZE);
+
+	round_trip(src_buf, BLOCK_SIZE);
+}
+
+void test_lz4_long_literals_and_match(void)
+{
+	/* Literal and match lengths that need more than one length byte */
+	random_fill(src_buf, 300, 1);
+	memcpy(&src_buf[300], src_buf, 300);
+	random_fill(&src_buf[600], BLOCK_SIZE - 600, 2);
+
+	round_trip(src_buf, BLOCK_SIZE);
+}
+
+void test_lz4_match_near_end(void)
+{
+	/* A repeat that runs into the last bytes of the block, which must stay literals */
+	random_fill(src_buf, 64, 3);
+	memcpy(&src_buf[64], src_buf, 64);
+
+	round_trip(src_buf, 128);
+}
+
+void test_lz4_incompressible(void)
+{
+	random_fill(src_buf, BLOCK_SIZE, 4);
+
+	TEST_ASSERT_EQUAL(0, lz4_block_compress(src_buf, BLOCK_SIZE, lz4_buf, BLOCK_SIZE - 1));
+}
+
+void test_lz4_short_block(void)
+{
+	/* Too short for a match, and literals only never make a block smaller */
+	memset(src_buf, 0, 12);
+
+	TEST_ASSERT_EQUAL(0, lz4_block_compress(src_buf, 12, lz4_buf, 11));
+}
+
+void test_snapshot_round_trip(void)
+{
+	sMemfaultCdrMetadata metadata;
+
+	stream_write(STREAM_SIZE);
+	TEST_ASSERT_EQUAL(STREAM_SIZE, processed_bytes);
+
+	modem_trace_ring_trigger(MODEM_TRACE_RING_TRIGGER_CLOUD_CONNECT);
+	pack_wait();
+
+	TEST_ASSERT_TRUE(cdr_source->has_cdr_cb(&metadata));
+	TEST_ASSERT_LESS_THAN(sizeof(struct snapshot_header) + RING_SIZE,
+			      metadata.data_size_bytes);
+
+	snapshot_verify(STREAM_SIZE, MODEM_TRACE_RING_TRIGGER_CLOUD_CONNECT);
+}
+
+void test_snapshot_partial_block(void)
+{
+	stream_write(BLOCK_SIZE + 10);
+
+	modem_trace_ring_trigger(MODEM_TRACE_RING_TRIGGER_ATTACH_REJECTED);
+	pack_wait();
+
+	snapshot_verify(BLOCK_SIZE + 10, MODEM_TRACE_RING_TRIGGER_ATTACH_REJECTED);
+}
+
+void test_trigger_without_traces_ignored(void)
+{
+	modem_trace_ring_trigger(MODEM_TRACE_RING_TRIGGER_CLOUD_CONNECT);
+	pack_wait();
+
+	TEST_ASSERT_FALSE(snapshot_ready());
+}
+
+void test_frozen_until_uploaded(void)
+{
+	stream_write(RING_SIZE / 2);
+
+	modem_trace_ring_trigger(MODEM_TRACE_RING_TRIGGER_ATTACH_REJECTED);
+	pack_wait();
+
+	/* Later traces and triggers do not touch the snapshot */
+	stream_write(RING_SIZE);
+	TEST_ASSERT_EQUAL(RING_SIZE / 2 + RING_SIZE, processed_bytes);
+
+	modem_trace_ring_trigger(MODEM_TRACE_RING_TRIGGER_CLOUD_CONNECT);
+	pack_wait();
+
+	snapshot_verify(RING_SIZE / 2, MODEM_TRACE_RING_TRIGGER_ATTACH_REJECTED);
+
+	/* Recording resumes once uploaded */
+	cdr_source->mark_cdr_read_cb();
+
+	expect_recording();
+}
+
+void test_watchdog_snapshot_packed_after_reset(void)
+{
+	stream_write(STREAM_SIZE);
+
+	/* Not packed before the reset */
+	modem_trace_ring_trigger(MODEM_TRACE_RING_TRIGGER_WATCHDOG);
+	pack_wait();
+
+	TEST_ASSERT_FALSE(snapshot_ready());
+
+	reboot();
+
+	snapshot_verify(STREAM_SIZE, MODEM_TRACE_RING_TRIGGER_WATCHDOG);
+}
+
+void test_packed_snapshot_kept_over_reset(void)
+{
+	stream_write(STREAM_SIZE);
+
+	modem_trace_ring_trigger(MODEM_TRACE_RING_TRIGGER_CLOUD_CONNECT);
+	pack_wait();
+	reboot();
+
+	snapshot_verify(STREAM_SIZE, MODEM_TRACE_RING_TRIGGER_CLOUD_CONNECT);
+}
+
+void test_header_crc_bad_discarded(void)
+{
+	stream_write(STREAM_SIZE);
+
+	modem_trace_ring_trigger(MODEM_TRACE_RING_TRIGGER_WATCHDOG);
+	pack_wait();
+
+	/* Any byte of the header is covered by its CRC */
+	noinit_damage(true, 8);
+	reboot();
+
+	expect_recording();
+}
+
+void test_packed_data_crc_bad_discarded(void)
+{
+	stream_write(STREAM_SIZE);
+
+	modem_trace_ring_trigger(MODEM_TRACE_RING_TRIGGER_CLOUD_CONNECT);
+	pack_wait();
+
+	noinit_damage(false, 0);
+	reboot();
+
+	expect_recording();
+}
+
+void test_recording_discarded_over_reset(void)
+{
+	stream_write(STREAM_SIZE);
+	reboot();
+
+	expect_recording();
+}
+
+void test_uninitialized_ram_discarded(void)
+{
+	uint8_t *header_ram;
+	uint8_t *buf_ram;
+	size_t header_size;
+	size_t buf_size;
+
+	/* What the RAM may hold after a power cycle */
+	modem_trace_ring_test_noinit_get(&header_ram, &header_size, &buf_ram, &buf_size);
+	memset(header_ram, 0xa5, header_size);
+	memset(buf_ram, 0xa5, buf_size);
+	reboot();
+
+	expect_recording();
+}
+
+/* This is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/smf.h>
+
+#include "state_stats.h"
+
+/* Allowed difference between expected and measured dwell times, due to tick rounding */
+#define DWELL_TOLERANCE_MS	2
+
+enum test_state {
+	STATE_IDLE,
+	STATE_BUSY,
+		STATE_BUSY_FIRST,
+		STATE_BUSY_SECOND,
+};
+
+struct test_state_object {
+	/* This must be first */
+	struct smf_ctx ctx;
+
+	/* State to transition to on the next run */
+	const struct smf_state *next;
+};
+
+static enum smf_state_result state_run(void *obj)
+{
+	struct test_state_object *state_object = obj;
+
+	smf_set_state(SMF_CTX(state_object), state_object->next);
+
+	return SMF_EVENT_HANDLED;
+}
+
+static const struct smf_state states[] = {
+	[STATE_IDLE] = SMF_CREATE_STATE(NULL, state_run, NULL, NULL, NULL),
+	[STATE_BUSY] = SMF_CREATE_STATE(NULL, NULL, NULL, NULL, NULL),
+	[STATE_BUSY_FIRST] = SMF_CREATE_STATE(NULL, state_run, NULL, &states[STATE_BUSY], NULL),
+	[STATE_BUSY_SECOND] = SMF_CREATE_STATE(NULL, state_run, NULL, &states[STATE_BUSY], NULL),
+};
+
+STATE_STATS_DEFINE(test, states);
+
+static struct test_state_object test_state;
+
+static void transition(enum test_state state)
+{
+	int err;
+
+	test_state.next = &states[state];
+
+	err = smf_run_state(SMF_CTX(&test_state));
+	TEST_ASSERT_EQUAL(0, err);
+
+	STATE_STATS_UPDATE(test, SMF_CTX(&test_state));
+}
+
+static void assert_entry(enum test_state state, uint32_t count, uint32_t total_ms,
+			 uint32_t max_ms)
+{
+	struct state_stats_entry entry;
+	int err = state_stats_get(STATE_STATS_GET(test), state, &entry);
+
+	TEST_ASSERT_EQUAL(0, err);
+	TEST_ASSERT_EQUAL(count, entry.count);
+	TEST_ASSERT_UINT32_WITHIN(DWELL_TOLERANCE_MS, total_ms, (uint32_t)entry.total_ms);
+	TEST_ASSERT_UINT32_WITHIN(DWELL_TOLERANCE_MS, max_ms, entry.max_ms);
+}
+
+void setUp(void)
+{
+	memset(test_state_stats_entries, 0, sizeof(test_state_stats_entries));
+	test_state_stats.current = NULL;
+
+	smf_set_initial(SMF_CTX(&test_state), &states[STATE_IDLE]);
+	STATE_STATS_UPDATE(test, SMF_CTX(&test_state));
+}
+
+void tearDown(void)
+{
+}
+
+void test_initial_state_entered(void)
+{
+	assert_entry(STATE_IDLE, 1, 0, 0);
+	assert_entry(STATE_BUSY, 0, 0, 0);
+	assert_entry(STATE_BUSY_FIRST, 0, 0, 0);
+}
+
+void test_entries_and_dwell_times_recorded(void)
+{
+	k_sleep(K_MSEC(100));
+	transition(STATE_BUSY_FIRST);
+	k_sleep(K_MSEC(300));
+	transition(STATE_IDLE);
+	k_sleep(K_MSEC(50));
+	transition(STATE_BUSY_FIRST);
+	k_sleep(K_MSEC(200));
+	transition(STATE_IDLE);
+
+	assert_entry(STATE_IDLE, 3, 150, 100);
+	assert_entry(STATE_BUSY_FIRST, 2, 500, 300);
+}
+
+void test_staying_in_state_not_counted_as_entry(void)
+{
+	transition(STATE_BUSY_FIRST);
+	k_sleep(K_MSEC(100));
+	transition(STATE_BUSY_FIRST);
+	k_sleep(K_MSEC(100));
+	transition(STATE_IDLE);
+
+	assert_entry(STATE_BUSY_FIRST, 1, 200, 200);
+}
+
+void test_parent_state_active_in_child_states(void)
+{
+	transition(STATE_BUSY_FIRST);
+	k_sleep(K_MSEC(100));
+	transition(STATE_BUSY_SECOND);
+	k_sleep(K_MSEC(200));
+	transition(STATE_BUSY_FIRST);
+	k_sleep(K_MSEC(100));
+
+	assert_entry(STATE_BUSY, 1, 400, 400);
+
+	transition(STATE_IDLE);
+	k_sleep(K_MSEC(100));
+
+	assert_entry(STATE_BUSY, 1, 400, 400);
+	assert_entry(STATE_BUSY_FIRST, 2, 200, 100);
+	assert_entry(STATE_BUSY_SECOND, 1, 200, 200);
+}
+
+void test_current_dwell_time_included(void)
+{
+	transition(STATE_BUSY_FIRST);
+	k_sleep(K_MSEC(250));
+
+	assert_entry(STATE_BUSY_FIRST, 1, 250, 250);
+
+	k_sleep(K_MSEC(250));
+
+	assert_entry(STATE_BUSY_FIRST, 1, 500, 500);
+}
+
+void test_invalid_state_rejected(void)
+{
+	struct state_stats_entry entry;
+
+	TEST_ASSERT_EQUAL(-EINVAL, state_stats_get(STATE_STATS_GET(test), ARRAY_SIZE(states),
+						   &entry));
+}
+
+void test_stats_registered(void)
+{
+	size_t count = 0;
+
+	STRUCT_SECTION_FOREACH(state_stats, stats) {
+		TEST_ASSERT_EQUAL_STRING("test", stats->name);
+		TEST_ASSERT_EQUAL(ARRAY_SIZE(states), stats->state_count);
+		count++;
+	}
+
+	TEST_ASSERT_EQUAL(1, count);
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "zbus_stats.h"
+
+struct test_msg {
+	int value;
+};
+
+ZBUS_MSG_SUBSCRIBER_DEFINE(test_subscriber);
+
+ZBUS_CHAN_DEFINE(tracked_chan, struct test_msg, NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0));
+ZBUS_CHAN_DEFINE(untracked_chan, struct test_msg, NULL, NULL, ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0));
+
+ZBUS_CHAN_ADD_OBS(tracked_chan, test_subscriber, 0);
+ZBUS_CHAN_ADD_OBS(untracked_chan, test_subscriber, 0);
+
+ZBUS_STATS_CHAN_DEFINE(tracked_chan);
+
+static void publish(const struct zbus_channel *chan, int count)
+{
+	struct test_msg msg = { 0 };
+
+	for (int i = 0; i < count; i++) {
+		int err = zbus_chan_pub(chan, &msg, K_SECONDS(1));
+
+		TEST_ASSERT_EQUAL(0, err);
+	}
+}
+
+static void receive(int count)
+{
+	const struct zbus_channel *chan;
+	struct test_msg msg;
+
+	for (int i = 0; i < count; i++) {
+		int err = zbus_sub_wait_msg(&test_subscriber, &chan, &msg, K_NO_WAIT);
+
+		TEST_ASSERT_EQUAL(0, err);
+
+		zbus_stats_received(&test_subscriber, chan);
+	}
+}
+
+static uint32_t latency_count(void)
+{
+	uint32_t count = 0;
+
+	for (size_t i = 0; i < ZBUS_STATS_LATENCY_BUCKETS; i++) {
+		count += tracked_chan_stats.latency_buckets[i];
+	}
+
+	return count;
+}
+
+void setUp(void)
+{
+	tracked_chan_stats.publish_count = 0;
+	tracked_chan_stats.delivery_count = 0;
+	memset(tracked_chan_stats.latency_buckets, 0, sizeof(tracked_chan_stats.latency_buckets));
+	tracked_chan_stats.latency_max_ms = 0;
+	tracked_chan_stats.queue_hwm = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test_subscriber_found(void)
+{
+	TEST_ASSERT_EQUAL(BIT(0), tracked_chan_stats.subscribers);
+}
+
+void test_publishes_and_queue_depth_counted(void)
+{
+	publish(&tracked_chan, 2);
+
+	TEST_ASSERT_EQUAL(2, tracked_chan_stats.publish_count);
+	TEST_ASSERT_EQUAL(2, tracked_chan_stats.queue_hwm);
+
+	receive(1);
+	publish(&tracked_chan, 1);
+
+	TEST_ASSERT_EQUAL(3, tracked_chan_stats.publish_count);
+	TEST_ASSERT_EQUAL(2, tracked_chan_stats.queue_hwm);
+
+	receive(2);
+
+	TEST_ASSERT_EQUAL(3, tracked_chan_stats.delivery_count);
+	TEST_ASSERT_EQUAL(3, tracked_chan_stats.latency_buckets[0]);
+}
+
+void test_delivery_latency_measured(void)
+{
+	publish(&tracked_chan, 1);
+	k_sleep(K_MSEC(30));
+	receive(1);
+
+	/* The 20 to 50 ms bucket */
+	TEST_ASSERT_EQUAL(1, tracked_chan_stats.latency_buckets[5]);
+	TEST_ASSERT_UINT32_WITHIN(2, 30, tracked_chan_stats.latency_max_ms);
+}
+
+void test_latency_not_measured_when_timestamps_full(void)
+{
+	publish(&tracked_chan, 4);
+
+	TEST_ASSERT_EQUAL(4, tracked_chan_stats.queue_hwm);
+
+	receive(4);
+
+	TEST_ASSERT_EQUAL(4, tracked_chan_stats.delivery_count);
+	TEST_ASSERT_EQUAL(CONFIG_APP_ZBUS_STATS_TIMESTAMPS, latency_count());
+
+	/* The queue is empty again, so new messages are timed */
+	publish(&tracked_chan, 1);
+	receive(1);
+
+	TEST_ASSERT_EQUAL(4, tracked_chan_stats.queue_hwm);
+	TEST_ASSERT_EQUAL(CONFIG_APP_ZBUS_STATS_TIMESTAMPS + 1, latency_count());
+}
+
+void test_untracked_channel_ignored(void)
+{
+	publish(&untracked_chan, 1);
+	publish(&tracked_chan, 1);
+	receive(2);
+
+	TEST_ASSERT_EQUAL(1, tracked_chan_stats.publish_count);
+	TEST_ASSERT_EQUAL(1, tracked_chan_stats.delivery_count);
+	TEST_ASSERT_EQUAL(1, tracked_chan_stats.queue_hwm);
+	TEST_ASSERT_EQUAL(1, latency_count());
+}
+
+void test_latency_p99(void)
+{
+	uint32_t buckets[ZBUS_STATS_LATENCY_BUCKETS] = { 0 };
+
+	TEST_ASSERT_EQUAL(0, zbus_stats_latency_p99(buckets, 0));
+
+	buckets[0] = 99;
+	buckets[5] = 1;
+
+	TEST_ASSERT_EQUAL(1, zbus_stats_latency_p99(buckets, 40));
+
+	buckets[0] = 98;
+	buckets[5] = 2;
+
+	TEST_ASSERT_EQUAL(40, zbus_stats_latency_p99(buckets, 40));
+
+	buckets[ZBUS_STATS_LATENCY_BUCKETS - 1] = 100;
+
+	TEST_ASSERT_EQUAL(60000, zbus_stats_latency_p99(buckets, 60000));
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,603 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * End-to-end performance benchmark of the data path from sampling to the cloud.
+ *
+ * The main state machine, the storage module with the RAM backend and the cloud module run
+ * unmodified. The neighbouring modules are simulated: the power module answers battery sample
+ * requests, the location search completes as soon as it is triggered, the FOTA module only
+ * reports that it is ready and the network is connected and disconnected by the tests.
+ *
+ * The nRF Cloud CoAP library is replaced by a simulated server with a round-trip time of
+ * BENCHMARK_RTT_MS and a loss of BENCHMARK_LOSS_PERCENT per transmission. Confirmable requests
+ * are retransmitted as the CoAP client does, see sim_request().
+ *
+ * Time on native_sim is simulated and advances while all threads wait, so that hours of
+ * operation take seconds to run. Losses are drawn from a fixed seed, the results are the same
+ * on every run. Each result is printed as one machine-readable line, in the same order on every
+ * run so that the output of two releases can be diffed directly:
+ *
+ *	BENCHMARK,<link>,<scenario>,<metric>,<value>
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/sys_heap.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/task_wdt/task_wdt.h>
+#include <zephyr/net/coap.h>
+#include <zephyr/net/coap_client.h>
+#include <net/nrf_provisioning.h>
+#include <net/nrf_cloud_coap.h>
+
+#include "app_common.h"
+#include "power.h"
+#include "network.h"
+#include "location.h"
+#include "fota.h"
+#include "cloud.h"
+#include "cloud_stats.h"
+
+DEFINE_FFF_GLOBALS;
+
+LOG_MODULE_REGISTER(performance_benchmark, LOG_LEVEL_INF);
+
+/* Simulated time per scenario */
+#define STEADY_STATE_HOURS	24
+#define OUTAGE_HOURS		12
+#define DRAIN_TIMEOUT_HOURS	4
+
+/* Any fixed seed gives reproducible losses */
+#define LOSS_SEED		0x2545F491
+
+#define PUB_TIMEOUT		K_SECONDS(1)
+
+FAKE_VALUE_FUNC(int, task_wdt_feed, int);
+FAKE_VALUE_FUNC(int, task_wdt_add, uint32_t, task_wdt_callback_t, void *);
+FAKE_VOID_FUNC(sys_reboot, int);
+FAKE_VALUE_FUNC(int, date_time_uptime_to_unix_time_ms, int64_t *);
+FAKE_VALUE_FUNC(bool, date_time_is_valid);
+FAKE_VALUE_FUNC(int, nrf_provisioning_init, nrf_provisioning_event_cb_t);
+FAKE_VALUE_FUNC(int, nrf_provisioning_trigger_manually);
+FAKE_VALUE_FUNC(int, nrf_cloud_client_id_get, char *, size_t);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_init);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_connect, const char * const);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_disconnect);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_shadow_configured_info_update, const char * const);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_shadow_network_info_update);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_sensor_send, const char *, double, int64_t, bool);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_json_message_send, const char *, bool, bool);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_shadow_get, char *, size_t *, bool, enum coap_content_format);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_patch, const char *, const char *,
+		const uint8_t *, size_t,
+		enum coap_content_format, bool,
+		coap_client_response_cb_t, void *);
+
+/* The system heap, defined by the kernel */
+extern struct k_heap _system_heap;
+
+/* Channels of the simulated modules */
+ZBUS_CHAN_DEFINE(power_chan,
+		 struct power_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(network_chan,
+		 struct network_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(.type = NETWORK_DISCONNECTED)
+);
+ZBUS_CHAN_DEFINE(location_chan,
+		 struct location_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(fota_chan,
+		 struct fota_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+static void power_chan_cb(const struct zbus_channel *chan);
+static void location_chan_cb(const struct zbus_channel *chan);
+static void cloud_chan_cb(const struct zbus_channel *chan);
+
+ZBUS_LISTENER_DEFINE(benchmark_power_listener, power_chan_cb);
+ZBUS_LISTENER_DEFINE(benchmark_location_listener, location_chan_cb);
+ZBUS_LISTENER_DEFINE(benchmark_cloud_listener, cloud_chan_cb);
+ZBUS_CHAN_ADD_OBS(power_chan, benchmark_power_listener, 0);
+ZBUS_CHAN_ADD_OBS(location_chan, benchmark_location_listener, 0);
+ZBUS_CHAN_ADD_OBS(cloud_chan, benchmark_cloud_listener, 0);
+
+static K_SEM_DEFINE(cloud_connected_sem, 0, 1);
+static K_SEM_DEFINE(cloud_disconnected_sem, 0, 1);
+
+/* Upload latency, from sampling until the sample reaches the server, in milliseconds */
+struct latency {
+	uint64_t total;
+	uint64_t max;
+	uint32_t count;
+};
+
+/* Counters of the running scenario. Updated on the cloud thread and the system workqueue, read
+ * by the tests while the modules wait. native_sim runs one thread at a time, so no locking.
+ */
+static struct {
+	bool link_up;
+	uint32_t loss_state;
+
+	uint32_t samples_generated;
+	uint32_t samples_delivered;
+
+	/* Non-confirmable samples that did not reach the server */
+	uint32_t samples_lost;
+
+	uint32_t requests;
+	uint32_t retransmissions;
+	uint32_t request_failures;
+
+	struct latency upload_latency;
+
+	/* Totals of the cloud module request statistics at the start of the scenario */
+	struct cloud_stats_entry cloud_stats_start;
+} sim = {
+	.loss_state = LOSS_SEED,
+};
+
+/* Simulated modules */
+
+static void power_response_work_fn(struct k_work *work)
+{
+	int err;
+	struct power_msg msg = {
+		.type = POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE,
+		.percentage = 80.0,
+		.voltage = 3.9,
+		.timestamp = k_uptime_get(),
+	};
+
+	ARG_UNUSED(work);
+
+	sim.samples_generated++;
+
+	err = zbus_chan_pub(&power_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish battery sample, error: %d", err);
+	}
+}
+
+static K_WORK_DEFINE(power_response_work, power_response_work_fn);
+
+static void location_done_work_fn(struct k_work *work)
+{
+	int err;
+	struct location_msg msg = {
+		.type = LOCATION_SEARCH_DONE,
+	};
+
+	ARG_UNUSED(work);
+
+	err = zbus_chan_pub(&location_chan, &msg, PUB_TIMEOUT);
+	if (err) {
+		LOG_ERR("Failed to publish location search done, error: %d", err);
+	}
+}
+
+static K_WORK_DEFINE(location_done_work, location_done_work_fn);
+
+/* Responses are published from the system workqueue, not from within the publication of the
+ * request.
+ */
+static void power_chan_cb(const struct zbus_channel *chan)
+{
+	const struct power_msg *msg = zbus_chan_const_msg(chan);
+
+	if (msg->type == POWER_BATTERY_PERCENTAGE_SAMPLE_REQUEST) {
+		k_work_submit(&power_response_work);
+	}
+}
+
+static void location_chan_cb(const struct zbus_channel *chan)
+{
+	const struct location_msg *msg = zbus_chan_const_msg(chan);
+
+	if ((msg->type == LOCATION_SEARCH_TRIGGER) ||
+	    (msg->type == LOCATION_CELLULAR_SEARCH_TRIGGER)) {
+		k_work_submit(&location_done_work);
+	}
+}
+
+static void cloud_chan_cb(const struct zbus_channel *chan)
+{
+	const struct cloud_msg *msg = zbus_chan_const_msg(chan);
+
+	if (msg->type == CLOUD_CONNECTED) {
+		k_sem_give(&cloud_connected_sem);
+	} else if (msg->type == CLOUD_DISCONNECTED) {
+		k_sem_give(&cloud_disconnected_sem);
+	}
+}
+
+/* Simulated nRF Cloud CoAP server */
+
+static bool sim_transmission_lost(void)
+{
+	/* xorshift32 */
+	sim.loss_state ^= sim.loss_state << 13;
+	sim.loss_state ^= sim.loss_state >> 17;
+	sim.loss_state ^= sim.loss_state << 5;
+
+	return !sim.link_up || ((sim.loss_state % 100) < BENCHMARK_LOSS_PERCENT);
+}
+
+/* One request to the simulated server. The nRF Cloud CoAP library blocks until the request is
+ * done: a confirmable request waits for the acknowledgment, is retransmitted with a doubling ACK
+ * timeout and fails after CONFIG_COAP_MAX_RETRANSMIT retransmissions. A non-confirmable request
+ * returns once it is sent, and is lost without notice.
+ */
+static int sim_request(bool confirmable, bool *delivered)
+{
+	uint32_t ack_timeout_ms = CONFIG_COAP_INIT_ACK_TIMEOUT_MS;
+
+	sim.requests++;
+
+	if (!confirmable) {
+		*delivered = !sim_transmission_lost();
+
+		return 0;
+	}
+
+	for (int i = 0; i <= CONFIG_COAP_MAX_RETRANSMIT; i++) {
+		if (i > 0) {
+			sim.retransmissions++;
+		}
+
+		if (!sim_transmission_lost()) {
+			k_sleep(K_MSEC(BENCHMARK_RTT_MS));
+			*delivered = true;
+
+			return 0;
+		}
+
+		k_sleep(K_MSEC(ack_timeout_ms));
+		ack_timeout_ms *= 2;
+	}
+
+	sim.request_failures++;
+	*delivered = false;
+
+	return -ETIMEDOUT;
+}
+
+static void latency_add(struct latency *latency, int64_t time_ms)
+{
+	uint64_t value = (uint64_t)MAX(time_ms, 0);
+
+	latency->total += value;
+	latency->max = MAX(latency->max, value);
+	latency->count++;
+}
+
+static int nrf_cloud_coap_sensor_send_custom_fake(const char *app_id, double value,
+						  int64_t ts_ms, bool confirmable)
+{
+	bool delivered;
+	int64_t arrival_ms;
+	int err;
+
+	ARG_UNUSED(app_id);
+	ARG_UNUSED(value);
+
+	err = sim_request(confirmable, &delivered);
+
+	if (delivered) {
+		/* Half a round trip before the acknowledgment, or after sending */
+		arrival_ms = confirmable ? k_uptime_get() - BENCHMARK_RTT_MS / 2 :
+					   k_uptime_get() + BENCHMARK_RTT_MS / 2;
+
+		sim.samples_delivered++;
+		latency_add(&sim.upload_latency, arrival_ms - ts_ms);
+	} else if (!err) {
+		sim.samples_lost++;
+	}
+
+	return err;
+}
+
+static int nrf_cloud_coap_json_message_send_custom_fake(const char *message, bool bulk,
+							bool confirmable)
+{
+	bool delivered;
+
+	ARG_UNUSED(message);
+	ARG_UNUSED(bulk);
+
+	return sim_request(confirmable, &delivered);
+}
+
+static int nrf_cloud_coap_shadow_get_custom_fake(char *buf, size_t *buf_len, bool delta,
+						 enum coap_content_format format)
+{
+	bool delivered;
+
+	ARG_UNUSED(buf);
+	ARG_UNUSED(delta);
+	ARG_UNUSED(format);
+
+	/* No desired configuration and no pending changes */
+	*buf_len = 0;
+
+	return sim_request(true, &delivered);
+}
+
+static int nrf_cloud_coap_patch_custom_fake(const char *resource, const char *query,
+					    const uint8_t *buf, size_t buf_len,
+					    enum coap_content_format fmt, bool reliable,
+					    coap_client_response_cb_t cb, void *user)
+{
+	bool delivered;
+
+	ARG_UNUSED(resource);
+	ARG_UNUSED(query);
+	ARG_UNUSED(buf);
+	ARG_UNUSED(buf_len);
+	ARG_UNUSED(fmt);
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user);
+
+	return sim_request(reliable, &delivered);
+}
+
+static int nrf_cloud_coap_shadow_update_custom_fake(void)
+{
+	bool delivered;
+
+	return sim_request(true, &delivered);
+}
+
+static int nrf_cloud_coap_shadow_configured_info_update_custom_fake(const char * const info)
+{
+	ARG_UNUSED(info);
+
+	return nrf_cloud_coap_shadow_update_custom_fake();
+}
+
+/* Timestamps are kept as uptime, so that the upload latency is the difference to the uptime at
+ * arrival.
+ */
+static int date_time_uptime_to_unix_time_ms_custom_fake(int64_t *uptime_ms)
+{
+	ARG_UNUSED(uptime_ms);
+
+	return 0;
+}
+
+/* Reporting */
+
+static void report(const char *scenario, const char *metric, uint64_t value)
+{
+	printk("BENCHMARK,%s,%s,%s,%llu\n", BENCHMARK_LINK, scenario, metric,
+	       (unsigned long long)value);
+}
+
+static void report_latency(const char *scenario, const struct latency *latency)
+{
+	uint64_t avg = (latency->count > 0) ? latency->total / latency->count : 0;
+
+	report(scenario, "upload_latency_ms_avg", avg);
+	report(scenario, "upload_latency_ms_max", latency->max);
+}
+
+static void cloud_stats_total_get(struct cloud_stats_entry *total)
+{
+	struct cloud_stats_entry entry;
+
+	memset(total, 0, sizeof(*total));
+
+	for (enum cloud_stats_type type = 0; type < CLOUD_STATS_TYPE_COUNT; type++) {
+		TEST_ASSERT_EQUAL(0, cloud_stats_get(type, &entry));
+
+		total->requests += entry.requests;
+		total->failures += entry.failures;
+		total->retransmissions += entry.retransmissions;
+	}
+}
+
+/* Requests as seen by the simulated server, and as estimated by the cloud module */
+static void report_requests(const char *scenario)
+{
+	struct cloud_stats_entry total;
+
+	cloud_stats_total_get(&total);
+
+	report(scenario, "requests", sim.requests);
+	report(scenario, "retransmissions", sim.retransmissions);
+	report(scenario, "request_failures", sim.request_failures);
+	report(scenario, "cloud_stats_requests", total.requests - sim.cloud_stats_start.requests);
+	report(scenario, "cloud_stats_retransmissions",
+	       total.retransmissions - sim.cloud_stats_start.retransmissions);
+}
+
+static void report_samples(const char *scenario)
+{
+	report(scenario, "samples_generated", sim.samples_generated);
+	report(scenario, "samples_delivered", sim.samples_delivered);
+	report(scenario, "samples_lost", sim.samples_lost);
+}
+
+/* Helpers */
+
+static void scenario_start(void)
+{
+	sim.samples_generated = 0;
+	sim.samples_delivered = 0;
+	sim.samples_lost = 0;
+	sim.requests = 0;
+	sim.retransmissions = 0;
+	sim.request_failures = 0;
+	memset(&sim.upload_latency, 0, sizeof(sim.upload_latency));
+	cloud_stats_total_get(&sim.cloud_stats_start);
+}
+
+static void network_publish(enum network_msg_type type)
+{
+	struct network_msg msg = {
+		.type = type,
+	};
+
+	sim.link_up = (type == NETWORK_CONNECTED);
+
+	TEST_ASSERT_EQUAL(0, zbus_chan_pub(&network_chan, &msg, PUB_TIMEOUT));
+}
+
+/* Report the simulated modules as ready and connect, once before the first scenario */
+static void modules_start(void)
+{
+	static bool started;
+	struct fota_msg fota_msg = { .type = FOTA_MODULE_READY };
+	struct power_msg power_msg = { .type = POWER_MODULE_READY };
+	struct location_msg location_msg = { .type = LOCATION_MODULE_READY };
+
+	if (started) {
+		return;
+	}
+
+	TEST_ASSERT_EQUAL(0, zbus_chan_pub(&fota_chan, &fota_msg, PUB_TIMEOUT));
+	TEST_ASSERT_EQUAL(0, zbus_chan_pub(&power_chan, &power_msg, PUB_TIMEOUT));
+	TEST_ASSERT_EQUAL(0, zbus_chan_pub(&location_chan, &location_msg, PUB_TIMEOUT));
+
+	network_publish(NETWORK_CONNECTED);
+	TEST_ASSERT_EQUAL(0, k_sem_take(&cloud_connected_sem, K_MINUTES(1)));
+
+	started = true;
+}
+
+void setUp(void)
+{
+	/* Reset only the call history, the custom fakes stay for the whole run */
+	FFF_RESET_HISTORY();
+
+	task_wdt_add_fake.return_val = 0;
+	date_time_is_valid_fake.return_val = true;
+	date_time_uptime_to_unix_time_ms_fake.custom_fake =
+		date_time_uptime_to_unix_time_ms_custom_fake;
+	nrf_cloud_coap_sensor_send_fake.custom_fake = nrf_cloud_coap_sensor_send_custom_fake;
+	nrf_cloud_coap_json_message_send_fake.custom_fake =
+		nrf_cloud_coap_json_message_send_custom_fake;
+	nrf_cloud_coap_shadow_get_fake.custom_fake = nrf_cloud_coap_shadow_get_custom_fake;
+	nrf_cloud_coap_patch_fake.custom_fake = nrf_cloud_coap_patch_custom_fake;
+	nrf_cloud_coap_shadow_configured_info_update_fake.custom_fake =
+		nrf_cloud_coap_shadow_configured_info_update_custom_fake;
+	nrf_cloud_coap_shadow_network_info_update_fake.custom_fake =
+		nrf_cloud_coap_shadow_update_custom_fake;
+
+	modules_start();
+}
+
+void tearDown(void)
+{
+}
+
+/* Throughput and upload latency while connected */
+void test_benchmark_steady_state(void)
+{
+	scenario_start();
+
+	k_sleep(K_HOURS(STEADY_STATE_HOURS));
+
+	report("steady_state", "hours", STEADY_STATE_HOURS);
+	report_samples("steady_state");
+	report("steady_state", "samples_per_hour", sim.samples_delivered / STEADY_STATE_HOURS);
+	report_latency("steady_state", &sim.upload_latency);
+	report_requests("steady_state");
+
+	TEST_ASSERT_GREATER_THAN(0, sim.samples_delivered);
+}
+
+/* Time to upload the samples stored during a network outage, after the network is back */
+void test_benchmark_outage_drain(void)
+{
+	uint32_t backlog;
+	int64_t start_ms;
+	int64_t drain_time_ms;
+	bool drained = false;
+
+	scenario_start();
+
+	k_sem_reset(&cloud_disconnected_sem);
+	network_publish(NETWORK_DISCONNECTED);
+	TEST_ASSERT_EQUAL(0, k_sem_take(&cloud_disconnected_sem, K_MINUTES(1)));
+
+	k_sleep(K_HOURS(OUTAGE_HOURS));
+
+	backlog = sim.samples_generated - sim.samples_delivered - sim.samples_lost;
+	start_ms = k_uptime_get();
+
+	network_publish(NETWORK_CONNECTED);
+
+	/* Storage is first in, first out. The backlog is drained when as many samples as were
+	 * stored at reconnection have been sent, later samples come on top.
+	 */
+	while (k_uptime_get() - start_ms < (int64_t)DRAIN_TIMEOUT_HOURS * MSEC_PER_SEC * 3600) {
+		if (sim.samples_delivered + sim.samples_lost >= backlog) {
+			drained = true;
+			break;
+		}
+
+		k_sleep(K_SECONDS(1));
+	}
+
+	drain_time_ms = k_uptime_get() - start_ms;
+
+	report("outage_drain", "outage_hours", OUTAGE_HOURS);
+	report("outage_drain", "backlog_samples", backlog);
+	report("outage_drain", "drain_time_ms", drain_time_ms);
+	report("outage_drain", "drain_samples_per_minute",
+	       (drain_time_ms > 0) ? ((uint64_t)backlog * 60 * MSEC_PER_SEC) / drain_time_ms : 0);
+	report_samples("outage_drain");
+	report_latency("outage_drain", &sim.upload_latency);
+	report_requests("outage_drain");
+
+	TEST_ASSERT_GREATER_THAN(0, backlog);
+	TEST_ASSERT_TRUE(drained);
+}
+
+/* Peak heap usage over all scenarios. Must be the last test.
+ *
+ * Threads run on host stacks on native_sim, their stack usage can only be measured on target,
+ * for example with the kernel thread stacks shell command.
+ */
+void test_benchmark_peak_ram(void)
+{
+	struct sys_memory_stats stats;
+
+	TEST_ASSERT_EQUAL(0, sys_heap_runtime_stats_get(&_system_heap.heap, &stats));
+
+	report("ram", "heap_size_bytes", CONFIG_HEAP_MEM_POOL_SIZE);
+	report("ram", "heap_peak_bytes", stats.max_allocated_bytes);
+	report("ram", "heap_allocated_bytes", stats.allocated_bytes);
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
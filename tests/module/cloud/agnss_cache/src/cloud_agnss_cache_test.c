@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <date_time.h>
+
+#include "cloud_agnss_cache.h"
+
+DEFINE_FFF_GLOBALS;
+
+/* Used by cloud_agnss_cache.c */
+LOG_MODULE_REGISTER(cloud, 4);
+
+FAKE_VALUE_FUNC(int, settings_subsys_init);
+FAKE_VALUE_FUNC(int, settings_save_one, const char *, const void *, size_t);
+FAKE_VALUE_FUNC(int, settings_load_subtree_direct, const char *, settings_load_direct_cb,
+		void *);
+FAKE_VALUE_FUNC(int, date_time_now, int64_t *);
+
+#define EPHEMERIS_VALIDITY_MS \
+	((int64_t)CONFIG_APP_CLOUD_AGNSS_CACHE_EPHEMERIS_VALIDITY_MINUTES * 60 * MSEC_PER_SEC)
+
+/* Date and time returned by the date_time_now() fake, advanced between tests because the
+ * cache is kept between tests.
+ */
+static int64_t now_ms = 1735689600000LL;
+
+static const char agnss_data[] = { 0x01, 0x02, 0x20, 0x00, 0xaa, 0xbb, 0xcc };
+
+static int date_time_now_custom_fake(int64_t *time)
+{
+	*time = now_ms;
+
+	return 0;
+}
+
+static struct nrf_modem_gnss_agnss_data_frame gps_request(uint64_t ephe, uint64_t alm)
+{
+	struct nrf_modem_gnss_agnss_data_frame request = {
+		.data_flags = NRF_MODEM_GNSS_AGNSS_GPS_UTC_REQUEST |
+			      NRF_MODEM_GNSS_AGNSS_GPS_SYS_TIME_AND_SV_TOW_REQUEST,
+		.system_count = 1,
+		.system[0] = {
+			.system_id = NRF_MODEM_GNSS_SYSTEM_GPS,
+			.sv_mask_ephe = ephe,
+			.sv_mask_alm = alm,
+		},
+	};
+
+	return request;
+}
+
+void setUp(void)
+{
+	RESET_FAKE(settings_subsys_init);
+	RESET_FAKE(settings_save_one);
+	RESET_FAKE(settings_load_subtree_direct);
+	RESET_FAKE(date_time_now);
+
+	date_time_now_fake.custom_fake = date_time_now_custom_fake;
+
+	/* Expire everything cached by the previous test */
+	now_ms += (int64_t)CONFIG_APP_CLOUD_AGNSS_CACHE_ALMANAC_VALIDITY_HOURS * 60 * 60 *
+		  MSEC_PER_SEC;
+}
+
+void tearDown(void)
+{
+}
+
+void test_request_split_into_parts(void)
+{
+	struct nrf_modem_gnss_agnss_data_frame request = gps_request(0xff, 0xf0f0);
+	struct nrf_modem_gnss_agnss_data_frame part;
+
+	TEST_ASSERT_TRUE(cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_OTHER, &request, &part));
+	TEST_ASSERT_EQUAL(request.data_flags, part.data_flags);
+	TEST_ASSERT_TRUE(part.system[0].sv_mask_ephe == 0);
+	TEST_ASSERT_TRUE(part.system[0].sv_mask_alm == 0);
+
+	TEST_ASSERT_TRUE(cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_EPHEMERIDES, &request,
+						    &part));
+	TEST_ASSERT_EQUAL(0, part.data_flags);
+	TEST_ASSERT_TRUE(part.system[0].sv_mask_ephe == 0xff);
+	TEST_ASSERT_TRUE(part.system[0].sv_mask_alm == 0);
+
+	TEST_ASSERT_TRUE(cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_ALMANAC, &request, &part));
+	TEST_ASSERT_EQUAL(0, part.data_flags);
+	TEST_ASSERT_TRUE(part.system[0].sv_mask_ephe == 0);
+	TEST_ASSERT_TRUE(part.system[0].sv_mask_alm == 0xf0f0);
+
+	/* Parts the modem does not request are skipped */
+	request = gps_request(0, 0);
+	request.data_flags = 0;
+
+	TEST_ASSERT_FALSE(cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_OTHER, &request, &part));
+	TEST_ASSERT_FALSE(cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_EPHEMERIDES, &request,
+						     &part));
+	TEST_ASSERT_FALSE(cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_ALMANAC, &request, &part));
+}
+
+void test_cached_ephemerides_used_for_covered_satellites(void)
+{
+	struct nrf_modem_gnss_agnss_data_frame request = gps_request(0xff, 0);
+	struct nrf_modem_gnss_agnss_data_frame part;
+	const char *data;
+	size_t size;
+
+	(void)cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_EPHEMERIDES, &request, &part);
+	TEST_ASSERT_FALSE(cloud_agnss_cache_lookup(CLOUD_AGNSS_PART_EPHEMERIDES, &part,
+						   &data, &size));
+
+	cloud_agnss_cache_add(CLOUD_AGNSS_PART_EPHEMERIDES, &part, agnss_data, sizeof(agnss_data));
+	TEST_ASSERT_EQUAL(1, settings_save_one_fake.call_count);
+	TEST_ASSERT_EQUAL_STRING("att_cloud/agnss/ephe", settings_save_one_fake.arg0_val);
+
+	/* A subset of the cached satellites is a hit */
+	request = gps_request(0x0f, 0);
+	(void)cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_EPHEMERIDES, &request, &part);
+	TEST_ASSERT_TRUE(cloud_agnss_cache_lookup(CLOUD_AGNSS_PART_EPHEMERIDES, &part,
+						  &data, &size));
+	TEST_ASSERT_EQUAL(sizeof(agnss_data), size);
+	TEST_ASSERT_EQUAL_MEMORY(agnss_data, data, sizeof(agnss_data));
+
+	/* A satellite that is not cached is a miss */
+	request = gps_request(0x1ff, 0);
+	(void)cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_EPHEMERIDES, &request, &part);
+	TEST_ASSERT_FALSE(cloud_agnss_cache_lookup(CLOUD_AGNSS_PART_EPHEMERIDES, &part,
+						   &data, &size));
+
+	/* Almanacs are cached separately */
+	request = gps_request(0, 0x0f);
+	(void)cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_ALMANAC, &request, &part);
+	TEST_ASSERT_FALSE(cloud_agnss_cache_lookup(CLOUD_AGNSS_PART_ALMANAC, &part,
+						   &data, &size));
+}
+
+void test_cached_ephemerides_expire(void)
+{
+	struct nrf_modem_gnss_agnss_data_frame request = gps_request(0xff, 0);
+	struct nrf_modem_gnss_agnss_data_frame part;
+	const char *data;
+	size_t size;
+
+	(void)cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_EPHEMERIDES, &request, &part);
+	cloud_agnss_cache_add(CLOUD_AGNSS_PART_EPHEMERIDES, &part, agnss_data, sizeof(agnss_data));
+
+	now_ms += EPHEMERIS_VALIDITY_MS - 1;
+	TEST_ASSERT_TRUE(cloud_agnss_cache_lookup(CLOUD_AGNSS_PART_EPHEMERIDES, &part,
+						  &data, &size));
+
+	now_ms += 1;
+	TEST_ASSERT_FALSE(cloud_agnss_cache_lookup(CLOUD_AGNSS_PART_EPHEMERIDES, &part,
+						   &data, &size));
+}
+
+void test_not_cached_without_date_time_or_when_too_large(void)
+{
+	static char large_data[CONFIG_APP_CLOUD_AGNSS_CACHE_BUF_SIZE + 1];
+	struct nrf_modem_gnss_agnss_data_frame request = gps_request(0, 0xff);
+	struct nrf_modem_gnss_agnss_data_frame part;
+	const char *data;
+	size_t size;
+
+	(void)cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_ALMANAC, &request, &part);
+
+	cloud_agnss_cache_add(CLOUD_AGNSS_PART_ALMANAC, &part, large_data, sizeof(large_data));
+	TEST_ASSERT_EQUAL(0, settings_save_one_fake.call_count);
+
+	date_time_now_fake.custom_fake = NULL;
+	date_time_now_fake.return_val = -ENODATA;
+
+	cloud_agnss_cache_add(CLOUD_AGNSS_PART_ALMANAC, &part, agnss_data, sizeof(agnss_data));
+	TEST_ASSERT_EQUAL(0, settings_save_one_fake.call_count);
+
+	date_time_now_fake.custom_fake = date_time_now_custom_fake;
+	TEST_ASSERT_FALSE(cloud_agnss_cache_lookup(CLOUD_AGNSS_PART_ALMANAC, &part,
+						   &data, &size));
+
+	/* The other part is never cached */
+	(void)cloud_agnss_cache_part_get(CLOUD_AGNSS_PART_OTHER, &request, &part);
+	cloud_agnss_cache_add(CLOUD_AGNSS_PART_OTHER, &part, agnss_data, sizeof(agnss_data));
+	TEST_ASSERT_EQUAL(0, settings_save_one_fake.call_count);
+	TEST_ASSERT_FALSE(cloud_agnss_cache_lookup(CLOUD_AGNSS_PART_OTHER, &part, &data, &size));
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
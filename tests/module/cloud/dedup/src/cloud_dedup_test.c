@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "cloud_dedup.h"
+#include "storage.h"
+#include "storage_data_types.h"
+#include "power.h"
+#include "environmental.h"
+#include "location.h"
+
+/* Used by cloud_dedup.c */
+LOG_MODULE_REGISTER(cloud, 4);
+
+static struct storage_data_item battery_item(double percentage)
+{
+	struct storage_data_item item = {
+		.type = STORAGE_TYPE_BATTERY,
+		.data.BATTERY.percentage = percentage,
+	};
+
+	return item;
+}
+
+static struct storage_data_item env_item(double temperature, double humidity, double pressure)
+{
+	struct storage_data_item item = {
+		.type = STORAGE_TYPE_ENVIRONMENTAL,
+		.data.ENVIRONMENTAL.temperature = temperature,
+		.data.ENVIRONMENTAL.humidity = humidity,
+		.data.ENVIRONMENTAL.pressure = pressure,
+	};
+
+	return item;
+}
+
+/* Check a sample and commit it as sent if it is not suppressed */
+static bool check_and_send(const struct storage_data_item *item)
+{
+	bool suppressed = cloud_dedup_suppress(item);
+
+	cloud_dedup_commit(item->type);
+
+	return suppressed;
+}
+
+void setUp(void)
+{
+	struct storage_data_item battery = battery_item(-1000.0);
+	struct storage_data_item env = env_item(-1000.0, -1000.0, -1000.0);
+
+	/* Start every test from a reference that no test value is a repeat of */
+	(void)check_and_send(&battery);
+	(void)check_and_send(&env);
+}
+
+void tearDown(void)
+{
+}
+
+void test_battery_within_deadband_suppressed(void)
+{
+	struct storage_data_item first = battery_item(80.0);
+	struct storage_data_item repeat = battery_item(80.5);
+	struct storage_data_item changed = battery_item(81.5);
+
+	TEST_ASSERT_FALSE(check_and_send(&first));
+	TEST_ASSERT_TRUE(check_and_send(&repeat));
+
+	/* Compared against the last sample sent, not the last suppressed one */
+	TEST_ASSERT_FALSE(check_and_send(&changed));
+}
+
+void test_repeats_sent_after_max_suppressed(void)
+{
+	struct storage_data_item item = battery_item(50.0);
+
+	TEST_ASSERT_FALSE(check_and_send(&item));
+
+	for (int i = 0; i < CONFIG_APP_CLOUD_DEDUP_MAX_SUPPRESSED; i++) {
+		TEST_ASSERT_TRUE(check_and_send(&item));
+	}
+
+	TEST_ASSERT_FALSE(check_and_send(&item));
+	TEST_ASSERT_TRUE(check_and_send(&item));
+}
+
+void test_environmental_suppressed_only_if_all_values_repeat(void)
+{
+	struct storage_data_item first = env_item(21.0, 40.0, 101325.0);
+	struct storage_data_item repeat = env_item(21.4, 40.9, 101360.0);
+	struct storage_data_item humidity_changed = env_item(21.0, 41.5, 101325.0);
+
+	TEST_ASSERT_FALSE(check_and_send(&first));
+	TEST_ASSERT_TRUE(check_and_send(&repeat));
+	TEST_ASSERT_FALSE(check_and_send(&humidity_changed));
+}
+
+void test_rollback_forgets_unsent_samples(void)
+{
+	struct storage_data_item sent = battery_item(70.0);
+	struct storage_data_item unsent = battery_item(60.0);
+
+	TEST_ASSERT_FALSE(check_and_send(&sent));
+
+	/* Checked but never sent, for example because the batch failed */
+	TEST_ASSERT_FALSE(cloud_dedup_suppress(&unsent));
+	cloud_dedup_rollback();
+
+	/* Still compared against the sample that was sent */
+	TEST_ASSERT_FALSE(check_and_send(&unsent));
+	TEST_ASSERT_TRUE(check_and_send(&unsent));
+}
+
+void test_other_types_never_suppressed(void)
+{
+	struct storage_data_item item = {
+		.type = STORAGE_TYPE_LOCATION,
+	};
+
+	TEST_ASSERT_FALSE(cloud_dedup_suppress(&item));
+	TEST_ASSERT_FALSE(cloud_dedup_suppress(&item));
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <modem/lte_lc.h>
+
+#include "cloud_location_cache.h"
+#include "location.h"
+
+DEFINE_FFF_GLOBALS;
+
+/* Used by cloud_location_cache.c */
+LOG_MODULE_REGISTER(cloud, 4);
+
+FAKE_VALUE_FUNC(int, settings_subsys_init);
+FAKE_VALUE_FUNC(int, settings_save_one, const char *, const void *, size_t);
+FAKE_VALUE_FUNC(int, settings_load_subtree_direct, const char *, settings_load_direct_cb,
+		void *);
+
+/* Cell IDs are unique per test, because the cache is kept between tests */
+static uint32_t next_cell_id = 1000;
+
+static struct location_cloud_request_data cell_request(uint32_t cell_id)
+{
+	struct location_cloud_request_data request = {
+		.current_cell = {
+			.id = cell_id,
+			.mcc = 242,
+			.mnc = 1,
+			.tac = 100,
+		},
+	};
+
+	return request;
+}
+
+static void wifi_ap_add(struct location_cloud_request_data *request, uint8_t last_byte,
+			int8_t rssi)
+{
+	struct location_wifi_ap_info *ap = &request->wifi_aps[request->wifi_cnt++];
+	const uint8_t mac[MAC_ADDR_LEN] = { 0x02, 0x00, 0x00, 0x00, 0x00, last_byte };
+
+	memcpy(ap->mac, mac, sizeof(mac));
+	ap->mac_length = MAC_ADDR_LEN;
+	ap->rssi = rssi;
+}
+
+static struct cloud_location_cache_position position(double lat)
+{
+	struct cloud_location_cache_position pos = {
+		.lat = lat,
+		.lon = 10.437,
+		.unc = 500,
+	};
+
+	return pos;
+}
+
+void setUp(void)
+{
+	RESET_FAKE(settings_subsys_init);
+	RESET_FAKE(settings_save_one);
+	RESET_FAKE(settings_load_subtree_direct);
+}
+
+void tearDown(void)
+{
+}
+
+void test_miss_then_hit_after_add(void)
+{
+	struct location_cloud_request_data request = cell_request(next_cell_id++);
+	struct cloud_location_cache_position added = position(63.421);
+	struct cloud_location_cache_position found;
+
+	TEST_ASSERT_FALSE(cloud_location_cache_lookup(&request, &found));
+
+	cloud_location_cache_add(&request, &added);
+	TEST_ASSERT_EQUAL(1, settings_save_one_fake.call_count);
+	TEST_ASSERT_EQUAL_STRING("att_cloud/loc_cache", settings_save_one_fake.arg0_val);
+
+	TEST_ASSERT_TRUE(cloud_location_cache_lookup(&request, &found));
+	TEST_ASSERT_TRUE(found.lat == added.lat);
+	TEST_ASSERT_TRUE(found.lon == added.lon);
+	TEST_ASSERT_EQUAL(added.unc, found.unc);
+
+	/* Lookups are not saved */
+	TEST_ASSERT_EQUAL(1, settings_save_one_fake.call_count);
+}
+
+void test_wifi_fingerprint_ignores_scan_order_and_weak_aps(void)
+{
+	uint32_t cell_id = next_cell_id++;
+	struct location_cloud_request_data first = cell_request(cell_id);
+	struct location_cloud_request_data second = cell_request(cell_id);
+	struct location_cloud_request_data other = cell_request(cell_id);
+	struct cloud_location_cache_position added = position(59.9);
+	struct cloud_location_cache_position found;
+
+	wifi_ap_add(&first, 1, -40);
+	wifi_ap_add(&first, 2, -50);
+	wifi_ap_add(&first, 3, -60);
+	wifi_ap_add(&first, 4, -90);
+
+	/* Same strongest access points in another order, with a different weak one */
+	wifi_ap_add(&second, 3, -55);
+	wifi_ap_add(&second, 5, -85);
+	wifi_ap_add(&second, 1, -45);
+	wifi_ap_add(&second, 2, -48);
+
+	/* Another strongest access point */
+	wifi_ap_add(&other, 1, -40);
+	wifi_ap_add(&other, 2, -50);
+	wifi_ap_add(&other, 6, -45);
+
+	cloud_location_cache_add(&first, &added);
+
+	TEST_ASSERT_TRUE(cloud_location_cache_lookup(&second, &found));
+	TEST_ASSERT_TRUE(found.lat == added.lat);
+	TEST_ASSERT_FALSE(cloud_location_cache_lookup(&other, &found));
+}
+
+void test_least_recently_used_entry_replaced(void)
+{
+	struct location_cloud_request_data requests[CONFIG_APP_CLOUD_LOCATION_CACHE_ENTRIES + 1];
+	struct cloud_location_cache_position added = position(60.0);
+	struct cloud_location_cache_position found;
+
+	for (size_t i = 0; i < ARRAY_SIZE(requests); i++) {
+		requests[i] = cell_request(next_cell_id++);
+	}
+
+	for (size_t i = 0; i < CONFIG_APP_CLOUD_LOCATION_CACHE_ENTRIES; i++) {
+		cloud_location_cache_add(&requests[i], &added);
+	}
+
+	/* Use the oldest entry, so that the second oldest is replaced */
+	TEST_ASSERT_TRUE(cloud_location_cache_lookup(&requests[0], &found));
+
+	cloud_location_cache_add(&requests[CONFIG_APP_CLOUD_LOCATION_CACHE_ENTRIES], &added);
+
+	TEST_ASSERT_TRUE(cloud_location_cache_lookup(&requests[0], &found));
+	TEST_ASSERT_FALSE(cloud_location_cache_lookup(&requests[1], &found));
+
+	for (size_t i = 2; i < ARRAY_SIZE(requests); i++) {
+		TEST_ASSERT_TRUE(cloud_location_cache_lookup(&requests[i], &found));
+	}
+}
+
+void test_request_without_cell_or_wifi_not_cached(void)
+{
+	struct location_cloud_request_data request = cell_request(LTE_LC_CELL_EUTRAN_ID_INVALID);
+	struct cloud_location_cache_position added = position(61.0);
+	struct cloud_location_cache_position found;
+
+	cloud_location_cache_add(&request, &added);
+
+	TEST_ASSERT_EQUAL(0, settings_save_one_fake.call_count);
+	TEST_ASSERT_FALSE(cloud_location_cache_lookup(&request, &found));
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+#include <net/nrf_cloud_defs.h>
+
+#include "cloud.h"
+#include "cloud_priority.h"
+
+DEFINE_FFF_GLOBALS;
+
+/* Used by cloud_priority.c */
+LOG_MODULE_REGISTER(cloud, 4);
+
+/* CoAP 4.00 Bad Request, as returned by the nRF Cloud CoAP library */
+#define COAP_BAD_REQUEST 0x80
+
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_sensor_send, const char *, double, int64_t, bool);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_json_message_send, const char *, bool, bool);
+FAKE_VALUE_FUNC(bool, date_time_is_valid);
+FAKE_VALUE_FUNC(int, date_time_uptime_to_unix_time_ms, int64_t *);
+
+static void button_publish(uint8_t button_number)
+{
+	struct cloud_priority_msg msg = {
+		.type = CLOUD_PRIORITY_BUTTON,
+		.uptime_ms = k_uptime_get(),
+		.button_number = button_number,
+	};
+
+	TEST_ASSERT_EQUAL(0, zbus_chan_pub(&cloud_priority_chan, &msg, K_NO_WAIT));
+}
+
+static void geofence_publish(uint32_t zone_id)
+{
+	struct cloud_priority_msg msg = {
+		.type = CLOUD_PRIORITY_GEOFENCE,
+		.uptime_ms = k_uptime_get(),
+		.geofence.zone_id = zone_id,
+		.geofence.entered = true,
+	};
+
+	TEST_ASSERT_EQUAL(0, zbus_chan_pub(&cloud_priority_chan, &msg, K_NO_WAIT));
+}
+
+static void environmental_publish(double temperature, double humidity, double pressure)
+{
+	struct cloud_priority_msg msg = {
+		.type = CLOUD_PRIORITY_ENVIRONMENTAL,
+		.uptime_ms = k_uptime_get(),
+		.environmental.temperature = temperature,
+		.environmental.humidity = humidity,
+		.environmental.pressure = pressure,
+	};
+
+	TEST_ASSERT_EQUAL(0, zbus_chan_pub(&cloud_priority_chan, &msg, K_NO_WAIT));
+}
+
+void setUp(void)
+{
+	/* Empty the queue left by the previous test */
+	RESET_FAKE(nrf_cloud_coap_sensor_send);
+	RESET_FAKE(nrf_cloud_coap_json_message_send);
+	TEST_ASSERT_EQUAL(0, cloud_priority_send_pending());
+
+	RESET_FAKE(nrf_cloud_coap_sensor_send);
+	RESET_FAKE(nrf_cloud_coap_json_message_send);
+	RESET_FAKE(date_time_is_valid);
+	RESET_FAKE(date_time_uptime_to_unix_time_ms);
+	FFF_RESET_HISTORY();
+}
+
+void tearDown(void)
+{
+}
+
+void test_events_sent_in_order(void)
+{
+	button_publish(1);
+	geofence_publish(7);
+	button_publish(2);
+
+	TEST_ASSERT_EQUAL(0, cloud_priority_send_pending());
+
+	TEST_ASSERT_EQUAL(2, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_json_message_send_fake.call_count);
+	TEST_ASSERT_EQUAL_STRING(NRF_CLOUD_JSON_APPID_VAL_BTN,
+				 nrf_cloud_coap_sensor_send_fake.arg0_history[0]);
+	TEST_ASSERT_EQUAL_DOUBLE(1.0, nrf_cloud_coap_sensor_send_fake.arg1_history[0]);
+	TEST_ASSERT_EQUAL_DOUBLE(2.0, nrf_cloud_coap_sensor_send_fake.arg1_history[1]);
+
+	/* Without a valid time, the time of reception is used */
+	TEST_ASSERT_EQUAL(NRF_CLOUD_NO_TIMESTAMP, nrf_cloud_coap_sensor_send_fake.arg2_history[0]);
+
+	/* Sent events are removed from the queue */
+	TEST_ASSERT_EQUAL(0, cloud_priority_send_pending());
+	TEST_ASSERT_EQUAL(2, nrf_cloud_coap_sensor_send_fake.call_count);
+}
+
+void test_network_error_keeps_event(void)
+{
+	button_publish(1);
+	button_publish(2);
+
+	nrf_cloud_coap_sensor_send_fake.return_val = -ETIMEDOUT;
+	TEST_ASSERT_EQUAL(-ETIMEDOUT, cloud_priority_send_pending());
+
+	/* The events after the failed one are not tried */
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_sensor_send_fake.call_count);
+
+	nrf_cloud_coap_sensor_send_fake.return_val = 0;
+	TEST_ASSERT_EQUAL(0, cloud_priority_send_pending());
+
+	TEST_ASSERT_EQUAL(3, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL_DOUBLE(1.0, nrf_cloud_coap_sensor_send_fake.arg1_history[1]);
+	TEST_ASSERT_EQUAL_DOUBLE(2.0, nrf_cloud_coap_sensor_send_fake.arg1_history[2]);
+}
+
+void test_event_dropped_after_max_attempts(void)
+{
+	button_publish(1);
+	button_publish(2);
+
+	nrf_cloud_coap_sensor_send_fake.return_val = -ETIMEDOUT;
+
+	for (int i = 0; i < CONFIG_APP_CLOUD_PRIORITY_SEND_ATTEMPTS; i++) {
+		TEST_ASSERT_EQUAL(-ETIMEDOUT, cloud_priority_send_pending());
+	}
+
+	TEST_ASSERT_EQUAL(CONFIG_APP_CLOUD_PRIORITY_SEND_ATTEMPTS,
+			  nrf_cloud_coap_sensor_send_fake.call_count);
+
+	/* The first event has been dropped, the second one is sent next */
+	nrf_cloud_coap_sensor_send_fake.return_val = 0;
+	TEST_ASSERT_EQUAL(0, cloud_priority_send_pending());
+
+	TEST_ASSERT_EQUAL(CONFIG_APP_CLOUD_PRIORITY_SEND_ATTEMPTS + 1,
+			  nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL_DOUBLE(2.0, nrf_cloud_coap_sensor_send_fake.arg1_history[
+				 CONFIG_APP_CLOUD_PRIORITY_SEND_ATTEMPTS]);
+}
+
+void test_attempts_reset_for_next_event(void)
+{
+	int seq[] = { -ETIMEDOUT, 0, -ETIMEDOUT, -ETIMEDOUT, 0 };
+
+	button_publish(1);
+	button_publish(2);
+
+	SET_RETURN_SEQ(nrf_cloud_coap_sensor_send, seq, ARRAY_SIZE(seq));
+
+	TEST_ASSERT_EQUAL(-ETIMEDOUT, cloud_priority_send_pending());
+	TEST_ASSERT_EQUAL(-ETIMEDOUT, cloud_priority_send_pending());
+	TEST_ASSERT_EQUAL(-ETIMEDOUT, cloud_priority_send_pending());
+
+	/* The second event is still queued after two failures of its own */
+	TEST_ASSERT_EQUAL(0, cloud_priority_send_pending());
+
+	TEST_ASSERT_EQUAL(5, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL_DOUBLE(2.0, nrf_cloud_coap_sensor_send_fake.arg1_history[4]);
+}
+
+void test_rejected_event_dropped(void)
+{
+	button_publish(1);
+	geofence_publish(7);
+
+	nrf_cloud_coap_sensor_send_fake.return_val = COAP_BAD_REQUEST;
+
+	/* Not a network error, so the following events are sent */
+	TEST_ASSERT_EQUAL(0, cloud_priority_send_pending());
+
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_json_message_send_fake.call_count);
+
+	TEST_ASSERT_EQUAL(0, cloud_priority_send_pending());
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_sensor_send_fake.call_count);
+}
+
+void test_invalid_event_dropped(void)
+{
+	struct cloud_priority_msg unknown = {
+		.type = CLOUD_PRIORITY_ENVIRONMENTAL + 1,
+	};
+
+	geofence_publish(7);
+	TEST_ASSERT_EQUAL(0, zbus_chan_pub(&cloud_priority_chan, &unknown, K_NO_WAIT));
+	button_publish(1);
+
+	nrf_cloud_coap_json_message_send_fake.return_val = -EINVAL;
+
+	TEST_ASSERT_EQUAL(0, cloud_priority_send_pending());
+
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_json_message_send_fake.call_count);
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_sensor_send_fake.call_count);
+}
+
+void test_environmental_resumed_after_failure(void)
+{
+	int seq[] = { 0, -ETIMEDOUT, 0 };
+
+	environmental_publish(21.5, 40.0, 1000.0);
+
+	SET_RETURN_SEQ(nrf_cloud_coap_sensor_send, seq, ARRAY_SIZE(seq));
+
+	TEST_ASSERT_EQUAL(-ETIMEDOUT, cloud_priority_send_pending());
+	TEST_ASSERT_EQUAL(0, cloud_priority_send_pending());
+
+	/* The temperature is not sent again */
+	TEST_ASSERT_EQUAL(4, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL_STRING(NRF_CLOUD_JSON_APPID_VAL_TEMP,
+				 nrf_cloud_coap_sensor_send_fake.arg0_history[0]);
+	TEST_ASSERT_EQUAL_STRING(NRF_CLOUD_JSON_APPID_VAL_HUMID,
+				 nrf_cloud_coap_sensor_send_fake.arg0_history[1]);
+	TEST_ASSERT_EQUAL_STRING(NRF_CLOUD_JSON_APPID_VAL_HUMID,
+				 nrf_cloud_coap_sensor_send_fake.arg0_history[2]);
+	TEST_ASSERT_EQUAL_STRING(NRF_CLOUD_JSON_APPID_VAL_AIR_PRESS,
+				 nrf_cloud_coap_sensor_send_fake.arg0_history[3]);
+}
+
+void test_environmental_without_pressure(void)
+{
+	environmental_publish(21.5, 40.0, NAN);
+
+	TEST_ASSERT_EQUAL(0, cloud_priority_send_pending());
+
+	TEST_ASSERT_EQUAL(2, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL_STRING(NRF_CLOUD_JSON_APPID_VAL_HUMID,
+				 nrf_cloud_coap_sensor_send_fake.arg0_history[1]);
+}
+
+void test_queue_full_drops_new_events(void)
+{
+	for (uint8_t i = 1; i <= CONFIG_APP_CLOUD_PRIORITY_QUEUE_SIZE + 1; i++) {
+		button_publish(i);
+	}
+
+	TEST_ASSERT_EQUAL(0, cloud_priority_send_pending());
+
+	TEST_ASSERT_EQUAL(CONFIG_APP_CLOUD_PRIORITY_QUEUE_SIZE,
+			  nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL_DOUBLE((double)CONFIG_APP_CLOUD_PRIORITY_QUEUE_SIZE,
+				 nrf_cloud_coap_sensor_send_fake.arg1_history[
+				 CONFIG_APP_CLOUD_PRIORITY_QUEUE_SIZE - 1]);
+}
+
+/* This is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/settings/settings.h>
+#include <modem/modem_key_mgmt.h>
+#include <net/nrf_provisioning.h>
+
+#include "cloud_provisioning.h"
+#include "cloud_internal.h"
+#include "network.h"
+
+/* Used by cloud_provisioning.c */
+LOG_MODULE_REGISTER(cloud, 4);
+
+/* Settings key and size of the marker, as in cloud_provisioning.c */
+#define SETTINGS_KEY		"att_cloud/prov"
+#define FINGERPRINT_SIZE	32
+
+DEFINE_FFF_GLOBALS;
+
+FAKE_VALUE_FUNC(int, nrf_provisioning_init, nrf_provisioning_event_cb_t);
+FAKE_VALUE_FUNC(int, nrf_provisioning_trigger_manually);
+FAKE_VALUE_FUNC(int, settings_subsys_init);
+FAKE_VALUE_FUNC(int, settings_load_subtree_direct, const char *, settings_load_direct_cb, void *);
+FAKE_VALUE_FUNC(int, settings_save_one, const char *, const void *, size_t);
+FAKE_VALUE_FUNC(int, settings_delete, const char *);
+FAKE_VALUE_FUNC(int, modem_key_mgmt_digest, nrf_sec_tag_t, enum modem_key_mgmt_cred_type,
+		void *, size_t);
+
+ZBUS_CHAN_DEFINE(network_chan,
+		 struct network_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_DEFINE(priv_cloud_chan,
+		 struct priv_cloud_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+/* Digests of the private key of two identities */
+static const uint8_t digest_a[FINGERPRINT_SIZE] = { 0xa1, 0xa2, 0xa3, [31] = 0xaf };
+static const uint8_t digest_b[FINGERPRINT_SIZE] = { 0xb1, 0xb2, 0xb3, [31] = 0xbf };
+
+/* Private key in the modem */
+static const uint8_t *modem_digest;
+
+/* Marker in settings, flash_len is 0 when there is none */
+static uint8_t flash_marker[FINGERPRINT_SIZE];
+static size_t flash_len;
+
+static ssize_t flash_read(void *cb_arg, void *data, size_t len)
+{
+	ARG_UNUSED(cb_arg);
+
+	len = MIN(len, flash_len);
+	memcpy(data, flash_marker, len);
+
+	return len;
+}
+
+static int settings_load_subtree_direct_custom(const char *subtree, settings_load_direct_cb cb,
+					       void *param)
+{
+	TEST_ASSERT_EQUAL_STRING(SETTINGS_KEY, subtree);
+
+	if (flash_len == 0) {
+		return 0;
+	}
+
+	return cb(NULL, flash_len, flash_read, NULL, param);
+}
+
+static int settings_save_one_custom(const char *name, const void *value, size_t val_len)
+{
+	TEST_ASSERT_EQUAL_STRING(SETTINGS_KEY, name);
+	TEST_ASSERT_EQUAL(FINGERPRINT_SIZE, val_len);
+
+	memcpy(flash_marker, value, val_len);
+	flash_len = val_len;
+
+	return 0;
+}
+
+static int settings_delete_custom(const char *name)
+{
+	TEST_ASSERT_EQUAL_STRING(SETTINGS_KEY, name);
+
+	flash_len = 0;
+
+	return 0;
+}
+
+static int modem_key_mgmt_digest_custom(nrf_sec_tag_t sec_tag,
+					enum modem_key_mgmt_cred_type cred_type, void *buf,
+					size_t len)
+{
+	TEST_ASSERT_EQUAL(CONFIG_NRF_CLOUD_COAP_SEC_TAG, sec_tag);
+	TEST_ASSERT_EQUAL(MODEM_KEY_MGMT_CRED_TYPE_PRIVATE_CERT, cred_type);
+	TEST_ASSERT_EQUAL(FINGERPRINT_SIZE, len);
+
+	memcpy(buf, modem_digest, len);
+
+	return 0;
+}
+
+static void flash_marker_set(const uint8_t *digest)
+{
+	memcpy(flash_marker, digest, FINGERPRINT_SIZE);
+	flash_len = FINGERPRINT_SIZE;
+}
+
+/* Forget what was loaded at boot, as a reset does */
+static void reboot(void)
+{
+	cloud_provisioning_test_reset();
+}
+
+void setUp(void)
+{
+	RESET_FAKE(nrf_provisioning_init);
+	RESET_FAKE(nrf_provisioning_trigger_manually);
+	RESET_FAKE(settings_subsys_init);
+	RESET_FAKE(settings_load_subtree_direct);
+	RESET_FAKE(settings_save_one);
+	RESET_FAKE(settings_delete);
+	RESET_FAKE(modem_key_mgmt_digest);
+
+	settings_load_subtree_direct_fake.custom_fake = settings_load_subtree_direct_custom;
+	settings_save_one_fake.custom_fake = settings_save_one_custom;
+	settings_delete_fake.custom_fake = settings_delete_custom;
+	modem_key_mgmt_digest_fake.custom_fake = modem_key_mgmt_digest_custom;
+
+	modem_digest = digest_a;
+	flash_len = 0;
+
+	reboot();
+}
+
+void tearDown(void)
+{
+}
+
+void test_no_marker(void)
+{
+	TEST_ASSERT_FALSE(cloud_provisioning_marker_valid());
+
+	/* Nothing to compare with */
+	TEST_ASSERT_EQUAL(0, modem_key_mgmt_digest_fake.call_count);
+}
+
+void test_marker_valid_with_same_credentials(void)
+{
+	flash_marker_set(digest_a);
+
+	TEST_ASSERT_TRUE(cloud_provisioning_marker_valid());
+	TEST_ASSERT_TRUE(cloud_provisioning_marker_valid());
+
+	/* Checked against the modem once per boot */
+	TEST_ASSERT_EQUAL(1, settings_load_subtree_direct_fake.call_count);
+	TEST_ASSERT_EQUAL(1, modem_key_mgmt_digest_fake.call_count);
+}
+
+void test_marker_not_valid_with_other_credentials(void)
+{
+	flash_marker_set(digest_b);
+
+	TEST_ASSERT_FALSE(cloud_provisioning_marker_valid());
+}
+
+void test_marker_not_valid_without_digest(void)
+{
+	flash_marker_set(digest_a);
+	modem_key_mgmt_digest_fake.custom_fake = NULL;
+	modem_key_mgmt_digest_fake.return_val = -ENOENT;
+
+	TEST_ASSERT_FALSE(cloud_provisioning_marker_valid());
+}
+
+void test_marker_of_unexpected_size_dropped(void)
+{
+	flash_marker_set(digest_a);
+	flash_len = FINGERPRINT_SIZE / 2;
+
+	TEST_ASSERT_FALSE(cloud_provisioning_marker_valid());
+	TEST_ASSERT_EQUAL(0, modem_key_mgmt_digest_fake.call_count);
+}
+
+void test_marker_saved_after_connection(void)
+{
+	cloud_provisioning_marker_save();
+
+	TEST_ASSERT_EQUAL(1, settings_save_one_fake.call_count);
+	TEST_ASSERT_EQUAL_MEMORY(digest_a, flash_marker, FINGERPRINT_SIZE);
+	TEST_ASSERT_TRUE(cloud_provisioning_marker_valid());
+
+	/* Not written again on the next connection */
+	cloud_provisioning_marker_save();
+
+	TEST_ASSERT_EQUAL(1, settings_save_one_fake.call_count);
+
+	reboot();
+
+	TEST_ASSERT_TRUE(cloud_provisioning_marker_valid());
+	TEST_ASSERT_EQUAL(1, settings_save_one_fake.call_count);
+}
+
+void test_marker_replaced_after_new_credentials(void)
+{
+	flash_marker_set(digest_b);
+
+	cloud_provisioning_marker_save();
+
+	TEST_ASSERT_EQUAL(1, settings_save_one_fake.call_count);
+	TEST_ASSERT_EQUAL_MEMORY(digest_a, flash_marker, FINGERPRINT_SIZE);
+	TEST_ASSERT_TRUE(cloud_provisioning_marker_valid());
+}
+
+void test_marker_cleared(void)
+{
+	flash_marker_set(digest_a);
+
+	cloud_provisioning_marker_clear();
+
+	TEST_ASSERT_EQUAL(1, settings_delete_fake.call_count);
+	TEST_ASSERT_FALSE(cloud_provisioning_marker_valid());
+
+	/* Nothing left to delete */
+	cloud_provisioning_marker_clear();
+
+	TEST_ASSERT_EQUAL(1, settings_delete_fake.call_count);
+
+	reboot();
+
+	TEST_ASSERT_FALSE(cloud_provisioning_marker_valid());
+}
+
+void test_provisioning_initialized_once(void)
+{
+	TEST_ASSERT_EQUAL(0, cloud_provisioning_init());
+	TEST_ASSERT_EQUAL(0, cloud_provisioning_trigger());
+	TEST_ASSERT_EQUAL(0, cloud_provisioning_trigger());
+
+	TEST_ASSERT_EQUAL(1, nrf_provisioning_init_fake.call_count);
+	TEST_ASSERT_EQUAL(2, nrf_provisioning_trigger_manually_fake.call_count);
+}
+
+void test_provisioning_initialized_on_first_trigger(void)
+{
+	flash_marker_set(digest_a);
+
+	/* The cloud module skips the initialization at boot with a valid marker */
+	TEST_ASSERT_TRUE(cloud_provisioning_marker_valid());
+	TEST_ASSERT_EQUAL(0, nrf_provisioning_init_fake.call_count);
+
+	/* Provisioning requested later, the marker is cleared as the credentials may change */
+	cloud_provisioning_marker_clear();
+
+	TEST_ASSERT_EQUAL(0, cloud_provisioning_trigger());
+
+	TEST_ASSERT_EQUAL(1, nrf_provisioning_init_fake.call_count);
+	TEST_ASSERT_EQUAL(1, nrf_provisioning_trigger_manually_fake.call_count);
+}
+
+void test_provisioning_init_retried_after_error(void)
+{
+	nrf_provisioning_init_fake.return_val = -ENOMEM;
+
+	TEST_ASSERT_EQUAL(-ENOMEM, cloud_provisioning_trigger());
+	TEST_ASSERT_EQUAL(0, nrf_provisioning_trigger_manually_fake.call_count);
+
+	nrf_provisioning_init_fake.return_val = 0;
+
+	TEST_ASSERT_EQUAL(0, cloud_provisioning_trigger());
+	TEST_ASSERT_EQUAL(2, nrf_provisioning_init_fake.call_count);
+	TEST_ASSERT_EQUAL(1, nrf_provisioning_trigger_manually_fake.call_count);
+}
+
+/* This is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
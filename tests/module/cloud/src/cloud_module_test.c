@@ -18,6 +18,7 @@
 #include <net/nrf_provisioning.h>
 #include <net/nrf_cloud_coap.h>
 #include <modem/modem_attest_token.h>
+#include <modem/modem_info.h>
 #include <zephyr/zbus/zbus.h>
 
 #include "environmental.h"
@@ -27,6 +28,9 @@
 #include "location.h"
 #include "storage.h"
 #include "storage_data_types.h"
+#include "cloud_policy.h"
+#include "cloud_session.h"
+#include "cloud_stats.h"
 #include "app_common.h"
 
 DEFINE_FFF_GLOBALS;
@@ -81,7 +85,7 @@ ZBUS_CHAN_DEFINE(storage_chan,
 );
 
 ZBUS_CHAN_DEFINE(storage_data_chan,
-		 struct storage_msg,
+		 struct storage_data_msg,
 		 NULL,
 		 NULL,
 		 ZBUS_OBSERVERS_EMPTY,
@@ -94,6 +98,8 @@ FAKE_VALUE_FUNC(int, nrf_cloud_client_id_get, char *, size_t);
 FAKE_VALUE_FUNC(int, nrf_cloud_coap_init);
 FAKE_VALUE_FUNC(int, nrf_cloud_coap_connect, const char * const);
 FAKE_VALUE_FUNC(int, nrf_cloud_coap_disconnect);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_pause);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_resume);
 FAKE_VALUE_FUNC(int, nrf_cloud_coap_shadow_configured_info_update, const char * const);
 FAKE_VALUE_FUNC(int, nrf_cloud_coap_shadow_network_info_update);
 FAKE_VALUE_FUNC(int, nrf_cloud_coap_shadow_device_status_update,
@@ -101,6 +107,13 @@ FAKE_VALUE_FUNC(int, nrf_cloud_coap_shadow_device_status_update,
 FAKE_VALUE_FUNC(int, nrf_cloud_coap_bytes_send, uint8_t *, size_t, bool);
 FAKE_VALUE_FUNC(int, nrf_cloud_coap_sensor_send, const char *, double, int64_t, bool);
 FAKE_VALUE_FUNC(int, nrf_cloud_coap_json_message_send, const char *, bool, bool);
+FAKE_VALUE_FUNC(int, nrf_cloud_coap_obj_send, struct nrf_cloud_obj *, bool);
+FAKE_VALUE_FUNC(int, nrf_cloud_obj_bulk_init, struct nrf_cloud_obj *);
+FAKE_VALUE_FUNC(int, nrf_cloud_obj_bulk_add, struct nrf_cloud_obj *, struct nrf_cloud_obj *);
+FAKE_VALUE_FUNC(int, nrf_cloud_obj_msg_init, struct nrf_cloud_obj *, const char *, const char *);
+FAKE_VALUE_FUNC(int, nrf_cloud_obj_num_add, struct nrf_cloud_obj *, const char *, double, bool);
+FAKE_VALUE_FUNC(int, nrf_cloud_obj_ts_add, struct nrf_cloud_obj *, int64_t);
+FAKE_VALUE_FUNC(int, nrf_cloud_obj_free, struct nrf_cloud_obj *);
 FAKE_VALUE_FUNC(int, nrf_cloud_coap_shadow_get, char *, size_t *, bool, enum coap_content_format);
 FAKE_VALUE_FUNC(int, nrf_cloud_coap_patch, const char *, const char *,
 		const uint8_t *, size_t,
@@ -122,6 +135,39 @@ FAKE_VALUE_FUNC(int, location_agnss_data_process, const char *, size_t);
 FAKE_VALUE_FUNC(int, nrf_provisioning_init, nrf_provisioning_event_cb_t);
 FAKE_VALUE_FUNC(int, nrf_provisioning_trigger_manually);
 FAKE_VALUE_FUNC(int, storage_batch_read, struct storage_data_item *, k_timeout_t);
+FAKE_VOID_FUNC(storage_batch_release, const struct storage_data_item *);
+FAKE_VALUE_FUNC(int, modem_info_string_get, enum modem_info, char *, size_t);
+
+/* Serving cell reported by the modem_info_string_get() fake */
+static const char *fake_cell_id = "0012BEEF";
+
+static int modem_info_string_get_custom_fake(enum modem_info info, char *buf, size_t buf_size)
+{
+	const char *value = (info == MODEM_INFO_CELLID) ? fake_cell_id : "fake";
+
+	strncpy(buf, value, buf_size - 1);
+	buf[buf_size - 1] = '\0';
+
+	return strlen(buf);
+}
+
+/* The cloud module claims batch items in place. Route claims through the storage_batch_read
+ * fake so that tests can drive the batch content with a single custom fake.
+ */
+int storage_batch_claim(const struct storage_data_item **item, k_timeout_t timeout)
+{
+	static struct storage_data_item claimed_item;
+	int err;
+
+	err = storage_batch_read(&claimed_item, timeout);
+	if (err) {
+		return err;
+	}
+
+	*item = &claimed_item;
+
+	return 0;
+}
 
 /* Forward declarations */
 static void dummy_cb(const struct zbus_channel *chan);
@@ -438,9 +484,19 @@ void setUp(void)
 	RESET_FAKE(nrf_cloud_coap_init);
 	RESET_FAKE(nrf_cloud_coap_connect);
 	RESET_FAKE(nrf_cloud_coap_disconnect);
+	RESET_FAKE(nrf_cloud_coap_pause);
+	RESET_FAKE(nrf_cloud_coap_resume);
 	RESET_FAKE(nrf_cloud_coap_shadow_network_info_update);
+	RESET_FAKE(modem_info_string_get);
 	RESET_FAKE(nrf_cloud_coap_shadow_device_status_update);
 	RESET_FAKE(nrf_cloud_coap_json_message_send);
+	RESET_FAKE(nrf_cloud_coap_obj_send);
+	RESET_FAKE(nrf_cloud_obj_bulk_init);
+	RESET_FAKE(nrf_cloud_obj_bulk_add);
+	RESET_FAKE(nrf_cloud_obj_msg_init);
+	RESET_FAKE(nrf_cloud_obj_num_add);
+	RESET_FAKE(nrf_cloud_obj_ts_add);
+	RESET_FAKE(nrf_cloud_obj_free);
 	RESET_FAKE(nrf_cloud_coap_location_send);
 	RESET_FAKE(nrf_cloud_coap_shadow_get);
 	RESET_FAKE(nrf_cloud_coap_patch);
@@ -450,6 +506,7 @@ void setUp(void)
 	RESET_FAKE(nrf_provisioning_init);
 	RESET_FAKE(nrf_provisioning_trigger_manually);
 	RESET_FAKE(storage_batch_read);
+	RESET_FAKE(storage_batch_release);
 	RESET_FAKE(nrf_cloud_coap_sensor_send);
 	RESET_FAKE(nrf_cloud_coap_location_get);
 	RESET_FAKE(nrf_cloud_coap_agnss_data_get);
@@ -460,6 +517,8 @@ void setUp(void)
 	date_time_uptime_to_unix_time_ms_fake.custom_fake =
 		date_time_uptime_to_unix_time_ms_custom_fake;
 	nrf_cloud_coap_location_send_fake.custom_fake = nrf_cloud_coap_location_send_custom_fake;
+	modem_info_string_get_fake.custom_fake = modem_info_string_get_custom_fake;
+	fake_cell_id = "0012BEEF";
 
 	k_sem_reset(&cloud_disconnected);
 	k_sem_reset(&cloud_connected);
@@ -647,6 +706,31 @@ void test_should_backoff_on_connection_failure(void)
 				     connect_duration_sec);
 }
 
+/* A connection rejected by the server backs off longer than a connection lost to the network */
+void test_should_backoff_longer_on_server_rejection(void)
+{
+	struct network_msg msg = {
+		.type = NETWORK_CONNECTED
+	};
+
+	/* Start a full connection also if a session was saved by the previous test */
+	nrf_cloud_coap_resume_fake.return_val = -EIO;
+	nrf_cloud_coap_connect_fake.return_val = -ECONNRESET;
+
+	publish_and_assert(&network_chan, &msg);
+	wait_for_processing();
+
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_connect_fake.call_count);
+
+	/* No new attempt after the backoff time used for network failures */
+	k_sleep(K_SECONDS(CONFIG_APP_CLOUD_BACKOFF_INITIAL_SECONDS + 1));
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_connect_fake.call_count);
+
+	k_sleep(K_SECONDS(CONFIG_APP_CLOUD_BACKOFF_INITIAL_SECONDS *
+			  (CONFIG_APP_CLOUD_BACKOFF_SERVER_REJECT_FACTOR - 1)));
+	TEST_ASSERT_EQUAL(2, nrf_cloud_coap_connect_fake.call_count);
+}
+
 void test_should_send_json_payload_to_cloud(void)
 {
 	struct cloud_msg msg = {
@@ -722,25 +806,19 @@ void test_gnss_location_data_handling(void)
 	struct network_msg network_msg = {
 		.type = NETWORK_CONNECTED
 	};
-	struct location_data mock_location = {
+	struct location_gnss_data mock_location = {
 		.latitude = 63.421,
 		.longitude = 10.437,
 		.accuracy = 5.0,
-		.datetime.valid = true,
-		.datetime.year = 2025,
-		.datetime.month = 1,
-		.datetime.day = 15,
-		.datetime.hour = 12,
-		.datetime.minute = 30,
-		.datetime.second = 45,
-		.datetime.ms = 0
+		.altitude = 120.0,
+		.flags = LOCATION_GNSS_HAS_ALTITUDE
 	};
 	struct location_msg location_msg = {
 		.type = LOCATION_GNSS_DATA,
 		.gnss_data = mock_location,
 		.timestamp = TEST_LOCATION_UNIX_MS
 	};
-	struct storage_msg storage_data_msg = {
+	struct storage_data_msg storage_data_msg = {
 		.type = STORAGE_DATA,
 		.data_type = STORAGE_TYPE_LOCATION,
 		.data_len = sizeof(struct location_msg)
@@ -766,7 +844,14 @@ void test_gnss_location_data_handling(void)
 	/* Verify the function was called with valid arguments and correct timestamp */
 	if (nrf_cloud_coap_location_send_fake.call_count > 0) {
 		TEST_ASSERT_EQUAL(TEST_LOCATION_UNIX_MS, last_gnss_data.ts_ms);
+		TEST_ASSERT_TRUE(last_gnss_data.pvt.has_alt);
+		TEST_ASSERT_EQUAL_FLOAT(120.0, last_gnss_data.pvt.alt);
+		TEST_ASSERT_FALSE(last_gnss_data.pvt.has_speed);
+		TEST_ASSERT_FALSE(last_gnss_data.pvt.has_heading);
 	}
+
+	/* Location fixes are critical data and always confirmable */
+	TEST_ASSERT_TRUE(nrf_cloud_coap_location_send_fake.arg1_val);
 }
 
 void test_storage_data_battery_sent_to_cloud(void)
@@ -799,6 +884,34 @@ void test_storage_data_battery_sent_to_cloud(void)
 	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_shadow_network_info_update_fake.call_count);
 }
 
+/* The uptime offset is looked up once per session and used for all items */
+void test_storage_batch_timestamps_converted_with_one_lookup(void)
+{
+	struct storage_msg batch_available = {
+		.type = STORAGE_BATCH_AVAILABLE,
+		.data_len = 2,
+		.session_id = 0x5EED0001,
+	};
+	unsigned int lookups;
+
+	connect_cloud();
+
+	fake_mode = FAKE_BATCH_TWO_BATTERY;
+	fake_read_calls = 0;
+	storage_batch_read_fake.custom_fake = storage_batch_read_custom;
+	lookups = date_time_uptime_to_unix_time_ms_fake.call_count;
+
+	publish_and_assert(&storage_chan, &batch_available);
+	wait_for_processing();
+
+	TEST_ASSERT_EQUAL(2, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL(TEST_BATTERY_UPTIME_MS + TEST_UPTIME_TO_UNIX_OFFSET_MS,
+			  nrf_cloud_coap_sensor_send_fake.arg2_history[0]);
+	TEST_ASSERT_EQUAL(TEST_BATTERY_UPTIME_MS + TEST_UPTIME_TO_UNIX_OFFSET_MS,
+			  nrf_cloud_coap_sensor_send_fake.arg2_history[1]);
+	TEST_ASSERT_EQUAL(lookups + 1, date_time_uptime_to_unix_time_ms_fake.call_count);
+}
+
 void test_storage_data_environmental_sent_to_cloud(void)
 {
 	struct storage_msg batch_available = {
@@ -819,20 +932,54 @@ void test_storage_data_environmental_sent_to_cloud(void)
 
 	/* One successful read + one -EAGAIN drain */
 	TEST_ASSERT_EQUAL(2, storage_batch_read_fake.call_count);
-	TEST_ASSERT_EQUAL(3, nrf_cloud_coap_sensor_send_fake.call_count);
 
-	/* Verify timestamps were converted correctly for all three calls */
+	/* All three readings are sent in a single request */
+	TEST_ASSERT_EQUAL(0, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_obj_send_fake.call_count);
+	TEST_ASSERT_EQUAL(3, nrf_cloud_obj_bulk_add_fake.call_count);
+
+	/* Verify timestamps were converted correctly for all three messages */
+	TEST_ASSERT_EQUAL(3, nrf_cloud_obj_ts_add_fake.call_count);
 	TEST_ASSERT_EQUAL(TEST_ENVIRONMENTAL_UPTIME_MS + TEST_UPTIME_TO_UNIX_OFFSET_MS,
-			  nrf_cloud_coap_sensor_send_fake.arg2_history[0]);
+			  nrf_cloud_obj_ts_add_fake.arg1_history[0]);
 	TEST_ASSERT_EQUAL(TEST_ENVIRONMENTAL_UPTIME_MS + TEST_UPTIME_TO_UNIX_OFFSET_MS,
-			  nrf_cloud_coap_sensor_send_fake.arg2_history[1]);
+			  nrf_cloud_obj_ts_add_fake.arg1_history[1]);
 	TEST_ASSERT_EQUAL(TEST_ENVIRONMENTAL_UPTIME_MS + TEST_UPTIME_TO_UNIX_OFFSET_MS,
-			  nrf_cloud_coap_sensor_send_fake.arg2_history[2]);
+			  nrf_cloud_obj_ts_add_fake.arg1_history[2]);
 
 	/* Verify shadow network info was updated after processing batch data */
 	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_shadow_network_info_update_fake.call_count);
 }
 
+void test_storage_data_environmental_real_time_single_request(void)
+{
+	struct environmental_msg env_msg = {
+		.type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE,
+		.temperature = 21.5,
+		.humidity = 40.0,
+		.pressure = 1002.3,
+		.timestamp = TEST_ENVIRONMENTAL_UPTIME_MS,
+	};
+	struct storage_data_msg storage_data_msg = {
+		.type = STORAGE_DATA,
+		.data_type = STORAGE_TYPE_ENVIRONMENTAL,
+		.data_len = sizeof(struct environmental_msg),
+	};
+
+	memcpy(storage_data_msg.buffer, &env_msg, sizeof(env_msg));
+
+	connect_cloud();
+
+	publish_and_assert(&storage_data_chan, &storage_data_msg);
+	wait_for_processing();
+
+	/* One request carrying the three readings instead of one request each */
+	TEST_ASSERT_EQUAL(0, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_obj_send_fake.call_count);
+	TEST_ASSERT_EQUAL(3, nrf_cloud_obj_bulk_add_fake.call_count);
+	TEST_ASSERT_EQUAL(1, nrf_cloud_obj_bulk_init_fake.call_count);
+}
+
 void test_storage_batch_no_items_should_not_update_shadow_network_info(void)
 {
 	struct storage_msg batch_available = {
@@ -1174,6 +1321,28 @@ void test_shadow_set_reported_should_call_patch(void)
 				      sizeof(test_cbor_payload));
 }
 
+/* The reported config section is only cleared at the first full report after boot */
+void test_shadow_set_reported_again_should_call_patch_once(void)
+{
+	const uint8_t test_cbor_payload[] = {0xa3, 0x04, 0x03, 0x02, 0x01};
+	struct cloud_msg update_msg = {
+		.type = CLOUD_SHADOW_SET_REPORTED_CONFIG,
+		.payload = {
+			.buffer_data_len = sizeof(test_cbor_payload)
+		}
+	};
+
+	memcpy(update_msg.payload.buffer, test_cbor_payload, sizeof(test_cbor_payload));
+
+	test_should_transition_from_disconnected_to_connected_ready();
+
+	publish_and_assert(&cloud_chan, &update_msg);
+	wait_for_processing();
+
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_patch_fake.call_count);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(test_cbor_payload, nrf_cloud_coap_patch_fake.arg2_val,
+				      sizeof(test_cbor_payload));
+}
 
 /* Test that cloud module correctly handles LOCATION_CLOUD_REQUEST with cellular data */
 void test_location_cloud_request_cellular_data(void)
@@ -1214,7 +1383,7 @@ void test_location_cloud_request_cellular_data(void)
 		}
 	};
 
-	struct storage_msg storage_data_msg = {
+	struct storage_data_msg storage_data_msg = {
 		.type = STORAGE_DATA,
 		.data_type = STORAGE_TYPE_LOCATION,
 		.data_len = sizeof(location_msg)
@@ -1266,7 +1435,7 @@ void test_location_cloud_request_wifi_data(void)
 		}
 	};
 
-	struct storage_msg storage_data_msg = {
+	struct storage_data_msg storage_data_msg = {
 		.type = STORAGE_DATA,
 		.data_type = STORAGE_TYPE_LOCATION,
 		.data_len = sizeof(location_msg)
@@ -1331,7 +1500,7 @@ void test_location_cloud_request_combined_data(void)
 		}
 	};
 
-	struct storage_msg storage_data_msg = {
+	struct storage_data_msg storage_data_msg = {
 		.type = STORAGE_DATA,
 		.data_type = STORAGE_TYPE_LOCATION,
 		.data_len = sizeof(location_msg)
@@ -1375,7 +1544,7 @@ void test_location_cloud_request_wifi_data_partial_ap_list(void)
 	/* Prepare location cloud request with 2 Wi-Fi APs, which is less than
 	 * CONFIG_LOCATION_METHOD_WIFI_SCANNING_RESULTS_MAX_CNT.
 	 */
-	struct storage_msg storage_data_msg = {
+	struct storage_data_msg storage_data_msg = {
 		.type = STORAGE_DATA,
 		.data_type = STORAGE_TYPE_LOCATION,
 		.data_len = sizeof(struct location_msg)
@@ -1450,7 +1619,7 @@ void test_location_cloud_request_wifi_data_excessive_ap_count(void)
 	location_msg.cloud_request.wifi_aps[0].mac[5] = 0xFF;
 	location_msg.cloud_request.wifi_aps[0].mac_length = 6;
 
-	struct storage_msg storage_data_msg = {
+	struct storage_data_msg storage_data_msg = {
 		.type = STORAGE_DATA,
 		.data_type = STORAGE_TYPE_LOCATION,
 		.data_len = sizeof(location_msg)
@@ -1539,7 +1708,7 @@ void test_location_cloud_request_gci_cells_only(void)
 		}
 	};
 
-	struct storage_msg storage_data_msg = {
+	struct storage_data_msg storage_data_msg = {
 		.type = STORAGE_DATA,
 		.data_type = STORAGE_TYPE_LOCATION,
 		.data_len = sizeof(location_msg)
@@ -1614,7 +1783,7 @@ void test_location_cloud_request_neighbor_and_gci_cells(void)
 		}
 	};
 
-	struct storage_msg storage_data_msg = {
+	struct storage_data_msg storage_data_msg = {
 		.type = STORAGE_DATA,
 		.data_type = STORAGE_TYPE_LOCATION,
 		.data_len = sizeof(location_msg)
@@ -1780,6 +1949,49 @@ void test_agnss_request_cached_while_disconnected_and_sent_on_connect(void)
 	TEST_ASSERT_EQUAL(1, location_agnss_data_process_fake.call_count);
 }
 
+static size_t agnss_buf_sz;
+
+static int nrf_cloud_coap_agnss_data_get_custom(struct nrf_cloud_coap_agnss_request const *request,
+						struct nrf_cloud_coap_agnss_result *result)
+{
+	ARG_UNUSED(request);
+
+	agnss_buf_sz = (result->buf != NULL) ? result->buf_sz : 0;
+	result->agnss_sz = 16;
+
+	return 0;
+}
+
+void test_agnss_request_downloaded_into_configured_buffer(void)
+{
+	struct location_msg agnss_msg = {
+		.type = LOCATION_AGNSS_REQUEST,
+		.agnss_request = {
+			.data_flags = 0x3f,
+			.system_count = 1,
+			.system = {
+				[0] = {
+					.system_id = 1, /* GPS */
+					.sv_mask_ephe = 0xffffffff,
+				},
+			},
+		},
+	};
+
+	agnss_buf_sz = 0;
+	nrf_cloud_coap_agnss_data_get_fake.custom_fake = nrf_cloud_coap_agnss_data_get_custom;
+
+	connect_cloud();
+
+	publish_and_assert(&location_chan, &agnss_msg);
+	wait_for_processing();
+
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_agnss_data_get_fake.call_count);
+	TEST_ASSERT_EQUAL(CONFIG_APP_CLOUD_AGNSS_BUF_SIZE, agnss_buf_sz);
+	TEST_ASSERT_EQUAL(1, location_agnss_data_process_fake.call_count);
+	TEST_ASSERT_EQUAL(16, location_agnss_data_process_fake.arg1_val);
+}
+
 /* Verify STORAGE_BATCH_CONSUME is published to storage_chan after each successful send */
 void test_batch_consume_sent_after_successful_send(void)
 {
@@ -1887,12 +2099,376 @@ void test_batch_network_error_aborts_loop(void)
 	/* No items were successfully delivered, so shadow network info should not be updated */
 	TEST_ASSERT_EQUAL(0, nrf_cloud_coap_shadow_network_info_update_fake.call_count);
 
-	/* Loop should have aborted after the failure, only one send should have been attempted */
-	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_sensor_send_fake.call_count);
+	/* Loop should have aborted after the failure, only the first item should have been
+	 * attempted, once plus CONFIG_APP_CLOUD_SEND_RETRIES retries.
+	 */
+	TEST_ASSERT_EQUAL(1 + CONFIG_APP_CLOUD_SEND_RETRIES,
+			  nrf_cloud_coap_sensor_send_fake.call_count);
 	/* Verify it was the first item (87.5%) — memcmp avoids Unity double support requirement */
-	TEST_ASSERT_EQUAL_MEMORY(&expected_pct,
-				 &nrf_cloud_coap_sensor_send_fake.arg1_history[0],
+	for (int i = 0; i < nrf_cloud_coap_sensor_send_fake.call_count; i++) {
+		TEST_ASSERT_EQUAL_MEMORY(&expected_pct,
+					 &nrf_cloud_coap_sensor_send_fake.arg1_history[i],
+					 sizeof(double));
+	}
+}
+
+/* Custom fake for nrf_cloud_coap_sensor_send that fails with -EIO on the first call only */
+static int nrf_cloud_coap_sensor_send_eio_first_custom_fake(const char *app_id, double value,
+							    int64_t ts, bool confirmable)
+{
+	ARG_UNUSED(app_id);
+	ARG_UNUSED(value);
+	ARG_UNUSED(ts);
+	ARG_UNUSED(confirmable);
+
+	return (nrf_cloud_coap_sensor_send_fake.call_count == 1) ? -EIO : 0;
+}
+
+/* Verify that a transient network error is retried for the same item and that the batch
+ * loop continues with the next item once the retry succeeds.
+ */
+void test_batch_network_error_retried_then_continues(void)
+{
+	struct storage_msg batch_available = {
+		.type = STORAGE_BATCH_AVAILABLE,
+		.data_len = 2,
+		.session_id = 0xC0FFEE01,
+	};
+	double first_pct = 87.5;
+
+	connect_cloud();
+
+	fake_mode = FAKE_BATCH_TWO_BATTERY;
+	fake_read_calls = 0;
+	storage_batch_read_fake.custom_fake = storage_batch_read_custom;
+	nrf_cloud_coap_sensor_send_fake.custom_fake =
+		nrf_cloud_coap_sensor_send_eio_first_custom_fake;
+
+	publish_and_assert(&storage_chan, &batch_available);
+
+	/* Both items are consumed after they have been sent */
+	wait_for_consume(K_SECONDS(WAIT_TIMEOUT));
+	wait_for_consume(K_SECONDS(WAIT_TIMEOUT));
+
+	wait_for_storage_batch_close(K_SECONDS(WAIT_TIMEOUT));
+	TEST_ASSERT_EQUAL(batch_available.session_id, last_storage_msg.session_id);
+	TEST_ASSERT_EQUAL(0, k_sem_count_get(&storage_consume_sem));
+
+	/* Failed send + retry of the first item + send of the second item */
+	TEST_ASSERT_EQUAL(3, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL_MEMORY(&first_pct, &nrf_cloud_coap_sensor_send_fake.arg1_history[0],
 				 sizeof(double));
+	TEST_ASSERT_EQUAL_MEMORY(&first_pct, &nrf_cloud_coap_sensor_send_fake.arg1_history[1],
+				 sizeof(double));
+
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_shadow_network_info_update_fake.call_count);
+}
+
+/* Requests collected in the transaction window run together, the shadow poll first */
+void test_txn_window_coalesces_shadow_poll_and_batch(void)
+{
+	struct storage_msg batch_available = {
+		.type = STORAGE_BATCH_AVAILABLE,
+		.data_len = 1,
+		.session_id = 0x11223344,
+	};
+	struct cloud_msg delta_msg = {
+		.type = CLOUD_SHADOW_GET_DELTA,
+	};
+	int shadow_get_idx = -1;
+	int sensor_send_idx = -1;
+
+	nrf_cloud_coap_shadow_get_fake.custom_fake = nrf_cloud_coap_shadow_get_empty_fake;
+
+	connect_cloud();
+	FFF_RESET_HISTORY();
+
+	fake_mode = FAKE_BATCH_BATTERY;
+	fake_read_calls = 0;
+	storage_batch_read_fake.custom_fake = storage_batch_read_custom;
+
+	/* The batch arrives first, the shadow poll right after it */
+	publish_and_assert(&storage_chan, &batch_available);
+	publish_and_assert(&cloud_chan, &delta_msg);
+
+	/* Nothing is sent before the window expires */
+	TEST_ASSERT_EQUAL(0, nrf_cloud_coap_shadow_get_fake.call_count);
+	TEST_ASSERT_EQUAL(0, nrf_cloud_coap_sensor_send_fake.call_count);
+
+	wait_for_processing();
+
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_shadow_get_fake.call_count);
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_sensor_send_fake.call_count);
+
+	for (int i = 0; i < MIN(fff.call_history_idx, FFF_CALL_HISTORY_LEN); i++) {
+		if ((fff.call_history[i] == (void *)nrf_cloud_coap_shadow_get) &&
+		    (shadow_get_idx < 0)) {
+			shadow_get_idx = i;
+		} else if ((fff.call_history[i] == (void *)nrf_cloud_coap_sensor_send) &&
+			   (sensor_send_idx < 0)) {
+			sensor_send_idx = i;
+		}
+	}
+
+	TEST_ASSERT_GREATER_OR_EQUAL(0, shadow_get_idx);
+	TEST_ASSERT_GREATER_THAN(shadow_get_idx, sensor_send_idx);
+}
+
+static void publish_network_quality(int16_t rsrp_idx)
+{
+	struct network_msg msg = {
+		.type = NETWORK_QUALITY_SAMPLE_RESPONSE,
+		.conn_eval_params.rsrp = rsrp_idx,
+	};
+
+	publish_and_assert(&network_chan, &msg);
+}
+
+static void send_battery_batch(void)
+{
+	struct storage_msg batch_available = {
+		.type = STORAGE_BATCH_AVAILABLE,
+		.data_len = 1,
+		.session_id = 0xAABBCCDD,
+	};
+
+	fake_mode = FAKE_BATCH_BATTERY;
+	fake_read_calls = 0;
+	storage_batch_read_fake.custom_fake = storage_batch_read_custom;
+
+	publish_and_assert(&storage_chan, &batch_available);
+	wait_for_processing();
+}
+
+/* Empty deltas double the number of poll triggers until the next delta poll */
+void test_shadow_delta_poll_backs_off_while_empty(void)
+{
+	struct cloud_msg delta_msg = {
+		.type = CLOUD_SHADOW_GET_DELTA,
+	};
+
+	nrf_cloud_coap_shadow_get_fake.custom_fake = nrf_cloud_coap_shadow_get_empty_fake;
+
+	connect_cloud();
+
+	/* Polled at triggers 1, 3 and 7 */
+	for (int i = 0; i < 8; i++) {
+		publish_and_assert(&cloud_chan, &delta_msg);
+		wait_for_processing();
+	}
+
+	TEST_ASSERT_EQUAL(3, nrf_cloud_coap_shadow_get_fake.call_count);
+
+	/* Never more than CONFIG_APP_CLOUD_SHADOW_POLL_MAX_INTERVAL triggers apart */
+	for (int i = 0; i < CONFIG_APP_CLOUD_SHADOW_POLL_MAX_INTERVAL; i++) {
+		publish_and_assert(&cloud_chan, &delta_msg);
+		wait_for_processing();
+	}
+
+	TEST_ASSERT_EQUAL(4, nrf_cloud_coap_shadow_get_fake.call_count);
+}
+
+/* Network info is only sent again when it changed since the last update */
+void test_network_info_update_skipped_when_unchanged(void)
+{
+	connect_cloud();
+
+	send_battery_batch();
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_shadow_network_info_update_fake.call_count);
+
+	send_battery_batch();
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_shadow_network_info_update_fake.call_count);
+
+	/* Moving to another cell triggers an update */
+	fake_cell_id = "0012CAFE";
+
+	send_battery_batch();
+	TEST_ASSERT_EQUAL(2, nrf_cloud_coap_shadow_network_info_update_fake.call_count);
+}
+
+/* A failed update is retried after the next batch */
+void test_network_info_update_retried_after_error(void)
+{
+	connect_cloud();
+
+	nrf_cloud_coap_shadow_network_info_update_fake.return_val = -EIO;
+
+	send_battery_batch();
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_shadow_network_info_update_fake.call_count);
+
+	nrf_cloud_coap_shadow_network_info_update_fake.return_val = 0;
+
+	send_battery_batch();
+	TEST_ASSERT_EQUAL(2, nrf_cloud_coap_shadow_network_info_update_fake.call_count);
+}
+
+/* Start from a good link: strong RSRP and only acknowledged confirmable sends */
+static void set_good_link(void)
+{
+	publish_network_quality(60);
+
+	for (int i = 0; i < 16; i++) {
+		cloud_policy_send_result(true, 0);
+	}
+}
+
+void test_routine_data_non_confirmable_on_good_link_with_probe(void)
+{
+	size_t confirmable_count = 0;
+
+	connect_cloud();
+	set_good_link();
+
+	for (int i = 0; i < CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE_PROBE_INTERVAL; i++) {
+		send_battery_batch();
+	}
+
+	TEST_ASSERT_EQUAL(CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE_PROBE_INTERVAL,
+			  nrf_cloud_coap_sensor_send_fake.call_count);
+
+	for (int i = 0; i < CONFIG_APP_CLOUD_CONFIRMABLE_ADAPTIVE_PROBE_INTERVAL; i++) {
+		if (nrf_cloud_coap_sensor_send_fake.arg3_history[i]) {
+			confirmable_count++;
+		}
+	}
+
+	/* Only the probe message is confirmable */
+	TEST_ASSERT_EQUAL(1, confirmable_count);
+}
+
+void test_routine_data_confirmable_on_low_rsrp(void)
+{
+	connect_cloud();
+	set_good_link();
+
+	/* RSRP index 10 is -131 dBm, below the threshold */
+	publish_network_quality(10);
+
+	send_battery_batch();
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_TRUE(nrf_cloud_coap_sensor_send_fake.arg3_val);
+
+	set_good_link();
+}
+
+void test_routine_data_confirmable_on_low_ack_rate(void)
+{
+	connect_cloud();
+	set_good_link();
+
+	for (int i = 0; i < 8; i++) {
+		cloud_policy_send_result(true, -ETIMEDOUT);
+	}
+
+	send_battery_batch();
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_TRUE(nrf_cloud_coap_sensor_send_fake.arg3_val);
+
+	set_good_link();
+}
+
+/* A network loss saves the DTLS session and the session is resumed without a new handshake */
+void test_session_resumed_after_network_loss(void)
+{
+	struct network_msg network_msg = {
+		.type = NETWORK_CONNECTED
+	};
+	struct cloud_session_metrics before;
+	struct cloud_session_metrics after;
+
+	setup_cloud_paused();
+	TEST_ASSERT_GREATER_OR_EQUAL(1, nrf_cloud_coap_pause_fake.call_count);
+
+	cloud_session_metrics_get(&before);
+	nrf_cloud_coap_connect_fake.call_count = 0;
+	nrf_cloud_coap_resume_fake.call_count = 0;
+
+	publish_and_assert(&network_chan, &network_msg);
+	wait_for_cloud_connected(K_SECONDS(WAIT_TIMEOUT));
+
+	cloud_session_metrics_get(&after);
+
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_resume_fake.call_count);
+	TEST_ASSERT_EQUAL(0, nrf_cloud_coap_connect_fake.call_count);
+	TEST_ASSERT_EQUAL(before.resumed_connects + 1, after.resumed_connects);
+	TEST_ASSERT_EQUAL(before.full_connects, after.full_connects);
+}
+
+/* A session that cannot be resumed falls back to a full DTLS handshake */
+void test_session_resume_failure_falls_back_to_full_connect(void)
+{
+	struct network_msg network_msg = {
+		.type = NETWORK_CONNECTED
+	};
+	struct cloud_session_metrics before;
+	struct cloud_session_metrics after;
+
+	setup_cloud_paused();
+
+	cloud_session_metrics_get(&before);
+	nrf_cloud_coap_connect_fake.call_count = 0;
+	nrf_cloud_coap_resume_fake.return_val = -EIO;
+
+	publish_and_assert(&network_chan, &network_msg);
+	wait_for_cloud_connected(K_SECONDS(WAIT_TIMEOUT));
+
+	cloud_session_metrics_get(&after);
+
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_connect_fake.call_count);
+	TEST_ASSERT_EQUAL(before.resume_failures + 1, after.resume_failures);
+	TEST_ASSERT_EQUAL(before.full_connects + 1, after.full_connects);
+	TEST_ASSERT_EQUAL(before.resumed_connects, after.resumed_connects);
+}
+
+/* Application messages are counted with their payload size and round-trip time */
+void test_request_stats_count_json_message(void)
+{
+	struct cloud_msg msg = {
+		.type = CLOUD_PAYLOAD_JSON,
+		.payload.buffer = "{\"test\": 2}",
+		.payload.buffer_data_len = strnlen(msg.payload.buffer, sizeof(msg.payload.buffer)),
+	};
+	struct cloud_stats_entry before;
+	struct cloud_stats_entry after;
+
+	connect_cloud();
+
+	TEST_ASSERT_EQUAL(0, cloud_stats_get(CLOUD_STATS_MESSAGE, &before));
+
+	publish_and_assert(&cloud_chan, &msg);
+	wait_for_processing();
+
+	TEST_ASSERT_EQUAL(0, cloud_stats_get(CLOUD_STATS_MESSAGE, &after));
+	TEST_ASSERT_EQUAL(1, nrf_cloud_coap_json_message_send_fake.call_count);
+	TEST_ASSERT_EQUAL(before.requests + 1, after.requests);
+	TEST_ASSERT_EQUAL(before.failures, after.failures);
+	TEST_ASSERT_EQUAL(before.bytes + msg.payload.buffer_data_len, after.bytes);
+
+	/* Application messages are confirmable */
+	TEST_ASSERT_EQUAL(before.rtt_count + 1, after.rtt_count);
+}
+
+/* Failed sends are counted per request type, and have no round-trip time */
+void test_request_stats_count_failed_battery_send(void)
+{
+	struct cloud_stats_entry before;
+	struct cloud_stats_entry after;
+
+	connect_cloud();
+
+	TEST_ASSERT_EQUAL(0, cloud_stats_get(CLOUD_STATS_SENSOR, &before));
+
+	nrf_cloud_coap_sensor_send_fake.return_val = -EIO;
+	send_battery_batch();
+
+	TEST_ASSERT_EQUAL(0, cloud_stats_get(CLOUD_STATS_SENSOR, &after));
+	TEST_ASSERT_GREATER_OR_EQUAL(1, nrf_cloud_coap_sensor_send_fake.call_count);
+	TEST_ASSERT_EQUAL(before.requests + nrf_cloud_coap_sensor_send_fake.call_count,
+			  after.requests);
+	TEST_ASSERT_EQUAL(before.failures + nrf_cloud_coap_sensor_send_fake.call_count,
+			  after.failures);
+	TEST_ASSERT_EQUAL(before.rtt_count, after.rtt_count);
+	TEST_ASSERT_EQUAL(-EINVAL, cloud_stats_get(CLOUD_STATS_TYPE_COUNT, &after));
 }
 
 /* This is required to be added to each test. That is because unity's
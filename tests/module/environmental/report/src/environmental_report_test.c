@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "environmental_report.h"
+
+/* Used by environmental_report.c */
+LOG_MODULE_REGISTER(environmental, 4);
+
+/* Far enough apart that small changes stay below the rate of change alarm */
+#define SAMPLE_INTERVAL_MS	(10 * MSEC_PER_SEC * SEC_PER_MIN)
+
+static int64_t uptime_ms;
+static struct environmental_report report;
+
+static void sample_add(double temperature, double humidity, double pressure)
+{
+	struct environmental_msg sample = {
+		.type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE,
+		.temperature = temperature,
+		.humidity = humidity,
+		.pressure = pressure,
+		.timestamp = uptime_ms,
+	};
+
+	environmental_report_add(&sample, uptime_ms, &report);
+
+	uptime_ms += SAMPLE_INTERVAL_MS;
+}
+
+void setUp(void)
+{
+	environmental_report_reset();
+
+	/* Keep the samples of different tests apart in time */
+	uptime_ms += 24 * SAMPLE_INTERVAL_MS;
+	memset(&report, 0, sizeof(report));
+}
+
+void tearDown(void)
+{
+}
+
+void test_first_sample_reported(void)
+{
+	sample_add(20.0, 40.0, 100000.0);
+	TEST_ASSERT_TRUE(report.event);
+
+	sample_add(20.0, 40.0, 100000.0);
+	TEST_ASSERT_FALSE(report.event);
+}
+
+void test_absolute_deadband(void)
+{
+	/* 10 % of 5.0 C is below the absolute deadband of 1.0 C */
+	sample_add(5.0, 40.0, 100000.0);
+	TEST_ASSERT_TRUE(report.event);
+
+	sample_add(5.9, 40.0, 100000.0);
+	TEST_ASSERT_FALSE(report.event);
+
+	/* Compared with the last reported sample, not the previous one */
+	sample_add(6.1, 40.0, 100000.0);
+	TEST_ASSERT_TRUE(report.event);
+
+	sample_add(5.2, 40.0, 100000.0);
+	TEST_ASSERT_FALSE(report.event);
+}
+
+void test_relative_deadband(void)
+{
+	/* 10 % of 20.0 C is above the absolute deadband of 1.0 C */
+	sample_add(20.0, 40.0, 100000.0);
+	TEST_ASSERT_TRUE(report.event);
+
+	sample_add(21.5, 40.0, 100000.0);
+	TEST_ASSERT_FALSE(report.event);
+
+	/* 10 % of the pressure is above the absolute deadband of 500 Pa */
+	sample_add(20.0, 40.0, 105000.0);
+	TEST_ASSERT_FALSE(report.event);
+
+	sample_add(22.5, 40.0, 100000.0);
+	TEST_ASSERT_TRUE(report.event);
+
+	sample_add(22.5, 40.0, 88000.0);
+	TEST_ASSERT_TRUE(report.event);
+}
+
+void test_humidity_deadband(void)
+{
+	sample_add(20.0, 40.0, 100000.0);
+	TEST_ASSERT_TRUE(report.event);
+
+	sample_add(20.0, 44.0, 100000.0);
+	TEST_ASSERT_FALSE(report.event);
+
+	sample_add(20.0, 46.0, 100000.0);
+	TEST_ASSERT_TRUE(report.event);
+}
+
+void test_rate_alarm(void)
+{
+	sample_add(20.0, 40.0, 100000.0);
+	TEST_ASSERT_TRUE(report.event);
+
+	/* Within the deadband, but 1.5 C in one minute is above the rate limit of 1.0 C/min */
+	uptime_ms -= SAMPLE_INTERVAL_MS - (MSEC_PER_SEC * SEC_PER_MIN);
+
+	sample_add(21.5, 40.0, 100000.0);
+	TEST_ASSERT_TRUE(report.event);
+
+	/* The same change over ten minutes */
+	sample_add(20.0, 40.0, 100000.0);
+	TEST_ASSERT_FALSE(report.event);
+}
+
+void test_window_summary(void)
+{
+	sample_add(20.0, 40.0, 100000.0);
+	TEST_ASSERT_FALSE(report.summary_ready);
+
+	sample_add(21.0, 42.0, 100100.0);
+	TEST_ASSERT_FALSE(report.summary_ready);
+
+	sample_add(19.0, 38.0, 99900.0);
+	TEST_ASSERT_FALSE(report.summary_ready);
+
+	sample_add(22.0, 44.0, 100200.0);
+	TEST_ASSERT_TRUE(report.summary_ready);
+
+	TEST_ASSERT_EQUAL(ENVIRONMENTAL_SENSOR_SUMMARY, report.summary.type);
+	TEST_ASSERT_EQUAL(4, report.summary.sample_count);
+	TEST_ASSERT_TRUE(report.summary.timestamp == (uptime_ms - SAMPLE_INTERVAL_MS));
+
+	TEST_ASSERT_EQUAL_DOUBLE(20.5, report.summary.temperature);
+	TEST_ASSERT_EQUAL_DOUBLE(19.0, report.summary.temperature_range.min);
+	TEST_ASSERT_EQUAL_DOUBLE(22.0, report.summary.temperature_range.max);
+
+	TEST_ASSERT_EQUAL_DOUBLE(41.0, report.summary.humidity);
+	TEST_ASSERT_EQUAL_DOUBLE(38.0, report.summary.humidity_range.min);
+	TEST_ASSERT_EQUAL_DOUBLE(44.0, report.summary.humidity_range.max);
+
+	TEST_ASSERT_EQUAL_DOUBLE(100050.0, report.summary.pressure);
+	TEST_ASSERT_EQUAL_DOUBLE(99900.0, report.summary.pressure_range.min);
+	TEST_ASSERT_EQUAL_DOUBLE(100200.0, report.summary.pressure_range.max);
+
+	/* The next window starts over */
+	sample_add(30.0, 50.0, 101000.0);
+	TEST_ASSERT_FALSE(report.summary_ready);
+}
+
+void test_reset_discards_window(void)
+{
+	sample_add(20.0, 40.0, 100000.0);
+	sample_add(20.0, 40.0, 100000.0);
+
+	/* Changed to the low-power profile, without pressure */
+	environmental_report_reset();
+
+	sample_add(10.0, 40.0, NAN);
+	TEST_ASSERT_TRUE(report.event);
+	TEST_ASSERT_FALSE(report.summary_ready);
+
+	sample_add(10.0, 40.0, NAN);
+	sample_add(10.0, 40.0, NAN);
+	TEST_ASSERT_FALSE(report.summary_ready);
+
+	sample_add(10.0, 40.0, NAN);
+	TEST_ASSERT_TRUE(report.summary_ready);
+	TEST_ASSERT_EQUAL(4, report.summary.sample_count);
+	TEST_ASSERT_EQUAL_DOUBLE(10.0, report.summary.temperature);
+	TEST_ASSERT_EQUAL_DOUBLE(10.0, report.summary.temperature_range.max);
+	TEST_ASSERT_TRUE(isnan(report.summary.pressure));
+
+	/* Back to the full profile, the first sample with pressure is the new reference */
+	environmental_report_reset();
+
+	sample_add(10.0, 40.0, 100000.0);
+	TEST_ASSERT_TRUE(report.event);
+
+	for (int i = 0; i < 3; i++) {
+		sample_add(10.0, 40.0, 100000.0);
+	}
+
+	TEST_ASSERT_TRUE(report.summary_ready);
+	TEST_ASSERT_EQUAL_DOUBLE(100000.0, report.summary.pressure);
+}
+
+/* This is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
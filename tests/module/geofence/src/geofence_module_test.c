@@ -0,0 +1,605 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/zbus/zbus.h>
+#include <zcbor_encode.h>
+
+#include "geofence.h"
+#include "location.h"
+#include "cloud.h"
+#include "cbor_helper.h"
+
+LOG_MODULE_REGISTER(geofence_module_test, 4);
+
+#define METERS_PER_DEGREE	111194.93
+
+/* Circle zone with a radius of 200 m */
+#define CIRCLE_ID		1
+#define CIRCLE_RADIUS		200
+#define CIRCLE_LAT_UDEG		63421000
+#define CIRCLE_LON_UDEG		10437000
+#define CIRCLE_LAT		(CIRCLE_LAT_UDEG / 1000000.0)
+#define CIRCLE_LON		(CIRCLE_LON_UDEG / 1000000.0)
+
+/* U-shaped polygon zone, open to the north. The notch is 1 km long and about 450 m wide. */
+#define POLYGON_ID		2
+#define POLYGON_ARM_LAT		63.42
+#define POLYGON_ARM_LON		10.405
+#define POLYGON_NOTCH_LAT	63.42
+#define POLYGON_NOTCH_LON	10.415
+#define POLYGON_EAST_LON	10.43
+
+/* Meters per degree of longitude at the latitude of the polygon */
+#define POLYGON_METERS_PER_LON	(METERS_PER_DEGREE * 0.4475)
+
+#define EVENTS_MAX		8
+
+struct event {
+	int type;
+	uint32_t zone_id;
+	bool entered;
+};
+
+static struct event geofence_events[EVENTS_MAX];
+static size_t geofence_event_count;
+static struct event priority_events[EVENTS_MAX];
+static size_t priority_event_count;
+
+/* Increases with every fix, the store decision is looked up by fix timestamp */
+static int64_t fix_timestamp = 1000;
+
+static void geofence_test_cb(const struct zbus_channel *chan);
+static void priority_test_cb(const struct zbus_channel *chan);
+
+ZBUS_LISTENER_DEFINE(geofence_test_listener, geofence_test_cb);
+ZBUS_LISTENER_DEFINE(priority_test_listener, priority_test_cb);
+
+ZBUS_CHAN_DEFINE(location_chan,
+		 struct location_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_DEFINE(cloud_priority_chan,
+		 struct cloud_priority_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS(priority_test_listener),
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_ADD_OBS(geofence_chan, geofence_test_listener, 0);
+
+static void geofence_test_cb(const struct zbus_channel *chan)
+{
+	const struct geofence_msg *msg = zbus_chan_const_msg(chan);
+
+	if ((msg->type != GEOFENCE_ENTERED) && (msg->type != GEOFENCE_EXITED)) {
+		return;
+	}
+
+	TEST_ASSERT_LESS_THAN(EVENTS_MAX, geofence_event_count);
+
+	geofence_events[geofence_event_count++] = (struct event) {
+		.type = msg->type,
+		.zone_id = msg->transition.zone_id,
+		.entered = (msg->type == GEOFENCE_ENTERED),
+	};
+}
+
+static void priority_test_cb(const struct zbus_channel *chan)
+{
+	const struct cloud_priority_msg *msg = zbus_chan_const_msg(chan);
+
+	TEST_ASSERT_LESS_THAN(EVENTS_MAX, priority_event_count);
+
+	priority_events[priority_event_count++] = (struct event) {
+		.type = msg->type,
+		.zone_id = msg->geofence.zone_id,
+		.entered = msg->geofence.entered,
+	};
+}
+
+static void zones_publish(const struct geofence_zones *zones)
+{
+	struct geofence_msg msg = {
+		.type = GEOFENCE_ZONES_SET,
+		.zones = *zones,
+	};
+
+	TEST_ASSERT_EQUAL(0, zbus_chan_pub(&geofence_chan, &msg, K_SECONDS(1)));
+}
+
+static void report_publish(enum geofence_report_mode mode, uint32_t heartbeat_interval)
+{
+	struct geofence_msg msg = {
+		.type = GEOFENCE_REPORT_SET,
+		.report.mode = mode,
+		.report.heartbeat_interval = heartbeat_interval,
+	};
+
+	TEST_ASSERT_EQUAL(0, zbus_chan_pub(&geofence_chan, &msg, K_SECONDS(1)));
+}
+
+static void circle_add(struct geofence_zones *zones, uint32_t id, uint32_t radius)
+{
+	struct geofence_zone *zone = &zones->zones[zones->count++];
+
+	*zone = (struct geofence_zone) {
+		.id = id,
+		.radius = radius,
+		.point_count = 1,
+		.points[0] = { .lat = CIRCLE_LAT_UDEG, .lon = CIRCLE_LON_UDEG },
+	};
+}
+
+static void polygon_add(struct geofence_zones *zones)
+{
+	struct geofence_zone *zone = &zones->zones[zones->count++];
+
+	*zone = (struct geofence_zone) {
+		.id = POLYGON_ID,
+		.radius = 0,
+		.point_count = 8,
+		.points = {
+			{ .lat = 63400000, .lon = 10400000 },
+			{ .lat = 63430000, .lon = 10400000 },
+			{ .lat = 63430000, .lon = 10410000 },
+			{ .lat = 63410000, .lon = 10410000 },
+			{ .lat = 63410000, .lon = 10420000 },
+			{ .lat = 63430000, .lon = 10420000 },
+			{ .lat = 63430000, .lon = 10430000 },
+			{ .lat = 63400000, .lon = 10430000 },
+		},
+	};
+}
+
+static struct location_msg fix_publish(double lat, double lon, float accuracy)
+{
+	struct location_msg msg = {
+		.type = LOCATION_GNSS_DATA,
+		.gnss_data.latitude = lat,
+		.gnss_data.longitude = lon,
+		.gnss_data.accuracy = accuracy,
+		.timestamp = fix_timestamp++,
+	};
+
+	TEST_ASSERT_EQUAL(0, zbus_chan_pub(&location_chan, &msg, K_SECONDS(1)));
+
+	return msg;
+}
+
+/* Publish a fix the given distance north of the circle center */
+static struct location_msg circle_fix_publish(double meters)
+{
+	return fix_publish(CIRCLE_LAT + (meters / METERS_PER_DEGREE), CIRCLE_LON, 10.0f);
+}
+
+static void events_clear(void)
+{
+	geofence_event_count = 0;
+	priority_event_count = 0;
+}
+
+static void event_verify(size_t index, uint32_t zone_id, bool entered)
+{
+	TEST_ASSERT_EQUAL(entered ? GEOFENCE_ENTERED : GEOFENCE_EXITED,
+			  geofence_events[index].type);
+	TEST_ASSERT_EQUAL(zone_id, geofence_events[index].zone_id);
+
+	TEST_ASSERT_EQUAL(CLOUD_PRIORITY_GEOFENCE, priority_events[index].type);
+	TEST_ASSERT_EQUAL(zone_id, priority_events[index].zone_id);
+	TEST_ASSERT_EQUAL(entered, priority_events[index].entered);
+}
+
+void setUp(void)
+{
+	struct geofence_zones zones = { 0 };
+
+	/* Clear the zones and their state */
+	zones_publish(&zones);
+	report_publish(GEOFENCE_REPORT_ALL, 0);
+	events_clear();
+}
+
+void tearDown(void)
+{
+}
+
+void test_circle_enter_and_exit(void)
+{
+	struct geofence_zones zones = { 0 };
+
+	circle_add(&zones, CIRCLE_ID, CIRCLE_RADIUS);
+	zones_publish(&zones);
+
+	circle_fix_publish(1000.0);
+	TEST_ASSERT_EQUAL(0, geofence_event_count);
+
+	circle_fix_publish(0.0);
+	TEST_ASSERT_EQUAL(1, geofence_event_count);
+	event_verify(0, CIRCLE_ID, true);
+
+	circle_fix_publish(190.0);
+	circle_fix_publish(1000.0);
+	TEST_ASSERT_EQUAL(2, geofence_event_count);
+	TEST_ASSERT_EQUAL(2, priority_event_count);
+	event_verify(1, CIRCLE_ID, false);
+}
+
+void test_circle_hysteresis(void)
+{
+	struct geofence_zones zones = { 0 };
+
+	circle_add(&zones, CIRCLE_ID, CIRCLE_RADIUS);
+	zones_publish(&zones);
+
+	circle_fix_publish(0.0);
+	events_clear();
+
+	/* Outside by less than the hysteresis, still inside */
+	circle_fix_publish(215.0);
+	TEST_ASSERT_EQUAL(0, geofence_event_count);
+
+	/* Outside by more than the hysteresis */
+	circle_fix_publish(240.0);
+	TEST_ASSERT_EQUAL(1, geofence_event_count);
+	event_verify(0, CIRCLE_ID, false);
+
+	/* Within the hysteresis from outside, a zone is only entered from inside the border */
+	circle_fix_publish(215.0);
+	TEST_ASSERT_EQUAL(1, geofence_event_count);
+
+	circle_fix_publish(190.0);
+	TEST_ASSERT_EQUAL(2, geofence_event_count);
+	event_verify(1, CIRCLE_ID, true);
+}
+
+void test_polygon_ray_casting(void)
+{
+	struct geofence_zones zones = { 0 };
+
+	polygon_add(&zones);
+	zones_publish(&zones);
+
+	/* Inside the bounding box, but in the notch of the U */
+	fix_publish(POLYGON_NOTCH_LAT, POLYGON_NOTCH_LON, 10.0f);
+	TEST_ASSERT_EQUAL(0, geofence_event_count);
+
+	fix_publish(POLYGON_ARM_LAT, POLYGON_ARM_LON, 10.0f);
+	TEST_ASSERT_EQUAL(1, geofence_event_count);
+	event_verify(0, POLYGON_ID, true);
+
+	/* The notch is about 250 m from the closest edge */
+	fix_publish(POLYGON_NOTCH_LAT, POLYGON_NOTCH_LON, 10.0f);
+	TEST_ASSERT_EQUAL(2, geofence_event_count);
+	event_verify(1, POLYGON_ID, false);
+
+	/* Bottom of the U */
+	fix_publish(63.405, POLYGON_NOTCH_LON, 10.0f);
+	TEST_ASSERT_EQUAL(3, geofence_event_count);
+	event_verify(2, POLYGON_ID, true);
+}
+
+void test_polygon_hysteresis(void)
+{
+	struct geofence_zones zones = { 0 };
+
+	polygon_add(&zones);
+	zones_publish(&zones);
+
+	fix_publish(63.405, 10.425, 10.0f);
+	TEST_ASSERT_EQUAL(1, geofence_event_count);
+
+	/* 10 m east of the east edge, within the hysteresis */
+	fix_publish(63.405, POLYGON_EAST_LON + (10.0 / POLYGON_METERS_PER_LON), 10.0f);
+	TEST_ASSERT_EQUAL(1, geofence_event_count);
+
+	/* 100 m east of the east edge */
+	fix_publish(63.405, POLYGON_EAST_LON + (100.0 / POLYGON_METERS_PER_LON), 10.0f);
+	TEST_ASSERT_EQUAL(2, geofence_event_count);
+	event_verify(1, POLYGON_ID, false);
+}
+
+void test_inaccurate_fix_ignored(void)
+{
+	struct geofence_zones zones = { 0 };
+
+	circle_add(&zones, CIRCLE_ID, CIRCLE_RADIUS);
+	zones_publish(&zones);
+
+	fix_publish(CIRCLE_LAT, CIRCLE_LON, CONFIG_APP_GEOFENCE_MAX_ACCURACY_METERS + 1);
+	TEST_ASSERT_EQUAL(0, geofence_event_count);
+	TEST_ASSERT_EQUAL(0, priority_event_count);
+}
+
+void test_invalid_zone_ignored(void)
+{
+	struct geofence_zones zones = { 0 };
+
+	polygon_add(&zones);
+
+	/* A polygon needs at least three points */
+	zones.zones[0].point_count = 2;
+	zones_publish(&zones);
+
+	fix_publish(POLYGON_ARM_LAT, POLYGON_ARM_LON, 10.0f);
+	TEST_ASSERT_EQUAL(0, geofence_event_count);
+}
+
+void test_zones_set_keeps_state_of_unchanged_zones(void)
+{
+	struct geofence_zones zones = { 0 };
+
+	circle_add(&zones, CIRCLE_ID, CIRCLE_RADIUS);
+	zones_publish(&zones);
+
+	circle_fix_publish(0.0);
+	TEST_ASSERT_EQUAL(1, geofence_event_count);
+	events_clear();
+
+	/* The same zone at another index, with a new zone in front of it */
+	zones.count = 0;
+	polygon_add(&zones);
+	circle_add(&zones, CIRCLE_ID, CIRCLE_RADIUS);
+	zones_publish(&zones);
+
+	circle_fix_publish(0.0);
+	TEST_ASSERT_EQUAL(0, geofence_event_count);
+
+	/* A zone with the same ID but another shape starts outside */
+	zones.count = 0;
+	circle_add(&zones, CIRCLE_ID, CIRCLE_RADIUS + 100);
+	zones_publish(&zones);
+
+	circle_fix_publish(0.0);
+	TEST_ASSERT_EQUAL(1, geofence_event_count);
+	event_verify(0, CIRCLE_ID, true);
+}
+
+void test_report_all_stores_every_fix(void)
+{
+	struct geofence_zones zones = { 0 };
+	struct location_msg fix;
+
+	circle_add(&zones, CIRCLE_ID, CIRCLE_RADIUS);
+	zones_publish(&zones);
+
+	fix = circle_fix_publish(1000.0);
+	TEST_ASSERT_TRUE(geofence_location_store(&fix));
+
+	fix = circle_fix_publish(1000.0);
+	TEST_ASSERT_TRUE(geofence_location_store(&fix));
+}
+
+void test_report_events_stores_transitions_and_heartbeat(void)
+{
+	struct geofence_zones zones = { 0 };
+	struct location_msg fix;
+
+	circle_add(&zones, CIRCLE_ID, CIRCLE_RADIUS);
+	zones_publish(&zones);
+	report_publish(GEOFENCE_REPORT_EVENTS, 60);
+
+	/* Stored or not depending on the previous tests, starts the heartbeat interval */
+	fix = circle_fix_publish(1000.0);
+	(void)geofence_location_store(&fix);
+
+	fix = circle_fix_publish(1000.0);
+	TEST_ASSERT_FALSE(geofence_location_store(&fix));
+
+	fix = circle_fix_publish(0.0);
+	TEST_ASSERT_TRUE(geofence_location_store(&fix));
+
+	fix = circle_fix_publish(0.0);
+	TEST_ASSERT_FALSE(geofence_location_store(&fix));
+
+	k_sleep(K_SECONDS(60));
+
+	fix = circle_fix_publish(0.0);
+	TEST_ASSERT_TRUE(geofence_location_store(&fix));
+}
+
+void test_report_events_burst_of_fixes(void)
+{
+	struct geofence_zones zones = { 0 };
+	struct location_msg fixes[4];
+
+	circle_add(&zones, CIRCLE_ID, CIRCLE_RADIUS);
+	zones_publish(&zones);
+	report_publish(GEOFENCE_REPORT_EVENTS, 3600);
+
+	fixes[0] = circle_fix_publish(1000.0);
+	(void)geofence_location_store(&fixes[0]);
+
+	/* All fixes are evaluated before the storage module checks any of them */
+	fixes[0] = circle_fix_publish(0.0);
+	fixes[1] = circle_fix_publish(0.0);
+	fixes[2] = circle_fix_publish(1000.0);
+	fixes[3] = circle_fix_publish(1000.0);
+	TEST_ASSERT_EQUAL(2, geofence_event_count);
+
+	TEST_ASSERT_TRUE(geofence_location_store(&fixes[0]));
+	TEST_ASSERT_FALSE(geofence_location_store(&fixes[1]));
+	TEST_ASSERT_TRUE(geofence_location_store(&fixes[2]));
+	TEST_ASSERT_FALSE(geofence_location_store(&fixes[3]));
+}
+
+/* Zone as encoded in the shadow, points given as [lat, lon] pairs */
+struct test_zone {
+	uint32_t id;
+	uint32_t radius;
+	size_t point_count;
+	int32_t points[CONFIG_APP_GEOFENCE_MAX_POINTS + 1][2];
+};
+
+/* Encode {"config": {"sample_interval": 600, "geofences": [zones]}} */
+static size_t shadow_encode(uint8_t *buf, size_t size, const struct test_zone *zones,
+			    size_t zone_count)
+{
+	ZCBOR_STATE_E(state, 6, buf, size, 0);
+
+	TEST_ASSERT_TRUE(zcbor_map_start_encode(state, 1));
+	TEST_ASSERT_TRUE(zcbor_tstr_put_lit(state, "config"));
+	TEST_ASSERT_TRUE(zcbor_map_start_encode(state, 2));
+	TEST_ASSERT_TRUE(zcbor_tstr_put_lit(state, "sample_interval"));
+	TEST_ASSERT_TRUE(zcbor_uint32_put(state, 600));
+	TEST_ASSERT_TRUE(zcbor_tstr_put_lit(state, "geofences"));
+	TEST_ASSERT_TRUE(zcbor_list_start_encode(state, zone_count));
+
+	for (size_t i = 0; i < zone_count; i++) {
+		TEST_ASSERT_TRUE(zcbor_list_start_encode(state, 3));
+		TEST_ASSERT_TRUE(zcbor_uint32_put(state, zones[i].id));
+		TEST_ASSERT_TRUE(zcbor_uint32_put(state, zones[i].radius));
+		TEST_ASSERT_TRUE(zcbor_list_start_encode(state, zones[i].point_count));
+
+		for (size_t j = 0; j < zones[i].point_count; j++) {
+			TEST_ASSERT_TRUE(zcbor_list_start_encode(state, 2));
+			TEST_ASSERT_TRUE(zcbor_int32_put(state, zones[i].points[j][0]));
+			TEST_ASSERT_TRUE(zcbor_int32_put(state, zones[i].points[j][1]));
+			TEST_ASSERT_TRUE(zcbor_list_end_encode(state, 2));
+		}
+
+		TEST_ASSERT_TRUE(zcbor_list_end_encode(state, zones[i].point_count));
+		TEST_ASSERT_TRUE(zcbor_list_end_encode(state, 3));
+	}
+
+	TEST_ASSERT_TRUE(zcbor_list_end_encode(state, zone_count));
+	TEST_ASSERT_TRUE(zcbor_map_end_encode(state, 2));
+	TEST_ASSERT_TRUE(zcbor_map_end_encode(state, 1));
+
+	return state->payload - buf;
+}
+
+void test_shadow_decode_zones(void)
+{
+	uint8_t buf[256];
+	struct geofence_zones zones = { 0 };
+	const struct test_zone input[] = {
+		{ .id = 1, .radius = 200, .point_count = 1,
+		  .points = { { 63421000, 10437000 } } },
+		{ .id = 2, .radius = 0, .point_count = 3,
+		  .points = { { 63430000, -10390000 }, { 63430000, -10400000 },
+			      { 63420000, -10400000 } } },
+	};
+	size_t len = shadow_encode(buf, sizeof(buf), input, ARRAY_SIZE(input));
+
+	TEST_ASSERT_EQUAL(0, decode_shadow_geofences_from_cbor(buf, len, &zones));
+	TEST_ASSERT_EQUAL(2, zones.count);
+
+	TEST_ASSERT_EQUAL(1, zones.zones[0].id);
+	TEST_ASSERT_EQUAL(200, zones.zones[0].radius);
+	TEST_ASSERT_EQUAL(1, zones.zones[0].point_count);
+	TEST_ASSERT_EQUAL(63421000, zones.zones[0].points[0].lat);
+	TEST_ASSERT_EQUAL(10437000, zones.zones[0].points[0].lon);
+
+	TEST_ASSERT_EQUAL(2, zones.zones[1].id);
+	TEST_ASSERT_EQUAL(0, zones.zones[1].radius);
+	TEST_ASSERT_EQUAL(3, zones.zones[1].point_count);
+	TEST_ASSERT_EQUAL(-10390000, zones.zones[1].points[0].lon);
+	TEST_ASSERT_EQUAL(63420000, zones.zones[1].points[2].lat);
+}
+
+void test_shadow_decode_too_many_points(void)
+{
+	uint8_t buf[256];
+	struct geofence_zones zones = { 0 };
+	struct test_zone input[2] = {
+		{ .id = 1, .radius = 0, .point_count = CONFIG_APP_GEOFENCE_MAX_POINTS + 1 },
+		{ .id = 2, .radius = 100, .point_count = 1, .points = { { 1, 2 } } },
+	};
+	size_t len;
+
+	for (size_t i = 0; i < input[0].point_count; i++) {
+		input[0].points[i][0] = 63400000 + i;
+		input[0].points[i][1] = 10400000 + i;
+	}
+
+	len = shadow_encode(buf, sizeof(buf), input, ARRAY_SIZE(input));
+
+	/* The zone is returned without points, and the next zone is still decoded */
+	TEST_ASSERT_EQUAL(0, decode_shadow_geofences_from_cbor(buf, len, &zones));
+	TEST_ASSERT_EQUAL(2, zones.count);
+	TEST_ASSERT_EQUAL(1, zones.zones[0].id);
+	TEST_ASSERT_EQUAL(0, zones.zones[0].point_count);
+	TEST_ASSERT_EQUAL(2, zones.zones[1].id);
+	TEST_ASSERT_EQUAL(1, zones.zones[1].point_count);
+}
+
+void test_shadow_decode_too_many_zones(void)
+{
+	uint8_t buf[256];
+	struct geofence_zones zones = { 0 };
+	struct test_zone input[CONFIG_APP_GEOFENCE_MAX_ZONES + 1];
+	size_t len;
+
+	for (size_t i = 0; i < ARRAY_SIZE(input); i++) {
+		input[i] = (struct test_zone) {
+			.id = i + 1, .radius = 100, .point_count = 1, .points = { { 1, 2 } },
+		};
+	}
+
+	len = shadow_encode(buf, sizeof(buf), input, ARRAY_SIZE(input));
+
+	TEST_ASSERT_EQUAL(0, decode_shadow_geofences_from_cbor(buf, len, &zones));
+	TEST_ASSERT_EQUAL(CONFIG_APP_GEOFENCE_MAX_ZONES, zones.count);
+	TEST_ASSERT_EQUAL(CONFIG_APP_GEOFENCE_MAX_ZONES,
+			  zones.zones[CONFIG_APP_GEOFENCE_MAX_ZONES - 1].id);
+}
+
+void test_shadow_decode_no_geofences(void)
+{
+	uint8_t buf[64];
+	struct geofence_zones zones = { 0 };
+	size_t len;
+	ZCBOR_STATE_E(state, 2, buf, sizeof(buf), 0);
+
+	TEST_ASSERT_TRUE(zcbor_map_start_encode(state, 1));
+	TEST_ASSERT_TRUE(zcbor_tstr_put_lit(state, "config"));
+	TEST_ASSERT_TRUE(zcbor_map_start_encode(state, 1));
+	TEST_ASSERT_TRUE(zcbor_tstr_put_lit(state, "sample_interval"));
+	TEST_ASSERT_TRUE(zcbor_uint32_put(state, 600));
+	TEST_ASSERT_TRUE(zcbor_map_end_encode(state, 1));
+	TEST_ASSERT_TRUE(zcbor_map_end_encode(state, 1));
+
+	len = state->payload - buf;
+
+	TEST_ASSERT_EQUAL(-ENOENT, decode_shadow_geofences_from_cbor(buf, len, &zones));
+}
+
+void test_shadow_decode_malformed(void)
+{
+	uint8_t buf[256];
+	struct geofence_zones zones = { 0 };
+	const struct test_zone input[] = {
+		{ .id = 1, .radius = 200, .point_count = 1,
+		  .points = { { 63421000, 10437000 } } },
+	};
+	size_t len = shadow_encode(buf, sizeof(buf), input, ARRAY_SIZE(input));
+
+	/* Cut off in the middle of the zone */
+	TEST_ASSERT_EQUAL(-EFAULT, decode_shadow_geofences_from_cbor(buf, len - 8, &zones));
+	TEST_ASSERT_EQUAL(-EINVAL, decode_shadow_geofences_from_cbor(buf, 0, &zones));
+}
+
+/* This is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "location_gnss_filter.h"
+
+/* Used by location_gnss_filter.c */
+LOG_MODULE_REGISTER(location_module, 4);
+
+/* About 111 meters per 0.001 degrees of latitude */
+#define LATITUDE			63.421
+#define LONGITUDE			10.437
+#define DEGREES_PER_KM			0.009
+
+static struct location_data fix_get(double latitude, float accuracy, uint8_t satellites,
+				    float hdop)
+{
+	struct location_data fix = {
+		.latitude = latitude,
+		.longitude = LONGITUDE,
+		.accuracy = accuracy,
+		.details.gnss.satellites_used = satellites,
+		.details.gnss.pvt_data.hdop = hdop,
+	};
+
+	return fix;
+}
+
+static struct location_data good_fix_get(double latitude)
+{
+	return fix_get(latitude, 10.0f, 6, 1.2f);
+}
+
+void setUp(void)
+{
+	struct location_data fix = good_fix_get(LATITUDE);
+
+	/* Start every test from an accepted reference fix at LATITUDE, an hour after the
+	 * reference of the previous test so that it is reachable.
+	 */
+	k_sleep(K_HOURS(1));
+	TEST_ASSERT_TRUE(location_gnss_filter_check(&fix));
+}
+
+void tearDown(void)
+{
+}
+
+void test_poor_fixes_dropped(void)
+{
+	struct location_data fix = fix_get(LATITUDE, 150.0f, 6, 1.2f);
+
+	TEST_ASSERT_FALSE(location_gnss_filter_check(&fix));
+
+	fix = fix_get(LATITUDE, 10.0f, 3, 1.2f);
+	TEST_ASSERT_FALSE(location_gnss_filter_check(&fix));
+
+	fix = fix_get(LATITUDE, 10.0f, 6, 5.5f);
+	TEST_ASSERT_FALSE(location_gnss_filter_check(&fix));
+
+	fix = fix_get(LATITUDE, 100.0f, 4, 5.0f);
+	TEST_ASSERT_TRUE(location_gnss_filter_check(&fix));
+}
+
+void test_plausible_movement_accepted(void)
+{
+	/* 1 km in one minute is 60 km/h */
+	struct location_data fix = good_fix_get(LATITUDE + DEGREES_PER_KM);
+
+	k_sleep(K_SECONDS(60));
+	TEST_ASSERT_TRUE(location_gnss_filter_check(&fix));
+}
+
+void test_jump_dropped_as_outlier(void)
+{
+	/* 10 km in one minute is 600 km/h */
+	struct location_data fix = good_fix_get(LATITUDE + (10 * DEGREES_PER_KM));
+
+	k_sleep(K_SECONDS(60));
+	TEST_ASSERT_FALSE(location_gnss_filter_check(&fix));
+
+	/* The reference is kept, a fix close to it is still accepted */
+	fix = good_fix_get(LATITUDE);
+	TEST_ASSERT_TRUE(location_gnss_filter_check(&fix));
+}
+
+void test_reference_reset_after_consecutive_outliers(void)
+{
+	struct location_data fix = good_fix_get(LATITUDE + (10 * DEGREES_PER_KM));
+
+	k_sleep(K_SECONDS(60));
+
+	for (int i = 0; i < CONFIG_APP_LOCATION_GNSS_FILTER_MAX_OUTLIERS; i++) {
+		TEST_ASSERT_FALSE(location_gnss_filter_check(&fix));
+	}
+
+	TEST_ASSERT_TRUE(location_gnss_filter_check(&fix));
+
+	/* The new position is now the reference */
+	TEST_ASSERT_TRUE(location_gnss_filter_check(&fix));
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <nrf_modem_gnss.h>
+
+#include "location_gnss_tracking.h"
+
+DEFINE_FFF_GLOBALS;
+
+/* Used by location_gnss_tracking.c */
+LOG_MODULE_REGISTER(location_module, 4);
+
+/* 2025-03-01 12:34:56.789 UTC */
+#define FIX_UNIX_TIME_MS		1740832496789LL
+
+FAKE_VALUE_FUNC(int32_t, nrf_modem_gnss_stop);
+FAKE_VALUE_FUNC(int32_t, nrf_modem_gnss_start);
+FAKE_VALUE_FUNC(int32_t, nrf_modem_gnss_event_handler_set, nrf_modem_gnss_event_handler_type_t);
+FAKE_VALUE_FUNC(int32_t, nrf_modem_gnss_use_case_set, uint8_t);
+FAKE_VALUE_FUNC(int32_t, nrf_modem_gnss_fix_interval_set, uint16_t);
+FAKE_VALUE_FUNC(int32_t, nrf_modem_gnss_read, void *, int32_t, int);
+FAKE_VOID_FUNC(tracking_handler, const struct location_gnss_tracking_evt *);
+
+/* Frame returned by the next nrf_modem_gnss_read() */
+static struct nrf_modem_gnss_pvt_data_frame next_pvt;
+
+/* The event is only valid during the call */
+static enum location_gnss_tracking_evt_type last_evt_type;
+
+static void tracking_handler_custom_fake(const struct location_gnss_tracking_evt *evt)
+{
+	last_evt_type = evt->type;
+}
+
+static int32_t nrf_modem_gnss_read_custom_fake(void *buf, int32_t buf_len, int type)
+{
+	TEST_ASSERT_EQUAL(NRF_MODEM_GNSS_DATA_PVT, type);
+	TEST_ASSERT_EQUAL(sizeof(next_pvt), buf_len);
+
+	memcpy(buf, &next_pvt, sizeof(next_pvt));
+
+	return 0;
+}
+
+static void pvt_set(double latitude)
+{
+	memset(&next_pvt, 0, sizeof(next_pvt));
+
+	next_pvt.latitude = latitude;
+	next_pvt.longitude = 10.437;
+	next_pvt.accuracy = 5.0f;
+	next_pvt.flags = NRF_MODEM_GNSS_PVT_FLAG_FIX_VALID;
+	next_pvt.datetime.year = 2025;
+	next_pvt.datetime.month = 3;
+	next_pvt.datetime.day = 1;
+	next_pvt.datetime.hour = 12;
+	next_pvt.datetime.minute = 34;
+	next_pvt.datetime.seconds = 56;
+	next_pvt.datetime.ms = 789;
+}
+
+/* Deliver a fix event to the event handler that the module registered */
+static void fix_event(double latitude)
+{
+	nrf_modem_gnss_event_handler_type_t handler =
+		nrf_modem_gnss_event_handler_set_fake.arg0_val;
+
+	pvt_set(latitude);
+	handler(NRF_MODEM_GNSS_EVT_FIX);
+}
+
+static size_t fixes_drain(void)
+{
+	struct location_data location;
+	int64_t uptime_ms;
+	int64_t timestamp_ms;
+	size_t count = 0;
+
+	while (location_gnss_tracking_get(&location, &uptime_ms, &timestamp_ms) == 0) {
+		count++;
+	}
+
+	return count;
+}
+
+void setUp(void)
+{
+	RESET_FAKE(nrf_modem_gnss_stop);
+	RESET_FAKE(nrf_modem_gnss_start);
+	RESET_FAKE(nrf_modem_gnss_event_handler_set);
+	RESET_FAKE(nrf_modem_gnss_use_case_set);
+	RESET_FAKE(nrf_modem_gnss_fix_interval_set);
+	RESET_FAKE(nrf_modem_gnss_read);
+	RESET_FAKE(tracking_handler);
+	FFF_RESET_HISTORY();
+
+	nrf_modem_gnss_read_fake.custom_fake = nrf_modem_gnss_read_custom_fake;
+	tracking_handler_fake.custom_fake = tracking_handler_custom_fake;
+
+	TEST_ASSERT_EQUAL(0, location_gnss_tracking_start(tracking_handler));
+
+	/* The buffer is kept between tests */
+	(void)fixes_drain();
+}
+
+void tearDown(void)
+{
+}
+
+void test_start_configures_periodic_navigation(void)
+{
+	TEST_ASSERT_EQUAL(1, nrf_modem_gnss_stop_fake.call_count);
+	TEST_ASSERT_EQUAL(NRF_MODEM_GNSS_USE_CASE_MULTIPLE_HOT_START,
+			  nrf_modem_gnss_use_case_set_fake.arg0_val);
+	TEST_ASSERT_EQUAL(CONFIG_APP_LOCATION_GNSS_TRACKING_INTERVAL_SECONDS,
+			  nrf_modem_gnss_fix_interval_set_fake.arg0_val);
+	TEST_ASSERT_EQUAL(1, nrf_modem_gnss_start_fake.call_count);
+}
+
+void test_start_error(void)
+{
+	nrf_modem_gnss_start_fake.return_val = -1;
+
+	TEST_ASSERT_EQUAL(-EIO, location_gnss_tracking_start(tracking_handler));
+}
+
+void test_empty_buffer(void)
+{
+	struct location_data location;
+	int64_t uptime_ms;
+	int64_t timestamp_ms;
+
+	TEST_ASSERT_EQUAL(-ENODATA,
+			  location_gnss_tracking_get(&location, &uptime_ms, &timestamp_ms));
+}
+
+void test_fix_conversion(void)
+{
+	struct location_data location;
+	int64_t uptime_ms;
+	int64_t timestamp_ms;
+	int64_t received_ms;
+
+	pvt_set(63.421);
+	next_pvt.hdop = 1.5f;
+	next_pvt.sv[0].sv = 1;
+	next_pvt.sv[0].flags = NRF_MODEM_GNSS_SV_FLAG_USED_IN_FIX;
+	next_pvt.sv[1].sv = 2;
+	next_pvt.sv[1].flags = NRF_MODEM_GNSS_SV_FLAG_USED_IN_FIX;
+	next_pvt.sv[2].sv = 3;
+
+	received_ms = k_uptime_get();
+	nrf_modem_gnss_event_handler_set_fake.arg0_val(NRF_MODEM_GNSS_EVT_FIX);
+
+	TEST_ASSERT_EQUAL(0, location_gnss_tracking_get(&location, &uptime_ms, &timestamp_ms));
+
+	TEST_ASSERT_TRUE(timestamp_ms == FIX_UNIX_TIME_MS);
+	TEST_ASSERT_TRUE(uptime_ms == received_ms);
+	TEST_ASSERT_EQUAL_DOUBLE(63.421, location.latitude);
+	TEST_ASSERT_EQUAL_DOUBLE(10.437, location.longitude);
+	TEST_ASSERT_TRUE(location.datetime.valid);
+	TEST_ASSERT_EQUAL(2025, location.datetime.year);
+	TEST_ASSERT_EQUAL(789, location.datetime.ms);
+	TEST_ASSERT_EQUAL(3, location.details.gnss.satellites_tracked);
+	TEST_ASSERT_EQUAL(2, location.details.gnss.satellites_used);
+	TEST_ASSERT_EQUAL_FLOAT(1.5f, location.details.gnss.pvt_data.hdop);
+}
+
+void test_invalid_fix_not_stored(void)
+{
+	nrf_modem_gnss_event_handler_type_t handler =
+		nrf_modem_gnss_event_handler_set_fake.arg0_val;
+
+	pvt_set(63.421);
+	next_pvt.flags = 0;
+	handler(NRF_MODEM_GNSS_EVT_FIX);
+
+	TEST_ASSERT_EQUAL(0, fixes_drain());
+}
+
+void test_buffer_full_event(void)
+{
+	for (int i = 0; i < CONFIG_APP_LOCATION_GNSS_TRACKING_BUFFER_SIZE - 1; i++) {
+		fix_event(63.0 + i);
+	}
+
+	TEST_ASSERT_EQUAL(0, tracking_handler_fake.call_count);
+
+	fix_event(64.0);
+
+	TEST_ASSERT_EQUAL(1, tracking_handler_fake.call_count);
+	TEST_ASSERT_EQUAL(LOCATION_GNSS_TRACKING_EVT_BUFFER_FULL, last_evt_type);
+	TEST_ASSERT_EQUAL(CONFIG_APP_LOCATION_GNSS_TRACKING_BUFFER_SIZE, fixes_drain());
+}
+
+void test_overflow_keeps_newest_fixes(void)
+{
+	struct location_data location;
+	int64_t uptime_ms;
+	int64_t timestamp_ms;
+	const int total = CONFIG_APP_LOCATION_GNSS_TRACKING_BUFFER_SIZE + 2;
+
+	for (int i = 0; i < total; i++) {
+		fix_event(60.0 + i);
+	}
+
+	/* The two oldest fixes were dropped, the rest are read oldest first */
+	for (int i = 2; i < total; i++) {
+		TEST_ASSERT_EQUAL(0, location_gnss_tracking_get(&location, &uptime_ms,
+								&timestamp_ms));
+		TEST_ASSERT_EQUAL_DOUBLE(60.0 + i, location.latitude);
+	}
+
+	TEST_ASSERT_EQUAL(-ENODATA,
+			  location_gnss_tracking_get(&location, &uptime_ms, &timestamp_ms));
+}
+
+/* This is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -14,6 +14,7 @@
 
 #include "app_common.h"
 #include "location.h"
+#include "location_helper.h"
 
 LOG_MODULE_REGISTER(location_module_test, LOG_LEVEL_DBG);
 
@@ -39,6 +40,7 @@ FAKE_VALUE_FUNC(int, date_time_set, const struct tm *);
 FAKE_VALUE_FUNC(int, date_time_now, int64_t *);
 FAKE_VALUE_FUNC(const char *, location_method_str, enum location_method);
 FAKE_VALUE_FUNC(int, lte_lc_func_mode_set, enum lte_lc_func_mode);
+FAKE_VOID_FUNC(lte_lc_register_handler, lte_lc_evt_handler_t);
 FAKE_VOID_FUNC(location_config_defaults_set, struct location_config *,
 	       uint8_t, enum location_method *);
 
@@ -258,23 +260,14 @@ static void verify_gnss_location_data(const struct location_data *expected_locat
 	TEST_ASSERT_EQUAL_DOUBLE(expected_location->latitude, received_msg.gnss_data.latitude);
 	TEST_ASSERT_EQUAL_DOUBLE(expected_location->longitude, received_msg.gnss_data.longitude);
 	TEST_ASSERT_EQUAL_DOUBLE(expected_location->accuracy, received_msg.gnss_data.accuracy);
-	TEST_ASSERT_EQUAL(expected_location->datetime.valid, received_msg.gnss_data.datetime.valid);
-
-	if (expected_location->datetime.valid) {
-		TEST_ASSERT_EQUAL(expected_location->datetime.year,
-				  received_msg.gnss_data.datetime.year);
-		TEST_ASSERT_EQUAL(expected_location->datetime.month,
-				  received_msg.gnss_data.datetime.month);
-		TEST_ASSERT_EQUAL(expected_location->datetime.day,
-				  received_msg.gnss_data.datetime.day);
-		TEST_ASSERT_EQUAL(expected_location->datetime.hour,
-				  received_msg.gnss_data.datetime.hour);
-		TEST_ASSERT_EQUAL(expected_location->datetime.minute,
-				  received_msg.gnss_data.datetime.minute);
-		TEST_ASSERT_EQUAL(expected_location->datetime.second,
-				  received_msg.gnss_data.datetime.second);
-		TEST_ASSERT_EQUAL(expected_location->datetime.ms,
-				  received_msg.gnss_data.datetime.ms);
+
+	/* Only the compact fix is published, altitude is taken from a valid PVT fix */
+	if (expected_location->details.gnss.pvt_data.flags & NRF_MODEM_GNSS_PVT_FLAG_FIX_VALID) {
+		TEST_ASSERT_TRUE(received_msg.gnss_data.flags & LOCATION_GNSS_HAS_ALTITUDE);
+		TEST_ASSERT_EQUAL_FLOAT(expected_location->details.gnss.pvt_data.altitude,
+					received_msg.gnss_data.altitude);
+	} else {
+		TEST_ASSERT_EQUAL(0, received_msg.gnss_data.flags);
 	}
 
 	err = zbus_sub_wait_msg(&test_subscriber, &chan, &received_msg, K_MSEC(100));
@@ -298,6 +291,44 @@ static void simulate_location_cancelled(void)
 	simulate_location_event(&cancelled_event);
 }
 
+/* Helper function to simulate a serving cell update from the LTE link controller.
+ * The handler is registered once when the module starts, so the fake is never reset.
+ */
+static void simulate_cell_update(uint32_t cell_id, uint32_t tac)
+{
+	struct lte_lc_evt evt = {
+		.type = LTE_LC_EVT_CELL_UPDATE,
+		.cell.id = cell_id,
+		.cell.tac = tac,
+	};
+
+	TEST_ASSERT_NOT_NULL(lte_lc_register_handler_fake.arg0_val);
+
+	lte_lc_register_handler_fake.arg0_val(&evt);
+	wait_for_processing();
+}
+
+/* Helper function to get a GNSS fix into the location cache */
+static void cache_gnss_fix(const struct location_data *fix)
+{
+	struct location_event_data event = {
+		.id = LOCATION_EVT_LOCATION,
+		.method = LOCATION_METHOD_GNSS,
+		.location = *fix
+	};
+
+	simulate_location_event(&event);
+	verify_gnss_location_data(fix);
+	wait_for_processing();
+}
+
+/* Helper function to leave the cache empty and the serving cell unknown for later tests */
+static void location_cache_clear(void)
+{
+	simulate_cell_update(LTE_LC_CELL_EUTRAN_ID_INVALID, 0);
+	publish_and_consume_message(LOCATION_MOTION_DETECTED);
+}
+
 void setUp(void)
 {
 	/* Reset all fakes */
@@ -1483,6 +1514,24 @@ void test_gnss_fix_trigger(void)
 	TEST_ASSERT_NOT_NULL(location_request_fake.arg0_val);
 }
 
+/* Test cellular location trigger handling from inactive state */
+void test_cellular_location_trigger(void)
+{
+	struct location_msg msg = {
+		.type = LOCATION_CELLULAR_SEARCH_TRIGGER
+	};
+
+	zbus_chan_pub(&location_chan, &msg, K_NO_WAIT);
+	wait_for_processing();
+
+	/* Verify location_config_defaults_set was called with cellular as the only method */
+	TEST_ASSERT_EQUAL(1, location_config_defaults_set_fake.call_count);
+	TEST_ASSERT_EQUAL(1, location_config_defaults_set_fake.arg1_val);
+
+	TEST_ASSERT_EQUAL(1, location_request_fake.call_count);
+	TEST_ASSERT_NOT_NULL(location_request_fake.arg0_val);
+}
+
 /* Test GNSS fix trigger is ignored while a search is already active */
 void test_gnss_fix_trigger_while_active(void)
 {
@@ -1567,6 +1616,209 @@ void test_gnss_fix_trigger_then_normal_trigger(void)
 	TEST_ASSERT_NULL(location_request_fake.arg0_val);
 }
 
+/* Test that the cached GNSS fix is reused while the serving cell stays the same */
+void test_cached_fix_reused_in_same_cell(void)
+{
+	struct location_data fix = {
+		.latitude = 63.421,
+		.longitude = 10.437,
+		.accuracy = 5.0,
+	};
+	struct location_msg received_msg;
+
+	simulate_cell_update(0x12345, 100);
+	cache_gnss_fix(&fix);
+
+	publish_and_consume_message(LOCATION_SEARCH_TRIGGER);
+
+	wait_for_message(LOCATION_GNSS_DATA, &received_msg);
+	TEST_ASSERT_TRUE(received_msg.cached);
+	TEST_ASSERT_EQUAL_DOUBLE(fix.latitude, received_msg.gnss_data.latitude);
+	TEST_ASSERT_EQUAL_DOUBLE(fix.longitude, received_msg.gnss_data.longitude);
+	verify_search_done_follows();
+
+	/* No search was started and the cached fix was not stored again */
+	TEST_ASSERT_EQUAL(0, location_request_fake.call_count);
+
+	location_cache_clear();
+}
+
+/* Test that a new location search is started after the serving cell changed */
+void test_cached_fix_dropped_on_cell_change(void)
+{
+	struct location_data fix = {
+		.latitude = 63.421,
+		.longitude = 10.437,
+		.accuracy = 5.0,
+	};
+
+	simulate_cell_update(0x12345, 100);
+	cache_gnss_fix(&fix);
+	simulate_cell_update(0x12346, 100);
+
+	publish_and_consume_message(LOCATION_SEARCH_TRIGGER);
+
+	TEST_ASSERT_EQUAL(1, location_request_fake.call_count);
+
+	location_cache_clear();
+}
+
+/* Test that a new location search is started after motion was detected */
+void test_cached_fix_dropped_on_motion(void)
+{
+	struct location_data fix = {
+		.latitude = 63.421,
+		.longitude = 10.437,
+		.accuracy = 5.0,
+	};
+
+	simulate_cell_update(0x12345, 100);
+	cache_gnss_fix(&fix);
+
+	publish_and_consume_message(LOCATION_MOTION_DETECTED);
+	publish_and_consume_message(LOCATION_SEARCH_TRIGGER);
+
+	TEST_ASSERT_EQUAL(1, location_request_fake.call_count);
+
+	location_cache_clear();
+}
+
+/* Test that the last Wi-Fi scan is reused while the serving cell stays the same */
+void test_cached_wifi_scan_reused_in_same_cell(void)
+{
+	struct wifi_scan_result mock_wifi_aps[1] = {
+		{
+			.mac = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0x11},
+			.mac_length = 6,
+			.channel = 6,
+			.rssi = -50
+		}
+	};
+	struct wifi_scan_info mock_wifi_info = {
+		.ap_info = mock_wifi_aps,
+		.cnt = 1
+	};
+	struct location_event_data mock_event = {
+		.id = LOCATION_EVT_CLOUD_LOCATION_EXT_REQUEST,
+		.method = LOCATION_METHOD_WIFI,
+		.cloud_location_request = {
+			.wifi_data = &mock_wifi_info
+		}
+	};
+	struct location_msg received_msg;
+
+	simulate_cell_update(0x12345, 100);
+
+	/* First search scans for Wi-Fi access points */
+	publish_and_consume_message(LOCATION_SEARCH_TRIGGER);
+	simulate_location_event(&mock_event);
+	wait_for_processing();
+
+	wait_for_message(LOCATION_CLOUD_REQUEST, &received_msg);
+	TEST_ASSERT_FALSE(received_msg.cached);
+	consume_published_message(LOCATION_SEARCH_CANCEL);
+
+	simulate_location_cancelled();
+	wait_for_processing();
+	verify_search_done_follows();
+
+	/* Second search reuses the scan */
+	publish_and_consume_message(LOCATION_SEARCH_TRIGGER);
+
+	wait_for_message(LOCATION_CLOUD_REQUEST, &received_msg);
+	TEST_ASSERT_TRUE(received_msg.cached);
+	TEST_ASSERT_EQUAL(1, received_msg.cloud_request.wifi_cnt);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(mock_wifi_aps[0].mac,
+				     received_msg.cloud_request.wifi_aps[0].mac,
+				     mock_wifi_aps[0].mac_length);
+	verify_search_done_follows();
+
+	TEST_ASSERT_EQUAL(1, location_request_fake.call_count);
+
+	/* Motion drops the scan, so the next search scans again */
+	publish_and_consume_message(LOCATION_MOTION_DETECTED);
+	publish_and_consume_message(LOCATION_SEARCH_TRIGGER);
+
+	TEST_ASSERT_EQUAL(2, location_request_fake.call_count);
+
+	location_cache_clear();
+}
+
+/* Test that Wi-Fi and cellular are moved next to each other for a combined cloud scan */
+void test_location_methods_combined(void)
+{
+	enum location_method wifi_first[] = {
+		LOCATION_METHOD_WIFI, LOCATION_METHOD_GNSS, LOCATION_METHOD_CELLULAR
+	};
+	enum location_method cellular_first[] = {
+		LOCATION_METHOD_CELLULAR, LOCATION_METHOD_GNSS, LOCATION_METHOD_WIFI
+	};
+	enum location_method adjacent[] = {
+		LOCATION_METHOD_GNSS, LOCATION_METHOD_WIFI, LOCATION_METHOD_CELLULAR
+	};
+	enum location_method cellular_only[] = {
+		LOCATION_METHOD_GNSS, LOCATION_METHOD_CELLULAR
+	};
+
+	location_methods_combine(wifi_first, ARRAY_SIZE(wifi_first));
+	TEST_ASSERT_EQUAL(LOCATION_METHOD_WIFI, wifi_first[0]);
+	TEST_ASSERT_EQUAL(LOCATION_METHOD_CELLULAR, wifi_first[1]);
+	TEST_ASSERT_EQUAL(LOCATION_METHOD_GNSS, wifi_first[2]);
+
+	location_methods_combine(cellular_first, ARRAY_SIZE(cellular_first));
+	TEST_ASSERT_EQUAL(LOCATION_METHOD_CELLULAR, cellular_first[0]);
+	TEST_ASSERT_EQUAL(LOCATION_METHOD_WIFI, cellular_first[1]);
+	TEST_ASSERT_EQUAL(LOCATION_METHOD_GNSS, cellular_first[2]);
+
+	location_methods_combine(adjacent, ARRAY_SIZE(adjacent));
+	TEST_ASSERT_EQUAL(LOCATION_METHOD_GNSS, adjacent[0]);
+	TEST_ASSERT_EQUAL(LOCATION_METHOD_WIFI, adjacent[1]);
+	TEST_ASSERT_EQUAL(LOCATION_METHOD_CELLULAR, adjacent[2]);
+
+	location_methods_combine(cellular_only, ARRAY_SIZE(cellular_only));
+	TEST_ASSERT_EQUAL(LOCATION_METHOD_GNSS, cellular_only[0]);
+	TEST_ASSERT_EQUAL(LOCATION_METHOD_CELLULAR, cellular_only[1]);
+}
+
+/* Test that only the valid PVT fields are published with a GNSS fix */
+void test_location_gnss_data_get(void)
+{
+	struct location_gnss_data gnss_data;
+	struct location_data location = {
+		.latitude = 63.421,
+		.longitude = 10.437,
+		.accuracy = 5.0,
+		.details.gnss.pvt_data = {
+			.flags = NRF_MODEM_GNSS_PVT_FLAG_FIX_VALID,
+			.altitude = 120.0,
+			.speed = 3.0,
+			.heading = 90.0,
+			.heading_accuracy = 10.0,
+		},
+	};
+
+	location_gnss_data_get(&gnss_data, &location);
+	TEST_ASSERT_EQUAL_DOUBLE(location.latitude, gnss_data.latitude);
+	TEST_ASSERT_EQUAL_DOUBLE(location.longitude, gnss_data.longitude);
+	TEST_ASSERT_EQUAL_FLOAT(location.accuracy, gnss_data.accuracy);
+	TEST_ASSERT_EQUAL_FLOAT(120.0, gnss_data.altitude);
+	TEST_ASSERT_EQUAL(LOCATION_GNSS_HAS_ALTITUDE | LOCATION_GNSS_HAS_HEADING, gnss_data.flags);
+
+	location.details.gnss.pvt_data.flags |= NRF_MODEM_GNSS_PVT_FLAG_VELOCITY_VALID;
+	location.details.gnss.pvt_data.heading_accuracy = 90.0;
+
+	location_gnss_data_get(&gnss_data, &location);
+	TEST_ASSERT_EQUAL_FLOAT(3.0, gnss_data.speed);
+	TEST_ASSERT_EQUAL(LOCATION_GNSS_HAS_ALTITUDE | LOCATION_GNSS_HAS_SPEED, gnss_data.flags);
+
+	/* Without a valid fix, only position and accuracy are published */
+	location.details.gnss.pvt_data.flags = 0;
+
+	location_gnss_data_get(&gnss_data, &location);
+	TEST_ASSERT_EQUAL_DOUBLE(location.latitude, gnss_data.latitude);
+	TEST_ASSERT_EQUAL(0, gnss_data.flags);
+}
+
 /* This is required to be added to each test. That is because unity's
  * main may return nonzero, while zephyr's main currently must
  * return 0 in all cases (other values are reserved).
@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <string.h>
+#include <zephyr/fff.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/task_wdt/task_wdt.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <date_time.h>
+
+#include "dk_buttons_and_leds.h"
+#include "app_common.h"
+#include "power.h"
+#include "network.h"
+#include "environmental.h"
+#include "cloud.h"
+#include "fota.h"
+#include "location.h"
+#include "led.h"
+#include "button.h"
+#include "storage.h"
+#include "motion.h"
+#include "checks.h"
+#include "cbor_helper.h"
+
+DEFINE_FFF_GLOBALS;
+
+FAKE_VALUE_FUNC(int, dk_buttons_init, button_handler_t);
+FAKE_VALUE_FUNC(int, task_wdt_feed, int);
+FAKE_VALUE_FUNC(int, task_wdt_add, uint32_t, task_wdt_callback_t, void *);
+FAKE_VOID_FUNC(sys_reboot, int);
+FAKE_VALUE_FUNC(int, settings_subsys_init);
+FAKE_VALUE_FUNC(int, settings_load_subtree_direct, const char *, settings_load_direct_cb, void *);
+FAKE_VALUE_FUNC(int, settings_save_one, const char *, const void *, size_t);
+FAKE_VALUE_FUNC(int, settings_delete, const char *);
+
+LOG_MODULE_REGISTER(main_config_persist_test, 4);
+
+/* Define the channels for testing */
+ZBUS_CHAN_DEFINE(power_chan,
+	struct power_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(button_chan,
+	struct button_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(network_chan,
+	struct network_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(.type = NETWORK_DISCONNECTED)
+);
+ZBUS_CHAN_DEFINE(cloud_chan,
+	struct cloud_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(.type = CLOUD_DISCONNECTED)
+);
+ZBUS_CHAN_DEFINE(environmental_chan,
+	struct environmental_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(fota_chan,
+	struct fota_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(location_chan,
+	struct location_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(led_chan,
+	struct led_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(storage_chan,
+	struct storage_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(motion_chan,
+	struct motion_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+
+/* Helper functions for sending messages */
+
+static void send_cloud_connected(void)
+{
+	struct cloud_msg cloud_msg = {
+		.type = CLOUD_CONNECTED,
+	};
+
+	int err = zbus_chan_pub(&cloud_chan, &cloud_msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_cloud_disconnected(void)
+{
+	struct cloud_msg cloud_msg = {
+		.type = CLOUD_DISCONNECTED,
+	};
+
+	int err = zbus_chan_pub(&cloud_chan, &cloud_msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_location_search_done(void)
+{
+	struct location_msg msg = {
+		.type = LOCATION_SEARCH_DONE,
+	};
+
+	int err = zbus_chan_pub(&location_chan, &msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_location_ready(void)
+{
+	struct location_msg msg = {
+		.type = LOCATION_MODULE_READY,
+	};
+
+	int err = zbus_chan_pub(&location_chan, &msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_power_ready(void)
+{
+	struct power_msg msg = {
+		.type = POWER_MODULE_READY,
+	};
+
+	int err = zbus_chan_pub(&power_chan, &msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_button_press_short(void)
+{
+	struct button_msg button_msg = {
+		.type = BUTTON_PRESS_SHORT,
+		.button_number = 1
+	};
+
+	int err = zbus_chan_pub(&button_chan, &button_msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_fota_msg(enum fota_msg_type msg_type)
+{
+	int err;
+	struct fota_msg msg = { .type = msg_type };
+
+	err = zbus_chan_pub(&fota_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	k_sleep(K_MSEC(100));
+}
+
+/* Connect to cloud and drop the messages of the initial shadow and FOTA synchronization */
+
+/* Publish a shadow response with the given parameters */
+static void send_shadow_response(enum cloud_msg_type type, const struct config_params *config)
+{
+	int err;
+	struct cloud_msg msg = { .type = type };
+	size_t encoded_len = 0;
+
+	err = encode_shadow_parameters_to_cbor(config, 0, 0, msg.response.buffer,
+					       sizeof(msg.response.buffer), &encoded_len);
+	if (err != 0) {
+		TEST_FAIL_MESSAGE("Failed to encode CBOR parameters");
+	}
+
+	msg.response.buffer_data_len = encoded_len;
+
+	err = zbus_chan_pub(&cloud_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+/* Connect to cloud and drop the messages of the initial shadow and FOTA synchronization */
+static void connect_to_cloud(void)
+{
+	send_cloud_connected();
+	expect_cloud_event(CLOUD_CONNECTED);
+
+	k_sleep(K_MSEC(500));
+	purge_all_events();
+}
+
+/* Restart the sampling timer by doing a immediate sample using a short button press */
+static void restart_sample_timer(void)
+{
+	send_button_press_short();
+	expect_location_event(LOCATION_SEARCH_TRIGGER);
+
+	send_location_search_done();
+	expect_location_event(LOCATION_SEARCH_DONE);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_REQUEST);
+}
+
+/* Configuration in flash, saved from the shadow before the reset of the test */
+static struct config_params flash_config = {
+	.sample_interval = 300,
+	.storage_threshold = 3,
+	.storage_threshold_valid = true,
+};
+
+static bool flash_config_valid = true;
+
+static ssize_t flash_read(void *cb_arg, void *data, size_t len)
+{
+	ARG_UNUSED(cb_arg);
+
+	memcpy(data, &flash_config, MIN(len, sizeof(flash_config)));
+
+	return MIN(len, sizeof(flash_config));
+}
+
+static int settings_load_subtree_direct_custom(const char *subtree, settings_load_direct_cb cb,
+					       void *param)
+{
+	TEST_ASSERT_EQUAL_STRING("att_main", subtree);
+
+	if (!flash_config_valid) {
+		return 0;
+	}
+
+	return cb("config", sizeof(flash_config), flash_read, NULL, param);
+}
+
+static int settings_save_one_custom(const char *name, const void *value, size_t val_len)
+{
+	TEST_ASSERT_EQUAL_STRING("att_main/config", name);
+	TEST_ASSERT_EQUAL(sizeof(flash_config), val_len);
+
+	memcpy(&flash_config, value, val_len);
+	flash_config_valid = true;
+
+	return 0;
+}
+
+static int settings_delete_custom(const char *name)
+{
+	TEST_ASSERT_EQUAL_STRING("att_main/config", name);
+
+	memset(&flash_config, 0, sizeof(flash_config));
+	flash_config_valid = false;
+
+	return 0;
+}
+
+void setUp(void)
+{
+	RESET_FAKE(dk_buttons_init);
+	RESET_FAKE(task_wdt_feed);
+	RESET_FAKE(task_wdt_add);
+	RESET_FAKE(sys_reboot);
+	RESET_FAKE(settings_subsys_init);
+	RESET_FAKE(settings_load_subtree_direct);
+	RESET_FAKE(settings_save_one);
+	RESET_FAKE(settings_delete);
+
+	settings_load_subtree_direct_fake.custom_fake = settings_load_subtree_direct_custom;
+	settings_save_one_fake.custom_fake = settings_save_one_custom;
+	settings_delete_fake.custom_fake = settings_delete_custom;
+
+	/* The saved configuration is loaded when the modules are ready in the first test */
+	send_location_ready();
+	send_power_ready();
+	send_fota_msg(FOTA_MODULE_READY);
+
+	send_cloud_disconnected();
+	k_sleep(K_MSEC(500));
+
+	/* Burn the current sampling cycle so that each test starts in STATE_DISCONNECTED_WAITING
+	 * with a known sample timer
+	 */
+	send_button_press_short();
+	send_location_search_done();
+	k_sleep(K_MSEC(100));
+
+	FFF_RESET_HISTORY();
+
+	purge_all_events();
+}
+
+/* Test functions */
+
+/* Runs first, as the configuration is only loaded at boot */
+void test_saved_config_applied_at_boot(void)
+{
+	TEST_ASSERT_EQUAL(1, settings_load_subtree_direct_fake.call_count);
+
+	/* Only the delta is fetched on the initial connection */
+	send_cloud_connected();
+	expect_cloud_event(CLOUD_CONNECTED);
+	expect_cloud_event(CLOUD_SHADOW_UPDATE_REPORTED_DEVICE);
+	expect_cloud_event(CLOUD_SHADOW_GET_DELTA);
+
+	k_sleep(K_MSEC(500));
+	purge_all_events();
+
+	/* Samples with the saved interval instead of the default of 600 seconds */
+	restart_sample_timer();
+
+	k_sleep(K_SECONDS(300));
+	expect_timer_event(TIMER_EXPIRED_SAMPLE_DATA);
+	expect_location_event(LOCATION_SEARCH_TRIGGER);
+}
+
+void test_delta_merged(void)
+{
+	struct config_params delta = {
+		.power_interval = 600,
+	};
+
+	connect_to_cloud();
+
+	send_shadow_response(CLOUD_SHADOW_RESPONSE_DELTA, &delta);
+	expect_cloud_event(CLOUD_SHADOW_RESPONSE_DELTA);
+	expect_cloud_event(CLOUD_SHADOW_UPDATE_REPORTED_CONFIG);
+
+	TEST_ASSERT_EQUAL(1, settings_save_one_fake.call_count);
+	TEST_ASSERT_EQUAL(300, flash_config.sample_interval);
+	TEST_ASSERT_EQUAL(600, flash_config.power_interval);
+	TEST_ASSERT_TRUE(flash_config.storage_threshold_valid);
+	TEST_ASSERT_EQUAL(3, flash_config.storage_threshold);
+}
+
+void test_unchanged_delta_not_saved(void)
+{
+	struct config_params delta = {
+		.sample_interval = 300,
+		.storage_threshold = 3,
+		.storage_threshold_valid = true,
+	};
+
+	connect_to_cloud();
+
+	send_shadow_response(CLOUD_SHADOW_RESPONSE_DELTA, &delta);
+	expect_cloud_event(CLOUD_SHADOW_RESPONSE_DELTA);
+	expect_cloud_event(CLOUD_SHADOW_UPDATE_REPORTED_CONFIG);
+
+	TEST_ASSERT_EQUAL(0, settings_save_one_fake.call_count);
+	TEST_ASSERT_EQUAL(0, settings_delete_fake.call_count);
+}
+
+void test_desired_replaces(void)
+{
+	struct config_params desired = {
+		.sample_interval = 120,
+	};
+
+	connect_to_cloud();
+
+	send_shadow_response(CLOUD_SHADOW_RESPONSE_DESIRED, &desired);
+	expect_cloud_event(CLOUD_SHADOW_RESPONSE_DESIRED);
+	expect_cloud_event(CLOUD_SHADOW_SET_REPORTED_CONFIG);
+
+	/* Parameters that are no longer in the desired section are dropped */
+	TEST_ASSERT_EQUAL(1, settings_save_one_fake.call_count);
+	TEST_ASSERT_EQUAL(120, flash_config.sample_interval);
+	TEST_ASSERT_EQUAL(0, flash_config.power_interval);
+	TEST_ASSERT_FALSE(flash_config.storage_threshold_valid);
+
+	/* The same desired section again is not written */
+	send_shadow_response(CLOUD_SHADOW_RESPONSE_DESIRED, &desired);
+	expect_cloud_event(CLOUD_SHADOW_RESPONSE_DESIRED);
+	expect_cloud_event(CLOUD_SHADOW_SET_REPORTED_CONFIG);
+
+	TEST_ASSERT_EQUAL(1, settings_save_one_fake.call_count);
+}
+
+void test_empty_desired_deletes(void)
+{
+	const struct config_params empty = {0};
+	const struct config_params delta = {
+		.power_interval = 900,
+	};
+
+	connect_to_cloud();
+
+	send_shadow_response(CLOUD_SHADOW_RESPONSE_EMPTY_DESIRED, &empty);
+	expect_cloud_event(CLOUD_SHADOW_RESPONSE_EMPTY_DESIRED);
+	expect_cloud_event(CLOUD_SHADOW_SET_REPORTED_CONFIG);
+
+	TEST_ASSERT_EQUAL(0, settings_save_one_fake.call_count);
+	TEST_ASSERT_EQUAL(1, settings_delete_fake.call_count);
+	TEST_ASSERT_FALSE(flash_config_valid);
+
+	/* Nothing left to delete */
+	send_shadow_response(CLOUD_SHADOW_RESPONSE_EMPTY_DESIRED, &empty);
+	expect_cloud_event(CLOUD_SHADOW_RESPONSE_EMPTY_DESIRED);
+	expect_cloud_event(CLOUD_SHADOW_SET_REPORTED_CONFIG);
+
+	TEST_ASSERT_EQUAL(1, settings_delete_fake.call_count);
+
+	/* A delta after the delete starts from an empty configuration */
+	send_shadow_response(CLOUD_SHADOW_RESPONSE_DELTA, &delta);
+	expect_cloud_event(CLOUD_SHADOW_RESPONSE_DELTA);
+	expect_cloud_event(CLOUD_SHADOW_UPDATE_REPORTED_CONFIG);
+
+	TEST_ASSERT_EQUAL(1, settings_save_one_fake.call_count);
+	TEST_ASSERT_EQUAL(0, flash_config.sample_interval);
+	TEST_ASSERT_EQUAL(900, flash_config.power_interval);
+}
+
+/* This is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	k_sleep(K_FOREVER);
+
+	return 0;
+}
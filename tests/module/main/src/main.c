@@ -21,6 +21,7 @@
 #include "led.h"
 #include "button.h"
 #include "storage.h"
+#include "motion.h"
 #include "checks.h"
 #include "cbor_helper.h"
 
@@ -100,6 +101,13 @@ ZBUS_CHAN_DEFINE(storage_chan,
 	ZBUS_OBSERVERS_EMPTY,
 	ZBUS_MSG_INIT(0)
 );
+ZBUS_CHAN_DEFINE(motion_chan,
+	struct motion_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
 
 /* Helper functions for sending messages */
 
@@ -158,6 +166,19 @@ static void send_power_ready(void)
 	TEST_ASSERT_EQUAL(0, err);
 }
 
+static void send_power_battery_sample(double percentage, bool charging)
+{
+	struct power_msg msg = {
+		.type = POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE,
+		.percentage = percentage,
+		.charging = charging,
+	};
+
+	int err = zbus_chan_pub(&power_chan, &msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
 static void send_button_press_short(void)
 {
 	struct button_msg button_msg = {
@@ -182,6 +203,16 @@ static void send_button_press_long(void)
 	TEST_ASSERT_EQUAL(0, err);
 }
 
+static void send_motion_detected(void)
+{
+	struct motion_msg msg = {
+		.type = MOTION_DETECTED,
+	};
+	int err = zbus_chan_pub(&motion_chan, &msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
 static void send_storage_threshold_reached(void)
 {
 	struct storage_msg storage_msg = {
@@ -263,6 +294,30 @@ static void config_change_all(uint32_t sample_interval, uint32_t storage_thresho
 	TEST_ASSERT_EQUAL(0, err);
 }
 
+static void config_change_power_interval(uint32_t sample_interval, uint32_t power_interval)
+{
+	int err;
+	struct cloud_msg msg = {
+		.type = CLOUD_SHADOW_RESPONSE_DELTA,
+	};
+	struct config_params config = {
+		.sample_interval = sample_interval,
+		.power_interval = power_interval,
+	};
+	size_t encoded_len = 0;
+
+	err = encode_shadow_parameters_to_cbor(&config, 0, 0, msg.response.buffer,
+					       sizeof(msg.response.buffer), &encoded_len);
+	if (err != 0) {
+		TEST_FAIL_MESSAGE("Failed to encode CBOR parameters");
+	}
+
+	msg.response.buffer_data_len = encoded_len;
+
+	err = zbus_chan_pub(&cloud_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+}
+
 /* Publish a shadow response with an empty CBOR payload. */
 static void send_shadow_response_empty_payload(enum cloud_msg_type type)
 {
@@ -574,6 +629,209 @@ void test_config_change(void)
 	expect_cloud_event(CLOUD_SHADOW_SET_REPORTED_CONFIG);
 }
 
+/* Battery sampling follows power_interval and shares the wake-up with location when due */
+void test_power_interval_from_shadow(void)
+{
+	connect_to_cloud();
+
+	restart_sample_timer();
+
+	config_change_power_interval(300, 600);
+	expect_cloud_event(CLOUD_SHADOW_RESPONSE_DELTA);
+	expect_cloud_event(CLOUD_SHADOW_UPDATE_REPORTED_CONFIG);
+	expect_timer_event(TIMER_CONFIG_CHANGED);
+
+	/* Only location is due after the sample interval */
+	k_sleep(K_SECONDS(300));
+	expect_timer_event(TIMER_EXPIRED_SAMPLE_DATA);
+	expect_location_event(LOCATION_SEARCH_TRIGGER);
+
+	send_location_search_done();
+	expect_location_event(LOCATION_SEARCH_DONE);
+	expect_no_events(100);
+
+	/* Location and battery are both due after the power interval */
+	k_sleep(K_SECONDS(300));
+	expect_timer_event(TIMER_EXPIRED_SAMPLE_DATA);
+	expect_location_event(LOCATION_SEARCH_TRIGGER);
+
+	send_location_search_done();
+	expect_location_event(LOCATION_SEARCH_DONE);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_REQUEST);
+}
+
+void test_motion_adapts_location_interval(void)
+{
+	connect_to_cloud();
+
+	restart_sample_timer();
+
+	/* Motion drops a cached fix and shortens the location interval */
+	send_motion_detected();
+	expect_location_event(LOCATION_MOTION_DETECTED);
+	expect_timer_event(TIMER_CONFIG_CHANGED);
+
+	k_sleep(K_SECONDS(60));
+	expect_timer_event(TIMER_EXPIRED_SAMPLE_DATA);
+	expect_location_event(LOCATION_SEARCH_TRIGGER);
+
+	send_location_search_done();
+	expect_location_event(LOCATION_SEARCH_DONE);
+
+	/* Motion was seen since the previous location sample, the interval is kept */
+	k_sleep(K_SECONDS(60));
+	expect_timer_event(TIMER_EXPIRED_SAMPLE_DATA);
+	expect_location_event(LOCATION_SEARCH_TRIGGER);
+
+	send_location_search_done();
+	expect_location_event(LOCATION_SEARCH_DONE);
+
+	/* No motion since the previous location sample, the interval is doubled */
+	expect_no_events(60);
+
+	k_sleep(K_SECONDS(60));
+	expect_timer_event(TIMER_EXPIRED_SAMPLE_DATA);
+	expect_location_event(LOCATION_SEARCH_TRIGGER);
+
+	send_location_search_done();
+	expect_location_event(LOCATION_SEARCH_DONE);
+}
+
+/* A critically low battery stretches sampling and uploads, uses cellular location only and
+ * defers FOTA until the battery is charging.
+ */
+void test_power_policy_critical_battery(void)
+{
+	connect_to_cloud();
+
+	restart_sample_timer();
+
+	send_power_battery_sample(5.0, false);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE);
+	expect_storage_event(STORAGE_SET_THRESHOLD);
+	expect_timer_event(TIMER_CONFIG_CHANGED);
+
+	/* Nothing is sampled at the configured interval */
+	expect_no_events(CONFIG_APP_SAMPLING_INTERVAL_SECONDS);
+
+	k_sleep(K_SECONDS(CONFIG_APP_POWER_POLICY_CRITICAL_SAMPLING_INTERVAL_SECONDS -
+			  CONFIG_APP_SAMPLING_INTERVAL_SECONDS));
+	expect_timer_event(TIMER_EXPIRED_SAMPLE_DATA);
+	expect_location_event(LOCATION_CELLULAR_SEARCH_TRIGGER);
+
+	send_location_search_done();
+	expect_location_event(LOCATION_SEARCH_DONE);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_REQUEST);
+
+	/* Data is sent without a FOTA poll */
+	send_button_press_long();
+	expect_storage_event(STORAGE_BATCH_REQUEST);
+	expect_cloud_event(CLOUD_SHADOW_GET_DELTA);
+	expect_no_events(1);
+
+	send_storage_batch_close();
+	expect_storage_event(STORAGE_BATCH_CLOSE);
+
+	/* Charging restores the normal profile, and the deferred FOTA poll is sent */
+	send_power_battery_sample(6.0, true);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE);
+	expect_storage_event(STORAGE_SET_THRESHOLD);
+	expect_fota_event(FOTA_POLL_REQUEST);
+	expect_timer_event(TIMER_CONFIG_CHANGED);
+
+	send_button_press_long();
+	expect_storage_event(STORAGE_BATCH_REQUEST);
+	expect_fota_event(FOTA_POLL_REQUEST);
+	expect_cloud_event(CLOUD_SHADOW_GET_DELTA);
+
+	send_storage_batch_close();
+	expect_storage_event(STORAGE_BATCH_CLOSE);
+}
+
+/* The low profile is only left when the battery is above the threshold by the hysteresis */
+void test_power_policy_hysteresis(void)
+{
+	send_power_battery_sample(25.0, false);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE);
+	expect_storage_event(STORAGE_SET_THRESHOLD);
+	expect_timer_event(TIMER_CONFIG_CHANGED);
+
+	send_power_battery_sample(32.0, false);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE);
+	expect_no_events(1);
+
+	send_power_battery_sample(36.0, false);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE);
+	expect_storage_event(STORAGE_SET_THRESHOLD);
+	expect_timer_event(TIMER_CONFIG_CHANGED);
+}
+
+/* A FOTA poll deferred by a low battery is sent as soon as the normal profile is used again,
+ * without waiting for the next poll trigger
+ */
+void test_power_policy_deferred_fota_poll(void)
+{
+	connect_to_cloud();
+
+	send_power_battery_sample(25.0, false);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE);
+	expect_storage_event(STORAGE_SET_THRESHOLD);
+	expect_timer_event(TIMER_CONFIG_CHANGED);
+
+	send_button_press_long();
+	expect_storage_event(STORAGE_BATCH_REQUEST);
+	expect_cloud_event(CLOUD_SHADOW_GET_DELTA);
+	expect_no_events(1);
+
+	send_storage_batch_close();
+	expect_storage_event(STORAGE_BATCH_CLOSE);
+
+	/* Still in the low profile, the poll stays deferred */
+	send_power_battery_sample(28.0, false);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE);
+	expect_no_events(1);
+
+	send_power_battery_sample(40.0, false);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE);
+	expect_storage_event(STORAGE_SET_THRESHOLD);
+	expect_fota_event(FOTA_POLL_REQUEST);
+	expect_timer_event(TIMER_CONFIG_CHANGED);
+
+	/* The poll is only sent once */
+	expect_no_events(1);
+}
+
+/* A poll deferred while disconnected is sent by the next connection, not by the profile
+ * change
+ */
+void test_power_policy_deferred_fota_poll_disconnected(void)
+{
+	connect_to_cloud();
+
+	send_power_battery_sample(25.0, false);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE);
+	expect_storage_event(STORAGE_SET_THRESHOLD);
+	expect_timer_event(TIMER_CONFIG_CHANGED);
+
+	send_button_press_long();
+	expect_storage_event(STORAGE_BATCH_REQUEST);
+	expect_cloud_event(CLOUD_SHADOW_GET_DELTA);
+
+	send_storage_batch_close();
+	expect_storage_event(STORAGE_BATCH_CLOSE);
+
+	send_cloud_disconnected();
+	expect_cloud_event(CLOUD_DISCONNECTED);
+
+	send_power_battery_sample(40.0, true);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE);
+	expect_storage_event(STORAGE_SET_THRESHOLD);
+	expect_timer_event(TIMER_CONFIG_CHANGED);
+	expect_no_events(1);
+
+	connect_to_cloud();
+	expect_fota_event(FOTA_POLL_REQUEST);
+}
 
 /* NOTE: This test must remain LAST in the file.
  *
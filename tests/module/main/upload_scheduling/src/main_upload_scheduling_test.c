@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <zephyr/fff.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/task_wdt/task_wdt.h>
+#include <zephyr/logging/log.h>
+#include <date_time.h>
+#include <modem/lte_lc.h>
+
+#include "dk_buttons_and_leds.h"
+#include "app_common.h"
+#include "power.h"
+#include "network.h"
+#include "environmental.h"
+#include "cloud.h"
+#include "fota.h"
+#include "location.h"
+#include "led.h"
+#include "button.h"
+#include "storage.h"
+#include "motion.h"
+#include "checks.h"
+
+DEFINE_FFF_GLOBALS;
+
+FAKE_VALUE_FUNC(int, dk_buttons_init, button_handler_t);
+FAKE_VALUE_FUNC(int, task_wdt_feed, int);
+FAKE_VALUE_FUNC(int, task_wdt_add, uint32_t, task_wdt_callback_t, void *);
+FAKE_VOID_FUNC(sys_reboot, int);
+
+LOG_MODULE_REGISTER(main_upload_scheduling_test, 4);
+
+/* Define the channels for testing */
+ZBUS_CHAN_DEFINE(power_chan,
+	struct power_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(button_chan,
+	struct button_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(network_chan,
+	struct network_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(.type = NETWORK_DISCONNECTED)
+);
+ZBUS_CHAN_DEFINE(cloud_chan,
+	struct cloud_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(.type = CLOUD_DISCONNECTED)
+);
+ZBUS_CHAN_DEFINE(environmental_chan,
+	struct environmental_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(fota_chan,
+	struct fota_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(location_chan,
+	struct location_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(led_chan,
+	struct led_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(storage_chan,
+	struct storage_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+ZBUS_CHAN_DEFINE(motion_chan,
+	struct motion_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+
+/* Helper functions for sending messages */
+
+static void send_cloud_connected(void)
+{
+	struct cloud_msg cloud_msg = {
+		.type = CLOUD_CONNECTED,
+	};
+
+	int err = zbus_chan_pub(&cloud_chan, &cloud_msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_cloud_disconnected(void)
+{
+	struct cloud_msg cloud_msg = {
+		.type = CLOUD_DISCONNECTED,
+	};
+
+	int err = zbus_chan_pub(&cloud_chan, &cloud_msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_location_search_done(void)
+{
+	struct location_msg msg = {
+		.type = LOCATION_SEARCH_DONE,
+	};
+
+	int err = zbus_chan_pub(&location_chan, &msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_location_ready(void)
+{
+	struct location_msg msg = {
+		.type = LOCATION_MODULE_READY,
+	};
+
+	int err = zbus_chan_pub(&location_chan, &msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_power_ready(void)
+{
+	struct power_msg msg = {
+		.type = POWER_MODULE_READY,
+	};
+
+	int err = zbus_chan_pub(&power_chan, &msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_button_press_short(void)
+{
+	struct button_msg button_msg = {
+		.type = BUTTON_PRESS_SHORT,
+		.button_number = 1
+	};
+
+	int err = zbus_chan_pub(&button_chan, &button_msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_storage_threshold_reached(uint32_t stored)
+{
+	struct storage_msg storage_msg = {
+		.type = STORAGE_THRESHOLD_REACHED,
+		.data_len = stored,
+	};
+	int err = zbus_chan_pub(&storage_chan, &storage_msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_storage_batch_close(void)
+{
+	struct storage_msg storage_msg = {
+		.type = STORAGE_BATCH_CLOSE,
+	};
+	int err = zbus_chan_pub(&storage_chan, &storage_msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_network_quality(int energy_estimate)
+{
+	struct network_msg msg = {
+		.type = NETWORK_QUALITY_SAMPLE_RESPONSE,
+		.conn_eval_params.energy_estimate = energy_estimate,
+	};
+	int err = zbus_chan_pub(&network_chan, &msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+static void send_fota_msg(enum fota_msg_type msg_type)
+{
+	int err;
+	struct fota_msg msg = { .type = msg_type };
+
+	err = zbus_chan_pub(&fota_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	k_sleep(K_MSEC(100));
+}
+
+/* Connect to cloud and drop the messages of the initial shadow and FOTA synchronization */
+static void connect_to_cloud(void)
+{
+	send_cloud_connected();
+	expect_cloud_event(CLOUD_CONNECTED);
+
+	k_sleep(K_MSEC(500));
+	purge_all_events();
+}
+
+/* Expect the messages of entering STATE_CONNECTED_SENDING and return to
+ * STATE_CONNECTED_WAITING
+ */
+static void expect_upload(void)
+{
+	expect_storage_event(STORAGE_BATCH_REQUEST);
+	expect_fota_event(FOTA_POLL_REQUEST);
+	expect_cloud_event(CLOUD_SHADOW_GET_DELTA);
+
+	send_storage_batch_close();
+	expect_storage_event(STORAGE_BATCH_CLOSE);
+}
+
+/* Defer an upload with a connection evaluation at excessive energy consumption */
+static void upload_defer(void)
+{
+	send_storage_threshold_reached(1);
+	expect_storage_event(STORAGE_THRESHOLD_REACHED);
+	expect_network_event(NETWORK_QUALITY_SAMPLE_REQUEST);
+
+	send_network_quality(LTE_LC_ENERGY_CONSUMPTION_EXCESSIVE);
+	expect_network_event(NETWORK_QUALITY_SAMPLE_RESPONSE);
+	expect_no_events(1);
+}
+
+void setUp(void)
+{
+	RESET_FAKE(dk_buttons_init);
+	RESET_FAKE(task_wdt_feed);
+	RESET_FAKE(task_wdt_add);
+	RESET_FAKE(sys_reboot);
+
+	send_location_ready();
+	send_power_ready();
+	send_fota_msg(FOTA_MODULE_READY);
+
+	send_cloud_disconnected();
+	k_sleep(K_MSEC(500));
+
+	/* Burn the current sampling cycle so that each test starts in STATE_DISCONNECTED_WAITING
+	 * with a known sample timer
+	 */
+	send_button_press_short();
+	send_location_search_done();
+	k_sleep(K_MSEC(100));
+
+	FFF_RESET_HISTORY();
+
+	purge_all_events();
+}
+
+/* Test functions */
+
+void test_upload_sent_at_efficient_energy(void)
+{
+	connect_to_cloud();
+
+	send_storage_threshold_reached(1);
+	expect_storage_event(STORAGE_THRESHOLD_REACHED);
+	expect_network_event(NETWORK_QUALITY_SAMPLE_REQUEST);
+
+	send_network_quality(LTE_LC_ENERGY_CONSUMPTION_EFFICIENT);
+	expect_network_event(NETWORK_QUALITY_SAMPLE_RESPONSE);
+	expect_upload();
+
+	expect_no_events(1);
+}
+
+void test_upload_deferred_until_energy_improves(void)
+{
+	connect_to_cloud();
+	upload_defer();
+
+	/* The connection is evaluated again when the device is idle after sampling */
+	send_button_press_short();
+	expect_location_event(LOCATION_SEARCH_TRIGGER);
+
+	send_location_search_done();
+	expect_location_event(LOCATION_SEARCH_DONE);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_REQUEST);
+	expect_network_event(NETWORK_QUALITY_SAMPLE_REQUEST);
+
+	send_network_quality(LTE_LC_ENERGY_CONSUMPTION_NORMAL);
+	expect_network_event(NETWORK_QUALITY_SAMPLE_RESPONSE);
+	expect_upload();
+
+	expect_no_events(1);
+}
+
+/* A response received while sampling does not interrupt the sampling */
+void test_upload_not_sent_while_sampling(void)
+{
+	connect_to_cloud();
+	upload_defer();
+
+	send_button_press_short();
+	expect_location_event(LOCATION_SEARCH_TRIGGER);
+
+	send_network_quality(LTE_LC_ENERGY_CONSUMPTION_EFFICIENT);
+	expect_network_event(NETWORK_QUALITY_SAMPLE_RESPONSE);
+	expect_no_events(1);
+
+	send_location_search_done();
+	expect_location_event(LOCATION_SEARCH_DONE);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_REQUEST);
+	expect_network_event(NETWORK_QUALITY_SAMPLE_REQUEST);
+
+	send_network_quality(LTE_LC_ENERGY_CONSUMPTION_EFFICIENT);
+	expect_network_event(NETWORK_QUALITY_SAMPLE_RESPONSE);
+	expect_upload();
+}
+
+/* The network module does not respond when the evaluation fails */
+void test_upload_sent_without_evaluation(void)
+{
+	connect_to_cloud();
+
+	send_storage_threshold_reached(1);
+	expect_storage_event(STORAGE_THRESHOLD_REACHED);
+	expect_network_event(NETWORK_QUALITY_SAMPLE_REQUEST);
+
+	k_sleep(K_SECONDS(CONFIG_APP_UPLOAD_SCHEDULING_EVAL_TIMEOUT_SECONDS));
+	expect_upload();
+
+	expect_no_events(1);
+}
+
+/* A timeout while sampling is ignored, the connection is evaluated again when idle */
+void test_evaluation_timeout_while_sampling(void)
+{
+	connect_to_cloud();
+
+	send_storage_threshold_reached(1);
+	expect_storage_event(STORAGE_THRESHOLD_REACHED);
+	expect_network_event(NETWORK_QUALITY_SAMPLE_REQUEST);
+
+	send_button_press_short();
+	expect_location_event(LOCATION_SEARCH_TRIGGER);
+
+	expect_no_events(CONFIG_APP_UPLOAD_SCHEDULING_EVAL_TIMEOUT_SECONDS + 1);
+
+	send_location_search_done();
+	expect_location_event(LOCATION_SEARCH_DONE);
+	expect_power_event(POWER_BATTERY_PERCENTAGE_SAMPLE_REQUEST);
+	expect_network_event(NETWORK_QUALITY_SAMPLE_REQUEST);
+
+	k_sleep(K_SECONDS(CONFIG_APP_UPLOAD_SCHEDULING_EVAL_TIMEOUT_SECONDS));
+	expect_upload();
+}
+
+void test_upload_forced_when_storage_is_full(void)
+{
+	connect_to_cloud();
+
+	send_storage_threshold_reached(CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE);
+	expect_storage_event(STORAGE_THRESHOLD_REACHED);
+	expect_upload();
+
+	expect_no_events(1);
+}
+
+/* This is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	k_sleep(K_FOREVER);
+
+	return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+
+#include "network_reattach.h"
+
+DEFINE_FFF_GLOBALS;
+
+/* Used by network_reattach.c */
+LOG_MODULE_REGISTER(network, 4);
+
+FAKE_VALUE_FUNC(int, settings_subsys_init);
+FAKE_VALUE_FUNC(int, settings_save_one, const char *, const void *, size_t);
+FAKE_VALUE_FUNC(int, settings_load_subtree_direct, const char *, settings_load_direct_cb,
+		void *);
+
+static char mask[NETWORK_REATTACH_BAND_MASK_SIZE];
+static char plmn[NETWORK_REATTACH_PLMN_SIZE];
+
+/* Band mask string with the given bands set, band 1 as the last character */
+static const char *expected_mask(uint8_t highest, uint8_t other)
+{
+	static char expected[NETWORK_REATTACH_BAND_MASK_SIZE];
+
+	memset(expected, '0', highest);
+	expected[highest] = '\0';
+	expected[0] = '1';
+
+	if (other) {
+		expected[highest - other] = '1';
+	}
+
+	return expected;
+}
+
+void setUp(void)
+{
+	RESET_FAKE(settings_subsys_init);
+	RESET_FAKE(settings_save_one);
+	RESET_FAKE(settings_load_subtree_direct);
+}
+
+void tearDown(void)
+{
+}
+
+void test_no_bands_before_first_connection(void)
+{
+	TEST_ASSERT_FALSE(network_reattach_band_mask_get(mask, sizeof(mask), plmn));
+	TEST_ASSERT_EQUAL(1, settings_load_subtree_direct_fake.call_count);
+	TEST_ASSERT_EQUAL_STRING("att_network", settings_load_subtree_direct_fake.arg0_val);
+
+	/* The cache is only loaded once */
+	TEST_ASSERT_FALSE(network_reattach_band_mask_get(mask, sizeof(mask), plmn));
+	TEST_ASSERT_EQUAL(1, settings_load_subtree_direct_fake.call_count);
+}
+
+void test_bands_of_plmn_cached(void)
+{
+	network_reattach_update("24201", 20);
+
+	TEST_ASSERT_EQUAL(1, settings_save_one_fake.call_count);
+	TEST_ASSERT_EQUAL_STRING("att_network/cell", settings_save_one_fake.arg0_val);
+
+	TEST_ASSERT_TRUE(network_reattach_band_mask_get(mask, sizeof(mask), plmn));
+	TEST_ASSERT_EQUAL_STRING(expected_mask(20, 0), mask);
+	TEST_ASSERT_EQUAL_STRING("24201", plmn);
+
+	network_reattach_update("24201", 3);
+
+	TEST_ASSERT_EQUAL(2, settings_save_one_fake.call_count);
+	TEST_ASSERT_TRUE(network_reattach_band_mask_get(mask, sizeof(mask), plmn));
+	TEST_ASSERT_EQUAL_STRING(expected_mask(20, 3), mask);
+
+	/* A known band is not saved again */
+	network_reattach_update("24201", 20);
+
+	TEST_ASSERT_EQUAL(2, settings_save_one_fake.call_count);
+}
+
+void test_least_recently_used_band_replaced(void)
+{
+	network_reattach_update("24202", 20);
+	network_reattach_update("24202", 3);
+	network_reattach_update("24202", 20);
+
+	/* Band 3 is the least recently used of the two cached bands */
+	network_reattach_update("24202", 8);
+
+	TEST_ASSERT_TRUE(network_reattach_band_mask_get(mask, sizeof(mask), plmn));
+	TEST_ASSERT_EQUAL_STRING(expected_mask(20, 8), mask);
+}
+
+void test_new_plmn_replaces_bands(void)
+{
+	network_reattach_update("24201", 20);
+	network_reattach_update("310410", 4);
+
+	TEST_ASSERT_TRUE(network_reattach_band_mask_get(mask, sizeof(mask), plmn));
+	TEST_ASSERT_EQUAL_STRING("1000", mask);
+	TEST_ASSERT_EQUAL_STRING("310410", plmn);
+}
+
+void test_invalid_serving_cell_not_cached(void)
+{
+	network_reattach_update("24201", 0);
+	network_reattach_update("24201", NETWORK_REATTACH_BAND_MAX + 1);
+	network_reattach_update("2420100", 20);
+
+	TEST_ASSERT_EQUAL(0, settings_save_one_fake.call_count);
+
+	/* A buffer too small for the mask is not written */
+	TEST_ASSERT_FALSE(network_reattach_band_mask_get(mask, 4, plmn));
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
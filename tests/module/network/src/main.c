@@ -11,6 +11,7 @@
 #include <modem/nrf_modem_lib.h>
 #include <modem/lte_lc.h>
 #include <modem/modem_info.h>
+#include <nrf_socket.h>
 
 #include "app_common.h"
 #include "network.h"
@@ -33,6 +34,14 @@ FAKE_VALUE_FUNC(int, lte_lc_system_mode_set, enum lte_lc_system_mode,
 FAKE_VALUE_FUNC(int, lte_lc_offline);
 FAKE_VALUE_FUNC(int, lte_lc_connect_async, lte_lc_evt_handler_t);
 FAKE_VALUE_FUNC(int, lte_lc_pdn_default_ctx_events_enable);
+FAKE_VALUE_FUNC(int, lte_lc_psm_param_set_seconds, int, int);
+FAKE_VALUE_FUNC(int, lte_lc_psm_req, bool);
+FAKE_VALUE_FUNC(int, lte_lc_edrx_param_set, enum lte_lc_lte_mode, const char *);
+FAKE_VALUE_FUNC(int, lte_lc_edrx_req, bool);
+FAKE_VALUE_FUNC(int, lte_lc_periodic_search_set, const struct lte_lc_periodic_search_cfg *);
+FAKE_VALUE_FUNC(int, nrf_socket, int, int, int);
+FAKE_VALUE_FUNC(int, nrf_setsockopt, int, int, int, const void *, nrf_socklen_t);
+FAKE_VALUE_FUNC(int, nrf_close, int);
 
 ZBUS_MSG_SUBSCRIBER_DEFINE(test_subscriber);
 ZBUS_CHAN_ADD_OBS(network_chan, test_subscriber, 0);
@@ -169,6 +178,37 @@ static void send_psm_update_evt(void)
 	lte_evt_handler(&evt);
 }
 
+static void send_psm_not_granted_evt(void)
+{
+	struct lte_lc_evt evt = {
+		.type = LTE_LC_EVT_PSM_UPDATE,
+		.psm_cfg = {
+			.tau = -1,
+			.active_time = -1,
+		},
+	};
+
+	lte_evt_handler(&evt);
+}
+
+static void send_schedule(uint32_t sample_interval_sec, uint32_t upload_interval_sec)
+{
+	int err;
+	struct network_msg msg = {
+		.type = NETWORK_SCHEDULE_SET,
+		.schedule = {
+			.sample_interval_sec = sample_interval_sec,
+			.upload_interval_sec = upload_interval_sec,
+		},
+	};
+
+	err = zbus_chan_pub(&network_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	/* Allow the message to be processed in the network module */
+	k_sleep(K_MSEC(100));
+}
+
 static void send_edrx_update_evt(void)
 {
 	struct lte_lc_evt evt = {
@@ -265,6 +305,14 @@ void setUp(void)
 	RESET_FAKE(lte_lc_system_mode_set);
 	RESET_FAKE(lte_lc_register_handler);
 	RESET_FAKE(nrf_modem_lib_init);
+	RESET_FAKE(lte_lc_psm_param_set_seconds);
+	RESET_FAKE(lte_lc_psm_req);
+	RESET_FAKE(lte_lc_edrx_param_set);
+	RESET_FAKE(lte_lc_edrx_req);
+	RESET_FAKE(lte_lc_periodic_search_set);
+	RESET_FAKE(nrf_socket);
+	RESET_FAKE(nrf_setsockopt);
+	RESET_FAKE(nrf_close);
 
 
 	date_time_now_fake.custom_fake = date_time_now_custom_fake;
@@ -451,6 +499,36 @@ void test_system_mode_request(void)
 	TEST_ASSERT_EQUAL(current_fake_system_mode, msg.system_mode);
 }
 
+void test_quality_sample_request(void)
+{
+	struct network_msg msg = { .type = NETWORK_DISCONNECT, };
+	int err;
+
+	/* Quality samples are only taken while connected */
+	err = zbus_chan_pub(&network_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	k_sleep(K_MSEC(10));
+
+	msg.type = NETWORK_CONNECT;
+
+	err = zbus_chan_pub(&network_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	wait_for_and_check_msg(&msg, NETWORK_CONNECTED);
+
+	msg.type = NETWORK_QUALITY_SAMPLE_REQUEST;
+
+	err = zbus_chan_pub(&network_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	wait_for_and_check_msg(&msg, NETWORK_QUALITY_SAMPLE_RESPONSE);
+	TEST_ASSERT_EQUAL(NETWORK_QUALITY_SAMPLE_RESPONSE, msg.type);
+	TEST_ASSERT_EQUAL(FAKE_RSRP_IDX, msg.conn_eval_params.rsrp);
+	TEST_ASSERT_EQUAL(FAKE_ENERGY_ESTIMATE, msg.conn_eval_params.energy_estimate);
+	TEST_ASSERT_EQUAL(1, lte_lc_conn_eval_params_get_fake.call_count);
+}
+
 static void system_mode_set_test(enum network_msg_type msg_type, enum lte_lc_system_mode expected)
 {
 	struct network_msg msg = { .type = NETWORK_DISCONNECT, };
@@ -555,6 +633,157 @@ void test_connect_from_idle(void)
 	TEST_ASSERT_EQUAL(NETWORK_CONNECTED, msg_rx.type);
 }
 
+void test_psm_requested_from_schedule(void)
+{
+	/* The TAU is requested as a multiple of the upload interval */
+	send_schedule(600, 2400);
+
+	TEST_ASSERT_EQUAL(1, lte_lc_psm_param_set_seconds_fake.call_count);
+	TEST_ASSERT_EQUAL(4800, lte_lc_psm_param_set_seconds_fake.arg0_val);
+	TEST_ASSERT_EQUAL(6, lte_lc_psm_param_set_seconds_fake.arg1_val);
+	TEST_ASSERT_EQUAL(1, lte_lc_psm_req_fake.call_count);
+	TEST_ASSERT_TRUE(lte_lc_psm_req_fake.arg0_val);
+
+	/* The same TAU is not requested again */
+	send_schedule(600, 2400);
+
+	TEST_ASSERT_EQUAL(1, lte_lc_psm_param_set_seconds_fake.call_count);
+
+	/* Short upload intervals are limited by the minimum TAU */
+	send_schedule(600, 600);
+
+	TEST_ASSERT_EQUAL(2, lte_lc_psm_param_set_seconds_fake.call_count);
+	TEST_ASSERT_EQUAL(3600, lte_lc_psm_param_set_seconds_fake.arg0_val);
+	TEST_ASSERT_EQUAL(0, lte_lc_edrx_req_fake.call_count);
+}
+
+void test_edrx_requested_when_psm_not_granted(void)
+{
+	struct network_msg msg;
+
+	send_schedule(600, 3000);
+
+	send_psm_not_granted_evt();
+	wait_for_and_check_msg(&msg, NETWORK_PSM_PARAMS);
+	k_sleep(K_MSEC(100));
+
+	/* The longest cycle below the maximum of 330 seconds, 327.68 seconds */
+	TEST_ASSERT_EQUAL(2, lte_lc_edrx_param_set_fake.call_count);
+	TEST_ASSERT_EQUAL(LTE_LC_LTE_MODE_LTEM, lte_lc_edrx_param_set_fake.arg0_history[0]);
+	TEST_ASSERT_EQUAL_STRING("1010", lte_lc_edrx_param_set_fake.arg1_history[0]);
+	TEST_ASSERT_EQUAL(LTE_LC_LTE_MODE_NBIOT, lte_lc_edrx_param_set_fake.arg0_history[1]);
+	TEST_ASSERT_EQUAL_STRING("1010", lte_lc_edrx_param_set_fake.arg1_history[1]);
+	TEST_ASSERT_EQUAL(1, lte_lc_edrx_req_fake.call_count);
+	TEST_ASSERT_TRUE(lte_lc_edrx_req_fake.arg0_val);
+
+	/* The cycle follows the sample interval, 40.96 seconds in both modes */
+	send_schedule(60, 3000);
+
+	TEST_ASSERT_EQUAL(4, lte_lc_edrx_param_set_fake.call_count);
+	TEST_ASSERT_EQUAL_STRING("0011", lte_lc_edrx_param_set_fake.arg1_history[2]);
+	TEST_ASSERT_EQUAL_STRING("0011", lte_lc_edrx_param_set_fake.arg1_history[3]);
+	TEST_ASSERT_EQUAL(2, lte_lc_edrx_req_fake.call_count);
+
+	/* The configured eDRX values are requested again when PSM is granted */
+	send_psm_update_evt();
+	wait_for_and_check_msg(&msg, NETWORK_PSM_PARAMS);
+	k_sleep(K_MSEC(100));
+
+	TEST_ASSERT_EQUAL(6, lte_lc_edrx_param_set_fake.call_count);
+	TEST_ASSERT_EQUAL_STRING("0000", lte_lc_edrx_param_set_fake.arg1_history[4]);
+	TEST_ASSERT_EQUAL_STRING("0000", lte_lc_edrx_param_set_fake.arg1_history[5]);
+	TEST_ASSERT_EQUAL(3, lte_lc_edrx_req_fake.call_count);
+	TEST_ASSERT_TRUE(lte_lc_edrx_req_fake.arg0_val);
+}
+
+void test_release_assistance_after_transaction(void)
+{
+	int err;
+	struct network_msg msg = {
+		.type = NETWORK_DISCONNECT,
+	};
+
+	err = zbus_chan_pub(&network_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	k_sleep(K_MSEC(100));
+
+	/* Ignored while disconnected */
+	msg.type = NETWORK_TRANSACTION_DONE;
+
+	err = zbus_chan_pub(&network_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	k_sleep(K_MSEC(100));
+
+	TEST_ASSERT_EQUAL(0, nrf_socket_fake.call_count);
+
+	msg.type = NETWORK_CONNECT;
+
+	err = zbus_chan_pub(&network_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	wait_for_and_check_msg(&msg, NETWORK_CONNECTED);
+
+	msg.type = NETWORK_TRANSACTION_DONE;
+	nrf_socket_fake.return_val = 3;
+
+	err = zbus_chan_pub(&network_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	k_sleep(K_MSEC(100));
+
+	TEST_ASSERT_EQUAL(1, nrf_setsockopt_fake.call_count);
+	TEST_ASSERT_EQUAL(3, nrf_setsockopt_fake.arg0_val);
+	TEST_ASSERT_EQUAL(NRF_SO_RAI, nrf_setsockopt_fake.arg2_val);
+	TEST_ASSERT_EQUAL(1, nrf_close_fake.call_count);
+	TEST_ASSERT_EQUAL(3, nrf_close_fake.arg0_val);
+}
+
+/* Must be the last test, the search budget of the hour is used */
+void test_search_suspended_when_budget_used(void)
+{
+	int err;
+	struct network_msg msg = {
+		.type = NETWORK_DISCONNECT,
+	};
+
+	/* Ensure we are disconnected and idle */
+	err = zbus_chan_pub(&network_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	k_sleep(K_MSEC(100));
+
+	/* Keep searching without finding a network */
+	lte_lc_connect_async_fake.custom_fake = NULL;
+	RESET_FAKE(lte_lc_offline);
+	lte_lc_offline_fake.custom_fake = lte_lc_offline_custom_fake;
+
+	msg.type = NETWORK_CONNECT;
+
+	err = zbus_chan_pub(&network_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	k_sleep(K_SECONDS(CONFIG_APP_NETWORK_SEARCH_BUDGET_SECONDS_PER_HOUR + 1));
+
+	TEST_ASSERT_EQUAL(1, lte_lc_connect_async_fake.call_count);
+	TEST_ASSERT_EQUAL(1, lte_lc_offline_fake.call_count);
+
+	/* No search is started until the budget window has passed */
+	err = zbus_chan_pub(&network_chan, &msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	k_sleep(K_MSEC(100));
+
+	TEST_ASSERT_EQUAL(1, lte_lc_connect_async_fake.call_count);
+	TEST_ASSERT_EQUAL(2, lte_lc_offline_fake.call_count);
+
+	/* The search is resumed at a sample deadline after the budget window */
+	k_sleep(K_SECONDS(3600 + 60));
+
+	TEST_ASSERT_EQUAL(2, lte_lc_connect_async_fake.call_count);
+}
+
 /* This is required to be added to each test. That is because unity's
  * main may return nonzero, while zephyr's main currently must
  * return 0 in all cases (other values are reserved).
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <zephyr/kernel.h>
+
+#include "energy_ledger.h"
+
+/* One hour in milliseconds */
+#define HOUR_MS (60 * 60 * MSEC_PER_SEC)
+
+void setUp(void)
+{
+	/* The ledger is kept between tests */
+	for (enum energy_ledger_activity activity = 0; activity < ENERGY_LEDGER_COUNT;
+	     activity++) {
+		energy_ledger_activity_set(activity, false);
+	}
+
+	energy_ledger_reset(0);
+}
+
+void tearDown(void)
+{
+}
+
+void test_charge_attributed_to_current_activity(void)
+{
+	uint32_t charge[ENERGY_LEDGER_COUNT];
+
+	/* 10 mA for one hour with nothing active */
+	energy_ledger_update(0.01f, HOUR_MS);
+
+	energy_ledger_activity_set(ENERGY_LEDGER_CLOUD, true);
+
+	/* 2 mA for half an hour while cloud is connected */
+	energy_ledger_update(0.002f, HOUR_MS + HOUR_MS / 2);
+
+	energy_ledger_get(charge);
+
+	TEST_ASSERT_EQUAL(10000, charge[ENERGY_LEDGER_OTHER]);
+	TEST_ASSERT_EQUAL(1000, charge[ENERGY_LEDGER_CLOUD]);
+	TEST_ASSERT_EQUAL(0, charge[ENERGY_LEDGER_SLEEP]);
+	TEST_ASSERT_EQUAL(0, charge[ENERGY_LEDGER_LOCATION]);
+	TEST_ASSERT_EQUAL(0, charge[ENERGY_LEDGER_FOTA]);
+}
+
+void test_overlapping_activities_attributed_by_priority(void)
+{
+	uint32_t charge[ENERGY_LEDGER_COUNT];
+
+	energy_ledger_activity_set(ENERGY_LEDGER_CLOUD, true);
+	energy_ledger_activity_set(ENERGY_LEDGER_SLEEP, true);
+	energy_ledger_activity_set(ENERGY_LEDGER_LOCATION, true);
+
+	TEST_ASSERT_EQUAL(ENERGY_LEDGER_LOCATION, energy_ledger_activity_get());
+
+	energy_ledger_update(0.001f, HOUR_MS);
+
+	energy_ledger_activity_set(ENERGY_LEDGER_LOCATION, false);
+
+	TEST_ASSERT_EQUAL(ENERGY_LEDGER_SLEEP, energy_ledger_activity_get());
+
+	energy_ledger_update(0.001f, 2 * HOUR_MS);
+
+	energy_ledger_activity_set(ENERGY_LEDGER_FOTA, true);
+
+	TEST_ASSERT_EQUAL(ENERGY_LEDGER_FOTA, energy_ledger_activity_get());
+
+	energy_ledger_update(0.001f, 3 * HOUR_MS);
+
+	energy_ledger_get(charge);
+
+	TEST_ASSERT_EQUAL(1000, charge[ENERGY_LEDGER_LOCATION]);
+	TEST_ASSERT_EQUAL(1000, charge[ENERGY_LEDGER_SLEEP]);
+	TEST_ASSERT_EQUAL(1000, charge[ENERGY_LEDGER_FOTA]);
+	TEST_ASSERT_EQUAL(0, charge[ENERGY_LEDGER_CLOUD]);
+	TEST_ASSERT_EQUAL(0, charge[ENERGY_LEDGER_OTHER]);
+}
+
+void test_charging_current_not_counted(void)
+{
+	uint32_t charge[ENERGY_LEDGER_COUNT];
+
+	/* A negative current is the battery being charged */
+	energy_ledger_update(-0.1f, HOUR_MS);
+
+	/* A time that goes backwards is ignored */
+	energy_ledger_update(0.01f, HOUR_MS / 2);
+
+	energy_ledger_get(charge);
+
+	for (size_t i = 0; i < ENERGY_LEDGER_COUNT; i++) {
+		TEST_ASSERT_EQUAL(0, charge[i]);
+	}
+}
+
+void test_reset_keeps_activities(void)
+{
+	uint32_t charge[ENERGY_LEDGER_COUNT];
+
+	energy_ledger_activity_set(ENERGY_LEDGER_SLEEP, true);
+	energy_ledger_update(0.001f, HOUR_MS);
+
+	energy_ledger_reset(2 * HOUR_MS);
+
+	TEST_ASSERT_TRUE(energy_ledger_activity_is_active(ENERGY_LEDGER_SLEEP));
+
+	/* Only the time since the reset is counted */
+	energy_ledger_update(0.001f, 3 * HOUR_MS);
+
+	energy_ledger_get(charge);
+
+	TEST_ASSERT_EQUAL(1000, charge[ENERGY_LEDGER_SLEEP]);
+}
+
+void test_other_cannot_be_set(void)
+{
+	energy_ledger_activity_set(ENERGY_LEDGER_OTHER, true);
+
+	TEST_ASSERT_FALSE(energy_ledger_activity_is_active(ENERGY_LEDGER_OTHER));
+	TEST_ASSERT_EQUAL(ENERGY_LEDGER_OTHER, energy_ledger_activity_get());
+	TEST_ASSERT_EQUAL_STRING("other", energy_ledger_activity_name(ENERGY_LEDGER_OTHER));
+	TEST_ASSERT_EQUAL_STRING("unknown", energy_ledger_activity_name(ENERGY_LEDGER_COUNT));
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -11,11 +11,13 @@
 #include <errno.h>
 #include <string.h>
 #include <nrf_fuel_gauge.h>
+#include <zephyr/drivers/mfd/npm13xx.h>
 #include "redef.h"
 #include <modem/lte_lc.h>
 
 #include "app_common.h"
 #include "power.h"
+#include "fota.h"
 
 DEFINE_FFF_GLOBALS;
 
@@ -31,10 +33,19 @@ FAKE_VALUE_FUNC(int, nrf_fuel_gauge_ext_state_update,
 		union nrf_fuel_gauge_ext_state_info_data *);
 FAKE_VALUE_FUNC(int, nrf_fuel_gauge_idle_set, float, float, float);
 FAKE_VOID_FUNC(lte_lc_register_handler, lte_lc_evt_handler_t);
+FAKE_VALUE_FUNC(int, mfd_npm13xx_add_callback, const struct device *, struct gpio_callback *);
 
 /* Define nrf_fuel_gauge_state_size for tests (normally provided by the library) */
 const size_t nrf_fuel_gauge_state_size = 512;
 
+ZBUS_CHAN_DEFINE(fota_chan,
+	struct fota_msg,
+	NULL,
+	NULL,
+	ZBUS_OBSERVERS_EMPTY,
+	ZBUS_MSG_INIT(0)
+);
+
 ZBUS_MSG_SUBSCRIBER_DEFINE(power_subscriber);
 ZBUS_CHAN_ADD_OBS(power_chan, power_subscriber, 0);
 
@@ -49,6 +60,23 @@ struct nrf_modem_lib_init_cb {
 };
 extern struct nrf_modem_lib_init_cb nrf_modem_hook_power_modem_init_hook;
 
+/* Changes the state of charge by one percentage point per sample, so that the fuel gauge state
+ * is saved after every sample.
+ */
+static int nrf_fuel_gauge_process_custom_fake(float v, float i, float t, float t_delta,
+					      float *soc, struct nrf_fuel_gauge_state_info *info)
+{
+	ARG_UNUSED(v);
+	ARG_UNUSED(i);
+	ARG_UNUSED(t);
+	ARG_UNUSED(t_delta);
+	ARG_UNUSED(info);
+
+	*soc += 1.0f;
+
+	return 0;
+}
+
 void setUp(void)
 {
 	/* reset fakes */
@@ -69,6 +97,7 @@ void setUp(void)
 
 	/* Set default return values */
 	nrf_fuel_gauge_state_get_fake.return_val = 0;
+	nrf_fuel_gauge_process_fake.custom_fake = nrf_fuel_gauge_process_custom_fake;
 
 	const struct zbus_channel *chan;
 	struct power_msg received_msg;
@@ -284,6 +313,86 @@ void test_idle_state_ignores_additional_sleep_entry(void)
 	TEST_ASSERT_EQUAL(0, nrf_fuel_gauge_idle_set_fake.call_count);
 }
 
+void test_idle_sampled_at_idle_interval(void)
+{
+	/* Given - Module enters STATE_IDLE */
+	send_modem_sleep_exit();
+	k_sleep(K_MSEC(100));
+	send_modem_sleep_entry();
+	k_sleep(K_MSEC(100));
+
+	RESET_FAKE(nrf_fuel_gauge_process);
+	RESET_FAKE(nrf_fuel_gauge_idle_set);
+
+	/* Then - No sample is taken before the idle interval */
+	k_sleep(K_SECONDS(CONFIG_APP_POWER_IDLE_SAMPLE_INTERVAL_SECONDS - 1));
+	TEST_ASSERT_EQUAL(0, nrf_fuel_gauge_process_fake.call_count);
+
+	/* And - One sample is taken at the idle interval and idle mode is set again */
+	k_sleep(K_SECONDS(2));
+	TEST_ASSERT_EQUAL(1, nrf_fuel_gauge_process_fake.call_count);
+	TEST_ASSERT_EQUAL(1, nrf_fuel_gauge_idle_set_fake.call_count);
+}
+
+void test_charger_event_triggers_sample(void)
+{
+	struct gpio_callback *event_cb = mfd_npm13xx_add_callback_fake.arg1_val;
+
+	/* Given - The module registered for charger events at startup and is in STATE_IDLE */
+	TEST_ASSERT_EQUAL(1, mfd_npm13xx_add_callback_fake.call_count);
+	TEST_ASSERT_NOT_NULL(event_cb);
+	TEST_ASSERT_TRUE(event_cb->pin_mask & BIT(NPM13XX_EVENT_VBUS_DETECTED));
+
+	send_modem_sleep_exit();
+	k_sleep(K_MSEC(100));
+	send_modem_sleep_entry();
+	k_sleep(K_MSEC(100));
+
+	RESET_FAKE(nrf_fuel_gauge_process);
+
+	/* When - The PMIC reports that VBUS is connected */
+	event_cb->handler(&mock_charger_device, event_cb, BIT(NPM13XX_EVENT_VBUS_DETECTED));
+	k_sleep(K_MSEC(100));
+
+	/* Then - The fuel gauge is sampled without waiting for the idle interval */
+	TEST_ASSERT_EQUAL(1, nrf_fuel_gauge_process_fake.call_count);
+}
+
+void test_fuel_gauge_state_not_saved_without_soc_change(void)
+{
+	/* Given - Module is in STATE_ACTIVE and the state of charge does not change */
+	send_modem_sleep_exit();
+	k_sleep(K_MSEC(100));
+
+	nrf_fuel_gauge_process_fake.custom_fake = NULL;
+	RESET_FAKE(nrf_fuel_gauge_state_get);
+
+	/* When - The fuel gauge is sampled several times */
+	k_sleep(K_MSEC(3100));
+
+	/* Then - The state is not saved again */
+	TEST_ASSERT_GREATER_OR_EQUAL(3, nrf_fuel_gauge_process_fake.call_count);
+	TEST_ASSERT_EQUAL(0, nrf_fuel_gauge_state_get_fake.call_count);
+}
+
+void test_fuel_gauge_state_saved_on_fota_reboot(void)
+{
+	struct fota_msg msg = {
+		.type = FOTA_REQUEST_REBOOT,
+	};
+
+	/* Given - The state of charge does not change */
+	nrf_fuel_gauge_process_fake.custom_fake = NULL;
+	RESET_FAKE(nrf_fuel_gauge_state_get);
+
+	/* When - A FOTA reboot is requested */
+	TEST_ASSERT_EQUAL(0, zbus_chan_pub(&fota_chan, &msg, K_SECONDS(1)));
+	k_sleep(K_MSEC(100));
+
+	/* Then - The state is saved before the reboot */
+	TEST_ASSERT_EQUAL(1, nrf_fuel_gauge_state_get_fake.call_count);
+}
+
 /* This is required to be added to each test. That is because unity's
  * main may return nonzero, while zephyr's main currently must
  * return 0 in all cases (other values are reserved).
@@ -0,0 +1,418 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * Throughput and latency benchmark for the storage module.
+ *
+ * The same tests run against the RAM backend and, with STORAGE_BENCHMARK_LITTLEFS, against
+ * the LittleFS backend on the flash simulator. Store, peek and retrieve are timed on the
+ * backend directly; the batch session is timed end to end through the storage module and
+ * storage_batch_read(), as in a flush to the cloud after an outage.
+ *
+ * Time on native_sim is simulated: it advances only through the flash simulator's busy-waits
+ * (see prj.conf), so the numbers reflect flash cost and are deterministic between runs. The RAM
+ * backend therefore reports no elapsed time; its lines serve as a baseline for the flash
+ * byte counts and item counts.
+ *
+ * Each result is printed as one machine-readable line, in the same order on every run so that
+ * the output of two releases can be diffed directly:
+ *
+ *	BENCHMARK,<backend>,<scenario>,<metric>,<value>
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/task_wdt/task_wdt.h>
+#if defined(CONFIG_FLASH_SIMULATOR_STATS)
+#include <zephyr/stats/stats.h>
+#endif
+
+#include "storage.h"
+#include "storage_backend.h"
+#include "storage_data_types.h"
+#include "power.h"
+#include "environmental.h"
+#include "location.h"
+
+DEFINE_FFF_GLOBALS;
+
+FAKE_VALUE_FUNC(int, task_wdt_feed, int);
+FAKE_VALUE_FUNC(int, task_wdt_add, uint32_t, task_wdt_callback_t, void *);
+
+/* Records stored per scenario, a full buffer of one type */
+#define BENCHMARK_RECORDS	CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE
+
+/* Number of timed peeks, spread over the stored records */
+#define PEEK_SAMPLES		32
+
+#define BENCHMARK_SESSION_ID	0xBE7C0001
+
+#if defined(CONFIG_APP_STORAGE_BACKEND_LITTLEFS)
+#define BENCHMARK_BACKEND	"littlefs"
+#else
+#define BENCHMARK_BACKEND	"ram"
+#endif
+
+static void storage_chan_cb(const struct zbus_channel *chan);
+
+ZBUS_CHAN_DEFINE(power_chan,
+		 struct power_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_DEFINE(environmental_chan,
+		 struct environmental_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_DEFINE(location_chan,
+		 struct location_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_LISTENER_DEFINE(benchmark_storage_listener, storage_chan_cb);
+ZBUS_CHAN_ADD_OBS(storage_chan, benchmark_storage_listener, 0);
+
+static K_SEM_DEFINE(batch_response_sem, 0, 1);
+static struct storage_msg batch_response;
+
+/* Latency of a series of operations, in cycles */
+struct latency {
+	uint64_t total;
+	uint64_t max;
+	uint32_t count;
+};
+
+static void storage_chan_cb(const struct zbus_channel *chan)
+{
+	const struct storage_msg *msg = zbus_chan_const_msg(chan);
+
+	if ((msg->type == STORAGE_BATCH_AVAILABLE) || (msg->type == STORAGE_BATCH_EMPTY) ||
+	    (msg->type == STORAGE_BATCH_BUSY) || (msg->type == STORAGE_BATCH_ERROR)) {
+		batch_response = *msg;
+		k_sem_give(&batch_response_sem);
+	}
+}
+
+static const struct storage_data *find_type(enum storage_data_type data_type)
+{
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		if (type->data_type == data_type) {
+			return type;
+		}
+	}
+
+	return NULL;
+}
+
+#if defined(CONFIG_FLASH_SIMULATOR_STATS)
+static int flash_stats_walk_cb(struct stats_hdr *hdr, void *arg, const char *name, uint16_t off)
+{
+	if (strcmp(name, "bytes_written") == 0) {
+		*(uint32_t *)arg = *(uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_FLASH_SIMULATOR_STATS */
+
+/* Total number of bytes written to the simulated flash since boot */
+static uint32_t flash_bytes_written(void)
+{
+	uint32_t bytes = 0;
+
+#if defined(CONFIG_FLASH_SIMULATOR_STATS)
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+
+	if (hdr) {
+		(void)stats_walk(hdr, flash_stats_walk_cb, &bytes);
+	}
+#endif /* CONFIG_FLASH_SIMULATOR_STATS */
+
+	return bytes;
+}
+
+static void latency_add(struct latency *latency, uint64_t start)
+{
+	uint64_t cycles = k_cycle_get_64() - start;
+
+	latency->total += cycles;
+	latency->max = MAX(latency->max, cycles);
+	latency->count++;
+}
+
+static void report(const char *scenario, const char *metric, uint64_t value)
+{
+	printk("BENCHMARK,%s,%s,%s,%llu\n", BENCHMARK_BACKEND, scenario, metric,
+	       (unsigned long long)value);
+}
+
+static void report_throughput(const char *scenario, const char *metric, uint32_t items,
+			      uint64_t elapsed_us)
+{
+	uint64_t per_s = (elapsed_us > 0) ? ((uint64_t)items * USEC_PER_SEC) / elapsed_us : 0;
+
+	report(scenario, "items", items);
+	report(scenario, "elapsed_us", elapsed_us);
+	report(scenario, metric, per_s);
+}
+
+static void report_latency(const char *scenario, const struct latency *latency)
+{
+	uint64_t avg = (latency->count > 0) ? latency->total / latency->count : 0;
+
+	report(scenario, "latency_ns_avg", k_cyc_to_ns_floor64(avg));
+	report(scenario, "latency_ns_max", k_cyc_to_ns_floor64(latency->max));
+}
+
+static void report_flash_bytes(const char *scenario, uint32_t records, uint32_t bytes)
+{
+	report(scenario, "flash_bytes_written", bytes);
+	report(scenario, "flash_bytes_per_record", (records > 0) ? bytes / records : 0);
+}
+
+/* Store records with increasing timestamps directly in the backend, untimed */
+static void fill_backend(const struct storage_data *type, uint32_t records)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	struct environmental_msg env_msg = { .type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE };
+	int err;
+
+	for (uint32_t i = 0; i < records; i++) {
+		env_msg.timestamp = (int64_t)i;
+		env_msg.temperature = (double)i;
+
+		err = backend->store(type, &env_msg, type->data_size);
+		TEST_ASSERT_EQUAL(0, err);
+	}
+
+	err = backend->sync();
+	TEST_ASSERT_EQUAL(0, err);
+	TEST_ASSERT_EQUAL(records, backend->count(type));
+}
+
+static void publish_and_assert(const struct storage_msg *msg)
+{
+	int err = zbus_chan_pub(&storage_chan, msg, K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(0, err);
+}
+
+void setUp(void)
+{
+	struct storage_msg clear_msg = { .type = STORAGE_CLEAR };
+
+	publish_and_assert(&clear_msg);
+	k_sleep(K_MSEC(500));
+
+	k_sem_reset(&batch_response_sem);
+
+	RESET_FAKE(task_wdt_feed);
+	RESET_FAKE(task_wdt_add);
+}
+
+void tearDown(void)
+{
+}
+
+/* Store a full buffer of records, including the final sync that makes them persistent */
+void test_benchmark_store(void)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	const struct storage_data *type = find_type(STORAGE_TYPE_ENVIRONMENTAL);
+	struct environmental_msg env_msg = { .type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE };
+	struct latency latency = { 0 };
+	uint32_t bytes_before;
+	uint64_t start_total;
+	uint64_t start;
+	int err;
+
+	TEST_ASSERT_NOT_NULL(type);
+
+	bytes_before = flash_bytes_written();
+	start_total = k_cycle_get_64();
+
+	for (uint32_t i = 0; i < BENCHMARK_RECORDS; i++) {
+		env_msg.timestamp = (int64_t)i;
+
+		start = k_cycle_get_64();
+
+		err = backend->store(type, &env_msg, type->data_size);
+		TEST_ASSERT_EQUAL(0, err);
+
+		latency_add(&latency, start);
+	}
+
+	err = backend->sync();
+	TEST_ASSERT_EQUAL(0, err);
+
+	report_throughput("store", "stores_per_s", BENCHMARK_RECORDS,
+			  k_cyc_to_us_floor64(k_cycle_get_64() - start_total));
+	report_latency("store", &latency);
+	report_flash_bytes("store", BENCHMARK_RECORDS, flash_bytes_written() - bytes_before);
+
+	TEST_ASSERT_EQUAL(BENCHMARK_RECORDS, backend->count(type));
+}
+
+/* Peek at records spread over a full buffer, from the oldest to the newest */
+void test_benchmark_peek(void)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	const struct storage_data *type = find_type(STORAGE_TYPE_ENVIRONMENTAL);
+	struct environmental_msg env_msg;
+	struct latency latency = { 0 };
+	uint64_t start;
+	int ret;
+
+	TEST_ASSERT_NOT_NULL(type);
+
+	fill_backend(type, BENCHMARK_RECORDS);
+
+	for (uint32_t i = 0; i < PEEK_SAMPLES; i++) {
+		size_t index = ((size_t)i * (BENCHMARK_RECORDS - 1)) / (PEEK_SAMPLES - 1);
+
+		start = k_cycle_get_64();
+
+		ret = backend->peek(type, index, &env_msg, sizeof(env_msg));
+		TEST_ASSERT_EQUAL((int)type->data_size, ret);
+
+		latency_add(&latency, start);
+
+		TEST_ASSERT_TRUE(env_msg.timestamp == (int64_t)index);
+	}
+
+	report("peek", "items", PEEK_SAMPLES);
+	report_latency("peek", &latency);
+}
+
+/* Retrieve a full buffer of records one by one, including the final sync */
+void test_benchmark_retrieve(void)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	const struct storage_data *type = find_type(STORAGE_TYPE_ENVIRONMENTAL);
+	struct environmental_msg env_msg;
+	struct latency latency = { 0 };
+	uint32_t bytes_before;
+	uint64_t start_total;
+	uint64_t start;
+	int ret;
+
+	TEST_ASSERT_NOT_NULL(type);
+
+	fill_backend(type, BENCHMARK_RECORDS);
+
+	bytes_before = flash_bytes_written();
+	start_total = k_cycle_get_64();
+
+	for (uint32_t i = 0; i < BENCHMARK_RECORDS; i++) {
+		start = k_cycle_get_64();
+
+		ret = backend->retrieve(type, &env_msg, sizeof(env_msg));
+		TEST_ASSERT_EQUAL((int)type->data_size, ret);
+
+		latency_add(&latency, start);
+
+		TEST_ASSERT_TRUE(env_msg.timestamp == (int64_t)i);
+	}
+
+	ret = backend->sync();
+	TEST_ASSERT_EQUAL(0, ret);
+
+	report_throughput("retrieve", "retrieves_per_s", BENCHMARK_RECORDS,
+			  k_cyc_to_us_floor64(k_cycle_get_64() - start_total));
+	report_latency("retrieve", &latency);
+	report_flash_bytes("retrieve", BENCHMARK_RECORDS, flash_bytes_written() - bytes_before);
+
+	TEST_ASSERT_EQUAL(0, backend->count(type));
+}
+
+/* Flush a full buffer through a batch session, confirming every item as it is read */
+void test_benchmark_batch_session(void)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	const struct storage_data *type = find_type(STORAGE_TYPE_ENVIRONMENTAL);
+	struct storage_msg request_msg = {
+		.type = STORAGE_BATCH_REQUEST,
+		.session_id = BENCHMARK_SESSION_ID,
+	};
+	struct storage_msg consume_msg = {
+		.type = STORAGE_BATCH_CONSUME,
+		.session_id = BENCHMARK_SESSION_ID,
+		.data_type = STORAGE_TYPE_ENVIRONMENTAL,
+	};
+	struct storage_msg close_msg = {
+		.type = STORAGE_BATCH_CLOSE,
+		.session_id = BENCHMARK_SESSION_ID,
+	};
+	struct storage_data_item item;
+	struct latency latency = { 0 };
+	uint32_t bytes_before;
+	uint64_t start_total;
+	uint64_t start;
+	int err;
+
+	TEST_ASSERT_NOT_NULL(type);
+
+	fill_backend(type, BENCHMARK_RECORDS);
+
+	bytes_before = flash_bytes_written();
+	start_total = k_cycle_get_64();
+
+	publish_and_assert(&request_msg);
+
+	err = k_sem_take(&batch_response_sem, K_SECONDS(5));
+	TEST_ASSERT_EQUAL(0, err);
+	TEST_ASSERT_EQUAL(STORAGE_BATCH_AVAILABLE, batch_response.type);
+	TEST_ASSERT_EQUAL(BENCHMARK_RECORDS, batch_response.data_len);
+
+	for (uint32_t i = 0; i < BENCHMARK_RECORDS; i++) {
+		start = k_cycle_get_64();
+
+		err = storage_batch_read(&item, K_SECONDS(5));
+		TEST_ASSERT_EQUAL(0, err);
+
+		latency_add(&latency, start);
+
+		TEST_ASSERT_EQUAL(STORAGE_TYPE_ENVIRONMENTAL, item.type);
+		TEST_ASSERT_TRUE(item.data.ENVIRONMENTAL.timestamp == (int64_t)i);
+
+		publish_and_assert(&consume_msg);
+	}
+
+	publish_and_assert(&close_msg);
+
+	/* Let the storage module process the last confirmation before stopping the clock */
+	while (backend->count(type) > 0) {
+		k_sleep(K_TICKS(1));
+	}
+
+	report_throughput("batch_session", "items_per_s", BENCHMARK_RECORDS,
+			  k_cyc_to_us_floor64(k_cycle_get_64() - start_total));
+	report_latency("batch_session", &latency);
+	report_flash_bytes("batch_session", BENCHMARK_RECORDS,
+			   flash_bytes_written() - bytes_before);
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * Throughput benchmark for the LittleFS storage backend.
+ *
+ * The backend is driven directly, without the storage module, so that only the file system
+ * and flash cost is measured. The flash simulator busy-waits for every read, write and erase
+ * (see prj.conf), which makes the simulated uptime a measure of that cost.
+ *
+ * Each test prints one machine-readable line:
+ *
+ *	BENCHMARK,<mode>,<scenario>,<records>,<elapsed_us>,<records_per_s>
+ *
+ * where <mode> is "keep_files_open" or "open_close" depending on
+ * CONFIG_APP_STORAGE_LITTLEFS_KEEP_FILES_OPEN.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "storage_backend.h"
+#include "storage_data_types.h"
+#include "power.h"
+#include "environmental.h"
+#include "location.h"
+
+/* Records stored per data type in the 1 Hz burst scenario, one second apart */
+#define BURST_SECONDS		60
+
+/* Records stored and then flushed in the flush scenario */
+#define FLUSH_RECORDS		500
+
+#if defined(CONFIG_APP_STORAGE_LITTLEFS_KEEP_FILES_OPEN)
+#define BENCHMARK_MODE		"keep_files_open"
+#else
+#define BENCHMARK_MODE		"open_close"
+#endif
+
+/* Channels referenced by the registered storage data types */
+ZBUS_CHAN_DEFINE(power_chan,
+		 struct power_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_DEFINE(environmental_chan,
+		 struct environmental_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_DEFINE(location_chan,
+		 struct location_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+static const struct storage_backend *backend;
+static uint8_t data_buf[STORAGE_MAX_DATA_SIZE];
+
+static const struct storage_data *find_type(const char *name)
+{
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		if (strcmp(type->name, name) == 0) {
+			return type;
+		}
+	}
+
+	return NULL;
+}
+
+static void report(const char *scenario, uint32_t records, uint64_t elapsed_us)
+{
+	uint64_t records_per_s = (elapsed_us > 0) ?
+				 ((uint64_t)records * USEC_PER_SEC) / elapsed_us : 0;
+
+	printk("BENCHMARK,%s,%s,%u,%llu,%llu\n", BENCHMARK_MODE, scenario, records,
+	       (unsigned long long)elapsed_us, (unsigned long long)records_per_s);
+}
+
+void setUp(void)
+{
+	int err;
+
+	if (backend == NULL) {
+		backend = storage_backend_get();
+		TEST_ASSERT_NOT_NULL(backend);
+
+		err = backend->init();
+		TEST_ASSERT_EQUAL(0, err);
+	}
+
+	err = backend->clear();
+	TEST_ASSERT_EQUAL(0, err);
+
+	memset(data_buf, 0, sizeof(data_buf));
+}
+
+void tearDown(void)
+{
+}
+
+/* One record per data type every second, as the storage module sees with 1 Hz sampling.
+ * Only the store and the final sync are timed, not the idle time in between.
+ */
+void test_benchmark_1hz_burst(void)
+{
+	uint64_t elapsed_ticks = 0;
+	uint32_t records = 0;
+	int64_t start;
+	int err;
+
+	for (int i = 0; i < BURST_SECONDS; i++) {
+		start = k_uptime_ticks();
+
+		STRUCT_SECTION_FOREACH(storage_data, type) {
+			err = backend->store(type, data_buf, type->data_size);
+			TEST_ASSERT_EQUAL(0, err);
+
+			records++;
+		}
+
+		elapsed_ticks += k_uptime_ticks() - start;
+
+		k_sleep(K_SECONDS(1));
+	}
+
+	start = k_uptime_ticks();
+
+	err = backend->sync();
+	TEST_ASSERT_EQUAL(0, err);
+
+	elapsed_ticks += k_uptime_ticks() - start;
+
+	report("burst_1hz", records, k_ticks_to_us_floor64(elapsed_ticks));
+}
+
+/* Retrieve a backlog of stored records in one go, as during a flush to the cloud */
+void test_benchmark_flush(void)
+{
+	const struct storage_data *type = find_type("environmental");
+	int64_t start;
+	int ret;
+
+	TEST_ASSERT_NOT_NULL(type);
+
+	for (int i = 0; i < FLUSH_RECORDS; i++) {
+		ret = backend->store(type, data_buf, type->data_size);
+		TEST_ASSERT_EQUAL(0, ret);
+	}
+
+	ret = backend->sync();
+	TEST_ASSERT_EQUAL(0, ret);
+	TEST_ASSERT_EQUAL(FLUSH_RECORDS, backend->count(type));
+
+	start = k_uptime_ticks();
+
+	for (int i = 0; i < FLUSH_RECORDS; i++) {
+		ret = backend->retrieve(type, data_buf, sizeof(data_buf));
+		TEST_ASSERT_EQUAL((int)type->data_size, ret);
+	}
+
+	ret = backend->sync();
+	TEST_ASSERT_EQUAL(0, ret);
+
+	report("flush", FLUSH_RECORDS, k_ticks_to_us_floor64(k_uptime_ticks() - start));
+
+	TEST_ASSERT_EQUAL(0, backend->count(type));
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * Recovery tests for the journaled superblock of the LittleFS storage backend.
+ *
+ * The backend is driven directly, without the storage module. A reset is simulated by
+ * initializing the backend again, after damaging the files on flash through the file system
+ * API.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/zbus/zbus.h>
+
+#include "storage_backend.h"
+#include "storage_data_types.h"
+#include "power.h"
+#include "environmental.h"
+#include "location.h"
+
+#define SUPERBLOCK_PATH		"/att_storage/storage.sb"
+#define HEADER_PATH		"/att_storage/environmental.header"
+
+/* Layout of one superblock copy, see struct superblock in littlefs_backend.c */
+#define SB_SEQUENCE_OFFSET	4
+#define SB_ENTRIES_OFFSET	8
+#define SB_ENTRY_SIZE		16
+#define SB_SIZE			(SB_ENTRIES_OFFSET + \
+				 (CONFIG_APP_STORAGE_MAX_TYPES * SB_ENTRY_SIZE) + 4)
+#define SB_COPIES		2
+
+/* Records stored and consumed by store_and_consume() */
+#define STORED			5
+#define CONSUMED		2
+
+/* Channels referenced by the registered storage data types */
+ZBUS_CHAN_DEFINE(power_chan,
+		 struct power_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_DEFINE(environmental_chan,
+		 struct environmental_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_DEFINE(location_chan,
+		 struct location_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+static const struct storage_backend *backend;
+static const struct storage_data *env_type;
+
+static const struct storage_data *find_type(const char *name)
+{
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		if (strcmp(type->name, name) == 0) {
+			return type;
+		}
+	}
+
+	return NULL;
+}
+
+/* Simulate a reset, the backend reads its state from flash again */
+static void reboot(void)
+{
+	TEST_ASSERT_EQUAL(0, backend->init());
+}
+
+static void superblock_copy_read(int copy, uint8_t *buf)
+{
+	struct fs_file_t file;
+
+	fs_file_t_init(&file);
+
+	TEST_ASSERT_EQUAL(0, fs_open(&file, SUPERBLOCK_PATH, FS_O_READ));
+	TEST_ASSERT_EQUAL(0, fs_seek(&file, copy * SB_SIZE, FS_SEEK_SET));
+	TEST_ASSERT_EQUAL(SB_SIZE, fs_read(&file, buf, SB_SIZE));
+	TEST_ASSERT_EQUAL(0, fs_close(&file));
+}
+
+static void superblock_copy_write(int copy, const uint8_t *buf)
+{
+	struct fs_file_t file;
+
+	fs_file_t_init(&file);
+
+	TEST_ASSERT_EQUAL(0, fs_open(&file, SUPERBLOCK_PATH, FS_O_RDWR));
+	TEST_ASSERT_EQUAL(0, fs_seek(&file, copy * SB_SIZE, FS_SEEK_SET));
+	TEST_ASSERT_EQUAL(SB_SIZE, fs_write(&file, buf, SB_SIZE));
+	TEST_ASSERT_EQUAL(0, fs_close(&file));
+}
+
+static uint32_t superblock_sequence_get(int copy)
+{
+	uint8_t buf[SB_SIZE];
+	uint32_t sequence;
+
+	superblock_copy_read(copy, buf);
+	memcpy(&sequence, &buf[SB_SEQUENCE_OFFSET], sizeof(sequence));
+
+	return sequence;
+}
+
+static int superblock_newest_copy(void)
+{
+	return (int32_t)(superblock_sequence_get(1) - superblock_sequence_get(0)) > 0 ? 1 : 0;
+}
+
+/* Flip a bit in the entries of a copy, so that its CRC no longer matches */
+static void superblock_copy_corrupt(int copy)
+{
+	uint8_t buf[SB_SIZE];
+
+	superblock_copy_read(copy, buf);
+	buf[SB_ENTRIES_OFFSET + 4] ^= 0x01;
+	superblock_copy_write(copy, buf);
+}
+
+static void record_store(double temperature)
+{
+	struct environmental_msg msg = {
+		.type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE,
+		.temperature = temperature,
+		.timestamp = k_uptime_get(),
+	};
+
+	TEST_ASSERT_EQUAL(0, backend->store(env_type, &msg, sizeof(msg)));
+}
+
+static void record_verify(double temperature)
+{
+	struct environmental_msg msg;
+
+	TEST_ASSERT_EQUAL(sizeof(msg), backend->retrieve(env_type, &msg, sizeof(msg)));
+	TEST_ASSERT_EQUAL_DOUBLE(temperature, msg.temperature);
+}
+
+/*
+ * Store STORED records and consume CONSUMED of them, with a sync after each step. The two
+ * superblock copies then hold the offsets before and after the records were consumed.
+ */
+static void store_and_consume(void)
+{
+	for (int i = 0; i < STORED; i++) {
+		record_store(i);
+	}
+
+	TEST_ASSERT_EQUAL(0, backend->sync());
+
+	for (int i = 0; i < CONSUMED; i++) {
+		record_verify(i);
+	}
+
+	TEST_ASSERT_EQUAL(0, backend->sync());
+	TEST_ASSERT_EQUAL(STORED - CONSUMED, backend->count(env_type));
+}
+
+void setUp(void)
+{
+	if (backend == NULL) {
+		backend = storage_backend_get();
+		TEST_ASSERT_NOT_NULL(backend);
+		TEST_ASSERT_EQUAL(0, backend->init());
+
+		env_type = find_type("environmental");
+		TEST_ASSERT_NOT_NULL(env_type);
+	}
+
+	TEST_ASSERT_EQUAL(0, backend->clear());
+}
+
+void tearDown(void)
+{
+}
+
+void test_offsets_kept_over_reboot(void)
+{
+	store_and_consume();
+	reboot();
+
+	TEST_ASSERT_EQUAL(STORED - CONSUMED, backend->count(env_type));
+	record_verify(CONSUMED);
+}
+
+void test_records_after_last_sync_recovered(void)
+{
+	store_and_consume();
+
+	/* Stored after the last superblock write */
+	record_store(STORED);
+	reboot();
+
+	TEST_ASSERT_EQUAL(STORED - CONSUMED + 1, backend->count(env_type));
+	record_verify(CONSUMED);
+}
+
+void test_newest_copy_crc_bad(void)
+{
+	store_and_consume();
+	superblock_copy_corrupt(superblock_newest_copy());
+	reboot();
+
+	/* The previous copy is used, consumed records are delivered again rather than lost */
+	TEST_ASSERT_EQUAL(STORED, backend->count(env_type));
+	record_verify(0);
+}
+
+void test_newest_copy_torn(void)
+{
+	struct fs_file_t file;
+
+	store_and_consume();
+
+	/* A reset while writing the second copy leaves it cut short */
+	TEST_ASSERT_EQUAL(1, superblock_newest_copy());
+
+	fs_file_t_init(&file);
+	TEST_ASSERT_EQUAL(0, fs_open(&file, SUPERBLOCK_PATH, FS_O_RDWR));
+	TEST_ASSERT_EQUAL(0, fs_truncate(&file, SB_SIZE + (SB_SIZE / 2)));
+	TEST_ASSERT_EQUAL(0, fs_close(&file));
+
+	reboot();
+
+	TEST_ASSERT_EQUAL(STORED, backend->count(env_type));
+	record_verify(0);
+}
+
+void test_older_copy_crc_bad(void)
+{
+	store_and_consume();
+	superblock_copy_corrupt(1 - superblock_newest_copy());
+	reboot();
+
+	TEST_ASSERT_EQUAL(STORED - CONSUMED, backend->count(env_type));
+	record_verify(CONSUMED);
+}
+
+void test_both_copies_bad_rebuild(void)
+{
+	store_and_consume();
+
+	for (int i = 0; i < SB_COPIES; i++) {
+		superblock_copy_corrupt(i);
+	}
+
+	reboot();
+
+	/* Rebuilt from the record sequence numbers, consumed records cannot be told apart */
+	TEST_ASSERT_EQUAL(STORED, backend->count(env_type));
+	record_verify(0);
+	TEST_ASSERT_EQUAL(0, backend->sync());
+
+	/* The rebuilt offsets are in the superblock, a rebuild would find STORED records again */
+	reboot();
+
+	TEST_ASSERT_EQUAL(STORED - 1, backend->count(env_type));
+	record_verify(1);
+}
+
+void test_legacy_header_migrated(void)
+{
+	struct storage_file_header {
+		uint32_t read_offset;
+		uint32_t write_offset;
+		uint32_t slot_size;
+	} header = {
+		.read_offset = CONSUMED,
+		.write_offset = STORED,
+		.slot_size = sizeof(uint32_t) + env_type->record_size,
+	};
+	struct fs_dirent entry;
+	struct fs_file_t file;
+
+	for (int i = 0; i < STORED; i++) {
+		record_store(i);
+	}
+
+	TEST_ASSERT_EQUAL(0, backend->sync());
+
+	/* Replace the superblock with a header file, as written before the superblock */
+	TEST_ASSERT_EQUAL(0, fs_unlink(SUPERBLOCK_PATH));
+
+	fs_file_t_init(&file);
+	TEST_ASSERT_EQUAL(0, fs_open(&file, HEADER_PATH, FS_O_CREATE | FS_O_WRITE));
+	TEST_ASSERT_EQUAL(sizeof(header), fs_write(&file, &header, sizeof(header)));
+	TEST_ASSERT_EQUAL(0, fs_close(&file));
+
+	reboot();
+
+	TEST_ASSERT_EQUAL(STORED - CONSUMED, backend->count(env_type));
+
+	/* Removed once its offsets are in the superblock */
+	TEST_ASSERT_EQUAL(-ENOENT, fs_stat(HEADER_PATH, &entry));
+
+	reboot();
+
+	TEST_ASSERT_EQUAL(STORED - CONSUMED, backend->count(env_type));
+	record_verify(CONSUMED);
+}
+
+void test_legacy_header_slot_size_mismatch_rebuilt(void)
+{
+	struct storage_file_header {
+		uint32_t read_offset;
+		uint32_t write_offset;
+		uint32_t slot_size;
+	} header = {
+		.read_offset = CONSUMED,
+		.write_offset = STORED,
+		.slot_size = 1,
+	};
+	struct fs_file_t file;
+
+	for (int i = 0; i < STORED; i++) {
+		record_store(i);
+	}
+
+	TEST_ASSERT_EQUAL(0, backend->sync());
+	TEST_ASSERT_EQUAL(0, fs_unlink(SUPERBLOCK_PATH));
+
+	fs_file_t_init(&file);
+	TEST_ASSERT_EQUAL(0, fs_open(&file, HEADER_PATH, FS_O_CREATE | FS_O_WRITE));
+	TEST_ASSERT_EQUAL(sizeof(header), fs_write(&file, &header, sizeof(header)));
+	TEST_ASSERT_EQUAL(0, fs_close(&file));
+
+	reboot();
+
+	/* The header file does not match the records, the offsets are rebuilt instead */
+	TEST_ASSERT_EQUAL(STORED, backend->count(env_type));
+	record_verify(0);
+}
+
+/* This is required to be added to each test. That is because unity's
+ * main may return nonzero, while zephyr's main currently must
+ * return 0 in all cases (other values are reserved).
+ */
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -59,16 +59,18 @@ ZBUS_CHAN_DEFINE(location_chan,
 /* Forward declarations */
 static void dummy_cb(const struct zbus_channel *chan);
 static void storage_chan_cb(const struct zbus_channel *chan);
+static void storage_data_chan_cb(const struct zbus_channel *chan);
 
 /* Define unused subscribers */
 ZBUS_LISTENER_DEFINE(trigger, dummy_cb);
 ZBUS_LISTENER_DEFINE(storage_test_listener, storage_chan_cb);
+ZBUS_LISTENER_DEFINE(storage_data_test_listener, storage_data_chan_cb);
 ZBUS_LISTENER_DEFINE(power_test_listener, dummy_cb);
 ZBUS_LISTENER_DEFINE(environmental_test_listener, dummy_cb);
 ZBUS_LISTENER_DEFINE(location_test_listener, dummy_cb);
 
 ZBUS_CHAN_ADD_OBS(storage_chan, storage_test_listener, 0);
-ZBUS_CHAN_ADD_OBS(storage_data_chan, storage_test_listener, 0);
+ZBUS_CHAN_ADD_OBS(storage_data_chan, storage_data_test_listener, 0);
 ZBUS_CHAN_ADD_OBS(power_chan, power_test_listener, 0);
 ZBUS_CHAN_ADD_OBS(environmental_chan, environmental_test_listener, 0);
 ZBUS_CHAN_ADD_OBS(location_chan, location_test_listener, 0);
@@ -143,11 +145,24 @@ static void storage_chan_cb(const struct zbus_channel *chan)
 {
 	const struct storage_msg *msg = zbus_chan_const_msg(chan);
 
-	if ((chan != &storage_chan) && (chan != &storage_data_chan)) {
+	if (chan != &storage_chan) {
 		return;
 	}
 
 	received_msg = *msg;
+}
+
+static void storage_data_chan_cb(const struct zbus_channel *chan)
+{
+	const struct storage_data_msg *msg = zbus_chan_const_msg(chan);
+
+	if (chan != &storage_data_chan) {
+		return;
+	}
+
+	received_msg.type = msg->type;
+	received_msg.data_type = msg->data_type;
+	received_msg.data_len = msg->data_len;
 
 	if (msg->type == STORAGE_DATA) {
 		switch (msg->data_type) {
@@ -1033,6 +1048,78 @@ void test_storage_wraps_when_max_records_reached(void)
 
 }
 
+/* A record overwritten by a new one while a batch session is active is not consumed twice */
+void test_storage_wraps_during_batch_session(void)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	const struct storage_data *env_type = NULL;
+	struct environmental_msg env_msg = { .type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE };
+	struct storage_data_item item;
+	struct storage_msg consume_msg = {
+		.type = STORAGE_BATCH_CONSUME,
+		.data_type = STORAGE_TYPE_ENVIRONMENTAL,
+	};
+	const size_t max_records = CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE;
+	uint32_t session_id;
+	int err;
+
+	STRUCT_SECTION_FOREACH(storage_data, t) {
+		if (t->data_type == STORAGE_TYPE_ENVIRONMENTAL) {
+			env_type = t;
+			break;
+		}
+	}
+
+	TEST_ASSERT_NOT_NULL(env_type);
+
+	/* Fill the type, the timestamp identifies the record */
+	for (size_t i = 0; i < max_records; i++) {
+		populate_env_message(i % ARRAY_SIZE(env_samples), &env_msg);
+		env_msg.timestamp = (int64_t)(i + 1);
+		publish_and_assert(&environmental_chan, &env_msg);
+	}
+
+	request_batch_and_assert();
+	k_sleep(K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(STORAGE_BATCH_AVAILABLE, received_msg.type);
+	TEST_ASSERT_EQUAL(max_records, received_msg.data_len);
+	session_id = received_msg.session_id;
+	consume_msg.session_id = session_id;
+
+	err = storage_batch_read(&item, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+	TEST_ASSERT_TRUE(item.data.ENVIRONMENTAL.timestamp == 1);
+
+	/* Overwrites the record that was just read */
+	env_msg.timestamp = (int64_t)(max_records + 1);
+	publish_and_assert(&environmental_chan, &env_msg);
+	k_sleep(K_MSEC(500));
+
+	TEST_ASSERT_EQUAL(max_records, backend->count(env_type));
+
+	/* Nothing left to remove for the item that was read */
+	publish_and_assert(&storage_chan, &consume_msg);
+	k_sleep(K_MSEC(500));
+
+	TEST_ASSERT_EQUAL(max_records, backend->count(env_type));
+
+	/* The remaining records are handed out in order, including the new one */
+	for (size_t i = 2; i <= max_records + 1; i++) {
+		err = storage_batch_read(&item, K_SECONDS(5));
+		TEST_ASSERT_EQUAL(0, err);
+		TEST_ASSERT_TRUE(item.data.ENVIRONMENTAL.timestamp == (int64_t)i);
+
+		publish_and_assert(&storage_chan, &consume_msg);
+	}
+
+	k_sleep(K_MSEC(500));
+
+	TEST_ASSERT_EQUAL(0, backend->count(env_type));
+
+	close_batch_and_assert(session_id);
+}
+
 void test_storage_threshold(void)
 {
 	int err;
@@ -1117,7 +1204,7 @@ void test_storage_unconsumed_item_retained_on_session_close(void)
 		publish_and_assert(&environmental_chan, &env_msg);
 	}
 
-	/* Open a batch session — one item is peeked into the pipe */
+	/* Open a batch session — items are prefetched into the pipe */
 	request_batch_and_assert();
 	k_sleep(K_SECONDS(1));
 
@@ -1151,6 +1238,501 @@ void test_storage_unconsumed_item_retained_on_session_close(void)
 	close_batch_and_assert(received_msg.session_id);
 }
 
+/* Verify that a consumer can read several items ahead of STORAGE_BATCH_CONSUME and
+ * confirm them afterwards, as done when uploading multiple items in one request.
+ */
+void test_storage_batch_read_ahead_then_consume(void)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	const struct storage_data *env_type = NULL;
+	struct environmental_msg env_msg = {
+		.type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE,
+	};
+	struct storage_data_item items[3];
+	struct storage_msg consume_msg = {
+		.type = STORAGE_BATCH_CONSUME,
+		.data_type = STORAGE_TYPE_ENVIRONMENTAL,
+	};
+	const uint8_t num_samples = ARRAY_SIZE(items);
+	uint32_t session_id;
+	int err;
+
+	STRUCT_SECTION_FOREACH(storage_data, t) {
+		if (t->data_type == STORAGE_TYPE_ENVIRONMENTAL) {
+			env_type = t;
+			break;
+		}
+	}
+
+	TEST_ASSERT_NOT_NULL(env_type);
+
+	for (size_t i = 0; i < num_samples; i++) {
+		populate_env_message(i, &env_msg);
+		publish_and_assert(&environmental_chan, &env_msg);
+	}
+
+	request_batch_and_assert();
+	k_sleep(K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(STORAGE_BATCH_AVAILABLE, received_msg.type);
+	TEST_ASSERT_EQUAL(num_samples, received_msg.data_len);
+	session_id = received_msg.session_id;
+
+	/* Read all items without consuming any of them */
+	for (size_t i = 0; i < num_samples; i++) {
+		err = storage_batch_read(&items[i], K_SECONDS(1));
+		TEST_ASSERT_EQUAL(0, err);
+		TEST_ASSERT_EQUAL(STORAGE_TYPE_ENVIRONMENTAL, items[i].type);
+		TEST_ASSERT_EQUAL_DOUBLE(env_samples[i].temperature,
+					 items[i].data.ENVIRONMENTAL.temperature);
+	}
+
+	/* Nothing is removed from the backend until the items are consumed */
+	TEST_ASSERT_EQUAL(num_samples, backend->count(env_type));
+
+	consume_msg.session_id = session_id;
+
+	for (size_t i = 0; i < num_samples; i++) {
+		err = zbus_chan_pub(&storage_chan, &consume_msg, K_SECONDS(1));
+		TEST_ASSERT_EQUAL(0, err);
+	}
+
+	k_sleep(K_MSEC(500));
+
+	TEST_ASSERT_EQUAL(0, backend->count(env_type));
+
+	close_batch_and_assert(session_id);
+}
+
+/* Verify that STORAGE_BATCH_CONSUME_N removes several read items of one type at once. */
+void test_storage_batch_consume_n(void)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	const struct storage_data *env_type = NULL;
+	struct environmental_msg env_msg = {
+		.type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE,
+	};
+	struct storage_data_item item;
+	struct storage_msg consume_msg = {
+		.type = STORAGE_BATCH_CONSUME_N,
+		.data_type = STORAGE_TYPE_ENVIRONMENTAL,
+	};
+	const uint8_t num_samples = 4;
+	const uint8_t num_consumed = 3;
+	uint32_t session_id;
+	int err;
+
+	STRUCT_SECTION_FOREACH(storage_data, t) {
+		if (t->data_type == STORAGE_TYPE_ENVIRONMENTAL) {
+			env_type = t;
+			break;
+		}
+	}
+
+	TEST_ASSERT_NOT_NULL(env_type);
+
+	for (size_t i = 0; i < num_samples; i++) {
+		populate_env_message(i, &env_msg);
+		publish_and_assert(&environmental_chan, &env_msg);
+	}
+
+	request_batch_and_assert();
+	k_sleep(K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(STORAGE_BATCH_AVAILABLE, received_msg.type);
+	session_id = received_msg.session_id;
+
+	for (size_t i = 0; i < num_consumed; i++) {
+		err = storage_batch_read(&item, K_SECONDS(1));
+		TEST_ASSERT_EQUAL(0, err);
+	}
+
+	consume_msg.session_id = session_id;
+	consume_msg.data_len = num_consumed;
+
+	err = zbus_chan_pub(&storage_chan, &consume_msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+
+	k_sleep(K_MSEC(500));
+
+	TEST_ASSERT_EQUAL(num_samples - num_consumed, backend->count(env_type));
+
+	/* The item that was not consumed is still delivered in order */
+	err = storage_batch_read(&item, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+	TEST_ASSERT_EQUAL_DOUBLE(env_samples[num_consumed].temperature,
+				 item.data.ENVIRONMENTAL.temperature);
+
+	close_batch_and_assert(session_id);
+}
+
+/* Verify that a claimed item can be used in place and that releasing it without a
+ * STORAGE_BATCH_CONSUME keeps the item in storage.
+ */
+void test_storage_batch_claim_release(void)
+{
+	const struct storage_data_item *item;
+	struct power_msg bat_msg = { .type = POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE };
+	uint32_t session_id;
+	int err;
+
+	bat_msg.percentage = battery_samples[0];
+	publish_and_assert(&power_chan, &bat_msg);
+
+	request_batch_and_assert();
+	k_sleep(K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(STORAGE_BATCH_AVAILABLE, received_msg.type);
+	TEST_ASSERT_EQUAL(1, received_msg.data_len);
+	session_id = received_msg.session_id;
+
+	err = storage_batch_claim(&item, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+	TEST_ASSERT_NOT_NULL(item);
+	TEST_ASSERT_EQUAL(STORAGE_TYPE_BATTERY, item->type);
+	TEST_ASSERT_EQUAL_DOUBLE(battery_samples[0], item->data.BATTERY.percentage);
+
+	storage_batch_release(item);
+
+	/* No more items in this session */
+	err = storage_batch_claim(&item, K_MSEC(500));
+	TEST_ASSERT_EQUAL(-EAGAIN, err);
+
+	close_batch_and_assert(session_id);
+
+	/* The released but unconsumed item is still available */
+	request_batch_and_assert();
+	k_sleep(K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(STORAGE_BATCH_AVAILABLE, received_msg.type);
+	TEST_ASSERT_EQUAL(1, received_msg.data_len);
+
+	close_batch_and_assert(received_msg.session_id);
+}
+
+/* Read all items of a query session in the order they are handed out */
+static size_t read_query_items(struct environmental_msg *out, size_t max_items)
+{
+	struct storage_data_item item;
+	size_t items_read = 0;
+
+	while (items_read < max_items) {
+		int ret = storage_batch_read(&item, K_MSEC(500));
+
+		if (ret == -EAGAIN) {
+			break;
+		}
+
+		TEST_ASSERT_EQUAL(0, ret);
+		TEST_ASSERT_EQUAL(STORAGE_TYPE_ENVIRONMENTAL, item.type);
+
+		out[items_read++] = item.data.ENVIRONMENTAL;
+	}
+
+	return items_read;
+}
+
+/* Queries select records by time and recency without removing them from storage */
+void test_storage_batch_query_since_and_latest(void)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	struct environmental_msg env_msg = { .type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE };
+	struct environmental_msg items[10];
+	struct storage_msg query_msg = {
+		.type = STORAGE_BATCH_QUERY,
+		.data_type = STORAGE_TYPE_ENVIRONMENTAL,
+		.session_id = 0x22222222,
+	};
+	const size_t num_samples = ARRAY_SIZE(items);
+	size_t items_read;
+
+	for (size_t i = 0; i < num_samples; i++) {
+		populate_env_message(i, &env_msg);
+		env_msg.timestamp = (int64_t)(i + 1) * 1000;
+		publish_and_assert(&environmental_chan, &env_msg);
+	}
+
+	/* Everything stored at or after 4 seconds, oldest first */
+	query_msg.query.since = 4000;
+	publish_and_assert(&storage_chan, &query_msg);
+	k_sleep(K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(STORAGE_BATCH_AVAILABLE, received_msg.type);
+	TEST_ASSERT_EQUAL(num_samples - 3, received_msg.data_len);
+
+	items_read = read_query_items(items, ARRAY_SIZE(items));
+	TEST_ASSERT_EQUAL(num_samples - 3, items_read);
+
+	for (size_t i = 0; i < items_read; i++) {
+		TEST_ASSERT_TRUE(items[i].timestamp == (int64_t)(i + 4) * 1000);
+		TEST_ASSERT_EQUAL_DOUBLE(env_samples[i + 3].temperature, items[i].temperature);
+	}
+
+	close_batch_and_assert(query_msg.session_id);
+
+	/* The three newest records, newest first */
+	query_msg.query.since = 0;
+	query_msg.query.max_items = 3;
+	query_msg.query.newest_first = true;
+	publish_and_assert(&storage_chan, &query_msg);
+	k_sleep(K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(STORAGE_BATCH_AVAILABLE, received_msg.type);
+	TEST_ASSERT_EQUAL(3, received_msg.data_len);
+
+	items_read = read_query_items(items, ARRAY_SIZE(items));
+	TEST_ASSERT_EQUAL(3, items_read);
+
+	for (size_t i = 0; i < items_read; i++) {
+		TEST_ASSERT_TRUE(items[i].timestamp == (int64_t)(num_samples - i) * 1000);
+	}
+
+	close_batch_and_assert(query_msg.session_id);
+
+	/* Nothing that recent */
+	query_msg.query.since = (int64_t)(num_samples + 1) * 1000;
+	query_msg.query.max_items = 0;
+	publish_and_assert(&storage_chan, &query_msg);
+	k_sleep(K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(STORAGE_BATCH_EMPTY, received_msg.type);
+
+	close_batch_and_assert(query_msg.session_id);
+
+	/* Queries are read-only */
+	STRUCT_SECTION_FOREACH(storage_data, t) {
+		if (t->data_type == STORAGE_TYPE_ENVIRONMENTAL) {
+			TEST_ASSERT_EQUAL(num_samples, backend->count(t));
+		}
+	}
+}
+
+/* Batch sessions merge the data types by timestamp instead of handing them out type by type */
+void test_storage_batch_merges_types_by_timestamp(void)
+{
+	struct power_msg bat_msg = { .type = POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE };
+	struct environmental_msg env_msg = { .type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE };
+	struct storage_msg batch_msg = { .type = STORAGE_BATCH_REQUEST, .session_id = 0x33333333 };
+	struct storage_msg clear_msg = { .type = STORAGE_CLEAR };
+	const int64_t bat_timestamps[] = { 3000, 4000 };
+	const int64_t env_timestamps[] = { 1000, 2000, 5000 };
+	const enum storage_data_type expected_types[] = {
+		STORAGE_TYPE_ENVIRONMENTAL, STORAGE_TYPE_ENVIRONMENTAL, STORAGE_TYPE_BATTERY,
+		STORAGE_TYPE_BATTERY, STORAGE_TYPE_ENVIRONMENTAL,
+	};
+	struct storage_data_item item;
+	int64_t timestamp;
+
+	publish_and_assert(&storage_chan, &clear_msg);
+	k_sleep(K_SECONDS(1));
+
+	/* All battery samples are stored before the environmental samples */
+	for (size_t i = 0; i < ARRAY_SIZE(bat_timestamps); i++) {
+		bat_msg.percentage = battery_samples[i];
+		bat_msg.timestamp = bat_timestamps[i];
+		publish_and_assert(&power_chan, &bat_msg);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(env_timestamps); i++) {
+		populate_env_message(i, &env_msg);
+		env_msg.timestamp = env_timestamps[i];
+		publish_and_assert(&environmental_chan, &env_msg);
+	}
+
+	k_sleep(K_SECONDS(1));
+
+	publish_and_assert(&storage_chan, &batch_msg);
+	k_sleep(K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(STORAGE_BATCH_AVAILABLE, received_msg.type);
+	TEST_ASSERT_EQUAL(ARRAY_SIZE(expected_types), received_msg.data_len);
+
+	for (size_t i = 0; i < ARRAY_SIZE(expected_types); i++) {
+		TEST_ASSERT_EQUAL(0, storage_batch_read(&item, K_SECONDS(1)));
+		TEST_ASSERT_EQUAL(expected_types[i], item.type);
+
+		timestamp = (item.type == STORAGE_TYPE_BATTERY) ? item.data.BATTERY.timestamp :
+								  item.data.ENVIRONMENTAL.timestamp;
+		TEST_ASSERT_TRUE(timestamp == (int64_t)(i + 1) * 1000);
+	}
+
+	close_batch_and_assert(batch_msg.session_id);
+
+	publish_and_assert(&storage_chan, &clear_msg);
+	k_sleep(K_SECONDS(1));
+}
+
+/* Persisting moves records from RAM to flash in backends that have both, and must not change
+ * the records or their order in any backend.
+ */
+void test_storage_persist_keeps_records_in_order(void)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	const struct storage_data *env_type = NULL;
+	struct environmental_msg env_msg = { .type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE };
+	struct environmental_msg retrieved;
+	struct storage_msg persist_msg = { .type = STORAGE_PERSIST };
+	const size_t num_samples = MIN(ARRAY_SIZE(env_samples), 5);
+
+	STRUCT_SECTION_FOREACH(storage_data, t) {
+		if (t->data_type == STORAGE_TYPE_ENVIRONMENTAL) {
+			env_type = t;
+			break;
+		}
+	}
+
+	TEST_ASSERT_NOT_NULL(env_type);
+
+	for (size_t i = 0; i < num_samples; i++) {
+		populate_env_message(i, &env_msg);
+		publish_and_assert(&environmental_chan, &env_msg);
+	}
+
+	publish_and_assert(&storage_chan, &persist_msg);
+
+	/* Let the storage thread process the samples and the persist command */
+	k_sleep(K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(num_samples, backend->count(env_type));
+
+	for (size_t i = 0; i < num_samples; i++) {
+		int ret = backend->retrieve(env_type, &retrieved, sizeof(retrieved));
+
+		TEST_ASSERT_EQUAL(sizeof(retrieved), ret);
+		TEST_ASSERT_EQUAL_DOUBLE(env_samples[i].temperature, retrieved.temperature);
+		TEST_ASSERT_EQUAL_DOUBLE(env_samples[i].humidity, retrieved.humidity);
+		TEST_ASSERT_EQUAL_DOUBLE(env_samples[i].pressure, retrieved.pressure);
+	}
+
+	TEST_ASSERT_EQUAL(0, backend->count(env_type));
+}
+
+/* Verify that data survives the compact record encoding used by persistent backends, and that
+ * the records are smaller than the data they encode.
+ */
+void test_storage_record_codec_round_trip(void)
+{
+	const struct storage_data *bat_type = NULL;
+	const struct storage_data *env_type = NULL;
+	const struct storage_data *loc_type = NULL;
+	uint8_t record[STORAGE_MAX_RECORD_SIZE];
+	const struct power_msg bat_in = {
+		.type = POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE,
+		.percentage = 85.25,
+		.voltage = 3.912,
+		.charging = true,
+		.timestamp = 1735689600123LL,
+	};
+	struct power_msg bat_out;
+	struct environmental_msg env_out;
+	struct location_msg loc_in = {
+		.type = LOCATION_CLOUD_REQUEST,
+		.cloud_request = {
+			.current_cell = {
+				.id = 0x12345678,
+				.mcc = 242,
+				.mnc = 1,
+				.tac = 0x1234,
+				.timing_advance = 7,
+				.earfcn = 6300,
+				.rsrp = -90,
+				.rsrq = -10,
+			},
+			.ncells_count = 1,
+			.neighbor_cells[0] = {
+				.earfcn = 6400,
+				.time_diff = -12,
+				.phys_cell_id = 42,
+				.rsrp = -100,
+				.rsrq = -12,
+			},
+			.wifi_cnt = 1,
+			.wifi_aps[0] = {
+				.rssi = -55,
+				.mac = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06},
+				.mac_length = 6,
+			},
+		},
+		.timestamp = 42,
+	};
+	struct location_msg loc_out;
+
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		TEST_ASSERT_LESS_THAN(type->data_size, type->record_size);
+
+		if (type->data_type == STORAGE_TYPE_BATTERY) {
+			bat_type = type;
+		} else if (type->data_type == STORAGE_TYPE_ENVIRONMENTAL) {
+			env_type = type;
+		} else if (type->data_type == STORAGE_TYPE_LOCATION) {
+			loc_type = type;
+		}
+	}
+
+	TEST_ASSERT_NOT_NULL(bat_type);
+	TEST_ASSERT_NOT_NULL(env_type);
+	TEST_ASSERT_NOT_NULL(loc_type);
+
+	bat_type->encode_record(&bat_in, record);
+	bat_type->decode_record(record, &bat_out);
+
+	TEST_ASSERT_EQUAL(bat_in.type, bat_out.type);
+	TEST_ASSERT_TRUE(bat_in.timestamp == bat_out.timestamp);
+	TEST_ASSERT_DOUBLE_WITHIN(0.01, bat_in.percentage, bat_out.percentage);
+	TEST_ASSERT_DOUBLE_WITHIN(0.001, bat_in.voltage, bat_out.voltage);
+	TEST_ASSERT_TRUE(bat_out.charging);
+
+	for (size_t i = 0; i < env_samples_size; i++) {
+		env_type->encode_record(&env_samples[i], record);
+		env_type->decode_record(record, &env_out);
+
+		TEST_ASSERT_EQUAL(ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE, env_out.type);
+		TEST_ASSERT_DOUBLE_WITHIN(0.01, env_samples[i].temperature, env_out.temperature);
+		TEST_ASSERT_DOUBLE_WITHIN(0.01, env_samples[i].humidity, env_out.humidity);
+		TEST_ASSERT_DOUBLE_WITHIN(0.01, env_samples[i].pressure, env_out.pressure);
+	}
+
+	for (size_t i = 0; i < location_samples_size; i++) {
+		loc_type->encode_record(&location_samples[i], record);
+		loc_type->decode_record(record, &loc_out);
+
+		TEST_ASSERT_EQUAL(location_samples[i].type, loc_out.type);
+		TEST_ASSERT_DOUBLE_WITHIN(1e-7, location_samples[i].gnss_data.latitude,
+					  loc_out.gnss_data.latitude);
+		TEST_ASSERT_DOUBLE_WITHIN(1e-7, location_samples[i].gnss_data.longitude,
+					  loc_out.gnss_data.longitude);
+		TEST_ASSERT_EQUAL_FLOAT(location_samples[i].gnss_data.accuracy,
+					loc_out.gnss_data.accuracy);
+	}
+
+	loc_type->encode_record(&loc_in, record);
+	loc_type->decode_record(record, &loc_out);
+
+	TEST_ASSERT_EQUAL(LOCATION_CLOUD_REQUEST, loc_out.type);
+	TEST_ASSERT_TRUE(loc_in.timestamp == loc_out.timestamp);
+	TEST_ASSERT_EQUAL_UINT32(loc_in.cloud_request.current_cell.id,
+				 loc_out.cloud_request.current_cell.id);
+	TEST_ASSERT_EQUAL(loc_in.cloud_request.current_cell.mcc,
+			  loc_out.cloud_request.current_cell.mcc);
+	TEST_ASSERT_EQUAL(loc_in.cloud_request.current_cell.mnc,
+			  loc_out.cloud_request.current_cell.mnc);
+	TEST_ASSERT_EQUAL_UINT32(loc_in.cloud_request.current_cell.tac,
+				 loc_out.cloud_request.current_cell.tac);
+	TEST_ASSERT_EQUAL(loc_in.cloud_request.current_cell.rsrp,
+			  loc_out.cloud_request.current_cell.rsrp);
+	TEST_ASSERT_EQUAL(1, loc_out.cloud_request.ncells_count);
+	TEST_ASSERT_EQUAL(loc_in.cloud_request.neighbor_cells[0].time_diff,
+			  loc_out.cloud_request.neighbor_cells[0].time_diff);
+	TEST_ASSERT_EQUAL(loc_in.cloud_request.neighbor_cells[0].phys_cell_id,
+			  loc_out.cloud_request.neighbor_cells[0].phys_cell_id);
+	TEST_ASSERT_EQUAL(0, loc_out.cloud_request.gci_cells_count);
+	TEST_ASSERT_EQUAL(1, loc_out.cloud_request.wifi_cnt);
+	TEST_ASSERT_EQUAL(loc_in.cloud_request.wifi_aps[0].rssi,
+			  loc_out.cloud_request.wifi_aps[0].rssi);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(loc_in.cloud_request.wifi_aps[0].mac,
+				      loc_out.cloud_request.wifi_aps[0].mac, 6);
+}
+
 extern int unity_main(void);
 
 int main(void)
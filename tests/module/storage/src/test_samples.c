@@ -137,305 +137,205 @@ const size_t env_samples_size = ARRAY_SIZE(env_samples);
 /* Location samples */
 const struct location_msg location_samples[100] = {
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4210, .longitude = 10.4370,
-	 .accuracy = 5.0f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 30, .second = 0, .ms = 0}}},
+	 .accuracy = 5.0f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4211, .longitude = 10.4371,
-	 .accuracy = 4.8f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 31, .second = 0, .ms = 0}}},
+	 .accuracy = 4.8f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4212, .longitude = 10.4372,
-	 .accuracy = 5.2f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 32, .second = 0, .ms = 0}}},
+	 .accuracy = 5.2f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4213, .longitude = 10.4373,
-	 .accuracy = 4.9f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 33, .second = 0, .ms = 0}}},
+	 .accuracy = 4.9f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4214, .longitude = 10.4374,
-	 .accuracy = 5.1f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 34, .second = 0, .ms = 0}}},
+	 .accuracy = 5.1f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4215, .longitude = 10.4375,
-	 .accuracy = 4.7f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 35, .second = 0, .ms = 0}}},
+	 .accuracy = 4.7f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4216, .longitude = 10.4376,
-	 .accuracy = 5.3f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 36, .second = 0, .ms = 0}}},
+	 .accuracy = 5.3f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4217, .longitude = 10.4377,
-	 .accuracy = 4.6f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 37, .second = 0, .ms = 0}}},
+	 .accuracy = 4.6f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4218, .longitude = 10.4378,
-	 .accuracy = 5.4f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 38, .second = 0, .ms = 0}}},
+	 .accuracy = 5.4f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4219, .longitude = 10.4379,
-	 .accuracy = 4.5f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 39, .second = 0, .ms = 0}}},
+	 .accuracy = 4.5f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4220, .longitude = 10.4380,
-	 .accuracy = 5.5f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 40, .second = 0, .ms = 0}}},
+	 .accuracy = 5.5f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4221, .longitude = 10.4381,
-	 .accuracy = 4.4f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 41, .second = 0, .ms = 0}}},
+	 .accuracy = 4.4f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4222, .longitude = 10.4382,
-	 .accuracy = 5.6f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 42, .second = 0, .ms = 0}}},
+	 .accuracy = 5.6f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4223, .longitude = 10.4383,
-	 .accuracy = 4.3f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 43, .second = 0, .ms = 0}}},
+	 .accuracy = 4.3f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4224, .longitude = 10.4384,
-	 .accuracy = 5.7f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 44, .second = 0, .ms = 0}}},
+	 .accuracy = 5.7f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4225, .longitude = 10.4385,
-	 .accuracy = 4.2f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 45, .second = 0, .ms = 0}}},
+	 .accuracy = 4.2f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4226, .longitude = 10.4386,
-	 .accuracy = 5.8f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 46, .second = 0, .ms = 0}}},
+	 .accuracy = 5.8f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4227, .longitude = 10.4387,
-	 .accuracy = 4.1f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 47, .second = 0, .ms = 0}}},
+	 .accuracy = 4.1f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4228, .longitude = 10.4388,
-	 .accuracy = 5.9f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 48, .second = 0, .ms = 0}}},
+	 .accuracy = 5.9f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4229, .longitude = 10.4389,
-	 .accuracy = 4.0f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 49, .second = 0, .ms = 0}}},
+	 .accuracy = 4.0f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4230, .longitude = 10.4390,
-	 .accuracy = 6.0f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 50, .second = 0, .ms = 0}}},
+	 .accuracy = 6.0f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4231, .longitude = 10.4391,
-	 .accuracy = 3.9f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 51, .second = 0, .ms = 0}}},
+	 .accuracy = 3.9f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4232, .longitude = 10.4392,
-	 .accuracy = 6.1f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 52, .second = 0, .ms = 0}}},
+	 .accuracy = 6.1f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4233, .longitude = 10.4393,
-	 .accuracy = 3.8f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 53, .second = 0, .ms = 0}}},
+	 .accuracy = 3.8f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4234, .longitude = 10.4394,
-	 .accuracy = 6.2f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 54, .second = 0, .ms = 0}}},
+	 .accuracy = 6.2f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4235, .longitude = 10.4395,
-	 .accuracy = 3.7f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 55, .second = 0, .ms = 0}}},
+	 .accuracy = 3.7f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4236, .longitude = 10.4396,
-	 .accuracy = 6.3f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 56, .second = 0, .ms = 0}}},
+	 .accuracy = 6.3f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4237, .longitude = 10.4397,
-	 .accuracy = 3.6f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 57, .second = 0, .ms = 0}}},
+	 .accuracy = 3.6f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4238, .longitude = 10.4398,
-	 .accuracy = 6.4f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 58, .second = 0, .ms = 0}}},
+	 .accuracy = 6.4f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4239, .longitude = 10.4399,
-	 .accuracy = 3.5f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 12, .minute = 59, .second = 0, .ms = 0}}},
+	 .accuracy = 3.5f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4240, .longitude = 10.4400,
-	 .accuracy = 6.5f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 0, .second = 0, .ms = 0}}},
+	 .accuracy = 6.5f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4241, .longitude = 10.4401,
-	 .accuracy = 3.4f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 1, .second = 0, .ms = 0}}},
+	 .accuracy = 3.4f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4242, .longitude = 10.4402,
-	 .accuracy = 6.6f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 2, .second = 0, .ms = 0}}},
+	 .accuracy = 6.6f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4243, .longitude = 10.4403,
-	 .accuracy = 3.3f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 3, .second = 0, .ms = 0}}},
+	 .accuracy = 3.3f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4244, .longitude = 10.4404,
-	 .accuracy = 6.7f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 4, .second = 0, .ms = 0}}},
+	 .accuracy = 6.7f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4245, .longitude = 10.4405,
-	 .accuracy = 3.2f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 5, .second = 0, .ms = 0}}},
+	 .accuracy = 3.2f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4246, .longitude = 10.4406,
-	 .accuracy = 6.8f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 6, .second = 0, .ms = 0}}},
+	 .accuracy = 6.8f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4247, .longitude = 10.4407,
-	 .accuracy = 3.1f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 7, .second = 0, .ms = 0}}},
+	 .accuracy = 3.1f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4248, .longitude = 10.4408,
-	 .accuracy = 6.9f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 8, .second = 0, .ms = 0}}},
+	 .accuracy = 6.9f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4249, .longitude = 10.4409,
-	 .accuracy = 3.0f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 9, .second = 0, .ms = 0}}},
+	 .accuracy = 3.0f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4250, .longitude = 10.4410,
-	 .accuracy = 7.0f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 10, .second = 0, .ms = 0}}},
+	 .accuracy = 7.0f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4251, .longitude = 10.4411,
-	 .accuracy = 2.9f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 11, .second = 0, .ms = 0}}},
+	 .accuracy = 2.9f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4252, .longitude = 10.4412,
-	 .accuracy = 7.1f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 12, .second = 0, .ms = 0}}},
+	 .accuracy = 7.1f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4253, .longitude = 10.4413,
-	 .accuracy = 2.8f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 13, .second = 0, .ms = 0}}},
+	 .accuracy = 2.8f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4254, .longitude = 10.4414,
-	 .accuracy = 7.2f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 14, .second = 0, .ms = 0}}},
+	 .accuracy = 7.2f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4255, .longitude = 10.4415,
-	 .accuracy = 2.7f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 15, .second = 0, .ms = 0}}},
+	 .accuracy = 2.7f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4256, .longitude = 10.4416,
-	 .accuracy = 7.3f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 16, .second = 0, .ms = 0}}},
+	 .accuracy = 7.3f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4257, .longitude = 10.4417,
-	 .accuracy = 2.6f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 17, .second = 0, .ms = 0}}},
+	 .accuracy = 2.6f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4258, .longitude = 10.4418,
-	 .accuracy = 7.4f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 18, .second = 0, .ms = 0}}},
+	 .accuracy = 7.4f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4259, .longitude = 10.4419,
-	 .accuracy = 2.5f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 19, .second = 0, .ms = 0}}},
+	 .accuracy = 2.5f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4260, .longitude = 10.4420,
-	 .accuracy = 7.5f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 20, .second = 0, .ms = 0}}},
+	 .accuracy = 7.5f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4261, .longitude = 10.4421,
-	 .accuracy = 2.4f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 21, .second = 0, .ms = 0}}},
+	 .accuracy = 2.4f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4262, .longitude = 10.4422,
-	 .accuracy = 7.6f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 22, .second = 0, .ms = 0}}},
+	 .accuracy = 7.6f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4263, .longitude = 10.4423,
-	 .accuracy = 2.3f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 23, .second = 0, .ms = 0}}},
+	 .accuracy = 2.3f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4264, .longitude = 10.4424,
-	 .accuracy = 7.7f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 24, .second = 0, .ms = 0}}},
+	 .accuracy = 7.7f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4265, .longitude = 10.4425,
-	 .accuracy = 2.2f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 25, .second = 0, .ms = 0}}},
+	 .accuracy = 2.2f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4266, .longitude = 10.4426,
-	 .accuracy = 7.8f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 26, .second = 0, .ms = 0}}},
+	 .accuracy = 7.8f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4267, .longitude = 10.4427,
-	 .accuracy = 2.1f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 27, .second = 0, .ms = 0}}},
+	 .accuracy = 2.1f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4268, .longitude = 10.4428,
-	 .accuracy = 7.9f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 28, .second = 0, .ms = 0}}},
+	 .accuracy = 7.9f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4269, .longitude = 10.4429,
-	 .accuracy = 2.0f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 29, .second = 0, .ms = 0}}},
+	 .accuracy = 2.0f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4270, .longitude = 10.4430,
-	 .accuracy = 8.0f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 30, .second = 0, .ms = 0}}},
+	 .accuracy = 8.0f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4271, .longitude = 10.4431,
-	 .accuracy = 1.9f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 31, .second = 0, .ms = 0}}},
+	 .accuracy = 1.9f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4272, .longitude = 10.4432,
-	 .accuracy = 8.1f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 32, .second = 0, .ms = 0}}},
+	 .accuracy = 8.1f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4273, .longitude = 10.4433,
-	 .accuracy = 1.8f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 33, .second = 0, .ms = 0}}},
+	 .accuracy = 1.8f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4274, .longitude = 10.4434,
-	 .accuracy = 8.2f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 34, .second = 0, .ms = 0}}},
+	 .accuracy = 8.2f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4275, .longitude = 10.4435,
-	 .accuracy = 1.7f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 35, .second = 0, .ms = 0}}},
+	 .accuracy = 1.7f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4276, .longitude = 10.4436,
-	 .accuracy = 8.3f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 36, .second = 0, .ms = 0}}},
+	 .accuracy = 8.3f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4277, .longitude = 10.4437,
-	 .accuracy = 1.6f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 37, .second = 0, .ms = 0}}},
+	 .accuracy = 1.6f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4278, .longitude = 10.4438,
-	 .accuracy = 8.4f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 38, .second = 0, .ms = 0}}},
+	 .accuracy = 8.4f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4279, .longitude = 10.4439,
-	 .accuracy = 1.5f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 39, .second = 0, .ms = 0}}},
+	 .accuracy = 1.5f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4280, .longitude = 10.4440,
-	 .accuracy = 8.5f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 40, .second = 0, .ms = 0}}},
+	 .accuracy = 8.5f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4281, .longitude = 10.4441,
-	 .accuracy = 1.4f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 41, .second = 0, .ms = 0}}},
+	 .accuracy = 1.4f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4282, .longitude = 10.4442,
-	 .accuracy = 8.6f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 42, .second = 0, .ms = 0}}},
+	 .accuracy = 8.6f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4283, .longitude = 10.4443,
-	 .accuracy = 1.3f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 43, .second = 0, .ms = 0}}},
+	 .accuracy = 1.3f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4284, .longitude = 10.4444,
-	 .accuracy = 8.7f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 44, .second = 0, .ms = 0}}},
+	 .accuracy = 8.7f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4285, .longitude = 10.4445,
-	 .accuracy = 1.2f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 45, .second = 0, .ms = 0}}},
+	 .accuracy = 1.2f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4286, .longitude = 10.4446,
-	 .accuracy = 8.8f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 46, .second = 0, .ms = 0}}},
+	 .accuracy = 8.8f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4287, .longitude = 10.4447,
-	 .accuracy = 1.1f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 47, .second = 0, .ms = 0}}},
+	 .accuracy = 1.1f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4288, .longitude = 10.4448,
-	 .accuracy = 8.9f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 48, .second = 0, .ms = 0}}},
+	 .accuracy = 8.9f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4289, .longitude = 10.4449,
-	 .accuracy = 1.0f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 49, .second = 0, .ms = 0}}},
+	 .accuracy = 1.0f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4290, .longitude = 10.4450,
-	 .accuracy = 9.0f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 50, .second = 0, .ms = 0}}},
+	 .accuracy = 9.0f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4291, .longitude = 10.4451,
-	 .accuracy = 0.9f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 51, .second = 0, .ms = 0}}},
+	 .accuracy = 0.9f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4292, .longitude = 10.4452,
-	 .accuracy = 9.1f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 52, .second = 0, .ms = 0}}},
+	 .accuracy = 9.1f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4293, .longitude = 10.4453,
-	 .accuracy = 0.8f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 53, .second = 0, .ms = 0}}},
+	 .accuracy = 0.8f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4294, .longitude = 10.4454,
-	 .accuracy = 9.2f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 54, .second = 0, .ms = 0}}},
+	 .accuracy = 9.2f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4295, .longitude = 10.4455,
-	 .accuracy = 0.7f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 55, .second = 0, .ms = 0}}},
+	 .accuracy = 0.7f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4296, .longitude = 10.4456,
-	 .accuracy = 9.3f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 56, .second = 0, .ms = 0}}},
+	 .accuracy = 9.3f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4297, .longitude = 10.4457,
-	 .accuracy = 0.6f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 57, .second = 0, .ms = 0}}},
+	 .accuracy = 0.6f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4298, .longitude = 10.4458,
-	 .accuracy = 9.4f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 58, .second = 0, .ms = 0}}},
+	 .accuracy = 9.4f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4299, .longitude = 10.4459,
-	 .accuracy = 0.5f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 13, .minute = 59, .second = 0, .ms = 0}}},
+	 .accuracy = 0.5f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4300, .longitude = 10.4460,
-	 .accuracy = 9.5f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 14, .minute = 0, .second = 0, .ms = 0}}},
+	 .accuracy = 9.5f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4301, .longitude = 10.4461,
-	 .accuracy = 0.4f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 14, .minute = 1, .second = 0, .ms = 0}}},
+	 .accuracy = 0.4f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4302, .longitude = 10.4462,
-	 .accuracy = 9.6f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 14, .minute = 2, .second = 0, .ms = 0}}},
+	 .accuracy = 9.6f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4303, .longitude = 10.4463,
-	 .accuracy = 0.3f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 14, .minute = 3, .second = 0, .ms = 0}}},
+	 .accuracy = 0.3f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4304, .longitude = 10.4464,
-	 .accuracy = 9.7f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 14, .minute = 4, .second = 0, .ms = 0}}},
+	 .accuracy = 9.7f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4305, .longitude = 10.4465,
-	 .accuracy = 0.2f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 14, .minute = 5, .second = 0, .ms = 0}}},
+	 .accuracy = 0.2f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4306, .longitude = 10.4466,
-	 .accuracy = 9.8f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 14, .minute = 6, .second = 0, .ms = 0}}},
+	 .accuracy = 9.8f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4307, .longitude = 10.4467,
-	 .accuracy = 0.1f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 14, .minute = 7, .second = 0, .ms = 0}}},
+	 .accuracy = 0.1f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4308, .longitude = 10.4468,
-	 .accuracy = 9.9f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 14, .minute = 8, .second = 0, .ms = 0}}},
+	 .accuracy = 9.9f}},
 	{.type = LOCATION_GNSS_DATA, .gnss_data = {.latitude = 63.4309, .longitude = 10.4469,
-	 .accuracy = 0.05f, .datetime = {.valid = true, .year = 2025, .month = 1, .day = 15,
-		      .hour = 14, .minute = 9, .second = 0, .ms = 0}}},
+	 .accuracy = 0.05f}},
 };
 
 const size_t location_samples_size = ARRAY_SIZE(location_samples);
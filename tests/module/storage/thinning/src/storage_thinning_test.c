@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <zephyr/fff.h>
+#include <zephyr/kernel.h>
+#include <zephyr/zbus/zbus.h>
+#include <zephyr/task_wdt/task_wdt.h>
+
+#include "storage.h"
+#include "storage_backend.h"
+#include "storage_data_types.h"
+#include "power.h"
+#include "environmental.h"
+#include "location.h"
+#include "app_common.h"
+
+DEFINE_FFF_GLOBALS;
+
+FAKE_VALUE_FUNC(int, task_wdt_feed, int);
+FAKE_VALUE_FUNC(int, task_wdt_add, uint32_t, task_wdt_callback_t, void *);
+
+ZBUS_CHAN_DEFINE(power_chan,
+		 struct power_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_DEFINE(environmental_chan,
+		 struct environmental_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+ZBUS_CHAN_DEFINE(location_chan,
+		 struct location_msg,
+		 NULL,
+		 NULL,
+		 ZBUS_OBSERVERS_EMPTY,
+		 ZBUS_MSG_INIT(0)
+);
+
+/* Number of records that triggers thinning, see CMakeLists.txt */
+#define THRESHOLD	((CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE * \
+			  CONFIG_APP_STORAGE_THINNING_THRESHOLD_PERCENT) / 100)
+
+static const struct storage_data *find_type(enum storage_data_type data_type)
+{
+	STRUCT_SECTION_FOREACH(storage_data, type) {
+		if (type->data_type == data_type) {
+			return type;
+		}
+	}
+
+	return NULL;
+}
+
+static void publish_env_samples(size_t first, size_t count)
+{
+	struct environmental_msg env_msg = { .type = ENVIRONMENTAL_SENSOR_SAMPLE_RESPONSE };
+	int err;
+
+	for (size_t i = first; i < first + count; i++) {
+		env_msg.timestamp = (int64_t)i;
+		env_msg.temperature = (double)i;
+
+		err = zbus_chan_pub(&environmental_chan, &env_msg, K_SECONDS(1));
+		TEST_ASSERT_EQUAL(0, err);
+	}
+
+	/* Let the storage thread process all published samples before direct backend reads */
+	k_sleep(K_SECONDS(1));
+}
+
+void setUp(void)
+{
+	int err;
+	struct storage_msg clear_msg = { .type = STORAGE_CLEAR };
+
+	err = zbus_chan_pub(&storage_chan, &clear_msg, K_SECONDS(1));
+	TEST_ASSERT_EQUAL(0, err);
+	k_sleep(K_MSEC(500));
+
+	RESET_FAKE(task_wdt_feed);
+	RESET_FAKE(task_wdt_add);
+}
+
+void tearDown(void)
+{
+}
+
+/* Reaching the threshold drops every second record of the older half, oldest record kept */
+void test_thinning_drops_every_second_old_record(void)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	const struct storage_data *env_type = find_type(STORAGE_TYPE_ENVIRONMENTAL);
+	struct environmental_msg retrieved;
+	const int64_t expected[] = { 0, 2, 4, 6, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+	BUILD_ASSERT(THRESHOLD == 16, "Test expects thinning at 16 records");
+
+	TEST_ASSERT_NOT_NULL(env_type);
+
+	publish_env_samples(0, THRESHOLD - 1);
+	TEST_ASSERT_EQUAL(THRESHOLD - 1, backend->count(env_type));
+
+	publish_env_samples(THRESHOLD - 1, 1);
+	TEST_ASSERT_EQUAL(ARRAY_SIZE(expected), backend->count(env_type));
+
+	for (size_t i = 0; i < ARRAY_SIZE(expected); i++) {
+		int ret = backend->retrieve(env_type, &retrieved, sizeof(retrieved));
+
+		TEST_ASSERT_EQUAL(sizeof(retrieved), ret);
+		TEST_ASSERT_TRUE(retrieved.timestamp == expected[i]);
+		TEST_ASSERT_EQUAL_INT((int)expected[i], (int)retrieved.temperature);
+	}
+}
+
+/* Repeated passes thin the oldest records again, so the footprint stays below the threshold */
+void test_thinning_repeats_and_keeps_newest_records(void)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	const struct storage_data *env_type = find_type(STORAGE_TYPE_ENVIRONMENTAL);
+	struct environmental_msg retrieved;
+	const size_t total = CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE * 5;
+	int64_t previous = -1;
+	int count;
+
+	TEST_ASSERT_NOT_NULL(env_type);
+
+	publish_env_samples(0, total);
+
+	count = backend->count(env_type);
+	TEST_ASSERT_GREATER_THAN(0, count);
+	TEST_ASSERT_LESS_THAN(THRESHOLD, count);
+
+	for (int i = 0; i < count; i++) {
+		int ret = backend->retrieve(env_type, &retrieved, sizeof(retrieved));
+
+		TEST_ASSERT_EQUAL(sizeof(retrieved), ret);
+
+		/* Order is kept and the very first record survives every pass */
+		TEST_ASSERT_TRUE(retrieved.timestamp > previous);
+		if (i == 0) {
+			TEST_ASSERT_TRUE(retrieved.timestamp == 0);
+		}
+
+		previous = retrieved.timestamp;
+	}
+
+	/* The newest record is never thinned */
+	TEST_ASSERT_TRUE(previous == (int64_t)(total - 1));
+}
+
+/* Types with thinning disabled keep overwriting their oldest records */
+void test_thinning_disabled_for_type_overwrites_oldest(void)
+{
+	const struct storage_backend *backend = storage_backend_get();
+	const struct storage_data *bat_type = find_type(STORAGE_TYPE_BATTERY);
+	struct power_msg bat_msg = { .type = POWER_BATTERY_PERCENTAGE_SAMPLE_RESPONSE };
+	struct power_msg retrieved;
+	const size_t total = CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE + 5;
+	int err;
+
+	TEST_ASSERT_NOT_NULL(bat_type);
+	TEST_ASSERT_FALSE(bat_type->thin);
+
+	for (size_t i = 0; i < total; i++) {
+		bat_msg.timestamp = (int64_t)i;
+
+		err = zbus_chan_pub(&power_chan, &bat_msg, K_SECONDS(1));
+		TEST_ASSERT_EQUAL(0, err);
+	}
+
+	k_sleep(K_SECONDS(1));
+
+	TEST_ASSERT_EQUAL(CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE, backend->count(bat_type));
+
+	err = backend->retrieve(bat_type, &retrieved, sizeof(retrieved));
+	TEST_ASSERT_EQUAL(sizeof(retrieved), err);
+	TEST_ASSERT_TRUE(retrieved.timestamp == (int64_t)(total -
+							   CONFIG_APP_STORAGE_MAX_RECORDS_PER_TYPE));
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <unity.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "storage_track.h"
+
+/* Used by storage_track.c */
+LOG_MODULE_REGISTER(storage, 4);
+
+#define LONGITUDE		10.437
+
+/* About 1 km and 10 m to the north */
+#define KM			0.009
+#define TEN_METERS		0.00009
+
+/* Latitude where the current test starts, stationary */
+static double base_latitude = 60.0;
+static int64_t timestamp;
+
+static bool fix_add(double latitude, double longitude)
+{
+	struct location_msg msg = {
+		.type = LOCATION_GNSS_DATA,
+		.gnss_data.latitude = latitude,
+		.gnss_data.longitude = longitude,
+		.timestamp = timestamp,
+	};
+
+	timestamp += 60 * MSEC_PER_SEC;
+
+	return storage_track_add(&msg);
+}
+
+static void verify_point(double latitude, double longitude)
+{
+	const struct location_msg *point = storage_track_point_get();
+
+	TEST_ASSERT_EQUAL(LOCATION_GNSS_DATA, point->type);
+	TEST_ASSERT_EQUAL_DOUBLE(latitude, point->gnss_data.latitude);
+	TEST_ASSERT_EQUAL_DOUBLE(longitude, point->gnss_data.longitude);
+}
+
+void setUp(void)
+{
+	/* Move far away and stop there, whatever the state left by the previous test */
+	base_latitude += 1.0;
+
+	(void)fix_add(base_latitude, LONGITUDE);
+	(void)fix_add(base_latitude, LONGITUDE);
+	(void)fix_add(base_latitude, LONGITUDE);
+}
+
+void tearDown(void)
+{
+}
+
+void test_stationary_fixes_dropped(void)
+{
+	for (int i = 0; i < 5; i++) {
+		TEST_ASSERT_FALSE(fix_add(base_latitude + ((i % 2) * TEN_METERS), LONGITUDE));
+	}
+}
+
+void test_straight_line_simplified(void)
+{
+	for (int i = 1; i <= 5; i++) {
+		TEST_ASSERT_FALSE(fix_add(base_latitude + (i * KM), LONGITUDE));
+	}
+
+	/* Turning east needs the last fix on the straight line to keep the shape */
+	TEST_ASSERT_TRUE(fix_add(base_latitude + (5 * KM), LONGITUDE + (2 * KM)));
+	verify_point(base_latitude + (5 * KM), LONGITUDE);
+}
+
+void test_stop_stored_right_away(void)
+{
+	for (int i = 1; i <= 3; i++) {
+		TEST_ASSERT_FALSE(fix_add(base_latitude + (i * KM), LONGITUDE));
+	}
+
+	TEST_ASSERT_TRUE(fix_add(base_latitude + (3 * KM) + TEN_METERS, LONGITUDE));
+	verify_point(base_latitude + (3 * KM) + TEN_METERS, LONGITUDE);
+
+	/* Fixes at the stop are dropped */
+	TEST_ASSERT_FALSE(fix_add(base_latitude + (3 * KM), LONGITUDE));
+}
+
+void test_point_stored_every_window(void)
+{
+	for (int i = 1; i <= CONFIG_APP_STORAGE_TRACK_WINDOW_SIZE; i++) {
+		TEST_ASSERT_FALSE(fix_add(base_latitude + (i * KM), LONGITUDE));
+	}
+
+	TEST_ASSERT_TRUE(fix_add(base_latitude + ((CONFIG_APP_STORAGE_TRACK_WINDOW_SIZE + 1) * KM),
+				 LONGITUDE));
+	verify_point(base_latitude + (CONFIG_APP_STORAGE_TRACK_WINDOW_SIZE * KM), LONGITUDE);
+}
+
+extern int unity_main(void);
+
+int main(void)
+{
+	(void)unity_main();
+
+	return 0;
+}
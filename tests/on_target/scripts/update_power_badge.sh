@@ -12,6 +12,14 @@ BADGE_FILE_DEST=docs/power_badge.json
 HTML_FILE_DEST=docs/power_measurements_plot.html
 CSV_FILE_DEST=docs/power_measurements.csv
 
+# Power benchmark results, only present after a nightly run
+BENCHMARK_CSV_FILE=tests/on_target/power_benchmark.csv
+BENCHMARK_STATES_CSV_FILE=tests/on_target/power_benchmark_states.csv
+
+BENCHMARK_CSV_FILE_DEST=docs/power_benchmark.csv
+BENCHMARK_STATES_CSV_FILE_DEST=docs/power_benchmark_states.csv
+BENCHMARK_HISTORY_CSV_FILE_DEST=docs/power_benchmark_history.csv
+
 # Temporary worktree directory
 WORKTREE_DIR=$(mktemp -d)
 
@@ -58,10 +66,24 @@ git worktree add "$WORKTREE_DIR" gh-pages || handle_error "Failed to create work
 cp "$BADGE_FILE" "$WORKTREE_DIR/$BADGE_FILE_DEST" || handle_error "Failed to copy badge file"
 cp "$HTML_FILE" "$WORKTREE_DIR/$HTML_FILE_DEST" || handle_error "Failed to copy HTML file"
 cp "$CSV_FILE" "$WORKTREE_DIR/$CSV_FILE_DEST" || handle_error "Failed to copy CSV file"
+FILES_DEST=("$BADGE_FILE_DEST" "$HTML_FILE_DEST" "$CSV_FILE_DEST")
+
+# Copy the benchmark results and append them to the history, one set of rows per version
+if [ -f $BENCHMARK_CSV_FILE ] && [ -f $BENCHMARK_STATES_CSV_FILE ]; then
+  cp "$BENCHMARK_CSV_FILE" "$WORKTREE_DIR/$BENCHMARK_CSV_FILE_DEST" || handle_error "Failed to copy benchmark CSV file"
+  cp "$BENCHMARK_STATES_CSV_FILE" "$WORKTREE_DIR/$BENCHMARK_STATES_CSV_FILE_DEST" || handle_error "Failed to copy benchmark states CSV file"
+  if [ ! -f "$WORKTREE_DIR/$BENCHMARK_HISTORY_CSV_FILE_DEST" ]; then
+    head -n 1 "$BENCHMARK_CSV_FILE" > "$WORKTREE_DIR/$BENCHMARK_HISTORY_CSV_FILE_DEST"
+  fi
+  tail -n +2 "$BENCHMARK_CSV_FILE" >> "$WORKTREE_DIR/$BENCHMARK_HISTORY_CSV_FILE_DEST"
+  FILES_DEST+=("$BENCHMARK_CSV_FILE_DEST" "$BENCHMARK_STATES_CSV_FILE_DEST" "$BENCHMARK_HISTORY_CSV_FILE_DEST")
+else
+  echo "Benchmark files not found, skipping"
+fi
 
 # Navigate to worktree, commit and push
 cd "$WORKTREE_DIR"
-git add "$BADGE_FILE_DEST" "$HTML_FILE_DEST" "$CSV_FILE_DEST"
+git add "${FILES_DEST[@]}"
 git commit -m "Update power badge, html and csv to docs folder"
 git push origin gh-pages
 
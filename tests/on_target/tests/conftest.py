@@ -261,6 +261,22 @@ def hex_file_buffer_ram():
 
     pytest.fail("No matching buffer RAM firmware .hex file found in the artifacts directory")
 
+@pytest.fixture(scope="session")
+def hex_file_power_benchmark():
+    # Skip if not thingy91x since the power benchmark build is only available for thingy91x
+    if DUT_DEVICE_TYPE != 'thingy91x':
+        pytest.skip("Power benchmark build is only available for thingy91x")
+
+    # Search for the firmware hex file in the artifacts folder
+    artifacts_dir = "artifacts/"
+    hex_pattern = f"asset-tracker-template-{r'[0-9a-z\.]+'}-power-bench-{DUT_DEVICE_TYPE}-nrf91.hex"
+
+    for file in os.listdir(artifacts_dir):
+        if re.match(hex_pattern, file):
+            return os.path.join(artifacts_dir, file)
+
+    pytest.fail("No matching power benchmark firmware .hex file found in the artifacts directory")
+
 @pytest.fixture(scope="session")
 def hex_file_buffer_flash():
     # Skip if not thingy91x since buffer flash build is only available for thingy91x
@@ -4,6 +4,7 @@
 ##########################################################################################
 
 import os
+import re
 import time
 import json
 import types
@@ -11,10 +12,11 @@ import pytest
 import csv
 import pandas as pd
 import plotly.express as px
-from tests.conftest import get_uarts
+from tests.conftest import get_uarts, NRFCLOUD_API_KEY, DEVICE_UUID
 from ppk2_api.ppk2_api import PPK2_API
 from utils.uart import Uart
 from utils.flash_tools import flash_device, reset_device, recover_device
+from utils.nrfcloud import NRFCloud, NRFCloudFOTA, NRFCloudFOTAError
 import sys
 sys.path.append(os.getcwd())
 from utils.logger import get_logger
@@ -34,6 +36,41 @@ SAMPLING_INTERVAL = 0.01
 CSV_FILE = "power_measurements.csv"
 HMTL_PLOT_FILE = "power_measurements_plot.html"
 SEGGER = os.getenv('SEGGER')
+APP_BUNDLEID = os.getenv("APP_BUNDLEID")
+
+BENCHMARK_CSV_FILE = "power_benchmark.csv"
+BENCHMARK_STATES_CSV_FILE = "power_benchmark_states.csv"
+BENCHMARK_SETTLE_TIME = 60
+DEFAULT_SAMPLE_INTERVAL = 150
+DEFAULT_STORAGE_THRESHOLD = 1
+
+# State statistics are reported by index, see enum app_state in app/src/main.c
+MAIN_STATE_DISCONNECTED_SAMPLING = 3
+MAIN_STATE_CONNECTED_SAMPLING = 6
+
+# Scenarios of the power benchmark matrix. Each phase is one measurement window, the
+# command is sent to the device right before the UARTs are suspended for the window.
+BENCHMARK_SCENARIOS = {
+    "idle_psm": {
+        "sample_interval": 3600,
+        "phases": [("idle", 600, None)],
+    },
+    "sampling_gnss_5min": {
+        "sample_interval": 300,
+        "phases": [("sampling", 1800, None)],
+    },
+    "outage_backlog_flush": {
+        "sample_interval": 300,
+        "phases": [
+            ("outage", 3600, "att_network disconnect"),
+            ("flush", 600, "att_network connect"),
+        ],
+    },
+    "fota_download": {
+        "sample_interval": 3600,
+        "phases": [("download", 60, None)],
+    },
+}
 
 
 def save_badge_data(average):
@@ -296,3 +333,229 @@ def test_power(thingy91x_ppk2, hex_file):
     else:
         # Current is between 0 and YELLOW_THRESHOLD but PSM wasn't reached
         pytest.fail(f"PSM target not reached after {POWER_TIMEOUT / 60} minutes, only reached {min_rolling_average} uA")
+
+
+def read_state_stats(uart):
+    '''
+    Read the state statistics of all modules with the att_state_stats shell command.
+
+    Returns a dict of {(module, state index): (entries, time in ms)}.
+    '''
+    start_pos = uart.get_size()
+    uart.write("att_state_stats\r\n")
+    # The statistics have no end marker, the uptime printed after them is used instead
+    uart.write("kernel uptime\r\n")
+    uart.wait_for_str("Uptime:", timeout=10, start_pos=start_pos)
+
+    stats = {}
+    module = None
+    for line in uart.log[start_pos:].splitlines():
+        line = line.strip()
+        header = re.fullmatch(r"(?:.*\$ )?(\w+):", line)
+        if header:
+            module = header.group(1)
+            continue
+        entry = re.search(r"state\s+(\d+): entered (\d+) times, total (\d+) ms", line)
+        if entry and module:
+            stats[(module, int(entry.group(1)))] = (int(entry.group(2)), int(entry.group(3)))
+
+    if not stats:
+        pytest.fail("No state statistics read, is CONFIG_APP_STATE_STATS enabled?")
+
+    return stats
+
+
+def state_stats_delta(before, after):
+    '''
+    Return the entries into and the time spent in each state between two readings.
+    '''
+    delta = {}
+    for key, (entries, time_ms) in after.items():
+        entries_before, time_ms_before = before.get(key, (0, 0))
+        if entries < entries_before or time_ms < time_ms_before:
+            pytest.fail(f"State statistics of {key[0]} went backwards, did the device reboot?")
+        if entries > entries_before or time_ms > time_ms_before:
+            delta[key] = (entries - entries_before, time_ms - time_ms_before)
+    return delta
+
+
+def measure_average_current(ppk2_dev, duration):
+    '''
+    Average the current drawn over the given number of seconds, in uA.
+    '''
+    # Drop the samples collected before the window
+    ppk2_dev.get_data()
+
+    total = 0.0
+    count = 0
+    start = time.time()
+    while time.time() < start + duration:
+        read_data = ppk2_dev.get_data()
+        if read_data != b'':
+            ppk_samples, _ = ppk2_dev.get_samples(read_data)
+            total += sum(ppk_samples)
+            count += len(ppk_samples)
+        time.sleep(SAMPLING_INTERVAL)
+
+    if count == 0:
+        pytest.fail("No PPK samples read during the measurement window")
+
+    return total / count
+
+
+def measure_phase(thingy91x_ppk2, duration, command):
+    '''
+    Measure one phase with the UARTs suspended and return the average current in uA and the
+    state statistics delta of the phase.
+    '''
+    uart = thingy91x_ppk2.t91x_uart
+
+    stats_before = read_state_stats(uart)
+    if command:
+        uart.write(f"{command}\r\n")
+
+    start_pos = uart.get_size()
+    uart.write(f"att_uart suspend {duration}\r\n")
+    uart.wait_for_str("Suspending UART", timeout=10, start_pos=start_pos)
+
+    average = measure_average_current(thingy91x_ppk2.ppk2_dev, duration)
+
+    # Give the device time to resume the UARTs
+    time.sleep(5)
+    stats_after = read_state_stats(uart)
+
+    return average, state_stats_delta(stats_before, stats_after)
+
+
+def get_version(hex_file):
+    match = re.search(r"asset-tracker-template-(.+)-power-bench-", os.path.basename(hex_file))
+    return match.group(1) if match else "unknown"
+
+
+def save_benchmark_data(results):
+    with open(BENCHMARK_CSV_FILE, 'w', newline='') as csvfile:
+        fieldnames = ['Version', 'Scenario', 'Phase', 'Duration (s)', 'Average current (uA)',
+                      'Charge (mC)', 'Samples', 'Charge per sample (mC)']
+        writer = csv.DictWriter(csvfile, fieldnames=fieldnames)
+
+        writer.writeheader()
+        for result in results:
+            writer.writerow({key: result[key] for key in fieldnames})
+
+    with open(BENCHMARK_STATES_CSV_FILE, 'w', newline='') as csvfile:
+        fieldnames = ['Version', 'Scenario', 'Phase', 'Module', 'State', 'Entries', 'Time (ms)']
+        writer = csv.DictWriter(csvfile, fieldnames=fieldnames)
+
+        writer.writeheader()
+        for result in results:
+            for (module, state), (entries, time_ms) in sorted(result['States'].items()):
+                writer.writerow({
+                    'Version': result['Version'],
+                    'Scenario': result['Scenario'],
+                    'Phase': result['Phase'],
+                    'Module': module,
+                    'State': state,
+                    'Entries': entries,
+                    'Time (ms)': time_ms
+                })
+
+    logger.info(f"Benchmark data saved to {BENCHMARK_CSV_FILE} and {BENCHMARK_STATES_CSV_FILE}")
+
+
+@pytest.fixture(scope="module")
+def benchmark_results():
+    results = []
+
+    yield results
+
+    if results:
+        save_benchmark_data(results)
+
+
+@pytest.mark.slow
+@pytest.mark.parametrize("scenario", BENCHMARK_SCENARIOS.keys())
+def test_power_benchmark(thingy91x_ppk2, hex_file_power_benchmark, benchmark_results, scenario):
+    '''
+    Measure the average current and the charge per sample of each benchmark scenario
+
+    The state statistics of the device are read before and after each phase, so that
+    a regression can be traced to the module states that were active in the phase.
+    '''
+    if not NRFCLOUD_API_KEY or not DEVICE_UUID:
+        pytest.skip("NRFCLOUD_API_KEY and UUID environment variables must be set")
+    if scenario == "fota_download" and not APP_BUNDLEID:
+        pytest.skip("APP_BUNDLEID environment variable not set")
+
+    config = BENCHMARK_SCENARIOS[scenario]
+    cloud = NRFCloud(api_key=NRFCLOUD_API_KEY)
+    fota = NRFCloudFOTA(api_key=NRFCLOUD_API_KEY)
+    uart = thingy91x_ppk2.t91x_uart
+
+    cloud.patch_config(
+        DEVICE_UUID,
+        sample_interval=config["sample_interval"],
+        storage_threshold=DEFAULT_STORAGE_THRESHOLD
+    )
+
+    try:
+        flash_device(os.path.abspath(hex_file_power_benchmark), serial=SEGGER)
+        start_pos = uart.get_size()
+        reset_device(serial=SEGGER)
+        try:
+            uart.wait_for_str("Connected to Cloud", timeout=120, start_pos=start_pos)
+        except AssertionError:
+            pytest.fail("Device unable to connect to cloud")
+
+        # Let the device apply the configuration and finish the samples taken on connect
+        time.sleep(BENCHMARK_SETTLE_TIME)
+
+        if scenario == "fota_download":
+            fota.ensure_no_pending_fota_jobs(DEVICE_UUID)
+            try:
+                job_id = fota.create_fota_job(DEVICE_UUID, APP_BUNDLEID)
+            except NRFCloudFOTAError as e:
+                pytest.skip(f"FOTA create_job REST API error: {e}")
+            logger.info(f"Created FOTA Job (ID: {job_id})")
+
+            start_pos = uart.get_size()
+            uart.write("att_fota poll\r\n")
+            uart.wait_for_str("nrf_cloud_fota_poll: Starting FOTA download", timeout=120,
+                              start_pos=start_pos)
+
+        for phase, duration, command in config["phases"]:
+            average, states = measure_phase(thingy91x_ppk2, duration, command)
+            if average < 0:
+                pytest.fail(f"Current can't be negative, current average: {average}")
+
+            samples = sum(entries for (module, state), (entries, _) in states.items()
+                          if module == "main" and state in (MAIN_STATE_DISCONNECTED_SAMPLING,
+                                                            MAIN_STATE_CONNECTED_SAMPLING))
+            charge = average * duration / 1000
+            charge_per_sample = round(charge / samples, 3) if samples else ""
+
+            logger.info(f"{scenario}/{phase}: {round(average, 2)} uA average, "
+                        f"{round(charge, 3)} mC, {samples} samples")
+            for (module, state), (entries, time_ms) in sorted(states.items()):
+                logger.info(f"  {module} state {state}: entered {entries} times, {time_ms} ms")
+
+            benchmark_results.append({
+                'Version': get_version(hex_file_power_benchmark),
+                'Scenario': scenario,
+                'Phase': phase,
+                'Duration (s)': duration,
+                'Average current (uA)': round(average, 2),
+                'Charge (mC)': round(charge, 3),
+                'Samples': samples,
+                'Charge per sample (mC)': charge_per_sample,
+                'States': states
+            })
+    finally:
+        if scenario == "fota_download":
+            fota.ensure_no_pending_fota_jobs(DEVICE_UUID)
+
+        # Restore default config no matter what
+        cloud.patch_config(
+            DEVICE_UUID,
+            sample_interval=DEFAULT_SAMPLE_INTERVAL,
+            storage_threshold=DEFAULT_STORAGE_THRESHOLD
+        )